@@ -285,6 +285,9 @@ protected:
 	/** create new instance, using cached data is possible */
 	TSharedPtr<FEnvQueryInstance> CreateQueryInstance(const UEnvQuery* Template, EEnvQueryRunMode::Type RunMode);
 
+	/** compute values of next test step of running queries on worker threads, see FEQSHelpers::ComputeTestValuesInParallel */
+	void ComputeTestValuesInParallel();
+
 	/** how long are we allowed to test per update, in seconds. */
 	UPROPERTY(config)
 	float MaxAllowedTestingTime;
@@ -303,6 +306,10 @@ protected:
 	UPROPERTY(config)
 	double QueryCountWarningInterval;
 
+	/** how many items of running queries can be evaluated on worker threads per update, when ai.eqs.ParallelTests is set */
+	UPROPERTY(config)
+	int32 MaxParallelTestItemsPerTick;
+
 private:
 
 	/** create and bind delegates in instance */
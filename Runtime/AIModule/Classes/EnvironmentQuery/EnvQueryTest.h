@@ -170,6 +170,18 @@ public:
 	/** Function that does the actual work */
 	virtual void RunTest(FEnvQueryInstance& QueryInstance) const { checkNoEntry(); }
 
+	/** Gather everything ComputeItemValues needs for items listed in ItemValues, called on game thread.
+	 *  Tests returning true will have raw values of all remaining items computed at once (possibly on worker threads)
+	 *  and passed to ApplyItemValues instead of RunTest */
+	virtual bool PrepareItemValues(FEnvQueryInstance& QueryInstance, FEnvQueryItemValues& ItemValues) const { return false; }
+
+	/** Compute raw values of items [FirstItem, FirstItem + NumItems) in ItemValues.
+	 *  Can be called from any thread, must not access query instance nor modify the test */
+	virtual void ComputeItemValues(FEnvQueryItemValues& ItemValues, int32 FirstItem, int32 NumItems) const {}
+
+	/** filter and score items using values computed by ComputeItemValues */
+	void ApplyItemValues(FEnvQueryInstance& QueryInstance, const FEnvQueryItemValues& ItemValues) const;
+
 	/** check if test supports item type */
 	bool IsSupportedItem(TSubclassOf<UEnvQueryItemType> ItemType) const;
 
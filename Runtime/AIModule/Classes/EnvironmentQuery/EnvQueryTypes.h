@@ -44,6 +44,7 @@ DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Time"),STAT_AI_EQS_LoadTime,STATGROUP_AI_EQ
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Execute One Step Time"),STAT_AI_EQS_ExecuteOneStep,STATGROUP_AI_EQS, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Generator Time"),STAT_AI_EQS_GeneratorTime,STATGROUP_AI_EQS, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Test Time"),STAT_AI_EQS_TestTime,STATGROUP_AI_EQS, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Parallel Test Values"),STAT_AI_EQS_ParallelTestValues,STATGROUP_AI_EQS, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("EQS Debug StoreQuery"), STAT_AI_EQS_Debug_StoreQuery, STATGROUP_AI_EQS, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("EQS Debug StoreTickTime"), STAT_AI_EQS_Debug_StoreTickTime, STATGROUP_AI_EQS, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("EQS Debug StoreStats"), STAT_AI_EQS_Debug_StoreStats, STATGROUP_AI_EQS, );
@@ -646,6 +647,52 @@ struct AIMODULE_API FEnvQueryOptionInstance
 	FORCEINLINE uint32 GetAllocatedSize() const { return sizeof(*this) + Tests.GetAllocatedSize(); }
 };
 
+/** Raw values of a test step, computed for all remaining items at once before the step runs (see UEnvQueryTest::PrepareItemValues).
+ *  Data is stored as structure of arrays, so numeric tests can run tight loops over items on worker threads */
+struct AIMODULE_API FEnvQueryItemValues
+{
+	/** indices of evaluated items in FEnvQueryInstance::Items */
+	TArray<int32> ItemIndices;
+
+	/** locations of evaluated items, one array per component */
+	TArray<float> ItemX;
+	TArray<float> ItemY;
+	TArray<float> ItemZ;
+
+	/** context data gathered by the test on game thread, meaning is test specific */
+	TArray<FVector> ContextVectors[2];
+
+	/** raw values, laid out by value: all items for value 0, then all items for value 1, etc. */
+	TArray<float> Values;
+
+	/** number of raw values passed to the item iterator for every item (e.g. one per context) */
+	int32 NumValuesPerItem;
+
+	/** filter thresholds, bound on game thread */
+	float FilterMin;
+	float FilterMax;
+
+	/** test specific flags describing how context data is used */
+	uint32 TestFlags;
+
+	/** step of query the values were computed for */
+	int32 OptionIndex;
+	int32 TestIndex;
+	int32 StartingItem;
+	uint64 FrameNumber;
+
+	FEnvQueryItemValues() { Reset(); }
+
+	void Reset();
+	void AllocateValues(int32 InNumValuesPerItem);
+	bool IsValidFor(const FEnvQueryInstance& QueryInstance) const;
+
+	FORCEINLINE int32 Num() const { return ItemIndices.Num(); }
+	FORCEINLINE float* GetValues(int32 ValueIndex) { return Values.GetData() + ValueIndex * ItemIndices.Num(); }
+	FORCEINLINE const float* GetValues(int32 ValueIndex) const { return Values.GetData() + ValueIndex * ItemIndices.Num(); }
+	FORCEINLINE FVector GetItemLocation(int32 Index) const { return FVector(ItemX[Index], ItemY[Index], ItemZ[Index]); }
+};
+
 #if NO_LOGGING
 #define EQSHEADERLOG(...)
 #else
@@ -807,6 +854,9 @@ struct AIMODULE_API FEnvQueryInstance : public FEnvQueryResult
 	/** item type's CDO for actor tests */
 	UEnvQueryItemType_ActorBase* ItemTypeActorCDO;
 
+	/** raw values of current test, computed before the step runs. See FEQSHelpers::ComputeTestValuesInParallel */
+	FEnvQueryItemValues PrecomputedValues;
+
 	FEnvQueryInstance();
 	FEnvQueryInstance(const FEnvQueryInstance& Other);
 	~FEnvQueryInstance();
@@ -814,6 +864,10 @@ struct AIMODULE_API FEnvQueryInstance : public FEnvQueryResult
 	/** execute single step of query */
 	void ExecuteOneStep(float TimeLimit);
 
+	/** gather data needed to compute values of current test for all remaining items off the game thread,
+	 *  returns false if current step is not a test supporting it */
+	bool PrepareTestValues();
+
 	/** update context cache */
 	bool PrepareContext(UClass* Context, FEnvQueryContextData& ContextData);
 
@@ -1250,6 +1304,14 @@ public:
 namespace FEQSHelpers
 {
 	AIMODULE_API const ANavigationData* FindNavigationDataForQuery(FEnvQueryInstance& QueryInstance);
+
+	/** true if tests should compute item values on worker threads when possible (ai.eqs.ParallelTests) */
+	AIMODULE_API bool ShouldRunTestsInParallel();
+
+	/** prepare next step of every instance with a test supporting it (see FEnvQueryInstance::PrepareTestValues) and
+	 *  compute values of all of them at once on worker threads. Values are consumed by next ExecuteOneStep of each instance.
+	 *  @return number of instances with precomputed values */
+	AIMODULE_API int32 ComputeTestValuesInParallel(TArrayView<FEnvQueryInstance* const> QueryInstances);
 }
 
 USTRUCT(BlueprintType)
@@ -43,6 +43,8 @@ protected:
 	bool bAbsoluteValue;
 
 	virtual void RunTest(FEnvQueryInstance& QueryInstance) const override;
+	virtual bool PrepareItemValues(FEnvQueryInstance& QueryInstance, FEnvQueryItemValues& ItemValues) const override;
+	virtual void ComputeItemValues(FEnvQueryItemValues& ItemValues, int32 FirstItem, int32 NumItems) const override;
 
 	virtual FText GetDescriptionTitle() const override;
 	virtual FText GetDescriptionDetails() const override;
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "UObject/ObjectMacros.h"
 #include "GenericTeamAgentInterface.h"
+#include "WorldCollision.h"
 #include "Perception/AISense.h"
 #include "AISense_Sight.generated.h"
 
@@ -78,10 +79,12 @@ struct FAISightQuery
 	FVector LastSeenLocation;
 
 	uint64 bLastResult:1;
-	uint64 LastProcessedFrameNumber :63;
+	/** An async line of sight trace has been requested for the query, its result is applied on the next update */
+	uint64 bTracePending:1;
+	uint64 LastProcessedFrameNumber :62;
 
 	FAISightQuery(FPerceptionListenerID ListenerId = FPerceptionListenerID::InvalidID(), FAISightTarget::FTargetId Target = FAISightTarget::InvalidTargetId)
-		: ObserverId(ListenerId), TargetId(Target), Score(0), Importance(0), LastSeenLocation(FAISystem::InvalidLocation), bLastResult(false), LastProcessedFrameNumber(GFrameCounter)
+		: ObserverId(ListenerId), TargetId(Target), Score(0), Importance(0), LastSeenLocation(FAISystem::InvalidLocation), bLastResult(false), bTracePending(false), LastProcessedFrameNumber(GFrameCounter)
 	{
 	}
 
@@ -170,8 +173,36 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "AI Perception", config)
 	float SightLimitQueryImportance;
 
+	/** If set, line of sight traces are requested as async traces and their results are applied on the next update, instead of tracing on the game thread */
+	UPROPERTY(EditDefaultsOnly, Category = "AI Perception", config)
+	bool bUseAsyncTraces;
+
+	/** Async line of sight traces requested per tick for each task graph worker thread, used instead of MaxTracesPerTick when bUseAsyncTraces is set */
+	UPROPERTY(EditDefaultsOnly, Category = "AI Perception", config)
+	int32 MaxAsyncTracesPerWorkerThread;
+
 	ECollisionChannel DefaultSightCollisionChannel;
 
+	/** Line of sight trace requested for a sight query, waiting for its result */
+	struct FPendingSightTrace
+	{
+		FTraceHandle TraceHandle;
+		FPerceptionListenerID ObserverId;
+		FAISightTarget::FTargetId TargetId;
+		FVector TargetLocation;
+		TWeakObjectPtr<AActor> HitActor;
+		uint64 RequestFrameNumber;
+		/** Frames since the query was processed, when the trace was requested */
+		uint32 AgeWhenRequested;
+		bool bCompleted;
+		bool bHit;
+	};
+	TArray<FPendingSightTrace> PendingSightTraces;
+	FTraceDelegate SightTraceDelegate;
+
+	/** Average number of frames between two updates of the sight queries of each listener */
+	TMap<FPerceptionListenerID, float> ListenerLatencies;
+
 public:
 
 	virtual void PostInitProperties() override;
@@ -184,9 +215,25 @@ public:
 	virtual void OnListenerForgetsActor(const FPerceptionListener& Listener, AActor& ActorToForget) override;
 	virtual void OnListenerForgetsAll(const FPerceptionListener& Listener) override;
 
+	/** Returns the average number of frames between two updates of the sight queries of a listener, or -1 if none was updated yet */
+	float GetAverageListenerLatency(const FPerceptionListenerID& ListenerId) const;
+
+	/** Logs the average latency of the sight queries of every listener */
+	void LogListenerLatencies();
+
 protected:
 	virtual float Update() override;
 
+	/** Number of async line of sight traces that can be requested in a tick, scaled by the number of worker threads running async traces */
+	int32 GetMaxAsyncTracesPerTick() const;
+
+	void OnSightTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/** Applies the results of the async line of sight traces requested by the previous update */
+	void ApplyPendingSightTraces();
+
+	void RecordListenerLatency(const FPerceptionListenerID& ListenerId, uint64 LatencyFrames);
+
 	virtual bool ShouldAutomaticallySeeTarget(const FDigestedSightProperties& PropDigest, FAISightQuery* SightQuery, FPerceptionListener& Listener, AActor* TargetActor, float& OutStimulusStrength) const;
 
 	void OnNewListenerImpl(const FPerceptionListener& NewListener);
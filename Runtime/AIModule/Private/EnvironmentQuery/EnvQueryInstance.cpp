@@ -427,7 +427,15 @@ void FEnvQueryInstance::ExecuteOneStep(float TimeLimit)
 
 		{
 			FScopeCycleCounterUObject TestScope(TestObject);
-			TestObject->RunTest(*this);
+			if (PrecomputedValues.IsValidFor(*this))
+			{
+				TestObject->ApplyItemValues(*this, PrecomputedValues);
+			}
+			else
+			{
+				TestObject->RunTest(*this);
+			}
+			PrecomputedValues.Reset();
 		}
 
 		bStepDone = CurrentTestStartingItem >= Items.Num() || bFoundSingleResult
@@ -489,6 +497,56 @@ void FEnvQueryInstance::ExecuteOneStep(float TimeLimit)
 	}
 }
 
+bool FEnvQueryInstance::PrepareTestValues()
+{
+	PrecomputedValues.Reset();
+
+	if (IsFinished() || !Owner.IsValid() || !Options.IsValidIndex(OptionIndex))
+	{
+		return false;
+	}
+
+	FEnvQueryOptionInstance& OptionItem = Options[OptionIndex];
+	if (!OptionItem.Tests.IsValidIndex(CurrentTest) || NumValidItems <= 0)
+	{
+		return false;
+	}
+
+	// final condition of SingleResult query stops at first passing item, computing all of them would be a waste
+	const UEnvQueryTest* TestObject = OptionItem.Tests[CurrentTest];
+	const bool bDoingLastTest = (CurrentTest >= OptionItem.Tests.Num() - 1);
+	if ((bDoingLastTest && Mode == EEnvQueryRunMode::SingleResult && TestObject->CanRunAsFinalCondition()) || !TestObject->GetWorkOnFloatValues())
+	{
+		return false;
+	}
+
+	PrecomputedValues.OptionIndex = OptionIndex;
+	PrecomputedValues.TestIndex = CurrentTest;
+	PrecomputedValues.StartingItem = CurrentTestStartingItem;
+	PrecomputedValues.FrameNumber = GFrameCounter;
+	PrecomputedValues.ItemIndices.Reserve(NumValidItems);
+	PrecomputedValues.ItemX.Reserve(NumValidItems);
+	PrecomputedValues.ItemY.Reserve(NumValidItems);
+	PrecomputedValues.ItemZ.Reserve(NumValidItems);
+
+	for (FConstItemIterator It(*this); It; ++It)
+	{
+		const FVector ItemLocation = TestObject->GetItemLocation(*this, It.GetIndex());
+		PrecomputedValues.ItemIndices.Add(It.GetIndex());
+		PrecomputedValues.ItemX.Add(ItemLocation.X);
+		PrecomputedValues.ItemY.Add(ItemLocation.Y);
+		PrecomputedValues.ItemZ.Add(ItemLocation.Z);
+	}
+
+	if (PrecomputedValues.Num() == 0 || !TestObject->PrepareItemValues(*this, PrecomputedValues))
+	{
+		PrecomputedValues.Reset();
+		return false;
+	}
+
+	return true;
+}
+
 FString FEnvQueryInstance::GetExecutionTimeDescription() const
 {
 	FString Description = FString::Printf(TEXT("Total Execution Time: %.2f ms"), TotalExecutionTime * 1000.f);
@@ -769,6 +827,9 @@ void FEnvQueryInstance::PickSingleItem(int32 ItemIndex)
 
 void FEnvQueryInstance::FinalizeQuery()
 {
+	// release buffers of parallel test values, instance is kept alive as query result
+	PrecomputedValues = FEnvQueryItemValues();
+
 	if (NumValidItems > 0)
 	{
 		if (Mode == EEnvQueryRunMode::SingleResult)
@@ -39,6 +39,7 @@ DEFINE_STAT(STAT_AI_EQS_LoadTime);
 DEFINE_STAT(STAT_AI_EQS_ExecuteOneStep);
 DEFINE_STAT(STAT_AI_EQS_GeneratorTime);
 DEFINE_STAT(STAT_AI_EQS_TestTime);
+DEFINE_STAT(STAT_AI_EQS_ParallelTestValues);
 DEFINE_STAT(STAT_AI_EQS_NumInstances);
 DEFINE_STAT(STAT_AI_EQS_NumItems);
 DEFINE_STAT(STAT_AI_EQS_InstanceMemory);
@@ -116,6 +117,7 @@ UEnvQueryManager::UEnvQueryManager(const FObjectInitializer& ObjectInitializer)
 
 	QueryCountWarningThreshold = 0;
 	QueryCountWarningInterval = 30.0;
+	MaxParallelTestItemsPerTick = 32768;
 #if !(UE_BUILD_SHIPPING)
 	LastQueryCountWarningThresholdTime = -FLT_MAX;
 #endif
@@ -363,6 +365,11 @@ void UEnvQueryManager::Tick(float DeltaTime)
 
 	{
 		SCOPE_CYCLE_COUNTER(STAT_AI_EQS_TickWork);
+
+		if (FEQSHelpers::ShouldRunTestsInParallel())
+		{
+			ComputeTestValuesInParallel();
+		}
 		
 		const int32 NumRunningQueries = RunningQueries.Num();
 		int32 Index = 0;
@@ -516,6 +523,32 @@ void UEnvQueryManager::Tick(float DeltaTime)
 	}
 }
 
+void UEnvQueryManager::ComputeTestValuesInParallel()
+{
+	TArray<FEnvQueryInstance*, TInlineAllocator<64>> QueryInstances;
+	int32 NumItems = 0;
+
+	for (const TSharedPtr<FEnvQueryInstance>& QueryInstance : RunningQueries)
+	{
+		if (QueryInstance.IsValid() && !QueryInstance->IsFinished())
+		{
+			QueryInstances.Add(QueryInstance.Get());
+			NumItems += QueryInstance->NumValidItems;
+
+			// when testing using depth, only the first query will make progress this update
+			if (!bTestQueriesUsingBreadth || NumItems >= MaxParallelTestItemsPerTick)
+			{
+				break;
+			}
+		}
+	}
+
+	if (QueryInstances.Num() > 0)
+	{
+		FEQSHelpers::ComputeTestValuesInParallel(QueryInstances);
+	}
+}
+
 #if !(UE_BUILD_SHIPPING)
 void UEnvQueryManager::CheckQueryCount() const
 {
@@ -21,6 +21,31 @@ UEnvQueryTest::UEnvQueryTest(const FObjectInitializer& ObjectInitializer) : Supe
 	bWorkOnFloatValues = true;
 }
 
+void UEnvQueryTest::ApplyItemValues(FEnvQueryInstance& QueryInstance, const FEnvQueryItemValues& ItemValues) const
+{
+	// only tests working on float values can precompute them
+	check(GetWorkOnFloatValues());
+
+	// all values are already computed, applying them is cheap enough to skip time slicing
+	FEnvQueryInstance::ItemIterator It(this, QueryInstance);
+	It.IgnoreTimeLimit();
+
+	int32 ValueIndex = 0;
+	for (; It; ++It)
+	{
+		for (; ValueIndex < ItemValues.Num() && ItemValues.ItemIndices[ValueIndex] < It.GetIndex(); ValueIndex++)
+			;
+
+		if (ItemValues.ItemIndices.IsValidIndex(ValueIndex) && ItemValues.ItemIndices[ValueIndex] == It.GetIndex())
+		{
+			for (int32 Idx = 0; Idx < ItemValues.NumValuesPerItem; Idx++)
+			{
+				It.SetScore(TestPurpose, FilterType, ItemValues.GetValues(Idx)[ValueIndex], ItemValues.FilterMin, ItemValues.FilterMax);
+			}
+		}
+	}
+}
+
 void UEnvQueryTest::NormalizeItemScores(FEnvQueryInstance& QueryInstance)
 {
 	UObject* QueryOwner = QueryInstance.Owner.Get();
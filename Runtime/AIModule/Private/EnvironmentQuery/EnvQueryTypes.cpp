@@ -17,6 +17,10 @@
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
 #include "EnvironmentQuery/EnvQueryManager.h"
+#include "EnvironmentQuery/EnvQueryTest.h"
+#include "Async/ParallelFor.h"
+#include "Misc/App.h"
+#include "HAL/IConsoleManager.h"
 
 #define LOCTEXT_NAMESPACE "EnvQueryGenerator"
 
@@ -278,6 +282,59 @@ void FEnvTraceData::OnPostLoad()
 //----------------------------------------------------------------------//
 namespace FEQSHelpers
 {
+	static int32 ParallelTests = 0;
+	FAutoConsoleVariableRef CVarParallelTests(TEXT("ai.eqs.ParallelTests"), ParallelTests,
+		TEXT("If set, tests supporting it compute values of all items of running queries at once on worker threads, and line traces are batched."), ECVF_Default);
+
+	static int32 ParallelItemsPerTask = 256;
+	FAutoConsoleVariableRef CVarParallelItemsPerTask(TEXT("ai.eqs.ParallelItemsPerTask"), ParallelItemsPerTask,
+		TEXT("Number of items evaluated by a single worker task when computing test values in parallel."), ECVF_Default);
+
+	bool ShouldRunTestsInParallel()
+	{
+		return ParallelTests != 0;
+	}
+
+	int32 ComputeTestValuesInParallel(TArrayView<FEnvQueryInstance* const> QueryInstances)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_AI_EQS_ParallelTestValues);
+
+		struct FWorkChunk
+		{
+			FEnvQueryInstance* QueryInstance;
+			const UEnvQueryTest* TestObject;
+			int32 FirstItem;
+			int32 NumItems;
+		};
+
+		const int32 ItemsPerTask = FMath::Max(ParallelItemsPerTask, 1);
+		TArray<FWorkChunk> Chunks;
+		int32 NumPreparedInstances = 0;
+
+		for (FEnvQueryInstance* QueryInstance : QueryInstances)
+		{
+			if (QueryInstance && QueryInstance->PrepareTestValues())
+			{
+				const UEnvQueryTest* TestObject = QueryInstance->Options[QueryInstance->OptionIndex].Tests[QueryInstance->CurrentTest];
+				const int32 NumItems = QueryInstance->PrecomputedValues.Num();
+				for (int32 FirstItem = 0; FirstItem < NumItems; FirstItem += ItemsPerTask)
+				{
+					Chunks.Add({ QueryInstance, TestObject, FirstItem, FMath::Min(ItemsPerTask, NumItems - FirstItem) });
+				}
+
+				NumPreparedInstances++;
+			}
+		}
+
+		ParallelFor(Chunks.Num(), [&Chunks](int32 ChunkIndex)
+		{
+			const FWorkChunk& Chunk = Chunks[ChunkIndex];
+			Chunk.TestObject->ComputeItemValues(Chunk.QueryInstance->PrecomputedValues, Chunk.FirstItem, Chunk.NumItems);
+		}, !FApp::ShouldUseThreadingForPerformance());
+
+		return NumPreparedInstances;
+	}
+
 	const ANavigationData* FindNavigationDataForQuery(FEnvQueryInstance& QueryInstance)
 	{
 		const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(QueryInstance.World);
@@ -299,6 +356,45 @@ namespace FEQSHelpers
 	}
 }
 
+//----------------------------------------------------------------------//
+// FEnvQueryItemValues
+//----------------------------------------------------------------------//
+void FEnvQueryItemValues::Reset()
+{
+	ItemIndices.Reset();
+	ItemX.Reset();
+	ItemY.Reset();
+	ItemZ.Reset();
+	ContextVectors[0].Reset();
+	ContextVectors[1].Reset();
+	Values.Reset();
+	NumValuesPerItem = 0;
+	FilterMin = 0.f;
+	FilterMax = 0.f;
+	TestFlags = 0;
+	OptionIndex = INDEX_NONE;
+	TestIndex = INDEX_NONE;
+	StartingItem = INDEX_NONE;
+	FrameNumber = 0;
+}
+
+void FEnvQueryItemValues::AllocateValues(int32 InNumValuesPerItem)
+{
+	NumValuesPerItem = InNumValuesPerItem;
+	Values.SetNumUninitialized(NumValuesPerItem * ItemIndices.Num());
+}
+
+bool FEnvQueryItemValues::IsValidFor(const FEnvQueryInstance& QueryInstance) const
+{
+	// values are computed from context data gathered this frame, don't use them if the step was postponed
+	return ItemIndices.Num() > 0 && NumValuesPerItem > 0
+		&& OptionIndex == QueryInstance.OptionIndex
+		&& TestIndex == QueryInstance.CurrentTest
+		&& StartingItem == QueryInstance.CurrentTestStartingItem
+		&& FrameNumber == GFrameCounter
+		&& !QueryInstance.IsInSingleItemFinalSearch();
+}
+
 //----------------------------------------------------------------------//
 // FEnvQueryInstance
 //----------------------------------------------------------------------//
@@ -135,6 +135,89 @@ void UEnvQueryTest_Distance::RunTest(FEnvQueryInstance& QueryInstance) const
 	}
 }
 
+bool UEnvQueryTest_Distance::PrepareItemValues(FEnvQueryInstance& QueryInstance, FEnvQueryItemValues& ItemValues) const
+{
+	UObject* QueryOwner = QueryInstance.Owner.Get();
+	if (QueryOwner == nullptr)
+	{
+		return false;
+	}
+
+	FloatValueMin.BindData(QueryOwner, QueryInstance.QueryID);
+	ItemValues.FilterMin = FloatValueMin.GetValue();
+
+	FloatValueMax.BindData(QueryOwner, QueryInstance.QueryID);
+	ItemValues.FilterMax = FloatValueMax.GetValue();
+
+	TArray<FVector>& ContextLocations = ItemValues.ContextVectors[0];
+	if (!QueryInstance.PrepareContext(DistanceTo, ContextLocations))
+	{
+		return false;
+	}
+
+	for (int32 ContextIndex = 0; ContextIndex < ContextLocations.Num(); ContextIndex++)
+	{
+		CheckContextLocationForNaN(ContextLocations[ContextIndex], QueryOwner, ContextIndex, TestMode);
+	}
+
+	ItemValues.AllocateValues(ContextLocations.Num());
+	return true;
+}
+
+void UEnvQueryTest_Distance::ComputeItemValues(FEnvQueryItemValues& ItemValues, int32 FirstItem, int32 NumItems) const
+{
+	const float* RESTRICT ItemX = ItemValues.ItemX.GetData() + FirstItem;
+	const float* RESTRICT ItemY = ItemValues.ItemY.GetData() + FirstItem;
+	const float* RESTRICT ItemZ = ItemValues.ItemZ.GetData() + FirstItem;
+
+	for (int32 ContextIndex = 0; ContextIndex < ItemValues.ContextVectors[0].Num(); ContextIndex++)
+	{
+		const FVector ContextLocation = ItemValues.ContextVectors[0][ContextIndex];
+		float* RESTRICT Distances = ItemValues.GetValues(ContextIndex) + FirstItem;
+
+		// same math as CalcDistance* helpers, written on separate components so loops can be vectorized
+		switch (TestMode)
+		{
+			case EEnvTestDistance::Distance3D:
+				for (int32 Idx = 0; Idx < NumItems; Idx++)
+				{
+					const float DeltaX = ContextLocation.X - ItemX[Idx];
+					const float DeltaY = ContextLocation.Y - ItemY[Idx];
+					const float DeltaZ = ContextLocation.Z - ItemZ[Idx];
+					Distances[Idx] = FMath::Sqrt(DeltaX * DeltaX + DeltaY * DeltaY + DeltaZ * DeltaZ);
+				}
+				break;
+
+			case EEnvTestDistance::Distance2D:
+				for (int32 Idx = 0; Idx < NumItems; Idx++)
+				{
+					const float DeltaX = ContextLocation.X - ItemX[Idx];
+					const float DeltaY = ContextLocation.Y - ItemY[Idx];
+					Distances[Idx] = FMath::Sqrt(DeltaX * DeltaX + DeltaY * DeltaY);
+				}
+				break;
+
+			case EEnvTestDistance::DistanceZ:
+				for (int32 Idx = 0; Idx < NumItems; Idx++)
+				{
+					Distances[Idx] = ContextLocation.Z - ItemZ[Idx];
+				}
+				break;
+
+			case EEnvTestDistance::DistanceAbsoluteZ:
+				for (int32 Idx = 0; Idx < NumItems; Idx++)
+				{
+					Distances[Idx] = FMath::Abs(ContextLocation.Z - ItemZ[Idx]);
+				}
+				break;
+
+			default:
+				checkNoEntry();
+				return;
+		}
+	}
+}
+
 FText UEnvQueryTest_Distance::GetDescriptionTitle() const
 {
 	FString ModeDesc;
@@ -5,6 +5,24 @@
 #include "EnvironmentQuery/Contexts/EnvQueryContext_Querier.h"
 #include "EnvironmentQuery/Contexts/EnvQueryContext_Item.h"
 
+namespace
+{
+	/** FEnvQueryItemValues::TestFlags bits, per line: directions depend on item location, and line starts at item */
+	FORCEINLINE uint32 LinePerItemFlag(int32 LineIndex) { return 1u << (LineIndex * 2); }
+	FORCEINLINE uint32 LineFromItemFlag(int32 LineIndex) { return 1u << (LineIndex * 2 + 1); }
+
+	FORCEINLINE FVector GetLineDirection(const FEnvQueryItemValues& ItemValues, int32 LineIndex, int32 Index, const FVector& ItemLocation)
+	{
+		const FVector& ContextVector = ItemValues.ContextVectors[LineIndex][Index];
+		if ((ItemValues.TestFlags & LinePerItemFlag(LineIndex)) == 0)
+		{
+			return ContextVector;
+		}
+
+		return (ItemValues.TestFlags & LineFromItemFlag(LineIndex)) ? (ContextVector - ItemLocation).GetSafeNormal() : (ItemLocation - ContextVector).GetSafeNormal();
+	}
+}
+
 UEnvQueryTest_Dot::UEnvQueryTest_Dot(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	Cost = EEnvTestCost::Low;
@@ -115,6 +133,87 @@ void UEnvQueryTest_Dot::RunTest(FEnvQueryInstance& QueryInstance) const
 	}
 }
 
+bool UEnvQueryTest_Dot::PrepareItemValues(FEnvQueryInstance& QueryInstance, FEnvQueryItemValues& ItemValues) const
+{
+	UObject* QueryOwner = QueryInstance.Owner.Get();
+	if (QueryOwner == nullptr || (TestMode != EEnvTestDot::Dot3D && TestMode != EEnvTestDot::Dot2D))
+	{
+		return false;
+	}
+
+	FloatValueMin.BindData(QueryOwner, QueryInstance.QueryID);
+	ItemValues.FilterMin = FloatValueMin.GetValue();
+
+	FloatValueMax.BindData(QueryOwner, QueryInstance.QueryID);
+	ItemValues.FilterMax = FloatValueMax.GetValue();
+
+	const FEnvDirection* Lines[] = { &LineA, &LineB };
+	for (int32 LineIndex = 0; LineIndex < 2; LineIndex++)
+	{
+		const FEnvDirection& Line = *Lines[LineIndex];
+		TArray<FVector>& LineData = ItemValues.ContextVectors[LineIndex];
+		const bool bUseDirectionContext = (Line.DirMode == EEnvDirection::Rotation);
+
+		if (!RequiresPerItemUpdates(Line.LineFrom, Line.LineTo, Line.Rotation, bUseDirectionContext))
+		{
+			GatherLineDirections(LineData, QueryInstance, Line.LineFrom, Line.LineTo, Line.Rotation, bUseDirectionContext);
+		}
+		// only lines between item and other context can be computed from item locations, item rotations are not gathered
+		else if (!bUseDirectionContext && (IsContextPerItem(Line.LineFrom) != IsContextPerItem(Line.LineTo)))
+		{
+			const bool bFromItem = IsContextPerItem(Line.LineFrom);
+			QueryInstance.PrepareContext(bFromItem ? Line.LineTo : Line.LineFrom, LineData);
+
+			ItemValues.TestFlags |= LinePerItemFlag(LineIndex) | (bFromItem ? LineFromItemFlag(LineIndex) : 0);
+		}
+		else
+		{
+			return false;
+		}
+
+		if (LineData.Num() == 0)
+		{
+			return false;
+		}
+	}
+
+	ItemValues.AllocateValues(ItemValues.ContextVectors[0].Num() * ItemValues.ContextVectors[1].Num());
+	return true;
+}
+
+void UEnvQueryTest_Dot::ComputeItemValues(FEnvQueryItemValues& ItemValues, int32 FirstItem, int32 NumItems) const
+{
+	const int32 NumLineADirs = ItemValues.ContextVectors[0].Num();
+	const int32 NumLineBDirs = ItemValues.ContextVectors[1].Num();
+
+	for (int32 ItemIndex = FirstItem; ItemIndex < FirstItem + NumItems; ItemIndex++)
+	{
+		const FVector ItemLocation = ItemValues.GetItemLocation(ItemIndex);
+
+		for (int32 LineAIndex = 0; LineAIndex < NumLineADirs; LineAIndex++)
+		{
+			const FVector LineADir = GetLineDirection(ItemValues, 0, LineAIndex, ItemLocation);
+
+			for (int32 LineBIndex = 0; LineBIndex < NumLineBDirs; LineBIndex++)
+			{
+				const FVector LineBDir = GetLineDirection(ItemValues, 1, LineBIndex, ItemLocation);
+
+				float DotValue = (TestMode == EEnvTestDot::Dot3D) ? FVector::DotProduct(LineADir, LineBDir) : LineADir.CosineAngle2D(LineBDir);
+				if (FMath::IsNaN(DotValue))
+				{
+					DotValue = 0.f;
+				}
+				else if (bAbsoluteValue)
+				{
+					DotValue = FMath::Abs(DotValue);
+				}
+
+				ItemValues.GetValues(LineAIndex * NumLineBDirs + LineBIndex)[ItemIndex] = DotValue;
+			}
+		}
+	}
+}
+
 void UEnvQueryTest_Dot::GatherLineDirections(TArray<FVector>& Directions, FEnvQueryInstance& QueryInstance, const FVector& ItemLocation,
 	TSubclassOf<UEnvQueryContext> LineFrom, TSubclassOf<UEnvQueryContext> LineTo) const
 {
@@ -77,6 +77,39 @@ void UEnvQueryTest_Trace::RunTest(FEnvQueryInstance& QueryInstance) const
 		ContextLocations[ContextIndex].Z += ContextZ;
 	}
 
+	// batched traces share query params, so they can't ignore item actors: use them only for point items
+	if (TraceData.TraceShape == EEnvTraceShape::Line && QueryInstance.ItemTypeActorCDO == nullptr && QueryInstance.World
+		&& QueryInstance.CanBatchTest() && FEQSHelpers::ShouldRunTestsInParallel())
+	{
+		TArray<FVector> TraceStarts;
+		TArray<FVector> TraceEnds;
+		for (FEnvQueryInstance::FConstItemIterator It(QueryInstance); It; ++It)
+		{
+			const FVector ItemLocation = GetItemLocation(QueryInstance, It.GetIndex()) + FVector(0, 0, ItemZ);
+			for (int32 ContextIndex = 0; ContextIndex < ContextLocations.Num(); ContextIndex++)
+			{
+				TraceStarts.Add(bTraceToItem ? ContextLocations[ContextIndex] : ItemLocation);
+				TraceEnds.Add(bTraceToItem ? ItemLocation : ContextLocations[ContextIndex]);
+			}
+		}
+
+		TArray<FHitResult> TraceHits;
+		QueryInstance.World->LineTraceBatchByChannel(EAsyncTraceType::Test, TraceHits, TraceStarts, TraceEnds, TraceCollisionChannel, TraceParams);
+
+		// all traces are done, applying results is cheap enough to skip time slicing
+		FEnvQueryInstance::ItemIterator It(this, QueryInstance);
+		It.IgnoreTimeLimit();
+		for (int32 TraceIndex = 0; It; ++It)
+		{
+			for (int32 ContextIndex = 0; ContextIndex < ContextLocations.Num(); ContextIndex++, TraceIndex++)
+			{
+				It.SetScore(TestPurpose, FilterType, TraceHits[TraceIndex].bBlockingHit, bWantsHit);
+			}
+		}
+
+		return;
+	}
+
 	for (FEnvQueryInstance::ItemIterator It(this, QueryInstance); It; ++It)
 	{
 		const FVector ItemLocation = GetItemLocation(QueryInstance, It.GetIndex()) + FVector(0, 0, ItemZ);
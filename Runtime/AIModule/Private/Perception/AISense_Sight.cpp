@@ -10,6 +10,8 @@
 #include "VisualLogger/VisualLogger.h"
 #include "Perception/AISightTargetInterface.h"
 #include "Perception/AISenseConfig_Sight.h"
+#include "Misc/App.h"
+#include "UObject/UObjectIterator.h"
 
 #define DO_SIGHT_VLOGGING (0 && ENABLE_VISUAL_LOG)
 
@@ -27,10 +29,36 @@ DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Listener Update"), STAT_AI_Sen
 DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Register Target"), STAT_AI_Sense_Sight_RegisterTarget, STATGROUP_AI);
 DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Remove By Listener"), STAT_AI_Sense_Sight_RemoveByListener, STATGROUP_AI);
 DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Remove To Target"), STAT_AI_Sense_Sight_RemoveToTarget, STATGROUP_AI);
+DECLARE_CYCLE_STAT(TEXT("Perception Sense: Sight, Apply Async Traces"), STAT_AI_Sense_Sight_ApplyAsyncTraces, STATGROUP_AI);
 
 
 static const int32 DefaultMaxTracesPerTick = 6;
 static const int32 DefaultMinQueriesPerTimeSliceCheck = 40;
+static const int32 DefaultMaxAsyncTracesPerWorkerThread = 16;
+
+namespace AISenseSight
+{
+	/** Weight of the latest sample in the per listener latency moving average */
+	static const float LatencySmoothingFactor = 0.1f;
+
+	FORCEINLINE uint64 MakeQueryKey(const FPerceptionListenerID& ObserverId, const FAISightTarget::FTargetId& TargetId)
+	{
+		return (uint64(uint32(ObserverId)) << 32) | uint64(TargetId);
+	}
+
+	static void LogListenerLatencies()
+	{
+		for (TObjectIterator<UAISense_Sight> It; It; ++It)
+		{
+			if (It->HasAnyFlags(RF_ClassDefaultObject) == false)
+			{
+				It->LogListenerLatencies();
+			}
+		}
+	}
+
+	FAutoConsoleCommand LogLatencyCmd(TEXT("ai.sight.LogLatency"), TEXT("Logs the average number of frames between two updates of the sight queries of every perception listener."), FConsoleCommandDelegate::CreateStatic(&LogListenerLatencies));
+}
 
 //----------------------------------------------------------------------//
 // helpers
@@ -131,6 +159,8 @@ UAISense_Sight::UAISense_Sight(const FObjectInitializer& ObjectInitializer)
 	, HighImportanceQueryDistanceThreshold(300.f)
 	, MaxQueryImportance(60.f)
 	, SightLimitQueryImportance(10.f)
+	, bUseAsyncTraces(false)
+	, MaxAsyncTracesPerWorkerThread(DefaultMaxAsyncTracesPerWorkerThread)
 {
 	if (HasAnyFlags(RF_ClassDefaultObject) == false)
 	{
@@ -140,6 +170,7 @@ UAISense_Sight::UAISense_Sight(const FObjectInitializer& ObjectInitializer)
 		OnNewListenerDelegate.BindUObject(this, &UAISense_Sight::OnNewListenerImpl);
 		OnListenerUpdateDelegate.BindUObject(this, &UAISense_Sight::OnListenerUpdateImpl);
 		OnListenerRemovedDelegate.BindUObject(this, &UAISense_Sight::OnListenerRemovedImpl);
+		SightTraceDelegate.BindUObject(this, &UAISense_Sight::OnSightTraceDone);
 	}
 
 	NotifyType = EAISenseNotifyType::OnPerceptionChange;
@@ -180,13 +211,16 @@ float UAISense_Sight::Update()
 {
 	SCOPE_CYCLE_COUNTER(STAT_AI_Sense_Sight);
 
-	const UWorld* World = GEngine->GetWorldFromContextObject(GetPerceptionSystem()->GetOuter(), EGetWorldErrorMode::LogAndReturnNull);
+	UWorld* World = GEngine->GetWorldFromContextObject(GetPerceptionSystem()->GetOuter(), EGetWorldErrorMode::LogAndReturnNull);
 
 	if (World == NULL)
 	{
 		return SuspendNextUpdate;
 	}
 
+	// async traces requested by the previous update have been run by now
+	ApplyPendingSightTraces();
+
 	// sort Sight Queries
 	{
 		auto RecalcScore = [](FAISightQuery& SightQuery)->EForEachResult
@@ -210,6 +244,7 @@ float UAISense_Sight::Update()
 		SightQueriesInRange.Sort(FAISightQuery::FSortPredicate());
 	}
 
+	const int32 MaxTraces = bUseAsyncTraces ? GetMaxAsyncTracesPerTick() : MaxTracesPerTick;
 	int32 TracesCount = 0;
 	int32 NumQueriesProcessed = 0;
 	double TimeSliceEnd = FPlatformTime::Seconds() + MaxTimeSlicePerTick;
@@ -271,10 +306,16 @@ float UAISense_Sight::Update()
 			// do not break here since that would bypass queue aging
 		}
 
-		if (TracesCount < MaxTracesPerTick && bHitTimeSliceLimit == false)
+		if (TracesCount < MaxTraces && bHitTimeSliceLimit == false)
 		{
 			bIsInRangeQuery ? ++InRangeItr : ++OutOfRangeItr;
 
+			if (SightQuery->bTracePending)
+			{
+				// waiting for the result of its async trace
+				continue;
+			}
+
 			FPerceptionListener& Listener = ListenersMap[SightQuery->ObserverId];
 			FAISightTarget& Target = ObservedTargets[SightQuery->TargetId];
 
@@ -330,6 +371,25 @@ float UAISense_Sight::Update()
 
 						TracesCount += NumberOfLoSChecksPerformed;
 					}
+					else if (bUseAsyncTraces)
+					{
+						// the result is applied by the next update, see ApplyPendingSightTraces
+						FPendingSightTrace& PendingTrace = PendingSightTraces.AddDefaulted_GetRef();
+						PendingTrace.ObserverId = SightQuery->ObserverId;
+						PendingTrace.TargetId = SightQuery->TargetId;
+						PendingTrace.TargetLocation = TargetLocation;
+						PendingTrace.RequestFrameNumber = GFrameCounter;
+						PendingTrace.AgeWhenRequested = uint32(SightQuery->GetAge());
+						PendingTrace.bCompleted = false;
+						PendingTrace.bHit = false;
+						PendingTrace.TraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Listener.CachedLocation, TargetLocation
+							, DefaultSightCollisionChannel
+							, FCollisionQueryParams(SCENE_QUERY_STAT(AILineOfSight), true, ListenerPtr->GetBodyActor())
+							, FCollisionResponseParams::DefaultResponseParam, &SightTraceDelegate, PendingSightTraces.Num() - 1);
+
+						SightQuery->bTracePending = true;
+						++TracesCount;
+					}
 					else
 					{
 						// we need to do tests ourselves
@@ -381,6 +441,11 @@ float UAISense_Sight::Update()
 					QueryOperations.Add(FQueryOperation(bIsInRangeQuery, EOperationType::SwapList, bIsInRangeQuery ? InRangeIndex : OutOfRangeIndex));
 				}
 
+				if (SightQuery->bTracePending == false)
+				{
+					RecordListenerLatency(SightQuery->ObserverId, uint64(SightQuery->GetAge()));
+				}
+
 				// restart query
 				SightQuery->OnProcessed();
 			}
@@ -476,6 +541,130 @@ float UAISense_Sight::Update()
 	return 0.f;
 }
 
+int32 UAISense_Sight::GetMaxAsyncTracesPerTick() const
+{
+	// async traces are run by the task graph worker threads
+	const int32 NumWorkerThreads = FApp::ShouldUseThreadingForPerformance() ? FTaskGraphInterface::Get().GetNumWorkerThreads() : 1;
+	return FMath::Max(MaxTracesPerTick, MaxAsyncTracesPerWorkerThread * FMath::Max(NumWorkerThreads, 1));
+}
+
+void UAISense_Sight::OnSightTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const int32 PendingTraceIndex = int32(TraceDatum.UserData);
+	if (PendingSightTraces.IsValidIndex(PendingTraceIndex) && PendingSightTraces[PendingTraceIndex].TraceHandle == TraceHandle)
+	{
+		FPendingSightTrace& PendingTrace = PendingSightTraces[PendingTraceIndex];
+		const FHitResult* BlockingHit = TraceDatum.OutHits.FindByPredicate([](const FHitResult& HitResult) { return HitResult.bBlockingHit; });
+
+		PendingTrace.bCompleted = true;
+		PendingTrace.bHit = (BlockingHit != nullptr);
+		PendingTrace.HitActor = BlockingHit ? BlockingHit->Actor : TWeakObjectPtr<AActor>();
+	}
+}
+
+void UAISense_Sight::ApplyPendingSightTraces()
+{
+	if (PendingSightTraces.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_AI_Sense_Sight_ApplyAsyncTraces);
+
+	TMap<uint64, int32> PendingTraceIndices;
+	PendingTraceIndices.Reserve(PendingSightTraces.Num());
+	for (int32 Index = 0; Index < PendingSightTraces.Num(); ++Index)
+	{
+		PendingTraceIndices.Add(AISenseSight::MakeQueryKey(PendingSightTraces[Index].ObserverId, PendingSightTraces[Index].TargetId), Index);
+	}
+
+	AIPerception::FListenerMap& ListenersMap = *GetListeners();
+	int32 NumPendingQueries = PendingSightTraces.Num();
+
+	auto ApplyTraceResult = [this, &ListenersMap, &PendingTraceIndices, &NumPendingQueries](FAISightQuery& SightQuery)->EForEachResult
+	{
+		if (SightQuery.bTracePending == false)
+		{
+			return EForEachResult::Continue;
+		}
+
+		// queries whose trace did not complete are processed again like any other query
+		SightQuery.bTracePending = false;
+
+		const int32* PendingTraceIndex = PendingTraceIndices.Find(AISenseSight::MakeQueryKey(SightQuery.ObserverId, SightQuery.TargetId));
+		FPerceptionListener* Listener = ListenersMap.Find(SightQuery.ObserverId);
+		const FAISightTarget* Target = ObservedTargets.Find(SightQuery.TargetId);
+		AActor* TargetActor = Target ? Target->Target.Get() : nullptr;
+
+		if (PendingTraceIndex && PendingSightTraces[*PendingTraceIndex].bCompleted && Listener && Listener->Listener.IsValid() && TargetActor)
+		{
+			const FPendingSightTrace& PendingTrace = PendingSightTraces[*PendingTraceIndex];
+			AActor* HitResultActor = PendingTrace.HitActor.Get();
+
+			if (PendingTrace.bHit == false || (HitResultActor && HitResultActor->IsOwnedBy(TargetActor)))
+			{
+				Listener->RegisterStimulus(TargetActor, FAIStimulus(*this, 1.f, PendingTrace.TargetLocation, Listener->CachedLocation));
+				SightQuery.bLastResult = true;
+				SightQuery.LastSeenLocation = PendingTrace.TargetLocation;
+			}
+			// communicate failure only if we've seen give actor before
+			else if (SightQuery.bLastResult == true)
+			{
+				Listener->RegisterStimulus(TargetActor, FAIStimulus(*this, 0.f, PendingTrace.TargetLocation, Listener->CachedLocation, FAIStimulus::SensingFailed));
+				SightQuery.bLastResult = false;
+				SightQuery.LastSeenLocation = FAISystem::InvalidLocation;
+			}
+
+			RecordListenerLatency(SightQuery.ObserverId, PendingTrace.AgeWhenRequested + (GFrameCounter - PendingTrace.RequestFrameNumber));
+		}
+
+		return --NumPendingQueries > 0 ? EForEachResult::Continue : EForEachResult::Break;
+	};
+
+	if (ForEach(SightQueriesInRange, ApplyTraceResult) == EForEachResult::Continue)
+	{
+		ForEach(SightQueriesOutOfRange, ApplyTraceResult);
+	}
+
+	PendingSightTraces.Reset();
+}
+
+void UAISense_Sight::RecordListenerLatency(const FPerceptionListenerID& ListenerId, uint64 LatencyFrames)
+{
+	float* AverageLatency = ListenerLatencies.Find(ListenerId);
+	if (AverageLatency)
+	{
+		*AverageLatency = FMath::Lerp(*AverageLatency, float(LatencyFrames), AISenseSight::LatencySmoothingFactor);
+	}
+	else
+	{
+		ListenerLatencies.Add(ListenerId, float(LatencyFrames));
+	}
+}
+
+float UAISense_Sight::GetAverageListenerLatency(const FPerceptionListenerID& ListenerId) const
+{
+	const float* AverageLatency = ListenerLatencies.Find(ListenerId);
+	return AverageLatency ? *AverageLatency : -1.f;
+}
+
+void UAISense_Sight::LogListenerLatencies()
+{
+	const float AverageFrameTimeMs = FApp::GetDeltaTime() * 1000.f;
+	AIPerception::FListenerMap& ListenersMap = *GetListeners();
+
+	UE_LOG(LogAIPerception, Log, TEXT("%s: sight query latency of %d listeners (%s traces, %d pending)")
+		, *GetName(), ListenerLatencies.Num(), bUseAsyncTraces ? TEXT("async") : TEXT("sync"), PendingSightTraces.Num());
+
+	for (const TPair<FPerceptionListenerID, float>& Latency : ListenerLatencies)
+	{
+		const FPerceptionListener* Listener = ListenersMap.Find(Latency.Key);
+		const AActor* ListenerOwner = (Listener && Listener->Listener.IsValid()) ? Listener->Listener->GetOwner() : nullptr;
+
+		UE_LOG(LogAIPerception, Log, TEXT("    %s: %.1f frames (~%.1f ms)"), *GetNameSafe(ListenerOwner), Latency.Value, Latency.Value * AverageFrameTimeMs);
+	}
+}
+
 void UAISense_Sight::RegisterEvent(const FAISightEvent& Event)
 {
 
@@ -750,6 +939,7 @@ void UAISense_Sight::OnListenerRemovedImpl(const FPerceptionListener& RemovedLis
 	RemoveAllQueriesByListener(RemovedListener);
 
 	DigestedProperties.FindAndRemoveChecked(RemovedListener.GetListenerID());
+	ListenerLatencies.Remove(RemovedListener.GetListenerID());
 
 	// note: there use to be code to remove all queries _to_ listener here as well
 	// but that was wrong - the fact that a listener gets unregistered doesn't have to
@@ -0,0 +1,147 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+#include "EnvironmentQuery/EnvQueryTypes.h"
+#include "EnvironmentQuery/Items/EnvQueryItemType_Point.h"
+#include "EnvironmentQuery/Contexts/EnvQueryContext_Querier.h"
+#include "EnvironmentQuery/Generators/EnvQueryGenerator_SimpleGrid.h"
+#include "EnvironmentQuery/Tests/EnvQueryTest_Distance.h"
+#include "EnvironmentQuery/Tests/EnvQueryTest_Dot.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace EnvQueryParallelTestsPrivate
+{
+	static const int32 NumQueries = 256;
+	static const float QuerierSpacing = 1000.0f;
+
+	/** Creates a query running a 31x31 points grid around the querier, scored by distance and dot tests.
+	 *  Querier context is stored up front, so the query doesn't need a world, querier actor nor query manager. */
+	TSharedPtr<FEnvQueryInstance> CreateQueryInstance(UObject* Owner, UEnvQueryGenerator* Generator, const TArray<UEnvQueryTest*>& Tests, int32 QueryID)
+	{
+		TSharedPtr<FEnvQueryInstance> QueryInstance = MakeShareable(new FEnvQueryInstance());
+		QueryInstance->Owner = Owner;
+		QueryInstance->QueryID = QueryID;
+		QueryInstance->QueryName = TEXT("EnvQueryParallelTests");
+		QueryInstance->Mode = EEnvQueryRunMode::AllMatching;
+#if USE_EQS_DEBUGGER
+		QueryInstance->bStoreDebugInfo = false;
+#endif
+
+		FEnvQueryOptionInstance& OptionInstance = QueryInstance->Options.AddDefaulted_GetRef();
+		OptionInstance.Generator = Generator;
+		OptionInstance.Tests = Tests;
+		OptionInstance.SourceOptionIndex = 0;
+		OptionInstance.ItemType = UEnvQueryItemType_Point::StaticClass();
+		OptionInstance.bHasNavLocations = false;
+
+		const FVector QuerierLocation((QueryID % 16) * QuerierSpacing, (QueryID / 16) * QuerierSpacing, 0.0f);
+		FEnvQueryContextData& ContextData = QueryInstance->ContextCache.Add(UEnvQueryContext_Querier::StaticClass());
+		UEnvQueryItemType_Point::SetContextHelper(ContextData, QuerierLocation);
+
+		return QueryInstance;
+	}
+
+	/** Runs all queries to completion, stepping them in the same breadth first order as UEnvQueryManager. Returns time spent in seconds. */
+	double RunQueries(const TArray<TSharedPtr<FEnvQueryInstance>>& Queries, bool bParallel)
+	{
+		TArray<FEnvQueryInstance*> RunningQueries;
+		for (const TSharedPtr<FEnvQueryInstance>& QueryInstance : Queries)
+		{
+			RunningQueries.Add(QueryInstance.Get());
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		while (RunningQueries.Num())
+		{
+			if (bParallel)
+			{
+				FEQSHelpers::ComputeTestValuesInParallel(RunningQueries);
+			}
+
+			for (FEnvQueryInstance* QueryInstance : RunningQueries)
+			{
+				// no time limit
+				QueryInstance->ExecuteOneStep(0.0f);
+			}
+
+			RunningQueries.RemoveAll([](const FEnvQueryInstance* QueryInstance) { return QueryInstance->IsFinished(); });
+		}
+
+		return FPlatformTime::Seconds() - StartTime;
+	}
+}
+
+/**
+ * Runs the same set of queries with tests computed on the game thread and with test values computed on worker threads
+ * (FEQSHelpers::ComputeTestValuesInParallel), checks that both produce the same scores and reports queries completed per second.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnvQueryParallelTestsBenchmark, "System.AI.EQS.ParallelTests", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FEnvQueryParallelTestsBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace EnvQueryParallelTestsPrivate;
+
+	UEnvQueryGenerator_SimpleGrid* Generator = NewObject<UEnvQueryGenerator_SimpleGrid>(GetTransientPackage());
+	Generator->GridSize.DefaultValue = 1500.0f;
+	Generator->SpaceBetween.DefaultValue = 100.0f;
+	Generator->ProjectionData.TraceMode = EEnvQueryTrace::None;
+
+	UEnvQueryTest_Distance* DistanceTest = NewObject<UEnvQueryTest_Distance>(GetTransientPackage());
+	DistanceTest->TestPurpose = EEnvTestPurpose::Score;
+
+	// default lines: querier's rotation vs direction from querier to item
+	UEnvQueryTest_Dot* DotTest = NewObject<UEnvQueryTest_Dot>(GetTransientPackage());
+	DotTest->TestPurpose = EEnvTestPurpose::Score;
+
+	TArray<UEnvQueryTest*> Tests;
+	Tests.Add(DistanceTest);
+	Tests.Add(DotTest);
+	for (int32 TestIndex = 0; TestIndex < Tests.Num(); TestIndex++)
+	{
+		Tests[TestIndex]->TestOrder = TestIndex;
+	}
+
+	TArray<TSharedPtr<FEnvQueryInstance>> SerialQueries;
+	TArray<TSharedPtr<FEnvQueryInstance>> ParallelQueries;
+	for (int32 QueryIndex = 0; QueryIndex < NumQueries; QueryIndex++)
+	{
+		SerialQueries.Add(CreateQueryInstance(Generator, Generator, Tests, QueryIndex));
+		ParallelQueries.Add(CreateQueryInstance(Generator, Generator, Tests, QueryIndex));
+	}
+
+	const double SerialSeconds = RunQueries(SerialQueries, false);
+	const double ParallelSeconds = RunQueries(ParallelQueries, true);
+
+	for (int32 QueryIndex = 0; QueryIndex < NumQueries; QueryIndex++)
+	{
+		const FEnvQueryInstance& SerialQuery = *SerialQueries[QueryIndex];
+		const FEnvQueryInstance& ParallelQuery = *ParallelQueries[QueryIndex];
+		if (!TestEqual(TEXT("Query status"), int32(ParallelQuery.GetRawStatus()), int32(SerialQuery.GetRawStatus()))
+			|| !TestEqual(TEXT("Number of items"), ParallelQuery.Items.Num(), SerialQuery.Items.Num()))
+		{
+			return false;
+		}
+
+		for (int32 ItemIndex = 0; ItemIndex < SerialQuery.Items.Num(); ItemIndex++)
+		{
+			if (!FMath::IsNearlyEqual(SerialQuery.Items[ItemIndex].Score, ParallelQuery.Items[ItemIndex].Score, KINDA_SMALL_NUMBER))
+			{
+				AddError(FString::Printf(TEXT("Query %d item %d: score %f computed in parallel, expected %f"),
+					QueryIndex, ItemIndex, ParallelQuery.Items[ItemIndex].Score, SerialQuery.Items[ItemIndex].Score));
+				return false;
+			}
+		}
+	}
+
+	const FString Summary = FString::Printf(TEXT("%d queries, %d items each: game thread %.1f queries/s, parallel test values %.1f queries/s (%.2fx)"),
+		NumQueries, SerialQueries[0]->Items.Num(), NumQueries / SerialSeconds, NumQueries / ParallelSeconds, SerialSeconds / ParallelSeconds);
+	UE_LOG(LogEQS, Display, TEXT("%s"), *Summary);
+	AddInfo(Summary);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
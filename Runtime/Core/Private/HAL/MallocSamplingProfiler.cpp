@@ -0,0 +1,556 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MallocSamplingProfiler.cpp: Sampling heap profiler
+=============================================================================*/
+
+#include "HAL/MallocSamplingProfiler.h"
+
+#if USE_MALLOC_SAMPLING_PROFILER
+
+#include "HAL/LowLevelMemTracker.h"
+#include "HAL/MemoryMisc.h"
+#include "HAL/PlatformStackWalk.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Crc.h"
+#include "Misc/Parse.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/OutputDevice.h"
+#include "Trace/Trace.h"
+
+CORE_API FMallocSamplingProfiler* GMallocSamplingProfiler = nullptr;
+
+#if UE_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_DEFINE(HeapSamplingChannel)
+
+UE_TRACE_EVENT_BEGIN(HeapSampling, Init, Important)
+	UE_TRACE_EVENT_FIELD(uint64, CycleFrequency)
+	UE_TRACE_EVENT_FIELD(uint32, SampleRate)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(HeapSampling, CallSite, Important)
+	UE_TRACE_EVENT_FIELD(uint32, Id)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(HeapSampling, Alloc)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, Address)
+	UE_TRACE_EVENT_FIELD(uint64, Size)
+	UE_TRACE_EVENT_FIELD(uint64, Weight)
+	UE_TRACE_EVENT_FIELD(int64, Tag)
+	UE_TRACE_EVENT_FIELD(uint32, CallSiteId)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(HeapSampling, Free)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint64, Address)
+UE_TRACE_EVENT_END()
+
+#endif // UE_TRACE_ENABLED
+
+namespace MallocSamplingProfilerPrivate
+{
+	struct FThreadState
+	{
+		/** Bytes this thread may still allocate before the next sample is taken. */
+		int64 BytesUntilSample;
+
+		/** Value of FMallocSamplingProfiler::SamplingEpoch that BytesUntilSample was computed for. */
+		int32 Epoch;
+
+		/** Set while the profiler itself is allocating, its own allocations are never sampled. */
+		bool bReentryGuard;
+
+		uint32 RandomSeed;
+	};
+
+	static thread_local FThreadState GThreadState = { 0, -1, false, 0 };
+
+	/** Draws the distance to the next sample from an exponential distribution, which makes sampling a Poisson process over allocated bytes. */
+	static int64 GetNextSampleInterval(FThreadState& State, uint32 SampleRate)
+	{
+		if (State.RandomSeed == 0)
+		{
+			State.RandomSeed = (uint32(UPTRINT(&State)) ^ uint32(FPlatformTime::Cycles64())) | 1;
+		}
+		// xorshift32
+		State.RandomSeed ^= State.RandomSeed << 13;
+		State.RandomSeed ^= State.RandomSeed >> 17;
+		State.RandomSeed ^= State.RandomSeed << 5;
+
+		const double Uniform = (double(State.RandomSeed >> 8) + 1.0) / double(1 << 24);
+		const double Interval = -FMath::Loge(Uniform) * double(SampleRate);
+		return FMath::Clamp<int64>(int64(Interval), 1, int64(SampleRate) * 32);
+	}
+
+	/**
+	 * Number of bytes a sample stands for. An allocation of Size bytes is picked with probability 1 - exp(-Size/Rate),
+	 * so dividing by that probability gives an unbiased estimate. Allocations much larger than the rate count as themselves.
+	 */
+	static int64 GetSampleWeight(SIZE_T Size, uint32 SampleRate)
+	{
+		const double Probability = 1.0 - FMath::Exp(-double(Size) / double(SampleRate));
+		return Probability > 0.0 ? int64(double(Size) / Probability) : int64(SampleRate);
+	}
+
+	struct FScopedReentryGuard
+	{
+		FScopedReentryGuard()
+		{
+			GThreadState.bReentryGuard = true;
+		}
+
+		~FScopedReentryGuard()
+		{
+			GThreadState.bReentryGuard = false;
+		}
+	};
+}
+
+FMallocSamplingProfiler::FMallocSamplingProfiler(FMalloc* InMalloc)
+	: UsedMalloc(InMalloc)
+	, SampleRate(0)
+	, SamplingEpoch(0)
+	, NumSamples(0)
+{
+	checkf(UsedMalloc, TEXT("FMallocSamplingProfiler is used without a valid malloc!"));
+	FMemory::Memzero((void*)PointerFilter, sizeof(PointerFilter));
+}
+
+void FMallocSamplingProfiler::ProcessCommandLine(const TCHAR* CmdLine)
+{
+	if (FParse::Param(CmdLine, TEXT("heapsampling")))
+	{
+		StartSampling(DefaultSampleRate);
+	}
+	else
+	{
+		uint32 Rate = 0;
+		if (FParse::Value(CmdLine, TEXT("-heapsampling="), Rate) && Rate > 0)
+		{
+			StartSampling(Rate);
+		}
+	}
+}
+
+void FMallocSamplingProfiler::StartSampling(uint32 InSampleRate)
+{
+	using namespace MallocSamplingProfilerPrivate;
+
+	FScopedReentryGuard Guard;
+	FScopeLock Lock(&CriticalSection);
+
+	if (CallSites.Num() == 0)
+	{
+		// Index 0 is reserved for allocations whose callstack could not be captured.
+		FCallSite& Unknown = CallSites.AddZeroed_GetRef();
+		Unknown.NumFrames = 0;
+	}
+
+	FPlatformAtomics::InterlockedExchange((volatile int32*)&SampleRate, int32(FMath::Max<uint32>(InSampleRate, 1)));
+	FPlatformAtomics::InterlockedIncrement(&SamplingEpoch);
+
+#if UE_TRACE_ENABLED
+	UE_TRACE_LOG(HeapSampling, Init, HeapSamplingChannel)
+		<< Init.CycleFrequency(uint64(1.0 / FPlatformTime::GetSecondsPerCycle64()))
+		<< Init.SampleRate(SampleRate);
+#endif
+}
+
+void FMallocSamplingProfiler::StopSampling()
+{
+	FPlatformAtomics::InterlockedExchange((volatile int32*)&SampleRate, 0);
+}
+
+FORCEINLINE bool FMallocSamplingProfiler::ShouldSample(SIZE_T Size)
+{
+	using namespace MallocSamplingProfilerPrivate;
+
+	FThreadState& State = GThreadState;
+	if (State.bReentryGuard)
+	{
+		return false;
+	}
+
+	State.BytesUntilSample -= int64(Size);
+	if (LIKELY(State.BytesUntilSample > 0 && State.Epoch == SamplingEpoch))
+	{
+		return false;
+	}
+
+	const uint32 Rate = SampleRate;
+	if (Rate == 0)
+	{
+		return false;
+	}
+
+	if (State.Epoch != SamplingEpoch)
+	{
+		// First allocation on this thread since sampling (re)started, just arm the counter.
+		State.Epoch = SamplingEpoch;
+		State.BytesUntilSample = GetNextSampleInterval(State, Rate);
+		return false;
+	}
+
+	State.BytesUntilSample = GetNextSampleInterval(State, Rate);
+	return true;
+}
+
+void* FMallocSamplingProfiler::Malloc(SIZE_T Size, uint32 Alignment)
+{
+	void* Ptr = UsedMalloc->Malloc(Size, Alignment);
+	if (SampleRate != 0 && Ptr != nullptr && ShouldSample(Size))
+	{
+		TrackSampledAlloc(Ptr, Size);
+	}
+	return Ptr;
+}
+
+void* FMallocSamplingProfiler::Realloc(void* OldPtr, SIZE_T NewSize, uint32 Alignment)
+{
+	// Detach the old sample before reallocating so another thread can't be handed the old address and sample it in
+	// between, but only account for its free once we know the realloc went through.
+	FLiveSample OldSample;
+	const bool bOldSampled = OldPtr != nullptr && PointerFilter[GetPointerFilterIndex(OldPtr)] != 0 && DetachSample(OldPtr, OldSample);
+
+	void* NewPtr = UsedMalloc->Realloc(OldPtr, NewSize, Alignment);
+	if (bOldSampled)
+	{
+		if (NewPtr == nullptr && NewSize > 0)
+		{
+			// Realloc failed, the old allocation is still alive.
+			RestoreSample(OldPtr, OldSample);
+		}
+		else
+		{
+			RetireSample(OldPtr, OldSample);
+		}
+	}
+
+	if (SampleRate != 0 && NewPtr != nullptr && NewSize > 0 && ShouldSample(NewSize))
+	{
+		TrackSampledAlloc(NewPtr, NewSize);
+	}
+	return NewPtr;
+}
+
+void FMallocSamplingProfiler::Free(void* Ptr)
+{
+	// Untrack before freeing so another thread can't be handed the same address and sample it in between.
+	if (Ptr != nullptr && PointerFilter[GetPointerFilterIndex(Ptr)] != 0)
+	{
+		TrackFree(Ptr);
+	}
+	UsedMalloc->Free(Ptr);
+}
+
+void FMallocSamplingProfiler::TrackSampledAlloc(void* Ptr, SIZE_T Size)
+{
+	using namespace MallocSamplingProfilerPrivate;
+
+	FScopedReentryGuard Guard;
+
+	uint64 FullCallStack[MaxCallStackDepth + CallStackEntriesToSkipCount] = { 0 };
+	FPlatformStackWalk::CaptureStackBackTrace(FullCallStack, MaxCallStackDepth + CallStackEntriesToSkipCount);
+
+	// Not every platform returns the depth, so count frames up to the first empty one.
+	int32 NumFrames = 0;
+	while (NumFrames < MaxCallStackDepth && FullCallStack[CallStackEntriesToSkipCount + NumFrames] != 0)
+	{
+		++NumFrames;
+	}
+
+	int64 Tag = 0;
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	if (FLowLevelMemTracker::IsEnabled())
+	{
+		Tag = FLowLevelMemTracker::Get().GetActiveTag(ELLMTracker::Default);
+	}
+#endif
+
+	const uint32 Rate = FMath::Max<uint32>(SampleRate, 1);
+	const int64 Weight = GetSampleWeight(Size, Rate);
+	const int64 Count = FMath::Max<int64>(Weight / FMath::Max<int64>(int64(Size), 1), 1);
+
+	FScopeLock Lock(&CriticalSection);
+
+	const uint32 CallSiteId = FindOrAddCallSite(FullCallStack + CallStackEntriesToSkipCount, NumFrames);
+	const FHeapSampleSiteKey Site(CallSiteId, Tag);
+
+	FLiveSample& Sample = LiveSamples.Add(Ptr);
+	Sample.Site = Site;
+	Sample.Weight = Weight;
+	Sample.Count = Count;
+	FPlatformAtomics::InterlockedIncrement(&PointerFilter[GetPointerFilterIndex(Ptr)]);
+
+	FHeapSampleSiteStats& Stats = SiteStats.FindOrAdd(Site);
+	Stats.LiveBytes += Weight;
+	Stats.LiveCount += Count;
+	Stats.AllocatedBytes += Weight;
+	Stats.AllocatedCount += Count;
+	++NumSamples;
+
+#if UE_TRACE_ENABLED
+	UE_TRACE_LOG(HeapSampling, Alloc, HeapSamplingChannel)
+		<< Alloc.Cycle(FPlatformTime::Cycles64())
+		<< Alloc.Address(uint64(UPTRINT(Ptr)))
+		<< Alloc.Size(uint64(Size))
+		<< Alloc.Weight(uint64(Weight))
+		<< Alloc.Tag(Tag)
+		<< Alloc.CallSiteId(CallSiteId);
+#endif
+}
+
+void FMallocSamplingProfiler::TrackFree(void* Ptr)
+{
+	FLiveSample Sample;
+	if (DetachSample(Ptr, Sample))
+	{
+		RetireSample(Ptr, Sample);
+	}
+}
+
+bool FMallocSamplingProfiler::DetachSample(void* Ptr, FLiveSample& OutSample)
+{
+	using namespace MallocSamplingProfilerPrivate;
+
+	// The profiler's own containers are never sampled, so there is nothing to find for them. Returning
+	// early also keeps us from touching LiveSamples while it is being resized.
+	if (GThreadState.bReentryGuard)
+	{
+		return false;
+	}
+
+	FScopedReentryGuard Guard;
+	FScopeLock Lock(&CriticalSection);
+
+	if (!LiveSamples.RemoveAndCopyValue(Ptr, OutSample))
+	{
+		// Another sampled pointer shares the filter bucket.
+		return false;
+	}
+	FPlatformAtomics::InterlockedDecrement(&PointerFilter[GetPointerFilterIndex(Ptr)]);
+	return true;
+}
+
+void FMallocSamplingProfiler::RetireSample(void* Ptr, const FLiveSample& Sample)
+{
+	using namespace MallocSamplingProfilerPrivate;
+
+	FScopedReentryGuard Guard;
+	FScopeLock Lock(&CriticalSection);
+
+	FHeapSampleSiteStats& Stats = SiteStats.FindChecked(Sample.Site);
+	Stats.LiveBytes -= Sample.Weight;
+	Stats.LiveCount -= Sample.Count;
+
+#if UE_TRACE_ENABLED
+	UE_TRACE_LOG(HeapSampling, Free, HeapSamplingChannel)
+		<< Free.Cycle(FPlatformTime::Cycles64())
+		<< Free.Address(uint64(UPTRINT(Ptr)));
+#endif
+}
+
+void FMallocSamplingProfiler::RestoreSample(void* Ptr, const FLiveSample& Sample)
+{
+	using namespace MallocSamplingProfilerPrivate;
+
+	FScopedReentryGuard Guard;
+	FScopeLock Lock(&CriticalSection);
+
+	LiveSamples.Add(Ptr, Sample);
+	FPlatformAtomics::InterlockedIncrement(&PointerFilter[GetPointerFilterIndex(Ptr)]);
+}
+
+uint32 FMallocSamplingProfiler::FindOrAddCallSite(const uint64* Frames, int32 NumFrames)
+{
+	if (NumFrames == 0)
+	{
+		return 0;
+	}
+
+	const uint32 Hash = FCrc::MemCrc32(Frames, NumFrames * sizeof(uint64));
+	if (const uint32* ExistingId = CallSiteHashToId.Find(Hash))
+	{
+		return *ExistingId;
+	}
+
+	const uint32 CallSiteId = uint32(CallSites.Num());
+	FCallSite& NewCallSite = CallSites.AddZeroed_GetRef();
+	NewCallSite.Hash = Hash;
+	NewCallSite.NumFrames = NumFrames;
+	FMemory::Memcpy(NewCallSite.Frames, Frames, NumFrames * sizeof(uint64));
+	CallSiteHashToId.Add(Hash, CallSiteId);
+
+#if UE_TRACE_ENABLED
+	const uint16 FramesSize = uint16(NumFrames * sizeof(uint64));
+	UE_TRACE_LOG(HeapSampling, CallSite, HeapSamplingChannel, FramesSize)
+		<< CallSite.Id(CallSiteId)
+		<< CallSite.Attachment(Frames, FramesSize);
+#endif
+
+	return CallSiteId;
+}
+
+void FMallocSamplingProfiler::TakeSnapshot(FHeapSampleSnapshot& OutSnapshot)
+{
+	using namespace MallocSamplingProfilerPrivate;
+
+	FScopedReentryGuard Guard;
+	FScopeLock Lock(&CriticalSection);
+
+	OutSnapshot.Sites = SiteStats;
+	OutSnapshot.Time = FPlatformTime::Seconds();
+	OutSnapshot.SampleRate = SampleRate;
+}
+
+FHeapSampleSnapshot FHeapSampleSnapshot::Delta(const FHeapSampleSnapshot& Before) const
+{
+	FHeapSampleSnapshot Result;
+	Result.Time = Time - Before.Time;
+	Result.SampleRate = SampleRate;
+
+	for (const TPair<FHeapSampleSiteKey, FHeapSampleSiteStats>& Pair : Sites)
+	{
+		FHeapSampleSiteStats Diff = Pair.Value;
+		if (const FHeapSampleSiteStats* Previous = Before.Sites.Find(Pair.Key))
+		{
+			Diff.LiveBytes -= Previous->LiveBytes;
+			Diff.LiveCount -= Previous->LiveCount;
+			Diff.AllocatedBytes -= Previous->AllocatedBytes;
+			Diff.AllocatedCount -= Previous->AllocatedCount;
+		}
+
+		if (Diff.LiveBytes != 0 || Diff.AllocatedBytes != 0)
+		{
+			Result.Sites.Add(Pair.Key, Diff);
+		}
+	}
+
+	return Result;
+}
+
+FHeapSampleSiteStats FHeapSampleSnapshot::GetTotals() const
+{
+	FHeapSampleSiteStats Totals;
+	for (const TPair<FHeapSampleSiteKey, FHeapSampleSiteStats>& Pair : Sites)
+	{
+		Totals.LiveBytes += Pair.Value.LiveBytes;
+		Totals.LiveCount += Pair.Value.LiveCount;
+		Totals.AllocatedBytes += Pair.Value.AllocatedBytes;
+		Totals.AllocatedCount += Pair.Value.AllocatedCount;
+	}
+	return Totals;
+}
+
+void FMallocSamplingProfiler::DumpSnapshot(const FHeapSampleSnapshot& Snapshot, int32 MaxSites, FOutputDevice& Ar)
+{
+	TArray<TPair<FHeapSampleSiteKey, FHeapSampleSiteStats>> SortedSites = Snapshot.Sites.Array();
+	SortedSites.Sort([](const TPair<FHeapSampleSiteKey, FHeapSampleSiteStats>& A, const TPair<FHeapSampleSiteKey, FHeapSampleSiteStats>& B)
+	{
+		const int64 AbsA = FMath::Abs(A.Value.LiveBytes);
+		const int64 AbsB = FMath::Abs(B.Value.LiveBytes);
+		return AbsA != AbsB ? AbsA > AbsB : A.Value.AllocatedBytes > B.Value.AllocatedBytes;
+	});
+
+	const FHeapSampleSiteStats Totals = Snapshot.GetTotals();
+	Ar.Logf(TEXT("Heap sampling: rate %u bytes, %d sites, live %.2f MB in %lld allocs, allocated %.2f MB in %lld allocs"),
+		Snapshot.SampleRate, SortedSites.Num(),
+		double(Totals.LiveBytes) / (1024.0 * 1024.0), Totals.LiveCount,
+		double(Totals.AllocatedBytes) / (1024.0 * 1024.0), Totals.AllocatedCount);
+
+	const int32 NumToDump = FMath::Min(MaxSites, SortedSites.Num());
+	for (int32 SiteIndex = 0; SiteIndex < NumToDump; ++SiteIndex)
+	{
+		const FHeapSampleSiteKey& Key = SortedSites[SiteIndex].Key;
+		const FHeapSampleSiteStats& Stats = SortedSites[SiteIndex].Value;
+
+		const TCHAR* TagName = TEXT("None");
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		if (FLowLevelMemTracker::IsEnabled())
+		{
+			if (const TCHAR* FoundName = FLowLevelMemTracker::Get().FindTagName(uint64(Key.Tag)))
+			{
+				TagName = FoundName;
+			}
+		}
+#endif
+
+		Ar.Logf(TEXT("  [%d] live %.2f KB in %lld allocs, allocated %.2f KB in %lld allocs, tag %s"),
+			SiteIndex, double(Stats.LiveBytes) / 1024.0, Stats.LiveCount, double(Stats.AllocatedBytes) / 1024.0, Stats.AllocatedCount, TagName);
+
+		FCallSite SiteCallStack;
+		{
+			FScopeLock Lock(&CriticalSection);
+			SiteCallStack = CallSites[Key.CallSiteId];
+		}
+
+		for (int32 FrameIndex = 0; FrameIndex < SiteCallStack.NumFrames; ++FrameIndex)
+		{
+			ANSICHAR FrameString[1024];
+			FrameString[0] = 0;
+			FPlatformStackWalk::ProgramCounterToHumanReadableString(FrameIndex, SiteCallStack.Frames[FrameIndex], FrameString, UE_ARRAY_COUNT(FrameString));
+			Ar.Logf(TEXT("      %s"), ANSI_TO_TCHAR(FrameString));
+		}
+	}
+}
+
+void FMallocSamplingProfiler::GetAllocatorStats(FGenericMemoryStats& OutStats)
+{
+	UsedMalloc->GetAllocatorStats(OutStats);
+
+	FScopeLock Lock(&CriticalSection);
+	OutStats.Add(TEXT("HeapSamplingNumSamples"), SIZE_T(NumSamples));
+	OutStats.Add(TEXT("HeapSamplingLiveSamples"), SIZE_T(LiveSamples.Num()));
+	OutStats.Add(TEXT("HeapSamplingOverhead"), SIZE_T(CallSites.GetAllocatedSize() + CallSiteHashToId.GetAllocatedSize() + LiveSamples.GetAllocatedSize() + SiteStats.GetAllocatedSize()));
+}
+
+bool FMallocSamplingProfiler::Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar)
+{
+	if (!FParse::Command(&Cmd, TEXT("HeapSampling")))
+	{
+		return UsedMalloc->Exec(InWorld, Cmd, Ar);
+	}
+
+	int32 MaxSites = 20;
+	FParse::Value(Cmd, TEXT("Sites="), MaxSites);
+
+	if (FParse::Command(&Cmd, TEXT("Start")))
+	{
+		uint32 Rate = DefaultSampleRate;
+		FParse::Value(Cmd, TEXT("Rate="), Rate);
+		StartSampling(Rate);
+		Ar.Logf(TEXT("Heap sampling started, one sample every %u bytes"), SampleRate);
+	}
+	else if (FParse::Command(&Cmd, TEXT("Stop")))
+	{
+		StopSampling();
+		Ar.Logf(TEXT("Heap sampling stopped, %llu samples taken"), NumSamples);
+	}
+	else if (FParse::Command(&Cmd, TEXT("Snapshot")))
+	{
+		TakeSnapshot(BaselineSnapshot);
+		Ar.Logf(TEXT("Heap sampling baseline snapshot taken, %d sites"), BaselineSnapshot.Sites.Num());
+	}
+	else if (FParse::Command(&Cmd, TEXT("Diff")))
+	{
+		FHeapSampleSnapshot Current;
+		TakeSnapshot(Current);
+		Ar.Logf(TEXT("Heap sampling delta over the last %.1f seconds:"), Current.Time - BaselineSnapshot.Time);
+		DumpSnapshot(Current.Delta(BaselineSnapshot), MaxSites, Ar);
+	}
+	else if (FParse::Command(&Cmd, TEXT("Dump")))
+	{
+		FHeapSampleSnapshot Current;
+		TakeSnapshot(Current);
+		DumpSnapshot(Current, MaxSites, Ar);
+	}
+	else
+	{
+		Ar.Logf(TEXT("Usage: HeapSampling Start [Rate=<bytes>] | Stop | Snapshot | Diff [Sites=<n>] | Dump [Sites=<n>]"));
+	}
+	return true;
+}
+
+#endif // USE_MALLOC_SAMPLING_PROFILER
@@ -25,6 +25,7 @@
 #include "HAL/PlatformMallocCrash.h"
 #include "HAL/MallocPoisonProxy.h"
 #include "HAL/MallocDoubleFreeFinder.h"
+#include "HAL/MallocSamplingProfiler.h"
 
 #if MALLOC_GT_HOOKS
 
@@ -334,7 +335,7 @@ static int FMemory_GCreateMalloc_ThreadUnsafe()
 	}
 
 #if PLATFORM_USES_FIXED_GMalloc_CLASS
-#if USE_MALLOC_PROFILER || MALLOC_VERIFY || MALLOC_LEAKDETECTION || UE_USE_MALLOC_FILL_BYTES
+#if USE_MALLOC_PROFILER || MALLOC_VERIFY || MALLOC_LEAKDETECTION || UE_USE_MALLOC_FILL_BYTES || USE_MALLOC_SAMPLING_PROFILER
 #error "Turn off PLATFORM_USES_FIXED_GMalloc_CLASS in order to use special allocator proxies"
 #endif
 	if (!GMalloc->IsInternallyThreadSafe())
@@ -359,6 +360,11 @@ static int FMemory_GCreateMalloc_ThreadUnsafe()
 		GMalloc = new FMallocThreadSafeProxy( GMalloc );
 	}
 
+#if USE_MALLOC_SAMPLING_PROFILER
+	GMallocSamplingProfiler = new FMallocSamplingProfiler( GMalloc );
+	GMalloc = GMallocSamplingProfiler;
+#endif
+
 #if MALLOC_VERIFY
 	// Add the verifier
 	GMalloc = new FMallocVerifyProxy( GMalloc );
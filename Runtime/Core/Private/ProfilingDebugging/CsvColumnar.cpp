@@ -0,0 +1,247 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ProfilingDebugging/CsvColumnar.h"
+#include "Containers/StringConv.h"
+
+namespace CsvColumnarPrivate
+{
+	FORCEINLINE uint32 ToTransformed(ECsvColumnType Type, uint32 Value, uint32 Previous)
+	{
+		if (Type == ECsvColumnType::Int)
+		{
+			// Zigzag encoded delta, so small changes in either direction give small numbers
+			const int32 Delta = int32(Value - Previous);
+			return uint32(Delta << 1) ^ uint32(Delta >> 31);
+		}
+		// Floats that don't change XOR to zero, ones that change a little keep the sign and exponent bits clear
+		return Value ^ Previous;
+	}
+
+	FORCEINLINE uint32 FromTransformed(ECsvColumnType Type, uint32 Transformed, uint32 Previous)
+	{
+		if (Type == ECsvColumnType::Int)
+		{
+			const int32 Delta = int32(Transformed >> 1) ^ -int32(Transformed & 1);
+			return Previous + uint32(Delta);
+		}
+		return Transformed ^ Previous;
+	}
+}
+
+void FCsvColumnarCodec::WriteVarUInt(uint64 Value, TArray<uint8>& Out)
+{
+	do
+	{
+		uint8 Byte = uint8(Value & 0x7f);
+		Value >>= 7;
+		Out.Add(Value ? (Byte | 0x80) : Byte);
+	}
+	while (Value);
+}
+
+bool FCsvColumnarCodec::ReadVarUInt(const uint8*& Cursor, const uint8* End, uint64& OutValue)
+{
+	OutValue = 0;
+	for (uint32 Shift = 0; Shift < 64; Shift += 7)
+	{
+		if (Cursor >= End)
+		{
+			return false;
+		}
+		const uint8 Byte = *Cursor++;
+		OutValue |= uint64(Byte & 0x7f) << Shift;
+		if ((Byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FCsvColumnarCodec::WriteString(const FString& Value, TArray<uint8>& Out)
+{
+	FTCHARToUTF8 Utf8(*Value);
+	WriteVarUInt(Utf8.Length(), Out);
+	Out.Append((const uint8*)Utf8.Get(), Utf8.Length());
+}
+
+bool FCsvColumnarCodec::ReadString(const uint8*& Cursor, const uint8* End, FString& OutValue)
+{
+	uint64 Length;
+	if (!ReadVarUInt(Cursor, End, Length) || Length > uint64(End - Cursor))
+	{
+		return false;
+	}
+	FUTF8ToTCHAR Converted((const ANSICHAR*)Cursor, int32(Length));
+	OutValue = FString(Converted.Length(), Converted.Get());
+	Cursor += Length;
+	return true;
+}
+
+void FCsvColumnarCodec::EncodeColumn(ECsvColumnType Type, const uint32* Values, int32 Num, TArray<uint8>& Out)
+{
+	using namespace CsvColumnarPrivate;
+
+	uint32 Previous = 0;
+	int32 Index = 0;
+	while (Index < Num)
+	{
+		const uint32 Transformed = ToTransformed(Type, Values[Index], Previous);
+		Previous = Values[Index];
+
+		// Extend the run while the transformed value repeats; a constant stat gives a run of zeros, a counter
+		// that goes up by the same amount every frame a run of its increment.
+		int32 RunLength = 1;
+		while (Index + RunLength < Num && ToTransformed(Type, Values[Index + RunLength], Previous) == Transformed)
+		{
+			Previous = Values[Index + RunLength];
+			++RunLength;
+		}
+
+		WriteVarUInt(RunLength, Out);
+		WriteVarUInt(Transformed, Out);
+		Index += RunLength;
+	}
+}
+
+bool FCsvColumnarCodec::DecodeColumn(ECsvColumnType Type, const uint8*& Cursor, const uint8* End, int32 Num, uint32* OutValues)
+{
+	using namespace CsvColumnarPrivate;
+
+	uint32 Previous = 0;
+	int32 Index = 0;
+	while (Index < Num)
+	{
+		uint64 RunLength;
+		uint64 Transformed;
+		if (!ReadVarUInt(Cursor, End, RunLength) || !ReadVarUInt(Cursor, End, Transformed) || RunLength == 0 || RunLength > uint64(Num - Index))
+		{
+			return false;
+		}
+
+		for (uint64 Run = 0; Run < RunLength; ++Run)
+		{
+			Previous = FromTransformed(Type, uint32(Transformed), Previous);
+			OutValues[Index++] = Previous;
+		}
+	}
+	return true;
+}
+
+bool FCsvColumnarFile::Load(const TArray<uint8>& Data)
+{
+	Frames.Reset();
+	Columns.Reset();
+	Events.Reset();
+	Metadata.Reset();
+
+	const uint8* Cursor = Data.GetData();
+	const uint8* End = Cursor + Data.Num();
+
+	if (Data.Num() < 8 || ((const uint32*)Cursor)[0] != FCsvColumnarCodec::Magic || ((const uint32*)Cursor)[1] != FCsvColumnarCodec::Version)
+	{
+		return false;
+	}
+	Cursor += 8;
+
+	TArray<uint32> Values;
+	while (Cursor < End)
+	{
+		const FCsvColumnarCodec::EBlockType BlockType = FCsvColumnarCodec::EBlockType(*Cursor++);
+		if (BlockType == FCsvColumnarCodec::EBlockType::Metadata)
+		{
+			uint64 NumEntries;
+			if (!FCsvColumnarCodec::ReadVarUInt(Cursor, End, NumEntries))
+			{
+				return false;
+			}
+			for (uint64 Entry = 0; Entry < NumEntries; ++Entry)
+			{
+				FString Key;
+				FString Value;
+				if (!FCsvColumnarCodec::ReadString(Cursor, End, Key) || !FCsvColumnarCodec::ReadString(Cursor, End, Value))
+				{
+					return false;
+				}
+				Metadata.Add(MoveTemp(Key), MoveTemp(Value));
+			}
+			continue;
+		}
+
+		if (BlockType != FCsvColumnarCodec::EBlockType::Frames)
+		{
+			return false;
+		}
+
+		uint64 NumRows;
+		uint64 NumNewColumns;
+		if (!FCsvColumnarCodec::ReadVarUInt(Cursor, End, NumRows) || !FCsvColumnarCodec::ReadVarUInt(Cursor, End, NumNewColumns) || NumRows > MAX_int32)
+		{
+			return false;
+		}
+
+		const int32 FirstRow = Frames.Num();
+		for (uint64 NewColumn = 0; NewColumn < NumNewColumns; ++NewColumn)
+		{
+			if (Cursor >= End)
+			{
+				return false;
+			}
+			FColumn& Column = Columns.AddDefaulted_GetRef();
+			Column.Type = ECsvColumnType(*Cursor++);
+			if (!FCsvColumnarCodec::ReadString(Cursor, End, Column.Name))
+			{
+				return false;
+			}
+			// Rows before the column existed read as zero, like in text CSV files.
+			Column.Values.SetNumZeroed(FirstRow);
+		}
+
+		uint64 NumEvents;
+		if (!FCsvColumnarCodec::ReadVarUInt(Cursor, End, NumEvents))
+		{
+			return false;
+		}
+		for (uint64 EventIndex = 0; EventIndex < NumEvents; ++EventIndex)
+		{
+			uint64 RowOffset;
+			FEvent& Event = Events.AddDefaulted_GetRef();
+			if (!FCsvColumnarCodec::ReadVarUInt(Cursor, End, RowOffset) || !FCsvColumnarCodec::ReadString(Cursor, End, Event.Text))
+			{
+				return false;
+			}
+			Event.Row = FirstRow + int32(RowOffset);
+		}
+
+		Values.SetNumUninitialized(int32(NumRows), false);
+
+		// Frame numbers are stored as the first column of every block.
+		if (!FCsvColumnarCodec::DecodeColumn(ECsvColumnType::Int, Cursor, End, int32(NumRows), Values.GetData()))
+		{
+			return false;
+		}
+		for (uint32 Frame : Values)
+		{
+			Frames.Add(int64(Frame));
+		}
+
+		for (FColumn& Column : Columns)
+		{
+			if (!FCsvColumnarCodec::DecodeColumn(Column.Type, Cursor, End, int32(NumRows), Values.GetData()))
+			{
+				return false;
+			}
+			for (uint32 Value : Values)
+			{
+				Column.Values.Add(Column.Type == ECsvColumnType::Int ? float(int32(Value)) : *(const float*)&Value);
+			}
+		}
+	}
+
+	return true;
+}
+
+const FCsvColumnarFile::FColumn* FCsvColumnarFile::FindColumn(const FString& Name) const
+{
+	return Columns.FindByPredicate([&Name](const FColumn& Column) { return Column.Name == Name; });
+}
@@ -6,6 +6,7 @@
 */
 
 #include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/CsvColumnar.h"
 #include "CoreGlobals.h"
 #include "HAL/RunnableThread.h"
 #include "HAL/ThreadManager.h"
@@ -114,6 +115,31 @@ TAutoConsoleVariable<int32> CVarCsvWriteBufferSize(
 	ECVF_Default
 );
 
+TAutoConsoleVariable<int32> CVarCsvOutputFormat(
+	TEXT("csv.OutputFormat"),
+	0,
+	TEXT("Format of the files written by CSV captures.\r\n")
+	TEXT(" 0 = (Default) One text row per frame.\r\n")
+	TEXT(" 1 = Binary columnar (.csvbin). Blocks of frames stored per stat, delta and run-length encoded. See FCsvColumnarFile.\r\n")
+	TEXT(" 2 = Aggregated. No per frame rows, instead one row per stat per csv.AggregateWindowSeconds with its min, average, p50, p95, p99 and max. Events are not written.\r\n")
+	TEXT("Formats other than 0 always write continuously."),
+	ECVF_Default
+);
+
+TAutoConsoleVariable<float> CVarCsvAggregateWindowSeconds(
+	TEXT("csv.AggregateWindowSeconds"),
+	60.0f,
+	TEXT("Length of the windows stats are aggregated over when csv.OutputFormat is 2, measured in frame time."),
+	ECVF_Default
+);
+
+enum class ECsvOutputFormat : uint8
+{
+	Csv,
+	Columnar,
+	Aggregated,
+};
+
 static bool GCsvUseProcessingThread = true;
 static int32 GCsvRepeatCount = 0;
 static int32 GCsvRepeatFrameCount = 0;
@@ -1241,6 +1267,11 @@ public:
 		WriteString(Value);
 	}
 
+	void WriteBinary(const void* Data, int32 NumBytes)
+	{
+		SerializeInternal((void*)Data, NumBytes);
+	}
+
 private:
 	void WriteStringInternal(const FString& Str)
 	{
@@ -1545,13 +1576,46 @@ class FCsvStreamWriter
 	int64 ReadFrameIndex;
 
 	const bool bContinuousWrites;
+	const ECsvOutputFormat OutputFormat;
 	bool bFirstRow;
 
 	TArray<FCsvStatSeries*> AllSeries;
 	TArray<class FCsvProfilerThreadDataProcessor*> DataProcessors;
 
+	// Rows of the current block when writing the columnar format, stored per series
+	struct FColumnarBlock
+	{
+		static const int32 MaxRows = 256;
+
+		TArray<uint32> Frames;
+		TArray<TArray<uint32>> Columns;
+		TArray<TPair<int32, FString>> Events;
+		TArray<uint8> Scratch;
+		int32 NumColumnsWritten = 0;
+	} ColumnarBlock;
+
+	// Values of the current window when writing the aggregated format, stored per series
+	struct FAggregateWindow
+	{
+		TArray<TArray<float>> Samples;
+		double ElapsedMs = 0.0;
+		int64 FirstFrame = 0;
+		int64 LastFrame = 0;
+		int32 NumFrames = 0;
+		int32 WindowIndex = 0;
+		int32 FrameTimeColumn = INDEX_NONE;
+		float WindowMs = 60000.0f;
+	} AggregateWindow;
+
+	void WriteHeaderIfNeeded();
+	void WriteCsvRow(const FCsvRow& Row);
+	void AddColumnarRow(const FCsvRow& Row);
+	void FlushColumnarBlock();
+	void AddAggregatedRow(const FCsvRow& Row);
+	void FlushAggregateWindow();
+
 public:
-	FCsvStreamWriter(const TSharedRef<FArchive>& InOutputFile, bool bInContinuousWrites, int32 InBufferSize, bool bInCompressOutput);
+	FCsvStreamWriter(const TSharedRef<FArchive>& InOutputFile, bool bInContinuousWrites, int32 InBufferSize, bool bInCompressOutput, ECsvOutputFormat InOutputFormat);
 	~FCsvStreamWriter();
 
 	void AddSeries(FCsvStatSeries* Series);
@@ -1974,13 +2038,16 @@ private:
 	}
 };
 
-FCsvStreamWriter::FCsvStreamWriter(const TSharedRef<FArchive>& InOutputFile, bool bInContinuousWrites, int32 InBufferSize, bool bInCompressOutput)
+FCsvStreamWriter::FCsvStreamWriter(const TSharedRef<FArchive>& InOutputFile, bool bInContinuousWrites, int32 InBufferSize, bool bInCompressOutput, ECsvOutputFormat InOutputFormat)
 	: Stream(InOutputFile, InBufferSize, bInCompressOutput)
 	, WriteFrameIndex(-1)
 	, ReadFrameIndex(-1)
 	, bContinuousWrites(bInContinuousWrites)
+	, OutputFormat(InOutputFormat)
 	, bFirstRow(true)
-{}
+{
+	AggregateWindow.WindowMs = FMath::Max(CVarCsvAggregateWindowSeconds.GetValueOnAnyThread(), 1.0f) * 1000.0f;
+}
 
 FCsvStreamWriter::~FCsvStreamWriter()
 {
@@ -2020,12 +2087,32 @@ void FCsvStreamWriter::PushEvent(const FCsvProcessedEvent& Event)
 	Rows.FindOrAdd(Event.FrameNumber).Events.Add(Event);
 }
 
-void FCsvStreamWriter::FinalizeNextRow()
+void FCsvStreamWriter::WriteHeaderIfNeeded()
 {
-	ReadFrameIndex++;
+	if (!bFirstRow)
+	{
+		return;
+	}
+	bFirstRow = false;
 
-	if (bFirstRow)
+	switch (OutputFormat)
 	{
+	case ECsvOutputFormat::Columnar:
+		{
+			const uint32 Header[] = { FCsvColumnarCodec::Magic, FCsvColumnarCodec::Version };
+			Stream.WriteBinary(Header, sizeof(Header));
+		}
+		break;
+
+	case ECsvOutputFormat::Aggregated:
+		for (const TCHAR* Column : { TEXT("Window"), TEXT("StartFrame"), TEXT("EndFrame"), TEXT("Stat"), TEXT("Count"), TEXT("Min"), TEXT("Avg"), TEXT("P50"), TEXT("P95"), TEXT("P99"), TEXT("Max") })
+		{
+			Stream.WriteString(Column);
+		}
+		Stream.NewLine();
+		break;
+
+	default:
 		// Write the first header row
 		Stream.WriteString("EVENTS");
 
@@ -2035,62 +2122,265 @@ void FCsvStreamWriter::FinalizeNextRow()
 		}
 
 		Stream.NewLine();
-		bFirstRow = false;
+		break;
 	}
+}
+
+void FCsvStreamWriter::FinalizeNextRow()
+{
+	ReadFrameIndex++;
+
+	WriteHeaderIfNeeded();
 
 	// Don't remove yet. Flushing series may modify this row
 	FCsvRow* Row = Rows.Find(ReadFrameIndex);
 	if (Row)
 	{
-		if (Row->Events.Num() > 0)
+		// Stat values are held in the series until a new value arrives.
+		// If we've caught up with the last value written to the series,
+		// we need to flush to get the correct value for this frame.
+		for (FCsvStatSeries* Series : AllSeries)
 		{
-			// Write the events for this row
-			TArray<FString> EventStrings;
-			EventStrings.Reserve(Row->Events.Num());
-			for (FCsvProcessedEvent& Event : Row->Events)
-			{
-				EventStrings.Add(Event.GetFullName());
-			}
-
-			Stream.WriteSemicolonSeparatedStringList(EventStrings);
+			if (Series->CurrentWriteFrameNumber == ReadFrameIndex)
+				Series->FlushIfDirty();
 		}
-		else
+
+		switch (OutputFormat)
 		{
-			// No events. Insert empty string at the start of the line
-			Stream.WriteEmptyString();
+		case ECsvOutputFormat::Columnar:
+			AddColumnarRow(*Row);
+			break;
+
+		case ECsvOutputFormat::Aggregated:
+			AddAggregatedRow(*Row);
+			break;
+
+		default:
+			WriteCsvRow(*Row);
+			break;
 		}
 
-		for (FCsvStatSeries* Series : AllSeries)
+		// Finally remove the frame data
+		Rows.FindAndRemoveChecked(ReadFrameIndex);
+	}
+}
+
+void FCsvStreamWriter::WriteCsvRow(const FCsvRow& Row)
+{
+	if (Row.Events.Num() > 0)
+	{
+		// Write the events for this row
+		TArray<FString> EventStrings;
+		EventStrings.Reserve(Row.Events.Num());
+		for (const FCsvProcessedEvent& Event : Row.Events)
 		{
-			// Stat values are held in the series until a new value arrives.
-			// If we've caught up with the last value written to the series,
-			// we need to flush to get the correct value for this frame.
-			if (Series->CurrentWriteFrameNumber == ReadFrameIndex)
-				Series->FlushIfDirty();
+			EventStrings.Add(Event.GetFullName());
+		}
+
+		Stream.WriteSemicolonSeparatedStringList(EventStrings);
+	}
+	else
+	{
+		// No events. Insert empty string at the start of the line
+		Stream.WriteEmptyString();
+	}
 
-			if (Row->Values.IsValidIndex(Series->ColumnIndex))
+	for (FCsvStatSeries* Series : AllSeries)
+	{
+		if (Row.Values.IsValidIndex(Series->ColumnIndex))
+		{
+			const FCsvStatSeriesValue& Value = Row.Values[Series->ColumnIndex];
+			if (Series->SeriesType == FCsvStatSeries::EType::CustomStatInt)
 			{
-				const FCsvStatSeriesValue& Value = Row->Values[Series->ColumnIndex];
-				if (Series->SeriesType == FCsvStatSeries::EType::CustomStatInt)
-				{
-					Stream.WriteValue(Value.Value.AsInt);
-				}
-				else
-				{
-					Stream.WriteValue(Value.Value.AsFloat);
-				}
+				Stream.WriteValue(Value.Value.AsInt);
 			}
 			else
 			{
-				Stream.WriteValue(0);
+				Stream.WriteValue(Value.Value.AsFloat);
 			}
 		}
+		else
+		{
+			Stream.WriteValue(0);
+		}
+	}
+
+	Stream.NewLine();
+}
+
+void FCsvStreamWriter::AddColumnarRow(const FCsvRow& Row)
+{
+	FColumnarBlock& Block = ColumnarBlock;
+	const int32 RowIndex = Block.Frames.Num();
 
+	// Series that appeared part way through the block read as zero before that
+	while (Block.Columns.Num() < AllSeries.Num())
+	{
+		Block.Columns.AddDefaulted_GetRef().SetNumZeroed(RowIndex);
+	}
+
+	Block.Frames.Add(uint32(ReadFrameIndex));
+	for (int32 ColumnIndex = 0; ColumnIndex < Block.Columns.Num(); ++ColumnIndex)
+	{
+		// AsInt aliases the float bits, which is what the codec wants for float columns
+		Block.Columns[ColumnIndex].Add(Row.Values.IsValidIndex(ColumnIndex) ? uint32(Row.Values[ColumnIndex].Value.AsInt) : 0);
+	}
+
+	for (const FCsvProcessedEvent& Event : Row.Events)
+	{
+		Block.Events.Emplace(RowIndex, Event.GetFullName());
+	}
+
+	if (Block.Frames.Num() >= FColumnarBlock::MaxRows)
+	{
+		FlushColumnarBlock();
+	}
+}
+
+void FCsvStreamWriter::FlushColumnarBlock()
+{
+	FColumnarBlock& Block = ColumnarBlock;
+	const int32 NumRows = Block.Frames.Num();
+	if (NumRows == 0)
+	{
+		return;
+	}
+
+	TArray<uint8>& Out = Block.Scratch;
+	Out.Reset();
+	Out.Add(uint8(FCsvColumnarCodec::EBlockType::Frames));
+	FCsvColumnarCodec::WriteVarUInt(NumRows, Out);
+
+	// Names and types of series first seen in this block
+	FCsvColumnarCodec::WriteVarUInt(Block.Columns.Num() - Block.NumColumnsWritten, Out);
+	for (int32 ColumnIndex = Block.NumColumnsWritten; ColumnIndex < Block.Columns.Num(); ++ColumnIndex)
+	{
+		const FCsvStatSeries* Series = AllSeries[ColumnIndex];
+		Out.Add(uint8(Series->SeriesType == FCsvStatSeries::EType::CustomStatInt ? ECsvColumnType::Int : ECsvColumnType::Float));
+		FCsvColumnarCodec::WriteString(Series->Name, Out);
+	}
+	Block.NumColumnsWritten = Block.Columns.Num();
+
+	FCsvColumnarCodec::WriteVarUInt(Block.Events.Num(), Out);
+	for (const TPair<int32, FString>& Event : Block.Events)
+	{
+		FCsvColumnarCodec::WriteVarUInt(Event.Key, Out);
+		FCsvColumnarCodec::WriteString(Event.Value, Out);
+	}
+
+	FCsvColumnarCodec::EncodeColumn(ECsvColumnType::Int, Block.Frames.GetData(), NumRows, Out);
+	for (int32 ColumnIndex = 0; ColumnIndex < Block.Columns.Num(); ++ColumnIndex)
+	{
+		const ECsvColumnType Type = AllSeries[ColumnIndex]->SeriesType == FCsvStatSeries::EType::CustomStatInt ? ECsvColumnType::Int : ECsvColumnType::Float;
+		FCsvColumnarCodec::EncodeColumn(Type, Block.Columns[ColumnIndex].GetData(), NumRows, Out);
+		Block.Columns[ColumnIndex].Reset();
+	}
+
+	Stream.WriteBinary(Out.GetData(), Out.Num());
+
+	Block.Frames.Reset();
+	Block.Events.Reset();
+}
+
+void FCsvStreamWriter::AddAggregatedRow(const FCsvRow& Row)
+{
+	FAggregateWindow& Window = AggregateWindow;
+
+	if (Window.Samples.Num() < AllSeries.Num())
+	{
+		Window.Samples.SetNum(AllSeries.Num());
+	}
+
+	if (Window.FrameTimeColumn == INDEX_NONE)
+	{
+		Window.FrameTimeColumn = AllSeries.IndexOfByPredicate([](const FCsvStatSeries* Series) { return Series->Name == TEXT("FrameTime"); });
+	}
+
+	if (Window.NumFrames++ == 0)
+	{
+		Window.FirstFrame = ReadFrameIndex;
+	}
+	Window.LastFrame = ReadFrameIndex;
+
+	// As in the text format, a series with no value in this frame counts as zero
+	for (int32 ColumnIndex = 0; ColumnIndex < AllSeries.Num(); ++ColumnIndex)
+	{
+		float Value = 0.0f;
+		if (Row.Values.IsValidIndex(ColumnIndex))
+		{
+			const FCsvStatSeriesValue& SeriesValue = Row.Values[ColumnIndex];
+			Value = AllSeries[ColumnIndex]->SeriesType == FCsvStatSeries::EType::CustomStatInt ? float(SeriesValue.Value.AsInt) : SeriesValue.Value.AsFloat;
+		}
+		Window.Samples[ColumnIndex].Add(Value);
+
+		if (ColumnIndex == Window.FrameTimeColumn)
+		{
+			Window.ElapsedMs += Value;
+		}
+	}
+
+	if (Window.FrameTimeColumn == INDEX_NONE)
+	{
+		// No frame times, assume 60Hz
+		Window.ElapsedMs += 1000.0 / 60.0;
+	}
+
+	if (Window.ElapsedMs >= Window.WindowMs)
+	{
+		FlushAggregateWindow();
+	}
+}
+
+void FCsvStreamWriter::FlushAggregateWindow()
+{
+	FAggregateWindow& Window = AggregateWindow;
+	if (Window.NumFrames == 0)
+	{
+		return;
+	}
+
+	for (int32 ColumnIndex = 0; ColumnIndex < Window.Samples.Num(); ++ColumnIndex)
+	{
+		TArray<float>& Samples = Window.Samples[ColumnIndex];
+		const int32 NumSamples = Samples.Num();
+		if (NumSamples == 0)
+		{
+			continue;
+		}
+
+		Samples.Sort();
+
+		double Sum = 0.0;
+		for (float Sample : Samples)
+		{
+			Sum += Sample;
+		}
+
+		// Nearest rank percentiles
+		auto Percentile = [&Samples, NumSamples](double Fraction)
+		{
+			return Samples[FMath::Clamp(FMath::CeilToInt(float(Fraction * NumSamples)) - 1, 0, NumSamples - 1)];
+		};
+
+		Stream.WriteValue(Window.WindowIndex);
+		Stream.WriteString(LexToString(Window.FirstFrame));
+		Stream.WriteString(LexToString(Window.LastFrame));
+		Stream.WriteString(AllSeries[ColumnIndex]->Name);
+		Stream.WriteValue(NumSamples);
+		Stream.WriteValue(Samples[0]);
+		Stream.WriteValue(Sum / NumSamples);
+		Stream.WriteValue(Percentile(0.5));
+		Stream.WriteValue(Percentile(0.95));
+		Stream.WriteValue(Percentile(0.99));
+		Stream.WriteValue(Samples.Last());
 		Stream.NewLine();
 
-		// Finally remove the frame data
-		Rows.FindAndRemoveChecked(ReadFrameIndex);
+		Samples.Reset();
 	}
+
+	Window.ElapsedMs = 0.0;
+	Window.NumFrames = 0;
+	Window.WindowIndex++;
 }
 
 void FCsvStreamWriter::Finalize(const TMap<FString, FString>& Metadata)
@@ -2101,16 +2391,42 @@ void FCsvStreamWriter::Finalize(const TMap<FString, FString>& Metadata)
 		FinalizeNextRow();
 	}
 
-	// Write a final summary header row
-	Stream.WriteString("EVENTS");
-	for (FCsvStatSeries* Series : AllSeries)
+	if (OutputFormat == ECsvOutputFormat::Columnar)
 	{
-		Stream.WriteString(Series->Name);
+		WriteHeaderIfNeeded();
+		FlushColumnarBlock();
+
+		TArray<uint8>& Out = ColumnarBlock.Scratch;
+		Out.Reset();
+		Out.Add(uint8(FCsvColumnarCodec::EBlockType::Metadata));
+		FCsvColumnarCodec::WriteVarUInt(Metadata.Num(), Out);
+		for (const auto& Pair : Metadata)
+		{
+			FCsvColumnarCodec::WriteString(Pair.Key, Out);
+			FCsvColumnarCodec::WriteString(Pair.Value, Out);
+		}
+		Stream.WriteBinary(Out.GetData(), Out.Num());
+		return;
 	}
-	Stream.NewLine();
 
-	// Insert some metadata to indicate the file has a summary header row
-	Stream.WriteMetadataEntry((TEXT("HasHeaderRowAtEnd")), TEXT("1"));
+	if (OutputFormat == ECsvOutputFormat::Aggregated)
+	{
+		WriteHeaderIfNeeded();
+		FlushAggregateWindow();
+	}
+	else
+	{
+		// Write a final summary header row
+		Stream.WriteString("EVENTS");
+		for (FCsvStatSeries* Series : AllSeries)
+		{
+			Stream.WriteString(Series->Name);
+		}
+		Stream.NewLine();
+
+		// Insert some metadata to indicate the file has a summary header row
+		Stream.WriteMetadataEntry((TEXT("HasHeaderRowAtEnd")), TEXT("1"));
+	}
 
 	// Add metadata at the end of the file, making sure commandline is last (this is required for parsing)
 	const TPair<FString, FString>* CommandlineEntry = NULL;
@@ -2556,7 +2872,10 @@ void FCsvProfiler::BeginFrame()
 
 				// Latch the cvars when we start a capture
 				int32 BufferSize = FMath::Max(CVarCsvWriteBufferSize.GetValueOnAnyThread(), 0);
-				bool bContinuousWrites = IsContinuousWriteEnabled(true);
+				const ECsvOutputFormat OutputFormat = (ECsvOutputFormat)FMath::Clamp(CVarCsvOutputFormat.GetValueOnGameThread(), 0, 2);
+
+				// The other formats exist to keep long captures small, so never hold the whole capture in memory for them
+				bool bContinuousWrites = IsContinuousWriteEnabled(true) || OutputFormat != ECsvOutputFormat::Csv;
 
 				// Allow overriding of compression based on the "csv.CompressionMode" CVar
 				bool bCompressOutput;
@@ -2575,7 +2894,21 @@ void FCsvProfiler::BeginFrame()
 					break;
 				}
 
-				const TCHAR* CsvExtension = bCompressOutput ? TEXT(".csv.gz") : TEXT(".csv");
+				const TCHAR* CsvExtension;
+				switch (OutputFormat)
+				{
+				case ECsvOutputFormat::Columnar:
+					CsvExtension = bCompressOutput ? TEXT(".csvbin.gz") : TEXT(".csvbin");
+					break;
+
+				case ECsvOutputFormat::Aggregated:
+					CsvExtension = bCompressOutput ? TEXT(".aggregate.csv.gz") : TEXT(".aggregate.csv");
+					break;
+
+				default:
+					CsvExtension = bCompressOutput ? TEXT(".csv.gz") : TEXT(".csv");
+					break;
+				}
 
 				// Determine the output path and filename based on override params
 				FString DestinationFolder = CurrentCommand.DestinationFolder.IsEmpty() ? FPaths::ProfilingDir() + TEXT("CSV/") : CurrentCommand.DestinationFolder + TEXT("/");
@@ -2590,7 +2923,7 @@ void FCsvProfiler::BeginFrame()
 				else
 				{
 					
-					CsvWriter = new FCsvStreamWriter(OutputFile.ToSharedRef(), bContinuousWrites, BufferSize, bCompressOutput);
+					CsvWriter = new FCsvStreamWriter(OutputFile.ToSharedRef(), bContinuousWrites, BufferSize, bCompressOutput, OutputFormat);
 
 					NumFramesToCapture = CurrentCommand.Value;
 					GCsvRepeatFrameCount = NumFramesToCapture;
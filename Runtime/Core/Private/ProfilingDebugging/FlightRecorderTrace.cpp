@@ -0,0 +1,129 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#include "ProfilingDebugging/FlightRecorderTrace.h"
+
+#if FLIGHTRECORDERTRACE_ENABLED
+
+#include "CoreGlobals.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/OutputDevice.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Trace/Trace.h"
+
+static float GFlightRecorderHitchMs = 500.0f;
+static FAutoConsoleVariableRef CVarFlightRecorderHitchMs(
+	TEXT("trace.FlightRecorder.HitchMs"),
+	GFlightRecorderHitchMs,
+	TEXT("Frames that take longer than this many milliseconds dump the trace flight recorder. 0 disables dumps on hitches."),
+	ECVF_Default);
+
+static float GFlightRecorderMinDumpInterval = 60.0f;
+static FAutoConsoleVariableRef CVarFlightRecorderMinDumpInterval(
+	TEXT("trace.FlightRecorder.MinDumpInterval"),
+	GFlightRecorderMinDumpInterval,
+	TEXT("Minimum number of seconds between two dumps of the trace flight recorder caused by hitches."),
+	ECVF_Default);
+
+struct FFlightRecorderTraceInternal
+{
+	static void OnEndFrame();
+	static void OnHandleSystemError();
+
+	/** Set on the first frame, when the project's directories are known. Kept so a crash does not have to build it. */
+	static FString DumpDir;
+	static double LastFrameTime;
+	static double LastDumpTime;
+};
+
+FString FFlightRecorderTraceInternal::DumpDir;
+double FFlightRecorderTraceInternal::LastFrameTime = 0.0;
+double FFlightRecorderTraceInternal::LastDumpTime = 0.0;
+
+void FFlightRecorderTraceInternal::OnEndFrame()
+{
+	const double Now = FPlatformTime::Seconds();
+	if (DumpDir.IsEmpty())
+	{
+		DumpDir = FPaths::ConvertRelativePathToFull(FPaths::ProfilingDir() / TEXT("FlightRecorder"));
+		IFileManager::Get().MakeDirectory(*DumpDir, true);
+		LastFrameTime = Now;
+		return;
+	}
+
+	const double FrameMs = (Now - LastFrameTime) * 1000.0;
+	LastFrameTime = Now;
+
+	if (GFlightRecorderHitchMs > 0.0f && FrameMs > GFlightRecorderHitchMs && Now - LastDumpTime > GFlightRecorderMinDumpInterval)
+	{
+		LastDumpTime = Now;
+		UE_LOG(LogCore, Log, TEXT("Frame took %.1fms, dumping trace flight recorder."), FrameMs);
+		FFlightRecorderTrace::Dump(TEXT("Hitch"));
+	}
+}
+
+void FFlightRecorderTraceInternal::OnHandleSystemError()
+{
+	// The trace worker thread does the writing, give it a moment before the process goes away.
+	FFlightRecorderTrace::Dump(TEXT("Crash"), 2000);
+}
+
+void FFlightRecorderTrace::Init(const TCHAR* CmdLine)
+{
+	uint32 CompressThreads = 0;
+	if (FParse::Value(CmdLine, TEXT("-tracecompressthreads="), CompressThreads))
+	{
+		Trace::SetCompressionThreadCount(CompressThreads);
+	}
+
+	uint32 Seconds = 30;
+	if (!FParse::Value(CmdLine, TEXT("-traceflightrecorder="), Seconds) && !FParse::Param(CmdLine, TEXT("traceflightrecorder")))
+	{
+		return;
+	}
+
+	uint32 SizeMb = 64;
+	FParse::Value(CmdLine, TEXT("-traceflightrecordermb="), SizeMb);
+
+	if (Trace::StartFlightRecorder(Seconds, SizeMb))
+	{
+		FCoreDelegates::OnEndFrame.AddStatic(&FFlightRecorderTraceInternal::OnEndFrame);
+		FCoreDelegates::OnHandleSystemError.AddStatic(&FFlightRecorderTraceInternal::OnHandleSystemError);
+	}
+}
+
+bool FFlightRecorderTrace::Dump(const TCHAR* Reason, uint32 WaitMs)
+{
+	if (FFlightRecorderTraceInternal::DumpDir.IsEmpty())
+	{
+		return false;
+	}
+
+	const FString Path = FFlightRecorderTraceInternal::DumpDir / FString::Printf(TEXT("%s_%s.utrace"), Reason, *FDateTime::Now().ToString());
+	return Trace::DumpFlightRecorder(*Path, WaitMs);
+}
+
+static FAutoConsoleCommand GFlightRecorderDumpCmd(
+	TEXT("trace.FlightRecorder.Dump"),
+	TEXT("Writes the data held by the trace flight recorder to Saved/Profiling/FlightRecorder."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FFlightRecorderTrace::Dump(TEXT("Manual"));
+	}));
+
+static FAutoConsoleCommandWithOutputDevice GTraceStatsCmd(
+	TEXT("trace.Stats"),
+	TEXT("Logs how much data the trace writer has processed and how far it is behind."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		Trace::FStatistics Stats;
+		Trace::GetStatistics(Stats);
+		Ar.Logf(TEXT("Reaped: %llu KB, Sent: %llu KB, Dropped: %llu KB"), Stats.BytesReaped >> 10, Stats.BytesSent >> 10, Stats.BytesDropped >> 10);
+		Ar.Logf(TEXT("Buffer memory: %llu KB, Max drained per update: %u KB, Encode threads: %u"), Stats.MemoryUsed >> 10, Stats.MaxDrainBytes >> 10, Stats.EncodeThreadCount);
+		Ar.Logf(TEXT("Flight recorder: %u KB"), Stats.FlightRecorderBytes >> 10);
+	}));
+
+#endif // FLIGHTRECORDERTRACE_ENABLED
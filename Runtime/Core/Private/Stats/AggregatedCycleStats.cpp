@@ -0,0 +1,243 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Stats/AggregatedCycleStats.h"
+
+#if USE_AGGREGATED_CYCLE_STATS
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/UnrealMemory.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+CORE_API bool GAggregatedCycleStatsEnabled = true;
+
+static FAutoConsoleVariableRef CVarAggregatedCycleStatsEnable(
+	TEXT("stats.Aggregated.Enable"),
+	GAggregatedCycleStatsEnabled,
+	TEXT("When enabled, cycle counter scopes accumulate into per-thread aggregated stats."),
+	ECVF_Default);
+
+static float GAggregatedCycleStatsCsvMinMs = 0.1f;
+static FAutoConsoleVariableRef CVarAggregatedCycleStatsCsvMinMs(
+	TEXT("stats.Aggregated.CsvMinMs"),
+	GAggregatedCycleStatsCsvMinMs,
+	TEXT("Aggregated cycle stats are written to the CSV profiler in frames where they took at least this many milliseconds."),
+	ECVF_Default);
+
+static int32 GAggregatedCycleStatsMaxWindow = 120;
+static FAutoConsoleVariableRef CVarAggregatedCycleStatsMaxWindow(
+	TEXT("stats.Aggregated.MaxWindow"),
+	GAggregatedCycleStatsMaxWindow,
+	TEXT("Number of frames over which the maximum of an aggregated cycle stat is taken."),
+	ECVF_Default);
+
+#if CSV_PROFILER
+CSV_DEFINE_CATEGORY(AggregatedStats, true);
+#endif
+
+uint32 FAggregatedCycleStats::TlsSlot = 0;
+
+int32 FAggregatedCycleStat::Register()
+{
+	const int32 NewIndex = FAggregatedCycleStats::Get().FindOrAddStat(Name);
+	FPlatformAtomics::InterlockedExchange(&Index, NewIndex);
+	return NewIndex;
+}
+
+FAggregatedCycleStats& FAggregatedCycleStats::Get()
+{
+	static FAggregatedCycleStats Singleton;
+	return Singleton;
+}
+
+FAggregatedCycleStats::FAggregatedCycleStats()
+	: ThreadBlocks(nullptr)
+	, WindowFrames(0)
+{
+	TlsSlot = FPlatformTLS::AllocTlsSlot();
+	Stats.Reserve(1024);
+}
+
+int32 FAggregatedCycleStats::FindOrAddStat(const TCHAR* Name)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	if (const int32* ExistingIndex = NameToIndex.Find(Name))
+	{
+		return *ExistingIndex;
+	}
+
+	// The last index is shared by everything registered after the table is full.
+	if (Stats.Num() >= MaxStats - 1)
+	{
+		if (Stats.Num() == MaxStats - 1)
+		{
+			FStatInfo& Overflow = Stats.AddZeroed_GetRef();
+			Overflow.Name = TEXT("STAT_AggregatedOverflow");
+			Overflow.Frame.Name = Overflow.Name;
+		}
+		return MaxStats - 1;
+	}
+
+	const int32 NewIndex = Stats.Num();
+	FStatInfo& Info = Stats.AddZeroed_GetRef();
+	Info.Name = Name;
+	Info.Frame.Name = Name;
+	NameToIndex.Add(Name, NewIndex);
+	return NewIndex;
+}
+
+FAggregatedCycleStats::FThreadBlock* FAggregatedCycleStats::CreateThreadBlock()
+{
+	FThreadBlock* Block = (FThreadBlock*)FMemory::Malloc(sizeof(FThreadBlock), alignof(FThreadBlock));
+	FMemory::Memzero(Block, sizeof(FThreadBlock));
+	Block->ThreadId = FPlatformTLS::GetCurrentThreadId();
+	FPlatformTLS::SetTlsValue(TlsSlot, Block);
+
+	// Blocks are never removed so a plain CAS push is enough. They outlive their thread so its totals stay correct.
+	FThreadBlock* Head;
+	do
+	{
+		Head = ThreadBlocks;
+		Block->Next = Head;
+	}
+	while (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&ThreadBlocks, Block, Head) != Head);
+
+	return Block;
+}
+
+FAggregatedCycleStatSlot* FAggregatedCycleStats::CreatePage(FThreadBlock& Block, int32 PageIndex)
+{
+	const SIZE_T PageSize = sizeof(FAggregatedCycleStatSlot) * SlotsPerPage;
+	FAggregatedCycleStatSlot* Page = (FAggregatedCycleStatSlot*)FMemory::Malloc(PageSize, PLATFORM_CACHE_LINE_SIZE);
+	FMemory::Memzero(Page, PageSize);
+	FPlatformAtomics::InterlockedExchangePtr((void**)&Block.Pages[PageIndex], Page);
+	return Page;
+}
+
+void FAggregatedCycleStats::AdvanceFrame()
+{
+	const double MsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000.0;
+
+	FScopeLock Lock(&CriticalSection);
+
+	const int32 NumStats = Stats.Num();
+	TArray<FAggregatedCycleStatSlot> Totals;
+	Totals.AddZeroed(NumStats);
+
+	for (FThreadBlock* Block = ThreadBlocks; Block; Block = Block->Next)
+	{
+		for (int32 PageIndex = 0; PageIndex * SlotsPerPage < NumStats; ++PageIndex)
+		{
+			const FAggregatedCycleStatSlot* Page = Block->Pages[PageIndex];
+			if (!Page)
+			{
+				continue;
+			}
+
+			const int32 NumSlots = FMath::Min(SlotsPerPage, NumStats - PageIndex * SlotsPerPage);
+			for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+			{
+				// Racy read of a value only the owning thread writes; at worst we see last frame's value and
+				// the difference shows up next frame.
+				const volatile FAggregatedCycleStatSlot& Slot = Page[SlotIndex];
+				FAggregatedCycleStatSlot& Total = Totals[PageIndex * SlotsPerPage + SlotIndex];
+				Total.Cycles += Slot.Cycles;
+				Total.Calls += Slot.Calls;
+			}
+		}
+	}
+
+	const bool bNewWindow = ++WindowFrames >= FMath::Max(GAggregatedCycleStatsMaxWindow, 1);
+	if (bNewWindow)
+	{
+		WindowFrames = 0;
+	}
+
+#if CSV_PROFILER
+	const bool bWriteCsv = FCsvProfiler::Get()->IsCapturing();
+#endif
+
+	for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+	{
+		FStatInfo& Info = Stats[StatIndex];
+		const FAggregatedCycleStatSlot& Total = Totals[StatIndex];
+
+		const double FrameMs = double(Total.Cycles - Info.PreviousCycles) * MsPerCycle;
+		Info.Frame.LastCalls = Total.Calls - Info.PreviousCalls;
+		Info.Frame.LastMs = FrameMs;
+		Info.Frame.AverageMs = FMath::Lerp(Info.Frame.AverageMs, FrameMs, 0.1);
+		Info.WindowMaxMs = FMath::Max(Info.WindowMaxMs, FrameMs);
+		if (bNewWindow)
+		{
+			Info.Frame.MaxMs = Info.WindowMaxMs;
+			Info.WindowMaxMs = 0.0;
+		}
+		Info.PreviousCycles = Total.Cycles;
+		Info.PreviousCalls = Total.Calls;
+
+#if CSV_PROFILER
+		if (bWriteCsv && FrameMs >= GAggregatedCycleStatsCsvMinMs)
+		{
+			if (Info.CsvName.IsNone())
+			{
+				Info.CsvName = FName(Info.Name);
+			}
+			FCsvProfiler::RecordCustomStat(Info.CsvName, CSV_CATEGORY_INDEX(AggregatedStats), float(FrameMs), ECsvCustomStatOp::Set);
+		}
+#endif
+	}
+}
+
+void FAggregatedCycleStats::GetFrameValues(TArray<FAggregatedCycleStatFrameValue>& OutValues) const
+{
+	FScopeLock Lock(&CriticalSection);
+
+	OutValues.Reset(Stats.Num());
+	for (const FStatInfo& Info : Stats)
+	{
+		if (Info.Frame.AverageMs > 0.0 || Info.Frame.MaxMs > 0.0)
+		{
+			OutValues.Add(Info.Frame);
+		}
+	}
+}
+
+void FAggregatedCycleStats::Dump(FOutputDevice& Ar, const TCHAR* Filter, int32 MaxStatsToDump) const
+{
+	TArray<FAggregatedCycleStatFrameValue> Values;
+	GetFrameValues(Values);
+
+	if (Filter && *Filter)
+	{
+		Values.RemoveAll([Filter](const FAggregatedCycleStatFrameValue& Value)
+		{
+			return FCString::Stristr(Value.Name, Filter) == nullptr;
+		});
+	}
+
+	Values.Sort([](const FAggregatedCycleStatFrameValue& A, const FAggregatedCycleStatFrameValue& B)
+	{
+		return A.AverageMs > B.AverageMs;
+	});
+
+	Ar.Logf(TEXT("%-64s %10s %10s %10s %8s"), TEXT("Stat"), TEXT("Avg ms"), TEXT("Max ms"), TEXT("Last ms"), TEXT("Calls"));
+	for (int32 Index = 0; Index < FMath::Min(MaxStatsToDump, Values.Num()); ++Index)
+	{
+		const FAggregatedCycleStatFrameValue& Value = Values[Index];
+		Ar.Logf(TEXT("%-64s %10.3f %10.3f %10.3f %8llu"), Value.Name, Value.AverageMs, Value.MaxMs, Value.LastMs, Value.LastCalls);
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GAggregatedCycleStatsDumpCmd(
+	TEXT("stats.Aggregated.Dump"),
+	TEXT("Logs the most expensive aggregated cycle stats. Usage: stats.Aggregated.Dump [NameFilter] [Count]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		const FString Filter = Args.Num() > 0 ? Args[0] : FString();
+		const int32 Count = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 40;
+		FAggregatedCycleStats::Get().Dump(Ar, *Filter, Count);
+	}));
+
+#endif // USE_AGGREGATED_CYCLE_STATS
@@ -224,6 +224,9 @@ void FStats::AdvanceFrame( bool bDiscardCallstack, const FOnAdvanceRenderingThre
 	FThreadStats::ExplicitFlush( bDiscardCallstack );
 	FThreadStats::WaitForStats();
 	MasterDisableChangeTagStartFrame = FThreadStats::MasterDisableChangeTag();
+#elif USE_AGGREGATED_CYCLE_STATS && !ENABLE_STATNAMEDEVENTS
+	check( IsInGameThread() );
+	FAggregatedCycleStats::Get().AdvanceFrame();
 #endif
 }
 
@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/MallocSamplingProfiler.h"
+#include "HAL/UnrealMemory.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && USE_MALLOC_SAMPLING_PROFILER
+
+namespace MallocSamplingProfilerTestPrivate
+{
+	/** Forwards to FMemory, can be told to fail reallocs or to keep them in place */
+	class FTestMalloc final : public FMalloc
+	{
+	public:
+		virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+		{
+			return FMemory::Malloc(Size, Alignment);
+		}
+
+		virtual void* Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+		{
+			if (bFailRealloc && NewSize > 0)
+			{
+				return nullptr;
+			}
+			if (bReallocInPlace && Ptr != nullptr && NewSize > 0)
+			{
+				return Ptr;
+			}
+			return FMemory::Realloc(Ptr, NewSize, Alignment);
+		}
+
+		virtual void Free(void* Ptr) override
+		{
+			FMemory::Free(Ptr);
+		}
+
+		bool bFailRealloc = false;
+		bool bReallocInPlace = false;
+	};
+
+	FHeapSampleSiteStats GetTotals(FMallocSamplingProfiler& Profiler)
+	{
+		FHeapSampleSnapshot Snapshot;
+		Profiler.TakeSnapshot(Snapshot);
+		return Snapshot.GetTotals();
+	}
+}
+
+/**
+ * Samples every allocation made through a profiler and checks live sample bookkeeping across allocs, reallocs that move,
+ * stay in place, fail or free, and frees.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMallocSamplingProfilerBookkeepingTest, "System.Core.HAL.MallocSamplingProfiler", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FMallocSamplingProfilerBookkeepingTest::RunTest(const FString& Parameters)
+{
+	using namespace MallocSamplingProfilerTestPrivate;
+
+	// Sampling state is per thread and shared by all profilers, the global one would keep rearming it.
+	if (GMallocSamplingProfiler && GMallocSamplingProfiler->IsSampling())
+	{
+		AddInfo(TEXT("Skipped, heap sampling is running on the global allocator"));
+		return true;
+	}
+
+	FTestMalloc TestMalloc;
+	FMallocSamplingProfiler Profiler(&TestMalloc);
+
+	// A rate of 1 byte samples every allocation of more than a few bytes, once the first allocation armed the thread
+	Profiler.StartSampling(1);
+	Profiler.Free(Profiler.Malloc(16, DEFAULT_ALIGNMENT));
+	const FHeapSampleSiteStats Baseline = GetTotals(Profiler);
+
+	void* Ptr = Profiler.Malloc(1024, DEFAULT_ALIGNMENT);
+	TestEqual(TEXT("Live count after malloc"), GetTotals(Profiler).LiveCount - Baseline.LiveCount, int64(1));
+	TestEqual(TEXT("Live bytes after malloc"), GetTotals(Profiler).LiveBytes - Baseline.LiveBytes, int64(1024));
+
+	Ptr = Profiler.Realloc(Ptr, 2048, DEFAULT_ALIGNMENT);
+	TestEqual(TEXT("Live count after moving realloc"), GetTotals(Profiler).LiveCount - Baseline.LiveCount, int64(1));
+	TestEqual(TEXT("Live bytes after moving realloc"), GetTotals(Profiler).LiveBytes - Baseline.LiveBytes, int64(2048));
+
+	TestMalloc.bFailRealloc = true;
+	TestNull(TEXT("Failed realloc"), Profiler.Realloc(Ptr, 4096, DEFAULT_ALIGNMENT));
+	TestMalloc.bFailRealloc = false;
+	TestEqual(TEXT("Live count after failed realloc"), GetTotals(Profiler).LiveCount - Baseline.LiveCount, int64(1));
+	TestEqual(TEXT("Live bytes after failed realloc"), GetTotals(Profiler).LiveBytes - Baseline.LiveBytes, int64(2048));
+
+	TestMalloc.bReallocInPlace = true;
+	TestEqual(TEXT("Realloc in place"), Profiler.Realloc(Ptr, 512, DEFAULT_ALIGNMENT), Ptr);
+	TestMalloc.bReallocInPlace = false;
+	TestEqual(TEXT("Live count after realloc in place"), GetTotals(Profiler).LiveCount - Baseline.LiveCount, int64(1));
+	TestEqual(TEXT("Live bytes after realloc in place"), GetTotals(Profiler).LiveBytes - Baseline.LiveBytes, int64(512));
+
+	Profiler.Free(Ptr);
+	TestEqual(TEXT("Live count after free"), GetTotals(Profiler).LiveCount, Baseline.LiveCount);
+	TestEqual(TEXT("Live bytes after free"), GetTotals(Profiler).LiveBytes, Baseline.LiveBytes);
+
+	Ptr = Profiler.Realloc(nullptr, 1024, DEFAULT_ALIGNMENT);
+	TestEqual(TEXT("Live count after realloc from null"), GetTotals(Profiler).LiveCount - Baseline.LiveCount, int64(1));
+	TestNull(TEXT("Realloc to zero"), Profiler.Realloc(Ptr, 0, DEFAULT_ALIGNMENT));
+	TestEqual(TEXT("Live count after realloc to zero"), GetTotals(Profiler).LiveCount, Baseline.LiveCount);
+
+	TestEqual(TEXT("Allocated count"), GetTotals(Profiler).AllocatedCount - Baseline.AllocatedCount, int64(4));
+
+	Profiler.StopSampling();
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && USE_MALLOC_SAMPLING_PROFILER
@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Misc/AutomationTest.h"
+#include "ProfilingDebugging/CsvColumnar.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCsvColumnarTest, "System.Core.ProfilingDebugging.CsvColumnar", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FCsvColumnarTest::RunTest(const FString& Parameters)
+{
+	// Columns round trip, and constant or linear columns collapse into a single run
+	{
+		TArray<uint32> Ints;
+		TArray<uint32> Floats;
+		TArray<uint32> Linear;
+		for (int32 Index = 0; Index < 200; ++Index)
+		{
+			const int32 IntValue = (Index % 7) * (Index % 2 ? -1000 : 1);
+			const float FloatValue = 16.6f + float(Index % 5) * 0.25f;
+			Ints.Add(uint32(IntValue));
+			Floats.Add(*(const uint32*)&FloatValue);
+			Linear.Add(uint32(1000 + Index));
+		}
+
+		for (const TPair<ECsvColumnType, const TArray<uint32>*>& Column : { MakeTuple(ECsvColumnType::Int, &Ints), MakeTuple(ECsvColumnType::Float, &Floats), MakeTuple(ECsvColumnType::Int, &Linear) })
+		{
+			TArray<uint8> Encoded;
+			FCsvColumnarCodec::EncodeColumn(Column.Key, Column.Value->GetData(), Column.Value->Num(), Encoded);
+
+			TArray<uint32> Decoded;
+			Decoded.SetNumZeroed(Column.Value->Num());
+			const uint8* Cursor = Encoded.GetData();
+			TestTrue(TEXT("Column decodes"), FCsvColumnarCodec::DecodeColumn(Column.Key, Cursor, Encoded.GetData() + Encoded.Num(), Decoded.Num(), Decoded.GetData()));
+			TestTrue(TEXT("Column consumed"), Cursor == Encoded.GetData() + Encoded.Num());
+			TestTrue(TEXT("Column round trips"), Decoded == *Column.Value);
+		}
+
+		TArray<uint8> Encoded;
+		FCsvColumnarCodec::EncodeColumn(ECsvColumnType::Int, Linear.GetData(), Linear.Num(), Encoded);
+		TestTrue(TEXT("Linear column is two runs"), Encoded.Num() <= 6);
+
+		const uint8* Cursor = Encoded.GetData();
+		TestFalse(TEXT("Truncated column fails"), FCsvColumnarCodec::DecodeColumn(ECsvColumnType::Int, Cursor, Encoded.GetData() + 1, Linear.Num(), Ints.GetData()));
+	}
+
+	// A file with two blocks, a column that first appears in the second one, events and metadata
+	{
+		TArray<uint8> Data;
+		Data.AddZeroed(8);
+		((uint32*)Data.GetData())[0] = FCsvColumnarCodec::Magic;
+		((uint32*)Data.GetData())[1] = FCsvColumnarCodec::Version;
+
+		const uint32 Frames0[] = { 10, 11 };
+		const float Times0[] = { 16.0f, 33.0f };
+		Data.Add(uint8(FCsvColumnarCodec::EBlockType::Frames));
+		FCsvColumnarCodec::WriteVarUInt(2, Data);
+		FCsvColumnarCodec::WriteVarUInt(1, Data);
+		Data.Add(uint8(ECsvColumnType::Float));
+		FCsvColumnarCodec::WriteString(TEXT("FrameTime"), Data);
+		FCsvColumnarCodec::WriteVarUInt(1, Data);
+		FCsvColumnarCodec::WriteVarUInt(1, Data);
+		FCsvColumnarCodec::WriteString(TEXT("Hitch"), Data);
+		FCsvColumnarCodec::EncodeColumn(ECsvColumnType::Int, Frames0, 2, Data);
+		FCsvColumnarCodec::EncodeColumn(ECsvColumnType::Float, (const uint32*)Times0, 2, Data);
+
+		const uint32 Frames1[] = { 13 };
+		const float Times1[] = { 17.0f };
+		const int32 Counts1[] = { -4 };
+		Data.Add(uint8(FCsvColumnarCodec::EBlockType::Frames));
+		FCsvColumnarCodec::WriteVarUInt(1, Data);
+		FCsvColumnarCodec::WriteVarUInt(1, Data);
+		Data.Add(uint8(ECsvColumnType::Int));
+		FCsvColumnarCodec::WriteString(TEXT("Count"), Data);
+		FCsvColumnarCodec::WriteVarUInt(0, Data);
+		FCsvColumnarCodec::EncodeColumn(ECsvColumnType::Int, Frames1, 1, Data);
+		FCsvColumnarCodec::EncodeColumn(ECsvColumnType::Float, (const uint32*)Times1, 1, Data);
+		FCsvColumnarCodec::EncodeColumn(ECsvColumnType::Int, (const uint32*)Counts1, 1, Data);
+
+		Data.Add(uint8(FCsvColumnarCodec::EBlockType::Metadata));
+		FCsvColumnarCodec::WriteVarUInt(1, Data);
+		FCsvColumnarCodec::WriteString(TEXT("Platform"), Data);
+		FCsvColumnarCodec::WriteString(TEXT("Test"), Data);
+
+		FCsvColumnarFile File;
+		TestTrue(TEXT("File loads"), File.Load(Data));
+		TestEqual(TEXT("Row count"), File.Frames.Num(), 3);
+		TestEqual(TEXT("Last frame"), File.Frames.Num() == 3 ? File.Frames[2] : 0, int64(13));
+
+		const FCsvColumnarFile::FColumn* FrameTime = File.FindColumn(TEXT("FrameTime"));
+		const FCsvColumnarFile::FColumn* Count = File.FindColumn(TEXT("Count"));
+		if (TestNotNull(TEXT("FrameTime column"), FrameTime) && TestNotNull(TEXT("Count column"), Count))
+		{
+			TestTrue(TEXT("FrameTime values"), FrameTime->Values == TArray<float>({ 16.0f, 33.0f, 17.0f }));
+			TestTrue(TEXT("Late column is zero before it appears"), Count->Values == TArray<float>({ 0.0f, 0.0f, -4.0f }));
+		}
+
+		TestTrue(TEXT("Event row"), File.Events.Num() == 1 && File.Events[0].Row == 1 && File.Events[0].Text == TEXT("Hitch"));
+		TestTrue(TEXT("Metadata"), File.Metadata.FindRef(TEXT("Platform")) == TEXT("Test"));
+
+		Data.SetNum(Data.Num() - 3);
+		TestFalse(TEXT("Truncated file fails"), File.Load(Data));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
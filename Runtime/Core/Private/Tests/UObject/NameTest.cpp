@@ -0,0 +1,200 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreTypes.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Containers/StringView.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Thread.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "UObject/NameBatchSerialization.h"
+#include "UObject/NameTypes.h"
+
+namespace NameTestPrivate
+{
+	/** Names that end with a letter so FName doesn't split off a number suffix */
+	static TArray<FString> MakeUniqueNames(const TCHAR* Prefix, int32 Num)
+	{
+		TArray<FString> Out;
+		Out.Reserve(Num);
+		for (int32 Idx = 0; Idx < Num; ++Idx)
+		{
+			Out.Add(FString::Printf(TEXT("%s_%d_Name"), Prefix, Idx));
+		}
+		return Out;
+	}
+
+	static TArray<FStringView> MakeViews(const TArray<FString>& Strings)
+	{
+		TArray<FStringView> Out;
+		Out.Reserve(Strings.Num());
+		for (const FString& String : Strings)
+		{
+			Out.Add(FStringView(*String, String.Len()));
+		}
+		return Out;
+	}
+
+	/** Runs Body(ThreadIndex) on NumThreads threads that start at the same time and returns the wall time in seconds */
+	template<typename BodyType>
+	static double RunOnThreads(int32 NumThreads, BodyType Body)
+	{
+		FThreadSafeCounter NumReady;
+		volatile bool bGo = false;
+		double StartTime = 0.0;
+
+		TArray<FThread> Threads;
+		for (int32 ThreadIdx = 0; ThreadIdx < NumThreads; ++ThreadIdx)
+		{
+			Threads.Emplace(TEXT("NameTest"), [&NumReady, &bGo, &Body, ThreadIdx]()
+			{
+				NumReady.Increment();
+				while (!bGo)
+				{
+					FPlatformProcess::Yield();
+				}
+				Body(ThreadIdx);
+			});
+		}
+
+		while (NumReady.GetValue() < NumThreads)
+		{
+			FPlatformProcess::Yield();
+		}
+
+		StartTime = FPlatformTime::Seconds();
+		bGo = true;
+
+		for (FThread& Thread : Threads)
+		{
+			Thread.Join();
+		}
+
+		return FPlatformTime::Seconds() - StartTime;
+	}
+}
+
+/**
+ * Checks that CreateNameBatch() resolves to the same names as constructing them one at a time,
+ * also when several threads race to create the same names.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNameBatchTest, "System.Core.UObject.NameBatch", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FNameBatchTest::RunTest(const FString& Parameters)
+{
+	using namespace NameTestPrivate;
+
+	const FName Existing(TEXT("NameBatchTest_Existing"));
+
+	const FAnsiStringView AnsiStrings[] = { "NameBatchTest_Existing", "NAMEBATCHTEST_EXISTING", "NameBatchTest_New", "", "None" };
+	TArray<FNameEntryId> AnsiIds;
+	CreateNameBatch(AnsiIds, MakeArrayView(AnsiStrings));
+
+	if (TestEqual(TEXT("One id per string"), AnsiIds.Num(), (int32)UE_ARRAY_COUNT(AnsiStrings)))
+	{
+		TestTrue(TEXT("Finds existing name"), FName::CreateFromDisplayId(AnsiIds[0], NAME_NO_NUMBER_INTERNAL) == Existing);
+		TestTrue(TEXT("Compares case-insensitively"), FName::CreateFromDisplayId(AnsiIds[1], NAME_NO_NUMBER_INTERNAL) == Existing);
+		TestTrue(TEXT("Adds new name"), FName::CreateFromDisplayId(AnsiIds[2], NAME_NO_NUMBER_INTERNAL) == FName(TEXT("NameBatchTest_New")));
+		TestTrue(TEXT("Empty string is None"), FName::CreateFromDisplayId(AnsiIds[3], NAME_NO_NUMBER_INTERNAL).IsNone());
+		TestTrue(TEXT("None is None"), FName::CreateFromDisplayId(AnsiIds[4], NAME_NO_NUMBER_INTERNAL).IsNone());
+	}
+
+	const FStringView WideStrings[] = { TEXT("NameBatchTest_Existing"), TEXT("NameBatchTest_Wide\u00C5") };
+	TArray<FNameEntryId> WideIds;
+	CreateNameBatch(WideIds, MakeArrayView(WideStrings));
+
+	if (TestEqual(TEXT("One id per wide string"), WideIds.Num(), (int32)UE_ARRAY_COUNT(WideStrings)))
+	{
+		TestTrue(TEXT("Pure ANSI wide string finds ANSI name"), FName::CreateFromDisplayId(WideIds[0], NAME_NO_NUMBER_INTERNAL) == Existing);
+		TestTrue(TEXT("Wide name round-trips"), FName::CreateFromDisplayId(WideIds[1], NAME_NO_NUMBER_INTERNAL).ToString() == TEXT("NameBatchTest_Wide\u00C5"));
+	}
+
+	// Racing threads must agree on the ids of names none of them has seen before
+	const int32 NumThreads = 4;
+	const TArray<FString> Strings = MakeUniqueNames(TEXT("NameBatchTest_Race"), 5000);
+	const TArray<FStringView> Views = MakeViews(Strings);
+	TArray<FNameEntryId> ThreadIds[NumThreads];
+	RunOnThreads(NumThreads, [&](int32 ThreadIdx)
+	{
+		if (ThreadIdx % 2)
+		{
+			CreateNameBatch(ThreadIds[ThreadIdx], MakeArrayView(Views));
+		}
+		else
+		{
+			for (const FString& String : Strings)
+			{
+				ThreadIds[ThreadIdx].Add(FName(*String).GetDisplayIndex());
+			}
+		}
+	});
+
+	for (int32 ThreadIdx = 1; ThreadIdx < NumThreads; ++ThreadIdx)
+	{
+		TestTrue(TEXT("Racing threads create the same names"), ThreadIds[ThreadIdx] == ThreadIds[0]);
+	}
+
+	return true;
+}
+
+/**
+ * Measures FName construction throughput with 1 to 8 threads, when creating new names, when looking up
+ * names that exist and when looking them up with CreateNameBatch(). Every run adds new names to the
+ * global name table, which is never shrunk.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNamePerfTest, "System.Core.UObject.NamePerf", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FNamePerfTest::RunTest(const FString& Parameters)
+{
+	using namespace NameTestPrivate;
+
+	const int32 NumNamesPerThread = 16384;
+	const int32 MaxThreads = FMath::Min(8, FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	static int32 RunIndex = 0;
+	++RunIndex;
+
+	for (int32 NumThreads = 1; NumThreads <= MaxThreads; NumThreads *= 2)
+	{
+		TArray<TArray<FString>> Strings;
+		for (int32 ThreadIdx = 0; ThreadIdx < NumThreads; ++ThreadIdx)
+		{
+			Strings.Add(MakeUniqueNames(*FString::Printf(TEXT("NamePerf%d_%d_%d"), RunIndex, NumThreads, ThreadIdx), NumNamesPerThread));
+		}
+
+		const double CreateSeconds = RunOnThreads(NumThreads, [&Strings](int32 ThreadIdx)
+		{
+			for (const FString& String : Strings[ThreadIdx])
+			{
+				FName Name(String.Len(), *String);
+			}
+		});
+
+		// All threads look up the same names, the most contended case
+		const double FindSeconds = RunOnThreads(NumThreads, [&Strings](int32 ThreadIdx)
+		{
+			for (const FString& String : Strings[0])
+			{
+				FName Name(String.Len(), *String);
+			}
+		});
+
+		const TArray<FStringView> Views = MakeViews(Strings[0]);
+		const double BatchSeconds = RunOnThreads(NumThreads, [&Views](int32 ThreadIdx)
+		{
+			TArray<FNameEntryId> Ids;
+			CreateNameBatch(Ids, MakeArrayView(Views));
+		});
+
+		const double NumNames = double(NumThreads) * NumNamesPerThread;
+		AddInfo(FString::Printf(TEXT("%d threads: create %.2f M names/s, find %.2f M names/s, batch find %.2f M names/s"),
+			NumThreads, NumNames / CreateSeconds / 1e6, NumNames / FindSeconds / 1e6, NumNames / BatchSeconds / 1e6));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -27,6 +27,7 @@
 #include "Serialization/MemoryImage.h"
 #include "Hash/CityHash.h"
 #include "Templates/AlignmentTemplates.h"
+#include "Math/VectorRegister.h"
 
 PRAGMA_DISABLE_UNSAFE_TYPECAST_WARNINGS
 
@@ -254,6 +255,19 @@ struct FNameSlot
 	bool operator==(FNameSlot Rhs) const { return IdAndHash == Rhs.IdAndHash; }
 
 	bool Used() const { return !!IdAndHash;  }
+
+	/** Slots are read without the shard lock by FNamePoolShard::FindLockFree() */
+	FNameSlot LoadAtomic() const
+	{
+		FNameSlot Out;
+		Out.IdAndHash = static_cast<uint32>(FPlatformAtomics::AtomicRead(reinterpret_cast<volatile const int32*>(&IdAndHash)));
+		return Out;
+	}
+
+	void StoreAtomic(FNameSlot Value)
+	{
+		FPlatformAtomics::AtomicStore(reinterpret_cast<volatile int32*>(&IdAndHash), static_cast<int32>(Value.IdAndHash));
+	}
 private:
 	uint32 IdAndHash = 0;
 };
@@ -557,15 +571,66 @@ struct FNameHash
 	}
 };
 
+/**
+ * Same as TChar<CharType>::ToLower() on every character. Since only ASCII characters are
+ * case-folded, 8-bit and 16-bit characters are lowered 16 bytes at a time by adding 0x20
+ * to every lane that lies within 'A'..'Z'.
+ */
 template<class CharType>
-FORCENOINLINE uint64 FNameHash::GenerateLowerCaseHash(const CharType* Str, uint32 Len)
+FORCEINLINE void ToLowerNameChars(const CharType* Str, uint32 Len, CharType* Out)
 {
-	CharType LowerStr[NAME_SIZE];
-	for (uint32 I = 0; I < Len; ++I)
+	uint32 I = 0;
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS || PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+	static constexpr uint32 CharsPerVector = 16 / sizeof(CharType);
+	const uint32 VectorLen = sizeof(CharType) <= 2 ? Len & ~(CharsPerVector - 1) : 0;
+	for (; I < VectorLen; I += CharsPerVector)
 	{
-		LowerStr[I] = TChar<CharType>::ToLower(Str[I]);
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+		// SSE2 only has signed compares, bias 'A'..'Z' to the 26 smallest signed values
+		__m128i Chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Str + I));
+		__m128i Lowered;
+		if (sizeof(CharType) == 1)
+		{
+			__m128i Biased = _mm_sub_epi8(Chars, _mm_set1_epi8(static_cast<char>('A' + 0x80)));
+			__m128i IsUpper = _mm_cmplt_epi8(Biased, _mm_set1_epi8(static_cast<char>(-0x80 + 26)));
+			Lowered = _mm_add_epi8(Chars, _mm_and_si128(IsUpper, _mm_set1_epi8(0x20)));
+		}
+		else
+		{
+			__m128i Biased = _mm_sub_epi16(Chars, _mm_set1_epi16(static_cast<short>('A' + 0x8000)));
+			__m128i IsUpper = _mm_cmplt_epi16(Biased, _mm_set1_epi16(static_cast<short>(-0x8000 + 26)));
+			Lowered = _mm_add_epi16(Chars, _mm_and_si128(IsUpper, _mm_set1_epi16(0x20)));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Out + I), Lowered);
+#else
+		if (sizeof(CharType) == 1)
+		{
+			uint8x16_t Chars = vld1q_u8(reinterpret_cast<const uint8*>(Str + I));
+			uint8x16_t IsUpper = vcltq_u8(vsubq_u8(Chars, vdupq_n_u8('A')), vdupq_n_u8(26));
+			vst1q_u8(reinterpret_cast<uint8*>(Out + I), vaddq_u8(Chars, vandq_u8(IsUpper, vdupq_n_u8(0x20))));
+		}
+		else
+		{
+			uint16x8_t Chars = vld1q_u16(reinterpret_cast<const uint16*>(Str + I));
+			uint16x8_t IsUpper = vcltq_u16(vsubq_u16(Chars, vdupq_n_u16('A')), vdupq_n_u16(26));
+			vst1q_u16(reinterpret_cast<uint16*>(Out + I), vaddq_u16(Chars, vandq_u16(IsUpper, vdupq_n_u16(0x20))));
+		}
+#endif
+	}
+#endif
+
+	for (; I < Len; ++I)
+	{
+		Out[I] = TChar<CharType>::ToLower(Str[I]);
 	}
+}
 
+template<class CharType>
+FORCENOINLINE uint64 FNameHash::GenerateLowerCaseHash(const CharType* Str, uint32 Len)
+{
+	CharType LowerStr[NAME_SIZE];
+	ToLowerNameChars(Str, Len, LowerStr);
 	return FNameHash::GenerateHash(LowerStr, Len);
 }
 
@@ -573,10 +638,7 @@ template<class CharType>
 FORCENOINLINE FNameHash HashLowerCase(const CharType* Str, uint32 Len)
 {
 	CharType LowerStr[NAME_SIZE];
-	for (uint32 I = 0; I < Len; ++I)
-	{
-		LowerStr[I] = TChar<CharType>::ToLower(Str[I]);
-	}
+	ToLowerNameChars(Str, Len, LowerStr);
 	return FNameHash(LowerStr, Len);
 }
 
@@ -631,8 +693,7 @@ public:
 		LLM_SCOPE(ELLMTag::FName);
 		Entries = &InEntries;
 
-		Slots = (FNameSlot*)FMemory::Malloc(FNamePoolInitialSlotsPerShard * sizeof(FNameSlot), alignof(FNameSlot));
-		memset(Slots, 0, FNamePoolInitialSlotsPerShard * sizeof(FNameSlot));
+		Slots = AllocSlots(FNamePoolInitialSlotsPerShard);
 		CapacityMask = FNamePoolInitialSlotsPerShard - 1;
 	}
 
@@ -640,7 +701,14 @@ public:
 	// but only via explicit FName::TearDown() call
 	~FNamePoolShardBase()
 	{
-		FMemory::Free(Slots);
+		while (RetiredSlots)
+		{
+			FNameSlot* Next = RetiredLink(RetiredSlots);
+			FreeSlots(RetiredSlots);
+			RetiredSlots = Next;
+		}
+
+		FreeSlots(Slots);
 		UsedSlots = 0;
 		CapacityMask = 0;
 		Slots = nullptr;
@@ -662,12 +730,39 @@ protected:
 
 	mutable FRWLock Lock;
 	uint32 UsedSlots = 0;
+	// Slots and CapacityMask are written under the lock but also read by FindLockFree().
+	// Grow() publishes Slots before CapacityMask so a reader never sees a mask larger than its slot array.
 	uint32 CapacityMask = 0;
-	FNameSlot* Slots = nullptr;
+	FNameSlot* volatile Slots = nullptr;
+	// Slot arrays replaced by Grow(). Lock-free readers may still be probing them, so they
+	// are kept until teardown. Each array is half the size of the next one or smaller.
+	FNameSlot* RetiredSlots = nullptr;
 	FNameEntryAllocator* Entries = nullptr;
 	uint32 NumCreatedEntries = 0;
 	uint32 NumCreatedWideEntries = 0;
 
+	/** Slot arrays are prefixed with a pointer that links retired arrays together */
+	static FNameSlot* AllocSlots(uint32 Num)
+	{
+		uint32 Bytes = sizeof(FNameSlot*) + Num * sizeof(FNameSlot);
+		uint8* Data = (uint8*)FMemory::Malloc(Bytes, alignof(FNameSlot*));
+		memset(Data, 0, Bytes);
+		return reinterpret_cast<FNameSlot*>(Data + sizeof(FNameSlot*));
+	}
+
+	static void FreeSlots(FNameSlot* InSlots)
+	{
+		if (InSlots)
+		{
+			FMemory::Free(reinterpret_cast<uint8*>(InSlots) - sizeof(FNameSlot*));
+		}
+	}
+
+	static FNameSlot*& RetiredLink(FNameSlot* InSlots)
+	{
+		return *reinterpret_cast<FNameSlot**>(reinterpret_cast<uint8*>(InSlots) - sizeof(FNameSlot*));
+	}
+
 
 	template<ENameCase Sensitivity>
 	FORCEINLINE static bool EntryEqualsValue(const FNameEntry& Entry, const FNameValue<Sensitivity>& Value)
@@ -682,11 +777,45 @@ class FNamePoolShard : public FNamePoolShardBase
 public:
 	FNameEntryId Find(const FNameValue<Sensitivity>& Value) const
 	{
+		if (FNameEntryId Existing = FindLockFree(Value))
+		{
+			return Existing;
+		}
+
 		FRWScopeLock _(Lock, FRWScopeLockType::SLT_ReadOnly);
 
 		return Probe(Value).GetId();
 	}
 
+	/**
+	 * Finds an existing name without taking the lock.
+	 *
+	 * Can miss names that are being inserted or rehashed by a concurrent Grow() and always misses "None",
+	 * whose id is zero. Callers must fall back to Find() or Insert() when nothing is found.
+	 */
+	FNameEntryId FindLockFree(const FNameValue<Sensitivity>& Value) const
+	{
+		const uint32 Mask = static_cast<uint32>(FPlatformAtomics::AtomicRead(reinterpret_cast<volatile const int32*>(&CapacityMask)));
+		const FNameSlot* TableSlots = Slots;
+
+		// A table grown after we read the mask can in theory be dense over our shorter probe range, so bound the probe
+		for (uint32 I = FNameHash::GetProbeStart(Value.Hash.UnmaskedSlotIndex, Mask), NumProbed = 0; NumProbed <= Mask; I = (I + 1) & Mask, ++NumProbed)
+		{
+			const FNameSlot Slot = TableSlots[I].LoadAtomic();
+			if (!Slot.Used())
+			{
+				break;
+			}
+
+			if (Slot.GetProbeHash() == Value.Hash.SlotProbeHash && EntryEqualsValue<Sensitivity>(Entries->Resolve(Slot.GetId()), Value))
+			{
+				return Slot.GetId();
+			}
+		}
+
+		return FNameEntryId();
+	}
+
 	template<class ScopeLock = FWriteScopeLock>
 	FORCEINLINE FNameEntryId Insert(const FNameValue<Sensitivity>& Value, bool& bCreatedNewEntry)
 	{
@@ -736,7 +865,8 @@ public:
 private:
 	void ClaimSlot(FNameSlot& UnusedSlot, FNameSlot NewValue)
 	{
-		UnusedSlot = NewValue;
+		// Entry data must be visible to lock-free readers before the slot is
+		UnusedSlot.StoreAtomic(NewValue);
 
 		++UsedSlots;
 		if (UsedSlots * LoadFactorDivisor >= LoadFactorQuotient * Capacity())
@@ -757,11 +887,10 @@ private:
 		const uint32 OldUsedSlots = UsedSlots;
 		const uint32 OldCapacity = Capacity();
 
-		Slots = (FNameSlot*)FMemory::Malloc(NewCapacity * sizeof(FNameSlot), alignof(FNameSlot));
-		memset(Slots, 0, NewCapacity * sizeof(FNameSlot));
-		UsedSlots = 0;
-		CapacityMask = NewCapacity - 1;
-
+		// Fill the new array before publishing it to lock-free readers
+		FNameSlot* const NewSlots = AllocSlots(NewCapacity);
+		const uint32 NewCapacityMask = NewCapacity - 1;
+		uint32 NewUsedSlots = 0;
 
 		for (uint32 OldIdx = 0; OldIdx < OldCapacity; ++OldIdx)
 		{
@@ -769,15 +898,20 @@ private:
 			if (OldSlot.Used())
 			{
 				FNameHash Hash = Rehash(OldSlot.GetId());
-				FNameSlot& NewSlot = Probe(Hash.UnmaskedSlotIndex, [](FNameSlot Slot) { return false; });
+				FNameSlot& NewSlot = Probe(NewSlots, NewCapacityMask, Hash.UnmaskedSlotIndex, [](FNameSlot Slot) { return false; });
 				NewSlot = OldSlot;
-				++UsedSlots;
+				++NewUsedSlots;
 			}
 		}
 
-		check(OldUsedSlots == UsedSlots);
+		check(OldUsedSlots == NewUsedSlots);
+
+		FPlatformAtomics::InterlockedExchangePtr((void**)&Slots, NewSlots);
+		FPlatformAtomics::InterlockedExchange(reinterpret_cast<volatile int32*>(&CapacityMask), static_cast<int32>(NewCapacityMask));
+		UsedSlots = NewUsedSlots;
 
-		FMemory::Free(OldSlots);
+		RetiredLink(OldSlots) = RetiredSlots;
+		RetiredSlots = OldSlots;
 	}
 
 	/** Find slot containing value or the first free slot that should be used to store it  */
@@ -792,10 +926,15 @@ private:
 	template<class PredicateFn>
 	FORCEINLINE FNameSlot& Probe(uint32 UnmaskedSlotIndex, PredicateFn Predicate) const
 	{
-		const uint32 Mask = CapacityMask;
+		return Probe(Slots, CapacityMask, UnmaskedSlotIndex, Predicate);
+	}
+
+	template<class PredicateFn>
+	FORCEINLINE static FNameSlot& Probe(FNameSlot* InSlots, uint32 Mask, uint32 UnmaskedSlotIndex, PredicateFn Predicate)
+	{
 		for (uint32 I = FNameHash::GetProbeStart(UnmaskedSlotIndex, Mask); true; I = (I + 1) & Mask)
 		{
-			FNameSlot& Slot = Slots[I];
+			FNameSlot& Slot = InSlots[I];
 			if (!Slot.Used() || Predicate(Slot))
 			{
 				return Slot;
@@ -828,9 +967,8 @@ public:
 
 	bool			IsValid(FNameEntryHandle Handle) const;
 
-	void			BatchLock();
-	FNameEntryId	BatchStore(const FNameComparisonValue& ComparisonValue);
-	void			BatchUnlock();
+	/** Stores many comparison values with one lock per shard instead of one per name. Only names that aren't found lock-free are locked for. */
+	void			BatchStore(TArrayView<const FNameComparisonValue> ComparisonValues, FNameEntryId* OutIds);
 
 	/// Stats and debug related functions ///
 
@@ -942,7 +1080,8 @@ FNameEntryId FNamePool::Store(FNameStringView Name)
 #if WITH_CASE_PRESERVING_NAME
 	FNameDisplayValue DisplayValue(Name);
 	FNamePoolShard<ENameCase::CaseSensitive>& DisplayShard = DisplayShards[DisplayValue.Hash.ShardIndex];
-	if (FNameEntryId Existing = DisplayShard.Find(DisplayValue))
+	// Insertions below check again under the lock
+	if (FNameEntryId Existing = DisplayShard.FindLockFree(DisplayValue))
 	{
 		return Existing;
 	}
@@ -952,7 +1091,15 @@ FNameEntryId FNamePool::Store(FNameStringView Name)
 
 	// Insert comparison name first since display value must contain comparison name
 	FNameComparisonValue ComparisonValue(Name);
-	FNameEntryId ComparisonId = ComparisonShards[ComparisonValue.Hash.ShardIndex].Insert(ComparisonValue, bAdded);
+	FNamePoolShard<ENameCase::IgnoreCase>& ComparisonShard = ComparisonShards[ComparisonValue.Hash.ShardIndex];
+#if !WITH_CASE_PRESERVING_NAME
+	// Most stored names exist already, only take the write lock when they don't
+	if (FNameEntryId Existing = ComparisonShard.FindLockFree(ComparisonValue))
+	{
+		return Existing;
+	}
+#endif
+	FNameEntryId ComparisonId = ComparisonShard.Insert(ComparisonValue, bAdded);
 
 #if WITH_CASE_PRESERVING_NAME
 	// Check if ComparisonId can be used as DisplayId
@@ -971,30 +1118,43 @@ FNameEntryId FNamePool::Store(FNameStringView Name)
 #endif
 }
 
-void FNamePool::BatchLock()
+void FNamePool::BatchStore(TArrayView<const FNameComparisonValue> ComparisonValues, FNameEntryId* OutIds)
 {
-	for (const FNamePoolShardBase& Shard : ComparisonShards)
+	// Indices of values that weren't found lock-free, sorted by shard below
+	TArray<int32, TInlineAllocator<256>> Missing;
+
+	for (int32 Idx = 0, Num = ComparisonValues.Num(); Idx < Num; ++Idx)
 	{
-		Shard.BatchLock();
+		const FNameComparisonValue& Value = ComparisonValues[Idx];
+		OutIds[Idx] = ComparisonShards[Value.Hash.ShardIndex].FindLockFree(Value);
+		if (!OutIds[Idx])
+		{
+			Missing.Add(Idx);
+		}
 	}
 
-	// Acquire entry allocator lock after shard locks
-	Entries.BatchLock();
-}
+	Missing.Sort([ComparisonValues](int32 A, int32 B) { return ComparisonValues[A].Hash.ShardIndex < ComparisonValues[B].Hash.ShardIndex; });
 
-FORCEINLINE FNameEntryId FNamePool::BatchStore(const FNameComparisonValue& ComparisonValue)
-{
-	bool bCreatedNewEntry;
-	return ComparisonShards[ComparisonValue.Hash.ShardIndex].Insert<FNullScopeLock>(ComparisonValue, bCreatedNewEntry);
-}
+	for (int32 RunBegin = 0, RunEnd = 0; RunBegin < Missing.Num(); RunBegin = RunEnd)
+	{
+		const uint32 ShardIndex = ComparisonValues[Missing[RunBegin]].Hash.ShardIndex;
+		for (RunEnd = RunBegin + 1; RunEnd < Missing.Num() && ComparisonValues[Missing[RunEnd]].Hash.ShardIndex == ShardIndex; ++RunEnd) {}
 
-void FNamePool::BatchUnlock()
-{
-	Entries.BatchUnlock();
+		FNamePoolShard<ENameCase::IgnoreCase>& Shard = ComparisonShards[ShardIndex];
 
-	for (int32 Idx = FNamePoolShards - 1; Idx >= 0; --Idx)
-	{
-		ComparisonShards[Idx].BatchUnlock();
+		// Acquire entry allocator lock after shard lock, same as Insert()
+		Shard.BatchLock();
+		Entries.BatchLock();
+
+		for (int32 MissingIdx = RunBegin; MissingIdx < RunEnd; ++MissingIdx)
+		{
+			bool bCreatedNewEntry = false;
+			const int32 ValueIdx = Missing[MissingIdx];
+			OutIds[ValueIdx] = Shard.Insert<FNullScopeLock>(ComparisonValues[ValueIdx], bCreatedNewEntry);
+		}
+
+		Entries.BatchUnlock();
+		Shard.BatchUnlock();
 	}
 }
 
@@ -2820,47 +2980,113 @@ FORCENOINLINE void ReserveNameBatch(uint32 NameDataBytes, uint32 HashDataBytes)
 	GetNamePoolPostInit().Reserve(AddSlack(NameDataBytes), AddSlack(NumEntries));
 }
 
-static FNameEntryId BatchLoadNameWithoutHash(const UTF16CHAR* Str, uint32 Len)
+/**
+ * Gathers the comparison values of a batch of names and stores them a chunk at a time,
+ * which bounds temporary memory and takes each shard lock at most once per chunk.
+ *
+ * Names are referenced, not copied, until they're flushed.
+ */
+class FNameBatchBuilder
 {
-	WIDECHAR Temp[NAME_SIZE];
+public:
+	enum { ChunkSize = 1024 };
+	enum { ConvertedBytesCapacity = 64 << 10 };
+
+	explicit FNameBatchBuilder(TArray<FNameEntryId>& InOutNames)
+		: OutNames(InOutNames)
+	{
+		Values.Reserve(ChunkSize);
+	}
+
+	void Add(FNameStringView Name, FNameHash Hash)
+	{
+		Values.Emplace(Name, Hash);
+		if (Values.Num() == ChunkSize)
+		{
+			Flush();
+		}
+	}
+
+	void Flush()
+	{
+		if (Values.Num())
+		{
+			int32 Offset = OutNames.AddUninitialized(Values.Num());
+			GetNamePoolPostInit().BatchStore(Values, OutNames.GetData() + Offset);
+			Values.Reset();
+		}
+
+		ConvertedBytes.Reset();
+	}
+
+	/** Returns storage for a converted name that is valid until the next flush */
+	template<class CharType>
+	CharType* AllocateConverted(uint32 Len)
+	{
+		static_assert(NAME_SIZE * sizeof(WIDECHAR) <= ConvertedBytesCapacity, "");
+		const int32 Bytes = Align(Len * sizeof(CharType), sizeof(WIDECHAR));
+		if (ConvertedBytes.Num() + Bytes > ConvertedBytesCapacity)
+		{
+			Flush();
+		}
+
+		// Never reallocate, flushed names could point into the old allocation
+		ConvertedBytes.Reserve(ConvertedBytesCapacity);
+		int32 Offset = ConvertedBytes.AddUninitialized(Bytes);
+		return reinterpret_cast<CharType*>(ConvertedBytes.GetData() + Offset);
+	}
+
+private:
+	TArray<FNameEntryId>& OutNames;
+	TArray<FNameComparisonValue> Values;
+	TArray<uint8> ConvertedBytes;
+};
+
+static void BatchLoadNameWithoutHash(FNameBatchBuilder& Batch, const UTF16CHAR* Str, uint32 Len)
+{
+	WIDECHAR* Converted = Batch.AllocateConverted<WIDECHAR>(Len);
 	for (uint32 Idx = 0; Idx < Len; ++Idx)
 	{
-		Temp[Idx] = INTEL_ORDER16(Str[Idx]);
+		Converted[Idx] = INTEL_ORDER16(Str[Idx]);
 	}
 	
 #if PLATFORM_TCHAR_IS_4_BYTES
 	// Inline combine any surrogate pairs in the data when loading into a UTF-32 string
-	Len = StringConv::InlineCombineSurrogates_Buffer(Temp, Len);
+	Len = StringConv::InlineCombineSurrogates_Buffer(Converted, Len);
 #endif
 
-	FNameStringView Name(Temp, Len);
-	FNameHash Hash = HashName<ENameCase::IgnoreCase>(Name);
-	return GetNamePoolPostInit().BatchStore(FNameComparisonValue(Name, Hash));
+	FNameStringView Name(Converted, Len);
+	Batch.Add(Name, HashName<ENameCase::IgnoreCase>(Name));
 }
 
-static FNameEntryId BatchLoadNameWithoutHash(const ANSICHAR* Str, uint32 Len)
+static void BatchLoadNameWithoutHash(FNameBatchBuilder& Batch, const ANSICHAR* Str, uint32 Len)
 {
 	FNameStringView Name(Str, Len);
-	FNameHash Hash = HashName<ENameCase::IgnoreCase>(Name);
-	return GetNamePoolPostInit().BatchStore(FNameComparisonValue(Name, Hash));
+	Batch.Add(Name, HashName<ENameCase::IgnoreCase>(Name));
 }
 
-static FNameEntryId BatchLoadNameWithoutHash(const FNameSerializedView& Name)
+static void BatchLoadNameWithoutHash(FNameBatchBuilder& Batch, const FNameSerializedView& Name)
 {
-	return Name.bIsUtf16 ? BatchLoadNameWithoutHash(Name.Utf16, Name.Len)
-						 : BatchLoadNameWithoutHash(Name.Ansi, Name.Len);
+	if (Name.bIsUtf16)
+	{
+		BatchLoadNameWithoutHash(Batch, Name.Utf16, Name.Len);
+	}
+	else
+	{
+		BatchLoadNameWithoutHash(Batch, Name.Ansi, Name.Len);
+	}
 }
 
 template<typename CharType>
-FNameEntryId BatchLoadNameWithHash(const CharType* Str, uint32 Len, uint64 InHash)
+void BatchLoadNameWithHash(FNameBatchBuilder& Batch, const CharType* Str, uint32 Len, uint64 InHash)
 {
 	FNameStringView Name(Str, Len);
 	FNameHash Hash(Str, Len, InHash);
 	checkfSlow(Hash == HashName<ENameCase::IgnoreCase>(Name), TEXT("Precalculated hash was wrong"));
-	return GetNamePoolPostInit().BatchStore(FNameComparisonValue(Name, Hash));
+	Batch.Add(Name, Hash);
 }
 
-static FNameEntryId BatchLoadNameWithHash(const FNameSerializedView& InName, uint64 InHash)
+static void BatchLoadNameWithHash(FNameBatchBuilder& Batch, const FNameSerializedView& InName, uint64 InHash)
 {
 	if (InName.bIsUtf16)
 	{
@@ -2869,15 +3095,16 @@ static FNameEntryId BatchLoadNameWithHash(const FNameSerializedView& InName, uin
 #if PLATFORM_LITTLE_ENDIAN
 		if (sizeof(UTF16CHAR) == sizeof(WIDECHAR))
 		{
-			return BatchLoadNameWithHash(reinterpret_cast<const WIDECHAR*>(InName.Utf16), InName.Len, InHash);
+			BatchLoadNameWithHash(Batch, reinterpret_cast<const WIDECHAR*>(InName.Utf16), InName.Len, InHash);
+			return;
 		}
 #endif
 
-		return BatchLoadNameWithoutHash(InName.Utf16, InName.Len);
+		BatchLoadNameWithoutHash(Batch, InName.Utf16, InName.Len);
 	}
 	else
 	{
-		return BatchLoadNameWithHash(InName.Ansi, InName.Len, InHash);
+		BatchLoadNameWithHash(Batch, InName.Ansi, InName.Len, InHash);
 	}
 }
 
@@ -2897,7 +3124,7 @@ void LoadNameBatch(TArray<FNameEntryId>& OutNames, TArrayView<const uint8> NameD
 
 	OutNames.Empty(Hashes.Num());
 
-	GetNamePoolPostInit().BatchLock();
+	FNameBatchBuilder Batch(OutNames);
 
 	if (HashVersion == FNameHash::AlgorithmId)
 	{
@@ -2905,7 +3132,7 @@ void LoadNameBatch(TArray<FNameEntryId>& OutNames, TArrayView<const uint8> NameD
 		{
 			check(NameIt < NameEnd);
 			FNameSerializedView Name = LoadNameHeader(/* in-out */ NameIt);
-			OutNames.Add(BatchLoadNameWithHash(Name, INTEL_ORDER64(Hash)));
+			BatchLoadNameWithHash(Batch, Name, INTEL_ORDER64(Hash));
 		}
 	}
 	else
@@ -2913,16 +3140,81 @@ void LoadNameBatch(TArray<FNameEntryId>& OutNames, TArrayView<const uint8> NameD
 		while (NameIt < NameEnd)
 		{
 			FNameSerializedView Name = LoadNameHeader(/* in-out */ NameIt);
-			OutNames.Add(BatchLoadNameWithoutHash(Name));
+			BatchLoadNameWithoutHash(Batch, Name);
 		}
 	
 	}
 
-	GetNamePoolPostInit().BatchUnlock();
+	Batch.Flush();
 
 	check(NameIt == NameEnd);
 }
 
+static FNameStringView MakeBatchNameView(FNameBatchBuilder& Batch, const ANSICHAR* Str, int32 Len)
+{
+	return FNameStringView(Str, Len);
+}
+
+static FNameStringView MakeBatchNameView(FNameBatchBuilder& Batch, const WIDECHAR* Str, int32 Len)
+{
+	if (IsWide(Str, Len))
+	{
+		return FNameStringView(Str, Len);
+	}
+
+	// Pure ANSI names are always stored narrow
+	ANSICHAR* AnsiStr = Batch.AllocateConverted<ANSICHAR>(Len);
+	for (int32 I = 0; I < Len; ++I)
+	{
+		AnsiStr[I] = static_cast<ANSICHAR>(Str[I]);
+	}
+	return FNameStringView(AnsiStr, Len);
+}
+
+template<class StringViewType>
+static void CreateNameBatchImpl(TArray<FNameEntryId>& OutNames, TArrayView<const StringViewType> Strings)
+{
+	// Initialize the pool before the builder uses GetNamePoolPostInit()
+	GetNamePool();
+
+	OutNames.Reset(Strings.Num());
+	FNameBatchBuilder Batch(OutNames);
+
+	for (const StringViewType& String : Strings)
+	{
+		FNameStringView Name = MakeBatchNameView(Batch, String.GetData(), String.Len());
+		if (Name.Len == 0)
+		{
+			// Resolves to NAME_None, same as FName(TEXT(""))
+			Name = FNameStringView("None", 4);
+		}
+		else if (Name.Len >= NAME_SIZE)
+		{
+			checkf(false, TEXT("FName's %d max length exceeded. Got %d characters excluding null-terminator."), NAME_SIZE - 1, Name.Len);
+			Name = FNameStringView("ERROR_NAME_SIZE_EXCEEDED", 24);
+		}
+
+#if WITH_CASE_PRESERVING_NAME
+		// Display entries need the per-name path
+		OutNames.Add(GetNamePoolPostInit().Store(Name));
+#else
+		Batch.Add(Name, HashName<ENameCase::IgnoreCase>(Name));
+#endif
+	}
+
+	Batch.Flush();
+}
+
+void CreateNameBatch(TArray<FNameEntryId>& OutNames, TArrayView<const FAnsiStringView> Strings)
+{
+	CreateNameBatchImpl(OutNames, Strings);
+}
+
+void CreateNameBatch(TArray<FNameEntryId>& OutNames, TArrayView<const FStringView> Strings)
+{
+	CreateNameBatchImpl(OutNames, Strings);
+}
+
 #if 0 && ALLOW_NAME_BATCH_SAVING  
 
 FORCENOINLINE void PerfTestLoadNameBatch(TArray<FNameEntryId>& OutNames, TArrayView<const uint8> NameData, TArrayView<const uint8> HashData)
@@ -0,0 +1,261 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/CriticalSection.h"
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Templates/TypeHash.h"
+#include "ProfilingDebugging/UMemoryDefines.h"
+
+#if USE_MALLOC_SAMPLING_PROFILER
+
+class FOutputDevice;
+
+/** Identifies one group of sampled allocations: the call site that made them and the LLM tag that was active at the time. */
+struct FHeapSampleSiteKey
+{
+	uint32 CallSiteId;
+	int64 Tag;
+
+	FHeapSampleSiteKey()
+		: CallSiteId(0)
+		, Tag(0)
+	{
+	}
+
+	FHeapSampleSiteKey(uint32 InCallSiteId, int64 InTag)
+		: CallSiteId(InCallSiteId)
+		, Tag(InTag)
+	{
+	}
+
+	friend bool operator==(const FHeapSampleSiteKey& A, const FHeapSampleSiteKey& B)
+	{
+		return A.CallSiteId == B.CallSiteId && A.Tag == B.Tag;
+	}
+
+	friend uint32 GetTypeHash(const FHeapSampleSiteKey& Key)
+	{
+		return HashCombine(Key.CallSiteId, GetTypeHash(Key.Tag));
+	}
+};
+
+/** Estimated totals for a site. All values are scaled up by the sample weights and are therefore estimates of the real heap. */
+struct FHeapSampleSiteStats
+{
+	/** Bytes currently allocated from this site. */
+	int64 LiveBytes = 0;
+
+	/** Number of allocations currently live from this site. */
+	int64 LiveCount = 0;
+
+	/** Bytes allocated from this site since sampling started, including those that were freed again. */
+	int64 AllocatedBytes = 0;
+
+	/** Number of allocations made from this site since sampling started. */
+	int64 AllocatedCount = 0;
+};
+
+/**
+ * Point in time copy of the sampled heap, grouped by call site and LLM tag.
+ * Two snapshots can be subtracted to show growth (leaks) and allocation traffic (churn) over an interval.
+ */
+struct CORE_API FHeapSampleSnapshot
+{
+	TMap<FHeapSampleSiteKey, FHeapSampleSiteStats> Sites;
+
+	/** FPlatformTime::Seconds() when the snapshot was taken. */
+	double Time = 0.0;
+
+	/** Sampling rate (mean bytes between samples) that produced this snapshot. */
+	uint32 SampleRate = 0;
+
+	/** Returns this snapshot minus Before. Sites that did not change are omitted. */
+	FHeapSampleSnapshot Delta(const FHeapSampleSnapshot& Before) const;
+
+	/** Sums all sites. */
+	FHeapSampleSiteStats GetTotals() const;
+};
+
+/**
+ * Sampling heap profiler.
+ *
+ * Instead of tracking every allocation it picks allocations at random so that on average one is recorded every
+ * SampleRate bytes. Each sampled allocation captures its callstack and the active LLM tag and is reported through
+ * TraceLog on the HeapSamplingChannel. An in-process copy of the sampled live heap is also kept so snapshots and
+ * deltas are available without an analysis tool, e.g. on a server. Unsampled allocations only pay for a thread local
+ * counter decrement, and unsampled frees for a lookup in a small pointer filter.
+ *
+ * Wraps GMalloc when USE_MALLOC_SAMPLING_PROFILER is set. Sampling stays off until -heapsampling[=Rate] is passed
+ * on the command line or "HeapSampling Start" is executed.
+ */
+class CORE_API FMallocSamplingProfiler final : public FMalloc
+{
+public:
+	static const int32 MaxCallStackDepth = 32;
+	static const int32 CallStackEntriesToSkipCount = 3;
+	static const uint32 DefaultSampleRate = 512 * 1024;
+
+	explicit FMallocSamplingProfiler(FMalloc* InMalloc);
+
+	/** Reads -heapsampling[=Rate] from the command line. */
+	void ProcessCommandLine(const TCHAR* CmdLine);
+
+	/** Starts sampling one allocation every InSampleRate bytes on average. Live samples from a previous run are kept. */
+	void StartSampling(uint32 InSampleRate);
+
+	/** Stops taking new samples. Frees of already sampled allocations are still tracked. */
+	void StopSampling();
+
+	bool IsSampling() const
+	{
+		return SampleRate != 0;
+	}
+
+	/** Copies the current per site totals. */
+	void TakeSnapshot(FHeapSampleSnapshot& OutSnapshot);
+
+	/** Logs the largest sites of a snapshot, resolving their callstacks. */
+	void DumpSnapshot(const FHeapSampleSnapshot& Snapshot, int32 MaxSites, FOutputDevice& Ar);
+
+	// FMalloc interface.
+	virtual void* Malloc(SIZE_T Size, uint32 Alignment) override;
+	virtual void* Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override;
+	virtual void Free(void* Ptr) override;
+	virtual bool Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar) override;
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+	{
+		return UsedMalloc->QuantizeSize(Count, Alignment);
+	}
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+	{
+		return UsedMalloc->GetAllocationSize(Original, SizeOut);
+	}
+
+	virtual void Trim(bool bTrimThreadCaches) override
+	{
+		UsedMalloc->Trim(bTrimThreadCaches);
+	}
+
+	virtual void SetupTLSCachesOnCurrentThread() override
+	{
+		UsedMalloc->SetupTLSCachesOnCurrentThread();
+	}
+
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+	{
+		UsedMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+	}
+
+	virtual void InitializeStatsMetadata() override
+	{
+		UsedMalloc->InitializeStatsMetadata();
+	}
+
+	virtual void UpdateStats() override
+	{
+		UsedMalloc->UpdateStats();
+	}
+
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override;
+
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+	{
+		UsedMalloc->DumpAllocatorStats(Ar);
+	}
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return true;
+	}
+
+	virtual bool ValidateHeap() override
+	{
+		return UsedMalloc->ValidateHeap();
+	}
+
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return UsedMalloc->GetDescriptiveName();
+	}
+
+private:
+	struct FCallSite
+	{
+		uint32 Hash;
+		int32 NumFrames;
+		uint64 Frames[MaxCallStackDepth];
+	};
+
+	struct FLiveSample
+	{
+		FHeapSampleSiteKey Site;
+		int64 Weight;
+		int64 Count;
+	};
+
+	/** Number of counters in the pointer filter that lets unsampled frees skip the lock. Must be a power of two. */
+	static const uint32 PointerFilterSize = 1 << 14;
+
+	static uint32 GetPointerFilterIndex(const void* Ptr)
+	{
+		const UPTRINT Bits = UPTRINT(Ptr) >> 4;
+		return uint32(Bits ^ (Bits >> 14)) & (PointerFilterSize - 1);
+	}
+
+	/** Returns true if the allocation of Size bytes on the calling thread should be sampled. */
+	FORCEINLINE bool ShouldSample(SIZE_T Size);
+
+	/** Records Ptr as a sampled allocation. Captures the callstack of the caller. */
+	FORCENOINLINE void TrackSampledAlloc(void* Ptr, SIZE_T Size);
+
+	/** Forgets Ptr if it is a sampled allocation. */
+	FORCENOINLINE void TrackFree(void* Ptr);
+
+	/** Removes Ptr from the live samples without accounting for its free yet. Returns false if it isn't a sampled allocation. */
+	bool DetachSample(void* Ptr, FLiveSample& OutSample);
+
+	/** Accounts for the free of a detached sample. */
+	void RetireSample(void* Ptr, const FLiveSample& Sample);
+
+	/** Puts back a detached sample whose allocation turned out to be still alive. */
+	void RestoreSample(void* Ptr, const FLiveSample& Sample);
+
+	/** Returns the id of the callsite, adding it if it is new. Must be called with CriticalSection held. */
+	uint32 FindOrAddCallSite(const uint64* Frames, int32 NumFrames);
+
+	/** Malloc we're based on, aka using under the hood */
+	FMalloc* UsedMalloc;
+
+	/** Mean number of bytes between two samples, 0 when sampling is off. */
+	volatile uint32 SampleRate;
+
+	/** Incremented on every StartSampling() so threads pick up a new rate. */
+	volatile int32 SamplingEpoch;
+
+	/** Per bucket number of live samples, read without the lock on every free. */
+	volatile int32 PointerFilter[PointerFilterSize];
+
+	/** Guards everything below. */
+	FCriticalSection CriticalSection;
+
+	TArray<FCallSite> CallSites;
+	TMap<uint32, uint32> CallSiteHashToId;
+	TMap<void*, FLiveSample> LiveSamples;
+	TMap<FHeapSampleSiteKey, FHeapSampleSiteStats> SiteStats;
+
+	/** Number of samples taken, for overhead reporting. */
+	uint64 NumSamples;
+
+	/** Baseline for "HeapSampling Diff". */
+	FHeapSampleSnapshot BaselineSnapshot;
+};
+
+extern CORE_API FMallocSamplingProfiler* GMallocSamplingProfiler;
+
+#endif // USE_MALLOC_SAMPLING_PROFILER
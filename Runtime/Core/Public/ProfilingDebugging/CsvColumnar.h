@@ -0,0 +1,76 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/**
+* Binary columnar format written by the CSV profiler when csv.OutputFormat is 1.
+*
+* The file is a header followed by blocks. A frames block holds up to a few hundred rows, stored column by column.
+* Each column is delta encoded (ints) or XORed with the previous value (floats), then run-length encoded, so stats
+* that rarely change cost a few bytes per block. Blocks only reference earlier blocks for column names and can be
+* decoded one at a time.
+*/
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+
+enum class ECsvColumnType : uint8
+{
+	Int,
+	Float,
+};
+
+struct CORE_API FCsvColumnarCodec
+{
+	static const uint32 Magic = 0x42565343; // 'CSVB'
+	static const uint32 Version = 1;
+
+	enum class EBlockType : uint8
+	{
+		Frames = 1,
+		Metadata = 2,
+	};
+
+	/** Appends Num values (int32 or float bits) to Out. */
+	static void EncodeColumn(ECsvColumnType Type, const uint32* Values, int32 Num, TArray<uint8>& Out);
+
+	/** Decodes Num values from the data at Cursor, advancing it. Returns false if the data is malformed. */
+	static bool DecodeColumn(ECsvColumnType Type, const uint8*& Cursor, const uint8* End, int32 Num, uint32* OutValues);
+
+	static void WriteVarUInt(uint64 Value, TArray<uint8>& Out);
+	static bool ReadVarUInt(const uint8*& Cursor, const uint8* End, uint64& OutValue);
+	static void WriteString(const FString& Value, TArray<uint8>& Out);
+	static bool ReadString(const uint8*& Cursor, const uint8* End, FString& OutValue);
+};
+
+/** A fully decoded columnar CSV file, for tools and tests. */
+struct CORE_API FCsvColumnarFile
+{
+	struct FColumn
+	{
+		FString Name;
+		ECsvColumnType Type;
+
+		/** One value per row. Ints are stored as floats, which is what the text CSV files contain too. */
+		TArray<float> Values;
+	};
+
+	struct FEvent
+	{
+		int32 Row;
+		FString Text;
+	};
+
+	TArray<int64> Frames;
+	TArray<FColumn> Columns;
+	TArray<FEvent> Events;
+	TMap<FString, FString> Metadata;
+
+	/** Decodes the contents of a file. Returns false if it is not a columnar CSV file or is truncated. */
+	bool Load(const TArray<uint8>& Data);
+
+	/** Returns the column with this name, or nullptr. */
+	const FColumn* FindColumn(const FString& Name) const;
+};
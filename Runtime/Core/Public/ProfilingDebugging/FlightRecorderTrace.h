@@ -0,0 +1,39 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Trace/Config.h"
+
+#if UE_TRACE_ENABLED
+#define FLIGHTRECORDERTRACE_ENABLED 1
+#else
+#define FLIGHTRECORDERTRACE_ENABLED 0
+#endif
+
+#if FLIGHTRECORDERTRACE_ENABLED
+
+/**
+ * Keeps the last few seconds of trace data in memory and writes them to Saved/Profiling/FlightRecorder when the game
+ * thread hitches or the process crashes. Meant to be left on permanently, e.g. on servers.
+ *
+ * -traceflightrecorder[=Seconds]	Starts the flight recorder, 30 seconds by default.
+ * -traceflightrecordermb=Size		Memory for the recorder in MB, 64 by default, at most 1024.
+ * -tracecompressthreads=Count		Threads that help the trace writer compress data.
+ */
+struct FFlightRecorderTrace
+{
+	CORE_API static void Init(const TCHAR* CmdLine);
+
+	/** Writes the recorded data to a new file named after Reason. Waits up to WaitMs for the file to be written. */
+	CORE_API static bool Dump(const TCHAR* Reason, uint32 WaitMs = 0);
+};
+
+#define TRACE_FLIGHTRECORDER_INIT(CmdLine) \
+	FFlightRecorderTrace::Init(CmdLine);
+
+#else
+
+#define TRACE_FLIGHTRECORDER_INIT(CmdLine)
+
+#endif
@@ -41,4 +41,11 @@
 #define MALLOC_PROFILER(...)
 #endif
 
-
+/**
+ * USE_MALLOC_SAMPLING_PROFILER	- Define this to wrap GMalloc in FMallocSamplingProfiler, a low overhead sampling heap
+ *								  profiler that reports through TraceLog. It can be combined with the proxies above and
+ *								  stays idle until enabled with -heapsampling[=Rate] or "HeapSampling Start".
+ */
+#ifndef USE_MALLOC_SAMPLING_PROFILER
+#define USE_MALLOC_SAMPLING_PROFILER	0
+#endif
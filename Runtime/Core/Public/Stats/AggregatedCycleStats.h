@@ -0,0 +1,188 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/CriticalSection.h"
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "UObject/NameTypes.h"
+
+/**
+ * USE_AGGREGATED_CYCLE_STATS - Define this to keep SCOPE_CYCLE_COUNTER and friends alive in builds without STATS.
+ * Instead of sending messages to the stats thread, every thread adds the cycles of a scope to its own accumulator
+ * for that stat, and the game thread sums the accumulators once per frame. Only inclusive time and call counts per
+ * stat are kept, there is no hierarchy, which makes it cheap enough to leave on in shipping servers.
+ * Has no effect when STATS or ENABLE_STATNAMEDEVENTS is set.
+ */
+#ifndef USE_AGGREGATED_CYCLE_STATS
+	#define USE_AGGREGATED_CYCLE_STATS 0
+#endif
+
+#if USE_AGGREGATED_CYCLE_STATS
+
+class FOutputDevice;
+
+/** Set by stats.Aggregated.Enable, scopes record nothing while false. */
+extern CORE_API bool GAggregatedCycleStatsEnabled;
+
+/**
+ * Identifies one aggregated cycle stat. Declared as a function local static by the cycle counter macros; the
+ * constructor is constexpr so there is no static initialization guard, the index is assigned on first use.
+ * Several instances with the same name share one index.
+ */
+struct FAggregatedCycleStat
+{
+	const TCHAR* Name;
+	int32 Index;
+
+	constexpr FAggregatedCycleStat(const TCHAR* InName)
+		: Name(InName)
+		, Index(INDEX_NONE)
+	{
+	}
+
+	FORCEINLINE int32 GetIndex()
+	{
+		const int32 Result = Index;
+		return LIKELY(Result != INDEX_NONE) ? Result : Register();
+	}
+
+	CORE_API int32 Register();
+};
+
+/** Cumulative values of one stat on one thread. Only written by the owning thread. */
+struct FAggregatedCycleStatSlot
+{
+	uint64 Cycles;
+	uint64 Calls;
+};
+
+/** Per frame values of one stat, summed over all threads. */
+struct FAggregatedCycleStatFrameValue
+{
+	const TCHAR* Name = nullptr;
+	double LastMs = 0.0;
+	double AverageMs = 0.0;
+	double MaxMs = 0.0;
+	uint64 LastCalls = 0;
+};
+
+/**
+ * Registry and per-thread storage of aggregated cycle stats.
+ *
+ * Each thread owns a cache line aligned block of pages of FAggregatedCycleStatSlot, so recording a scope is an
+ * uncontended add to memory no other thread writes. AdvanceFrame() walks the blocks of all threads and turns the
+ * difference to the previous frame's sums into per frame values; the accumulators are never reset, so the reader
+ * does not need to synchronize with the writers.
+ */
+class CORE_API FAggregatedCycleStats
+{
+public:
+	static const int32 SlotsPerPage = 256;
+	static const int32 MaxPages = 64;
+	static const int32 MaxStats = SlotsPerPage * MaxPages;
+
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FThreadBlock
+	{
+		FAggregatedCycleStatSlot* volatile Pages[MaxPages];
+		FThreadBlock* Next;
+		uint32 ThreadId;
+	};
+
+	static FAggregatedCycleStats& Get();
+
+	/** Adds the cycles of one scope to the calling thread's accumulator for the stat. */
+	static FORCEINLINE void Accumulate(int32 StatIndex, uint64 Cycles)
+	{
+		FThreadBlock* Block = (FThreadBlock*)FPlatformTLS::GetTlsValue(TlsSlot);
+		if (UNLIKELY(Block == nullptr))
+		{
+			Block = Get().CreateThreadBlock();
+		}
+
+		FAggregatedCycleStatSlot* Page = Block->Pages[StatIndex / SlotsPerPage];
+		if (UNLIKELY(Page == nullptr))
+		{
+			Page = CreatePage(*Block, StatIndex / SlotsPerPage);
+		}
+
+		FAggregatedCycleStatSlot& Slot = Page[StatIndex % SlotsPerPage];
+		Slot.Cycles += Cycles;
+		++Slot.Calls;
+	}
+
+	/** Returns the index of the stat with this name, registering it if needed. */
+	int32 FindOrAddStat(const TCHAR* Name);
+
+	/** Sums all threads and updates the per frame values. Called from FStats::AdvanceFrame on the game thread. */
+	void AdvanceFrame();
+
+	/** Copies the per frame values of all stats that were hit recently. */
+	void GetFrameValues(TArray<FAggregatedCycleStatFrameValue>& OutValues) const;
+
+	/** Logs the most expensive stats, optionally only those whose name contains Filter. */
+	void Dump(FOutputDevice& Ar, const TCHAR* Filter, int32 MaxStatsToDump) const;
+
+private:
+	FAggregatedCycleStats();
+
+	FThreadBlock* CreateThreadBlock();
+	static FAggregatedCycleStatSlot* CreatePage(FThreadBlock& Block, int32 PageIndex);
+
+	struct FStatInfo
+	{
+		const TCHAR* Name;
+		FName CsvName;
+		uint64 PreviousCycles;
+		uint64 PreviousCalls;
+		FAggregatedCycleStatFrameValue Frame;
+		double WindowMaxMs;
+	};
+
+	/** TLS slot holding the calling thread's FThreadBlock. */
+	static uint32 TlsSlot;
+
+	/** Head of the list of all thread blocks, only ever pushed to. */
+	FThreadBlock* volatile ThreadBlocks;
+
+	/** Guards Stats and NameToIndex. */
+	mutable FCriticalSection CriticalSection;
+	TArray<FStatInfo> Stats;
+	TMap<FString, int32> NameToIndex;
+
+	/** Number of frames the current max window has been running for. */
+	int32 WindowFrames;
+};
+
+/** Times a scope into an aggregated cycle stat. */
+class FAggregatedCycleScope
+{
+public:
+	FORCEINLINE FAggregatedCycleScope(FAggregatedCycleStat* InStat, bool bCondition = true)
+		: Stat(bCondition && GAggregatedCycleStatsEnabled ? InStat : nullptr)
+		, StartCycles(0)
+	{
+		if (Stat)
+		{
+			StartCycles = FPlatformTime::Cycles64();
+		}
+	}
+
+	FORCEINLINE ~FAggregatedCycleScope()
+	{
+		if (Stat)
+		{
+			FAggregatedCycleStats::Accumulate(Stat->GetIndex(), FPlatformTime::Cycles64() - StartCycles);
+		}
+	}
+
+private:
+	FAggregatedCycleStat* Stat;
+	uint64 StartCycles;
+};
+
+#endif // USE_AGGREGATED_CYCLE_STATS
@@ -11,6 +11,7 @@
 #include "StatsCommon.h"
 #include "ProfilingDebugging/UMemoryDefines.h"
 #include "Stats/Stats2.h"
+#include "Stats/AggregatedCycleStats.h"
 
 /** 
  *	Learn about the Stats System at docs.unrealengine.com
@@ -173,6 +174,40 @@ private:
 	bool bPop;
 };
 
+#elif USE_AGGREGATED_CYCLE_STATS
+
+struct TStatId
+{
+	FAggregatedCycleStat* Stat;
+
+	FORCEINLINE TStatId()
+	: Stat(nullptr)
+	{
+	}
+
+	FORCEINLINE TStatId(FAggregatedCycleStat* InStat)
+	: Stat(InStat)
+	{
+	}
+
+	FORCEINLINE bool IsValidStat() const
+	{
+		return Stat != nullptr;
+	}
+};
+
+class FScopeCycleCounter
+{
+public:
+	FORCEINLINE FScopeCycleCounter(TStatId InStatId, bool bAlways = false)
+		: Scope(InStatId.Stat, InStatId.IsValidStat())
+	{
+	}
+
+private:
+	FAggregatedCycleScope Scope;
+};
+
 #else	//ENABLE_STATNAMEDEVENTS
 struct TStatId {};
 
@@ -220,6 +255,31 @@ FORCEINLINE void StatsMasterEnableSubtract(int32 Value = 1)
 #define GET_STATID(Stat) (TStatId(ANSI_TO_PROFILING(#Stat)))
 
 
+#elif USE_AGGREGATED_CYCLE_STATS
+
+#define DECLARE_SCOPE_CYCLE_COUNTER(CounterName,Stat,GroupId) \
+	static FAggregatedCycleStat AggregatedCycleStat_##Stat(TEXT(#Stat)); \
+	FAggregatedCycleScope AggregatedCycleScope_##Stat(&AggregatedCycleStat_##Stat);
+
+#define QUICK_SCOPE_CYCLE_COUNTER(Stat) \
+	static FAggregatedCycleStat AggregatedCycleStat_##Stat(TEXT(#Stat)); \
+	FAggregatedCycleScope AggregatedCycleScope_##Stat(&AggregatedCycleStat_##Stat);
+
+#define SCOPE_CYCLE_COUNTER(Stat) \
+	static FAggregatedCycleStat AggregatedCycleStat_##Stat(TEXT(#Stat)); \
+	FAggregatedCycleScope AggregatedCycleScope_##Stat(&AggregatedCycleStat_##Stat);
+
+#define CONDITIONAL_SCOPE_CYCLE_COUNTER(Stat,bCondition) \
+	static FAggregatedCycleStat AggregatedCycleStat_##Stat(TEXT(#Stat)); \
+	FAggregatedCycleScope AggregatedCycleScope_##Stat(&AggregatedCycleStat_##Stat, bCondition);
+
+#define RETURN_QUICK_DECLARE_CYCLE_STAT(StatId,GroupId) \
+	static FAggregatedCycleStat AggregatedCycleStat_##StatId(TEXT(#StatId)); \
+	return TStatId(&AggregatedCycleStat_##StatId);
+
+#define GET_STATID(Stat) \
+	([]() -> TStatId { static FAggregatedCycleStat AggregatedCycleStat_##Stat(TEXT(#Stat)); return TStatId(&AggregatedCycleStat_##Stat); }())
+
 #elif USE_LIGHTWEIGHT_STATS_FOR_HITCH_DETECTION && USE_HITCH_DETECTION
 extern CORE_API bool GHitchDetected;
 
@@ -271,7 +331,11 @@ public:
 #define SCOPE_SECONDS_ACCUMULATOR(Stat)
 #define SCOPE_MS_ACCUMULATOR(Stat)
 #define DEFINE_STAT(Stat)
+#if USE_AGGREGATED_CYCLE_STATS && !ENABLE_STATNAMEDEVENTS
+#define QUICK_USE_CYCLE_STAT(StatId,GroupId) GET_STATID(StatId)
+#else
 #define QUICK_USE_CYCLE_STAT(StatId,GroupId) TStatId()
+#endif
 #define DECLARE_CYCLE_STAT(CounterName,StatId,GroupId)
 #define DECLARE_FLOAT_COUNTER_STAT(CounterName,StatId,GroupId)
 #define DECLARE_DWORD_COUNTER_STAT(CounterName,StatId,GroupId)
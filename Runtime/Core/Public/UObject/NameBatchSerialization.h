@@ -22,4 +22,13 @@ CORE_API void ReserveNameBatch(uint32 NameDataBytes, uint32 HashDataBytes);
 // Names are rehased if hash algorithm version doesn't match.
 //
 // @param NameData, HashData must be 8-byte aligned.
-CORE_API void LoadNameBatch(TArray<FNameEntryId>& OutNames, TArrayView<const uint8> NameData, TArrayView<const uint8> HashData);
\ No newline at end of file
+CORE_API void LoadNameBatch(TArray<FNameEntryId>& OutNames, TArrayView<const uint8> NameData, TArrayView<const uint8> HashData);
+
+// Find or add plain names in bulk, e.g. when loading a name table that isn't in the batch format.
+//
+// Same as FName(Str, FNAME_Add) for each string except that no number suffix is split off.
+// Names that already exist are found without locking and the rest are added with one lock per shard.
+//
+// @param OutNames receives one display entry id per string, see FName::CreateFromDisplayId().
+CORE_API void CreateNameBatch(TArray<FNameEntryId>& OutNames, TArrayView<const FAnsiStringView> Strings);
+CORE_API void CreateNameBatch(TArray<FNameEntryId>& OutNames, TArrayView<const FStringView> Strings);
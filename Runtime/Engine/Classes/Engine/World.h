@@ -1970,6 +1970,44 @@ public:
 	bool ComponentOverlapMultiByChannel(TArray<struct FOverlapResult>& OutOverlaps, const class UPrimitiveComponent* PrimComp, const FVector& Pos, const FQuat& Rot,    ECollisionChannel TraceChannel, const FComponentQueryParams& Params = FComponentQueryParams::DefaultComponentQueryParams, const FCollisionObjectQueryParams& ObjectQueryParams=FCollisionObjectQueryParams::DefaultObjectQueryParam) const;
 	bool ComponentOverlapMultiByChannel(TArray<struct FOverlapResult>& OutOverlaps, const class UPrimitiveComponent* PrimComp, const FVector& Pos, const FRotator& Rot, ECollisionChannel TraceChannel, const FComponentQueryParams& Params = FComponentQueryParams::DefaultComponentQueryParams, const FCollisionObjectQueryParams& ObjectQueryParams=FCollisionObjectQueryParams::DefaultObjectQueryParam) const;
 
+	// BATCHED QUERIES
+
+	/**
+	 *  Trace a batch of rays sharing the same channel and parameters against the world. Faster than tracing the rays one at a time,
+	 *  the filter data is built once and the rays are traced in spatially coherent order on task threads.
+	 *  The call is synchronous: it blocks until all rays were traced, OutHits is complete on return. Use AsyncLineTraceByChannel
+	 *  to get results in a later frame instead.
+	 *  @param  TraceType       Test or Single, multi traces aren't supported
+	 *  @param  OutHits         One result per ray, in the order of Starts. bBlockingHit is set for rays that found a blocking hit
+	 *  @param  Starts          Start locations of the rays
+	 *  @param  Ends            End locations of the rays, same number as Starts
+	 *  @param  TraceChannel    The 'channel' that the rays are in, used to determine which components to hit
+	 *  @param  Params          Additional parameters used for the traces
+	 * 	@param 	ResponseParam	ResponseContainer to be used for the traces
+	 */
+	void LineTraceBatchByChannel(EAsyncTraceType TraceType, TArray<struct FHitResult>& OutHits, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam) const;
+
+	/**
+	 *  Sweep a shape against the world for a batch of sweeps sharing the same shape, channel and parameters, see LineTraceBatchByChannel.
+	 *  Synchronous, blocks until all sweeps completed.
+	 *  @param  Rot             Rotation of the shape during the sweeps
+	 *  @param  CollisionShape  CollisionShape - supports Box, Sphere, Capsule
+	 */
+	void SweepBatchByChannel(EAsyncTraceType TraceType, TArray<struct FHitResult>& OutHits, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam) const;
+
+	/**
+	 *  Test a shape against the world at a batch of positions sharing the same shape, channel and parameters.
+	 *  Synchronous, blocks until all positions were tested.
+	 *  @param  OutBlocking     Whether a blocking overlap was found, per position
+	 *  @param  Positions       Locations of the shape
+	 *  @param  Rot             Rotation of the shape
+	 *  @param  TraceChannel    The 'channel' that the queries are in, used to determine which components to hit
+	 *  @param  CollisionShape  CollisionShape - supports Box, Sphere, Capsule
+	 *  @param  Params          Additional parameters used for the queries
+	 *  @param  ResponseParam   ResponseContainer to be used for the queries
+	 */
+	void OverlapBlockingTestBatchByChannel(TArray<bool>& OutBlocking, TArrayView<const FVector> Positions, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam, const FCollisionResponseParams& ResponseParam = FCollisionResponseParams::DefaultResponseParam) const;
+
 
 	/**
 	 * Interface for Async. Pretty much same parameter set except you can optional set delegate to be called when execution is completed and you can set UserData if you'd like
@@ -0,0 +1,79 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "CharacterMovementBatchSubsystem.generated.h"
+
+class AController;
+class UPawnMovementComponent;
+class UCharacterMovementComponent;
+class UCharacterMovementBatchSubsystem;
+
+struct FCharacterMovementBatchTickFunction : public FTickFunction
+{
+	FCharacterMovementBatchTickFunction() : FCharacterMovementBatchTickFunction(nullptr) {}
+	FCharacterMovementBatchTickFunction(UCharacterMovementBatchSubsystem* InSubsystem) : Subsystem(InSubsystem) {}
+	virtual ~FCharacterMovementBatchTickFunction() {}
+
+	// Begin FTickFunction overrides
+	virtual void ExecuteTick(float DeltaTime, enum ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	virtual FName DiagnosticContext(bool bDetailed) override;
+	// End FTickFunction overrides
+
+	UCharacterMovementBatchSubsystem* Subsystem;
+};
+
+/**
+ * Steps floor checks of characters using batched movement (@see UCharacterMovementComponent::bUseBatchedMovement) together.
+ * Ticks after the controllers of their characters and before their movement components, predicts where each walking character
+ * will end up after its next move and finds the floor at all predicted locations at once on worker threads.
+ * Movement components then use these results instead of sweeping for the floor themselves, when the floor is on a component that can't move
+ * and no movable component is in the way of the floor sweep.
+ *
+ * Only the floor check following the first walking step is batched. Movement sweeps stay on game thread with their owner's tick,
+ * as they move components and trigger hit and overlap events. Floor checks don't go through the batched scene query API
+ * (@see UWorld::SweepBatchByChannel): each one ignores its own character and may follow its sweep with a narrower sweep and a line trace,
+ * so they are spread over worker threads with ParallelFor instead, one ComputeFloorDist per character.
+ */
+UCLASS()
+class ENGINE_API UCharacterMovementBatchSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UCharacterMovementBatchSubsystem();
+
+	// Begin USubsystem
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End USubsystem
+
+	/** Adds movement component to the batch, its tick will wait for the batch tick */
+	void RegisterComponent(UCharacterMovementComponent* MovementComponent);
+	void UnregisterComponent(UCharacterMovementComponent* MovementComponent);
+
+	/** Makes the batch tick wait for the controller and its components (e.g. path following) when they drive a batched movement component */
+	void AddControllerTickDependency(AController* Controller, UPawnMovementComponent* MovementComponent);
+	void RemoveControllerTickDependency(AController* Controller);
+
+	int32 GetNumRegisteredComponents() const { return MovementComponents.Num(); }
+
+	/** Number of floor checks computed by the last batch tick */
+	int32 GetNumBatchedFloors() const { return BatchedComponents.Num(); }
+
+private:
+	void Tick(float DeltaTime);
+
+	friend struct FCharacterMovementBatchTickFunction;
+	FCharacterMovementBatchTickFunction TickFunction;
+
+	TArray<UCharacterMovementComponent*> MovementComponents;
+
+	/** Components with floor checks computed in current batch, kept around to avoid reallocating every frame */
+	TArray<UCharacterMovementComponent*> BatchedComponents;
+};
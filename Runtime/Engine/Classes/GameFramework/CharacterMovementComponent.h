@@ -1024,6 +1024,15 @@ public:
 	UPROPERTY(Category = "RootMotion", EditAnywhere, BlueprintReadWrite)
 	uint8 bAllowPhysicsRotationDuringAnimRootMotion : 1;
 
+	/**
+	 * If true, floor checks are stepped together with other characters using batched movement while walking with authority and not controlled by a player.
+	 * Floor at the location the character is predicted to move to is found on worker threads before it ticks, and movement uses it when the character ends up there.
+	 * Overrides of FloorSweepTest, IsWalkable and InitCollisionParams need to be thread safe. Read when tick functions are registered.
+	 * @see UCharacterMovementBatchSubsystem
+	 */
+	UPROPERTY(Category="Character Movement (General Settings)", EditDefaultsOnly, AdvancedDisplay)
+	uint8 bUseBatchedMovement:1;
+
 protected:
 
 	// AI PATH FOLLOWING
@@ -1782,6 +1791,24 @@ public:
 	/** Tick function called after physics (sync scene) has finished simulation, before cloth */
 	virtual void PostPhysicsTickComponent(float DeltaTime, FCharacterMovementComponentPostPhysicsTickFunction& ThisTickFunction);
 
+	friend class UCharacterMovementBatchSubsystem;
+
+	/** Called by batch on game thread, predicts location of the floor check following the next move. Returns false if floor can't be batched this frame */
+	bool PrepareBatchedFloorCheck(float DeltaTime);
+
+	/** Called by batch, possibly on a worker thread. Finds the floor at location predicted by PrepareBatchedFloorCheck */
+	void ComputeBatchedFloorCheck();
+
+	/** Uses floor found by the batch this frame, if it was checked close enough to CapsuleLocation with the same distance and was found on a component that can't move and didn't, with no movable component in the swept region. Each batched floor is used only once */
+	bool ConsumeBatchedFloor(const FVector& CapsuleLocation, float SweepDistance, FFindFloorResult& OutFloorResult);
+
+	/** Floor found by the batch at BatchedFloorLocation, valid only during frame BatchedFloorFrame */
+	FFindFloorResult BatchedFloor;
+	FTransform BatchedFloorComponentTransform;
+	FVector BatchedFloorLocation;
+	float BatchedFloorSweepDistance;
+	uint64 BatchedFloorFrame;
+
 protected:
 	/** @note Movement update functions should only be called through StartNewPhysics()*/
 	virtual void PhysWalking(float deltaTime, int32 Iterations);
@@ -355,7 +355,19 @@ void AActor::GatherCurrentMovement()
 			// Don't replicate movement if we're welded to another parent actor.
 			// Their replication will affect our position indirectly since we are attached.
 			ReplicatedMovement.bRepPhysics = !RootPrimComp->IsWelded();
-			
+
+			// Keep recent poses of replicated bodies around for lag compensated hit checks
+			if (ReplicatedMovement.bRepPhysics)
+			{
+				if (FPhysScene* PhysScene = GetWorld()->GetPhysicsScene())
+				{
+					if (FPhysicsReplication* PhysicsReplication = PhysScene->GetPhysicsReplication())
+					{
+						PhysicsReplication->AddRewindHistory(RootPrimComp);
+					}
+				}
+			}
+
 			// Technically, the values might have stayed the same, but we'll just assume they've changed.
 			bWasRepMovementModified = true;
 		}
@@ -13,6 +13,8 @@
 #include "Collision/CollisionConversions.h"
 #include "PhysicsEngine/ScopedSQHitchRepeater.h"
 #include "PhysicsInterfaceDeclaresCore.h"
+#include "Async/ParallelFor.h"
+#include "Misc/App.h"
 
 #if PHYSICS_INTERFACE_PHYSX
 #include "PhysXInterfaceWrapper.h"
@@ -662,4 +664,282 @@ bool FGenericPhysicsInterface::GeomOverlapMulti(const UWorld* World, const FColl
 	FTransform GeomTransform(InRotation, InPosition);
 	FPhysicsShapeAdapter Adaptor(GeomTransform.GetRotation(), InGeom);
 	return GeomOverlapMultiImp<EQueryInfo::GatherAll>(World, Adaptor.GetGeometry(), InGeom, Adaptor.GetGeomPose(GeomTransform.GetTranslation()), OutOverlaps, TraceChannel, Params, ResponseParams, ObjectParams);
-}
\ No newline at end of file
+}
+
+//////////////////////////////////////////////////////////////////////////
+// BATCHED QUERIES
+
+static int32 GSceneQueryBatchSize = 32;
+static FAutoConsoleVariableRef CVarSceneQueryBatchSize(
+	TEXT("p.SceneQueryBatchSize"),
+	GSceneQueryBatchSize,
+	TEXT("Number of queries of a batched scene query run by one task, scene locks and filter callbacks are shared by the queries of a task. 0 runs the whole batch on the calling thread."),
+	ECVF_Default);
+
+static int32 GSceneQueryBatchCoherentOrder = 1;
+static FAutoConsoleVariableRef CVarSceneQueryBatchCoherentOrder(
+	TEXT("p.SceneQueryBatchCoherentOrder"),
+	GSceneQueryBatchCoherentOrder,
+	TEXT("Whether the queries of a batched scene query run in Morton order of their start locations, so consecutive queries traverse the same nodes of the acceleration structure."),
+	ECVF_Default);
+
+/** Returns the order to run the queries of a batch in, queries starting close to each other run one after the other. */
+static void GetCoherentQueryOrder(TArrayView<const FVector> Starts, TArray<int32>& OutOrder)
+{
+	const int32 NumQueries = Starts.Num();
+
+	OutOrder.SetNumUninitialized(NumQueries);
+	for (int32 QueryIndex = 0; QueryIndex < NumQueries; QueryIndex++)
+	{
+		OutOrder[QueryIndex] = QueryIndex;
+	}
+
+	if (!GSceneQueryBatchCoherentOrder || NumQueries < 2)
+	{
+		return;
+	}
+
+	// Quantize the start locations to 10 bits per axis in the bounds of the batch
+	const FBox Bounds(Starts.GetData(), NumQueries);
+	const FVector Scale = FVector(1023.f) / Bounds.GetSize().ComponentMax(FVector(KINDA_SMALL_NUMBER));
+
+	TArray<uint32> MortonCodes;
+	MortonCodes.SetNumUninitialized(NumQueries);
+	for (int32 QueryIndex = 0; QueryIndex < NumQueries; QueryIndex++)
+	{
+		const FVector Cell = (Starts[QueryIndex] - Bounds.Min) * Scale;
+		MortonCodes[QueryIndex] = FMath::MortonCode3((uint32)Cell.X) | (FMath::MortonCode3((uint32)Cell.Y) << 1) | (FMath::MortonCode3((uint32)Cell.Z) << 2);
+	}
+
+	OutOrder.Sort([&MortonCodes](int32 A, int32 B)
+	{
+		return MortonCodes[A] < MortonCodes[B];
+	});
+}
+
+/** Splits the queries of a batch, in coherent order, between tasks. TaskFunc(QueryIndices) runs once per task, on task threads. */
+template <typename TaskFuncType>
+static void ParallelForBatchedQueries(TArrayView<const FVector> Starts, const TaskFuncType& TaskFunc)
+{
+	TArray<int32> QueryOrder;
+	GetCoherentQueryOrder(Starts, QueryOrder);
+
+	const int32 NumQueries = QueryOrder.Num();
+	const int32 BatchSize = GSceneQueryBatchSize > 0 ? GSceneQueryBatchSize : NumQueries;
+	const int32 NumTasks = FMath::DivideAndRoundUp(NumQueries, BatchSize);
+
+	ParallelFor(NumTasks, [&](int32 TaskIndex)
+	{
+		const int32 FirstOrderIndex = TaskIndex * BatchSize;
+		TaskFunc(TArrayView<const int32>(QueryOrder.GetData() + FirstOrderIndex, FMath::Min(BatchSize, NumQueries - FirstOrderIndex)));
+	}, GSceneQueryBatchSize <= 0 || !FApp::ShouldUseThreadingForPerformance());
+}
+
+template <typename Traits, typename TGeomInputs>
+void TSceneCastBatchCommon(const UWorld* World, TArray<FHitResult>& OutHits, const TGeomInputs& GeomInputs, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, ECollisionChannel TraceChannel, const struct FCollisionQueryParams& Params, const struct FCollisionResponseParams& ResponseParams, const struct FCollisionObjectQueryParams& ObjectParams)
+{
+	static_assert(!Traits::IsMulti(), "Batched scene queries return one result per query");
+	check(Starts.Num() == Ends.Num());
+
+	FScopeCycleCounter Counter(Params.StatId);
+	STARTQUERYTIMER();
+
+	const int32 NumQueries = Starts.Num();
+
+	OutHits.Reset(NumQueries);
+	for (int32 QueryIndex = 0; QueryIndex < NumQueries; QueryIndex++)
+	{
+		Traits::ResetOutHits(OutHits.AddDefaulted_GetRef(), Starts[QueryIndex], Ends[QueryIndex]);
+	}
+
+	if ((World == NULL) || (World->GetPhysicsScene() == NULL) || NumQueries == 0)
+	{
+		return;
+	}
+
+	// Filter data is created once for the whole batch
+	const FCollisionFilterData Filter = CreateQueryFilterData(TraceChannel, Params.bTraceComplex, ResponseParams.CollisionResponse, Params, ObjectParams, false);
+
+	FPhysScene& PhysScene = *World->GetPhysicsScene();
+
+	ParallelForBatchedQueries(Starts, [&](TArrayView<const int32> QueryIndices)
+	{
+		// The filter callback and scene locks are shared by the queries of a task
+		CA_SUPPRESS(6326);
+		FCollisionQueryFilterCallback QueryCallback(Params, Traits::GeometryQuery == ESweepOrRay::Sweep);
+		QueryCallback.bIgnoreTouches = true;
+
+		FScopeHelper ChaosLockedScope;
+		FScopedSceneReadLock SceneLocks(PhysScene);
+
+		for (int32 QueryIndex : QueryIndices)
+		{
+			const FVector Start = Starts[QueryIndex];
+			const FVector End = Ends[QueryIndex];
+
+			const FVector Delta = End - Start;
+			const float DeltaSize = Delta.Size();
+			const float DeltaMag = FMath::IsNearlyZero(DeltaSize) ? 0.f : DeltaSize;
+			if (!Traits::IsSweep() && DeltaMag <= 0.f)
+			{
+				continue;
+			}
+
+			typename Traits::THitBuffer HitBufferSync;
+
+			const FVector Dir = DeltaMag > 0.f ? (Delta / DeltaMag) : FVector(1, 0, 0);
+			const FTransform StartTM = Traits::IsRay() ? FTransform(Start) : FTransform(*GeomInputs.GetGeometryOrientation(), Start);
+
+			{
+				FScopedSQHitchRepeater<decltype(HitBufferSync)> HitchRepeater(HitBufferSync, QueryCallback, FHitchDetectionInfo(Start, End, TraceChannel, Params));
+				do
+				{
+					Traits::SceneTrace(PhysScene, GeomInputs, Dir, DeltaMag, StartTM, HitchRepeater.GetBuffer(), Traits::GetHitFlags(), Traits::GetQueryFlags(), Filter, Params, &QueryCallback);
+				} while (HitchRepeater.RepeatOnHitch());
+			}
+
+			const int32 NumHits = Traits::GetNumHits(HitBufferSync);
+			if (NumHits > 0 && GetHasBlock(HitBufferSync))
+			{
+				FHitResult& OutHit = OutHits[QueryIndex];
+
+				if (Traits::IsTest())
+				{
+					OutHit.bBlockingHit = true;
+				}
+				else
+				{
+					bool bBlockingHit = true;
+					const float MinBlockingDistance = GetDistance(Traits::GetHits(HitBufferSync)[NumHits - 1]);
+					if (ConvertTraceResults(bBlockingHit, World, NumHits, Traits::GetHits(HitBufferSync), DeltaMag, Filter, OutHit, Start, End, *GeomInputs.GetGeometry(), StartTM, MinBlockingDistance, Params.bReturnFaceIndex, Params.bReturnPhysicalMaterial) != EConvertQueryResult::Valid)
+					{
+						UE_LOG(LogCollision, Error, TEXT("%sBatch resulted in a NaN/INF in PHit!"), Traits::IsRay() ? TEXT("Raycast") : TEXT("Sweep"));
+					}
+				}
+			}
+		}
+	});
+
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+	if (World->DebugDrawSceneQueries(Params.TraceTag))
+	{
+		for (int32 QueryIndex = 0; QueryIndex < NumQueries; QueryIndex++)
+		{
+			Traits::DrawTraces(World, Starts[QueryIndex], Ends[QueryIndex], GeomInputs.GetGeometry(), GeomInputs.GetGeometryOrientation(), OutHits[QueryIndex]);
+		}
+	}
+#endif //!(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+
+#if ENABLE_COLLISION_ANALYZER
+	for (int32 QueryIndex = 0; QueryIndex < NumQueries; QueryIndex++)
+	{
+		Traits::CaptureTraces(World, Starts[QueryIndex], Ends[QueryIndex], GeomInputs, TraceChannel, Params, ResponseParams, ObjectParams, OutHits[QueryIndex], OutHits[QueryIndex].bBlockingHit, StartTime);
+	}
+#endif
+}
+
+void FGenericPhysicsInterface::RaycastBatch(const UWorld* World, EAsyncTraceType TraceType, TArray<struct FHitResult>& OutHits, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, ECollisionChannel TraceChannel, const struct FCollisionQueryParams& Params, const struct FCollisionResponseParams& ResponseParams, const struct FCollisionObjectQueryParams& ObjectParams)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Collision_SceneQueryTotal);
+	SCOPE_CYCLE_COUNTER(STAT_Collision_RaycastBatch);
+	CSV_SCOPED_TIMING_STAT(SceneQuery, RaycastBatch);
+
+	ensureMsgf(TraceType != EAsyncTraceType::Multi, TEXT("RaycastBatch doesn't support multi traces, running single traces instead"));
+
+	if (TraceType == EAsyncTraceType::Test)
+	{
+		using TCastTraits = TSQTraits<FHitRaycast, ESweepOrRay::Raycast, ESingleMultiOrTest::Test>;
+		TSceneCastBatchCommon<TCastTraits>(World, OutHits, FRaycastSQAdditionalInputs(), Starts, Ends, TraceChannel, Params, ResponseParams, ObjectParams);
+	}
+	else
+	{
+		using TCastTraits = TSQTraits<FHitRaycast, ESweepOrRay::Raycast, ESingleMultiOrTest::Single>;
+		TSceneCastBatchCommon<TCastTraits>(World, OutHits, FRaycastSQAdditionalInputs(), Starts, Ends, TraceChannel, Params, ResponseParams, ObjectParams);
+	}
+}
+
+void FGenericPhysicsInterface::GeomSweepBatch(const UWorld* World, EAsyncTraceType TraceType, const struct FCollisionShape& CollisionShape, const FQuat& Rot, TArray<struct FHitResult>& OutHits, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, ECollisionChannel TraceChannel, const struct FCollisionQueryParams& Params, const struct FCollisionResponseParams& ResponseParams, const struct FCollisionObjectQueryParams& ObjectParams)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Collision_SceneQueryTotal);
+	SCOPE_CYCLE_COUNTER(STAT_Collision_GeomSweepBatch);
+	CSV_SCOPED_TIMING_STAT(SceneQuery, GeomSweepBatch);
+
+	ensureMsgf(TraceType != EAsyncTraceType::Multi, TEXT("GeomSweepBatch doesn't support multi traces, running single traces instead"));
+
+	// The query geometry is created once for the whole batch
+	const FGeomSQAdditionalInputs GeomInputs(CollisionShape, Rot);
+
+	if (TraceType == EAsyncTraceType::Test)
+	{
+		using TCastTraits = TSQTraits<FHitSweep, ESweepOrRay::Sweep, ESingleMultiOrTest::Test>;
+		TSceneCastBatchCommon<TCastTraits>(World, OutHits, GeomInputs, Starts, Ends, TraceChannel, Params, ResponseParams, ObjectParams);
+	}
+	else
+	{
+		using TCastTraits = TSQTraits<FHitSweep, ESweepOrRay::Sweep, ESingleMultiOrTest::Single>;
+		TSceneCastBatchCommon<TCastTraits>(World, OutHits, GeomInputs, Starts, Ends, TraceChannel, Params, ResponseParams, ObjectParams);
+	}
+}
+
+void FGenericPhysicsInterface::GeomOverlapBlockingTestBatch(const UWorld* World, const struct FCollisionShape& CollisionShape, const FQuat& Rot, TArray<bool>& OutBlocking, TArrayView<const FVector> Positions, ECollisionChannel TraceChannel, const struct FCollisionQueryParams& Params, const struct FCollisionResponseParams& ResponseParams, const struct FCollisionObjectQueryParams& ObjectParams)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Collision_SceneQueryTotal);
+	SCOPE_CYCLE_COUNTER(STAT_Collision_GeomOverlapBlockingBatch);
+	CSV_SCOPED_TIMING_STAT(SceneQuery, GeomOverlapBlockingBatch);
+
+	FScopeCycleCounter Counter(Params.StatId);
+
+	OutBlocking.Reset(Positions.Num());
+	OutBlocking.AddZeroed(Positions.Num());
+
+	if ((World == NULL) || (World->GetPhysicsScene() == NULL) || Positions.Num() == 0)
+	{
+		return;
+	}
+
+	// The query geometry is created once for the whole batch
+	const FPhysicsShapeAdapter Adaptor(Rot, CollisionShape);
+	const FPhysicsGeometry& Geom = Adaptor.GetGeometry();
+
+	// overlapMultiple only supports sphere/capsule/box/convex
+	const ECollisionShapeType GeomType = GetType(Geom);
+	if (GeomType != ECollisionShapeType::Sphere && GeomType != ECollisionShapeType::Capsule && GeomType != ECollisionShapeType::Box && GeomType != ECollisionShapeType::Convex)
+	{
+		UE_LOG(LogCollision, Log, TEXT("GeomOverlapBlockingTestBatch : unsupported shape - only supports sphere, capsule, box, convex"));
+		return;
+	}
+
+	// Filter data is created once for the whole batch
+	const FCollisionFilterData Filter = CreateQueryFilterData(TraceChannel, Params.bTraceComplex, ResponseParams.CollisionResponse, Params, ObjectParams, true);
+	const EQueryFlags QueryFlags = EQueryFlags::PreFilter | EQueryFlags::AnyHit;
+	const FQueryFilterData QueryFilterData = MakeQueryFilterData(Filter, QueryFlags, Params);
+
+	FPhysScene& PhysScene = *World->GetPhysicsScene();
+
+	ParallelForBatchedQueries(Positions, [&](TArrayView<const int32> QueryIndices)
+	{
+		// The filter callback and scene locks are shared by the queries of a task
+		FCollisionQueryFilterCallback QueryCallback(Params, false);
+		QueryCallback.bIgnoreTouches = true;
+		QueryCallback.bIsOverlapQuery = true;
+
+		FPhysicsCommand::ExecuteRead(&PhysScene, [&]()
+		{
+			for (int32 QueryIndex : QueryIndices)
+			{
+				const FTransform GeomPose = Adaptor.GetGeomPose(Positions[QueryIndex]);
+
+				FDynamicHitBuffer<FHitOverlap> OverlapBuffer;
+				{
+					FScopedSQHitchRepeater<decltype(OverlapBuffer)> HitchRepeater(OverlapBuffer, QueryCallback, FHitchDetectionInfo(GeomPose, TraceChannel, Params));
+					do
+					{
+						LowLevelOverlap(PhysScene, Geom, GeomPose, HitchRepeater.GetBuffer(), QueryFlags, Filter, QueryFilterData, &QueryCallback, FQueryDebugParams());
+					} while (HitchRepeater.RepeatOnHitch());
+				}
+
+				OutBlocking[QueryIndex] = GetHasBlock(OverlapBuffer);
+			}
+		});
+	});
+}
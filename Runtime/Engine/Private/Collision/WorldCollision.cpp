@@ -37,6 +37,9 @@ DEFINE_STAT(STAT_Collision_GeomSweepMultiple);
 DEFINE_STAT(STAT_Collision_GeomOverlapMultiple);
 DEFINE_STAT(STAT_Collision_GeomOverlapBlocking);
 DEFINE_STAT(STAT_Collision_GeomOverlapAny);
+DEFINE_STAT(STAT_Collision_RaycastBatch);
+DEFINE_STAT(STAT_Collision_GeomSweepBatch);
+DEFINE_STAT(STAT_Collision_GeomOverlapBlockingBatch);
 DEFINE_STAT(STAT_Collision_FBodyInstance_OverlapMulti);
 DEFINE_STAT(STAT_Collision_FBodyInstance_OverlapTest);
 DEFINE_STAT(STAT_Collision_FBodyInstance_LineTrace);
@@ -350,6 +353,28 @@ bool UWorld::ComponentOverlapMultiByChannel(TArray<struct FOverlapResult>& OutOv
 	}
 }
 
+void UWorld::LineTraceBatchByChannel(EAsyncTraceType TraceType, TArray<struct FHitResult>& OutHits, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params /* = FCollisionQueryParams::DefaultQueryParam */, const FCollisionResponseParams& ResponseParam /* = FCollisionResponseParams::DefaultResponseParam */) const
+{
+	FPhysicsInterface::RaycastBatch(this, TraceType, OutHits, Starts, Ends, TraceChannel, Params, ResponseParam, FCollisionObjectQueryParams::DefaultObjectQueryParam);
+}
+
+void UWorld::SweepBatchByChannel(EAsyncTraceType TraceType, TArray<struct FHitResult>& OutHits, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params /* = FCollisionQueryParams::DefaultQueryParam */, const FCollisionResponseParams& ResponseParam /* = FCollisionResponseParams::DefaultResponseParam */) const
+{
+	if (CollisionShape.IsNearlyZero())
+	{
+		LineTraceBatchByChannel(TraceType, OutHits, Starts, Ends, TraceChannel, Params, ResponseParam);
+	}
+	else
+	{
+		FPhysicsInterface::GeomSweepBatch(this, TraceType, CollisionShape, Rot, OutHits, Starts, Ends, TraceChannel, Params, ResponseParam, FCollisionObjectQueryParams::DefaultObjectQueryParam);
+	}
+}
+
+void UWorld::OverlapBlockingTestBatchByChannel(TArray<bool>& OutBlocking, TArrayView<const FVector> Positions, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionShape& CollisionShape, const FCollisionQueryParams& Params /* = FCollisionQueryParams::DefaultQueryParam */, const FCollisionResponseParams& ResponseParam /* = FCollisionResponseParams::DefaultResponseParam */) const
+{
+	FPhysicsInterface::GeomOverlapBlockingTestBatch(this, CollisionShape, Rot, OutBlocking, Positions, TraceChannel, Params, ResponseParam, FCollisionObjectQueryParams::DefaultObjectQueryParam);
+}
+
 bool UWorld::ComponentSweepMulti(TArray<struct FHitResult>& OutHits, class UPrimitiveComponent* PrimComp, const FVector& Start, const FVector& End, const FQuat& Quat, const FComponentQueryParams& Params) const
 {
 	OutHits.Reset();
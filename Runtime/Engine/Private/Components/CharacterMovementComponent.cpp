@@ -18,6 +18,7 @@
 #include "DrawDebugHelpers.h"
 #include "GameFramework/GameNetworkManager.h"
 #include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementBatchSubsystem.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/GameStateBase.h"
 #include "Engine/Canvas.h"
@@ -72,6 +73,7 @@ DECLARE_CYCLE_STAT(TEXT("Char ProcessLanded"), STAT_CharProcessLanded, STATGROUP
 
 
 DECLARE_CYCLE_STAT(TEXT("Char HandleImpact"), STAT_CharHandleImpact, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Batched Floors Used"), STAT_CharBatchedFloorsUsed, STATGROUP_Character);
 
 // MAGIC NUMBERS
 const float MAX_STEP_SIDE_Z = 0.08f;	// maximum z value for the normal on the vertical side of steps
@@ -130,6 +132,13 @@ namespace CharacterMovementCVars
 		TEXT("<0: Disable, >=0: Enable and log this often, in seconds."),
 		ECVF_Default);
 
+	static float BatchedFloorTolerance = 0.5f;
+	FAutoConsoleVariableRef CVarBatchedFloorTolerance(
+		TEXT("p.BatchedCharacterMovement.FloorTolerance"),
+		BatchedFloorTolerance,
+		TEXT("How far (in cm) a character using batched movement can end up from its predicted location and still use the floor found there by the batch."),
+		ECVF_Default);
+
 	static int32 NetEnableMoveCombining = 1;
 	FAutoConsoleVariableRef CVarNetEnableMoveCombining(
 		TEXT("p.NetEnableMoveCombining"),
@@ -512,6 +521,9 @@ UCharacterMovementComponent::UCharacterMovementComponent(const FObjectInitialize
 	bIgnoreClientMovementErrorChecksAndCorrection = false;
 	bServerAcceptClientAuthoritativePosition = false;
 	bAlwaysCheckFloor = true;
+	bUseBatchedMovement = false;
+	BatchedFloorSweepDistance = 0.f;
+	BatchedFloorFrame = 0;
 
 	// default character can jump, walk, and swim
 	NavAgentProps.bCanJump = true;
@@ -6187,7 +6199,10 @@ void UCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, FFin
 		if ( bAlwaysCheckFloor || !bCanUseCachedLocation || bForceNextFloorCheck || bJustTeleported )
 		{
 			MutableThis->bForceNextFloorCheck = false;
-			ComputeFloorDist(CapsuleLocation, FloorLineTraceDist, FloorSweepTraceDist, OutFloorResult, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius(), DownwardSweepResult);
+			if (DownwardSweepResult != NULL || !MutableThis->ConsumeBatchedFloor(CapsuleLocation, FloorSweepTraceDist, OutFloorResult))
+			{
+				ComputeFloorDist(CapsuleLocation, FloorLineTraceDist, FloorSweepTraceDist, OutFloorResult, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius(), DownwardSweepResult);
+			}
 		}
 		else
 		{
@@ -6214,7 +6229,10 @@ void UCharacterMovementComponent::FindFloor(const FVector& CapsuleLocation, FFin
 			else
 			{
 				MutableThis->bForceNextFloorCheck = false;
-				ComputeFloorDist(CapsuleLocation, FloorLineTraceDist, FloorSweepTraceDist, OutFloorResult, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius(), DownwardSweepResult);
+				if (DownwardSweepResult != NULL || !MutableThis->ConsumeBatchedFloor(CapsuleLocation, FloorSweepTraceDist, OutFloorResult))
+				{
+					ComputeFloorDist(CapsuleLocation, FloorLineTraceDist, FloorSweepTraceDist, OutFloorResult, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius(), DownwardSweepResult);
+				}
 			}
 		}
 	}
@@ -9886,6 +9904,13 @@ void UCharacterMovementComponent::RegisterComponentTickFunctions(bool bRegister)
 			PostPhysicsTickFunction.Target = this;
 			PostPhysicsTickFunction.AddPrerequisite(this, this->PrimaryComponentTick);
 		}
+
+		UWorld* MyWorld = GetWorld();
+		UCharacterMovementBatchSubsystem* BatchSubsystem = (bUseBatchedMovement && MyWorld) ? MyWorld->GetSubsystem<UCharacterMovementBatchSubsystem>() : nullptr;
+		if (BatchSubsystem && PrimaryComponentTick.IsTickFunctionRegistered())
+		{
+			BatchSubsystem->RegisterComponent(this);
+		}
 	}
 	else
 	{
@@ -9893,9 +9918,155 @@ void UCharacterMovementComponent::RegisterComponentTickFunctions(bool bRegister)
 		{
 			PostPhysicsTickFunction.UnRegisterTickFunction();
 		}
+
+		UWorld* MyWorld = GetWorld();
+		UCharacterMovementBatchSubsystem* BatchSubsystem = MyWorld ? MyWorld->GetSubsystem<UCharacterMovementBatchSubsystem>() : nullptr;
+		if (BatchSubsystem)
+		{
+			BatchSubsystem->UnregisterComponent(this);
+		}
+		BatchedFloorFrame = 0;
 	}
 }
 
+bool UCharacterMovementComponent::PrepareBatchedFloorCheck(float DeltaTime)
+{
+	// Only characters simulated by this machine without player input, where the next move is predictable and runs through PhysWalking.
+	if (!HasValidData() || CharacterOwner->GetLocalRole() != ROLE_Authority || CharacterOwner->IsPlayerControlled())
+	{
+		return false;
+	}
+
+	if (MovementMode != MOVE_Walking || HasAnimRootMotion() || CurrentRootMotion.HasActiveRootMotionSources() || UpdatedComponent->IsSimulatingPhysics()
+		|| !UpdatedComponent->IsQueryCollisionEnabled() || !CurrentFloor.IsWalkableFloor())
+	{
+		return false;
+	}
+
+	// PhysWalking doesn't move characters without controller, avoidance changes its own state when velocity is computed.
+	if ((!CharacterOwner->Controller && !bRunPhysicsWithNoController) || bUseRVOAvoidance)
+	{
+		return false;
+	}
+
+	// Tick intervals and disabled ticks would make the prediction miss anyway.
+	if (!IsComponentTickEnabled() || PrimaryComponentTick.TickInterval > 0.f)
+	{
+		return false;
+	}
+
+	// Same first step as PhysWalking, with DeltaTime dilated as in component tick. Velocity is predicted the way PhysWalking
+	// computes it from pending input and requested move, then state changed by CalcVelocity is restored.
+	const float timeTick = GetSimulationTimeStep(DeltaTime * CharacterOwner->CustomTimeDilation, 1);
+	const FVector SavedVelocity = Velocity;
+	const FVector SavedAcceleration = Acceleration;
+	const float SavedAnalogInputModifier = AnalogInputModifier;
+
+	if (CharacterOwner->IsLocallyControlled() || !CharacterOwner->Controller)
+	{
+		Acceleration = ScaleInputAcceleration(ConstrainInputAcceleration(GetPendingInputVector()));
+		AnalogInputModifier = ComputeAnalogInputModifier();
+	}
+
+	MaintainHorizontalGroundVelocity();
+	Acceleration.Z = 0.f;
+	CalcVelocity(timeTick, GroundFriction, false, GetMaxBrakingDeceleration());
+	const FVector MoveVelocity = Velocity;
+
+	Velocity = SavedVelocity;
+	Acceleration = SavedAcceleration;
+	AnalogInputModifier = SavedAnalogInputModifier;
+
+	const FVector Delta = ComputeGroundMovementDelta(MoveVelocity * timeTick, CurrentFloor.HitResult, CurrentFloor.bLineTrace);
+	if (Delta.IsNearlyZero())
+	{
+		// Floor is only checked after moving, stationary characters don't need it.
+		return false;
+	}
+
+	BatchedFloorLocation = UpdatedComponent->GetComponentLocation() + Delta;
+	BatchedFloorSweepDistance = FMath::Max(MAX_FLOOR_DIST, MaxStepHeight + MAX_FLOOR_DIST + KINDA_SMALL_NUMBER);
+	BatchedFloorFrame = GFrameCounter;
+	return true;
+}
+
+void UCharacterMovementComponent::ComputeBatchedFloorCheck()
+{
+	ComputeFloorDist(BatchedFloorLocation, BatchedFloorSweepDistance, BatchedFloorSweepDistance, BatchedFloor, CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius());
+
+	// Only read here, game thread is waiting for the batch.
+	const UPrimitiveComponent* FloorComponent = BatchedFloor.HitResult.GetComponent();
+	BatchedFloorComponentTransform = FloorComponent ? FloorComponent->GetComponentTransform() : FTransform::Identity;
+}
+
+bool UCharacterMovementComponent::ConsumeBatchedFloor(const FVector& CapsuleLocation, float SweepDistance, FFindFloorResult& OutFloorResult)
+{
+	if (BatchedFloorFrame != GFrameCounter || SweepDistance != BatchedFloorSweepDistance)
+	{
+		return false;
+	}
+
+	const FVector Offset = CapsuleLocation - BatchedFloorLocation;
+	if (Offset.SizeSquared() > FMath::Square(CharacterMovementCVars::BatchedFloorTolerance))
+	{
+		return false;
+	}
+
+	// Batched floor is only good for the first check after the move it was predicted for.
+	BatchedFloorFrame = 0;
+
+	// Anything movable could have moved into or out of the way since the batch, including the floor itself.
+	// Only floors found on components that can't move and didn't are used.
+	const UPrimitiveComponent* FloorComponent = BatchedFloor.HitResult.GetComponent();
+	if (!BatchedFloor.bBlockingHit || FloorComponent == nullptr || FloorComponent->Mobility == EComponentMobility::Movable
+		|| !FloorComponent->GetComponentTransform().Equals(BatchedFloorComponentTransform, 0.f))
+	{
+		return false;
+	}
+
+	// Movable components in the region swept for the floor may have entered it after the batch, sweep again when there are any.
+	float PawnRadius, PawnHalfHeight;
+	CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleSize(PawnRadius, PawnHalfHeight);
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(BatchedFloorMovableOverlap), false, CharacterOwner);
+	FCollisionResponseParams ResponseParam;
+	InitCollisionParams(QueryParams, ResponseParam);
+	const FCollisionShape SweptShape = FCollisionShape::MakeCapsule(PawnRadius, PawnHalfHeight + 0.5f * SweepDistance);
+	const FVector SweptCenter = CapsuleLocation - FVector(0.f, 0.f, 0.5f * SweepDistance);
+
+	TArray<FOverlapResult> Overlaps;
+	GetWorld()->OverlapMultiByChannel(Overlaps, SweptCenter, FQuat::Identity, UpdatedComponent->GetCollisionObjectType(), SweptShape, QueryParams, ResponseParam);
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		const UPrimitiveComponent* OverlapComponent = Overlap.GetComponent();
+		if (Overlap.bBlockingHit && OverlapComponent && OverlapComponent->Mobility == EComponentMobility::Movable)
+		{
+			return false;
+		}
+	}
+
+	// Floor didn't move, only the distance to it did.
+	FFindFloorResult FloorResult = BatchedFloor;
+	FloorResult.FloorDist += Offset.Z;
+	if (FloorResult.bLineTrace)
+	{
+		FloorResult.LineDist += Offset.Z;
+	}
+
+	if (FloorResult.FloorDist < 0.f || FloorResult.FloorDist > SweepDistance)
+	{
+		return false;
+	}
+
+	FloorResult.HitResult.Location += Offset;
+	FloorResult.HitResult.TraceStart += Offset;
+	FloorResult.HitResult.TraceEnd += Offset;
+	FloorResult.HitResult.ImpactPoint += FVector(Offset.X, Offset.Y, 0.f);
+
+	OutFloorResult = FloorResult;
+	INC_DWORD_STAT(STAT_CharBatchedFloorsUsed);
+	return true;
+}
+
 void UCharacterMovementComponent::ApplyWorldOffset(const FVector& InOffset, bool bWorldShift)
 {
 	OldBaseLocation += InOffset;
@@ -17,6 +17,7 @@
 #include "GameFramework/GameStateBase.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/PawnMovementComponent.h"
+#include "GameFramework/CharacterMovementBatchSubsystem.h"
 #include "Logging/MessageLog.h"
 
 // @todo this is here only due to circular dependency to AIModule. To be removed
@@ -427,6 +428,11 @@ void AController::RemovePawnTickDependency(APawn* InOldPawn)
 		if (PawnMovement)
 		{
 			PawnMovement->PrimaryComponentTick.RemovePrerequisite(this, this->PrimaryActorTick);
+
+			if (UCharacterMovementBatchSubsystem* BatchSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UCharacterMovementBatchSubsystem>() : nullptr)
+			{
+				BatchSubsystem->RemoveControllerTickDependency(this);
+			}
 		}
 		
 		InOldPawn->PrimaryActorTick.RemovePrerequisite(this, this->PrimaryActorTick);
@@ -444,6 +450,12 @@ void AController::AddPawnTickDependency(APawn* NewPawn)
 		{
 			PawnMovement->PrimaryComponentTick.AddPrerequisite(this, this->PrimaryActorTick);
 
+			// Batched floor checks predict the move this controller requests
+			if (UCharacterMovementBatchSubsystem* BatchSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UCharacterMovementBatchSubsystem>() : nullptr)
+			{
+				BatchSubsystem->AddControllerTickDependency(this, PawnMovement);
+			}
+
 			// Don't need a prereq on the pawn if the movement component already sets up a prereq.
 			if (PawnMovement->bTickBeforeOwner || NewPawn->PrimaryActorTick.GetPrerequisites().Contains(FTickPrerequisite(PawnMovement, PawnMovement->PrimaryComponentTick)))
 			{
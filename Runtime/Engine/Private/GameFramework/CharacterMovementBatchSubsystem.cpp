@@ -0,0 +1,154 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "GameFramework/CharacterMovementBatchSubsystem.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "Async/ParallelFor.h"
+
+namespace CharacterMovementBatchCVars
+{
+	static int32 EnableBatchedMovement = 1;
+	FAutoConsoleVariableRef CVarEnableBatchedMovement(
+		TEXT("p.BatchedCharacterMovement"),
+		EnableBatchedMovement,
+		TEXT("Whether floor checks of characters using batched movement are found ahead of time by UCharacterMovementBatchSubsystem.\n")
+		TEXT("0: Disable, 1: Enable"),
+		ECVF_Default);
+
+	static int32 ParallelBatchedMovement = 1;
+	FAutoConsoleVariableRef CVarParallelBatchedMovement(
+		TEXT("p.BatchedCharacterMovement.Parallel"),
+		ParallelBatchedMovement,
+		TEXT("Whether batched floor checks are spread across worker threads.\n")
+		TEXT("0: Game thread only, 1: Worker threads"),
+		ECVF_Default);
+}
+
+DECLARE_CYCLE_STAT(TEXT("Char Batched Movement Tick"), STAT_CharBatchedMovementTick, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Batched Floors"), STAT_CharBatchedFloors, STATGROUP_Character);
+
+void FCharacterMovementBatchTickFunction::ExecuteTick(float DeltaTime, enum ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (TickType != LEVELTICK_ViewportsOnly)
+	{
+		Subsystem->Tick(DeltaTime);
+	}
+}
+
+FString FCharacterMovementBatchTickFunction::DiagnosticMessage()
+{
+	static const FString Message(TEXT("UCharacterMovementBatchSubsystemTick"));
+	return Message;
+}
+
+FName FCharacterMovementBatchTickFunction::DiagnosticContext(bool bDetailed)
+{
+	static const FName Context(TEXT("UCharacterMovementBatchSubsystem"));
+	return Context;
+}
+
+UCharacterMovementBatchSubsystem::UCharacterMovementBatchSubsystem()
+	: TickFunction(this)
+{
+}
+
+void UCharacterMovementBatchSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	// movement components waiting for the batch tick in TG_PrePhysics
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = true;
+	TickFunction.TickGroup = TG_PrePhysics;
+	TickFunction.bAllowTickOnDedicatedServer = true;
+	TickFunction.RegisterTickFunction(GetWorld()->PersistentLevel);
+}
+
+void UCharacterMovementBatchSubsystem::Deinitialize()
+{
+	TickFunction.UnRegisterTickFunction();
+	MovementComponents.Empty();
+	BatchedComponents.Empty();
+}
+
+void UCharacterMovementBatchSubsystem::RegisterComponent(UCharacterMovementComponent* MovementComponent)
+{
+	if (MovementComponent && !MovementComponents.Contains(MovementComponent))
+	{
+		MovementComponents.Add(MovementComponent);
+		MovementComponent->PrimaryComponentTick.AddPrerequisite(this, TickFunction);
+
+		const APawn* PawnOwner = MovementComponent->GetPawnOwner();
+		AddControllerTickDependency(PawnOwner ? PawnOwner->GetController() : nullptr, MovementComponent);
+	}
+}
+
+void UCharacterMovementBatchSubsystem::UnregisterComponent(UCharacterMovementComponent* MovementComponent)
+{
+	if (MovementComponents.RemoveSingleSwap(MovementComponent, false) > 0)
+	{
+		MovementComponent->PrimaryComponentTick.RemovePrerequisite(this, TickFunction);
+
+		const APawn* PawnOwner = MovementComponent->GetPawnOwner();
+		RemoveControllerTickDependency(PawnOwner ? PawnOwner->GetController() : nullptr);
+	}
+}
+
+void UCharacterMovementBatchSubsystem::AddControllerTickDependency(AController* Controller, UPawnMovementComponent* MovementComponent)
+{
+	// Controllers and their components request velocity and add input the batch predicts the next move from.
+	// Player controlled characters aren't batched.
+	if (Controller && !Controller->IsPlayerController() && MovementComponents.Contains(MovementComponent))
+	{
+		TickFunction.AddPrerequisite(Controller, Controller->PrimaryActorTick);
+		for (UActorComponent* Component : Controller->GetComponents())
+		{
+			if (Component && Component->PrimaryComponentTick.bCanEverTick)
+			{
+				TickFunction.AddPrerequisite(Component, Component->PrimaryComponentTick);
+			}
+		}
+	}
+}
+
+void UCharacterMovementBatchSubsystem::RemoveControllerTickDependency(AController* Controller)
+{
+	if (Controller)
+	{
+		TickFunction.RemovePrerequisite(Controller, Controller->PrimaryActorTick);
+		for (UActorComponent* Component : Controller->GetComponents())
+		{
+			if (Component)
+			{
+				TickFunction.RemovePrerequisite(Component, Component->PrimaryComponentTick);
+			}
+		}
+	}
+}
+
+void UCharacterMovementBatchSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharBatchedMovementTick);
+
+	BatchedComponents.Reset();
+	if (CharacterMovementBatchCVars::EnableBatchedMovement == 0)
+	{
+		return;
+	}
+
+	// predicting next move reads and writes component state, stays on game thread
+	for (UCharacterMovementComponent* MovementComponent : MovementComponents)
+	{
+		if (MovementComponent->PrepareBatchedFloorCheck(DeltaTime))
+		{
+			BatchedComponents.Add(MovementComponent);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_CharBatchedFloors, BatchedComponents.Num());
+
+	ParallelFor(BatchedComponents.Num(), [this](int32 Index)
+	{
+		BatchedComponents[Index]->ComputeBatchedFloorCheck();
+	}, CharacterMovementBatchCVars::ParallelBatchedMovement == 0);
+}
@@ -81,6 +81,91 @@ namespace PhysicsReplicationCVars
 {
 	static int32 SkipSkeletalRepOptimization = 1;
 	static FAutoConsoleVariableRef CVarSkipSkeletalRepOptimization(TEXT("p.SkipSkeletalRepOptimization"), SkipSkeletalRepOptimization, TEXT("If true, we don't move the skeletal mesh component during replication. This is ok because the skeletal mesh already polls physx after its results"));
+
+	static int32 BatchedReplicationCorrections = 1;
+	static FAutoConsoleVariableRef CVarBatchedReplicationCorrections(TEXT("p.BatchedReplicationCorrections"), BatchedReplicationCorrections, TEXT("If true, all replicated bodies are corrected under a single physics scene lock and their components are moved afterwards"));
+
+	static int32 MaxReplicationCorrectionsPerTick = 128;
+	static FAutoConsoleVariableRef CVarMaxReplicationCorrectionsPerTick(TEXT("p.MaxReplicationCorrectionsPerTick"), MaxReplicationCorrectionsPerTick, TEXT("Max number of replicated bodies corrected per tick, remaining ones wait for the next ticks. Bounds the time the physics scene is write locked when many bodies get updates at once. 0 for no limit"));
+
+	static int32 RewindHistory = 1;
+	static FAutoConsoleVariableRef CVarRewindHistory(TEXT("p.RewindHistory"), RewindHistory, TEXT("If true, server records recent poses of replicated physics bodies for lag compensated hit checks"));
+
+	static int32 RewindHistorySamples = 32;
+	static FAutoConsoleVariableRef CVarRewindHistorySamples(TEXT("p.RewindHistorySamples"), RewindHistorySamples, TEXT("Number of poses kept per body in rewind history, one is recorded every physics tick. Applies to bodies added afterwards"));
+
+	static int32 RewindHistoryBudgetKB = 512;
+	static FAutoConsoleVariableRef CVarRewindHistoryBudgetKB(TEXT("p.RewindHistoryBudgetKB"), RewindHistoryBudgetKB, TEXT("Max memory used by rewind history of a physics scene, bodies over budget are not recorded"));
+}
+
+DECLARE_CYCLE_STAT(TEXT("Phys Replication Corrections"), STAT_PhysicsReplicationCorrections, STATGROUP_Physics);
+DECLARE_CYCLE_STAT(TEXT("Phys Rewind History Record"), STAT_PhysicsRewindHistoryRecord, STATGROUP_Physics);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Phys Replication Corrected Bodies"), STAT_PhysicsReplicationCorrectedBodies, STATGROUP_Physics);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Phys Rewind History Bodies"), STAT_PhysicsRewindHistoryBodies, STATGROUP_Physics);
+DECLARE_MEMORY_STAT(TEXT("Phys Rewind History Memory"), STAT_PhysicsRewindHistoryMemory, STATGROUP_Physics);
+
+FPhysicsRewindHistory::FPhysicsRewindHistory(int32 InMaxSamples)
+	: MaxSamples(FMath::Max(InMaxSamples, 2))
+	, OldestIndex(0)
+{
+	Samples.Reserve(MaxSamples);
+}
+
+void FPhysicsRewindHistory::Record(float TimeSeconds, const FTransform& Pose)
+{
+	const FSample Sample = { Pose.GetRotation(), Pose.GetLocation(), TimeSeconds };
+	const int32 NumSamples = Samples.Num();
+	if (NumSamples > 0 && TimeSeconds <= GetSample(NumSamples - 1).TimeSeconds)
+	{
+		Samples[(OldestIndex + NumSamples - 1) % NumSamples] = Sample;
+	}
+	else if (NumSamples < MaxSamples)
+	{
+		Samples.Add(Sample);
+	}
+	else
+	{
+		Samples[OldestIndex] = Sample;
+		OldestIndex = (OldestIndex + 1) % NumSamples;
+	}
+}
+
+bool FPhysicsRewindHistory::GetPoseAtTime(float TimeSeconds, FTransform& OutPose) const
+{
+	const int32 NumSamples = Samples.Num();
+	if (NumSamples == 0 || TimeSeconds < GetSample(0).TimeSeconds)
+	{
+		return false;
+	}
+
+	// first sample after requested time, the oldest one is known to be before it
+	int32 First = 1;
+	int32 Last = NumSamples;
+	while (First < Last)
+	{
+		const int32 Middle = (First + Last) / 2;
+		if (GetSample(Middle).TimeSeconds > TimeSeconds)
+		{
+			Last = Middle;
+		}
+		else
+		{
+			First = Middle + 1;
+		}
+	}
+
+	if (First == NumSamples)
+	{
+		const FSample& Newest = GetSample(NumSamples - 1);
+		OutPose = FTransform(Newest.Rotation, Newest.Position);
+		return true;
+	}
+
+	const FSample& Before = GetSample(First - 1);
+	const FSample& After = GetSample(First);
+	const float Alpha = (TimeSeconds - Before.TimeSeconds) / (After.TimeSeconds - Before.TimeSeconds);
+	OutPose = FTransform(FQuat::Slerp(Before.Rotation, After.Rotation, Alpha), FMath::Lerp(Before.Position, After.Position, Alpha));
+	return true;
 }
 
 bool FPhysicsReplication::ApplyRigidBodyState(float DeltaSeconds, FBodyInstance* BI, FReplicatedPhysicsTarget& PhysicsTarget, const FRigidBodyErrorCorrection& ErrorCorrection, const float PingSecondsOneWay)
@@ -367,21 +452,22 @@ float FPhysicsReplication::GetOwnerPing(const AActor* const Owner, const FReplic
 
 void FPhysicsReplication::OnTick(float DeltaSeconds, TMap<TWeakObjectPtr<UPrimitiveComponent>, FReplicatedPhysicsTarget>& ComponentsToTargets)
 {
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsReplicationCorrections);
+
 	const FRigidBodyErrorCorrection& PhysicErrorCorrection = UPhysicsSettings::Get()->PhysicErrorCorrection;
 
 	// Get the ping between this PC & the server
 	const float LocalPing = GetLocalPing();
 
+	PendingCorrections.Reset();
 	for (auto Itr = ComponentsToTargets.CreateIterator(); Itr; ++Itr)
 	{
-		bool bRemoveItr = false;
 		if (UPrimitiveComponent* PrimComp = Itr.Key().Get())
 		{
 			if (FBodyInstance* BI = PrimComp->GetBodyInstance(Itr.Value().BoneName))
 			{
 				FReplicatedPhysicsTarget& PhysicsTarget = Itr.Value();
 				FRigidBodyState& UpdatedState = PhysicsTarget.TargetState;
-				bool bUpdated = false;
 				if (AActor* OwningActor = PrimComp->GetOwner())
 				{
 					const ENetRole OwnerRole = OwningActor->GetLocalRole();
@@ -400,43 +486,97 @@ void FPhysicsReplication::OnTick(float DeltaSeconds, TMap<TWeakObjectPtr<UPrimit
 
 						if (UpdatedState.Flags & ERigidBodyFlags::NeedsUpdate)
 						{
-							const bool bRestoredState = ApplyRigidBodyState(DeltaSeconds, BI, PhysicsTarget, PhysicErrorCorrection, PingSecondsOneWay);
-
-							// Need to update the component to match new position.
-							if (PhysicsReplicationCVars::SkipSkeletalRepOptimization == 0 || Cast<USkeletalMeshComponent>(PrimComp) == nullptr)	//simulated skeletal mesh does its own polling of physics results so we don't need to call this as it'll happen at the end of the physics sim
-							{
-								PrimComp->SyncComponentToRBPhysics();
-							}
-
-							if (bRestoredState)
-							{
-								bRemoveItr = true;
-							}
+							PendingCorrections.Add({ PrimComp, BI, &PhysicsTarget, PingSecondsOneWay, false });
 						}
 					}
 				}
 			}
 		}
+	}
+
+	// Over budget, correct a window of bodies and continue after it next tick
+	int32 FirstCorrection = 0;
+	int32 NumCorrections = PendingCorrections.Num();
+	const int32 MaxCorrections = PhysicsReplicationCVars::MaxReplicationCorrectionsPerTick;
+	if (MaxCorrections > 0 && NumCorrections > MaxCorrections)
+	{
+		FirstCorrection = NextCorrectionIndex % NumCorrections;
+		NumCorrections = MaxCorrections;
+		NextCorrectionIndex = FirstCorrection + NumCorrections;
+	}
+
+	INC_DWORD_STAT_BY(STAT_PhysicsReplicationCorrectedBodies, NumCorrections);
+
+	auto ApplyCorrections = [&]()
+	{
+		for (int32 Index = 0; Index < NumCorrections; ++Index)
+		{
+			FPendingCorrection& Correction = PendingCorrections[(FirstCorrection + Index) % PendingCorrections.Num()];
+			Correction.bRestoredState = ApplyRigidBodyState(DeltaSeconds, Correction.BodyInstance, *Correction.Target, PhysicErrorCorrection, Correction.PingSecondsOneWay);
+		}
+	};
+
+	if (PhysicsReplicationCVars::BatchedReplicationCorrections && PhysScene && NumCorrections > 1)
+	{
+		FPhysicsCommand::ExecuteWrite(PhysScene, ApplyCorrections);
+	}
+	else
+	{
+		ApplyCorrections();
+	}
+
+	// Components are moved outside of the scene lock, overlaps and game code can run from there
+	for (int32 Index = 0; Index < NumCorrections; ++Index)
+	{
+		FPendingCorrection& Correction = PendingCorrections[(FirstCorrection + Index) % PendingCorrections.Num()];
+
+		// Need to update the component to match new position.
+		if (PhysicsReplicationCVars::SkipSkeletalRepOptimization == 0 || Cast<USkeletalMeshComponent>(Correction.Component) == nullptr)	//simulated skeletal mesh does its own polling of physics results so we don't need to call this as it'll happen at the end of the physics sim
+		{
+			Correction.Component->SyncComponentToRBPhysics();
+		}
+	}
 
-		if (bRemoveItr)
+	for (int32 Index = 0; Index < NumCorrections; ++Index)
+	{
+		const FPendingCorrection& Correction = PendingCorrections[(FirstCorrection + Index) % PendingCorrections.Num()];
+		if (Correction.bRestoredState)
 		{
-			OnTargetRestored(Itr.Key().Get(), Itr.Value());
-			Itr.RemoveCurrent();
+			TWeakObjectPtr<UPrimitiveComponent> TargetKey(Correction.Component);
+			OnTargetRestored(TargetKey, *Correction.Target);
+			ComponentsToTargets.Remove(TargetKey);
 		}
 	}
+	PendingCorrections.Reset();
 }
 
 void FPhysicsReplication::Tick(float DeltaSeconds)
 {
+	RecordRewindHistory();
 	OnTick(DeltaSeconds, ComponentToTargets);
+
+	// Step started after this tick simulates bodies up to the current world time, their poses are recorded with it next tick
+	const UWorld* OwningWorld = GetOwningWorld();
+	if (OwningWorld && DeltaSeconds > 0.0f)
+	{
+		LastStepTimeSeconds = OwningWorld->GetTimeSeconds();
+	}
 }
 
 FPhysicsReplication::FPhysicsReplication(FPhysScene* InPhysicsScene)
 	: PhysScene(InPhysicsScene)
+	, RewindHistoryAllocatedSize(0)
+	, LastStepTimeSeconds(-1.0f)
+	, NextCorrectionIndex(0)
 {
 
 }
 
+FPhysicsReplication::~FPhysicsReplication()
+{
+	DEC_MEMORY_STAT_BY(STAT_PhysicsRewindHistoryMemory, RewindHistoryAllocatedSize);
+}
+
 void FPhysicsReplication::SetReplicatedTarget(UPrimitiveComponent* Component, FName BoneName, const FRigidBodyState& ReplicatedTarget)
 {
 	if (UWorld* OwningWorld = GetOwningWorld())
@@ -468,3 +608,86 @@ void FPhysicsReplication::RemoveReplicatedTarget(UPrimitiveComponent* Component)
 {
 	ComponentToTargets.Remove(Component);
 }
+
+bool FPhysicsReplication::AddRewindHistory(UPrimitiveComponent* Component, FName BoneName)
+{
+	if (PhysicsReplicationCVars::RewindHistory == 0 || Component == nullptr)
+	{
+		return false;
+	}
+
+	TWeakObjectPtr<UPrimitiveComponent> HistoryKey(Component);
+	if (FPhysicsRewindHistory* History = ComponentToRewindHistory.Find(HistoryKey))
+	{
+		History->BoneName = BoneName;
+		return true;
+	}
+
+	FPhysicsRewindHistory NewHistory(PhysicsReplicationCVars::RewindHistorySamples);
+	NewHistory.BoneName = BoneName;
+	const SIZE_T BudgetBytes = SIZE_T(FMath::Max(PhysicsReplicationCVars::RewindHistoryBudgetKB, 0)) * 1024;
+	if (RewindHistoryAllocatedSize + NewHistory.GetAllocatedSize() > BudgetBytes)
+	{
+		UE_LOG(LogPhysics, Verbose, TEXT("Rewind history of %s doesn't fit into p.RewindHistoryBudgetKB (%d bodies recorded)"), *Component->GetPathName(), ComponentToRewindHistory.Num());
+		return false;
+	}
+
+	RewindHistoryAllocatedSize += NewHistory.GetAllocatedSize();
+	INC_MEMORY_STAT_BY(STAT_PhysicsRewindHistoryMemory, NewHistory.GetAllocatedSize());
+	ComponentToRewindHistory.Add(HistoryKey, MoveTemp(NewHistory));
+	return true;
+}
+
+void FPhysicsReplication::RemoveRewindHistory(UPrimitiveComponent* Component)
+{
+	TWeakObjectPtr<UPrimitiveComponent> HistoryKey(Component);
+	if (const FPhysicsRewindHistory* History = ComponentToRewindHistory.Find(HistoryKey))
+	{
+		RewindHistoryAllocatedSize -= History->GetAllocatedSize();
+		DEC_MEMORY_STAT_BY(STAT_PhysicsRewindHistoryMemory, History->GetAllocatedSize());
+		ComponentToRewindHistory.Remove(HistoryKey);
+	}
+}
+
+bool FPhysicsReplication::GetRewindPose(UPrimitiveComponent* Component, float TimeSeconds, FTransform& OutPose) const
+{
+	const FPhysicsRewindHistory* History = ComponentToRewindHistory.Find(Component);
+	return History && History->GetPoseAtTime(TimeSeconds, OutPose);
+}
+
+void FPhysicsReplication::RecordRewindHistory()
+{
+	// Nothing simulated yet, bodies don't hold results of any step
+	if (LastStepTimeSeconds < 0.0f || ComponentToRewindHistory.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_PhysicsRewindHistoryRecord);
+
+	// Bodies hold results of the last step, which simulated up to the world time it was started at
+	const float TimeSeconds = LastStepTimeSeconds;
+
+	// Read all bodies under a single scene lock
+	FPhysicsCommand::ExecuteRead(PhysScene, [&]()
+	{
+		for (auto Itr = ComponentToRewindHistory.CreateIterator(); Itr; ++Itr)
+		{
+			FPhysicsRewindHistory& History = Itr.Value();
+			UPrimitiveComponent* PrimComp = Itr.Key().Get();
+			FBodyInstance* BI = PrimComp ? PrimComp->GetBodyInstance(History.BoneName) : nullptr;
+			if (BI && BI->IsInstanceSimulatingPhysics())
+			{
+				History.Record(TimeSeconds, BI->GetUnrealWorldTransform_AssumesLocked());
+			}
+			else
+			{
+				RewindHistoryAllocatedSize -= History.GetAllocatedSize();
+				DEC_MEMORY_STAT_BY(STAT_PhysicsRewindHistoryMemory, History.GetAllocatedSize());
+				Itr.RemoveCurrent();
+			}
+		}
+	});
+
+	INC_DWORD_STAT_BY(STAT_PhysicsRewindHistoryBodies, ComponentToRewindHistory.Num());
+}
@@ -0,0 +1,267 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/CollisionProfile.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/CharacterMovementBatchSubsystem.h"
+#include "HAL/IConsoleManager.h"
+#include "Components/BoxComponent.h"
+#include "Components/CapsuleComponent.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CharacterMovementBatchTestsPrivate
+{
+	static const float FloorHalfHeight = 50.0f;
+	static const float DeltaTime = 1.0f / 30.0f;
+
+	/** how far the moving base moves between the batch and the character's move */
+	static const float BaseDrop = 5.0f;
+
+	/** half height of the movable obstacle that enters the floor sweep after the batch, and its height above the floor */
+	static const float ObstacleHalfHeight = 0.5f;
+	static const float ObstacleHeight = 1.0f;
+
+	/** characters moved by the subsystem's batch, far enough apart to not find each other in their floor sweeps */
+	static const int32 NumBatchedCharacters = 16;
+	static const float CharacterSpacing = 300.0f;
+
+	UBoxComponent* SpawnFloor(UWorld* World, const FVector& Location, const FVector& Extent, EComponentMobility::Type Mobility)
+	{
+		AActor* Actor = World->SpawnActor<AActor>();
+		UBoxComponent* Box = NewObject<UBoxComponent>(Actor);
+		Box->SetMobility(Mobility);
+		Box->SetBoxExtent(Extent);
+		Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Box->SetWorldLocation(Location);
+		Actor->SetRootComponent(Box);
+		Box->RegisterComponent();
+		return Box;
+	}
+
+	ACharacter* SpawnWalkingCharacter(UWorld* World, const FVector& FloorLocation)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		ACharacter* Character = World->SpawnActor<ACharacter>(FloorLocation, FRotator::ZeroRotator, SpawnParams);
+
+		const float HalfHeight = Character->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+		Character->SetActorLocation(FloorLocation + FVector(0.0f, 0.0f, FloorHalfHeight + HalfHeight + 2.0f));
+
+		UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement();
+		MoveComp->bRunPhysicsWithNoController = true;
+		MoveComp->SetMovementMode(MOVE_Walking);
+		MoveComp->Velocity = FVector(300.0f, 100.0f, 0.0f);
+		return Character;
+	}
+
+	bool AreFloorsEqual(const FFindFloorResult& A, const FFindFloorResult& B)
+	{
+		return A.bBlockingHit == B.bBlockingHit
+			&& A.bWalkableFloor == B.bWalkableFloor
+			&& A.bLineTrace == B.bLineTrace
+			&& FMath::IsNearlyEqual(A.FloorDist, B.FloorDist, KINDA_SMALL_NUMBER)
+			&& A.HitResult.Component == B.HitResult.Component
+			&& A.HitResult.ImpactNormal.Equals(B.HitResult.ImpactNormal, KINDA_SMALL_NUMBER);
+	}
+}
+
+/**
+ * Finds the floor of walking characters through the batched floor check and with the regular floor sweep after the same move,
+ * on a static floor and on a moving base that moves after the batch, and checks that both give the same floor.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCharacterMovementBatchedFloorTest, "System.Engine.Character.BatchedFloor", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCharacterMovementBatchedFloorTest::RunTest(const FString& Parameters)
+{
+	using namespace CharacterMovementBatchTestsPrivate;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	const FVector StaticFloorLocation(0.0f, 0.0f, 0.0f);
+	const FVector MovingBaseLocation(10000.0f, 0.0f, 0.0f);
+	SpawnFloor(World, StaticFloorLocation, FVector(2000.0f, 2000.0f, FloorHalfHeight), EComponentMobility::Static);
+	UBoxComponent* MovingBase = SpawnFloor(World, MovingBaseLocation, FVector(1000.0f, 1000.0f, FloorHalfHeight), EComponentMobility::Movable);
+
+	struct FCase
+	{
+		const TCHAR* Name;
+		FVector FloorLocation;
+		UPrimitiveComponent* MovingBase;
+		bool bObstacleEntersSweep;
+	};
+	const FCase Cases[] = {
+		{ TEXT("Static floor"), StaticFloorLocation, nullptr, false },
+		{ TEXT("Moving base"), MovingBaseLocation, MovingBase, false },
+		{ TEXT("Movable obstacle"), StaticFloorLocation + FVector(1000.0f, 1000.0f, 0.0f), nullptr, true } };
+
+	for (const FCase& Case : Cases)
+	{
+		ACharacter* Character = SpawnWalkingCharacter(World, Case.FloorLocation);
+		UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement();
+		if (!TestTrue(FString::Printf(TEXT("%s: walking on floor"), Case.Name), MoveComp->IsMovingOnGround() && MoveComp->CurrentFloor.IsWalkableFloor()))
+		{
+			continue;
+		}
+
+		if (!TestTrue(FString::Printf(TEXT("%s: floor check batched"), Case.Name), MoveComp->PrepareBatchedFloorCheck(DeltaTime)))
+		{
+			continue;
+		}
+		MoveComp->ComputeBatchedFloorCheck();
+
+		// Other actors tick between the batch and the character's move
+		if (Case.MovingBase)
+		{
+			Case.MovingBase->SetWorldLocation(Case.MovingBase->GetComponentLocation() - FVector(0.0f, 0.0f, BaseDrop));
+		}
+		UBoxComponent* Obstacle = nullptr;
+		if (Case.bObstacleEntersSweep)
+		{
+			const FVector ObstacleLocation(MoveComp->BatchedFloorLocation.X, MoveComp->BatchedFloorLocation.Y, Case.FloorLocation.Z + FloorHalfHeight + ObstacleHeight);
+			Obstacle = SpawnFloor(World, ObstacleLocation, FVector(100.0f, 100.0f, ObstacleHalfHeight), EComponentMobility::Movable);
+		}
+
+		// Character moved where it was predicted to
+		const FVector Location = MoveComp->BatchedFloorLocation;
+		MoveComp->UpdatedComponent->SetWorldLocation(Location, false, nullptr, ETeleportType::TeleportPhysics);
+
+		const FFindFloorResult BatchFloor = MoveComp->BatchedFloor;
+		FFindFloorResult BatchedResult;
+		const bool bUsedBatch = MoveComp->ConsumeBatchedFloor(Location, MoveComp->BatchedFloorSweepDistance, BatchedResult);
+		if (!bUsedBatch)
+		{
+			MoveComp->FindFloor(Location, BatchedResult, false);
+		}
+
+		// Batched floor was consumed, this one is swept
+		FFindFloorResult UnbatchedResult;
+		MoveComp->FindFloor(Location, UnbatchedResult, false);
+
+		TestTrue(FString::Printf(TEXT("%s: batched floor same as swept floor"), Case.Name), AreFloorsEqual(BatchedResult, UnbatchedResult));
+		TestTrue(FString::Printf(TEXT("%s: floor found"), Case.Name), UnbatchedResult.IsWalkableFloor());
+
+		if (Case.MovingBase)
+		{
+			TestFalse(FString::Printf(TEXT("%s: floor on movable component not used"), Case.Name), bUsedBatch);
+			TestTrue(FString::Printf(TEXT("%s: floor from batch is stale"), Case.Name), FMath::IsNearlyEqual(UnbatchedResult.FloorDist - BatchFloor.FloorDist, BaseDrop, 0.1f));
+		}
+		else if (Obstacle)
+		{
+			TestFalse(FString::Printf(TEXT("%s: floor with movable component in the sweep not used"), Case.Name), bUsedBatch);
+			TestTrue(FString::Printf(TEXT("%s: floor found on obstacle"), Case.Name), UnbatchedResult.HitResult.Component == Obstacle);
+		}
+		else
+		{
+			TestTrue(FString::Printf(TEXT("%s: batched floor used"), Case.Name), bUsedBatch);
+		}
+
+		AddInfo(FString::Printf(TEXT("%s: batched floor %s, floor distance %.3f, swept floor distance %.3f"), Case.Name, bUsedBatch ? TEXT("used") : TEXT("rejected"), BatchedResult.FloorDist, UnbatchedResult.FloorDist));
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+/**
+ * Ticks a world with walking characters registered to the movement batch subsystem, with floor checks computed on worker threads
+ * and on game thread, and checks that every character's floor was found by the batch tick and used by its move.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCharacterMovementBatchSubsystemTest, "System.Engine.Character.BatchedFloorSubsystem", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCharacterMovementBatchSubsystemTest::RunTest(const FString& Parameters)
+{
+	using namespace CharacterMovementBatchTestsPrivate;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	// Batched floors are only valid during the frame they were computed in, ticks here get their own frame numbers
+	const uint64 SavedFrameCounter = GFrameCounter;
+	IConsoleVariable* ParallelVar = IConsoleManager::Get().FindConsoleVariable(TEXT("p.BatchedCharacterMovement.Parallel"));
+	const int32 SavedParallel = ParallelVar->GetInt();
+
+	const FVector FloorLocation(0.0f, 0.0f, 0.0f);
+	SpawnFloor(World, FloorLocation, FVector(4000.0f, 4000.0f, FloorHalfHeight), EComponentMobility::Static);
+
+	UCharacterMovementBatchSubsystem* BatchSubsystem = World->GetSubsystem<UCharacterMovementBatchSubsystem>();
+	if (TestNotNull(TEXT("Batch subsystem"), BatchSubsystem))
+	{
+		// Batched movement is read when tick functions are registered
+		TArray<ACharacter*> Characters;
+		for (int32 CharacterIdx = 0; CharacterIdx < NumBatchedCharacters; ++CharacterIdx)
+		{
+			const FVector Location = FloorLocation + FVector((CharacterIdx % 4) * CharacterSpacing, (CharacterIdx / 4) * CharacterSpacing, 0.0f);
+			ACharacter* Character = SpawnWalkingCharacter(World, Location);
+			UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement();
+			MoveComp->UnregisterComponent();
+			MoveComp->bUseBatchedMovement = true;
+			MoveComp->RegisterComponent();
+			Characters.Add(Character);
+		}
+		TestEqual(TEXT("Registered movement components"), BatchSubsystem->GetNumRegisteredComponents(), NumBatchedCharacters);
+
+		for (int32 bParallel = 1; bParallel >= 0; --bParallel)
+		{
+			const TCHAR* Name = bParallel ? TEXT("Worker threads") : TEXT("Game thread");
+			ParallelVar->Set(bParallel, ECVF_SetByCode);
+
+			for (ACharacter* Character : Characters)
+			{
+				UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement();
+				MoveComp->SetMovementMode(MOVE_Walking);
+				MoveComp->Velocity = FVector(300.0f, 100.0f, 0.0f);
+			}
+
+			++GFrameCounter;
+			World->Tick(LEVELTICK_All, DeltaTime);
+
+			TestEqual(FString::Printf(TEXT("%s: batched floors"), Name), BatchSubsystem->GetNumBatchedFloors(), NumBatchedCharacters);
+
+			int32 NumUsed = 0;
+			int32 NumMismatches = 0;
+			for (ACharacter* Character : Characters)
+			{
+				UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement();
+
+				// Consumed batched floors are cleared
+				NumUsed += MoveComp->BatchedFloorFrame == 0 ? 1 : 0;
+
+				FFindFloorResult SweptFloor;
+				MoveComp->FindFloor(MoveComp->UpdatedComponent->GetComponentLocation(), SweptFloor, false);
+				NumMismatches += MoveComp->IsMovingOnGround() && AreFloorsEqual(MoveComp->CurrentFloor, SweptFloor) ? 0 : 1;
+			}
+			TestEqual(FString::Printf(TEXT("%s: batched floors used by moves"), Name), NumUsed, NumBatchedCharacters);
+			TestEqual(FString::Printf(TEXT("%s: floors different from swept floors"), Name), NumMismatches, 0);
+
+			AddInfo(FString::Printf(TEXT("%s: %d of %d batched floors used, %d different from swept floors"), Name, NumUsed, BatchSubsystem->GetNumBatchedFloors(), NumMismatches));
+		}
+	}
+
+	ParallelVar->Set(SavedParallel, ECVF_SetByCode);
+	GFrameCounter = SavedFrameCounter;
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,441 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Package.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/CollisionProfile.h"
+#include "GameFramework/Actor.h"
+#include "Components/BoxComponent.h"
+#include "Components/SphereComponent.h"
+#include "PhysicsReplication.h"
+#include "PhysicsPublic.h"
+#include "Physics/PhysicsInterfaceCore.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace PhysicsReplicationTestsPrivate
+{
+	/** server ticks at roughly 30Hz with jittering frame times */
+	static const float MinTickSeconds = 1.0f / 45.0f;
+	static const float MaxTickSeconds = 1.0f / 25.0f;
+	static const float SimulatedSeconds = 3.0f;
+
+	/** one way latency of each shot, and error of server's ping estimate */
+	static const float MinLatencySeconds = 0.02f;
+	static const float MaxLatencySeconds = 0.15f;
+	static const float PingErrorSeconds = 0.005f;
+
+	static const int32 NumShots = 4096;
+
+	/** bodies are spheres, clients aim anywhere inside ShotRadius */
+	static const float BodyRadius = 50.0f;
+	static const float ShotRadius = 40.0f;
+
+	/** bodies move along a known curve, so server can check client's view of them */
+	struct FBodyMotion
+	{
+		FVector Origin;
+		FVector Velocity;
+		float Amplitude;
+		float Frequency;
+		FVector SpinAxis;
+		float SpinRate;
+
+		FTransform GetPose(float TimeSeconds) const
+		{
+			const FVector Wobble(FMath::Sin(Frequency * TimeSeconds), FMath::Cos(Frequency * TimeSeconds), 0.0f);
+			return FTransform(FQuat(SpinAxis, SpinRate * TimeSeconds), Origin + Velocity * TimeSeconds + Wobble * Amplitude);
+		}
+	};
+
+	/** sets console variable for the lifetime of the scope */
+	struct FScopedConsoleVariable
+	{
+		FScopedConsoleVariable(const TCHAR* Name, int32 Value)
+			: Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+			, OldValue(Variable ? Variable->GetInt() : 0)
+		{
+			if (Variable)
+			{
+				Variable->Set(Value, ECVF_SetByCode);
+			}
+		}
+
+		~FScopedConsoleVariable()
+		{
+			if (Variable)
+			{
+				Variable->Set(OldValue, ECVF_SetByCode);
+			}
+		}
+
+		IConsoleVariable* Variable;
+		int32 OldValue;
+	};
+
+	/** bodies of the world tests, far enough apart to never touch */
+	static const int32 NumWorldBodies = 8;
+	static const float WorldBodySpacing = 1000.0f;
+
+	/** distance between a pose the body was set to and the one read back from physics */
+	static const float PoseTolerance = 0.01f;
+
+	UWorld* CreateTestWorld()
+	{
+		UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		FURL URL;
+		World->InitializeActorsForPlay(URL);
+		World->BeginPlay();
+		return World;
+	}
+
+	void DestroyTestWorld(UWorld* World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	/** simulating sphere without gravity nor damping, owned by an actor replicated from the server */
+	USphereComponent* SpawnBody(UWorld* World, const FVector& Location)
+	{
+		AActor* Actor = World->SpawnActor<AActor>();
+		Actor->SetRole(ROLE_SimulatedProxy);
+
+		USphereComponent* Sphere = NewObject<USphereComponent>(Actor);
+		Sphere->SetSphereRadius(BodyRadius);
+		Sphere->SetCollisionProfileName(UCollisionProfile::PhysicsActor_ProfileName);
+		Sphere->SetWorldLocation(Location);
+		Actor->SetRootComponent(Sphere);
+		Sphere->RegisterComponent();
+
+		Sphere->SetEnableGravity(false);
+		Sphere->SetLinearDamping(0.0f);
+		Sphere->SetAngularDamping(0.0f);
+		Sphere->SetSimulatePhysics(true);
+		return Sphere;
+	}
+
+	bool ArePosesEqual(const FTransform& A, const FTransform& B)
+	{
+		return A.GetLocation().Equals(B.GetLocation(), PoseTolerance) && A.GetRotation().Equals(B.GetRotation(), KINDA_SMALL_NUMBER);
+	}
+
+	FTransform GetBodyPose(USphereComponent* Sphere)
+	{
+		return Sphere->GetBodyInstance()->GetUnrealWorldTransform();
+	}
+}
+
+/**
+ * Records poses of moving bodies into rewind history at jittering server tick rate, then validates shots clients fired
+ * at the bodies as they saw them through simulated latency. Checks that every shot hits the rewound body, that history
+ * stays within p.RewindHistoryBudgetKB and reports time spent recording and querying.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPhysicsRewindHistoryTest, "System.Engine.Physics.RewindHistory", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPhysicsRewindHistoryTest::RunTest(const FString& Parameters)
+{
+	using namespace PhysicsReplicationTestsPrivate;
+
+	FScopedConsoleVariable RewindHistoryGuard(TEXT("p.RewindHistory"), 1);
+	const int32 NumSamples = IConsoleManager::Get().FindConsoleVariable(TEXT("p.RewindHistorySamples"))->GetInt();
+	const SIZE_T BudgetBytes = SIZE_T(IConsoleManager::Get().FindConsoleVariable(TEXT("p.RewindHistoryBudgetKB"))->GetInt()) * 1024;
+	const SIZE_T BytesPerBody = FPhysicsRewindHistory(NumSamples).GetAllocatedSize();
+	const int32 MaxBodies = int32(BudgetBytes / BytesPerBody);
+	if (!TestTrue(TEXT("Budget fits a body"), MaxBodies > 0))
+	{
+		return false;
+	}
+
+	// Memory budget, bodies over it are not recorded
+	{
+		FPhysicsReplication PhysicsReplication(nullptr);
+		TArray<UBoxComponent*> Components;
+		for (int32 BodyIdx = 0; BodyIdx < MaxBodies + 16; ++BodyIdx)
+		{
+			UBoxComponent* Component = NewObject<UBoxComponent>(GetTransientPackage());
+			Components.Add(Component);
+			TestTrue(TEXT("Body added within budget"), PhysicsReplication.AddRewindHistory(Component) == (BodyIdx < MaxBodies));
+		}
+		TestEqual(TEXT("Recorded bodies"), PhysicsReplication.GetNumRewindHistories(), MaxBodies);
+		TestTrue(TEXT("Rewind history within budget"), PhysicsReplication.GetRewindHistoryAllocatedSize() <= BudgetBytes);
+
+		for (UBoxComponent* Component : Components)
+		{
+			PhysicsReplication.RemoveRewindHistory(Component);
+		}
+		TestEqual(TEXT("Rewind history memory after removing bodies"), int64(PhysicsReplication.GetRewindHistoryAllocatedSize()), int64(0));
+	}
+
+	FRandomStream RandomStream(0x52574e44);
+	TArray<FBodyMotion> Motions;
+	TArray<FPhysicsRewindHistory> Histories;
+	for (int32 BodyIdx = 0; BodyIdx < MaxBodies; ++BodyIdx)
+	{
+		FBodyMotion Motion;
+		Motion.Origin = RandomStream.GetUnitVector() * RandomStream.FRandRange(0.0f, 10000.0f);
+		Motion.Velocity = RandomStream.GetUnitVector() * RandomStream.FRandRange(0.0f, 800.0f);
+		Motion.Amplitude = RandomStream.FRandRange(0.0f, 100.0f);
+		Motion.Frequency = RandomStream.FRandRange(0.0f, 2.0f * PI);
+		Motion.SpinAxis = RandomStream.GetUnitVector();
+		Motion.SpinRate = RandomStream.FRandRange(0.0f, 2.0f * PI);
+		Motions.Add(Motion);
+		Histories.Emplace(NumSamples);
+	}
+
+	// Server ticks
+	double RecordSeconds = 0.0;
+	int32 NumTicks = 0;
+	float ServerTimeSeconds = 0.0f;
+	while (ServerTimeSeconds < SimulatedSeconds)
+	{
+		ServerTimeSeconds += RandomStream.FRandRange(MinTickSeconds, MaxTickSeconds);
+		++NumTicks;
+
+		FDurationTimer Timer(RecordSeconds);
+		for (int32 BodyIdx = 0; BodyIdx < MaxBodies; ++BodyIdx)
+		{
+			Histories[BodyIdx].Record(ServerTimeSeconds, Motions[BodyIdx].GetPose(ServerTimeSeconds));
+		}
+		Timer.Stop();
+	}
+
+	SIZE_T AllocatedSize = 0;
+	for (const FPhysicsRewindHistory& History : Histories)
+	{
+		AllocatedSize += History.GetAllocatedSize();
+	}
+	TestTrue(TEXT("Recorded history within budget"), AllocatedSize <= BudgetBytes);
+
+	FTransform Pose;
+	TestFalse(TEXT("Pose older than history"), Histories[0].GetPoseAtTime(Histories[0].GetOldestTime() - 0.01f, Pose));
+
+	// Shots arrive at the server now. Client fired them one way latency ago, at bodies as they were another one way latency
+	// before that. Server rewinds by its estimate of the round trip.
+	double QuerySeconds = 0.0;
+	int32 NumRewoundHits = 0;
+	int32 NumCurrentHits = 0;
+	float MaxRewindError = 0.0f;
+	for (int32 ShotIdx = 0; ShotIdx < NumShots; ++ShotIdx)
+	{
+		const int32 BodyIdx = RandomStream.RandHelper(MaxBodies);
+		const float RoundTripSeconds = RandomStream.FRandRange(MinLatencySeconds, MaxLatencySeconds) + RandomStream.FRandRange(MinLatencySeconds, MaxLatencySeconds);
+		const float ClientViewTimeSeconds = ServerTimeSeconds - RoundTripSeconds;
+		const FTransform ClientViewPose = Motions[BodyIdx].GetPose(ClientViewTimeSeconds);
+		const FVector ShotLocation = ClientViewPose.TransformPosition(RandomStream.GetUnitVector() * RandomStream.FRandRange(0.0f, ShotRadius));
+
+		const float RewindTimeSeconds = ServerTimeSeconds - RoundTripSeconds + RandomStream.FRandRange(-PingErrorSeconds, PingErrorSeconds);
+		FTransform RewoundPose;
+		FDurationTimer Timer(QuerySeconds);
+		const bool bFoundPose = Histories[BodyIdx].GetPoseAtTime(RewindTimeSeconds, RewoundPose);
+		Timer.Stop();
+		if (!bFoundPose)
+		{
+			AddError(FString::Printf(TEXT("Shot %d: no pose of body %d at %.3f s, history starts at %.3f s"), ShotIdx, BodyIdx, RewindTimeSeconds, Histories[BodyIdx].GetOldestTime()));
+			return false;
+		}
+
+		NumRewoundHits += RewoundPose.InverseTransformPosition(ShotLocation).Size() <= BodyRadius ? 1 : 0;
+		NumCurrentHits += Motions[BodyIdx].GetPose(ServerTimeSeconds).InverseTransformPosition(ShotLocation).Size() <= BodyRadius ? 1 : 0;
+
+		const FTransform ExpectedPose = Motions[BodyIdx].GetPose(RewindTimeSeconds);
+		MaxRewindError = FMath::Max(MaxRewindError, FVector::Dist(RewoundPose.GetLocation(), ExpectedPose.GetLocation()));
+	}
+	TestEqual(TEXT("Shots hitting rewound bodies"), NumRewoundHits, NumShots);
+
+	const FString Summary = FString::Printf(TEXT("%d bodies, %d samples each, %.1f KB of %.1f KB budget. Record %.2f us/tick, query %.0f ns/shot. ")
+		TEXT("%d shots with %.0f-%.0f ms round trips: %d hit rewound bodies (max interpolation error %.3f), %d hit current bodies"),
+		MaxBodies, NumSamples, AllocatedSize / 1024.0, BudgetBytes / 1024.0, RecordSeconds * 1000000.0 / NumTicks, QuerySeconds * 1000000000.0 / NumShots,
+		NumShots, MinLatencySeconds * 2000.0f, MaxLatencySeconds * 2000.0f, NumRewoundHits, MaxRewindError, NumCurrentHits);
+	UE_LOG(LogPhysics, Display, TEXT("%s"), *Summary);
+	AddInfo(Summary);
+
+	return true;
+}
+
+/**
+ * Sends replicated targets far from the bodies of simulated proxies and applies them in one physics replication tick,
+ * batched under a single scene lock and one body at a time, then checks bodies and their components snapped to the
+ * targets. Checks that a correction budget corrects every body over the next ticks.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPhysicsReplicationCorrectionsTest, "System.Engine.Physics.ReplicationCorrections", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPhysicsReplicationCorrectionsTest::RunTest(const FString& Parameters)
+{
+	using namespace PhysicsReplicationTestsPrivate;
+
+	FScopedConsoleVariable HardSnapGuard(TEXT("p.AlwaysHardSnap"), 1);
+
+	struct FCase
+	{
+		const TCHAR* Name;
+		int32 bBatched;
+		int32 MaxCorrections;
+	};
+	const FCase Cases[] = { { TEXT("Batched"), 1, 0 }, { TEXT("Unbatched"), 0, 0 }, { TEXT("Batched over budget"), 1, 3 } };
+
+	for (const FCase& Case : Cases)
+	{
+		FScopedConsoleVariable BatchedGuard(TEXT("p.BatchedReplicationCorrections"), Case.bBatched);
+		FScopedConsoleVariable BudgetGuard(TEXT("p.MaxReplicationCorrectionsPerTick"), Case.MaxCorrections);
+
+		UWorld* World = CreateTestWorld();
+		FPhysicsReplication* PhysicsReplication = World->GetPhysicsScene() ? World->GetPhysicsScene()->GetPhysicsReplication() : nullptr;
+		if (!TestNotNull(FString::Printf(TEXT("%s: physics replication"), Case.Name), PhysicsReplication))
+		{
+			DestroyTestWorld(World);
+			continue;
+		}
+
+		TArray<USphereComponent*> Bodies;
+		TArray<FTransform> Targets;
+		for (int32 BodyIdx = 0; BodyIdx < NumWorldBodies; ++BodyIdx)
+		{
+			Bodies.Add(SpawnBody(World, FVector(BodyIdx * WorldBodySpacing, 0.0f, 0.0f)));
+			Targets.Add(FTransform(FQuat(FVector::UpVector, 0.1f * (BodyIdx + 1)), FVector(BodyIdx * WorldBodySpacing, 300.0f, 100.0f + BodyIdx)));
+
+			FRigidBodyState TargetState;
+			TargetState.Position = Targets[BodyIdx].GetLocation();
+			TargetState.Quaternion = Targets[BodyIdx].GetRotation();
+			TargetState.LinVel = FVector::ZeroVector;
+			TargetState.AngVel = FVector::ZeroVector;
+			TargetState.Flags = ERigidBodyFlags::NeedsUpdate;
+			PhysicsReplication->SetReplicatedTarget(Bodies[BodyIdx], NAME_None, TargetState);
+		}
+
+		// Every tick corrects the budget or all remaining bodies
+		const int32 NumTicks = Case.MaxCorrections > 0 ? FMath::DivideAndRoundUp(NumWorldBodies, Case.MaxCorrections) : 1;
+		for (int32 TickIdx = 0; TickIdx < NumTicks; ++TickIdx)
+		{
+			PhysicsReplication->Tick(1.0f / 30.0f);
+
+			int32 NumCorrected = 0;
+			for (int32 BodyIdx = 0; BodyIdx < NumWorldBodies; ++BodyIdx)
+			{
+				NumCorrected += ArePosesEqual(GetBodyPose(Bodies[BodyIdx]), Targets[BodyIdx]) ? 1 : 0;
+			}
+			const int32 ExpectedCorrected = Case.MaxCorrections > 0 ? FMath::Min((TickIdx + 1) * Case.MaxCorrections, NumWorldBodies) : NumWorldBodies;
+			TestEqual(FString::Printf(TEXT("%s: bodies at target after tick %d"), Case.Name, TickIdx), NumCorrected, ExpectedCorrected);
+		}
+
+		for (int32 BodyIdx = 0; BodyIdx < NumWorldBodies; ++BodyIdx)
+		{
+			TestTrue(FString::Printf(TEXT("%s: body %d at target"), Case.Name, BodyIdx), ArePosesEqual(GetBodyPose(Bodies[BodyIdx]), Targets[BodyIdx]));
+			TestTrue(FString::Printf(TEXT("%s: component %d moved with its body"), Case.Name, BodyIdx), ArePosesEqual(Bodies[BodyIdx]->GetComponentTransform(), Targets[BodyIdx]));
+		}
+
+		DestroyTestWorld(World);
+	}
+
+	return true;
+}
+
+/**
+ * Ticks a world with moving bodies at jittering frame times while the server records their rewind history, then checks
+ * that rewinding to the time of every past frame gives the pose the body had at the end of that frame, and that shots
+ * rewound by their round trip land between the poses of the frames around them.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPhysicsRewindHistoryWorldTest, "System.Engine.Physics.RewindHistoryWorld", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPhysicsRewindHistoryWorldTest::RunTest(const FString& Parameters)
+{
+	using namespace PhysicsReplicationTestsPrivate;
+
+	FScopedConsoleVariable RewindHistoryGuard(TEXT("p.RewindHistory"), 1);
+	const int32 NumSamples = IConsoleManager::Get().FindConsoleVariable(TEXT("p.RewindHistorySamples"))->GetInt();
+
+	UWorld* World = CreateTestWorld();
+	FPhysicsReplication* PhysicsReplication = World->GetPhysicsScene() ? World->GetPhysicsScene()->GetPhysicsReplication() : nullptr;
+	if (!TestNotNull(TEXT("Physics replication"), PhysicsReplication))
+	{
+		DestroyTestWorld(World);
+		return false;
+	}
+
+	FRandomStream RandomStream(0x52574e57);
+	TArray<USphereComponent*> Bodies;
+	for (int32 BodyIdx = 0; BodyIdx < NumWorldBodies; ++BodyIdx)
+	{
+		USphereComponent* Body = SpawnBody(World, FVector(BodyIdx * WorldBodySpacing, 0.0f, 0.0f));
+		Body->SetPhysicsLinearVelocity(RandomStream.GetUnitVector() * RandomStream.FRandRange(100.0f, 800.0f));
+		Body->SetPhysicsAngularVelocityInDegrees(RandomStream.GetUnitVector() * RandomStream.FRandRange(0.0f, 180.0f));
+		TestTrue(TEXT("Body recorded"), PhysicsReplication->AddRewindHistory(Body));
+		Bodies.Add(Body);
+	}
+
+	// Frames stay under max physics delta time, so every frame steps the bodies. Last frame isn't recorded yet.
+	// Tick functions are queued once per frame number, ticks here get their own and the global one is restored afterwards.
+	const uint64 SavedFrameCounter = GFrameCounter;
+	const int32 NumFrames = FMath::Min(NumSamples, 24);
+	TArray<float> FrameTimes;
+	TArray<TArray<FTransform>> FramePoses;
+	for (int32 FrameIdx = 0; FrameIdx < NumFrames; ++FrameIdx)
+	{
+		++GFrameCounter;
+		World->Tick(LEVELTICK_All, RandomStream.FRandRange(MinTickSeconds, 1.0f / 35.0f));
+
+		FrameTimes.Add(World->GetTimeSeconds());
+		TArray<FTransform>& Poses = FramePoses.AddDefaulted_GetRef();
+		for (USphereComponent* Body : Bodies)
+		{
+			Poses.Add(GetBodyPose(Body));
+		}
+	}
+	GFrameCounter = SavedFrameCounter;
+
+	int32 NumMismatches = 0;
+	for (int32 FrameIdx = 0; FrameIdx < NumFrames - 1; ++FrameIdx)
+	{
+		for (int32 BodyIdx = 0; BodyIdx < NumWorldBodies; ++BodyIdx)
+		{
+			FTransform RewoundPose;
+			const bool bFoundPose = PhysicsReplication->GetRewindPose(Bodies[BodyIdx], FrameTimes[FrameIdx], RewoundPose);
+			NumMismatches += bFoundPose && ArePosesEqual(RewoundPose, FramePoses[FrameIdx][BodyIdx]) ? 0 : 1;
+		}
+	}
+	TestEqual(TEXT("Rewound poses different from poses at end of frames"), NumMismatches, 0);
+
+	// Shots arrive now, fired at bodies as clients saw them a round trip ago
+	int32 NumShotMismatches = 0;
+	for (int32 ShotIdx = 0; ShotIdx < NumShots; ++ShotIdx)
+	{
+		const int32 BodyIdx = RandomStream.RandHelper(NumWorldBodies);
+		const float RoundTripSeconds = RandomStream.FRandRange(MinLatencySeconds, MaxLatencySeconds) + RandomStream.FRandRange(MinLatencySeconds, MaxLatencySeconds);
+		const float RewindTimeSeconds = FMath::Max(FrameTimes.Last() - RoundTripSeconds, FrameTimes[0]);
+		const int32 AfterIdx = FMath::Max(Algo::UpperBound(FrameTimes, RewindTimeSeconds), 1);
+		if (AfterIdx >= NumFrames - 1)
+		{
+			continue;
+		}
+
+		FTransform RewoundPose;
+		if (!PhysicsReplication->GetRewindPose(Bodies[BodyIdx], RewindTimeSeconds, RewoundPose))
+		{
+			++NumShotMismatches;
+			continue;
+		}
+
+		// Bodies move at constant velocity between frames
+		const FVector Before = FramePoses[AfterIdx - 1][BodyIdx].GetLocation();
+		const FVector After = FramePoses[AfterIdx][BodyIdx].GetLocation();
+		const float Alpha = (RewindTimeSeconds - FrameTimes[AfterIdx - 1]) / (FrameTimes[AfterIdx] - FrameTimes[AfterIdx - 1]);
+		NumShotMismatches += RewoundPose.GetLocation().Equals(FMath::Lerp(Before, After, Alpha), PoseTolerance) ? 0 : 1;
+	}
+	TestEqual(TEXT("Rewound shots away from bodies"), NumShotMismatches, 0);
+
+	AddInfo(FString::Printf(TEXT("%d bodies over %d frames (%.3f s), %d rewound poses and %d rewound shots differ"), NumWorldBodies, NumFrames, FrameTimes.Last(), NumMismatches, NumShotMismatches));
+
+	DestroyTestWorld(World);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
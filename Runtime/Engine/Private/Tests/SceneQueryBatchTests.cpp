@@ -0,0 +1,142 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/CollisionProfile.h"
+#include "GameFramework/Actor.h"
+#include "Components/BoxComponent.h"
+#include "WorldCollision.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SceneQueryBatchTestsPrivate
+{
+	static const int32 NumBoxes = 64;
+	static const int32 NumQueries = 1024;
+	static const float WorldExtent = 5000.0f;
+
+	/** distance between batched and single hit locations and normals, hits are computed by the same low level queries */
+	static const float HitTolerance = 0.01f;
+
+	bool AreHitsEqual(const FHitResult& A, const FHitResult& B)
+	{
+		if (A.bBlockingHit != B.bBlockingHit)
+		{
+			return false;
+		}
+
+		return !A.bBlockingHit
+			|| (A.Component == B.Component
+				&& A.ImpactPoint.Equals(B.ImpactPoint, HitTolerance)
+				&& A.ImpactNormal.Equals(B.ImpactNormal, HitTolerance)
+				&& FMath::IsNearlyEqual(A.Time, B.Time, KINDA_SMALL_NUMBER));
+	}
+}
+
+/**
+ * Runs line traces, sweeps and blocking overlap tests against randomly placed boxes through the batched scene query API
+ * and one query at a time, and checks that every batched result matches the single query one.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSceneQueryBatchTest, "System.Engine.Collision.BatchedQueries", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSceneQueryBatchTest::RunTest(const FString& Parameters)
+{
+	using namespace SceneQueryBatchTestsPrivate;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	FRandomStream RandomStream(0x42415443);
+	for (int32 BoxIdx = 0; BoxIdx < NumBoxes; ++BoxIdx)
+	{
+		AActor* Actor = World->SpawnActor<AActor>();
+		UBoxComponent* Box = NewObject<UBoxComponent>(Actor);
+		Box->SetBoxExtent(FVector(RandomStream.FRandRange(50.0f, 500.0f), RandomStream.FRandRange(50.0f, 500.0f), RandomStream.FRandRange(50.0f, 500.0f)));
+		Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Actor->SetRootComponent(Box);
+		Box->SetWorldLocationAndRotation(RandomStream.GetUnitVector() * RandomStream.FRandRange(0.0f, WorldExtent), FRotator(RandomStream.FRandRange(-180.0f, 180.0f), RandomStream.FRandRange(-180.0f, 180.0f), 0.0f));
+		Box->RegisterComponent();
+	}
+
+	TArray<FVector> Starts;
+	TArray<FVector> Ends;
+	for (int32 QueryIdx = 0; QueryIdx < NumQueries; ++QueryIdx)
+	{
+		Starts.Add(RandomStream.GetUnitVector() * RandomStream.FRandRange(0.0f, WorldExtent));
+		Ends.Add(Starts.Last() + RandomStream.GetUnitVector() * RandomStream.FRandRange(0.0f, WorldExtent));
+	}
+
+	const ECollisionChannel TraceChannel = ECC_WorldStatic;
+	const FQuat Rot(FRotator(30.0f, 45.0f, 0.0f));
+	const FCollisionShape Shapes[] = { FCollisionShape::MakeSphere(100.0f), FCollisionShape::MakeBox(FVector(50.0f, 100.0f, 150.0f)), FCollisionShape::MakeCapsule(40.0f, 90.0f) };
+
+	int32 NumMismatches = 0;
+	int32 NumBlocking = 0;
+	TArray<FHitResult> BatchHits;
+	TArray<bool> BatchBlocking;
+
+	// Line traces
+	World->LineTraceBatchByChannel(EAsyncTraceType::Single, BatchHits, Starts, Ends, TraceChannel);
+	for (int32 QueryIdx = 0; QueryIdx < NumQueries; ++QueryIdx)
+	{
+		FHitResult Hit;
+		World->LineTraceSingleByChannel(Hit, Starts[QueryIdx], Ends[QueryIdx], TraceChannel);
+		NumMismatches += AreHitsEqual(BatchHits[QueryIdx], Hit) ? 0 : 1;
+		NumBlocking += Hit.bBlockingHit ? 1 : 0;
+	}
+
+	World->LineTraceBatchByChannel(EAsyncTraceType::Test, BatchHits, Starts, Ends, TraceChannel);
+	for (int32 QueryIdx = 0; QueryIdx < NumQueries; ++QueryIdx)
+	{
+		NumMismatches += BatchHits[QueryIdx].bBlockingHit == World->LineTraceTestByChannel(Starts[QueryIdx], Ends[QueryIdx], TraceChannel) ? 0 : 1;
+	}
+
+	// Sweeps and overlaps
+	for (const FCollisionShape& Shape : Shapes)
+	{
+		World->SweepBatchByChannel(EAsyncTraceType::Single, BatchHits, Starts, Ends, Rot, TraceChannel, Shape);
+		for (int32 QueryIdx = 0; QueryIdx < NumQueries; ++QueryIdx)
+		{
+			FHitResult Hit;
+			World->SweepSingleByChannel(Hit, Starts[QueryIdx], Ends[QueryIdx], Rot, TraceChannel, Shape);
+			NumMismatches += AreHitsEqual(BatchHits[QueryIdx], Hit) ? 0 : 1;
+			NumBlocking += Hit.bBlockingHit ? 1 : 0;
+		}
+
+		World->SweepBatchByChannel(EAsyncTraceType::Test, BatchHits, Starts, Ends, Rot, TraceChannel, Shape);
+		for (int32 QueryIdx = 0; QueryIdx < NumQueries; ++QueryIdx)
+		{
+			NumMismatches += BatchHits[QueryIdx].bBlockingHit == World->SweepTestByChannel(Starts[QueryIdx], Ends[QueryIdx], Rot, TraceChannel, Shape) ? 0 : 1;
+		}
+
+		World->OverlapBlockingTestBatchByChannel(BatchBlocking, Starts, Rot, TraceChannel, Shape);
+		for (int32 QueryIdx = 0; QueryIdx < NumQueries; ++QueryIdx)
+		{
+			const bool bBlocking = World->OverlapBlockingTestByChannel(Starts[QueryIdx], Rot, TraceChannel, Shape);
+			NumMismatches += BatchBlocking[QueryIdx] == bBlocking ? 0 : 1;
+			NumBlocking += bBlocking ? 1 : 0;
+		}
+	}
+
+	TestEqual(TEXT("Batched results different from single query results"), NumMismatches, 0);
+	TestTrue(TEXT("Queries found blocking hits"), NumBlocking > 0);
+
+	const FString Summary = FString::Printf(TEXT("%d queries of each kind against %d boxes, %d blocking single results, %d batched results differ"), NumQueries, NumBoxes, NumBlocking, NumMismatches);
+	UE_LOG(LogCollision, Display, TEXT("%s"), *Summary);
+	AddInfo(Summary);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
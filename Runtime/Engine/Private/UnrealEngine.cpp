@@ -1690,6 +1690,9 @@ void UEngine::Init(IEngineLoop* InEngineLoop)
 	EngineStats.Add(FEngineStatFuncs(TEXT("STAT_Hitches"), TEXT("STATCAT_Engine"), FText::GetEmpty(), &UEngine::RenderStatHitches, &UEngine::ToggleStatHitches, bIsRHS));
 	EngineStats.Add(FEngineStatFuncs(TEXT("STAT_AI"), TEXT("STATCAT_Engine"), FText::GetEmpty(), &UEngine::RenderStatAI, NULL, bIsRHS));
 	EngineStats.Add(FEngineStatFuncs(TEXT("STAT_Timecode"), TEXT("STATCAT_Engine"), FText::GetEmpty(), &UEngine::RenderStatTimecode, NULL, bIsRHS));
+#if USE_AGGREGATED_CYCLE_STATS && !STATS && !ENABLE_STATNAMEDEVENTS
+	EngineStats.Add(FEngineStatFuncs(TEXT("STAT_Aggregated"), TEXT("STATCAT_Engine"), FText::GetEmpty(), &UEngine::RenderStatAggregated, NULL));
+#endif
 
 	EngineStats.Add(FEngineStatFuncs(TEXT("STAT_ColorList"), TEXT("STATCAT_Engine"), FText::GetEmpty(), &UEngine::RenderStatColorList, NULL));
 	EngineStats.Add(FEngineStatFuncs(TEXT("STAT_Levels"), TEXT("STATCAT_Engine"), FText::GetEmpty(), &UEngine::RenderStatLevels, NULL));
@@ -15973,6 +15976,43 @@ int32 UEngine::RenderStatTimecode(UWorld* World, FViewport* Viewport, FCanvas* C
 	return Y;
 }
 
+#if USE_AGGREGATED_CYCLE_STATS && !STATS && !ENABLE_STATNAMEDEVENTS
+static int32 GStatAggregatedDisplayCount = 30;
+static FAutoConsoleVariableRef CVarStatAggregatedDisplayCount(
+	TEXT("stats.Aggregated.DisplayCount"),
+	GStatAggregatedDisplayCount,
+	TEXT("Number of aggregated cycle stats shown by 'stat aggregated'."),
+	ECVF_Default);
+
+// AGGREGATED
+int32 UEngine::RenderStatAggregated(UWorld* World, FViewport* Viewport, FCanvas* Canvas, int32 X, int32 Y, const FVector* ViewLocation, const FRotator* ViewRotation)
+{
+	UFont* Font = FPlatformProperties::SupportsWindowedMode() ? GetSmallFont() : GetMediumFont();
+	const int32 RowHeight = FMath::TruncToInt(Font->GetMaxCharHeight() * 1.1f);
+
+	TArray<FAggregatedCycleStatFrameValue> Values;
+	FAggregatedCycleStats::Get().GetFrameValues(Values);
+	Values.Sort([](const FAggregatedCycleStatFrameValue& A, const FAggregatedCycleStatFrameValue& B)
+	{
+		return A.AverageMs > B.AverageMs;
+	});
+
+	Canvas->DrawShadowedString(X, Y, TEXT("Aggregated cycle stats          Avg ms    Max ms   Calls"), Font, FColor::Yellow);
+	Y += RowHeight;
+
+	const int32 NumToDraw = FMath::Min(GStatAggregatedDisplayCount, Values.Num());
+	for (int32 Index = 0; Index < NumToDraw; ++Index)
+	{
+		const FAggregatedCycleStatFrameValue& Value = Values[Index];
+		const FColor Color = Value.AverageMs >= 1.0 ? FColor::Red : (Value.AverageMs >= 0.1 ? FColor::Yellow : FColor::Green);
+		Canvas->DrawShadowedString(X, Y, *FString::Printf(TEXT("%-30.30s %8.3f  %8.3f  %6llu"), Value.Name, Value.AverageMs, Value.MaxMs, Value.LastCalls), Font, Color);
+		Y += RowHeight;
+	}
+
+	return Y;
+}
+#endif
+
 // SLATEBATCHES
 #if STATS
 int32 UEngine::RenderStatSlateBatches(UWorld* World, FViewport* Viewport, FCanvas* Canvas, int32 X, int32 Y, const FVector* ViewLocation, const FRotator* ViewRotation)
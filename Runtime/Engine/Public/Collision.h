@@ -24,6 +24,9 @@ DECLARE_CYCLE_STAT_EXTERN(TEXT("GeomSweepMultiple"),STAT_Collision_GeomSweepMult
 DECLARE_CYCLE_STAT_EXTERN(TEXT("GeomOverlapMultiple"),STAT_Collision_GeomOverlapMultiple,STATGROUP_Collision, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("GeomOverlapBlocking"), STAT_Collision_GeomOverlapBlocking, STATGROUP_Collision, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("GeomOverlapAny"), STAT_Collision_GeomOverlapAny, STATGROUP_Collision, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RaycastBatch"), STAT_Collision_RaycastBatch, STATGROUP_Collision, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GeomSweepBatch"), STAT_Collision_GeomSweepBatch, STATGROUP_Collision, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GeomOverlapBlockingBatch"), STAT_Collision_GeomOverlapBlockingBatch, STATGROUP_Collision, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("BodyInstanceOverlapMulti"), STAT_Collision_FBodyInstance_OverlapMulti, STATGROUP_Collision, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("BodyInstanceOverlapTest"), STAT_Collision_FBodyInstance_OverlapTest, STATGROUP_Collision, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("BodyInstanceLineTrace"), STAT_Collision_FBodyInstance_LineTrace, STATGROUP_Collision, );
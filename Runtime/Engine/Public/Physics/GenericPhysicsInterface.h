@@ -44,6 +44,20 @@ struct ENGINE_API FGenericPhysicsInterface
 
 	/** Function for testing overlaps between a supplied PxGeometry and the world. Returns true if anything is overlapping (blocking or touching)*/
 	static bool GeomOverlapAnyTest(const UWorld* World, const FCollisionShape& CollisionShape, const FVector& Pos, const FQuat& Rot, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParams, const FCollisionObjectQueryParams& ObjectParams = FCollisionObjectQueryParams::DefaultObjectQueryParam);
+
+	/**
+	 *  Trace a batch of rays sharing the same filter parameters against the world.
+	 *  OutHits receives one result per ray, in the order of Starts. bBlockingHit is set on the results of rays that found a blocking hit.
+	 *  Only Test and Single trace types are supported, Test results only contain bBlockingHit.
+	 *  Synchronous: queries are spread over task threads, but the call blocks until all of them completed and OutHits is filled on return.
+	 */
+	static void RaycastBatch(const UWorld* World, EAsyncTraceType TraceType, TArray<struct FHitResult>& OutHits, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParams, const FCollisionObjectQueryParams& ObjectParams = FCollisionObjectQueryParams::DefaultObjectQueryParam);
+
+	/** Sweep a supplied shape against the world for a batch of queries sharing the same filter parameters. Synchronous, see RaycastBatch */
+	static void GeomSweepBatch(const UWorld* World, EAsyncTraceType TraceType, const FCollisionShape& CollisionShape, const FQuat& Rot, TArray<struct FHitResult>& OutHits, TArrayView<const FVector> Starts, TArrayView<const FVector> Ends, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParams, const FCollisionObjectQueryParams& ObjectParams = FCollisionObjectQueryParams::DefaultObjectQueryParam);
+
+	/** Test overlaps between a supplied shape and the world at a batch of positions sharing the same filter parameters. OutBlocking receives, per position, whether a blocking overlap was found. Synchronous, see RaycastBatch */
+	static void GeomOverlapBlockingTestBatch(const UWorld* World, const FCollisionShape& CollisionShape, const FQuat& Rot, TArray<bool>& OutBlocking, TArrayView<const FVector> Positions, ECollisionChannel TraceChannel, const FCollisionQueryParams& Params, const FCollisionResponseParams& ResponseParams, const FCollisionObjectQueryParams& ObjectParams = FCollisionObjectQueryParams::DefaultObjectQueryParam);
 };
 
 template<>
@@ -40,6 +40,42 @@ struct FReplicatedPhysicsTarget
 #endif
 };
 
+/** Recent poses of a body on the server, used to rewind it for lag compensated hit checks */
+struct ENGINE_API FPhysicsRewindHistory
+{
+	struct FSample
+	{
+		FQuat Rotation;
+		FVector Position;
+		float TimeSeconds;
+	};
+
+	explicit FPhysicsRewindHistory(int32 InMaxSamples);
+
+	/** Adds pose of the body at given time, overwriting the oldest sample once full. Times are expected to increase, same time replaces newest sample. */
+	void Record(float TimeSeconds, const FTransform& Pose);
+
+	/** Interpolates pose of the body at given time. Times after newest sample give newest pose, times before oldest sample fail. */
+	bool GetPoseAtTime(float TimeSeconds, FTransform& OutPose) const;
+
+	int32 Num() const { return Samples.Num(); }
+	float GetOldestTime() const { return Samples.Num() ? GetSample(0).TimeSeconds : 0.0f; }
+	float GetNewestTime() const { return Samples.Num() ? GetSample(Samples.Num() - 1).TimeSeconds : 0.0f; }
+	SIZE_T GetAllocatedSize() const { return Samples.GetAllocatedSize(); }
+
+	/** The bone name used to find the body */
+	FName BoneName;
+
+private:
+	/** Samples in order of time, 0 being the oldest one */
+	const FSample& GetSample(int32 Index) const { return Samples[(OldestIndex + Index) % Samples.Num()]; }
+
+	/** Ring buffer, allocated up front for MaxSamples */
+	TArray<FSample> Samples;
+	int32 MaxSamples;
+	int32 OldestIndex;
+};
+
 struct FBodyInstance;
 struct FRigidBodyErrorCorrection;
 class UWorld;
@@ -49,9 +85,9 @@ class ENGINE_API FPhysicsReplication
 {
 public:
 	FPhysicsReplication(FPhysScene* PhysScene);
-	virtual ~FPhysicsReplication() {}
+	virtual ~FPhysicsReplication();
 
-	/** Tick and update all body states according to replicated targets */
+	/** Tick and update all body states according to replicated targets, records rewind history of bodies on the server */
 	void Tick(float DeltaSeconds);
 
 	/** Sets the latest replicated target for a body instance */
@@ -60,6 +96,18 @@ public:
 	/** Remove the replicated target*/
 	virtual void RemoveReplicatedTarget(UPrimitiveComponent* Component);
 
+	/** Starts recording poses of a body every tick, fails when it doesn't fit into p.RewindHistoryBudgetKB */
+	bool AddRewindHistory(UPrimitiveComponent* Component, FName BoneName = NAME_None);
+
+	/** Stops recording poses of a body */
+	void RemoveRewindHistory(UPrimitiveComponent* Component);
+
+	/** Pose of a recorded body at a past world time, e.g. when a client saw it while shooting. Fails when body isn't recorded or time is older than its history. */
+	bool GetRewindPose(UPrimitiveComponent* Component, float TimeSeconds, FTransform& OutPose) const;
+
+	int32 GetNumRewindHistories() const { return ComponentToRewindHistory.Num(); }
+	SIZE_T GetRewindHistoryAllocatedSize() const { return RewindHistoryAllocatedSize; }
+
 protected:
 
 	/** Update the physics body state given a set of replicated targets */
@@ -74,6 +122,9 @@ protected:
 
 private:
 
+	/** Records current poses of all bodies with rewind history at the time of the last step, drops the ones no longer simulating */
+	void RecordRewindHistory();
+
 	/** Get the ping from this machine to the server */
 	float GetLocalPing() const;
 
@@ -84,4 +135,24 @@ private:
 	TMap<TWeakObjectPtr<UPrimitiveComponent>, FReplicatedPhysicsTarget> ComponentToTargets;
 	FPhysScene* PhysScene;
 
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, FPhysicsRewindHistory> ComponentToRewindHistory;
+	SIZE_T RewindHistoryAllocatedSize;
+
+	/** World time the last physics step simulated bodies up to, negative before the first step */
+	float LastStepTimeSeconds;
+
+	struct FPendingCorrection
+	{
+		UPrimitiveComponent* Component;
+		FBodyInstance* BodyInstance;
+		FReplicatedPhysicsTarget* Target;
+		float PingSecondsOneWay;
+		bool bRestoredState;
+	};
+
+	/** Bodies corrected in current tick, kept around to avoid reallocating every frame */
+	TArray<FPendingCorrection> PendingCorrections;
+
+	/** Where next tick starts correcting bodies when not all of them fit into p.MaxReplicationCorrectionsPerTick */
+	int32 NextCorrectionIndex;
 };
\ No newline at end of file
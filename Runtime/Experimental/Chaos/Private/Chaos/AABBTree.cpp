@@ -3,4 +3,10 @@
 #include "Chaos/AABBTree.h"
 
 int32 FAABBTreeCVars::UpdateDirtyElementPayloadData = 1;
-FAutoConsoleVariableRef FAABBTreeCVars::CVarUpdateDirtyElementPayloadData(TEXT("p.aabbtree.updatedirtyelementpayloads"), FAABBTreeCVars::UpdateDirtyElementPayloadData, TEXT("Allow AABB tree elements to update internal payload data when they recieve a payload update"));
\ No newline at end of file
+FAutoConsoleVariableRef FAABBTreeCVars::CVarUpdateDirtyElementPayloadData(TEXT("p.aabbtree.updatedirtyelementpayloads"), FAABBTreeCVars::UpdateDirtyElementPayloadData, TEXT("Allow AABB tree elements to update internal payload data when they recieve a payload update"));
+
+int32 FAABBTreeCVars::IncrementalUpdate = 1;
+FAutoConsoleVariableRef FAABBTreeCVars::CVarIncrementalUpdate(TEXT("p.aabbtree.incrementalupdate"), FAABBTreeCVars::IncrementalUpdate, TEXT("Move updated AABB tree elements to the best leaf and refit the tree instead of adding them to the dirty elements, which force a full rebuild once there are too many of them"));
+
+int32 FAABBTreeCVars::WideNodeQueries = 1;
+FAutoConsoleVariableRef FAABBTreeCVars::CVarWideNodeQueries(TEXT("p.aabbtree.widenodequeries"), FAABBTreeCVars::WideNodeQueries, TEXT("Traverse AABB trees four children at a time, testing their bounds with SIMD instructions"));
@@ -2,6 +2,7 @@
 
 #include "Chaos/Framework/Parallel.h"
 #include "Async/ParallelFor.h"
+#include "HAL/ThreadSafeCounter.h"
 
 using namespace Chaos;
 
@@ -26,6 +27,32 @@ void Chaos::PhysicsParallelFor(int32 InNum, TFunctionRef<void(int32)> InCallable
 	::ParallelFor(InNum, InCallable, bDisablePhysicsParallelFor || bForceSingleThreaded);
 }
 
+void Chaos::PhysicsParallelForWorkQueue(int32 InNum, TFunctionRef<void(int32)> InCallable, int32 InMaxThreads, bool bForceSingleThreaded)
+{
+	// Worker threads and the calling thread
+	const int32 NumAvailable = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	const int32 NumThreads = FMath::Min(InNum, (InMaxThreads > 0) ? FMath::Min(InMaxThreads, NumAvailable) : NumAvailable);
+
+	if (NumThreads <= 1 || bDisablePhysicsParallelFor || bForceSingleThreaded)
+	{
+		for (int32 Index = 0; Index < InNum; ++Index)
+		{
+			InCallable(Index);
+		}
+		return;
+	}
+
+	// One task per thread, each pulling indices until the queue is empty, so threads done with cheap items pick up the remaining ones
+	FThreadSafeCounter NextIndex;
+	::ParallelFor(NumThreads, [InNum, &InCallable, &NextIndex](int32 ThreadIndex)
+	{
+		for (int32 Index = NextIndex.Increment() - 1; Index < InNum; Index = NextIndex.Increment() - 1)
+		{
+			InCallable(Index);
+		}
+	}, EParallelForFlags::Unbalanced);
+}
+
 //class FRecursiveDivideTask
 //{
 //	TFuture<void> ThisFuture;
@@ -62,11 +62,92 @@ namespace Chaos
 	int32 Chaos_Collision_UseAccumulatedImpulseClipSolve = 0; // Experimental: This requires multiple contact points per iteration per pair, and making sure the contact points don't move too much in body space
 	FAutoConsoleVariableRef CVarChaosCollisionOriginalSolve(TEXT("p.Chaos.Collision.UseAccumulatedImpulseClipSolve"), Chaos_Collision_UseAccumulatedImpulseClipSolve, TEXT("Use experimental Accumulated impulse clipped contact solve"));
 
+	int32 Chaos_Collision_ContactCacheEnabled = 1;
+	FAutoConsoleVariableRef CVarChaosCollisionContactCacheEnabled(TEXT("p.Chaos.Collision.ContactCache.Enabled"), Chaos_Collision_ContactCacheEnabled, TEXT("Reuse contacts of particle pairs that have not moved relative to each other since the previous step instead of running collision detection again"));
+
+	float Chaos_Collision_ContactCacheMaxTranslation = 0.5f;
+	FAutoConsoleVariableRef CVarChaosCollisionContactCacheMaxTranslation(TEXT("p.Chaos.Collision.ContactCache.MaxTranslation"), Chaos_Collision_ContactCacheMaxTranslation, TEXT("Relative motion of the particles at a cached contact above which collision detection runs again (cm). [def:0.5]"));
+
+	float Chaos_Collision_ContactCacheMaxRotation = 2.0f;
+	FAutoConsoleVariableRef CVarChaosCollisionContactCacheMaxRotation(TEXT("p.Chaos.Collision.ContactCache.MaxRotation"), Chaos_Collision_ContactCacheMaxRotation, TEXT("Relative rotation of the particles above which collision detection runs again for cached contacts (degrees). [def:2]"));
+
+	// Impulses are only applied to approaching contacts, too large warm start can't be taken back by the solver
+	float Chaos_Collision_WarmStartFactor = 0.5f;
+	FAutoConsoleVariableRef CVarChaosCollisionWarmStartFactor(TEXT("p.Chaos.Collision.WarmStartFactor"), Chaos_Collision_WarmStartFactor, TEXT("Fraction of the previous step impulse applied to cached contacts before solving them, 0 to disable warm starting. [def:0.5]"));
+
 	DECLARE_CYCLE_STAT(TEXT("Collisions::Reset"), STAT_Collisions_Reset, STATGROUP_ChaosCollision);
 	DECLARE_CYCLE_STAT(TEXT("Collisions::UpdatePointConstraints"), STAT_Collisions_UpdatePointConstraints, STATGROUP_ChaosCollision);
 	DECLARE_CYCLE_STAT(TEXT("Collisions::UpdateManifoldConstraints"), STAT_Collisions_UpdateManifoldConstraints, STATGROUP_ChaosCollision);
 	DECLARE_CYCLE_STAT(TEXT("Collisions::Apply"), STAT_Collisions_Apply, STATGROUP_ChaosCollision);
 	DECLARE_CYCLE_STAT(TEXT("Collisions::ApplyPushOut"), STAT_Collisions_ApplyPushOut, STATGROUP_ChaosCollision);
+	DECLARE_DWORD_COUNTER_STAT(TEXT("Collisions::ContactCacheHits"), STAT_Collisions_ContactCacheHits, STATGROUP_ChaosCollision);
+	DECLARE_DWORD_COUNTER_STAT(TEXT("Collisions::ContactCacheMisses"), STAT_Collisions_ContactCacheMisses, STATGROUP_ChaosCollision);
+	DECLARE_FLOAT_COUNTER_STAT(TEXT("Collisions::ContactCacheHitRate"), STAT_Collisions_ContactCacheHitRate, STATGROUP_ChaosCollision);
+	DECLARE_FLOAT_COUNTER_STAT(TEXT("Collisions::NarrowPhase (ms, all threads)"), STAT_Collisions_NarrowPhaseMs, STATGROUP_ChaosCollision);
+
+	namespace
+	{
+		/**
+		 * Move a cached contact along with its particles. Location and normal follow particle 1, separation changes by the
+		 * relative motion of the particles at the contact along the normal (which points from particle 1 towards particle 0).
+		 * Returns false if the relative motion is too large for the contact to be reused.
+		 */
+		template<typename T, int d>
+		bool MoveCachedContact(TCollisionConstraintBase<T, d>& Constraint, const TRigidTransform<T, d>& OldTransform0, const TRigidTransform<T, d>& NewTransform0, const TRigidTransform<T, d>& OldTransform1, const TRigidTransform<T, d>& NewTransform1)
+		{
+			const TVector<T, d> Location0 = NewTransform0.TransformPositionNoScale(OldTransform0.InverseTransformPositionNoScale(Constraint.GetLocation()));
+			const TVector<T, d> Location1 = NewTransform1.TransformPositionNoScale(OldTransform1.InverseTransformPositionNoScale(Constraint.GetLocation()));
+			const TVector<T, d> RelativeMotion = Location0 - Location1;
+			if (RelativeMotion.SizeSquared() > FMath::Square(Chaos_Collision_ContactCacheMaxTranslation))
+			{
+				return false;
+			}
+
+			const TVector<T, d> Normal = NewTransform1.TransformVectorNoScale(OldTransform1.InverseTransformVectorNoScale(Constraint.GetNormal()));
+			Constraint.SetLocation(Location1);
+			Constraint.SetNormal(Normal);
+			Constraint.SetPhi(Constraint.GetPhi() + TVector<T, d>::DotProduct(RelativeMotion, Normal));
+			return true;
+		}
+
+		/** Store the impulse a constraint received this step in its cached copy */
+		template<typename T_CONSTRAINT, typename T_ALLOCATOR>
+		void StoreCachedImpulse(TArray<T_CONSTRAINT, T_ALLOCATOR>& CachedConstraints, const T_CONSTRAINT& Constraint)
+		{
+			for (T_CONSTRAINT& CachedConstraint : CachedConstraints)
+			{
+				if (CachedConstraint.Particle[0] == Constraint.Particle[0] && CachedConstraint.Particle[1] == Constraint.Particle[1]
+					&& CachedConstraint.ContainsManifold(Constraint.Manifold.Implicit[0], Constraint.Manifold.Implicit[1]))
+				{
+					CachedConstraint.AccumulatedImpulse = Constraint.AccumulatedImpulse;
+					return;
+				}
+			}
+		}
+
+		/** Move cached constraints of a pair to OutConstraints, returns false if any of them can't be reused */
+		template<typename T, int d, typename T_CONSTRAINT, typename T_CACHEDALLOCATOR, typename T_OUTALLOCATOR>
+		bool MoveCachedConstraints(const TArray<T_CONSTRAINT, T_CACHEDALLOCATOR>& CachedConstraints, const TGeometryParticleHandle<T, d>* const* CachedParticles,
+			const TRigidTransform<T, d>* OldTransforms, const TRigidTransform<T, d>* NewTransforms, TArray<T_CONSTRAINT, T_OUTALLOCATOR>& OutConstraints)
+		{
+			for (const T_CONSTRAINT& CachedConstraint : CachedConstraints)
+			{
+				T_CONSTRAINT Constraint = CachedConstraint;
+				const int32 Index0 = (Constraint.Particle[0] == CachedParticles[0]) ? 0 : 1;
+				const int32 Index1 = 1 - Index0;
+				if (!MoveCachedContact<T, d>(Constraint, OldTransforms[Index0], NewTransforms[Index0], OldTransforms[Index1], NewTransforms[Index1]))
+				{
+					return false;
+				}
+
+				Constraint.bIsCached = true;
+				Constraint.AccumulatedImpulse = CachedConstraint.AccumulatedImpulse * Chaos_Collision_WarmStartFactor;
+				Constraint.ConstraintHandle = nullptr;
+				OutConstraints.Add(Constraint);
+			}
+			return true;
+		}
+	}
 
 	//
 	// Collision Constraint Container
@@ -199,6 +280,11 @@ namespace Chaos
 		}
 
 		UpdateConstraintMaterialProperties(PointConstraints[Idx]);
+
+		if (FCachedContacts* CachedContacts = GetCachedContactsForUpdate(PointConstraints[Idx]))
+		{
+			CachedContacts->PointConstraints.Add(PointConstraints[Idx]);
+		}
 	}
 
 	template<typename T, int d>
@@ -250,6 +336,11 @@ namespace Chaos
 		}
 
 		UpdateConstraintMaterialProperties(IterativeConstraints[Idx]);
+
+		if (FCachedContacts* CachedContacts = GetCachedContactsForUpdate(IterativeConstraints[Idx]))
+		{
+			CachedContacts->MultiPointConstraints.Add(IterativeConstraints[Idx]);
+		}
 	}
 
 	template<typename T, int d>
@@ -265,6 +356,8 @@ namespace Chaos
 	{
 		SCOPE_CYCLE_COUNTER(STAT_Collisions_Reset);
 
+		UpdateContactCache();
+
 #if CHAOS_COLLISION_PERSISTENCE_ENABLED
 		check(bHandlesEnabled);	// This will need fixing for handle-free mode
 		TArray<FConstraintContainerHandle*> CopyOfHandles = Handles;
@@ -325,6 +418,14 @@ namespace Chaos
 				}
 			}
 		}
+
+		for (auto It = ContactCache.CreateIterator(); It; ++It)
+		{
+			if (InHandleSet.Contains(It.Key().Key) || InHandleSet.Contains(It.Key().Value))
+			{
+				It.RemoveCurrent();
+			}
+		}
 	}
 
 	template<typename T, int d>
@@ -404,6 +505,154 @@ namespace Chaos
 	}
 
 
+	template<typename T, int d>
+	typename TPBDCollisionConstraints<T, d>::FCachedContacts* TPBDCollisionConstraints<T, d>::GetCachedContactsForUpdate(const FConstraintBase& Constraint)
+	{
+		if (!Chaos_Collision_ContactCacheEnabled)
+		{
+			return nullptr;
+		}
+
+		const FParticlePairKey Key = MakeParticlePairKey(Constraint.Particle[0], Constraint.Particle[1]);
+		FCachedContacts& CachedContacts = ContactCache.FindOrAdd(Key);
+		CachedContacts.UsedTimestamp = LifespanCounter;
+		if (Constraint.bIsCached)
+		{
+			// Reused contacts are already in the cache, keep the transforms they were found at
+			return nullptr;
+		}
+
+		if (CachedContacts.DetectedTimestamp != LifespanCounter)
+		{
+			// First contact found for the pair in this step, replaces whatever was cached before
+			CachedContacts.Particles[0] = Key.Key;
+			CachedContacts.Particles[1] = Key.Value;
+			for (int32 ParticleIndex = 0; ParticleIndex < 2; ++ParticleIndex)
+			{
+				CachedContacts.Geometries[ParticleIndex] = CachedContacts.Particles[ParticleIndex]->Geometry().Get();
+				CachedContacts.Transforms[ParticleIndex] = Collisions::GetTransform(CachedContacts.Particles[ParticleIndex]);
+			}
+			CachedContacts.PointConstraints.Reset();
+			CachedContacts.MultiPointConstraints.Reset();
+			CachedContacts.DetectedTimestamp = LifespanCounter;
+		}
+
+		return &CachedContacts;
+	}
+
+	template<typename T, int d>
+	void TPBDCollisionConstraints<T, d>::UpdateContactCache()
+	{
+		if (!Chaos_Collision_ContactCacheEnabled || !bEnableCollisions)
+		{
+			ContactCache.Reset();
+			return;
+		}
+
+		for (const FPointContactConstraint& Constraint : PointConstraints)
+		{
+			if (FCachedContacts* CachedContacts = ContactCache.Find(MakeParticlePairKey(Constraint.Particle[0], Constraint.Particle[1])))
+			{
+				StoreCachedImpulse(CachedContacts->PointConstraints, Constraint);
+			}
+		}
+
+		for (const FMultiPointContactConstraint& Constraint : IterativeConstraints)
+		{
+			if (FCachedContacts* CachedContacts = ContactCache.Find(MakeParticlePairKey(Constraint.Particle[0], Constraint.Particle[1])))
+			{
+				StoreCachedImpulse(CachedContacts->MultiPointConstraints, Constraint);
+			}
+		}
+
+		// Drop pairs that were not in contact in this step
+		for (auto It = ContactCache.CreateIterator(); It; ++It)
+		{
+			if (It.Value().UsedTimestamp != LifespanCounter)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	template<typename T, int d>
+	bool TPBDCollisionConstraints<T, d>::FindCachedConstraints(TGeometryParticleHandle<T, d>* Particle0, TGeometryParticleHandle<T, d>* Particle1, const T CullDistance, FCollisionConstraintsArray& NewConstraints) const
+	{
+		if (!Chaos_Collision_ContactCacheEnabled)
+		{
+			return false;
+		}
+
+		const FCachedContacts* CachedContacts = ContactCache.Find(MakeParticlePairKey(Particle0, Particle1));
+		if (CachedContacts == nullptr)
+		{
+			return false;
+		}
+
+		TRigidTransform<T, d> Transforms[2];
+		for (int32 ParticleIndex = 0; ParticleIndex < 2; ++ParticleIndex)
+		{
+			if (CachedContacts->Particles[ParticleIndex]->Geometry().Get() != CachedContacts->Geometries[ParticleIndex])
+			{
+				return false;
+			}
+			Transforms[ParticleIndex] = Collisions::GetTransform(CachedContacts->Particles[ParticleIndex]);
+		}
+
+		const TRotation<T, d> OldRelativeRotation = CachedContacts->Transforms[0].GetRotation().Inverse() * CachedContacts->Transforms[1].GetRotation();
+		const TRotation<T, d> NewRelativeRotation = Transforms[0].GetRotation().Inverse() * Transforms[1].GetRotation();
+		const T CosHalfAngle = FMath::Abs((NewRelativeRotation * OldRelativeRotation.Inverse()).W);
+		if (CosHalfAngle < FMath::Cos(FMath::DegreesToRadians(Chaos_Collision_ContactCacheMaxRotation) * (T)0.5))
+		{
+			return false;
+		}
+
+		const int32 NumPointConstraints = NewConstraints.SinglePointConstraints.Num();
+		const int32 NumMultiPointConstraints = NewConstraints.MultiPointConstraints.Num();
+		if (!MoveCachedConstraints<T, d>(CachedContacts->PointConstraints, CachedContacts->Particles, CachedContacts->Transforms, Transforms, NewConstraints.SinglePointConstraints)
+			|| !MoveCachedConstraints<T, d>(CachedContacts->MultiPointConstraints, CachedContacts->Particles, CachedContacts->Transforms, Transforms, NewConstraints.MultiPointConstraints))
+		{
+			NewConstraints.SinglePointConstraints.SetNum(NumPointConstraints);
+			NewConstraints.MultiPointConstraints.SetNum(NumMultiPointConstraints);
+			return false;
+		}
+
+		// Multi point constraints pick the deepest point of their (particle space) manifold
+		for (int32 Index = NumMultiPointConstraints; Index < NewConstraints.MultiPointConstraints.Num(); ++Index)
+		{
+			Collisions::Update(NewConstraints.MultiPointConstraints[Index], CullDistance);
+		}
+
+		// Drop contacts separated beyond the cull distance, same as collision detection would
+		for (int32 Index = NewConstraints.SinglePointConstraints.Num() - 1; Index >= NumPointConstraints; --Index)
+		{
+			if (NewConstraints.SinglePointConstraints[Index].GetPhi() >= CullDistance)
+			{
+				NewConstraints.SinglePointConstraints.RemoveAt(Index);
+			}
+		}
+		for (int32 Index = NewConstraints.MultiPointConstraints.Num() - 1; Index >= NumMultiPointConstraints; --Index)
+		{
+			if (NewConstraints.MultiPointConstraints[Index].GetPhi() >= CullDistance)
+			{
+				NewConstraints.MultiPointConstraints.RemoveAt(Index);
+			}
+		}
+
+		return true;
+	}
+
+	template<typename T, int d>
+	void TPBDCollisionConstraints<T, d>::SetContactCacheStats(const FCollisionCacheStats& InStats)
+	{
+		ContactCacheStats = InStats;
+
+		INC_DWORD_STAT_BY(STAT_Collisions_ContactCacheHits, InStats.NumHits);
+		INC_DWORD_STAT_BY(STAT_Collisions_ContactCacheMisses, InStats.NumMisses);
+		SET_FLOAT_STAT(STAT_Collisions_ContactCacheHitRate, InStats.GetHitRate());
+		INC_FLOAT_STAT_BY(STAT_Collisions_NarrowPhaseMs, (float)(InStats.NarrowPhaseSeconds * 1000.0));
+	}
+
 	template<typename T, int d>
 	void TPBDCollisionConstraints<T, d>::UpdateConstraints(T Dt, const TSet<TGeometryParticleHandle<T, d>*>& ParticlesSet)
 	{
@@ -508,12 +508,78 @@ namespace Chaos
 		}
 
 
+		// Apply the impulse a contact reused from the previous step received then, before solving it. Only pushes the particles apart.
+		bool ApplyWarmStartImpulse(const FCollisionContact& Contact,
+			TGenericParticleHandle<FReal, 3> Particle0,
+			TGenericParticleHandle<FReal, 3> Particle1,
+			const FVec3& Impulse,
+			const FReal Dt)
+		{
+			if (FVec3::DotProduct(Impulse, Contact.Normal) <= 0)
+			{
+				return false;
+			}
+
+			TPBDRigidParticleHandle<FReal, 3>* PBDRigid0 = Particle0->CastToRigidParticle();
+			TPBDRigidParticleHandle<FReal, 3>* PBDRigid1 = Particle1->CastToRigidParticle();
+
+			if (PBDRigid0 && PBDRigid0->ObjectState() == EObjectStateType::Dynamic)
+			{
+				FVec3 P0 = FParticleUtilities::GetCoMWorldPosition(Particle0);
+				FRotation3 Q0 = FParticleUtilities::GetCoMWorldRotation(Particle0);
+				const FMatrix33 WorldSpaceInvI1 = Utilities::ComputeWorldSpaceInertia(Q0, PBDRigid0->InvI());
+				const FVec3 DV = PBDRigid0->InvM() * Impulse;
+				const FVec3 DW = WorldSpaceInvI1 * FVec3::CrossProduct(Contact.Location - P0, Impulse);
+				PBDRigid0->V() += DV;
+				PBDRigid0->W() += DW;
+				P0 += (DV * Dt);
+				Q0 += FRotation3::FromElements(DW, 0.f) * Q0 * Dt * FReal(0.5);
+				Q0.Normalize();
+				FParticleUtilities::SetCoMWorldTransform(PBDRigid0, P0, Q0);
+			}
+			if (PBDRigid1 && PBDRigid1->ObjectState() == EObjectStateType::Dynamic)
+			{
+				FVec3 P1 = FParticleUtilities::GetCoMWorldPosition(Particle1);
+				FRotation3 Q1 = FParticleUtilities::GetCoMWorldRotation(Particle1);
+				const FMatrix33 WorldSpaceInvI2 = Utilities::ComputeWorldSpaceInertia(Q1, PBDRigid1->InvI());
+				const FVec3 DV = -PBDRigid1->InvM() * Impulse;
+				const FVec3 DW = WorldSpaceInvI2 * FVec3::CrossProduct(Contact.Location - P1, -Impulse);
+				PBDRigid1->V() += DV;
+				PBDRigid1->W() += DW;
+				P1 += (DV * Dt);
+				Q1 += FRotation3::FromElements(DW, 0.f) * Q1 * Dt * FReal(0.5);
+				Q1.Normalize();
+				FParticleUtilities::SetCoMWorldTransform(PBDRigid1, P1, Q1);
+			}
+			return true;
+		}
+
 		template<typename T_CONSTRAINT>
 		void ApplyImpl(T_CONSTRAINT& Constraint, const FContactIterationParameters & IterationParameters, const FContactParticleParameters & ParticleParameters)
 		{
 			TGenericParticleHandle<FReal, 3> Particle0 = TGenericParticleHandle<FReal, 3>(Constraint.Particle[0]);
 			TGenericParticleHandle<FReal, 3> Particle1 = TGenericParticleHandle<FReal, 3>(Constraint.Particle[1]);
 
+			// What Apply algorithm should we use? Controlled by the solver, with forcable cvar override for now...
+			bool bUseVelocityMode = (IterationParameters.ApplyType == ECollisionApplyType::Velocity);
+			if (Chaos_Collision_ForceApplyType != 0)
+			{
+				bUseVelocityMode = (Chaos_Collision_ForceApplyType == (int32)ECollisionApplyType::Velocity);
+			}
+
+			// Contacts reused from the previous step carry (a fraction of) the impulse they received then, apply it up front
+			// so the solver starts close to the resting solution. It is only kept as accumulated impulse if it was applied.
+			if (Constraint.bIsCached && (IterationParameters.Iteration == 0))
+			{
+				const FVec3 WarmStartImpulse = Constraint.AccumulatedImpulse;
+				Constraint.AccumulatedImpulse = FVec3(0);
+				if (bUseVelocityMode && (Constraint.GetPhi() < ParticleParameters.ShapePadding)
+					&& ApplyWarmStartImpulse(Constraint.GetManifold(), Particle0, Particle1, WarmStartImpulse, IterationParameters.Dt))
+				{
+					Constraint.AccumulatedImpulse = WarmStartImpulse;
+				}
+			}
+
 			for (int32 PairIt = 0; PairIt < IterationParameters.NumPairIterations; ++PairIt)
 			{
 				// Collision is already up-to-date on first iteration (we either just detected it, or updated it in DetectCollisions)
@@ -543,13 +609,6 @@ namespace Chaos
 				//   For example, and iterative constraint might have 4 penetrating points that need to be resolved. 
 				//
 
-				// What Apply algorithm should we use? Controlled by the solver, with forcable cvar override for now...
-				bool bUseVelocityMode = (IterationParameters.ApplyType == ECollisionApplyType::Velocity);
-				if (Chaos_Collision_ForceApplyType != 0)
-				{
-					bUseVelocityMode = (Chaos_Collision_ForceApplyType == (int32)ECollisionApplyType::Velocity);
-				}
-
 				if (bUseVelocityMode)
 				{
 					if (Chaos_Collision_UseAccumulatedImpulseClipSolve)
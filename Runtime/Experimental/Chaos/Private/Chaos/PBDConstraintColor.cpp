@@ -10,60 +10,138 @@
 
 #include "ProfilingDebugging/ScopedTimers.h"
 #include "ChaosStats.h"
-#include "Containers/Queue.h"
 #include "ChaosLog.h"
 
-#include <memory>
-#include <queue>
-#include <sstream>
-
 using namespace Chaos;
 
 DECLARE_CYCLE_STAT(TEXT("FPBDConstraintColor::ComputeColors"), STAT_Constraint_ComputeColor, STATGROUP_Chaos);
 DECLARE_CYCLE_STAT(TEXT("FPBDConstraintColor::ComputeContactGraph"), STAT_Constraint_ComputeContactGraph, STATGROUP_Chaos);
 DECLARE_CYCLE_STAT(TEXT("FPBDConstraintColor::ComputeIslandColoring"), STAT_Constraint_ComputeIslandColoring, STATGROUP_Chaos);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FPBDConstraintColor::NumIslandsColored"), STAT_Constraint_NumIslandsColored, STATGROUP_Chaos);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FPBDConstraintColor::NumIslandsReused"), STAT_Constraint_NumIslandsReused, STATGROUP_Chaos);
+
+namespace
+{
+	bool IsParticleDynamic(const TGeometryParticleHandle<FReal, 3>* Particle)
+	{
+		return Particle->CastToRigidParticle() && Particle->ObjectState() == EObjectStateType::Dynamic;
+	}
+}
+
+bool FPBDConstraintColor::UpdateIslandKey(const int32 Island, const FPBDConstraintGraph& ConstraintGraph, uint32 ContainerId)
+{
+	FIslandColor& IslandColor = IslandData[Island];
+	TArray<UPTRINT>& Key = IslandColor.NewColorKey;
+	Key.Reset();
+
+	// Everything the coloring depends on, in the order it is visited: island particles with their dynamic state
+	// and, for each of them, the rule's constraints in this island with both constrained particles
+	for (const TGeometryParticleHandle<FReal, 3>* Particle : ConstraintGraph.GetIslandParticles(Island))
+	{
+		// Handles are aligned, the lowest bit is free to store the dynamic state
+		Key.Add(UPTRINT(Particle) | (IsParticleDynamic(Particle) ? 1 : 0));
+		const int32 NumEdgesIndex = Key.Add(0);
+
+		const int32* NodeIndexPtr = ConstraintGraph.ParticleToNodeIndex.Find(Particle);
+		if (NodeIndexPtr == nullptr)
+		{
+			continue;
+		}
+
+		for (const int32 EdgeIndex : ConstraintGraph.Nodes[*NodeIndexPtr].Edges)
+		{
+			const typename FPBDConstraintGraph::FGraphEdge& GraphEdge = ConstraintGraph.Edges[EdgeIndex];
+			if (GraphEdge.Data.GetContainerId() != ContainerId || Edges[EdgeIndex].Island != Island)
+			{
+				continue;
+			}
+
+			Key.Add(UPTRINT(GraphEdge.Data.GetConstraintHandle()));
+			Key.Add(UPTRINT(GraphEdge.FirstNode != INDEX_NONE ? ConstraintGraph.Nodes[GraphEdge.FirstNode].Particle : nullptr));
+			Key.Add(UPTRINT(GraphEdge.SecondNode != INDEX_NONE ? ConstraintGraph.Nodes[GraphEdge.SecondNode].Particle : nullptr));
+			++Key[NumEdgesIndex];
+		}
+	}
+
+	const bool bUnchanged = (IslandColor.bUsedContactGraph == bUseContactGraph) && (Key == IslandColor.ColorKey);
+	Swap(IslandColor.ColorKey, IslandColor.NewColorKey);
+	return bUnchanged;
+}
 
 void FPBDConstraintColor::ComputeIslandColoring(const int32 Island, const FPBDConstraintGraph& ConstraintGraph, uint32 ContainerId)
 {
 	SCOPE_CYCLE_COUNTER(STAT_Constraint_ComputeIslandColoring);
 	const TArray<TGeometryParticleHandle<FReal, 3>*>& IslandParticles = ConstraintGraph.GetIslandParticles(Island);
-	FLevelToColorToConstraintListMap& LevelToColorToConstraintListMap = IslandData[Island].LevelToColorToConstraintListMap;
-	int32& MaxColor = IslandData[Island].MaxColor;
-
-	const int32 MaxLevel = IslandData[Island].MaxLevel;
-	
-	LevelToColorToConstraintListMap.Reset();
-	LevelToColorToConstraintListMap.SetNum(MaxLevel + 1);
+	FIslandColor& IslandColor = IslandData[Island];
+	int32& MaxColor = IslandColor.MaxColor;
+	const int32 MaxLevel = IslandColor.MaxLevel;
 	MaxColor = -1;
 
-	TSet<int32> ProcessedNodes;
-	TArray<int32> NodesToProcess;
-
-	for (const TGeometryParticleHandle<FReal, 3>* Particle :IslandParticles)
+	// Map dynamic nodes to the island scratch arrays. A node's next color never exceeds the number of colors used
+	// at it (bounded by its degree), and the other node of an edge can push it further by at most its own degree.
+	int32 NumIslandNodes = 0;
+	int32 MaxDegree = 0;
+	for (const TGeometryParticleHandle<FReal, 3>* Particle : IslandParticles)
 	{
-		if (!ConstraintGraph.ParticleToNodeIndex.Find(Particle))
+		const int32* NodeIndexPtr = ConstraintGraph.ParticleToNodeIndex.Find(Particle);
+		if (NodeIndexPtr == nullptr || !IsParticleDynamic(Particle))
 		{
 			continue;
 		}
 
-		const int32 ParticleNodeIndex = ConstraintGraph.ParticleToNodeIndex[Particle];
+		NodeToIslandNode[*NodeIndexPtr] = NumIslandNodes++;
 
-		const bool bIsParticleDynamic = Particle->CastToRigidParticle() && Particle->ObjectState() == EObjectStateType::Dynamic;
-		if (ProcessedNodes.Contains(ParticleNodeIndex) || bIsParticleDynamic == false)
+		int32 Degree = 0;
+		for (const int32 EdgeIndex : ConstraintGraph.Nodes[*NodeIndexPtr].Edges)
+		{
+			Degree += (ConstraintGraph.Edges[EdgeIndex].Data.GetContainerId() == ContainerId) ? 1 : 0;
+		}
+		MaxDegree = FMath::Max(MaxDegree, Degree);
+	}
+
+	const int32 NumColorWords = FMath::Max(1, FMath::DivideAndRoundUp(3 * MaxDegree, 64));
+	TArray<int32>& NextColors = IslandColor.NextColors;
+	TArray<uint64>& UsedColors = IslandColor.UsedColors;
+	TArray<bool>& ProcessedNodes = IslandColor.ProcessedNodes;
+	TArray<int32>& NodesToProcess = IslandColor.NodesToProcess;
+	NextColors.Reset();
+	NextColors.SetNumZeroed(NumIslandNodes);
+	UsedColors.Reset();
+	UsedColors.SetNumZeroed(NumIslandNodes * NumColorWords);
+	ProcessedNodes.Reset();
+	ProcessedNodes.SetNumZeroed(NumIslandNodes);
+	NodesToProcess.Reset();
+
+	auto IsColorUsed = [&UsedColors, NumColorWords](const int32 IslandNode, const int32 Color) -> bool
+	{
+		checkSlow(Color < NumColorWords * 64);
+		return (UsedColors[IslandNode * NumColorWords + (Color >> 6)] & (uint64(1) << (Color & 63))) != 0;
+	};
+
+	auto SetColorUsed = [&UsedColors, NumColorWords](const int32 IslandNode, const int32 Color)
+	{
+		checkSlow(Color < NumColorWords * 64);
+		UsedColors[IslandNode * NumColorWords + (Color >> 6)] |= (uint64(1) << (Color & 63));
+	};
+
+	for (const TGeometryParticleHandle<FReal, 3>* Particle : IslandParticles)
+	{
+		const int32* ParticleNodeIndexPtr = ConstraintGraph.ParticleToNodeIndex.Find(Particle);
+		if (ParticleNodeIndexPtr == nullptr || !IsParticleDynamic(Particle) || ProcessedNodes[NodeToIslandNode[*ParticleNodeIndexPtr]])
 		{
 			continue;
 		}
 
-		NodesToProcess.Add(ParticleNodeIndex);
+		NodesToProcess.Add(*ParticleNodeIndexPtr);
 
 		while (NodesToProcess.Num())
 		{
-			const int32 NodeIndex = NodesToProcess.Last();
+			const int32 NodeIndex = NodesToProcess.Pop(/*bAllowShrinking=*/false);
+			const int32 IslandNode = NodeToIslandNode[NodeIndex];
 			const typename FPBDConstraintGraph::FGraphNode& GraphNode = ConstraintGraph.Nodes[NodeIndex];
-			FGraphNodeColor& ColorNode = Nodes[NodeIndex];
+			int32& NextColor = NextColors[IslandNode];
 
-			NodesToProcess.SetNum(NodesToProcess.Num() - 1, /*bAllowShrinking=*/false);
-			ProcessedNodes.Add(NodeIndex);
+			ProcessedNodes[IslandNode] = true;
 
 			for (const int32 EdgeIndex : GraphNode.Edges)
 			{
@@ -71,7 +149,7 @@ void FPBDConstraintColor::ComputeIslandColoring(const int32 Island, const FPBDCo
 				FGraphEdgeColor& ColorEdge = Edges[EdgeIndex];
 
 				// If this is not from our rule, ignore it
-				if (GraphEdge.Data.GetContainerId() != ContainerId)
+				if (GraphEdge.Data.GetContainerId() != ContainerId || ColorEdge.Island != Island)
 				{
 					continue;
 				}
@@ -94,75 +172,51 @@ void FPBDConstraintColor::ComputeIslandColoring(const int32 Island, const FPBDCo
 				}
 
 				// Find next color that is not used already at this node
-				while (ColorNode.UsedColors.Contains(ColorNode.NextColor))
+				while (IsColorUsed(IslandNode, NextColor))
 				{
-					ColorNode.NextColor++;
+					NextColor++;
 				}
-				int32 ColorToUse = ColorNode.NextColor;
+				int32 ColorToUse = NextColor;
 
 				// Exclude colors used by the other node (but still allow this node to use them for other edges)
-				if (OtherNodeIndex != INDEX_NONE)
+				const bool bIsOtherNodeDynamic = (OtherNodeIndex != INDEX_NONE) && IsParticleDynamic(ConstraintGraph.Nodes[OtherNodeIndex].Particle);
+				const int32 OtherIslandNode = bIsOtherNodeDynamic ? NodeToIslandNode[OtherNodeIndex] : INDEX_NONE;
+				if (bIsOtherNodeDynamic)
 				{
-					FGraphNodeColor& OtherColorNode = Nodes[OtherNodeIndex];
-
-					const typename FPBDConstraintGraph::FGraphNode& OtherGraphNode = ConstraintGraph.Nodes[OtherNodeIndex];
-					const bool bIsOtherGraphNodeDynamic = OtherGraphNode.Particle->CastToRigidParticle() && OtherGraphNode.Particle->ObjectState() == EObjectStateType::Dynamic;
-					if (bIsOtherGraphNodeDynamic)
+					while (IsColorUsed(OtherIslandNode, ColorToUse) || IsColorUsed(IslandNode, ColorToUse))
 					{
-						while (OtherColorNode.UsedColors.Contains(ColorToUse) || ColorNode.UsedColors.Contains(ColorToUse))
-						{
-							ColorToUse++;
-						}
+						ColorToUse++;
 					}
 				}
 
 				// Assign color and set as used at this node
 				MaxColor = FMath::Max(ColorToUse, MaxColor);
-				ColorNode.UsedColors.Add(ColorToUse);
+				SetColorUsed(IslandNode, ColorToUse);
 				ColorEdge.Color = ColorToUse;
 
 				// Bump color to use next time, but only if we weren't forced to use a different color by the other node
-				if ((ColorToUse == ColorNode.NextColor) && bIsParticleDynamic == true)
+				if (ColorToUse == NextColor)
 				{
-					ColorNode.NextColor++;
+					NextColor++;
 				}
 
-				int32 Level = ColorEdge.Level;
-
-				if ((Level < 0) || (Level >= LevelToColorToConstraintListMap.Num()))
+				if ((ColorEdge.Level < 0) || (ColorEdge.Level > MaxLevel))
 				{
-					UE_LOG(LogChaos, Error, TEXT("\t **** Level is out of bounds!!!!  Level - %d, LevelToColorToConstraintListMap.Num() - %d"), Level, LevelToColorToConstraintListMap.Num());
+					UE_LOG(LogChaos, Error, TEXT("\t **** Level is out of bounds!!!!  Level - %d, MaxLevel - %d"), ColorEdge.Level, MaxLevel);
 					continue;
 				}
 
-				if (!LevelToColorToConstraintListMap[Level].Contains(ColorEdge.Color))
+				if (bIsOtherNodeDynamic)
 				{
-					LevelToColorToConstraintListMap[Level].Add(ColorEdge.Color, {});
-				}
+					// Mark other node as not allowing use of this color
+					SetColorUsed(OtherIslandNode, ColorEdge.Color);
 
-				LevelToColorToConstraintListMap[Level][ColorEdge.Color].Add(GraphEdge.Data.GetConstraintHandle());
-
-				if (OtherNodeIndex != INDEX_NONE)
-				{
-					const typename FPBDConstraintGraph::FGraphNode& OtherGraphNode = ConstraintGraph.Nodes[OtherNodeIndex];
-					const bool bIsOtherGraphNodeDynamic = OtherGraphNode.Particle->CastToRigidParticle() && OtherGraphNode.Particle->ObjectState() == EObjectStateType::Dynamic;
-					if (bIsOtherGraphNodeDynamic)
+					// Queue other node for processing
+					if (!ProcessedNodes[OtherIslandNode])
 					{
-						FGraphNodeColor& OtherColorNode = Nodes[OtherNodeIndex];
-
-						// Mark other node as not allowing use of this color
-						if (bIsParticleDynamic)
-						{
-							OtherColorNode.UsedColors.Add(ColorEdge.Color);
-						}
-
-						// Queue other node for processing
-						if (!ProcessedNodes.Contains(OtherNodeIndex))
-						{
-							ensure(OtherGraphNode.Island == GraphNode.Island);
-							checkSlow(IslandParticles.Find(OtherGraphNode.Particle) != INDEX_NONE);
-							NodesToProcess.Add(OtherNodeIndex);
-						}
+						ensure(ConstraintGraph.Nodes[OtherNodeIndex].Island == GraphNode.Island);
+						checkSlow(IslandParticles.Find(ConstraintGraph.Nodes[OtherNodeIndex].Particle) != INDEX_NONE);
+						NodesToProcess.Add(OtherNodeIndex);
 					}
 				}
 			}
@@ -170,32 +224,59 @@ void FPBDConstraintColor::ComputeIslandColoring(const int32 Island, const FPBDCo
 	}
 }
 
+void FPBDConstraintColor::BuildIslandConstraintLists(const int32 Island, const FPBDConstraintGraph& ConstraintGraph, uint32 ContainerId)
+{
+	FIslandColor& IslandColor = IslandData[Island];
+	const int32 NumColors = IslandColor.MaxColor + 1;
+	const int32 NumLists = (IslandColor.MaxLevel + 1) * NumColors;
+
+	// Lists are only ever grown so their allocations get reused by the following steps
+	if (IslandColor.LevelColorConstraints.Num() < NumLists)
+	{
+		IslandColor.LevelColorConstraints.SetNum(NumLists);
+	}
+	for (FConstraintList& ConstraintList : IslandColor.LevelColorConstraints)
+	{
+		ConstraintList.Reset();
+	}
+
+	for (const int32 EdgeIndex : ConstraintGraph.GetIslandConstraintData(Island))
+	{
+		const typename FPBDConstraintGraph::FGraphEdge& GraphEdge = ConstraintGraph.Edges[EdgeIndex];
+		const FGraphEdgeColor& ColorEdge = Edges[EdgeIndex];
+		if (GraphEdge.Data.GetContainerId() != ContainerId || ColorEdge.Color < 0 || ColorEdge.Level < 0 || ColorEdge.Level > IslandColor.MaxLevel)
+		{
+			continue;
+		}
+
+		IslandColor.LevelColorConstraints[ColorEdge.Level * NumColors + ColorEdge.Color].Add(GraphEdge.Data.GetConstraintHandle());
+	}
+}
+
 void FPBDConstraintColor::ComputeContactGraph(const int32 Island, const FPBDConstraintGraph& ConstraintGraph, uint32 ContainerId)
 {
 	SCOPE_CYCLE_COUNTER(STAT_Constraint_ComputeContactGraph);
 	const TArray<int32>& ConstraintDataIndices = ConstraintGraph.GetIslandConstraintData(Island);
+	FIslandColor& IslandColor = IslandData[Island];
 
-	IslandData[Island].MaxLevel = ConstraintDataIndices.Num() ? 0 : -1;
+	IslandColor.MaxLevel = ConstraintDataIndices.Num() ? 0 : -1;
 
-	std::queue<std::pair<int32, int32>> QueueToProcess;
+	// Breadth first from the island's non-dynamic particles, pairs of level and node index
+	TArray<TPair<int32, int32>>& LevelQueue = IslandColor.LevelQueue;
+	LevelQueue.Reset();
 	for (const TGeometryParticleHandle<FReal, 3>* Particle : ConstraintGraph.GetIslandParticles(Island))
 	{
 		const int32* NodeIndexPtr = ConstraintGraph.ParticleToNodeIndex.Find(Particle);
-		const bool bIsParticleDynamic = Particle->CastToRigidParticle() && Particle->ObjectState() == EObjectStateType::Dynamic;
-		if (bIsParticleDynamic == false && NodeIndexPtr)
+		if (!IsParticleDynamic(Particle) && NodeIndexPtr)
 		{
-			const int32 NodeIndex = *NodeIndexPtr;
-			QueueToProcess.push(std::make_pair(0, NodeIndex));
+			LevelQueue.Emplace(0, *NodeIndexPtr);
 		}
 	}
 
-	while (!QueueToProcess.empty())
+	for (int32 QueueIndex = 0; QueueIndex < LevelQueue.Num(); ++QueueIndex)
 	{
-		const std::pair<int32, int32> Elem = QueueToProcess.front();
-		QueueToProcess.pop();
-
-		int32 Level = Elem.first;
-		int32 NodeIndex = Elem.second;
+		const int32 Level = LevelQueue[QueueIndex].Key;
+		const int32 NodeIndex = LevelQueue[QueueIndex].Value;
 		const typename FPBDConstraintGraph::FGraphNode& GraphNode = ConstraintGraph.Nodes[NodeIndex];
 
 		for (int32 EdgeIndex : GraphNode.Edges)
@@ -215,16 +296,15 @@ void FPBDConstraintColor::ComputeContactGraph(const int32 Island, const FPBDCons
 				continue;
 			}
 
-			// Does the node have edges that are not from this Island?
-			// @todo(ccaulfield): look into this - this should never happen I think? it's an O(N) check
-			if (!ConstraintDataIndices.Contains(EdgeIndex))
+			// Non-dynamic nodes are shared between islands, skip edges from the other ones
+			if (ColorEdge.Island != Island)
 			{
 				continue;
 			}
 
 			// Assign the level and update max level for the island if required
 			ColorEdge.Level = Level;
-			IslandData[Island].MaxLevel = FGenericPlatformMath::Max(IslandData[Island].MaxLevel, ColorEdge.Level);
+			IslandColor.MaxLevel = FGenericPlatformMath::Max(IslandColor.MaxLevel, ColorEdge.Level);
 
 			// Find adjacent node and recurse
 			int32 OtherNode = INDEX_NONE;
@@ -238,77 +318,86 @@ void FPBDConstraintColor::ComputeContactGraph(const int32 Island, const FPBDCons
 			}
 			if (OtherNode != INDEX_NONE)
 			{
-				QueueToProcess.push(std::make_pair(ColorEdge.Level + 1, OtherNode));
+				LevelQueue.Emplace(ColorEdge.Level + 1, OtherNode);
 			}
 		}
 	}
 
-	// @todo(ccaulfield): What is this for? Isolated particles with no constraints? 
-	// If so we should add them to some new islands, keeping the number of particles to each island in some reasonable range.
-	// Answer: If an island is only dynamics the above code would be skipped. This simply adds them all to level 0
+	// If an island is only dynamics the above code would be skipped. This simply adds them all to level 0
 	for (const int32 EdgeIndex : ConstraintDataIndices)
 	{
-		check(Edges[EdgeIndex].Level <= IslandData[Island].MaxLevel);
+		check(Edges[EdgeIndex].Level <= IslandColor.MaxLevel);
 		if (Edges[EdgeIndex].Level < 0)
 		{
 			Edges[EdgeIndex].Level = 0;
 		}
 	}
 
-	check(IslandData[Island].MaxLevel >= 0 || !ConstraintDataIndices.Num());
+	check(IslandColor.MaxLevel >= 0 || !ConstraintDataIndices.Num());
 }
 
 void FPBDConstraintColor::InitializeColor(const FPBDConstraintGraph& ConstraintGraph)
 {
-	// The Number of nodes is large and fairly constant so persist rather than resetting every frame
-	if (Nodes.Num() != ConstraintGraph.Nodes.Num())
-	{
-		// Nodes need to grow when the nodes of the constraint graph grows
-		Nodes.AddDefaulted(ConstraintGraph.Nodes.Num() - Nodes.Num());
-	}
-	
-	// Reset the existing Nodes - so colors are all reset to zero
-	for (int32 UpdatedNode : UpdatedNodes)
-	{
-		Nodes[UpdatedNode].NextColor = 0;
-		Nodes[UpdatedNode].UsedColors.Empty();
-	}
+	// Written per island for its dynamic nodes only, no need to reset
+	NodeToIslandNode.SetNumUninitialized(ConstraintGraph.Nodes.Num(), /*bAllowShrinking=*/false);
 
-	// edges are not persistent right now so we still reset them
+	// Edges are rebuilt every step, so we still reset them
 	Edges.Reset();
-	IslandData.Reset();
-
 	Edges.SetNum(ConstraintGraph.Edges.Num());
-	IslandData.SetNum(ConstraintGraph.IslandToData.Num());
 
-	UpdatedNodes = ConstraintGraph.GetUpdatedNodes();
+	// Island colors persist, ComputeColor will check if they are still valid
+	IslandData.SetNum(ConstraintGraph.NumIslands());
+
+	// Tag edges with their island up front, so islands colored in parallel can tell which edges of shared static nodes are theirs
+	for (int32 Island = 0; Island < IslandData.Num(); ++Island)
+	{
+		for (const int32 EdgeIndex : ConstraintGraph.GetIslandConstraintData(Island))
+		{
+			Edges[EdgeIndex].Island = Island;
+		}
+	}
 }
 
 void FPBDConstraintColor::ComputeColor(const int32 Island, const FPBDConstraintGraph& ConstraintGraph, uint32 ContainerId)
 {
 	SCOPE_CYCLE_COUNTER(STAT_Constraint_ComputeColor);
+
+	// Same particles and constraints as last time we colored this island, keep the colors
+	if (UpdateIslandKey(Island, ConstraintGraph, ContainerId))
+	{
+		INC_DWORD_STAT(STAT_Constraint_NumIslandsReused);
+		return;
+	}
+	INC_DWORD_STAT(STAT_Constraint_NumIslandsColored);
+
 	if (bUseContactGraph)
 	{
 		ComputeContactGraph(Island, ConstraintGraph, ContainerId);
 	}
 	else
 	{
-		for (FGraphEdgeColor& Edge : Edges)
+		for (const int32 EdgeIndex : ConstraintGraph.GetIslandConstraintData(Island))
 		{
-			Edge.Level = 0;
+			Edges[EdgeIndex].Level = 0;
 		}
 		IslandData[Island].MaxLevel = 0;
 	}
 	ComputeIslandColoring(Island, ConstraintGraph, ContainerId);
+	BuildIslandConstraintLists(Island, ConstraintGraph, ContainerId);
+	IslandData[Island].bUsedContactGraph = bUseContactGraph;
 }
 
-const typename FPBDConstraintColor::FLevelToColorToConstraintListMap& FPBDConstraintColor::GetIslandLevelToColorToConstraintListMap(int32 Island) const
+const typename FPBDConstraintColor::FConstraintList& FPBDConstraintColor::GetIslandConstraints(int32 Island, int32 Level, int32 Color) const
 {
 	if (Island < IslandData.Num())
 	{
-		return IslandData[Island].LevelToColorToConstraintListMap;
+		const FIslandColor& IslandColor = IslandData[Island];
+		if (Level >= 0 && Level <= IslandColor.MaxLevel && Color >= 0 && Color <= IslandColor.MaxColor)
+		{
+			return IslandColor.LevelColorConstraints[Level * (IslandColor.MaxColor + 1) + Color];
+		}
 	}
-	return EmptyLevelToColorToConstraintListMap;
+	return EmptyConstraintList;
 }
 
 int FPBDConstraintColor::GetIslandMaxColor(int32 Island) const
@@ -52,6 +52,9 @@ float BoundsThicknessVelocityMultiplier = 2.0f;
 FAutoConsoleVariableRef CVarBoundsThickness(TEXT("p.CollisionBoundsThickness"), BoundsThickness, TEXT("Collision inflation for speculative contact generation.[def:0.0]"));
 FAutoConsoleVariableRef CVarBoundsThicknessVelocityMultiplier(TEXT("p.CollisionBoundsVelocityInflation"), BoundsThicknessVelocityMultiplier, TEXT("Collision velocity inflation for speculatibe contact generation.[def:2.0]"));
 
+int32 MaxIslandSolveThreads = 0;
+FAutoConsoleVariableRef CVarMaxIslandSolveThreads(TEXT("p.Chaos.MaxIslandSolveThreads"), MaxIslandSolveThreads, TEXT("Maximum number of threads solving islands in parallel, 0 to use all worker threads. [def:0]"));
+
 float HackCCD_EnableThreshold = 0.0f;
 FAutoConsoleVariableRef CVarHackCCDVelThreshold(TEXT("p.Chaos.CCD.EnableThreshold"), HackCCD_EnableThreshold, TEXT("If distance moved is greater than this times the minimum object dimension, use CCD"));
 
@@ -326,6 +329,18 @@ void FPBDRigidsEvolutionGBF::AdvanceOneTimeStep(const FReal Dt, const FReal Step
 		PreApplyCallback();
 	}
 
+	// Solve the most expensive islands first, so that no thread is left alone with a big island at the end of the solve
+	IslandSolveOrder.SetNumUninitialized(GetConstraintGraph().NumIslands(), /*bAllowShrinking=*/false);
+	for (int32 Island = 0; Island < IslandSolveOrder.Num(); ++Island)
+	{
+		IslandSolveOrder[Island] = Island;
+	}
+	const FPBDConstraintGraph& Graph = GetConstraintGraph();
+	IslandSolveOrder.Sort([&Graph](const int32 L, const int32 R)
+	{
+		return (Graph.GetIslandConstraintData(L).Num() + Graph.GetIslandParticles(L).Num()) > (Graph.GetIslandConstraintData(R).Num() + Graph.GetIslandParticles(R).Num());
+	});
+
 	TArray<bool> SleepedIslands;
 	SleepedIslands.SetNum(GetConstraintGraph().NumIslands());
 	TArray<TArray<TPBDRigidParticleHandle<FReal, 3>*>> DisabledParticles;
@@ -334,7 +349,8 @@ void FPBDRigidsEvolutionGBF::AdvanceOneTimeStep(const FReal Dt, const FReal Step
 	if(Dt > 0)
 	{
 		SCOPE_CYCLE_COUNTER(STAT_Evolution_ParallelSolve);
-		PhysicsParallelFor(GetConstraintGraph().NumIslands(), [&](int32 Island) {
+		PhysicsParallelForWorkQueue(IslandSolveOrder.Num(), [&](int32 SolveIndex) {
+			const int32 Island = IslandSolveOrder[SolveIndex];
 			const TArray<TGeometryParticleHandle<FReal, 3>*>& IslandParticles = GetConstraintGraph().GetIslandParticles(Island);
 
 			{
@@ -397,7 +413,7 @@ void FPBDRigidsEvolutionGBF::AdvanceOneTimeStep(const FReal Dt, const FReal Step
 
 			// Turn off if not moving
 			SleepedIslands[Island] = GetConstraintGraph().SleepInactive(Island, PhysicsMaterials);
-		});
+		}, MaxIslandSolveThreads);
 	}
 
 	{
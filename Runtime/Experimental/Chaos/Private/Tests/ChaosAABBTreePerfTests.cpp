@@ -0,0 +1,263 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "ChaosLog.h"
+#include "Chaos/AABBTree.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * AABB tree benchmark: 100k dynamic bodies, measures overlap and raycast throughput with binary and wide node traversal,
+ * batched raycasts, and update throughput with dirty elements and full rebuilds vs incremental updates. Run headless with e.g.
+ *   UE4Editor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests System.Chaos.AABBTreePerf; Quit"
+ */
+namespace ChaosAABBTreePerfTestsPrivate
+{
+	using namespace Chaos;
+
+	using FTree = TAABBTree<int32, TAABBTreeLeafArray<int32, FReal>, FReal>;
+	using FElement = TPayloadBoundsElement<int32, FReal>;
+
+	static const int32 NumBodies = 100000;
+	static const FReal WorldHalfSize = 10000.0f;
+	static const FReal BodyHalfSize = 50.0f;
+
+	static const int32 NumQueries = 20000;
+	static const int32 NumVerifiedQueries = 500;
+	static const FReal QueryHalfSize = 200.0f;
+	static const FReal RayLength = 2000.0f;
+
+	static const int32 NumUpdateSteps = 10;
+	static const FReal MaxStepMotion = 20.0f;
+
+	struct FCountingVisitor
+	{
+		bool VisitOverlap(const TSpatialVisitorData<int32>& Instance)
+		{
+			++NumHits;
+			return true;
+		}
+
+		bool VisitRaycast(const TSpatialVisitorData<int32>& Instance, FQueryFastData& CurData)
+		{
+			++NumHits;
+			return true;
+		}
+
+		bool VisitSweep(const TSpatialVisitorData<int32>& Instance, FQueryFastData& CurData)
+		{
+			++NumHits;
+			return true;
+		}
+
+		const void* GetQueryData() const { return nullptr; }
+
+		int32 NumHits = 0;
+	};
+
+	FVec3 RandomPoint(FRandomStream& RandomStream, FReal HalfSize)
+	{
+		return FVec3(RandomStream.FRandRange(-HalfSize, HalfSize), RandomStream.FRandRange(-HalfSize, HalfSize), RandomStream.FRandRange(-HalfSize, HalfSize));
+	}
+
+	TAABB<FReal, 3> MakeBounds(const FVec3& Center, FReal HalfSize)
+	{
+		return TAABB<FReal, 3>(Center - FVec3(HalfSize), Center + FVec3(HalfSize));
+	}
+
+	struct FQueries
+	{
+		TArray<TAABB<FReal, 3>> Bounds;
+		TArray<FVec3> Starts;
+		TArray<FVec3> Dirs;
+		TArray<FReal> Lengths;
+	};
+
+	FQueries MakeQueries(FRandomStream& RandomStream)
+	{
+		FQueries Queries;
+		for (int32 QueryIdx = 0; QueryIdx < NumQueries; ++QueryIdx)
+		{
+			Queries.Bounds.Add(MakeBounds(RandomPoint(RandomStream, WorldHalfSize), QueryHalfSize));
+			Queries.Starts.Add(RandomPoint(RandomStream, WorldHalfSize));
+			Queries.Dirs.Add(FVec3(RandomStream.GetUnitVector()));
+			Queries.Lengths.Add(RayLength);
+		}
+		return Queries;
+	}
+
+	/** Returns time spent in seconds, total number of hits in OutNumHits */
+	double RunOverlaps(const FTree& Tree, const FQueries& Queries, int32& OutNumHits)
+	{
+		double Seconds = 0.0;
+		FDurationTimer Timer(Seconds);
+		FCountingVisitor Visitor;
+		for (const TAABB<FReal, 3>& QueryBounds : Queries.Bounds)
+		{
+			Tree.Overlap(QueryBounds, Visitor);
+		}
+		Timer.Stop();
+
+		OutNumHits = Visitor.NumHits;
+		return Seconds;
+	}
+
+	double RunRaycasts(const FTree& Tree, const FQueries& Queries, int32& OutNumHits)
+	{
+		double Seconds = 0.0;
+		FDurationTimer Timer(Seconds);
+		FCountingVisitor Visitor;
+		for (int32 QueryIdx = 0; QueryIdx < NumQueries; ++QueryIdx)
+		{
+			Tree.Raycast(Queries.Starts[QueryIdx], Queries.Dirs[QueryIdx], Queries.Lengths[QueryIdx], Visitor);
+		}
+		Timer.Stop();
+
+		OutNumHits = Visitor.NumHits;
+		return Seconds;
+	}
+
+	double RunRaycastBatch(const FTree& Tree, const FQueries& Queries, int32& OutNumHits)
+	{
+		TArray<FCountingVisitor> Visitors;
+		Visitors.AddDefaulted(NumQueries);
+
+		double Seconds = 0.0;
+		FDurationTimer Timer(Seconds);
+		Tree.RaycastBatch(MakeArrayView(Queries.Starts), MakeArrayView(Queries.Dirs), MakeArrayView(Queries.Lengths), MakeArrayView(Visitors));
+		Timer.Stop();
+
+		OutNumHits = 0;
+		for (const FCountingVisitor& Visitor : Visitors)
+		{
+			OutNumHits += Visitor.NumHits;
+		}
+		return Seconds;
+	}
+
+	/** Moves every body a little and updates the tree, returns time spent in seconds */
+	double RunUpdates(FTree& Tree, TArray<FElement>& Elements, FRandomStream& RandomStream)
+	{
+		double Seconds = 0.0;
+		for (int32 Step = 0; Step < NumUpdateSteps; ++Step)
+		{
+			for (FElement& Elem : Elements)
+			{
+				const FVec3 Motion = RandomPoint(RandomStream, MaxStepMotion);
+				Elem.Bounds = TAABB<FReal, 3>(Elem.Bounds.Min() + Motion, Elem.Bounds.Max() + Motion);
+			}
+
+			FDurationTimer Timer(Seconds);
+			for (const FElement& Elem : Elements)
+			{
+				Tree.UpdateElement(Elem.Payload, Elem.Bounds, true);
+			}
+			Timer.Stop();
+		}
+		return Seconds;
+	}
+
+	/** Checks overlaps found by the tree against testing every body */
+	bool VerifyOverlaps(FAutomationTestBase& Test, const FTree& Tree, const TArray<FElement>& Elements, const FQueries& Queries)
+	{
+		for (int32 QueryIdx = 0; QueryIdx < NumVerifiedQueries; ++QueryIdx)
+		{
+			const TAABB<FReal, 3>& QueryBounds = Queries.Bounds[QueryIdx];
+			TArray<int32> Expected;
+			for (const FElement& Elem : Elements)
+			{
+				if (Elem.Bounds.Intersects(QueryBounds))
+				{
+					Expected.Add(Elem.Payload);
+				}
+			}
+
+			TArray<int32> Found = Tree.FindAllIntersections(QueryBounds);
+			Expected.Sort();
+			Found.Sort();
+			if (Found != Expected)
+			{
+				Test.AddError(FString::Printf(TEXT("Overlap %d: tree found %d bodies, expected %d"), QueryIdx, Found.Num(), Expected.Num()));
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChaosAABBTreePerfTest, "System.Chaos.AABBTreePerf", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FChaosAABBTreePerfTest::RunTest(const FString& Parameters)
+{
+	using namespace ChaosAABBTreePerfTestsPrivate;
+
+	TGuardValue<int32> WideNodeQueriesGuard(FAABBTreeCVars::WideNodeQueries, FAABBTreeCVars::WideNodeQueries);
+	TGuardValue<int32> IncrementalUpdateGuard(FAABBTreeCVars::IncrementalUpdate, FAABBTreeCVars::IncrementalUpdate);
+
+	FRandomStream RandomStream(0x41414254);
+	TArray<FElement> Elements;
+	Elements.Reserve(NumBodies);
+	for (int32 BodyIdx = 0; BodyIdx < NumBodies; ++BodyIdx)
+	{
+		Elements.Add(FElement{ BodyIdx, MakeBounds(RandomPoint(RandomStream, WorldHalfSize), BodyHalfSize) });
+	}
+	const FQueries Queries = MakeQueries(RandomStream);
+
+	double BuildSeconds = 0.0;
+	FDurationTimer BuildTimer(BuildSeconds);
+	FTree Tree(Elements);
+	BuildTimer.Stop();
+
+	// Queries, binary nodes vs wide nodes
+	int32 NumHits[2];
+	FAABBTreeCVars::WideNodeQueries = 0;
+	const double OverlapSeconds = RunOverlaps(Tree, Queries, NumHits[0]);
+	FAABBTreeCVars::WideNodeQueries = 1;
+	const double WideOverlapSeconds = RunOverlaps(Tree, Queries, NumHits[1]);
+	TestEqual(TEXT("Overlap hits with wide nodes"), NumHits[1], NumHits[0]);
+
+	FAABBTreeCVars::WideNodeQueries = 0;
+	const double RaycastSeconds = RunRaycasts(Tree, Queries, NumHits[0]);
+	FAABBTreeCVars::WideNodeQueries = 1;
+	const double WideRaycastSeconds = RunRaycasts(Tree, Queries, NumHits[1]);
+	TestEqual(TEXT("Raycast hits with wide nodes"), NumHits[1], NumHits[0]);
+	const double BatchRaycastSeconds = RunRaycastBatch(Tree, Queries, NumHits[1]);
+	TestEqual(TEXT("Raycast hits in batch"), NumHits[1], NumHits[0]);
+
+	// Updates, dirty elements and full rebuilds vs incremental
+	double UpdateSeconds[2];
+	double UpdatedOverlapSeconds[2];
+	for (int32 Incremental = 0; Incremental < 2; ++Incremental)
+	{
+		FAABBTreeCVars::IncrementalUpdate = Incremental;
+
+		TArray<FElement> MovingElements = Elements;
+		FTree MovingTree(MovingElements);
+		FRandomStream MotionStream(0x4d4f5645);
+		UpdateSeconds[Incremental] = RunUpdates(MovingTree, MovingElements, MotionStream);
+		UpdatedOverlapSeconds[Incremental] = RunOverlaps(MovingTree, Queries, NumHits[Incremental]);
+
+		if (!VerifyOverlaps(*this, MovingTree, MovingElements, Queries))
+		{
+			return false;
+		}
+	}
+	TestEqual(TEXT("Overlap hits after incremental updates"), NumHits[1], NumHits[0]);
+
+	const int32 NumUpdates = NumBodies * NumUpdateSteps;
+	const FString Summary = FString::Printf(TEXT("%d bodies, build %.1f ms. Overlaps/s: binary %.0f, wide %.0f (%.2fx). Raycasts/s: binary %.0f, wide %.0f (%.2fx), batch %.0f (%.2fx). ")
+		TEXT("Updates/s: dirty elements %.0f, incremental %.0f (%.2fx). Overlaps/s after updates: dirty elements %.0f, incremental %.0f"),
+		NumBodies, BuildSeconds * 1000.0,
+		NumQueries / OverlapSeconds, NumQueries / WideOverlapSeconds, OverlapSeconds / WideOverlapSeconds,
+		NumQueries / RaycastSeconds, NumQueries / WideRaycastSeconds, RaycastSeconds / WideRaycastSeconds, NumQueries / BatchRaycastSeconds, RaycastSeconds / BatchRaycastSeconds,
+		NumUpdates / UpdateSeconds[0], NumUpdates / UpdateSeconds[1], UpdateSeconds[0] / UpdateSeconds[1],
+		NumQueries / UpdatedOverlapSeconds[0], NumQueries / UpdatedOverlapSeconds[1]);
+	UE_LOG(LogChaos, Display, TEXT("%s"), *Summary);
+	AddInfo(Summary);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,357 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/IConsoleManager.h"
+#include "ChaosLog.h"
+#include "Chaos/ChaosPerfTest.h"
+#include "Chaos/Box.h"
+#include "Chaos/PBDRigidsSOAs.h"
+#include "Chaos/PBDRigidsEvolutionGBF.h"
+#include "Chaos/PBDJointConstraints.h"
+#include "Chaos/PBDConstraintRule.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Solver benchmarks: steps a few typical scenes with the solver limited to 1..N threads and reports milliseconds per step.
+ * No world nor rendering is needed, run headless with e.g.
+ *   UE4Editor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests System.Chaos.SolverPerf; Quit"
+ */
+namespace ChaosSolverPerfTestsPrivate
+{
+	using namespace Chaos;
+
+	static const FReal Dt = 1.0f / 60.0f;
+	static const int32 NumWarmupSteps = 10;
+	static const int32 NumMeasuredSteps = 60;
+
+	static const FReal BoxSize = 100.0f;
+
+	struct FSolverPerfScene
+	{
+		FSolverPerfScene()
+			: JointsRule(Joints)
+			, Material(MakeUnique<FChaosPhysicsMaterial>())
+			, Evolution(Particles)
+		{
+			// keep everything awake, so every measured step solves the whole scene
+			Material->SleepingLinearThreshold = 0;
+			Material->SleepingAngularThreshold = 0;
+
+			Evolution.AddConstraintRule(&JointsRule);
+		}
+
+		TPBDRigidsSOAs<FReal, 3> Particles;
+		FPBDJointConstraints Joints;
+		TPBDConstraintIslandRule<FPBDJointConstraints> JointsRule;
+		TUniquePtr<FChaosPhysicsMaterial> Material;
+		FPBDRigidsEvolutionGBF Evolution;
+	};
+
+	TSharedPtr<FImplicitObject, ESPMode::ThreadSafe> MakeBox(const FVec3& HalfExtents)
+	{
+		return TSharedPtr<FImplicitObject, ESPMode::ThreadSafe>(new TBox<FReal, 3>(-HalfExtents, HalfExtents));
+	}
+
+	void SetGeometry(TGeometryParticleHandle<FReal, 3>* Handle, TSharedPtr<FImplicitObject, ESPMode::ThreadSafe> Geometry)
+	{
+		Handle->SetSharedGeometry(Geometry);
+		Handle->SetHasBounds(true);
+		Handle->SetLocalBounds(Geometry->BoundingBox());
+		Handle->SetWorldSpaceInflatedBounds(Geometry->BoundingBox().TransformedAABB(FRigidTransform3(Handle->X(), Handle->R())));
+	}
+
+	void AddGround(FSolverPerfScene& Scene, FReal HalfSize)
+	{
+		TGeometryParticleHandle<FReal, 3>* Ground = Scene.Particles.CreateStaticParticles(1)[0];
+		Ground->SetX(FVec3(0, 0, -BoxSize * 0.5f));
+		Ground->SetR(FRotation3::Identity);
+		SetGeometry(Ground, MakeBox(FVec3(HalfSize, HalfSize, BoxSize * 0.5f)));
+		Scene.Evolution.SetPhysicsMaterial(Ground, MakeSerializable(Scene.Material));
+		Scene.Evolution.CreateParticle(Ground);
+	}
+
+	/** Same setup as geometry collection particles: position, unit density mass and box inertia, geometry and material */
+	void InitDynamicBox(FSolverPerfScene& Scene, TPBDRigidParticleHandle<FReal, 3>* Handle, const FVec3& X, TSharedPtr<FImplicitObject, ESPMode::ThreadSafe> Geometry, const FRotation3& R = FRotation3::Identity)
+	{
+		Handle->SetX(X);
+		Handle->SetV(FVec3(0));
+		Handle->SetR(R);
+		Handle->SetW(FVec3(0));
+		Handle->SetP(Handle->X());
+		Handle->SetQ(Handle->R());
+
+		const FVec3 Size = Geometry->BoundingBox().Extents();
+		const FReal Mass = Size.X * Size.Y * Size.Z * 0.001f;
+		Handle->SetM(Mass);
+		Handle->SetI(PMatrix<FReal, 3, 3>(
+			Mass * (Size.Y * Size.Y + Size.Z * Size.Z) / 12.0f,
+			Mass * (Size.X * Size.X + Size.Z * Size.Z) / 12.0f,
+			Mass * (Size.X * Size.X + Size.Y * Size.Y) / 12.0f));
+		Handle->SetObjectStateLowLevel(EObjectStateType::Dynamic);
+
+		SetGeometry(Handle, Geometry);
+		Scene.Evolution.SetPhysicsMaterial(Handle, MakeSerializable(Scene.Material));
+		Scene.Evolution.CreateParticle(Handle);
+	}
+
+	/** NumTowers x NumTowers towers of boxes stacked on the ground, each tower is a separate island */
+	void BuildStacks(FSolverPerfScene& Scene)
+	{
+		const int32 NumTowers = 8;
+		const int32 TowerHeight = 10;
+		const FReal Spacing = BoxSize * 2.0f;
+
+		AddGround(Scene, NumTowers * Spacing);
+
+		TSharedPtr<FImplicitObject, ESPMode::ThreadSafe> Box = MakeBox(FVec3(BoxSize * 0.5f));
+		TArray<TPBDRigidParticleHandle<FReal, 3>*> Boxes = Scene.Particles.CreateDynamicParticles(NumTowers * NumTowers * TowerHeight);
+		for (int32 Index = 0; Index < Boxes.Num(); Index++)
+		{
+			const int32 Tower = Index / TowerHeight;
+			const int32 Level = Index % TowerHeight;
+			const FVec3 X(((Tower % NumTowers) - NumTowers / 2) * Spacing, ((Tower / NumTowers) - NumTowers / 2) * Spacing, (Level + 0.5f) * BoxSize);
+			InitDynamicBox(Scene, Boxes[Index], X, Box);
+		}
+	}
+
+	/** Chains of jointed boxes, piled in layers on top of each other so they end up in a few large islands */
+	void BuildRagdollPiles(FSolverPerfScene& Scene)
+	{
+		const int32 NumPiles = 4;
+		const int32 RagdollsPerPile = 16;
+		const int32 NumLinks = 8;
+		const FVec3 LinkHalfExtents(BoxSize * 0.2f, BoxSize * 0.2f, BoxSize * 0.4f);
+		const FReal LinkLength = LinkHalfExtents.Z * 2.0f + 10.0f;
+		const FReal PileSpacing = LinkLength * NumLinks * 1.5f;
+
+		AddGround(Scene, NumPiles * PileSpacing);
+
+		TSharedPtr<FImplicitObject, ESPMode::ThreadSafe> Link = MakeBox(LinkHalfExtents);
+		TArray<TPBDRigidParticleHandle<FReal, 3>*> Links = Scene.Particles.CreateDynamicParticles(NumPiles * RagdollsPerPile * NumLinks);
+		for (int32 Index = 0; Index < Links.Num(); Index++)
+		{
+			const int32 Ragdoll = Index / NumLinks;
+			const int32 LinkIndex = Index % NumLinks;
+			const int32 Pile = Ragdoll / RagdollsPerPile;
+			const int32 Layer = Ragdoll % RagdollsPerPile;
+
+			// chains lie flat, alternating between X and Y in every layer
+			const FVec3 Along = (Layer % 2) ? FVec3(0, 1, 0) : FVec3(1, 0, 0);
+			const FVec3 PileCenter((Pile - NumPiles / 2) * PileSpacing, 0, (Layer + 0.5f) * BoxSize);
+			const FVec3 X = PileCenter + Along * ((LinkIndex - NumLinks / 2) * LinkLength);
+			InitDynamicBox(Scene, Links[Index], X, Link, FRotation3::FromRotatedVector(FVec3(0, 0, 1), Along));
+
+			if (LinkIndex > 0)
+			{
+				TPBDRigidParticleHandle<FReal, 3>* Parent = Links[Index - 1];
+				const FVec3 JointX = (Parent->X() + Links[Index]->X()) * 0.5f;
+				Scene.Joints.AddConstraint(FPBDJointConstraints::FParticlePair(Parent, Links[Index]), FRigidTransform3(JointX, FRotation3::Identity));
+			}
+		}
+	}
+
+	/** Clusters of small boxes with low strain, dropped on the ground so they break apart on impact */
+	void BuildFracture(FSolverPerfScene& Scene)
+	{
+		const int32 NumClusters = 8;
+		const int32 PiecesPerSide = 4;
+		const FReal PieceSize = BoxSize * 0.25f;
+		const FReal DropHeight = BoxSize * 3.0f;
+		const FReal Spacing = PiecesPerSide * PieceSize * 2.0f;
+
+		AddGround(Scene, NumClusters * Spacing);
+
+		TSharedPtr<FImplicitObject, ESPMode::ThreadSafe> Piece = MakeBox(FVec3(PieceSize * 0.5f));
+		for (int32 Cluster = 0; Cluster < NumClusters; Cluster++)
+		{
+			const FVec3 ClusterCorner((Cluster - NumClusters / 2) * Spacing, 0, DropHeight);
+
+			TArray<TPBDRigidClusteredParticleHandle<FReal, 3>*> Pieces = Scene.Particles.CreateClusteredParticles(PiecesPerSide * PiecesPerSide * PiecesPerSide);
+			TArray<TPBDRigidParticleHandle<FReal, 3>*> Children;
+			for (int32 Index = 0; Index < Pieces.Num(); Index++)
+			{
+				const FVec3 Cell(Index % PiecesPerSide, (Index / PiecesPerSide) % PiecesPerSide, Index / (PiecesPerSide * PiecesPerSide));
+				InitDynamicBox(Scene, Pieces[Index], ClusterCorner + (Cell + FVec3(0.5f)) * PieceSize, Piece);
+				Pieces[Index]->SetStrain(1.0f);
+				Children.Add(Pieces[Index]);
+			}
+
+			Scene.Evolution.GetRigidClustering().CreateClusterParticle(0, MoveTemp(Children));
+		}
+	}
+
+	struct FCVarOverride
+	{
+		FCVarOverride(const TCHAR* Name)
+			: CVar(IConsoleManager::Get().FindConsoleVariable(Name))
+			, PreviousValue(CVar ? CVar->GetInt() : 0)
+		{
+		}
+
+		~FCVarOverride()
+		{
+			Set(PreviousValue);
+		}
+
+		void Set(int32 Value)
+		{
+			if (CVar)
+			{
+				CVar->Set(Value, ECVF_SetByCode);
+			}
+		}
+
+		IConsoleVariable* CVar;
+		int32 PreviousValue;
+	};
+
+	/** Builds a fresh scene for every thread count, so all of them step through the same simulation, and reports ms per step */
+	bool RunSolverPerfTest(FAutomationTestBase& Test, const TCHAR* SceneName, TFunctionRef<void(FSolverPerfScene&)> BuildScene)
+	{
+		// parallel fors can't be limited to a number of threads, single threaded run disables them (not available in shipping),
+		// multithreaded runs limit threads solving islands, which is where most of the step is spent
+		FCVarOverride DisablePhysicsParallelFor(TEXT("p.Chaos.DisablePhysicsParallelFor"));
+		FCVarOverride DisableParticleParallelFor(TEXT("p.Chaos.DisableParticleParallelFor"));
+		FCVarOverride MaxIslandSolveThreads(TEXT("p.Chaos.MaxIslandSolveThreads"));
+
+		const int32 MaxThreads = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+		TArray<int32> ThreadCounts;
+		for (int32 NumThreads = 1; NumThreads < MaxThreads; NumThreads *= 2)
+		{
+			ThreadCounts.Add(NumThreads);
+		}
+		ThreadCounts.Add(MaxThreads);
+
+		FString Summary = FString::Printf(TEXT("%s:"), SceneName);
+		double SingleThreadMs = 0.0;
+		for (const int32 NumThreads : ThreadCounts)
+		{
+			DisablePhysicsParallelFor.Set(NumThreads == 1 ? 1 : 0);
+			DisableParticleParallelFor.Set(NumThreads == 1 ? 1 : 0);
+			MaxIslandSolveThreads.Set(NumThreads == 1 ? 0 : NumThreads);
+
+			FSolverPerfScene Scene;
+			BuildScene(Scene);
+			if (!Test.TestTrue(TEXT("Scene has dynamic particles"), Scene.Particles.GetActiveParticlesView().Num() > 0))
+			{
+				return false;
+			}
+
+			for (int32 Step = 0; Step < NumWarmupSteps; Step++)
+			{
+				Scene.Evolution.AdvanceOneTimeStep(Dt);
+			}
+
+			double Seconds = 0.0;
+			{
+				FDurationTimer Timer(Seconds);
+				for (int32 Step = 0; Step < NumMeasuredSteps; Step++)
+				{
+					Scene.Evolution.AdvanceOneTimeStep(Dt);
+				}
+				Timer.Stop();
+			}
+
+			const double StepMs = Seconds * 1000.0 / NumMeasuredSteps;
+			SingleThreadMs = (NumThreads == 1) ? StepMs : SingleThreadMs;
+			UE_LOG(LogChaos, Display, TEXT("%s, %d thread(s): %.3f ms/step"), SceneName, NumThreads, StepMs);
+			Summary += FString::Printf(TEXT(" %d thread(s) %.3f ms/step (%.2fx)"), NumThreads, StepMs, SingleThreadMs / StepMs);
+
+			// one more step with phase timers logged
+			{
+				CHAOS_PERF_TEST(ChaosSolverPerf, EChaosPerfUnits::Ms);
+				Scene.Evolution.AdvanceOneTimeStep(Dt);
+			}
+		}
+
+		UE_LOG(LogChaos, Display, TEXT("%s"), *Summary);
+		Test.AddInfo(Summary);
+		return true;
+	}
+
+	/** Steps the scene and sums up contact cache stats of all measured steps, returns ms per step */
+	double RunContactCacheSteps(FSolverPerfScene& Scene, FCollisionCacheStats& OutStats)
+	{
+		for (int32 Step = 0; Step < NumWarmupSteps; Step++)
+		{
+			Scene.Evolution.AdvanceOneTimeStep(Dt);
+		}
+
+		double Seconds = 0.0;
+		FDurationTimer Timer(Seconds);
+		for (int32 Step = 0; Step < NumMeasuredSteps; Step++)
+		{
+			Scene.Evolution.AdvanceOneTimeStep(Dt);
+
+			const FCollisionCacheStats& StepStats = Scene.Evolution.GetCollisionConstraints().GetContactCacheStats();
+			OutStats.NumHits += StepStats.NumHits;
+			OutStats.NumMisses += StepStats.NumMisses;
+			OutStats.NarrowPhaseSeconds += StepStats.NarrowPhaseSeconds;
+		}
+		Timer.Stop();
+
+		return Seconds * 1000.0 / NumMeasuredSteps;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChaosSolverPerfStacksTest, "System.Chaos.SolverPerf.Stacks", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FChaosSolverPerfStacksTest::RunTest(const FString& Parameters)
+{
+	using namespace ChaosSolverPerfTestsPrivate;
+	return RunSolverPerfTest(*this, TEXT("Stacks"), BuildStacks);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChaosSolverPerfRagdollPilesTest, "System.Chaos.SolverPerf.RagdollPiles", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FChaosSolverPerfRagdollPilesTest::RunTest(const FString& Parameters)
+{
+	using namespace ChaosSolverPerfTestsPrivate;
+	return RunSolverPerfTest(*this, TEXT("RagdollPiles"), BuildRagdollPiles);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChaosSolverPerfFractureTest, "System.Chaos.SolverPerf.Fracture", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FChaosSolverPerfFractureTest::RunTest(const FString& Parameters)
+{
+	using namespace ChaosSolverPerfTestsPrivate;
+	return RunSolverPerfTest(*this, TEXT("Fracture"), BuildFracture);
+}
+
+/**
+ * Steps resting stacks with the contact cache disabled and enabled, reports narrow phase time and cache hit rate.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChaosSolverPerfContactCacheTest, "System.Chaos.SolverPerf.ContactCache", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FChaosSolverPerfContactCacheTest::RunTest(const FString& Parameters)
+{
+	using namespace ChaosSolverPerfTestsPrivate;
+
+	FCVarOverride ContactCacheEnabled(TEXT("p.Chaos.Collision.ContactCache.Enabled"));
+
+	FCollisionCacheStats Stats[2];
+	double StepMs[2];
+	for (int32 Enabled = 0; Enabled < 2; Enabled++)
+	{
+		ContactCacheEnabled.Set(Enabled);
+
+		FSolverPerfScene Scene;
+		BuildStacks(Scene);
+		StepMs[Enabled] = RunContactCacheSteps(Scene, Stats[Enabled]);
+	}
+
+	TestEqual(TEXT("Contact cache hits when disabled"), Stats[0].NumHits, 0);
+	TestTrue(TEXT("Contact cache hits when enabled"), Stats[1].NumHits > 0);
+
+	const FString Summary = FString::Printf(TEXT("Stacks: without contact cache %.3f ms/step, narrow phase %.3f ms/step, with contact cache %.3f ms/step, narrow phase %.3f ms/step, hit rate %.1f%%"),
+		StepMs[0], Stats[0].NarrowPhaseSeconds * 1000.0 / NumMeasuredSteps,
+		StepMs[1], Stats[1].NarrowPhaseSeconds * 1000.0 / NumMeasuredSteps, Stats[1].GetHitRate() * 100.0f);
+	UE_LOG(LogChaos, Display, TEXT("%s"), *Summary);
+	AddInfo(Summary);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -9,11 +9,18 @@
 #include "Chaos/ISpatialAcceleration.h"
 #include "Templates/Models.h"
 #include "Chaos/BoundingVolume.h"
+#include "Chaos/Framework/Parallel.h"
 
 struct FAABBTreeCVars
 {
 	static int32 UpdateDirtyElementPayloadData;
 	static FAutoConsoleVariableRef CVarUpdateDirtyElementPayloadData;
+
+	static int32 IncrementalUpdate;
+	static FAutoConsoleVariableRef CVarIncrementalUpdate;
+
+	static int32 WideNodeQueries;
+	static FAutoConsoleVariableRef CVarWideNodeQueries;
 };
 
 namespace Chaos
@@ -199,6 +206,26 @@ struct TAABBTreeLeafArray : public TBoundsWrapperHelper<TPayloadType, T, bComput
 		}
 	}
 
+	void AddElement(const TPayloadBoundsElement<TPayloadType, T>& Elem)
+	{
+		Elems.Add(Elem);
+	}
+
+	int32 NumElements() const
+	{
+		return Elems.Num();
+	}
+
+	TAABB<T, 3> ComputeElementsBounds() const
+	{
+		TAABB<T, 3> ElemsBounds = TAABB<T, 3>::EmptyAABB();
+		for (const auto& Elem : Elems)
+		{
+			ElemsBounds.GrowToInclude(Elem.Bounds);
+		}
+		return ElemsBounds;
+	}
+
 	const TAABB<T, 3>& GetBounds() const
 	{
 		return Bounds;
@@ -255,6 +282,104 @@ FChaosArchive& operator<<(FChaosArchive& Ar, TAABBTreeNode<T>& Node)
 	return Ar;
 }
 
+/**
+ * Children of two levels of binary nodes with bounds stored per axis, so a query tests all four of them at once.
+ * Built from TAABBTreeNode once the tree is generated and refit along with it, see TAABBTree::BuildWideNodes.
+ */
+struct FAABBTreeWideNode
+{
+	static constexpr int32 NumLanes = 4;
+
+	FAABBTreeWideNode()
+		: ValidLanes(0)
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			Min[Axis] = VectorSetFloat1(TNumericLimits<float>::Max());
+			Max[Axis] = VectorSetFloat1(-TNumericLimits<float>::Max());
+		}
+
+		for (int32& ChildNode : ChildrenNodes)
+		{
+			ChildNode = INDEX_NONE;
+		}
+	}
+
+	template <typename T>
+	void SetLane(const int32 Lane, const TAABB<T, 3>& Bounds, const int32 ChildNode)
+	{
+		SetLaneBounds(Lane, Bounds);
+		ChildrenNodes[Lane] = ChildNode;
+		ValidLanes |= (1 << Lane);
+	}
+
+	template <typename T>
+	void SetLaneBounds(const int32 Lane, const TAABB<T, 3>& Bounds)
+	{
+		MS_ALIGN(16) float Values[NumLanes] GCC_ALIGN(16);
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			VectorStoreAligned(Min[Axis], Values);
+			Values[Lane] = (float)Bounds.Min()[Axis];
+			Min[Axis] = VectorLoadAligned(Values);
+
+			VectorStoreAligned(Max[Axis], Values);
+			Values[Lane] = (float)Bounds.Max()[Axis];
+			Max[Axis] = VectorLoadAligned(Values);
+		}
+	}
+
+	/** Returns mask of the lanes overlapping query bounds, given as splatted min and max per axis */
+	FORCEINLINE_DEBUGGABLE int32 Overlap(const VectorRegister* QueryMin, const VectorRegister* QueryMax) const
+	{
+		VectorRegister Mask = VectorBitwiseAnd(VectorCompareLE(QueryMin[0], Max[0]), VectorCompareGE(QueryMax[0], Min[0]));
+		Mask = VectorBitwiseAnd(Mask, VectorBitwiseAnd(VectorCompareLE(QueryMin[1], Max[1]), VectorCompareGE(QueryMax[1], Min[1])));
+		Mask = VectorBitwiseAnd(Mask, VectorBitwiseAnd(VectorCompareLE(QueryMin[2], Max[2]), VectorCompareGE(QueryMax[2], Min[2])));
+		return VectorMaskBits(Mask) & ValidLanes;
+	}
+
+	/**
+	 * Returns mask of the lanes hit by a ray within Length and the time it enters each of them. Lanes are inflated by
+	 * Inflation for sweeps. Same slab test as TAABB::RaycastFast, axes the ray is parallel to only test the start point.
+	 */
+	FORCEINLINE_DEBUGGABLE int32 Raycast(const VectorRegister* Start, const VectorRegister* InvDir, const VectorRegister* Inflation, const bool* bParallel, const VectorRegister& Length, VectorRegister& OutTimes) const
+	{
+		VectorRegister Mask = GlobalVectorConstants::AllMask;
+		VectorRegister StartTime = VectorZero();
+		VectorRegister EndTime = Length;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const VectorRegister BoxMin = VectorSubtract(Min[Axis], Inflation[Axis]);
+			const VectorRegister BoxMax = VectorAdd(Max[Axis], Inflation[Axis]);
+
+			// Empty leaves have inverted bounds
+			Mask = VectorBitwiseAnd(Mask, VectorCompareLE(BoxMin, BoxMax));
+			if (bParallel[Axis])
+			{
+				Mask = VectorBitwiseAnd(Mask, VectorBitwiseAnd(VectorCompareLE(BoxMin, Start[Axis]), VectorCompareGE(BoxMax, Start[Axis])));
+			}
+			else
+			{
+				const VectorRegister Time1 = VectorMultiply(VectorSubtract(BoxMin, Start[Axis]), InvDir[Axis]);
+				const VectorRegister Time2 = VectorMultiply(VectorSubtract(BoxMax, Start[Axis]), InvDir[Axis]);
+				StartTime = VectorMax(StartTime, VectorMin(Time1, Time2));
+				EndTime = VectorMin(EndTime, VectorMax(Time1, Time2));
+			}
+		}
+
+		Mask = VectorBitwiseAnd(Mask, VectorCompareLE(StartTime, EndTime));
+		OutTimes = StartTime;
+		return VectorMaskBits(Mask) & ValidLanes;
+	}
+
+	VectorRegister Min[3];
+	VectorRegister Max[3];
+
+	/** Binary node each lane stands for, either a leaf node or a node with a wide node of its own */
+	int32 ChildrenNodes[NumLanes];
+	int32 ValidLanes;
+};
+
 struct FAABBTreePayloadInfo
 {
 	int32 GlobalPayloadIdx;
@@ -304,6 +429,33 @@ static void UpdateElementHelper(T& InElem, const T& InFrom)
 	}
 }
 
+struct CIsIncrementalLeaf
+{
+	template<typename LeafT, typename ElementT>
+	auto Requires(LeafT& InLeaf, const ElementT& InElem) -> decltype(InLeaf.AddElement(InElem));
+};
+
+/** Forwards incremental tree updates to leaves that support adding elements, other leaves always go through the dirty list */
+template <typename TLeafType, typename TElement, typename T, bool bIncremental = TModels<CIsIncrementalLeaf, TLeafType, TElement>::Value>
+struct TAABBTreeIncrementalLeafHelper
+{
+	static constexpr bool bSupported = false;
+
+	static void AddElement(TLeafType& Leaf, const TElement& Elem) { check(false); }
+	static int32 NumElements(const TLeafType& Leaf) { check(false); return 0; }
+	static TAABB<T, 3> ComputeBounds(const TLeafType& Leaf) { check(false); return TAABB<T, 3>::EmptyAABB(); }
+};
+
+template <typename TLeafType, typename TElement, typename T>
+struct TAABBTreeIncrementalLeafHelper<TLeafType, TElement, T, true>
+{
+	static constexpr bool bSupported = true;
+
+	static void AddElement(TLeafType& Leaf, const TElement& Elem) { Leaf.AddElement(Elem); }
+	static int32 NumElements(const TLeafType& Leaf) { return Leaf.NumElements(); }
+	static TAABB<T, 3> ComputeBounds(const TLeafType& Leaf) { return Leaf.ComputeElementsBounds(); }
+};
+
 template <typename TPayloadType, typename TLeafType, typename T, bool bMutable = true>
 class TAABBTree final : public ISpatialAcceleration<TPayloadType, T, 3>
 {
@@ -315,6 +467,8 @@ public:
 	static constexpr int32 DefaultMaxChildrenInLeaf = 12;
 	static constexpr int32 DefaultMaxTreeDepth = 16;
 	static constexpr int32 DefaultMaxNumToProcess = 0; // 0 special value for processing all without timeslicing
+	static constexpr int32 MaxElementsInLeafFactor = 2; // incremental updates add to leaves up to this many times MaxChildrenInLeaf
+	static constexpr int32 RaycastBatchChunkSize = 64;
 	static constexpr ESpatialAcceleration StaticType = TIsSame<TAABBTreeLeafArray<TPayloadType, T>, TLeafType>::Value ? ESpatialAcceleration::AABBTree : 
 		(TIsSame<TBoundingVolume<TPayloadType, T, 3>, TLeafType>::Value ? ESpatialAcceleration::AABBTreeBV : ESpatialAcceleration::Unknown);
 	TAABBTree()
@@ -404,6 +558,28 @@ public:
 		return QueryImp<EAABBQueryType::Raycast>(Start, CurData, TVector<T, 3>(), TAABB<T, 3>(), Visitor);
 	}
 
+	/**
+	 * Raycast a batch of rays, split across worker threads in chunks of RaycastBatchChunkSize rays sharing a traversal stack.
+	 * Visitors[Idx] receives the hits of ray Idx and is called from a worker thread.
+	 */
+	template <typename SQVisitor>
+	void RaycastBatch(TArrayView<const TVector<T, 3>> Starts, TArrayView<const TVector<T, 3>> Dirs, TArrayView<const T> Lengths, TArrayView<SQVisitor> Visitors, bool bForceSingleThreaded = false) const
+	{
+		check(Dirs.Num() == Starts.Num() && Lengths.Num() == Starts.Num() && Visitors.Num() == Starts.Num());
+
+		const int32 NumChunks = FMath::DivideAndRoundUp(Starts.Num(), RaycastBatchChunkSize);
+		PhysicsParallelFor(NumChunks, [this, &Starts, &Dirs, &Lengths, &Visitors](int32 ChunkIdx)
+		{
+			FNodeStack NodeStack;
+			const int32 LastIdx = FMath::Min((ChunkIdx + 1) * RaycastBatchChunkSize, Starts.Num());
+			for (int32 Idx = ChunkIdx * RaycastBatchChunkSize; Idx < LastIdx; ++Idx)
+			{
+				FQueryFastData QueryFastData(Dirs[Idx], Lengths[Idx]);
+				QueryImp<EAABBQueryType::Raycast>(Starts[Idx], QueryFastData, TVector<T, 3>(), TAABB<T, 3>(), Visitors[Idx], NodeStack);
+			}
+		}, bForceSingleThreaded);
+	}
+
 	void Sweep(const TVector<T, 3>& Start, const TVector<T, 3>& Dir, const T Length, const TVector<T, 3> QueryHalfExtents, ISpatialVisitor<TPayloadType, T>& Visitor) const override
 	{
 		TSpatialVisitor<TPayloadType, T> ProxyVisitor(Visitor);
@@ -472,6 +648,10 @@ public:
 				else if (ensure(PayloadInfo->LeafIdx != INDEX_NONE))
 				{
 					Leaves[PayloadInfo->LeafIdx].RemoveElement(Payload);
+					if (CanUpdateIncrementally())
+					{
+						RefitLeaf(PayloadInfo->LeafIdx);
+					}
 				}
 
 				PayloadToInfo.Remove(Payload);
@@ -483,11 +663,20 @@ public:
 	{
 		if (ensure(bMutable))
 		{
+			const bool bIncremental = CanUpdateIncrementally();
 			FAABBTreePayloadInfo* PayloadInfo = PayloadToInfo.Find(Payload);
 			if (PayloadInfo)
 			{
 				if (PayloadInfo->LeafIdx != INDEX_NONE)
 				{
+					if (bIncremental && bHasBounds && NewBounds.Extents().Max() <= MaxPayloadBounds)
+					{
+						if (UpdateElementInLeaf(Payload, NewBounds, *PayloadInfo))
+						{
+							return;
+						}
+					}
+
 					//If we are still within the same leaf bounds, do nothing
 					if (bHasBounds)
 					{
@@ -499,6 +688,10 @@ public:
 					}
 
 					Leaves[PayloadInfo->LeafIdx].RemoveElement(Payload);
+					if (bIncremental)
+					{
+						RefitLeaf(PayloadInfo->LeafIdx);
+					}
 					PayloadInfo->LeafIdx = INDEX_NONE;
 				}
 			}
@@ -519,7 +712,22 @@ public:
 
 			if (bHasBounds)
 			{
-				if (PayloadInfo->DirtyPayloadIdx == INDEX_NONE)
+				if (bIncremental && InsertElement(FElement{ Payload, NewBounds }, *PayloadInfo))
+				{
+					// Handle something that was waiting in dirty elements for the next rebuild.
+					if (PayloadInfo->DirtyPayloadIdx != INDEX_NONE)
+					{
+						if (PayloadInfo->DirtyPayloadIdx + 1 < DirtyElements.Num())
+						{
+							auto LastDirtyPayload = DirtyElements.Last().Payload;
+							PayloadToInfo.FindChecked(LastDirtyPayload).DirtyPayloadIdx = PayloadInfo->DirtyPayloadIdx;
+						}
+						DirtyElements.RemoveAtSwap(PayloadInfo->DirtyPayloadIdx);
+
+						PayloadInfo->DirtyPayloadIdx = INDEX_NONE;
+					}
+				}
+				else if (PayloadInfo->DirtyPayloadIdx == INDEX_NONE)
 				{
 					PayloadInfo->DirtyPayloadIdx = DirtyElements.Add(FElement{ Payload, NewBounds });
 				}
@@ -620,12 +828,26 @@ public:
 		Ar << MaxChildrenInLeaf;
 		Ar << MaxTreeDepth;
 		Ar << MaxPayloadBounds;
+
+		if (Ar.IsLoading())
+		{
+			BuildNodeLinks();
+			BuildWideNodes();
+		}
 	}
 
 private:
 
 	using FElement = TPayloadBoundsElement<TPayloadType, T>;
 	using FNode = TAABBTreeNode<T>;
+	using FIncrementalLeafHelper = TAABBTreeIncrementalLeafHelper<TLeafType, FElement, T>;
+
+	struct FNodeQueueEntry
+	{
+		int32 NodeIdx;
+		T TOI;
+	};
+	using FNodeStack = TArray<FNodeQueueEntry, TInlineAllocator<64>>;
 
 	void ReoptimizeTree()
 	{
@@ -653,6 +875,13 @@ private:
 
 	template <EAABBQueryType Query, typename TQueryFastData, typename SQVisitor>
 	bool QueryImp(const TVector<T, 3>& Start, TQueryFastData& CurData, const TVector<T, 3> QueryHalfExtents, const TAABB<T,3>& QueryBounds, SQVisitor& Visitor) const
+	{
+		FNodeStack NodeStack;
+		return QueryImp<Query>(Start, CurData, QueryHalfExtents, QueryBounds, Visitor, NodeStack);
+	}
+
+	template <EAABBQueryType Query, typename TQueryFastData, typename SQVisitor>
+	bool QueryImp(const TVector<T, 3>& Start, TQueryFastData& CurData, const TVector<T, 3> QueryHalfExtents, const TAABB<T,3>& QueryBounds, SQVisitor& Visitor, FNodeStack& NodeStack) const
 	{
 		//QUICK_SCOPE_CYCLE_COUNTER(AABBTreeQueryImp);
 		TVector<T, 3> TmpPosition;
@@ -725,13 +954,12 @@ private:
 
 		}
 
-		struct FNodeQueueEntry
+		if (WideNodes.Num() && FAABBTreeCVars::WideNodeQueries != 0)
 		{
-			int32 NodeIdx;
-			T TOI;
-		};
+			return QueryWideNodes<Query>(Start, CurData, QueryHalfExtents, QueryBounds, Visitor, NodeStack);
+		}
 
-		TArray<FNodeQueueEntry> NodeStack;
+		NodeStack.Reset();
 		NodeStack.Add(FNodeQueueEntry{ 0, 0 });
 		while (NodeStack.Num())
 		{
@@ -747,40 +975,276 @@ private:
 			const FNode& Node = Nodes[NodeEntry.NodeIdx];
 			if (Node.bLeaf)
 			{
-				const auto& Leaf = Leaves[Node.ChildrenNodes[0]];
-				if (Query == EAABBQueryType::Overlap)
+				if (QueryLeaf<Query>(Leaves[Node.ChildrenNodes[0]], Start, CurData, QueryHalfExtents, QueryBounds, Visitor) == false)
 				{
-					if (Leaf.OverlapFast(QueryBounds, Visitor) == false)
-					{
-						return false;
-					}
+					return false;
 				}
-				else if (Query == EAABBQueryType::Sweep)
+			}
+			else
+			{
+				int32 Idx = 0;
+				for (const TAABB<T, 3>& AABB : Node.ChildrenBounds)
 				{
-					if (Leaf.SweepFast(Start, CurData, QueryHalfExtents, Visitor) == false)
+					if(TAABBTreeIntersectionHelper<T, TQueryFastData, Query>::Intersects(Start, CurData, TOI, TmpPosition, AABB, QueryBounds, QueryHalfExtents))
 					{
-						return false;
+						NodeStack.Add(FNodeQueueEntry{ Node.ChildrenNodes[Idx], TOI });
 					}
+					++Idx;
 				}
-				else if (Leaf.RaycastFast(Start, CurData, Visitor) == false)
+			}
+		}
+
+		return true;
+	}
+
+	template <EAABBQueryType Query, typename TQueryFastData, typename SQVisitor>
+	FORCEINLINE_DEBUGGABLE bool QueryLeaf(const TLeafType& Leaf, const TVector<T, 3>& Start, TQueryFastData& CurData, const TVector<T, 3>& QueryHalfExtents, const TAABB<T, 3>& QueryBounds, SQVisitor& Visitor) const
+	{
+		if (Query == EAABBQueryType::Overlap)
+		{
+			return Leaf.OverlapFast(QueryBounds, Visitor);
+		}
+		else if (Query == EAABBQueryType::Sweep)
+		{
+			return Leaf.SweepFast(Start, CurData, QueryHalfExtents, Visitor);
+		}
+		return Leaf.RaycastFast(Start, CurData, Visitor);
+	}
+
+	/** Same traversal as QueryImp, testing the four children of each wide node at once */
+	template <EAABBQueryType Query, typename TQueryFastData, typename SQVisitor>
+	bool QueryWideNodes(const TVector<T, 3>& Start, TQueryFastData& CurData, const TVector<T, 3>& QueryHalfExtents, const TAABB<T, 3>& QueryBounds, SQVisitor& Visitor, FNodeStack& NodeStack) const
+	{
+		VectorRegister QueryMin[3];
+		VectorRegister QueryMax[3];
+		VectorRegister QueryStart[3];
+		VectorRegister QueryInvDir[3];
+		VectorRegister QueryInflation[3];
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (Query == EAABBQueryType::Overlap)
+			{
+				QueryMin[Axis] = VectorSetFloat1((float)QueryBounds.Min()[Axis]);
+				QueryMax[Axis] = VectorSetFloat1((float)QueryBounds.Max()[Axis]);
+			}
+			else
+			{
+				QueryStart[Axis] = VectorSetFloat1((float)Start[Axis]);
+				QueryInvDir[Axis] = VectorSetFloat1((float)CurData.InvDir[Axis]);
+				QueryInflation[Axis] = VectorSetFloat1(Query == EAABBQueryType::Sweep ? (float)QueryHalfExtents[Axis] : 0.0f);
+			}
+		}
+
+		MS_ALIGN(16) float LaneTimes[FAABBTreeWideNode::NumLanes] GCC_ALIGN(16);
+
+		NodeStack.Reset();
+		NodeStack.Add(FNodeQueueEntry{ 0, 0 });
+		while (NodeStack.Num())
+		{
+			const FNodeQueueEntry NodeEntry = NodeStack.Pop(false);
+			if (Query != EAABBQueryType::Overlap)
+			{
+				if (NodeEntry.TOI > CurData.CurrentLength)
+				{
+					continue;
+				}
+			}
+
+			const FNode& Node = Nodes[NodeEntry.NodeIdx];
+			if (Node.bLeaf)
+			{
+				if (QueryLeaf<Query>(Leaves[Node.ChildrenNodes[0]], Start, CurData, QueryHalfExtents, QueryBounds, Visitor) == false)
 				{
 					return false;
 				}
+				continue;
+			}
+
+			const FAABBTreeWideNode& WideNode = WideNodes[NodeToWideNode[NodeEntry.NodeIdx]];
+			int32 HitLanes;
+			if (Query == EAABBQueryType::Overlap)
+			{
+				HitLanes = WideNode.Overlap(QueryMin, QueryMax);
 			}
 			else
 			{
-				int32 Idx = 0;
-				for (const TAABB<T, 3>& AABB : Node.ChildrenBounds)
+				VectorRegister Times;
+				HitLanes = WideNode.Raycast(QueryStart, QueryInvDir, QueryInflation, CurData.bParallel, VectorSetFloat1((float)CurData.CurrentLength), Times);
+				VectorStoreAligned(Times, LaneTimes);
+			}
+
+			for (int32 Lane = 0; Lane < FAABBTreeWideNode::NumLanes; ++Lane)
+			{
+				if (HitLanes & (1 << Lane))
 				{
-					if(TAABBTreeIntersectionHelper<T, TQueryFastData, Query>::Intersects(Start, CurData, TOI, TmpPosition, AABB, QueryBounds, QueryHalfExtents))
+					NodeStack.Add(FNodeQueueEntry{ WideNode.ChildrenNodes[Lane], Query == EAABBQueryType::Overlap ? (T)0 : (T)LaneTimes[Lane] });
+				}
+			}
+		}
+
+		return true;
+	}
+
+	/** Parent of each node and node of each leaf, used by incremental updates to refit the tree */
+	void BuildNodeLinks()
+	{
+		NodeParents.Init(INDEX_NONE, Nodes.Num());
+		LeafNodes.Init(INDEX_NONE, Leaves.Num());
+		for (int32 NodeIdx = 0; NodeIdx < Nodes.Num(); ++NodeIdx)
+		{
+			const FNode& Node = Nodes[NodeIdx];
+			if (Node.bLeaf)
+			{
+				LeafNodes[Node.ChildrenNodes[0]] = NodeIdx;
+			}
+			else
+			{
+				NodeParents[Node.ChildrenNodes[0]] = NodeIdx;
+				NodeParents[Node.ChildrenNodes[1]] = NodeIdx;
+			}
+		}
+	}
+
+	/**
+	 * Collapse every two levels of binary nodes into a wide node, starting at the root. Lanes of a wide node are the
+	 * grandchildren of its binary node, or the child itself when it's a leaf. Remembers which lane holds the bounds of
+	 * each binary child, so refitting binary nodes keeps wide nodes up to date.
+	 */
+	void BuildWideNodes()
+	{
+		WideNodes.Reset();
+		NodeToWideNode.Init(INDEX_NONE, Nodes.Num());
+		NodeChildWideLanes.Init(INDEX_NONE, Nodes.Num() * 2);
+		if (Nodes.Num() == 0 || Nodes[0].bLeaf)
+		{
+			return;
+		}
+
+		TArray<int32> NodesToCollapse;
+		NodesToCollapse.Add(0);
+		while (NodesToCollapse.Num())
+		{
+			const int32 NodeIdx = NodesToCollapse.Pop(false);
+			const int32 WideNodeIdx = WideNodes.AddDefaulted();
+			NodeToWideNode[NodeIdx] = WideNodeIdx;
+
+			for (int32 ChildIdx = 0; ChildIdx < 2; ++ChildIdx)
+			{
+				const int32 ChildNodeIdx = Nodes[NodeIdx].ChildrenNodes[ChildIdx];
+				const FNode& ChildNode = Nodes[ChildNodeIdx];
+				if (ChildNode.bLeaf)
+				{
+					const int32 Lane = ChildIdx * 2;
+					WideNodes[WideNodeIdx].SetLane(Lane, Nodes[NodeIdx].ChildrenBounds[ChildIdx], ChildNodeIdx);
+					NodeChildWideLanes[NodeIdx * 2 + ChildIdx] = WideNodeIdx * FAABBTreeWideNode::NumLanes + Lane;
+					continue;
+				}
+
+				for (int32 GrandChildIdx = 0; GrandChildIdx < 2; ++GrandChildIdx)
+				{
+					const int32 GrandChildNodeIdx = ChildNode.ChildrenNodes[GrandChildIdx];
+					const int32 Lane = ChildIdx * 2 + GrandChildIdx;
+					WideNodes[WideNodeIdx].SetLane(Lane, ChildNode.ChildrenBounds[GrandChildIdx], GrandChildNodeIdx);
+					NodeChildWideLanes[ChildNodeIdx * 2 + GrandChildIdx] = WideNodeIdx * FAABBTreeWideNode::NumLanes + Lane;
+
+					if (!Nodes[GrandChildNodeIdx].bLeaf)
 					{
-						NodeStack.Add(FNodeQueueEntry{ Node.ChildrenNodes[Idx], TOI });
+						NodesToCollapse.Add(GrandChildNodeIdx);
 					}
-					++Idx;
 				}
 			}
 		}
+	}
+
+	/** Incremental updates move elements between leaves and refit the tree instead of going through dirty elements and full rebuilds */
+	bool CanUpdateIncrementally() const
+	{
+		return bMutable && FIncrementalLeafHelper::bSupported && FAABBTreeCVars::IncrementalUpdate != 0
+			&& WorkStack.Num() == 0 && Nodes.Num() > 0 && LeafNodes.Num() == Leaves.Num();
+	}
+
+	void SetChildBounds(const int32 NodeIdx, const int32 ChildIdx, const TAABB<T, 3>& Bounds)
+	{
+		Nodes[NodeIdx].ChildrenBounds[ChildIdx] = Bounds;
 
+		const int32 WideLane = NodeChildWideLanes[NodeIdx * 2 + ChildIdx];
+		if (WideLane != INDEX_NONE)
+		{
+			WideNodes[WideLane / FAABBTreeWideNode::NumLanes].SetLaneBounds(WideLane % FAABBTreeWideNode::NumLanes, Bounds);
+		}
+	}
+
+	/** Set bounds of the leaf to the bounds of its elements and propagate them up the tree, until a node's bounds don't change */
+	void RefitLeaf(const int32 LeafIdx)
+	{
+		int32 NodeIdx = LeafNodes[LeafIdx];
+		TAABB<T, 3> NodeBounds = FIncrementalLeafHelper::ComputeBounds(Leaves[LeafIdx]);
+		for (int32 ParentIdx = NodeParents[NodeIdx]; ParentIdx != INDEX_NONE; NodeIdx = ParentIdx, ParentIdx = NodeParents[NodeIdx])
+		{
+			const FNode& Parent = Nodes[ParentIdx];
+			const int32 ChildIdx = (Parent.ChildrenNodes[0] == NodeIdx) ? 0 : 1;
+			if (Parent.ChildrenBounds[ChildIdx].Min() == NodeBounds.Min() && Parent.ChildrenBounds[ChildIdx].Max() == NodeBounds.Max())
+			{
+				break;
+			}
+
+			SetChildBounds(ParentIdx, ChildIdx, NodeBounds);
+			NodeBounds = Parent.ChildrenBounds[0];
+			NodeBounds.GrowToInclude(Parent.ChildrenBounds[1]);
+		}
+	}
+
+	/** Replace the bounds of an element in its leaf if they still fit in the leaf bounds. Leaf bounds are not shrunk */
+	bool UpdateElementInLeaf(const TPayloadType& Payload, const TAABB<T, 3>& NewBounds, const FAABBTreePayloadInfo& PayloadInfo)
+	{
+		const int32 NodeIdx = LeafNodes[PayloadInfo.LeafIdx];
+		const int32 ParentIdx = NodeParents[NodeIdx];
+		if (ParentIdx != INDEX_NONE)
+		{
+			const FNode& Parent = Nodes[ParentIdx];
+			const TAABB<T, 3>& LeafBounds = Parent.ChildrenBounds[(Parent.ChildrenNodes[0] == NodeIdx) ? 0 : 1];
+			if (!LeafBounds.Contains(NewBounds.Min()) || !LeafBounds.Contains(NewBounds.Max()))
+			{
+				return false;
+			}
+		}
+
+		TLeafType& Leaf = Leaves[PayloadInfo.LeafIdx];
+		Leaf.RemoveElement(Payload);
+		FIncrementalLeafHelper::AddElement(Leaf, FElement{ Payload, NewBounds });
+		return true;
+	}
+
+	/** Growth of bounds when adding an element, with the same metric FindBestBounds uses to split nodes */
+	static T ComputeGrowthCost(const TAABB<T, 3>& Bounds, const TAABB<T, 3>& ElemBounds)
+	{
+		TAABB<T, 3> NewBounds = Bounds;
+		NewBounds.GrowToInclude(ElemBounds);
+		const bool bEmpty = Bounds.Min()[0] > Bounds.Max()[0];
+		return NewBounds.Extents().SizeSquared() - (bEmpty ? 0 : Bounds.Extents().SizeSquared());
+	}
+
+	/** Add element to the leaf whose bounds grow the least. Fails when that leaf is full, the element is then left to the next rebuild */
+	bool InsertElement(const FElement& Elem, FAABBTreePayloadInfo& PayloadInfo)
+	{
+		int32 NodeIdx = 0;
+		while (!Nodes[NodeIdx].bLeaf)
+		{
+			const FNode& Node = Nodes[NodeIdx];
+			const T Cost0 = ComputeGrowthCost(Node.ChildrenBounds[0], Elem.Bounds);
+			const T Cost1 = ComputeGrowthCost(Node.ChildrenBounds[1], Elem.Bounds);
+			NodeIdx = Node.ChildrenNodes[(Cost1 < Cost0) ? 1 : 0];
+		}
+
+		const int32 LeafIdx = Nodes[NodeIdx].ChildrenNodes[0];
+		if (FIncrementalLeafHelper::NumElements(Leaves[LeafIdx]) >= MaxChildrenInLeaf * MaxElementsInLeafFactor)
+		{
+			return false;
+		}
+
+		FIncrementalLeafHelper::AddElement(Leaves[LeafIdx], Elem);
+		PayloadInfo.LeafIdx = LeafIdx;
+		RefitLeaf(LeafIdx);
 		return true;
 	}
 
@@ -827,6 +1291,11 @@ private:
 		Nodes.Reset();
 		DirtyElements.Reset();
 		PayloadToInfo.Reset();
+		NodeParents.Reset();
+		LeafNodes.Reset();
+		WideNodes.Reset();
+		NodeToWideNode.Reset();
+		NodeChildWideLanes.Reset();
 		NumProcessedThisSlice = 0;
 
 		WorkSnapshot.Bounds = TAABB<T, 3>::EmptyAABB();
@@ -1151,7 +1620,9 @@ private:
 
 		check(WorkStack.Num() == 0);
 		//Stack is empty, clean up pool and mark task as complete
-		
+
+		BuildNodeLinks();
+		BuildWideNodes();
 		this->SetAsyncTimeSlicingComplete(true);
 	}
 
@@ -1197,6 +1668,11 @@ private:
 		, DirtyElements(Other.DirtyElements)
 		, GlobalPayloads(Other.GlobalPayloads)
 		, PayloadToInfo(Other.PayloadToInfo)
+		, NodeParents(Other.NodeParents)
+		, LeafNodes(Other.LeafNodes)
+		, WideNodes(Other.WideNodes)
+		, NodeToWideNode(Other.NodeToWideNode)
+		, NodeChildWideLanes(Other.NodeChildWideLanes)
 		, MaxChildrenInLeaf(Other.MaxChildrenInLeaf)
 		, MaxTreeDepth(Other.MaxTreeDepth)
 		, MaxPayloadBounds(Other.MaxPayloadBounds)
@@ -1222,6 +1698,11 @@ private:
 			DirtyElements = Rhs.DirtyElements;
 			GlobalPayloads = Rhs.GlobalPayloads;
 			PayloadToInfo = Rhs.PayloadToInfo;
+			NodeParents = Rhs.NodeParents;
+			LeafNodes = Rhs.LeafNodes;
+			WideNodes = Rhs.WideNodes;
+			NodeToWideNode = Rhs.NodeToWideNode;
+			NodeChildWideLanes = Rhs.NodeChildWideLanes;
 			MaxChildrenInLeaf = Rhs.MaxChildrenInLeaf;
 			MaxTreeDepth = Rhs.MaxTreeDepth;
 			MaxPayloadBounds = Rhs.MaxPayloadBounds;
@@ -1239,6 +1720,13 @@ private:
 	TArray<FElement> GlobalPayloads;
 	TArrayAsMap<TPayloadType, FAABBTreePayloadInfo> PayloadToInfo;
 
+	// Built from Nodes and Leaves once the tree is generated, not serialized
+	TArray<int32> NodeParents;
+	TArray<int32> LeafNodes;
+	TArray<FAABBTreeWideNode> WideNodes;
+	TArray<int32> NodeToWideNode;
+	TArray<int32> NodeChildWideLanes;	// Wide node lane holding ChildrenBounds of each binary node, as WideNodeIdx * NumLanes + Lane
+
 	int32 MaxChildrenInLeaf;
 	int32 MaxTreeDepth;
 	T MaxPayloadBounds;
@@ -56,9 +56,11 @@ namespace Chaos
 			// Receivers and NarrowPhase are assumed to be stateless atm. If we change that, they need to
 			// be passed into the constructor with the BroadPhase and Container.
 			FReceiver Receiver(CollisionContainer);
-			FNarrowPhase NarrowPhase(Context);
+			FNarrowPhase NarrowPhase(Context, &CollisionContainer);
 			BroadPhase.ProduceOverlaps(Dt, NarrowPhase, Receiver, StatData);
 			Receiver.ProcessCollisions();
+
+			CollisionContainer.SetContactCacheStats(NarrowPhase.GetCacheStats());
 		}
 
 	private:
@@ -8,6 +8,8 @@
 #include "Chaos/PBDCollisionConstraints.h"
 #include "Chaos/PBDRigidsSOAs.h"
 #include "ChaosStats.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeCounter64.h"
 
 namespace Chaos
 {
@@ -23,14 +25,16 @@ namespace Chaos
 
 	/**
 	 * Generate contact manifolds for particle pairs.
+	 * Pairs that were in contact in the previous step reuse their contacts from the collision container's cache when possible.
 	 *
 	 * /see FAsyncCollisionReceiver, FSyncCollisionReceiver.
 	 */
 	class CHAOS_API FNarrowPhase
 	{
 	public:
-		FNarrowPhase(const FCollisionContext& InContext)
+		FNarrowPhase(const FCollisionContext& InContext, const TPBDCollisionConstraints<FReal, 3>* InContactCache = nullptr)
 			: Context(InContext)
+			, ContactCache(InContactCache)
 		{
 		}
 
@@ -43,6 +47,15 @@ namespace Chaos
 			SCOPE_CYCLE_COUNTER_NAROWPHASE();
 			if (ensure(Particle0 && Particle1))
 			{
+				const uint32 StartCycles = FPlatformTime::Cycles();
+				if (ContactCache && ContactCache->FindCachedConstraints(Particle0, Particle1, CullDistance, NewConstraints))
+				{
+					NumCacheHits.Increment();
+					NarrowPhaseCycles.Add(FPlatformTime::Cycles() - StartCycles);
+					CHAOS_COLLISION_STAT(if (NewConstraints.Num()) { StatData.IncrementCountNP(NewConstraints.Num()); });
+					return;
+				}
+
 				//
 				// @todo(chaos) : Collision Constraints
 				//   This is not efficient. The constraint has to go through a construction 
@@ -51,13 +64,33 @@ namespace Chaos
 				//   the creation process. 
 				//
 				Collisions::ConstructConstraints<FReal, 3>(Particle0, Particle1, Particle0->Geometry().Get(), Particle1->Geometry().Get(), Collisions::GetTransform(Particle0), Collisions::GetTransform(Particle1), CullDistance, Context, NewConstraints);
+				NumCacheMisses.Increment();
+				NarrowPhaseCycles.Add(FPlatformTime::Cycles() - StartCycles);
 
 				CHAOS_COLLISION_STAT(if (NewConstraints.Num()) { StatData.IncrementCountNP(NewConstraints.Num()); });
 				CHAOS_COLLISION_STAT(if (!NewConstraints.Num()) { StatData.IncrementRejectedNP(); });
 			}
 		}
 
+		/**
+		 * Contact cache counters and time spent generating collisions so far, summed over all threads.
+		 */
+		FCollisionCacheStats GetCacheStats() const
+		{
+			FCollisionCacheStats Stats;
+			Stats.NumHits = NumCacheHits.GetValue();
+			Stats.NumMisses = NumCacheMisses.GetValue();
+			Stats.NarrowPhaseSeconds = FPlatformTime::ToSeconds64(NarrowPhaseCycles.GetValue());
+			return Stats;
+		}
+
 	private:
 		const FCollisionContext& Context;
+		const TPBDCollisionConstraints<FReal, 3>* ContactCache;
+
+		// Pairs are processed on multiple threads
+		FThreadSafeCounter NumCacheHits;
+		FThreadSafeCounter NumCacheMisses;
+		FThreadSafeCounter64 NarrowPhaseCycles;
 	};
 }
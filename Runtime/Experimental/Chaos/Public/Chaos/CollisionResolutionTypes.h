@@ -123,6 +123,7 @@ namespace Chaos
 			: AccumulatedImpulse(0)
 			, Timestamp(-INT_MAX)
 			, ConstraintHandle(nullptr)
+			, bIsCached(false)
 			, Type(InType)
 		{ 
 			ImplicitTransform[0] = TRigidTransform<T, d>::Identity; ImplicitTransform[1] = TRigidTransform<T,d>::Identity;
@@ -137,6 +138,7 @@ namespace Chaos
 			: AccumulatedImpulse(0)
 			, Timestamp(InTimestamp)
 			, ConstraintHandle(nullptr)
+			, bIsCached(false)
 			, Type(InType)
 		{
 			ImplicitTransform[0] = Transform0; ImplicitTransform[1] = Transform1;
@@ -186,6 +188,10 @@ namespace Chaos
 		int32 Timestamp;
 		TPBDCollisionConstraintHandle<T, d>* ConstraintHandle;
 
+		// Contact reused from a previous step instead of running collision detection, AccumulatedImpulse holds the impulse
+		// to warm start the solver with. /see TPBDCollisionConstraints::FindCachedConstraints
+		bool bIsCached;
+
 	private:
 
 		FType Type;
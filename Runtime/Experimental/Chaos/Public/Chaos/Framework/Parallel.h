@@ -7,6 +7,12 @@
 namespace Chaos
 {
 	void CHAOS_API PhysicsParallelFor(int32 InNum, TFunctionRef<void(int32)> InCallable, bool bForceSingleThreaded = false);
+
+	/**
+	 * Calls InCallable for every index on up to InMaxThreads threads (all workers if <= 0), each taking the next index from a shared queue
+	 * as soon as it is done with the previous one. For few items of very uneven cost: callers should order them most expensive first.
+	 */
+	void CHAOS_API PhysicsParallelForWorkQueue(int32 InNum, TFunctionRef<void(int32)> InCallable, int32 InMaxThreads = 0, bool bForceSingleThreaded = false);
 	//void CHAOS_API PhysicsParallelFor_RecursiveDivide(int32 InNum, TFunctionRef<void(int32)> InCallable, bool bForceSingleThreaded = false);
 
 
@@ -63,6 +63,33 @@ using TRigidBodyContactConstraintsPostApplyPushOutCallback = TFunction<void(cons
 template <typename T, int d>
 using TCollisionModifierCallback = TFunction<ECollisionModifierResult(const TPBDCollisionConstraintHandle<T, d>*)>;
 
+/**
+ * Contact cache and narrow phase counters of a collision detection pass.
+ */
+struct FCollisionCacheStats
+{
+	FCollisionCacheStats()
+		: NumHits(0)
+		, NumMisses(0)
+		, NarrowPhaseSeconds(0)
+	{
+	}
+
+	float GetHitRate() const
+	{
+		return (NumHits + NumMisses) > 0 ? (float)NumHits / (float)(NumHits + NumMisses) : 0.0f;
+	}
+
+	/** Particle pairs that reused contacts from the previous step */
+	int32 NumHits;
+
+	/** Particle pairs that ran collision detection */
+	int32 NumMisses;
+
+	/** Time spent in the narrow phase, summed over all threads */
+	double NarrowPhaseSeconds;
+};
+
 /**
  * A container and solver for collision constraints.
  */
@@ -214,6 +241,24 @@ public:
 		return Handles; 
 	}
 
+	/**
+	 * Copy contacts the pair had in the previous step to NewConstraints, if its particles have not moved relative to each other
+	 * more than p.Chaos.Collision.ContactCache.MaxTranslation/MaxRotation since the contacts were found. Contacts are moved along
+	 * with the particles and keep a fraction of the impulse they received, used to warm start the solver.
+	 * Only reads the cache, can be called by the narrow phase from any thread.
+	 * @return true if cached contacts were used, false if collision detection needs to run for the pair
+	 */
+	bool FindCachedConstraints(TGeometryParticleHandle<T, d>* Particle0, TGeometryParticleHandle<T, d>* Particle1, const T CullDistance, FCollisionConstraintsArray& NewConstraints) const;
+
+	/**
+	 * Counters of the last collision detection, set by the collision detector.
+	 */
+	void SetContactCacheStats(const FCollisionCacheStats& InStats);
+	const FCollisionCacheStats& GetContactCacheStats() const
+	{
+		return ContactCacheStats;
+	}
+
 	bool Contains(const FConstraintBase* Base) const 
 	{
 #if CHAOS_COLLISION_PERSISTENCE_ENABLED
@@ -305,6 +350,37 @@ protected:
 
 private:
 
+	using FParticlePairKey = TPair<TGeometryParticleHandle<T, d>*, TGeometryParticleHandle<T, d>*>;
+
+	/** Contacts found by collision detection for a pair of particles, along with the particle transforms at that time */
+	struct FCachedContacts
+	{
+		FCachedContacts()
+			: DetectedTimestamp(-INT_MAX)
+			, UsedTimestamp(-INT_MAX)
+		{
+		}
+
+		TGeometryParticleHandle<T, d>* Particles[2];
+		const FImplicitObject* Geometries[2];
+		TRigidTransform<T, d> Transforms[2];
+		TArray<FPointContactConstraint, TInlineAllocator<1>> PointConstraints;
+		TArray<FMultiPointContactConstraint> MultiPointConstraints;
+		int32 DetectedTimestamp;
+		int32 UsedTimestamp;
+	};
+
+	static FParticlePairKey MakeParticlePairKey(TGeometryParticleHandle<T, d>* Particle0, TGeometryParticleHandle<T, d>* Particle1)
+	{
+		return (Particle0 < Particle1) ? FParticlePairKey(Particle0, Particle1) : FParticlePairKey(Particle1, Particle0);
+	}
+
+	/** Marks the pair of the constraint as still in contact, returns its entry if the constraint was found by collision detection and needs to be cached */
+	FCachedContacts* GetCachedContactsForUpdate(const FConstraintBase& Constraint);
+
+	/** Keeps impulses of this step's constraints and drops pairs no longer in contact, called before constraints are reset */
+	void UpdateContactCache();
+
 	const TPBDRigidsSOAs<T,d>& Particles;
 
 	TArray<FPointContactConstraint> PointConstraints;
@@ -317,6 +393,9 @@ private:
 	TArray<FConstraintContainerHandle*> Handles;
 	FConstraintHandleAllocator HandleAllocator;
 
+	TMap<FParticlePairKey, FCachedContacts> ContactCache;
+	FCollisionCacheStats ContactCacheStats;
+
 	TArrayCollectionArray<bool>& MCollided;
 	const TArrayCollectionArray<TSerializablePtr<FChaosPhysicsMaterial>>& MPhysicsMaterials;
 	int32 MApplyPairIterations;
@@ -15,29 +15,28 @@ namespace Chaos
 	class CHAOS_API FPBDConstraintColor
 	{
 	public:
-		typedef TSet<int32> FColorSet;
 		typedef TArray<FConstraintHandle*> FConstraintList;
-		typedef TMap<int32, FConstraintList> FColorToConstraintListMap;
-		typedef TArray<FColorToConstraintListMap> FLevelToColorToConstraintListMap;
 
 		FPBDConstraintColor()
 			: bUseContactGraph(true)
 		{}
 
 		/**
-		 * Initialize the color structures based on the connectivity graph (i.e., reset all color-related node, edge and island data).
+		 * Initialize the color structures based on the connectivity graph (i.e., reset all color-related edge data and assign edges to their islands).
+		 * Island colors are kept so they can be reused by islands that didn't change.
 		 */
 		void InitializeColor(const FPBDConstraintGraph& ConstraintGraph);
 
 		/**
-		 * Calculate the color information for the specified island.
+		 * Calculate the color information for the specified island, or keep the previous one if the island's particles and constraints didn't change.
+		 * Can be called for different islands in parallel.
 		 */
 		void ComputeColor(const int32 Island, const FPBDConstraintGraph& ConstraintGraph, uint32 ContainerId);
 
 		/**
-		 * Get the Level-Color-ConstraintList map for the specified island.
+		 * Get the list of constraints with the specified level and color in the specified island.
 		 */
-		const FLevelToColorToConstraintListMap& GetIslandLevelToColorToConstraintListMap(int32 Island) const;
+		const FConstraintList& GetIslandConstraints(int32 Island, int32 Level, int32 Color) const;
 
 		/**
 		 * Get the maximum color index used in the specified island.
@@ -55,47 +54,56 @@ namespace Chaos
 		}
 
 	private:
+		bool UpdateIslandKey(const int32 Island, const FPBDConstraintGraph& ConstraintGraph, uint32 ContainerId);
 		void ComputeContactGraph(const int32 Island, const FPBDConstraintGraph& ConstraintGraph, uint32 ContainerId);
 		void ComputeIslandColoring(const int32 Island, const FPBDConstraintGraph& ConstraintGraph, uint32 ContainerId);
-
-		struct FGraphNodeColor
-		{
-			FGraphNodeColor()
-				: NextColor(0)
-			{
-			}
-			int32 NextColor;
-			FColorSet UsedColors;
-		};
+		void BuildIslandConstraintLists(const int32 Island, const FPBDConstraintGraph& ConstraintGraph, uint32 ContainerId);
 
 		struct FGraphEdgeColor
 		{
 			FGraphEdgeColor()
 				: Color(INDEX_NONE)
 				, Level(INDEX_NONE)
+				, Island(INDEX_NONE)
 			{
 			}
 			int32 Color;
 			int32 Level;
+			int32 Island;
 		};
 
 		struct FIslandColor
 		{
 			FIslandColor()
-				: MaxColor(0)
-				, MaxLevel(0)
+				: MaxColor(-1)
+				, MaxLevel(-1)
+				, bUsedContactGraph(false)
 			{
 			}
 			int32 MaxColor;
 			int32 MaxLevel;
-			FLevelToColorToConstraintListMap LevelToColorToConstraintListMap;
+			bool bUsedContactGraph;
+
+			/** Constraint lists indexed by Level * (MaxColor + 1) + Color */
+			TArray<FConstraintList> LevelColorConstraints;
+
+			/** Particles (with their dynamic state) and constraints the island was colored with, in the order the coloring visits them */
+			TArray<UPTRINT> ColorKey;
+			TArray<UPTRINT> NewColorKey;
+
+			/** Coloring scratch, indexed by island node (@see NodeToIslandNode). Kept between steps to avoid reallocating */
+			TArray<int32> NextColors;
+			TArray<uint64> UsedColors;
+			TArray<bool> ProcessedNodes;
+			TArray<int32> NodesToProcess;
+			TArray<TPair<int32, int32>> LevelQueue;
 		};
 
-		TArray<FGraphNodeColor> Nodes;
+		/** Index of dynamic graph nodes within their island's coloring scratch */
+		TArray<int32> NodeToIslandNode;
 		TArray<FGraphEdgeColor> Edges;
 		TArray<FIslandColor> IslandData;
-		FLevelToColorToConstraintListMap EmptyLevelToColorToConstraintListMap;
-		TArray<int32> UpdatedNodes;
+		FConstraintList EmptyConstraintList;
 		bool bUseContactGraph;
 	};
 
@@ -290,7 +290,6 @@ namespace Chaos
 
 		virtual bool ApplyConstraints(const FReal Dt, int32 Island, const int32 It, const int32 NumIts) override
 		{
-			const typename FPBDConstraintColor::FLevelToColorToConstraintListMap& LevelToColorToConstraintListMap = GraphColor.GetIslandLevelToColorToConstraintListMap(Island);
 			int32 MaxColor = GraphColor.GetIslandMaxColor(Island);
 			int32 MaxLevel = GraphColor.GetIslandMaxLevel(Island);
 			bool bNeedsMoreIterations = false;
@@ -298,9 +297,9 @@ namespace Chaos
 			{
 				for (int32 Color = 0; Color <= MaxColor; ++Color)
 				{
-					if (LevelToColorToConstraintListMap[Level].Contains(Color) && LevelToColorToConstraintListMap[Level][Color].Num())
+					const TArray<typename FConstraints::FConstraintContainerHandle*>& ConstraintHandles = GetLevelColorConstraints(Island, Level, Color);
+					if (ConstraintHandles.Num())
 					{
-						const TArray<typename FConstraints::FConstraintContainerHandle*>& ConstraintHandles = GetLevelColorConstraints(LevelToColorToConstraintListMap, Level, Color);
 						bNeedsMoreIterations |= Constraints.Apply(Dt, ConstraintHandles, It, NumIts);
 					}
 				}
@@ -316,7 +315,6 @@ namespace Chaos
 
 		virtual bool ApplyPushOut(const FReal Dt, int32 Island, const int32 It, const int32 NumIts) override
 		{
-			const typename FPBDConstraintColor::FLevelToColorToConstraintListMap& LevelToColorToConstraintListMap = GraphColor.GetIslandLevelToColorToConstraintListMap(Island);
 			int32 MaxColor = GraphColor.GetIslandMaxColor(Island);
 			int32 MaxLevel = GraphColor.GetIslandMaxLevel(Island);
 
@@ -326,9 +324,9 @@ namespace Chaos
 			{
 				for (int32 Color = 0; Color <= MaxColor; ++Color)
 				{
-					if (LevelToColorToConstraintListMap[Level].Contains(Color) && LevelToColorToConstraintListMap[Level][Color].Num())
+					const TArray<typename FConstraints::FConstraintContainerHandle*>& ConstraintHandles = GetLevelColorConstraints(Island, Level, Color);
+					if (ConstraintHandles.Num())
 					{
-						const TArray<typename FConstraints::FConstraintContainerHandle*>& ConstraintHandles = GetLevelColorConstraints(LevelToColorToConstraintListMap, Level, Color);
 						if (Constraints.ApplyPushOut(Dt, ConstraintHandles, IsTemporarilyStatic, It, NumIts))
 						{
 							bNeedsAnotherIteration = true;
@@ -340,27 +338,24 @@ namespace Chaos
 #if USE_SHOCK_PROPOGATION
 				for (int32 Color = 0; Color <= MaxColor; ++Color)
 				{
-					if (LevelToColorToConstraintListMap[Level].Contains(Color))
-					{
-						const TArray<typename FConstraints::FConstraintContainerHandle*>& ConstraintHandles = GetLevelColorConstraints(LevelToColorToConstraintListMap, Level, Color);
+					const TArray<typename FConstraints::FConstraintContainerHandle*>& ConstraintHandles = GetLevelColorConstraints(Island, Level, Color);
 
-						for (int32 Edge = 0; Edge < ConstraintHandles.Num(); ++Edge)
+					for (int32 Edge = 0; Edge < ConstraintHandles.Num(); ++Edge)
+					{
+						const typename FConstraints::FConstraintContainerHandle* Handle = ConstraintHandles[Edge];
+						TVector<const TGeometryParticleHandle<FReal, 3>*, 2> Particles = Handle->GetConstrainedParticles();
+						if (It == NumIts - 1)
 						{
-							const typename FConstraints::FConstraintContainerHandle* Handle = ConstraintHandles[Edge];
-							TVector<const TGeometryParticleHandle<FReal, 3>*, 2> Particles = Handle->GetConstrainedParticles();
-							if (It == NumIts - 1)
+							const bool bIsParticleDynamic0 = Particles[0]->CastToRigidParticle() && Particles[0]->ObjectState() == EObjectStateType::Dynamic;
+							const bool bIsParticleDynamic1 = Particles[1]->CastToRigidParticle() && Particles[1]->ObjectState() == EObjectStateType::Dynamic;
+
+							if (bIsParticleDynamic0 == false || IsTemporarilyStatic.Contains(Particles[0]))
+							{
+								IsTemporarilyStatic.Add(Particles[1]);
+							}
+							else if (bIsParticleDynamic1 == false || IsTemporarilyStatic.Contains(Particles[1]))
 							{
-								const bool bIsParticleDynamic0 = Particles[0]->CastToRigidParticle() && Particles[0]->ObjectState() == EObjectStateType::Dynamic;
-								const bool bIsParticleDynamic1 = Particles[1]->CastToRigidParticle() && Particles[1]->ObjectState() == EObjectStateType::Dynamic;
-
-								if (bIsParticleDynamic0 == false || IsTemporarilyStatic.Contains(Particles[0]))
-								{
-									IsTemporarilyStatic.Add(Particles[1]);
-								}
-								else if (bIsParticleDynamic1 == false || IsTemporarilyStatic.Contains(Particles[1]))
-								{
-									IsTemporarilyStatic.Add(Particles[0]);
-								}
+								IsTemporarilyStatic.Add(Particles[0]);
 							}
 						}
 					}
@@ -389,16 +384,15 @@ namespace Chaos
 		template<typename TVisitor>
 		void VisitIslandConstraints(const int32 Island, const TVisitor& Visitor) const
 		{
-			const typename FPBDConstraintColor::FLevelToColorToConstraintListMap& LevelToColorToConstraintListMap = GraphColor.GetIslandLevelToColorToConstraintListMap(Island);
 			int32 MaxColor = GraphColor.GetIslandMaxColor(Island);
 			int32 MaxLevel = GraphColor.GetIslandMaxLevel(Island);
 			for (int32 Level = 0; Level <= MaxLevel; ++Level)
 			{
 				for (int32 Color = 0; Color <= MaxColor; ++Color)
 				{
-					if (LevelToColorToConstraintListMap[Level].Contains(Color) && LevelToColorToConstraintListMap[Level][Color].Num())
+					const TArray<typename FConstraints::FConstraintContainerHandle*>& ConstraintHandles = GetLevelColorConstraints(Island, Level, Color);
+					if (ConstraintHandles.Num())
 					{
-						const TArray<typename FConstraints::FConstraintContainerHandle*>& ConstraintHandles = GetLevelColorConstraints(LevelToColorToConstraintListMap, Level, Color);
 						Visitor(ConstraintHandles);
 					}
 				}
@@ -410,10 +404,10 @@ namespace Chaos
 		using Base::ConstraintGraph;
 		using Base::ContainerId;
 
-		const TArray<typename FConstraints::FConstraintContainerHandle*>& GetLevelColorConstraints(const typename FPBDConstraintColor::FLevelToColorToConstraintListMap& LevelToColorToConstraintListMap, int32 Level, int32 Color) const
+		const TArray<typename FConstraints::FConstraintContainerHandle*>& GetLevelColorConstraints(int32 Island, int32 Level, int32 Color) const
 		{
 			// FPBDConstraintColor works with any constraint type (in principle - currently only used with Collisions), but the rule is bound to a single type and so this cast is ok
-			return reinterpret_cast<const TArray<typename FConstraints::FConstraintContainerHandle*>&>(LevelToColorToConstraintListMap[Level][Color]);
+			return reinterpret_cast<const TArray<typename FConstraints::FConstraintContainerHandle*>&>(GraphColor.GetIslandConstraints(Island, Level, Color));
 		}
 
 		FPBDConstraintColor GraphColor;
@@ -212,5 +212,8 @@ namespace Chaos
 		FPBDRigidsEvolutionIslandCallback PostApplyCallback;
 		FPBDRigidsEvolutionIslandCallback PostApplyPushOutCallback;
 		FPBDRigidsEvolutionInternalHandleCallback InternalParticleInitilization;
+
+		/** Island indices sorted by decreasing solve cost, rebuilt every step */
+		TArray<int32> IslandSolveOrder;
 	};
 }
@@ -32,6 +32,8 @@
 #include "ProfilingDebugging/MiscTrace.h"
 #include "ProfilingDebugging/PlatformFileTrace.h"
 #include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/FlightRecorderTrace.h"
+#include "HAL/MallocSamplingProfiler.h"
 #if WITH_ENGINE
 #include "HAL/PlatformSplash.h"
 #endif
@@ -1381,6 +1383,14 @@ int32 FEngineLoop::PreInitPreStartupScreen(const TCHAR* CmdLine)
 		TRACE_CPUPROFILER_INIT(CmdLine);
 		TRACE_PLATFORMFILE_INIT(CmdLine);
 		TRACE_COUNTERS_INIT(CmdLine);
+		TRACE_FLIGHTRECORDER_INIT(CmdLine);
+	}
+#endif
+
+#if USE_MALLOC_SAMPLING_PROFILER
+	if (GMallocSamplingProfiler)
+	{
+		GMallocSamplingProfiler->ProcessCommandLine(CmdLine);
 	}
 #endif
 
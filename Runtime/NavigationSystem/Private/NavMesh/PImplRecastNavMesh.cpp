@@ -17,6 +17,7 @@
 #include "NavMesh/RecastQueryFilter.h"
 #include "NavLinkCustomInterface.h"
 #include "VisualLogger/VisualLogger.h"
+#include "Misc/ScopeRWLock.h"
 
 
 //----------------------------------------------------------------------//
@@ -33,13 +34,13 @@ static_assert(RECAST_UNWALKABLE_POLY_COST == DT_UNWALKABLE_POLY_COST, "Unwalkabl
 
 /// Helper for accessing navigation query from different threads
 #define INITIALIZE_NAVQUERY_SIMPLE(NavQueryVariable, NumNodes)	\
-	dtNavMeshQuery NavQueryVariable##Private;	\
-	dtNavMeshQuery& NavQueryVariable = IsInGameThread() ? SharedNavQuery : NavQueryVariable##Private; \
+	FRecastNavQueryScope NavQueryVariable##Scope(*this);	\
+	dtNavMeshQuery& NavQueryVariable = NavQueryVariable##Scope.Get(); \
 	NavQueryVariable.init(DetourNavMesh, NumNodes);
 
 #define INITIALIZE_NAVQUERY(NavQueryVariable, NumNodes, LinkFilter)	\
-	dtNavMeshQuery NavQueryVariable##Private;	\
-	dtNavMeshQuery& NavQueryVariable = IsInGameThread() ? SharedNavQuery : NavQueryVariable##Private; \
+	FRecastNavQueryScope NavQueryVariable##Scope(*this);	\
+	dtNavMeshQuery& NavQueryVariable = NavQueryVariable##Scope.Get(); \
 	NavQueryVariable.init(DetourNavMesh, NumNodes, &LinkFilter);
 
 static void* DetourMalloc(int Size, dtAllocHint)
@@ -269,17 +270,77 @@ FPImplRecastNavMesh::~FPImplRecastNavMesh()
 {
 	ReleaseDetourNavMesh();
 
+	while (dtNavMeshQuery* NavQuery = NavQueryPool.Pop())
+	{
+		dtFreeNavMeshQuery(NavQuery);
+	}
+
 	DEC_DWORD_STAT_BY( STAT_NavigationMemory, sizeof(*this) );
 };
 
+dtNavMeshQuery* FPImplRecastNavMesh::AcquireNavQuery() const
+{
+	dtNavMeshQuery* NavQuery = NavQueryPool.Pop();
+	return NavQuery ? NavQuery : dtAllocNavMeshQuery();
+}
+
+void FPImplRecastNavMesh::ReleaseNavQuery(dtNavMeshQuery* NavQuery) const
+{
+	check(NavQuery);
+	NavQueryPool.Push(NavQuery);
+}
+
+/** navmesh which tile data is read locked by current thread, so nested query scopes don't lock it again */
+static thread_local const FPImplRecastNavMesh* GReadLockedNavMeshImpl = nullptr;
+
+FRecastNavQueryScope::FRecastNavQueryScope(const FPImplRecastNavMesh& InNavMeshImpl)
+	: NavMeshImpl(InNavMeshImpl)
+	, PrevLockedNavMeshImpl(nullptr)
+	, bPooled(!IsInGameThread())
+	, bReadLocked(false)
+{
+	if (bPooled)
+	{
+		NavQuery = NavMeshImpl.AcquireNavQuery();
+
+		if (GReadLockedNavMeshImpl != &NavMeshImpl)
+		{
+			NavMeshImpl.GetTileDataLock().ReadLock();
+			PrevLockedNavMeshImpl = GReadLockedNavMeshImpl;
+			GReadLockedNavMeshImpl = &NavMeshImpl;
+			bReadLocked = true;
+		}
+	}
+	else
+	{
+		// tiles are modified only on game thread, no need to lock them
+		NavQuery = &NavMeshImpl.SharedNavQuery;
+	}
+}
+
+FRecastNavQueryScope::~FRecastNavQueryScope()
+{
+	if (bPooled)
+	{
+		if (bReadLocked)
+		{
+			GReadLockedNavMeshImpl = PrevLockedNavMeshImpl;
+			NavMeshImpl.GetTileDataLock().ReadUnlock();
+		}
+
+		NavMeshImpl.ReleaseNavQuery(NavQuery);
+	}
+}
+
 void FPImplRecastNavMesh::ReleaseDetourNavMesh()
 {
 	// release navmesh only if we own it
 	if (DetourNavMesh != nullptr)
 	{
+		FRWScopeLock TileDataWriteLock(TileDataLock, SLT_Write);
 		dtFreeNavMesh(DetourNavMesh);
+		DetourNavMesh = nullptr;
 	}
-	DetourNavMesh = nullptr;
 	
 	CompressedTileCacheLayers.Empty();
 
@@ -727,7 +788,10 @@ void FPImplRecastNavMesh::SetRecastMesh(dtNavMesh* NavMesh)
 	}
 
 	ReleaseDetourNavMesh();
-	DetourNavMesh = NavMesh;
+	{
+		FRWScopeLock TileDataWriteLock(TileDataLock, SLT_Write);
+		DetourNavMesh = NavMesh;
+	}
 
 	if (NavMeshOwner)
 	{
@@ -1584,6 +1648,7 @@ void FPImplRecastNavMesh::UpdateNavigationLinkArea(int32 UserId, uint8 AreaType,
 {
 	if (DetourNavMesh)
 	{
+		FRWScopeLock TileDataWriteLock(TileDataLock, SLT_Write);
 		DetourNavMesh->updateOffMeshConnectionByUserId(UserId, AreaType, PolyFlags);
 	}
 }
@@ -1592,6 +1657,7 @@ void FPImplRecastNavMesh::UpdateSegmentLinkArea(int32 UserId, uint8 AreaType, ui
 {
 	if (DetourNavMesh)
 	{
+		FRWScopeLock TileDataWriteLock(TileDataLock, SLT_Write);
 		DetourNavMesh->updateOffMeshSegmentConnectionByUserId(UserId, AreaType, PolyFlags);
 	}
 }
@@ -1681,6 +1747,7 @@ void FPImplRecastNavMesh::SetPolyAreaID(NavNodeRef PolyID, uint8 AreaID)
 {
 	if (DetourNavMesh)
 	{
+		FRWScopeLock TileDataWriteLock(TileDataLock, SLT_Write);
 		DetourNavMesh->setPolyArea((dtPolyRef)PolyID, AreaID);
 	}
 }
@@ -2690,6 +2757,7 @@ void FPImplRecastNavMesh::ApplyWorldOffset(const FVector& InOffset, bool bWorldS
 		// transform offset to Recast space
 		const FVector OffsetRC = Unreal2RecastPoint(InOffset);
 		// apply offset
+		FRWScopeLock TileDataWriteLock(TileDataLock, SLT_Write);
 		DetourNavMesh->applyWorldOffset(&OffsetRC.X);
 	}
 }
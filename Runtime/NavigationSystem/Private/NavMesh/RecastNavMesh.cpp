@@ -2,6 +2,7 @@
 
 #include "NavMesh/RecastNavMesh.h"
 #include "Misc/Paths.h"
+#include "Misc/ScopeRWLock.h"
 #include "EngineGlobals.h"
 #include "Engine/World.h"
 #include "NavigationSystem.h"
@@ -33,13 +34,13 @@
 #if WITH_RECAST
 /// Helper for accessing navigation query from different threads
 #define INITIALIZE_NAVQUERY(NavQueryVariable, NumNodes)	\
-	dtNavMeshQuery NavQueryVariable##Private;	\
-	dtNavMeshQuery& NavQueryVariable = IsInGameThread() ? RecastNavMeshImpl->SharedNavQuery : NavQueryVariable##Private; \
+	FRecastNavQueryScope NavQueryVariable##Scope(*RecastNavMeshImpl);	\
+	dtNavMeshQuery& NavQueryVariable = NavQueryVariable##Scope.Get(); \
 	NavQueryVariable.init(RecastNavMeshImpl->DetourNavMesh, NumNodes);
 
 #define INITIALIZE_NAVQUERY_WLINKFILTER(NavQueryVariable, NumNodes, LinkFilter)	\
-	dtNavMeshQuery NavQueryVariable##Private;	\
-	dtNavMeshQuery& NavQueryVariable = IsInGameThread() ? RecastNavMeshImpl->SharedNavQuery : NavQueryVariable##Private; \
+	FRecastNavQueryScope NavQueryVariable##Scope(*RecastNavMeshImpl);	\
+	dtNavMeshQuery& NavQueryVariable = NavQueryVariable##Scope.Get(); \
 	NavQueryVariable.init(RecastNavMeshImpl->DetourNavMesh, NumNodes, &LinkFilter);
 
 #endif // WITH_RECAST
@@ -1492,6 +1493,9 @@ bool ARecastNavMesh::SetPolyArea(NavNodeRef PolyID, TSubclassOf<UNavArea> AreaCl
 		
 		if (AreaId != INDEX_NONE && NavMesh)
 		{
+			// tiles can be searched by queries on other threads
+			FRWScopeLock TileDataWriteLock(RecastNavMeshImpl->GetTileDataLock(), SLT_Write);
+
 			// @todo implement a single detour function that would do both
 			bSuccess = dtStatusSucceed(NavMesh->setPolyArea(PolyID, AreaId));
 			bSuccess = (bSuccess && dtStatusSucceed(NavMesh->setPolyFlags(PolyID, AreaFlags)));
@@ -1510,6 +1514,9 @@ void ARecastNavMesh::SetPolyArrayArea(const TArray<FNavPoly>& Polys, TSubclassOf
 
 		if (AreaId != INDEX_NONE && NavMesh)
 		{
+			// tiles can be searched by queries on other threads
+			FRWScopeLock TileDataWriteLock(RecastNavMeshImpl->GetTileDataLock(), SLT_Write);
+
 			for (int32 Idx = 0; Idx < Polys.Num(); Idx++)
 			{
 				NavMesh->setPolyArea(Polys[Idx].Ref, AreaId);
@@ -1542,6 +1549,9 @@ int32 ARecastNavMesh::ReplaceAreaInTileBounds(const FBox& Bounds, TSubclassOf<UN
 		const float TileSizeInWorldUnits = RcTileSize * CellSize;
 		const FRcTileBox TileBox(Bounds, RcNavMeshOrigin, TileSizeInWorldUnits);
 
+		// tiles can be searched by queries on other threads
+		FRWScopeLock TileDataWriteLock(RecastNavMeshImpl->GetTileDataLock(), SLT_Write);
+
 		for (int32 TileY = TileBox.YMin; TileY <= TileBox.YMax; ++TileY)
 		{
 			for (int32 TileX = TileBox.XMin; TileX <= TileBox.XMax; ++TileX)
@@ -2502,12 +2512,7 @@ void ARecastNavMesh::UpdateGenerationProperties(const FRecastNavMeshGenerationPr
 
 bool ARecastNavMesh::IsVoxelCacheEnabled()
 {
-#if RECAST_ASYNC_REBUILDING
-	// voxel cache is using static buffers to minimize memory impact
-	// therefore it can run only with synchronous navmesh rebuilds
-	return false;
-#endif
-
+	// voxel cache is rasterized using per thread buffers, so it works with asynchronous navmesh rebuilds too
 	ARecastNavMesh* DefOb = (ARecastNavMesh*)ARecastNavMesh::StaticClass()->GetDefaultObject();
 	return DefOb && DefOb->bUseVoxelCache;
 }
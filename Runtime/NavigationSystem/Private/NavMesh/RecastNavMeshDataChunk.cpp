@@ -2,6 +2,7 @@
 
 #include "NavMesh/RecastNavMeshDataChunk.h"
 #include "Engine/World.h"
+#include "Misc/ScopeRWLock.h"
 #include "NavigationSystem.h"
 #include "NavMesh/RecastNavMesh.h"
 #include "NavMesh/PImplRecastNavMesh.h"
@@ -176,6 +177,8 @@ TArray<uint32> URecastNavMeshDataChunk::AttachTiles(FPImplRecastNavMesh& NavMesh
 
 	if (NavMesh != nullptr)
 	{
+		FRWScopeLock TileDataWriteLock(NavMeshImpl.GetTileDataLock(), SLT_Write);
+
 		for (FRecastTileData& TileData : Tiles)
 		{
 			if (!TileData.bAttached && TileData.TileRawData.IsValid())
@@ -255,6 +258,8 @@ TArray<uint32> URecastNavMeshDataChunk::DetachTiles(FPImplRecastNavMesh& NavMesh
 
 	if (NavMesh != nullptr)
 	{
+		FRWScopeLock TileDataWriteLock(NavMeshImpl.GetTileDataLock(), SLT_Write);
+
 		for (FRecastTileData& TileData : Tiles)
 		{
 			if (TileData.bAttached)
@@ -6,6 +6,8 @@
 #include "HAL/FileManager.h"
 #include "Misc/Paths.h"
 #include "Serialization/MemoryWriter.h"
+#include "Misc/ScopeRWLock.h"
+#include "Misc/ScopeLock.h"
 #include "EngineGlobals.h"
 #include "GameFramework/PlayerController.h"
 #include "Engine/Engine.h"
@@ -1764,6 +1766,13 @@ struct FVoxelCacheRasterizeContext
 
 	void Create(int32 FieldSize, float CellSize, float CellHeight)
 	{
+		if (RasterizeHF && (RasterizeHF->width != FieldSize || RasterizeHF->cs != CellSize || RasterizeHF->ch != CellHeight))
+		{
+			// set up for a navmesh with different config
+			rcFreeHeightField(RasterizeHF);
+			RasterizeHF = NULL;
+		}
+
 		if (RasterizeHF == NULL)
 		{
 			const float DummyBounds[3] = { 0 };
@@ -1794,7 +1803,14 @@ struct FVoxelCacheRasterizeContext
 	rcHeightfield* RasterizeHF;
 };
 
-static FVoxelCacheRasterizeContext VoxelCacheContext;
+/** one per thread, so tile generators running on different workers can prepare voxel caches at the same time */
+static thread_local FVoxelCacheRasterizeContext VoxelCacheContext;
+
+/** guards voxel caches stored in navigation octree's elements, those are shared by all tile generators */
+static FCriticalSection VoxelCacheLock;
+
+/** guards lazy data gathering and slice export preparation of navigation octree's elements done by tile generators on workers */
+static FCriticalSection LazyGatheringLock;
 
 uint32 GetTileCacheSizeHelper(TArray<FNavMeshTileData>& CompressedTiles)
 {
@@ -1902,6 +1918,12 @@ void FRecastTileGenerator::Setup(const FRecastNavMeshGenerator& ParentGenerator,
 	const FBox RCBox = Unreal2RecastBox(TileBB);
 	rcVcopy(TileConfig.bmin, &RCBox.Min.X);
 	rcVcopy(TileConfig.bmax, &RCBox.Max.X);
+
+	VoxelCacheConfigHash = HashCombine(GetTypeHash(TileConfig.cs), GetTypeHash(TileConfig.ch));
+	VoxelCacheConfigHash = HashCombine(VoxelCacheConfigHash, HashCombine(GetTypeHash(TileConfig.tileSize), GetTypeHash(TileConfig.borderSize)));
+	VoxelCacheConfigHash = HashCombine(VoxelCacheConfigHash, HashCombine(GetTypeHash(TileConfig.AgentRadius), GetTypeHash(TileConfig.AgentHeight)));
+	VoxelCacheConfigHash = HashCombine(VoxelCacheConfigHash, HashCombine(GetTypeHash(TileConfig.walkableClimb), GetTypeHash(TileConfig.walkableSlopeAngle)));
+	VoxelCacheConfigHash = HashCombine(VoxelCacheConfigHash, GetTypeHash(FVector(TileConfig.bmin[0], TileConfig.bmin[1], TileConfig.bmin[2])));
 			
 	// from passed in boxes pick the ones overlapping with tile bounds
 	bFullyEncapsulatedByInclusionBounds = true;
@@ -1975,6 +1997,7 @@ bool FRecastTileGenerator::HasDataToBuild() const
 		|| Modifiers.Num()
 		|| OffmeshLinks.Num()
 		|| RawGeometry.Num()
+		|| StaticVoxels.Num()
 		|| (InclusionBounds.Num() && NavigationRelevantData.Num() > 0);
 }
 
@@ -2055,6 +2078,7 @@ bool FRecastTileGenerator::DoWork()
 void FRecastTileGenerator::DumpAsyncData()
 {
 	RawGeometry.Empty();
+	StaticVoxels.Empty();
 	Modifiers.Empty();
 	OffmeshLinks.Empty();
 
@@ -2068,6 +2092,8 @@ bool FRecastTileGenerator::DoAsyncGeometryGathering()
 
 	const bool bRetVal = NavigationRelevantData.Num() > 0;
 
+	// shared elements are only written when gathering their lazy data (guarded by LazyGatheringLock) and
+	// voxel caches (guarded by VoxelCacheLock), other tile generators can be reading the same elements
 	for (auto& ElementData : NavigationRelevantData)
 	{
 		if (ElementData->GetOwner() == nullptr)
@@ -2076,76 +2102,65 @@ bool FRecastTileGenerator::DoAsyncGeometryGathering()
 			continue;
 		}
 
-		bool bDumpGeometryData = false;
-		if (ElementData->IsPendingLazyGeometryGathering() && ElementData->SupportsGatheringGeometrySlices())
 		{
-			QUICK_SCOPE_CYCLE_COUNTER(STAT_RecastNavMeshGenerator_LandscapeSlicesExporting);
-
-			FRecastGeometryExport GeomExport(*ElementData);
-
-			INavRelevantInterface* NavRelevant = Cast<INavRelevantInterface>(ElementData->GetOwner());
-			if(NavRelevant)
-			{
-				NavRelevant->PrepareGeometryExportSync();
-				// adding a small bump to avoid special case of zero-expansion when tile bounds
-				// overlap landscape's tile bounds
-				NavRelevant->GatherGeometrySlice(GeomExport, TileBBExpandedForAgent);
-
-				RecastGeometryExport::CovertCoordDataToRecast(GeomExport.VertexBuffer);
-				RecastGeometryExport::StoreCollisionCache(GeomExport);
-				bDumpGeometryData = true;
-			}
-			else
+			FScopeLock Lock(&LazyGatheringLock);
+			if ((ElementData->IsPendingLazyGeometryGathering() && ElementData->SupportsGatheringGeometrySlices() == false)
+				|| ElementData->IsPendingLazyModifiersGathering())
 			{
-				UE_LOG(LogNavigation, Error, TEXT("DoAsyncGeometryGathering: got an invalid NavRelevant instance!"));
+				QUICK_SCOPE_CYCLE_COUNTER(STAT_RecastNavMeshGenerator_LazyGeometryExport);
+				NavOctree->DemandLazyDataGathering(*ElementData);
 			}
 		}
 
-		if (ElementData->IsPendingLazyGeometryGathering() || ElementData->IsPendingLazyModifiersGathering())
-		{
-			NavOctree->DemandLazyDataGathering(*ElementData);
-		}
-
 		const FCompositeNavModifier ModifierInstance = ElementData->Modifiers.HasMetaAreas() ? ElementData->Modifiers.GetInstantiatedMetaModifier(&NavDataConfig, ElementData->SourceObject) : ElementData->Modifiers;
 
-		const bool bExportGeometry = bUpdateGeometry && ElementData->HasGeometry();
-		if (bExportGeometry)
+		if (bUpdateGeometry && ElementData->IsPendingLazyGeometryGathering() && ElementData->SupportsGatheringGeometrySlices())
 		{
-			if (ARecastNavMesh::IsVoxelCacheEnabled())
+			const bool bUseVoxelCache = ARecastNavMesh::IsVoxelCacheEnabled();
+			if (bUseVoxelCache == false || AppendCachedVoxels(*ElementData) == false)
 			{
-				TNavStatArray<rcSpanCache> SpanData;
-				rcSpanCache* CachedVoxels = 0;
-				int32 NumCachedVoxels = 0;
+				QUICK_SCOPE_CYCLE_COUNTER(STAT_RecastNavMeshGenerator_LandscapeSlicesExporting);
 
-				DECLARE_SCOPE_CYCLE_COUNTER(TEXT("Rasterization: prepare voxel cache"), Stat_RecastRasterCachePrep, STATGROUP_Navigation);
+				// slice is exported to tile's own data, other tiles can be exporting slices of the same element
+				TSharedRef<FNavigationRelevantData, ESPMode::ThreadSafe> SliceData = MakeShareable(new FNavigationRelevantData(*ElementData->GetOwner()));
+				FRecastGeometryExport GeomExport(*SliceData);
 
-				if (!HasVoxelCache(ElementData->VoxelData, CachedVoxels, NumCachedVoxels))
+				INavRelevantInterface* NavRelevant = Cast<INavRelevantInterface>(ElementData->GetOwner());
+				if (NavRelevant)
 				{
-					// rasterize
-					PrepareVoxelCache(ElementData->CollisionData, ModifierInstance, SpanData);
-					CachedVoxels = SpanData.GetData();
-					NumCachedVoxels = SpanData.Num();
-
-					// encode
-					const int32 PrevElementMemory = ElementData->GetAllocatedSize();
-					FNavigationRelevantData* ModData = (FNavigationRelevantData*)&ElementData;
-					AddVoxelCache(ModData->VoxelData, CachedVoxels, NumCachedVoxels);
-
-					const int32 NewElementMemory = ElementData->GetAllocatedSize();
-					const int32 ElementMemoryDelta = NewElementMemory - PrevElementMemory;
-					INC_MEMORY_STAT_BY(STAT_Navigation_CollisionTreeMemory, ElementMemoryDelta);
-				}
-			}
-			else
-			{
-				ValidateAndAppendGeometry(ElementData, ModifierInstance);
-			}
+					{
+						// Preparing slice export isn't thread safe (landscape caches its height field samples on first use),
+						// exporting slices only reads prepared data
+						FScopeLock Lock(&LazyGatheringLock);
+						NavRelevant->PrepareGeometryExportSync();
+					}
 
-			if (bDumpGeometryData)
-			{
-				const_cast<FNavigationRelevantData&>(*ElementData).CollisionData.Empty();
+					// adding a small bump to avoid special case of zero-expansion when tile bounds
+					// overlap landscape's tile bounds
+					NavRelevant->GatherGeometrySlice(GeomExport, TileBBExpandedForAgent);
+
+					RecastGeometryExport::CovertCoordDataToRecast(GeomExport.VertexBuffer);
+					RecastGeometryExport::StoreCollisionCache(GeomExport);
+
+					if (bUseVoxelCache)
+					{
+						AppendAndCacheVoxels(const_cast<FNavigationRelevantData&>(*ElementData), SliceData->CollisionData, ModifierInstance);
+					}
+					else
+					{
+						ValidateAndAppendGeometry(SliceData, ModifierInstance);
+					}
+				}
+				else
+				{
+					UE_LOG(LogNavigation, Error, TEXT("DoAsyncGeometryGathering: got an invalid NavRelevant instance!"));
+				}
 			}
 		}
+		else if (bUpdateGeometry && ElementData->HasGeometry())
+		{
+			AppendElementGeometry(ElementData, ModifierInstance);
+		}
 
 		if (ModifierInstance.IsEmpty() == false)
 		{
@@ -2174,6 +2189,7 @@ void FRecastTileGenerator::PrepareGeometrySources(const FRecastNavMeshGenerator&
 		const bool bShouldUse = Element.ShouldUseGeometry(NavDataConfig);
 		if (bShouldUse)
 		{
+			// only a snapshot of the sources is taken on game thread, their lazy data is gathered by the worker
 			const bool bExportGeometry = bGeometryChanged && (Element.Data->HasGeometry() || Element.Data->IsPendingLazyGeometryGathering());
 			if (bExportGeometry
 				|| (Element.Data->IsPendingLazyModifiersGathering() || Element.Data->Modifiers.HasMetaAreas() == true || Element.Data->Modifiers.IsEmpty() == false))
@@ -2244,35 +2260,7 @@ void FRecastTileGenerator::GatherGeometry(const FRecastNavMeshGenerator& ParentG
 			const bool bExportGeometry = bGeometryChanged && Element.Data->HasGeometry();
 			if (bExportGeometry)
 			{
-				if (ARecastNavMesh::IsVoxelCacheEnabled())
-				{
-					TNavStatArray<rcSpanCache> SpanData;
-					rcSpanCache* CachedVoxels = 0;
-					int32 NumCachedVoxels = 0;
-
-					DECLARE_SCOPE_CYCLE_COUNTER(TEXT("Rasterization: prepare voxel cache"), Stat_RecastRasterCachePrep, STATGROUP_Navigation);
-
-					if (!HasVoxelCache(Element.Data->VoxelData, CachedVoxels, NumCachedVoxels))
-					{
-						// rasterize
-						PrepareVoxelCache(Element.Data->CollisionData, ModifierInstance, SpanData);
-						CachedVoxels = SpanData.GetData();
-						NumCachedVoxels = SpanData.Num();
-
-						// encode
-						const int32 PrevElementMemory = Element.Data->GetAllocatedSize();
-						FNavigationRelevantData* ModData = (FNavigationRelevantData*)&Element.Data;
-						AddVoxelCache(ModData->VoxelData, CachedVoxels, NumCachedVoxels);
-
-						const int32 NewElementMemory = Element.Data->GetAllocatedSize();
-						const int32 ElementMemoryDelta = NewElementMemory - PrevElementMemory;
-						INC_MEMORY_STAT_BY(STAT_Navigation_CollisionTreeMemory, ElementMemoryDelta);
-					}
-				}
-				else
-				{
-					ValidateAndAppendGeometry(Element.Data, ModifierInstance);
-				}
+				AppendElementGeometry(Element.Data, ModifierInstance);
 
 				if (bDumpGeometryData)
 				{
@@ -2399,13 +2387,14 @@ void FRecastTileGenerator::ApplyVoxelFilter(rcHeightfield* HF, float WalkableRad
 
 void FRecastTileGenerator::PrepareVoxelCache(const TNavStatArray<uint8>& RawCollisionCache, const FCompositeNavModifier& InModifier, TNavStatArray<rcSpanCache>& SpanData)
 {
-	// tile's geometry: voxel cache (only for synchronous rebuilds)
+	// tile's geometry: voxel cache
 	const int32 WalkableClimbVX = TileConfig.walkableClimb;
 	const float WalkableSlopeCos = FMath::Cos(FMath::DegreesToRadians(TileConfig.walkableSlopeAngle));
 	const float RasterizationPadding = TileConfig.borderSize * TileConfig.cs;
 
 	FRecastGeometryCache CachedCollisions(RawCollisionCache.GetData());
 
+	VoxelCacheContext.Create(TileConfig.tileSize + TileConfig.borderSize * 2, TileConfig.cs, TileConfig.ch);
 	VoxelCacheContext.SetupForTile(TileConfig.bmin, TileConfig.bmax, RasterizationPadding);
 
 	float SlopeCosPerActor = WalkableSlopeCos;
@@ -2441,7 +2430,7 @@ bool FRecastTileGenerator::HasVoxelCache(const TNavStatArray<uint8>& RawVoxelCac
 	FRecastVoxelCache VoxelCache(RawVoxelCache.GetData());
 	for (FRecastVoxelCache::FTileInfo* iTile = VoxelCache.Tiles; iTile; iTile = iTile->NextTile)
 	{
-		if (iTile->TileX == TileX && iTile->TileY == TileY)
+		if (iTile->TileX == TileX && iTile->TileY == TileY && iTile->ConfigHash == VoxelCacheConfigHash)
 		{
 			CachedVoxels = iTile->SpanData;
 			NumCachedVoxels = iTile->NumSpans;
@@ -2472,10 +2461,77 @@ void FRecastTileGenerator::AddVoxelCache(TNavStatArray<uint8>& RawVoxelCache, co
 	TileInfo->TileX = TileX;
 	TileInfo->TileY = TileY;
 	TileInfo->NumSpans = NumCachedVoxels;
+	TileInfo->ConfigHash = VoxelCacheConfigHash;
 
 	FMemory::Memcpy(RawVoxelCache.GetData() + NewCacheIdx + HeaderSize, CachedVoxels, VoxelsSize);
 }
 
+void FRecastTileGenerator::AppendVoxels(rcSpanCache* SpanData, int32 NumSpans)
+{
+	if (NumSpans)
+	{
+		const int32 FirstSpan = StaticVoxels.AddUninitialized(NumSpans);
+		FMemory::Memcpy(StaticVoxels.GetData() + FirstSpan, SpanData, NumSpans * sizeof(rcSpanCache));
+	}
+}
+
+void FRecastTileGenerator::AppendElementGeometry(TSharedRef<FNavigationRelevantData, ESPMode::ThreadSafe> ElementData, const FCompositeNavModifier& InModifier)
+{
+	// voxel cache doesn't store per instance transforms, instanced geometry is always rasterized from collision data
+	if (ARecastNavMesh::IsVoxelCacheEnabled() && ElementData->NavDataPerInstanceTransformDelegate.IsBound() == false)
+	{
+		if (AppendCachedVoxels(*ElementData) == false && ElementData->IsCollisionDataValid())
+		{
+			AppendAndCacheVoxels(ElementData.Get(), ElementData->CollisionData, InModifier);
+		}
+	}
+	else
+	{
+		ValidateAndAppendGeometry(ElementData, InModifier);
+	}
+}
+
+bool FRecastTileGenerator::AppendCachedVoxels(const FNavigationRelevantData& CacheOwner)
+{
+	FScopeLock Lock(&VoxelCacheLock);
+
+	rcSpanCache* CachedVoxels = 0;
+	int32 NumCachedVoxels = 0;
+	if (HasVoxelCache(CacheOwner.VoxelData, CachedVoxels, NumCachedVoxels))
+	{
+		// copy while locked, cache's memory can be reallocated by other tile generators
+		AppendVoxels(CachedVoxels, NumCachedVoxels);
+		return true;
+	}
+
+	return false;
+}
+
+void FRecastTileGenerator::AppendAndCacheVoxels(FNavigationRelevantData& CacheOwner, const TNavStatArray<uint8>& RawCollisionCache, const FCompositeNavModifier& InModifier)
+{
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("Rasterization: prepare voxel cache"), Stat_RecastRasterCachePrep, STATGROUP_Navigation);
+
+	// rasterize
+	TNavStatArray<rcSpanCache> SpanData;
+	PrepareVoxelCache(RawCollisionCache, InModifier, SpanData);
+	AppendVoxels(SpanData.GetData(), SpanData.Num());
+
+	// encode
+	FScopeLock Lock(&VoxelCacheLock);
+
+	rcSpanCache* CachedVoxels = 0;
+	int32 NumCachedVoxels = 0;
+	if (HasVoxelCache(CacheOwner.VoxelData, CachedVoxels, NumCachedVoxels) == false)
+	{
+		const int32 PrevElementMemory = CacheOwner.GetAllocatedSize();
+		AddVoxelCache(CacheOwner.VoxelData, SpanData.GetData(), SpanData.Num());
+
+		const int32 NewElementMemory = CacheOwner.GetAllocatedSize();
+		const int32 ElementMemoryDelta = NewElementMemory - PrevElementMemory;
+		INC_MEMORY_STAT_BY(STAT_Navigation_CollisionTreeMemory, ElementMemoryDelta);
+	}
+}
+
 void FRecastTileGenerator::AppendModifier(const FCompositeNavModifier& Modifier, const FNavDataPerInstanceTransformDelegate& InTransformsDelegate)
 {
 	// append all offmesh links (not included in compress layers)
@@ -2692,7 +2748,7 @@ bool FRecastTileGenerator::CreateHeightField(FNavMeshBuildContext& BuildContext,
 	BuildContext.log(RC_LOG_PROGRESS, "CreateHeightField:");
 	BuildContext.log(RC_LOG_PROGRESS, " - %d x %d cells", TileConfig.width, TileConfig.height);
 
-	const bool bHasGeometry = RawGeometry.Num() > 0;
+	const bool bHasGeometry = RawGeometry.Num() > 0 || StaticVoxels.Num() > 0;
 
 	// Allocate voxel heightfield where we rasterize our input data to.
 	if (bHasGeometry)
@@ -2908,6 +2964,11 @@ ETimeSliceWorkResult FRecastTileGenerator::RasterizeTrianglesTimeSliced(FNavMesh
 		++RasterizeTrianglesTimeSlicedRawGeomIdx;
 	}
 
+	if (StaticVoxels.Num())
+	{
+		rcAddSpans(&BuildContext, *RasterContext.SolidHF, TileConfig.walkableClimb, StaticVoxels.GetData(), StaticVoxels.Num());
+	}
+
 	//return sucess as non timesliced functionality does not detect failure here
 	return ETimeSliceWorkResult::Succeeded;
 }
@@ -2932,6 +2993,12 @@ void FRecastTileGenerator::RasterizeTriangles(FNavMeshBuildContext& BuildContext
 			RasterizeGeometryRecast(BuildContext, Element.GeomCoords, Element.GeomIndices, Element.RasterizationFlags, RasterContext);
 		}
 	}
+
+	// cached voxels are already in tile's space
+	if (StaticVoxels.Num())
+	{
+		rcAddSpans(&BuildContext, *RasterContext.SolidHF, TileConfig.walkableClimb, StaticVoxels.GetData(), StaticVoxels.Num());
+	}
 }
 
 void FRecastTileGenerator::GenerateRecastFilter(FNavMeshBuildContext& BuildContext, FTileRasterizationContext& RasterContext)
@@ -4061,6 +4128,7 @@ uint32 FRecastTileGenerator::GetUsedMemCount() const
 	TotalMemory += Modifiers.GetAllocatedSize();
 	TotalMemory += OffmeshLinks.GetAllocatedSize();
 	TotalMemory += RawGeometry.GetAllocatedSize();
+	TotalMemory += StaticVoxels.GetAllocatedSize();
 	
 	for (const FRecastRawGeometryElement& Element : RawGeometry)
 	{
@@ -4146,6 +4214,7 @@ FRecastNavMeshGenerator::FRecastNavMeshGenerator(ARecastNavMesh& InDestNavMesh)
 	, bInitialized(false)
 	, bRestrictBuildingToActiveTiles(false)
 	, bSortTilesWithSeedLocations(true)
+	, PendingTilesSortCooldown(0.0f)
 	, Version(0)
 {
 	INC_DWORD_STAT_BY(STAT_NavigationMemory, sizeof(*this));
@@ -4242,12 +4311,6 @@ void FRecastNavMeshGenerator::Init()
 	UE_LOG(LogNavigation, Log, TEXT("Using max of %d workers to build navigation."), MaxTileGeneratorTasks);
 	NumActiveTiles = 0;
 
-	// prepare voxel cache if needed
-	if (ARecastNavMesh::IsVoxelCacheEnabled())
-	{
-		VoxelCacheContext.Create(Config.tileSize + Config.borderSize * 2, Config.cs, Config.ch);
-	}
-
 	bInitialized = true;
 
 
@@ -4492,10 +4555,9 @@ void FRecastNavMeshGenerator::EnsureBuildCompletion()
 {
 	const bool bHadTasks = GetNumRemaningBuildTasks() > 0;
 	
-	const bool bDoAsyncDataGathering = (GatherGeometryOnGameThread() == false);
 	do 
 	{
-		const int32 NumTasksToProcess = (bDoAsyncDataGathering ? 1 : MaxTileGeneratorTasks) - RunningDirtyTiles.Num();
+		const int32 NumTasksToProcess = MaxTileGeneratorTasks - RunningDirtyTiles.Num();
 		ProcessTileTasks(NumTasksToProcess);
 		
 		// Block until tasks are finished
@@ -4545,11 +4607,17 @@ void FRecastNavMeshGenerator::TickAsyncBuild(float DeltaSeconds)
 	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
 	check(NavSys);
 	const int32 NumRunningTasks = NavSys->GetNumRunningBuildTasks();
-	// this is a temp solution to enforce only one worker thread if GatherGeometryOnGameThread == false
-	// due to missing safety features
-	const bool bDoAsyncDataGathering = GatherGeometryOnGameThread() == false;
 
-	const int32 NumTasksToSubmit = (bDoAsyncDataGathering ? 1 : MaxTileGeneratorTasks) - NumRunningTasks;
+	// keep pending tiles ordered by distance to moving players and invokers
+	PendingTilesSortCooldown -= DeltaSeconds;
+	if (PendingTilesSortCooldown <= 0.0f && PendingDirtyTiles.Num() > 1)
+	{
+		SortPendingBuildTiles();
+		PendingTilesSortCooldown = DestNavMesh->TileSetUpdateInterval;
+	}
+
+	// tile generators gathering geometry asynchronously only read shared navigation octree data, so they can run on all workers as well
+	const int32 NumTasksToSubmit = MaxTileGeneratorTasks - NumRunningTasks;
 	TArray<uint32> UpdatedTileIndices = ProcessTileTasks(NumTasksToSubmit);
 			
 	if (UpdatedTileIndices.Num() > 0)
@@ -4816,6 +4884,8 @@ TArray<uint32> FRecastNavMeshGenerator::RemoveTileLayers(const int32 TileX, cons
 
 		if (NumLayers > 0)
 		{
+			FRWScopeLock TileDataWriteLock(DestNavMesh->GetRecastNavMeshImpl()->GetTileDataLock(), SLT_Write);
+
 			TArray<dtMeshTile*> Tiles;
 			Tiles.AddZeroed(NumLayers);
 			DetourMesh->getTilesAt(TileX, TileY, (const dtMeshTile**)Tiles.GetData(), NumLayers);
@@ -4893,6 +4963,9 @@ void FRecastNavMeshGenerator::AddGeneratedTileLayer(int32 LayerIndex, FRecastTil
 	dtTileRef OldTileRef = DetourMesh->getTileRefAt(TileX, TileY, LayerIndex);
 	const int32 LayerDataIndex = TileLayers.IndexOfByPredicate(FLayerIndexFinder(LayerIndex));
 
+	// pathfinding running outside game thread can't see tiles while they're being replaced
+	FRWScopeLock TileDataWriteLock(DestNavMesh->GetRecastNavMeshImpl()->GetTileDataLock(), SLT_Write);
+
 	if (LayerDataIndex != INDEX_NONE)
 	{
 		FNavMeshTileData& LayerData = TileLayers[LayerDataIndex];
@@ -5372,11 +5445,12 @@ void FRecastNavMeshGenerator::SortPendingBuildTiles()
 	{
 		const float TileSizeInWorldUnits = Config.tileSize * Config.cs;
 		
-		// Calculate shortest distances between tiles and players
+		// Calculate shortest distances between tiles and seed locations, those could have moved since tiles were last sorted
 		for (FPendingTileElement& Element : PendingDirtyTiles)
 		{
 			const FBox TileBox = CalculateTileBounds(Element.Coord.X, Element.Coord.Y, FVector::ZeroVector, TotalNavBounds, TileSizeInWorldUnits);
 			FVector2D TileCenter2D = FVector2D(TileBox.GetCenter());
+			Element.SeedDistance = MAX_flt;
 			for (FVector2D SeedLocation : SeedLocations)
 			{
 				Element.SeedDistance = FMath::Min(Element.SeedDistance, FVector2D::DistSquared(TileCenter2D, SeedLocation));
@@ -5400,6 +5474,16 @@ void FRecastNavMeshGenerator::GetSeedLocations(UWorld& World, TArray<FVector2D>&
 			OutSeedLocations.Add(SeedLoc);
 		}
 	}
+
+	// Collect navigation invokers, AI needs navmesh around them as much as players do
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(&World);
+	if (NavSys)
+	{
+		for (const FNavigationInvokerRaw& Invoker : NavSys->GetInvokerLocations())
+		{
+			OutSeedLocations.Add(FVector2D(Invoker.Location));
+		}
+	}
 }
 
 TSharedRef<FRecastTileGenerator> FRecastNavMeshGenerator::CreateTileGenerator(const FIntPoint& Coord, const TArray<FBox>& DirtyAreas)
@@ -3,6 +3,9 @@
 #include "NavigationSystem.h"
 #include "NavigationDataHandler.h"
 #include "Misc/ScopeLock.h"
+#include "Misc/App.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
 #include "Stats/StatsMisc.h"
 #include "Modules/ModuleManager.h"
 #include "AI/Navigation/NavAgentInterface.h"
@@ -53,6 +56,14 @@
 static const uint32 INITIAL_ASYNC_QUERIES_SIZE = 32;
 static const uint32 REGISTRATION_QUEUE_SIZE = 16;	// and we'll not reallocate
 
+static int32 GParallelAsyncPathfinding = 1;
+static FAutoConsoleVariableRef CVarParallelAsyncPathfinding(
+	TEXT("n.ParallelAsyncPathfinding"),
+	GParallelAsyncPathfinding,
+	TEXT("If set, batched async pathfinding requests are spread across worker threads for navigation data supporting concurrent pathfinding (recast navmesh).\n")
+	TEXT("Otherwise all requests are processed one after another by a single task."),
+	ECVF_Default);
+
 #define LOCTEXT_NAMESPACE "Navigation"
 
 DECLARE_CYCLE_STAT(TEXT("Nav Tick: mark dirty"), STAT_Navigation_TickMarkDirty, STATGROUP_Navigation);
@@ -1193,6 +1204,38 @@ static void AsyncQueryDone(FAsyncPathFindingQuery Query)
 	Query.OnDoneDelegate.ExecuteIfBound(Query.QueryID, Query.Result.Result, Query.Result.Path);
 }
 
+static void DispatchAsyncQueryDone(const FAsyncPathFindingQuery& Query)
+{
+	// @todo make it return more informative results (bResult == false)
+	// trigger calling delegate on main thread - otherwise it may depend too much on stuff being thread safe
+	DECLARE_CYCLE_STAT(TEXT("FSimpleDelegateGraphTask.Async nav query finished"),
+		STAT_FSimpleDelegateGraphTask_AsyncNavQueryFinished,
+		STATGROUP_TaskGraphTasks);
+
+	FSimpleDelegateGraphTask::CreateAndDispatchWhenReady(
+		FSimpleDelegateGraphTask::FDelegate::CreateStatic(AsyncQueryDone, Query),
+		GET_STATID(STAT_FSimpleDelegateGraphTask_AsyncNavQueryFinished), NULL, ENamedThreads::GameThread);
+}
+
+static void PerformAsyncQuery(FAsyncPathFindingQuery& Query, const ANavigationData* NavData)
+{
+	if (NavData)
+	{
+		if (Query.Mode == EPathFindingMode::Hierarchical)
+		{
+			Query.Result = NavData->FindHierarchicalPath(Query.NavAgentProperties, Query);
+		}
+		else
+		{
+			Query.Result = NavData->FindPath(Query.NavAgentProperties, Query);
+		}
+	}
+	else
+	{
+		Query.Result = ENavigationQueryResult::Error;
+	}
+}
+
 void UNavigationSystemV1::PerformAsyncQueries(TArray<FAsyncPathFindingQuery> PathFindingQueries)
 {
 	SCOPE_CYCLE_COUNTER(STAT_Navigation_PathfindingAsync);
@@ -1203,38 +1246,42 @@ void UNavigationSystemV1::PerformAsyncQueries(TArray<FAsyncPathFindingQuery> Pat
 		return;
 	}
 	
-	for (FAsyncPathFindingQuery& Query : PathFindingQueries)
+	const bool bParallel = GParallelAsyncPathfinding && FApp::ShouldUseThreadingForPerformance() && PathFindingQueries.Num() > 1;
+	TArray<const ANavigationData*> QueryNavData;
+	QueryNavData.AddZeroed(PathFindingQueries.Num());
+	TArray<int32> ConcurrentQueries;
+
+	for (int32 QueryIndex = 0; QueryIndex < PathFindingQueries.Num(); ++QueryIndex)
 	{
+		FAsyncPathFindingQuery& Query = PathFindingQueries[QueryIndex];
+
 		// @todo this is not necessarily the safest way to use UObjects outside of main thread. 
 		//	think about something else.
 		const ANavigationData* NavData = Query.NavData.IsValid() ? Query.NavData.Get() : GetDefaultNavDataInstance(FNavigationSystem::DontCreate);
 
-		// perform query
-		if (NavData)
+		if (bParallel && NavData && NavData->SupportsConcurrentPathfinding())
 		{
-			if (Query.Mode == EPathFindingMode::Hierarchical)
-			{
-				Query.Result = NavData->FindHierarchicalPath(Query.NavAgentProperties, Query);
-			}
-			else
-			{
-				Query.Result = NavData->FindPath(Query.NavAgentProperties, Query);
-			}
+			// batched below
+			QueryNavData[QueryIndex] = NavData;
+			ConcurrentQueries.Add(QueryIndex);
 		}
 		else
 		{
-			Query.Result = ENavigationQueryResult::Error;
+			PerformAsyncQuery(Query, NavData);
+			DispatchAsyncQueryDone(Query);
 		}
+	}
 
-		// @todo make it return more informative results (bResult == false)
-		// trigger calling delegate on main thread - otherwise it may depend too much on stuff being thread safe
-		DECLARE_CYCLE_STAT(TEXT("FSimpleDelegateGraphTask.Async nav query finished"),
-			STAT_FSimpleDelegateGraphTask_AsyncNavQueryFinished,
-			STATGROUP_TaskGraphTasks);
+	// navigation data supporting it can be searched by all workers at once, each one using its own query object
+	ParallelFor(ConcurrentQueries.Num(), [&PathFindingQueries, &QueryNavData, &ConcurrentQueries](int32 Index)
+	{
+		const int32 QueryIndex = ConcurrentQueries[Index];
+		PerformAsyncQuery(PathFindingQueries[QueryIndex], QueryNavData[QueryIndex]);
+	});
 
-		FSimpleDelegateGraphTask::CreateAndDispatchWhenReady(
-			FSimpleDelegateGraphTask::FDelegate::CreateStatic(AsyncQueryDone, Query),
-			GET_STATID(STAT_FSimpleDelegateGraphTask_AsyncNavQueryFinished), NULL, ENamedThreads::GameThread);
+	for (const int32 QueryIndex : ConcurrentQueries)
+	{
+		DispatchAsyncQueryDone(PathFindingQueries[QueryIndex]);
 	}
 }
 
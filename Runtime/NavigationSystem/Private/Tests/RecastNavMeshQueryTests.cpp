@@ -0,0 +1,248 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+#include "Async/ParallelFor.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "NavMesh/NavMeshPath.h"
+#include "NavMesh/PImplRecastNavMesh.h"
+#include "NavMesh/RecastHelpers.h"
+#include "NavMesh/RecastQueryFilter.h"
+
+#if WITH_RECAST
+#include "Detour/DetourNavMeshBuilder.h"
+#endif
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_RECAST
+
+namespace RecastNavMeshQueryTestsPrivate
+{
+	/** navmesh is a single tile made of GridSize x GridSize square polys, each CellVoxels wide */
+	static const int32 GridSize = 64;
+	static const int32 CellVoxels = 10;
+	static const float VoxelSize = 10.0f;
+
+	/** walls on every WallSpacing column, with a single gap alternating between both ends of the grid, so most paths have to zigzag through the whole navmesh */
+	static const int32 WallSpacing = 8;
+
+	static const int32 NumPaths = 2048;
+
+	bool IsCellWalkable(int32 X, int32 Z)
+	{
+		if (X % WallSpacing != WallSpacing - 1)
+		{
+			return true;
+		}
+
+		const int32 GapZ = ((X / WallSpacing) % 2) ? 0 : GridSize - 1;
+		return Z == GapZ;
+	}
+
+	FVector GetCellCenter(int32 X, int32 Z)
+	{
+		const float CellSize = CellVoxels * VoxelSize;
+		return Recast2UnrealPoint(FVector((X + 0.5f) * CellSize, 0.0f, (Z + 0.5f) * CellSize));
+	}
+
+	dtNavMesh* CreateGridNavMesh()
+	{
+		const int32 NumVertsPerRow = GridSize + 1;
+		TArray<uint16> Verts;
+		Verts.Reserve(NumVertsPerRow * NumVertsPerRow * 3);
+		for (int32 Z = 0; Z < NumVertsPerRow; Z++)
+		{
+			for (int32 X = 0; X < NumVertsPerRow; X++)
+			{
+				Verts.Add(uint16(X * CellVoxels));
+				Verts.Add(0);
+				Verts.Add(uint16(Z * CellVoxels));
+			}
+		}
+
+		TArray<int32> CellPolys;
+		CellPolys.Init(INDEX_NONE, GridSize * GridSize);
+		int32 NumPolys = 0;
+		for (int32 CellIndex = 0; CellIndex < CellPolys.Num(); CellIndex++)
+		{
+			if (IsCellWalkable(CellIndex % GridSize, CellIndex / GridSize))
+			{
+				CellPolys[CellIndex] = NumPolys++;
+			}
+		}
+
+		auto GetNeighbourPoly = [&CellPolys](int32 X, int32 Z) -> uint16
+		{
+			const bool bInGrid = (X >= 0 && X < GridSize && Z >= 0 && Z < GridSize);
+			const int32 PolyIndex = bInGrid ? CellPolys[Z * GridSize + X] : INDEX_NONE;
+			// 0x800f marks border edge
+			return PolyIndex != INDEX_NONE ? uint16(PolyIndex) : 0x800f;
+		};
+
+		const int32 MaxVertsPerPoly = DT_VERTS_PER_POLYGON;
+		TArray<uint16> Polys;
+		Polys.Init(0xffff, NumPolys * MaxVertsPerPoly * 2);
+		for (int32 CellIndex = 0; CellIndex < CellPolys.Num(); CellIndex++)
+		{
+			if (CellPolys[CellIndex] == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const int32 X = CellIndex % GridSize;
+			const int32 Z = CellIndex / GridSize;
+			uint16* PolyVerts = &Polys[CellPolys[CellIndex] * MaxVertsPerPoly * 2];
+			uint16* PolyNeis = PolyVerts + MaxVertsPerPoly;
+
+			PolyVerts[0] = uint16(Z * NumVertsPerRow + X);
+			PolyVerts[1] = uint16((Z + 1) * NumVertsPerRow + X);
+			PolyVerts[2] = uint16((Z + 1) * NumVertsPerRow + X + 1);
+			PolyVerts[3] = uint16(Z * NumVertsPerRow + X + 1);
+
+			PolyNeis[0] = GetNeighbourPoly(X - 1, Z);
+			PolyNeis[1] = GetNeighbourPoly(X, Z + 1);
+			PolyNeis[2] = GetNeighbourPoly(X + 1, Z);
+			PolyNeis[3] = GetNeighbourPoly(X, Z - 1);
+		}
+
+		TArray<uint16> PolyFlags;
+		PolyFlags.Init(1, NumPolys);
+		TArray<uint8> PolyAreas;
+		PolyAreas.Init(RECAST_DEFAULT_AREA, NumPolys);
+
+		dtNavMeshCreateParams Params;
+		FMemory::Memzero(Params);
+		Params.verts = Verts.GetData();
+		Params.vertCount = Verts.Num() / 3;
+		Params.polys = Polys.GetData();
+		Params.polyFlags = PolyFlags.GetData();
+		Params.polyAreas = PolyAreas.GetData();
+		Params.polyCount = NumPolys;
+		Params.nvp = MaxVertsPerPoly;
+		Params.bmax[0] = GridSize * CellVoxels * VoxelSize;
+		Params.bmax[1] = VoxelSize;
+		Params.bmax[2] = GridSize * CellVoxels * VoxelSize;
+		Params.walkableHeight = 200.0f;
+		Params.walkableRadius = 35.0f;
+		Params.walkableClimb = 50.0f;
+		Params.cs = VoxelSize;
+		Params.ch = VoxelSize;
+		Params.buildBvTree = true;
+
+		unsigned char* TileData = nullptr;
+		int TileDataSize = 0;
+		if (!dtCreateNavMeshData(&Params, &TileData, &TileDataSize))
+		{
+			return nullptr;
+		}
+
+		dtNavMesh* DetourNavMesh = dtAllocNavMesh();
+		if (dtStatusFailed(DetourNavMesh->init(TileData, TileDataSize, DT_TILE_FREE_DATA)))
+		{
+			dtFreeNavMesh(DetourNavMesh);
+			return nullptr;
+		}
+
+		return DetourNavMesh;
+	}
+
+	struct FPathRequest
+	{
+		FVector Start;
+		FVector End;
+		ENavigationQueryResult::Type Result;
+		int32 NumPathPoints;
+	};
+
+	/** Finds all paths and returns time spent in seconds. Single threaded run goes through game thread's shared query,
+	 *  parallel one has each worker using query from navmesh's pool. */
+	double FindPaths(const FPImplRecastNavMesh& NavMeshImpl, const FNavigationQueryFilter& Filter, TArray<FPathRequest>& Requests, bool bParallel)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		ParallelFor(Requests.Num(), [&NavMeshImpl, &Filter, &Requests](int32 Index)
+		{
+			FPathRequest& Request = Requests[Index];
+			FNavMeshPath Path;
+			Request.Result = NavMeshImpl.FindPath(Request.Start, Request.End, Path, Filter, nullptr);
+			Request.NumPathPoints = Path.GetPathPoints().Num();
+		}, !bParallel);
+
+		return FPlatformTime::Seconds() - StartTime;
+	}
+}
+
+/**
+ * Finds paths on a generated navmesh, first one after another on the calling thread and then spread across
+ * worker threads using pooled Detour queries. Checks that both find the same paths and reports paths per second.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRecastNavMeshParallelPathfindingTest, "System.Navigation.Recast.ParallelPathfinding", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FRecastNavMeshParallelPathfindingTest::RunTest(const FString& Parameters)
+{
+	using namespace RecastNavMeshQueryTestsPrivate;
+
+	dtNavMesh* DetourNavMesh = CreateGridNavMesh();
+	if (!TestNotNull(TEXT("Generated navmesh"), DetourNavMesh))
+	{
+		return false;
+	}
+
+	// default object only provides query extents, navmesh is not part of any world
+	FPImplRecastNavMesh NavMeshImpl(GetMutableDefault<ARecastNavMesh>());
+	NavMeshImpl.DetourNavMesh = DetourNavMesh;
+
+	FNavigationQueryFilter Filter;
+	Filter.SetFilterType<FRecastQueryFilter>();
+	Filter.SetMaxSearchNodes(GridSize * GridSize);
+
+	TArray<FIntPoint> WalkableCells;
+	for (int32 Z = 0; Z < GridSize; Z++)
+	{
+		for (int32 X = 0; X < GridSize; X++)
+		{
+			if (IsCellWalkable(X, Z))
+			{
+				WalkableCells.Add(FIntPoint(X, Z));
+			}
+		}
+	}
+
+	FRandomStream RandomStream(0x4e415650);
+	TArray<FPathRequest> SerialRequests;
+	SerialRequests.AddZeroed(NumPaths);
+	for (FPathRequest& Request : SerialRequests)
+	{
+		const FIntPoint StartCell = WalkableCells[RandomStream.RandHelper(WalkableCells.Num())];
+		const FIntPoint EndCell = WalkableCells[RandomStream.RandHelper(WalkableCells.Num())];
+		Request.Start = GetCellCenter(StartCell.X, StartCell.Y);
+		Request.End = GetCellCenter(EndCell.X, EndCell.Y);
+	}
+	TArray<FPathRequest> ParallelRequests = SerialRequests;
+
+	const double SerialSeconds = FindPaths(NavMeshImpl, Filter, SerialRequests, false);
+	const double ParallelSeconds = FindPaths(NavMeshImpl, Filter, ParallelRequests, true);
+
+	int32 NumFound = 0;
+	for (int32 Index = 0; Index < NumPaths; Index++)
+	{
+		const FPathRequest& SerialRequest = SerialRequests[Index];
+		const FPathRequest& ParallelRequest = ParallelRequests[Index];
+		if (ParallelRequest.Result != SerialRequest.Result || ParallelRequest.NumPathPoints != SerialRequest.NumPathPoints)
+		{
+			AddError(FString::Printf(TEXT("Path %d: found %d points (result %d) on worker threads, expected %d points (result %d)"),
+				Index, ParallelRequest.NumPathPoints, int32(ParallelRequest.Result), SerialRequest.NumPathPoints, int32(SerialRequest.Result)));
+			return false;
+		}
+
+		NumFound += (SerialRequest.Result == ENavigationQueryResult::Success) ? 1 : 0;
+	}
+	TestEqual(TEXT("Number of paths found"), NumFound, NumPaths);
+
+	AddInfo(FString::Printf(TEXT("%d paths on %d polys: single thread %.1f paths/s, %d worker threads %.1f paths/s (%.2fx)"),
+		NumPaths, WalkableCells.Num(), NumPaths / SerialSeconds, FTaskGraphInterface::Get().GetNumWorkerThreads(), NumPaths / ParallelSeconds, SerialSeconds / ParallelSeconds));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && WITH_RECAST
@@ -9,6 +9,7 @@
 #pragma once 
 
 #include "CoreMinimal.h"
+#include "Containers/LockFreeList.h"
 #include "UObject/WeakObjectPtr.h"
 #include "NavFilters/NavigationQueryFilter.h"
 #include "AI/Navigation/NavigationTypes.h"
@@ -223,6 +224,16 @@ public:
 	/** query used for searching data on game thread */
 	mutable dtNavMeshQuery SharedNavQuery;
 
+	/** get a query for searching data outside game thread, must be given back with ReleaseNavQuery. @see FRecastNavQueryScope */
+	dtNavMeshQuery* AcquireNavQuery() const;
+
+	/** return query obtained from AcquireNavQuery, keeping its node pool allocated for next user */
+	void ReleaseNavQuery(dtNavMeshQuery* NavQuery) const;
+
+	/** lock guarding Detour tiles, write locked by game thread when adding or removing tiles
+	 *  and read locked by queries running on other threads */
+	FRWLock& GetTileDataLock() const { return TileDataLock; }
+
 	/** Helper function to serialize a single Recast tile. */
 	static void SerializeRecastMeshTile(FArchive& Ar, int32 NavMeshVersion, unsigned char*& TileData, int32& TileDataSize);
 
@@ -249,10 +260,32 @@ public:
 	void GetEdgesForPathCorridorImpl(const TArray<NavNodeRef>* PathCorridor, TArray<FNavigationPortalEdge>* PathCorridorEdges, const dtNavMeshQuery& NavQuery) const;
 
 protected:
+	/** queries used outside game thread, each one is used by a single thread at a time so the pool grows up to the number of threads searching this navmesh concurrently */
+	mutable TLockFreePointerListUnordered<dtNavMeshQuery, PLATFORM_CACHE_LINE_SIZE> NavQueryPool;
+
+	mutable FRWLock TileDataLock;
+
 	/** 
 	 *	@param ForbiddenFlags polys with flags matching the fillter will get added to 
 	 */
 	int32 GetTilesDebugGeometry(const FRecastNavMeshGenerator* Generator, const dtMeshTile& Tile, int32 VertBase, FRecastDebugGeometry& OutGeometry, int32 TileIdx = INDEX_NONE, uint16 ForbiddenFlags = 0) const;
 };
 
+/** Gives access to navigation query for the duration of scope: SharedNavQuery on game thread, or query from navmesh's pool 
+ *  on other threads, which also read lock navmesh's tile data so game thread can't modify tiles while they are searched */
+struct NAVIGATIONSYSTEM_API FRecastNavQueryScope
+{
+	explicit FRecastNavQueryScope(const FPImplRecastNavMesh& InNavMeshImpl);
+	~FRecastNavQueryScope();
+
+	dtNavMeshQuery& Get() const { return *NavQuery; }
+
+private:
+	const FPImplRecastNavMesh& NavMeshImpl;
+	dtNavMeshQuery* NavQuery;
+	const FPImplRecastNavMesh* PrevLockedNavMeshImpl;
+	bool bPooled;
+	bool bReadLocked;
+};
+
 #endif	// WITH_RECAST
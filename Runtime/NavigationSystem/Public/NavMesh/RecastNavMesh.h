@@ -1019,6 +1019,7 @@ public:
 	virtual bool NeedsRebuild() const override;
 	virtual bool SupportsRuntimeGeneration() const override;
 	virtual bool SupportsStreaming() const override;
+	virtual bool SupportsConcurrentPathfinding() const override { return true; }
 	virtual void ConditionalConstructGenerator() override;
 	void UpdateGenerationProperties(const FRecastNavMeshGenerationProperties& GenerationProps);
 	bool ShouldGatherDataOnGameThread() const { return bDoFullyAsyncNavDataGathering == false; }
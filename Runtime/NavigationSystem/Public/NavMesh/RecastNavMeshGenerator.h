@@ -106,6 +106,8 @@ struct FRecastVoxelCache
 		int16 TileX;
 		int16 TileY;
 		int32 NumSpans;
+		/** build parameters the spans were rasterized with, elements are shared by navmeshes of all agents */
+		uint32 ConfigHash;
 		FTileInfo* NextTile;
 		rcSpanCache* SpanData;
 	};
@@ -398,6 +400,12 @@ protected:
 	void ValidateAndAppendGeometry(TSharedRef<FNavigationRelevantData, ESPMode::ThreadSafe> ElementData, const FCompositeNavModifier& InModifier);
 	void AppendGeometry(const TNavStatArray<uint8>& RawCollisionCache, const FCompositeNavModifier& InModifier, const FNavDataPerInstanceTransformDelegate& InTransformsDelegate);
 	void AppendVoxels(rcSpanCache* SpanData, int32 NumSpans);
+	/** Appends element's geometry to tile's geometry, going through element's voxel cache when it's enabled */
+	void AppendElementGeometry(TSharedRef<FNavigationRelevantData, ESPMode::ThreadSafe> ElementData, const FCompositeNavModifier& InModifier);
+	/** Appends voxels cached for this tile by CacheOwner, returns false if there are none */
+	bool AppendCachedVoxels(const FNavigationRelevantData& CacheOwner);
+	/** Rasterizes collision data, stores result in CacheOwner's voxel cache and appends it to tile's geometry */
+	void AppendAndCacheVoxels(FNavigationRelevantData& CacheOwner, const TNavStatArray<uint8>& RawCollisionCache, const FCompositeNavModifier& InModifier);
 	
 	/** prepare voxel cache from collision data */
 	void PrepareVoxelCache(const TNavStatArray<uint8>& RawCollisionCache, const FCompositeNavModifier& InModifier, TNavStatArray<rcSpanCache>& SpanData);
@@ -450,6 +458,9 @@ protected:
 	/** Parameters defining navmesh tiles */
 	FRecastBuildConfig TileConfig;
 
+	/** Hash of TileConfig parameters affecting rasterization, voxel caches only match tiles built with the same ones */
+	uint32 VoxelCacheConfigHash;
+
 	/** Bounding geometry definition. */
 	TNavStatArray<FBox> InclusionBounds;
 
@@ -463,6 +474,8 @@ protected:
 	/** Result of calling RasterizeGeometryInitVars() */
 	TArray<float> RasterizeGeometryWorldRecastCoords;
 	
+	// tile's geometry: voxel cache
+	TNavStatArray<rcSpanCache> StaticVoxels;
 	// tile's geometry: without voxel cache
 	TArray<FRecastRawGeometryElement> RawGeometry;
 	// areas used for creating navigation data: obstacles
@@ -698,10 +711,11 @@ protected:
 	// Updates cached list of navigation bounds
 	void UpdateNavigationBounds();
 		
-	// Sorts pending build tiles by proximity to player, so tiles closer to player will get generated first
+	// Sorts pending build tiles by proximity to players and navigation invokers, so tiles closer to them will get generated first
 	virtual void SortPendingBuildTiles();
 
 	// Get seed locations used for sorting pending build tiles. Tiles closer to these locations will be prioritized first.
+	// Default implementation uses player pawns and navigation invokers
 	virtual void GetSeedLocations(UWorld& World, TArray<FVector2D>& OutSeedLocations) const;
 
 	/** Instantiates dtNavMesh and configures it for tiles generation. Returns false if failed */
@@ -831,6 +845,9 @@ protected:
 
 	uint32 bSortTilesWithSeedLocations:1;
 
+	/** Time left until pending tiles get sorted again to follow moving seed locations, @see ARecastNavMesh::TileSetUpdateInterval */
+	float PendingTilesSortCooldown;
+
 	/** Runtime generator's version, increased every time all tile generators get invalidated
 	 *	like when navmesh size changes */
 	uint32 Version;
@@ -582,6 +582,8 @@ public:
 	virtual bool NeedsRebuild() const { return false; }
 	virtual bool SupportsRuntimeGeneration() const;
 	virtual bool SupportsStreaming() const;
+	/** if true, FindPath and FindHierarchicalPath can be called by multiple threads at the same time */
+	virtual bool SupportsConcurrentPathfinding() const { return false; }
 	virtual void OnNavigationBoundsChanged();
 	virtual void OnStreamingLevelAdded(ULevel* InLevel, UWorld* InWorld) {};
 	virtual void OnStreamingLevelRemoved(ULevel* InLevel, UWorld* InWorld) {};
@@ -10,6 +10,7 @@
 #include "RHI.h"
 #include "Misc/ScopeLock.h"
 #include "PipelineStateCache.h"
+#include "RHICommandStreamCapture.h"
 #include "ProfilingDebugging/CsvProfiler.h"
 #include "Trace/Trace.h"
 
@@ -290,6 +291,14 @@ void FRHICommandListExecutor::ExecuteInner_DoExecute(FRHICommandListBase& CmdLis
 	}
 #endif
 
+#if RHI_COMMAND_STREAM_CAPTURE
+	if (FRHICommandStreamCapture::IsCapturing())
+	{
+		FRHICommandStreamCapture::ExecuteAndCapture(CmdList);
+		return;
+	}
+#endif
+
 	FRHICommandListDebugContext DebugContext;
 	FRHICommandListIterator Iter(CmdList);
 #if STATS
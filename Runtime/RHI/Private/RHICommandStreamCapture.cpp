@@ -0,0 +1,424 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	RHICommandStreamCapture.cpp: Capture and replay of the RHI command stream for render thread benchmarks.
+=============================================================================*/
+
+#include "RHICommandStreamCapture.h"
+#include "DynamicRHI.h"
+#include "HAL/FileManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+#if RHI_COMMAND_STREAM_CAPTURE
+
+static const uint32 RHICommandStreamCaptureMagic = 0x52484343;
+static const uint32 RHICommandStreamCaptureVersion = 1;
+
+TAtomic<bool> FRHICommandStreamCapture::bCapturing(false);
+
+static FCriticalSection GRHICommandStreamCaptureCS;
+static FRHICommandStreamCaptureData GRHICommandStreamCaptureData;
+static TMap<const TCHAR*, uint16> GRHICommandStreamCaptureTypeIndices;
+static int32 GRHICommandStreamCaptureFrameIndex = 0;
+static FString GRHICommandStreamCaptureFilename;
+static FDelegateHandle GRHICommandStreamCaptureEndFrameHandle;
+
+FArchive& operator<<(FArchive& Ar, FRHICommandStreamCaptureData& Ref)
+{
+	uint32 Magic = RHICommandStreamCaptureMagic;
+	uint32 Version = RHICommandStreamCaptureVersion;
+	Ar << Magic << Version;
+
+	if (Ar.IsLoading() && (Magic != RHICommandStreamCaptureMagic || Version != RHICommandStreamCaptureVersion))
+	{
+		Ar.SetError();
+		return Ar;
+	}
+
+	return Ar << Ref.TypeNames << Ref.NumFrames << Ref.SecondsPerCycle << Ref.CommandLists;
+}
+
+bool FRHICommandStreamCaptureData::Save(const FString& Filename)
+{
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Ar)
+	{
+		return false;
+	}
+
+	*Ar << *this;
+	return Ar->Close();
+}
+
+bool FRHICommandStreamCaptureData::Load(const FString& Filename)
+{
+	TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*Filename));
+	if (!Ar)
+	{
+		return false;
+	}
+
+	*Ar << *this;
+	if (Ar->IsError())
+	{
+		return false;
+	}
+
+	for (const FRHICapturedCommandList& CommandList : CommandLists)
+	{
+		for (const FRHICapturedCommand& Command : CommandList.Commands)
+		{
+			if (Command.TypeIndex >= TypeNames.Num())
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void FRHICommandStreamCapture::ExecuteAndTime(FRHICommandListBase& CmdList, TArray<FExecutedCommand>& OutCommands)
+{
+	FRHICommandListDebugContext DebugContext;
+	FRHICommandListIterator Iter(CmdList);
+	while (Iter.HasCommandsLeft())
+	{
+		FRHICommandBase* Cmd = Iter.NextCommand();
+
+		FExecutedCommand& ExecutedCommand = OutCommands.AddDefaulted_GetRef();
+		ExecutedCommand.Name = Cmd->GetCaptureName();
+		ExecutedCommand.Size = Cmd->GetCaptureSize();
+
+		const uint32 StartCycles = FPlatformTime::Cycles();
+		Cmd->ExecuteAndDestruct(CmdList, DebugContext);
+		ExecutedCommand.Cycles = FPlatformTime::Cycles() - StartCycles;
+	}
+	CmdList.Reset();
+}
+
+void FRHICommandStreamCapture::ExecuteAndCapture(FRHICommandListBase& CmdList)
+{
+	TArray<FExecutedCommand> ExecutedCommands;
+	ExecutedCommands.Reserve(CmdList.NumCommands);
+	ExecuteAndTime(CmdList, ExecutedCommands);
+
+	FScopeLock Lock(&GRHICommandStreamCaptureCS);
+
+	// The capture may have ended while the commands executed
+	if (!bCapturing)
+	{
+		return;
+	}
+
+	FRHICapturedCommandList& CapturedList = GRHICommandStreamCaptureData.CommandLists.AddDefaulted_GetRef();
+	CapturedList.FrameIndex = GRHICommandStreamCaptureFrameIndex;
+	CapturedList.Commands.Reserve(ExecutedCommands.Num());
+
+	for (const FExecutedCommand& ExecutedCommand : ExecutedCommands)
+	{
+		const uint16* TypeIndex = GRHICommandStreamCaptureTypeIndices.Find(ExecutedCommand.Name);
+		if (!TypeIndex)
+		{
+			// Command types compiled in several modules have the same name at different addresses
+			int32 NameIndex = GRHICommandStreamCaptureData.TypeNames.IndexOfByKey(ExecutedCommand.Name);
+			if (NameIndex == INDEX_NONE)
+			{
+				NameIndex = GRHICommandStreamCaptureData.TypeNames.Add(ExecutedCommand.Name);
+			}
+			check(NameIndex <= MAX_uint16);
+			TypeIndex = &GRHICommandStreamCaptureTypeIndices.Add(ExecutedCommand.Name, uint16(NameIndex));
+		}
+
+		FRHICapturedCommand& CapturedCommand = CapturedList.Commands.AddDefaulted_GetRef();
+		CapturedCommand.TypeIndex = *TypeIndex;
+		CapturedCommand.Size = ExecutedCommand.Size;
+		CapturedCommand.Cycles = ExecutedCommand.Cycles;
+	}
+}
+
+bool FRHICommandStreamCapture::BeginCapture(int32 NumFrames, const FString& Filename)
+{
+	check(IsInGameThread());
+
+	if (GRHICommandStreamCaptureEndFrameHandle.IsValid())
+	{
+		UE_LOG(LogRHI, Warning, TEXT("An RHI command stream capture is already in progress."));
+		return false;
+	}
+
+	{
+		FScopeLock Lock(&GRHICommandStreamCaptureCS);
+		GRHICommandStreamCaptureData = FRHICommandStreamCaptureData();
+		GRHICommandStreamCaptureData.NumFrames = FMath::Max(NumFrames, 1);
+		GRHICommandStreamCaptureData.SecondsPerCycle = FPlatformTime::GetSecondsPerCycle();
+		GRHICommandStreamCaptureTypeIndices.Reset();
+		GRHICommandStreamCaptureFrameIndex = 0;
+		GRHICommandStreamCaptureFilename = Filename;
+		bCapturing = true;
+	}
+
+	GRHICommandStreamCaptureEndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FRHICommandStreamCapture::OnEndFrame);
+
+	UE_LOG(LogRHI, Display, TEXT("Capturing the RHI command stream of the next %d frames to %s"), FMath::Max(NumFrames, 1), *Filename);
+	return true;
+}
+
+void FRHICommandStreamCapture::OnEndFrame()
+{
+	FRHICommandStreamCaptureData Data;
+	{
+		FScopeLock Lock(&GRHICommandStreamCaptureCS);
+		if (++GRHICommandStreamCaptureFrameIndex < GRHICommandStreamCaptureData.NumFrames)
+		{
+			return;
+		}
+
+		bCapturing = false;
+		Data = MoveTemp(GRHICommandStreamCaptureData);
+		GRHICommandStreamCaptureTypeIndices.Reset();
+	}
+
+	FCoreDelegates::OnEndFrame.Remove(GRHICommandStreamCaptureEndFrameHandle);
+	GRHICommandStreamCaptureEndFrameHandle.Reset();
+
+	int32 NumCommands = 0;
+	for (const FRHICapturedCommandList& CommandList : Data.CommandLists)
+	{
+		NumCommands += CommandList.Commands.Num();
+	}
+
+	if (Data.Save(GRHICommandStreamCaptureFilename))
+	{
+		UE_LOG(LogRHI, Display, TEXT("Saved %d RHI commands in %d command lists over %d frames to %s"), NumCommands, Data.CommandLists.Num(), Data.NumFrames, *GRHICommandStreamCaptureFilename);
+	}
+	else
+	{
+		UE_LOG(LogRHI, Error, TEXT("Failed to save the RHI command stream capture to %s"), *GRHICommandStreamCaptureFilename);
+	}
+}
+
+/** Stands in for the commands that can't be replayed, with the allocation size of the captured command. */
+FRHICOMMAND_MACRO(FRHICommandReplayPlaceholder)
+{
+	void Execute(FRHICommandListBase& CmdList)
+	{
+	}
+};
+
+typedef void (*FAllocReplayCommand)(FRHICommandListBase& CmdList, uint32 Size);
+
+/** Commands that only take parameters, replayed as themselves with default arguments. */
+struct FReplayCommandType
+{
+	const TCHAR* Name;
+	FAllocReplayCommand AllocCommand;
+};
+
+static const FReplayCommandType GReplayCommandTypes[] =
+{
+	{ TEXT("FRHICommandDrawPrimitive"), [](FRHICommandListBase& CmdList, uint32) { ALLOC_COMMAND_CL(CmdList, FRHICommandDrawPrimitive)(0, 1, 1); } },
+	{ TEXT("FRHICommandDrawIndexedPrimitive"), [](FRHICommandListBase& CmdList, uint32) { ALLOC_COMMAND_CL(CmdList, FRHICommandDrawIndexedPrimitive)(nullptr, 0, 0, 3, 0, 1, 1); } },
+	{ TEXT("FRHICommandSetStreamSource"), [](FRHICommandListBase& CmdList, uint32) { ALLOC_COMMAND_CL(CmdList, FRHICommandSetStreamSource)(0, nullptr, 0); } },
+	{ TEXT("FRHICommandSetViewport"), [](FRHICommandListBase& CmdList, uint32) { ALLOC_COMMAND_CL(CmdList, FRHICommandSetViewport)(0.0f, 0.0f, 0.0f, 1920.0f, 1080.0f, 1.0f); } },
+	{ TEXT("FRHICommandSetScissorRect"), [](FRHICommandListBase& CmdList, uint32) { ALLOC_COMMAND_CL(CmdList, FRHICommandSetScissorRect)(true, 0, 0, 1920, 1080); } },
+	{ TEXT("FRHICommandSetStencilRef"), [](FRHICommandListBase& CmdList, uint32) { ALLOC_COMMAND_CL(CmdList, FRHICommandSetStencilRef)(0); } },
+	{ TEXT("FRHICommandSetBlendFactor"), [](FRHICommandListBase& CmdList, uint32) { ALLOC_COMMAND_CL(CmdList, FRHICommandSetBlendFactor)(FLinearColor::White); } },
+};
+
+static void AllocReplayPlaceholder(FRHICommandListBase& CmdList, uint32 Size)
+{
+	void* Memory = CmdList.AllocCommand(FMath::Max<int32>(Size, sizeof(FRHICommandReplayPlaceholder)), alignof(FRHICommandReplayPlaceholder));
+	new (Memory) FRHICommandReplayPlaceholder();
+}
+
+bool FRHICommandStreamCapture::Replay(const FRHICommandStreamCaptureData& Data, int32 NumIterations, TArray<FRHICommandTypeReport>& OutReport)
+{
+	const TCHAR* RHIName = GDynamicRHI ? GDynamicRHI->GetName() : nullptr;
+	if (!RHIName || (FCString::Strcmp(RHIName, TEXT("Null")) != 0 && FCString::Strcmp(RHIName, TEXT("Empty")) != 0))
+	{
+		UE_LOG(LogRHI, Error, TEXT("RHI command streams can only be replayed with the Null or Empty RHI (-nullrhi), the current RHI is %s."), RHIName ? RHIName : TEXT("not initialized"));
+		return false;
+	}
+
+	if (bCapturing)
+	{
+		UE_LOG(LogRHI, Error, TEXT("RHI command streams can't be replayed while capturing."));
+		return false;
+	}
+
+	NumIterations = FMath::Max(NumIterations, 1);
+
+	TArray<FAllocReplayCommand> AllocCommands;
+	OutReport.Reset(Data.TypeNames.Num());
+	for (const FString& TypeName : Data.TypeNames)
+	{
+		FRHICommandTypeReport& TypeReport = OutReport.AddDefaulted_GetRef();
+		TypeReport.Name = TypeName;
+
+		FAllocReplayCommand& AllocCommand = AllocCommands.Add_GetRef(&AllocReplayPlaceholder);
+		for (const FReplayCommandType& ReplayCommandType : GReplayCommandTypes)
+		{
+			if (TypeName == ReplayCommandType.Name)
+			{
+				AllocCommand = ReplayCommandType.AllocCommand;
+				TypeReport.bReplayedAsType = true;
+			}
+		}
+	}
+
+	for (const FRHICapturedCommandList& CommandList : Data.CommandLists)
+	{
+		for (const FRHICapturedCommand& Command : CommandList.Commands)
+		{
+			FRHICommandTypeReport& TypeReport = OutReport[Command.TypeIndex];
+			TypeReport.Count++;
+			TypeReport.AllocatedBytes += Command.Size;
+			TypeReport.CapturedMs += Command.Cycles * Data.SecondsPerCycle * 1000.0;
+		}
+	}
+
+	TArray<uint64> RecordCycles;
+	TArray<uint64> ExecuteCycles;
+	RecordCycles.AddZeroed(Data.TypeNames.Num());
+	ExecuteCycles.AddZeroed(Data.TypeNames.Num());
+
+	IRHICommandContext* Context = RHIGetDefaultContext();
+	TArray<FExecutedCommand> ExecutedCommands;
+
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		for (const FRHICapturedCommandList& CommandList : Data.CommandLists)
+		{
+			if (CommandList.Commands.Num() == 0)
+			{
+				continue;
+			}
+
+			FRHICommandList CmdList(FRHIGPUMask::All());
+			CmdList.SetContext(Context);
+
+			for (const FRHICapturedCommand& Command : CommandList.Commands)
+			{
+				const uint32 StartCycles = FPlatformTime::Cycles();
+				AllocCommands[Command.TypeIndex](CmdList, Command.Size);
+				RecordCycles[Command.TypeIndex] += FPlatformTime::Cycles() - StartCycles;
+			}
+
+			ExecutedCommands.Reset();
+			CmdList.bExecuting = true;
+			ExecuteAndTime(CmdList, ExecutedCommands);
+
+			check(ExecutedCommands.Num() == CommandList.Commands.Num());
+			for (int32 CommandIndex = 0; CommandIndex < ExecutedCommands.Num(); ++CommandIndex)
+			{
+				ExecuteCycles[CommandList.Commands[CommandIndex].TypeIndex] += ExecutedCommands[CommandIndex].Cycles;
+			}
+		}
+	}
+
+	const double MsPerCycle = FPlatformTime::GetSecondsPerCycle() * 1000.0 / NumIterations;
+	for (int32 TypeIndex = 0; TypeIndex < OutReport.Num(); ++TypeIndex)
+	{
+		OutReport[TypeIndex].RecordMs = RecordCycles[TypeIndex] * MsPerCycle;
+		OutReport[TypeIndex].ExecuteMs = ExecuteCycles[TypeIndex] * MsPerCycle;
+	}
+
+	OutReport.Sort([](const FRHICommandTypeReport& A, const FRHICommandTypeReport& B)
+	{
+		return A.RecordMs + A.ExecuteMs > B.RecordMs + B.ExecuteMs;
+	});
+
+	return true;
+}
+
+void FRHICommandStreamCapture::WriteReport(const TArray<FRHICommandTypeReport>& Report, const FString& CsvFilename)
+{
+	FString Csv = TEXT("Command,Count,AllocatedBytes,CapturedMs,RecordMs,ExecuteMs,ReplayedAsType\n");
+
+	UE_LOG(LogRHI, Display, TEXT("%-48s %8s %10s %12s %10s %10s"), TEXT("Command"), TEXT("Count"), TEXT("Bytes"), TEXT("Captured ms"), TEXT("Record ms"), TEXT("Exec ms"));
+	for (const FRHICommandTypeReport& TypeReport : Report)
+	{
+		UE_LOG(LogRHI, Display, TEXT("%-48s %8d %10llu %12.3f %10.3f %10.3f%s"), *TypeReport.Name, TypeReport.Count, TypeReport.AllocatedBytes,
+			TypeReport.CapturedMs, TypeReport.RecordMs, TypeReport.ExecuteMs, TypeReport.bReplayedAsType ? TEXT("") : TEXT(" (placeholder)"));
+
+		Csv += FString::Printf(TEXT("%s,%d,%llu,%.4f,%.4f,%.4f,%d\n"), *TypeReport.Name, TypeReport.Count, TypeReport.AllocatedBytes,
+			TypeReport.CapturedMs, TypeReport.RecordMs, TypeReport.ExecuteMs, TypeReport.bReplayedAsType ? 1 : 0);
+	}
+
+	if (FFileHelper::SaveStringToFile(Csv, *CsvFilename))
+	{
+		UE_LOG(LogRHI, Display, TEXT("Wrote the RHI command stream replay report to %s"), *CsvFilename);
+	}
+}
+
+static FString GetRHICommandStreamCaptureFilename(const FString& Name)
+{
+	// Names can contain dots, only paths are used as given
+	if (Name.Contains(TEXT("/")) || Name.Contains(TEXT("\\")))
+	{
+		return Name;
+	}
+	return FPaths::ProfilingDir() / TEXT("RHICapture") / Name + (Name.EndsWith(TEXT(".rhicap")) ? TEXT("") : TEXT(".rhicap"));
+}
+
+static void CaptureRHICommandStream(const TArray<FString>& Args)
+{
+	const int32 NumFrames = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1;
+	const FString Name = Args.Num() > 1 ? Args[1] : FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"));
+	FRHICommandStreamCapture::BeginCapture(NumFrames, GetRHICommandStreamCaptureFilename(Name));
+}
+
+static void ReplayRHICommandStream(const TArray<FString>& Args)
+{
+	if (Args.Num() == 0)
+	{
+		UE_LOG(LogRHI, Display, TEXT("Usage: RHI.ReplayCommandStream <Name or path> [NumIterations=10]"));
+		return;
+	}
+
+	const FString Filename = GetRHICommandStreamCaptureFilename(Args[0]);
+	const int32 NumIterations = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 10;
+
+	FRHICommandStreamCaptureData Data;
+	if (!Data.Load(Filename))
+	{
+		UE_LOG(LogRHI, Error, TEXT("Failed to load the RHI command stream capture %s"), *Filename);
+		return;
+	}
+
+	// The replay uses the default context, the RHI thread must not use it at the same time
+	TArray<FRHICommandTypeReport> Report;
+	bool bReplayed = false;
+	FGraphEventRef ReplayTask = FFunctionGraphTask::CreateAndDispatchWhenReady([&Data, NumIterations, &Report, &bReplayed]()
+	{
+		FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
+		RHICmdList.ImmediateFlush(EImmediateFlushType::FlushRHIThread);
+		FScopedRHIThreadStaller StallRHIThread(RHICmdList);
+
+		bReplayed = FRHICommandStreamCapture::Replay(Data, NumIterations, Report);
+	}, TStatId(), nullptr, ENamedThreads::GetRenderThread());
+	FTaskGraphInterface::Get().WaitUntilTaskCompletes(ReplayTask);
+
+	if (bReplayed)
+	{
+		UE_LOG(LogRHI, Display, TEXT("Replayed %s %d times, times are per iteration:"), *Filename, FMath::Max(NumIterations, 1));
+		FRHICommandStreamCapture::WriteReport(Report, FPaths::ChangeExtension(Filename, TEXT("")) + TEXT("_Replay.csv"));
+	}
+}
+
+static FAutoConsoleCommand CaptureRHICommandStreamCmd(
+	TEXT("RHI.CaptureCommandStream"),
+	TEXT("Records the type, size and execution time of the RHI commands executed during the next frames to Saved/Profiling/RHICapture.\n")
+	TEXT("Usage: RHI.CaptureCommandStream [NumFrames=1] [Name]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&CaptureRHICommandStream));
+
+static FAutoConsoleCommand ReplayRHICommandStreamCmd(
+	TEXT("RHI.ReplayCommandStream"),
+	TEXT("Replays a captured RHI command stream against the Null or Empty RHI and reports the recording and execution cost of each command type.\n")
+	TEXT("Usage: RHI.ReplayCommandStream <Name or path> [NumIterations=10]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&ReplayRHICommandStream));
+
+#endif // RHI_COMMAND_STREAM_CAPTURE
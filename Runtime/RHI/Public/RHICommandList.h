@@ -39,6 +39,11 @@ CSV_DECLARE_CATEGORY_MODULE_EXTERN(RHI_API, RHITFlushes);
 #include "HAL/PlatformStackwalk.h"
 #endif
 
+// Set to 1 to allow capturing the type and execution cost of the RHI commands, see RHICommandStreamCapture.h
+#ifndef RHI_COMMAND_STREAM_CAPTURE
+#define RHI_COMMAND_STREAM_CAPTURE	(!UE_BUILD_SHIPPING)
+#endif
+
 class FApp;
 class FBlendStateInitializerRHI;
 class FGraphicsPipelineStateInitializer;
@@ -360,6 +365,12 @@ struct FRHICommandBase
 {
 	FRHICommandBase* Next = nullptr;
 	virtual void ExecuteAndDestruct(FRHICommandListBase& CmdList, FRHICommandListDebugContext& DebugContext) = 0;
+
+#if RHI_COMMAND_STREAM_CAPTURE
+	/** Name and size of the command type, recorded by the command stream capture. */
+	virtual const TCHAR* GetCaptureName() const = 0;
+	virtual uint32 GetCaptureSize() const = 0;
+#endif
 };
 
 // Thread-safe allocator for GPU fences used in deferred command list execution
@@ -564,6 +575,7 @@ private:
 
 	friend class FRHICommandListExecutor;
 	friend class FRHICommandListIterator;
+	friend class FRHICommandStreamCapture;
 	friend class FRHICommandListScopedFlushAndExecute;
 
 protected:
@@ -746,6 +758,11 @@ struct FRHICommand : public FRHICommandBase
 	}
 
 	virtual void StoreDebugInfo(FRHICommandListDebugContext& Context) {};
+
+#if RHI_COMMAND_STREAM_CAPTURE
+	const TCHAR* GetCaptureName() const override final { return NameType::TStr(); }
+	uint32 GetCaptureSize() const override final { return sizeof(TCmd); }
+#endif
 };
 
 #define FRHICOMMAND_MACRO(CommandName)								\
@@ -3870,6 +3887,11 @@ class RHI_API FRHICommandListImmediate : public FRHICommandList
 			Lambda(*static_cast<FRHICommandListImmediate*>(&CmdList));
 			Lambda.~LAMBDA();
 		}
+
+#if RHI_COMMAND_STREAM_CAPTURE
+		const TCHAR* GetCaptureName() const override final { return TEXT("TRHILambdaCommand"); }
+		uint32 GetCaptureSize() const override final { return sizeof(*this); }
+#endif
 	};
 
 	friend class FRHICommandListExecutor;
@@ -4869,6 +4891,11 @@ class TRHICommandList_RecursiveHazardous : public FRHICommandList_RecursiveHazar
 			Lambda(static_cast<ContextType&>(CmdList.GetContext()));
 			Lambda.~LAMBDA();
 		}
+
+#if RHI_COMMAND_STREAM_CAPTURE
+		const TCHAR* GetCaptureName() const override final { return TEXT("TRHILambdaCommand"); }
+		uint32 GetCaptureSize() const override final { return sizeof(*this); }
+#endif
 	};
 
 public:
@@ -0,0 +1,126 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	RHICommandStreamCapture.h: Capture and replay of the RHI command stream for render thread benchmarks.
+=============================================================================*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Atomic.h"
+#include "RHICommandList.h"
+
+#if RHI_COMMAND_STREAM_CAPTURE
+
+/** A command executed while capturing. */
+struct FRHICapturedCommand
+{
+	/** Index of the command type in FRHICommandStreamCaptureData::TypeNames. */
+	uint16 TypeIndex = 0;
+
+	/** Bytes allocated for the command in the command list. */
+	uint32 Size = 0;
+
+	/** Cycles spent executing the command. */
+	uint32 Cycles = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FRHICapturedCommand& Ref)
+	{
+		return Ar << Ref.TypeIndex << Ref.Size << Ref.Cycles;
+	}
+};
+
+/** Commands of a command list, in execution order. */
+struct FRHICapturedCommandList
+{
+	/** Frame of the capture the list was executed in. */
+	int32 FrameIndex = 0;
+
+	TArray<FRHICapturedCommand> Commands;
+
+	friend FArchive& operator<<(FArchive& Ar, FRHICapturedCommandList& Ref)
+	{
+		return Ar << Ref.FrameIndex << Ref.Commands;
+	}
+};
+
+/** Command stream recorded by a capture, as saved on disk. */
+struct RHI_API FRHICommandStreamCaptureData
+{
+	TArray<FString> TypeNames;
+	TArray<FRHICapturedCommandList> CommandLists;
+	int32 NumFrames = 0;
+	double SecondsPerCycle = 0.0;
+
+	bool Save(const FString& Filename);
+	bool Load(const FString& Filename);
+
+	friend FArchive& operator<<(FArchive& Ar, FRHICommandStreamCaptureData& Ref);
+};
+
+/** Cost of one command type, from the capture and from its replay. */
+struct FRHICommandTypeReport
+{
+	FString Name;
+
+	/** Number of commands, which is also the number of command list allocations. */
+	int32 Count = 0;
+	uint64 AllocatedBytes = 0;
+
+	/** Execution time of the commands when they were captured. */
+	double CapturedMs = 0.0;
+
+	/** Average time per replay iteration to allocate the commands, and to execute them. */
+	double RecordMs = 0.0;
+	double ExecuteMs = 0.0;
+
+	/** True if the replay used the command type itself, false if it used a placeholder command of the same size. */
+	bool bReplayedAsType = false;
+};
+
+/**
+ * Records the type, size and execution cost of every RHI command executed during a number of frames, and replays
+ * the recorded stream against the Null or Empty RHI to measure the command recording and translation cost without a GPU.
+ *
+ * Commands reference live RHI resources so they can't be replayed as recorded. The replay allocates and executes
+ * commands that only take parameters (draws, viewports, scissors...) with default arguments, and other commands as
+ * placeholders of the captured size that execute nothing.
+ */
+class RHI_API FRHICommandStreamCapture
+{
+public:
+	static bool IsCapturing()
+	{
+		return bCapturing;
+	}
+
+	/** Starts capturing the commands executed during the next NumFrames frames, then saves them to Filename. */
+	static bool BeginCapture(int32 NumFrames, const FString& Filename);
+
+	/** Executes the commands of a command list while capturing, then resets the list. */
+	static void ExecuteAndCapture(FRHICommandListBase& CmdList);
+
+	/**
+	 * Replays a captured command stream on the calling thread, which must be allowed to use the default RHI context.
+	 * @return false if the RHI isn't the Null or Empty RHI, commands with null resources would not be safe to execute
+	 */
+	static bool Replay(const FRHICommandStreamCaptureData& Data, int32 NumIterations, TArray<FRHICommandTypeReport>& OutReport);
+
+	/** Writes a replay report to the log and to a CSV file. */
+	static void WriteReport(const TArray<FRHICommandTypeReport>& Report, const FString& CsvFilename);
+
+private:
+	struct FExecutedCommand
+	{
+		const TCHAR* Name;
+		uint32 Size;
+		uint32 Cycles;
+	};
+
+	static void ExecuteAndTime(FRHICommandListBase& CmdList, TArray<FExecutedCommand>& OutCommands);
+	static void OnEndFrame();
+
+	static TAtomic<bool> bCapturing;
+};
+
+#endif // RHI_COMMAND_STREAM_CAPTURE
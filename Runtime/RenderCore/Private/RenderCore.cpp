@@ -199,6 +199,9 @@ DEFINE_STAT(STAT_CachedShadowmapMemory);
 DEFINE_STAT(STAT_RenderTargetPoolSize);
 DEFINE_STAT(STAT_RenderTargetPoolUsed);
 DEFINE_STAT(STAT_RenderTargetPoolCount);
+DEFINE_STAT(STAT_RenderTargetPoolRequests);
+DEFINE_STAT(STAT_RenderTargetPoolHits);
+DEFINE_STAT(STAT_RenderTargetPoolEvictions);
 
 #define EXPOSE_FORCE_LOD !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
 
@@ -0,0 +1,212 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	RenderGraphAliasing.cpp: Transient resource aliasing planner for the render graph.
+=============================================================================*/
+
+#include "RenderGraphAliasing.h"
+#include "RenderUtils.h"
+#include "Algo/BinarySearch.h"
+
+const uint64 FRDGTransientAliasingPlanner::DefaultAlignment;
+const uint64 FRDGTransientAliasingPlanner::MultisampleAlignment;
+
+FRDGTransientAliasingPlanner::FRDGTransientAliasingPlanner(uint64 InHeapSize)
+	: HeapSize(InHeapSize)
+	, MemoryWithoutAliasing(0)
+	, MemoryWithAliasing(0)
+	, PeakLiveMemory(0)
+{
+	check(HeapSize > 0);
+}
+
+int32 FRDGTransientAliasingPlanner::AddResource(uint64 Size, uint64 Alignment, int32 FirstPass, int32 LastPass)
+{
+	check(FirstPass >= 0 && FirstPass <= LastPass);
+	check(Alignment > 0 && FMath::IsPowerOfTwo(Alignment));
+
+	FResource Resource;
+	Resource.Size = FMath::Max<uint64>(Size, 1);
+	Resource.Alignment = Alignment;
+	Resource.FirstPass = FirstPass;
+	Resource.LastPass = LastPass;
+	return Resources.Add(Resource);
+}
+
+void FRDGTransientAliasingPlanner::Plan()
+{
+	Allocations.Reset();
+	Allocations.SetNum(Resources.Num());
+	HeapSizes.Reset();
+	MemoryWithoutAliasing = 0;
+	MemoryWithAliasing = 0;
+	PeakLiveMemory = 0;
+
+	// Peak of the memory alive during a pass, from the size deltas at the start and end of each lifetime.
+	{
+		int32 NumPasses = 0;
+		for (const FResource& Resource : Resources)
+		{
+			MemoryWithoutAliasing += Resource.Size;
+			NumPasses = FMath::Max(NumPasses, Resource.LastPass + 2);
+		}
+
+		TArray<int64> LiveMemoryDeltas;
+		LiveMemoryDeltas.SetNumZeroed(NumPasses);
+
+		for (const FResource& Resource : Resources)
+		{
+			LiveMemoryDeltas[Resource.FirstPass] += Resource.Size;
+			LiveMemoryDeltas[Resource.LastPass + 1] -= Resource.Size;
+		}
+
+		int64 LiveMemory = 0;
+		for (int64 Delta : LiveMemoryDeltas)
+		{
+			LiveMemory += Delta;
+			PeakLiveMemory = FMath::Max<uint64>(PeakLiveMemory, LiveMemory);
+		}
+	}
+
+	// Placing large resources first leaves the gaps to the small ones.
+	TArray<int32> PlacementOrder;
+	PlacementOrder.SetNumUninitialized(Resources.Num());
+	for (int32 ResourceIndex = 0; ResourceIndex < Resources.Num(); ++ResourceIndex)
+	{
+		PlacementOrder[ResourceIndex] = ResourceIndex;
+	}
+
+	PlacementOrder.Sort([this](int32 A, int32 B)
+	{
+		const FResource& ResourceA = Resources[A];
+		const FResource& ResourceB = Resources[B];
+
+		if (ResourceA.Size != ResourceB.Size)
+		{
+			return ResourceA.Size > ResourceB.Size;
+		}
+
+		return ResourceA.FirstPass != ResourceB.FirstPass ? ResourceA.FirstPass < ResourceB.FirstPass : A < B;
+	});
+
+	// Resources placed in each heap, sorted by offset.
+	TArray<TArray<int32>> HeapResources;
+	TArray<uint64> HeapCapacities;
+
+	for (int32 ResourceIndex : PlacementOrder)
+	{
+		const FResource& Resource = Resources[ResourceIndex];
+		FAllocation& Allocation = Allocations[ResourceIndex];
+
+		for (int32 HeapIndex = 0; HeapIndex < HeapResources.Num() && Allocation.HeapIndex == INDEX_NONE; ++HeapIndex)
+		{
+			// Lowest offset past every placed resource alive at the same time, stopping at the first gap large enough.
+			uint64 Offset = 0;
+
+			for (int32 PlacedIndex : HeapResources[HeapIndex])
+			{
+				const FResource& PlacedResource = Resources[PlacedIndex];
+				const FAllocation& PlacedAllocation = Allocations[PlacedIndex];
+
+				if (!Resource.OverlapsLifetime(PlacedResource))
+				{
+					continue;
+				}
+
+				if (Align(Offset, Resource.Alignment) + Resource.Size <= PlacedAllocation.Offset)
+				{
+					break;
+				}
+
+				Offset = FMath::Max(Offset, PlacedAllocation.Offset + PlacedResource.Size);
+			}
+
+			Offset = Align(Offset, Resource.Alignment);
+
+			if (Offset + Resource.Size <= HeapCapacities[HeapIndex])
+			{
+				Allocation.HeapIndex = HeapIndex;
+				Allocation.Offset = Offset;
+			}
+		}
+
+		if (Allocation.HeapIndex == INDEX_NONE)
+		{
+			// Resources larger than the heap size get a dedicated heap, which smaller resources may still alias.
+			Allocation.HeapIndex = HeapResources.AddDefaulted();
+			Allocation.Offset = 0;
+			HeapCapacities.Add(FMath::Max(HeapSize, Resource.Size));
+			HeapSizes.Add(0);
+		}
+
+		TArray<int32>& PlacedResources = HeapResources[Allocation.HeapIndex];
+		const int32 InsertIndex = Algo::UpperBoundBy(PlacedResources, Allocation.Offset, [this](int32 PlacedIndex) { return Allocations[PlacedIndex].Offset; });
+		PlacedResources.Insert(ResourceIndex, InsertIndex);
+
+		HeapSizes[Allocation.HeapIndex] = FMath::Max(HeapSizes[Allocation.HeapIndex], Allocation.Offset + Resource.Size);
+	}
+
+	for (uint64 UsedHeapSize : HeapSizes)
+	{
+		MemoryWithAliasing += UsedHeapSize;
+	}
+}
+
+bool FRDGTransientAliasingPlanner::Validate() const
+{
+	for (int32 ResourceIndexA = 0; ResourceIndexA < Resources.Num(); ++ResourceIndexA)
+	{
+		const FResource& ResourceA = Resources[ResourceIndexA];
+		const FAllocation& AllocationA = Allocations[ResourceIndexA];
+
+		if (AllocationA.HeapIndex == INDEX_NONE || AllocationA.Offset % ResourceA.Alignment != 0)
+		{
+			return false;
+		}
+
+		for (int32 ResourceIndexB = ResourceIndexA + 1; ResourceIndexB < Resources.Num(); ++ResourceIndexB)
+		{
+			const FResource& ResourceB = Resources[ResourceIndexB];
+			const FAllocation& AllocationB = Allocations[ResourceIndexB];
+
+			const bool bOverlapsMemory = AllocationA.HeapIndex == AllocationB.HeapIndex
+				&& AllocationA.Offset < AllocationB.Offset + ResourceB.Size
+				&& AllocationB.Offset < AllocationA.Offset + ResourceA.Size;
+
+			if (bOverlapsMemory && ResourceA.OverlapsLifetime(ResourceB))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+uint64 FRDGTransientAliasingPlanner::EstimateTextureSize(const FRDGTextureDesc& Desc)
+{
+	const FPixelFormatInfo& FormatInfo = GPixelFormats[Desc.Format];
+	const uint32 Depth = Desc.Is3DTexture() ? Desc.Depth : 1;
+	const uint32 NumLayers = (Desc.IsArray() ? FMath::Max<uint32>(Desc.ArraySize, 1) : 1) * (Desc.IsCubemap() ? 6 : 1);
+
+	uint64 Size = 0;
+
+	for (uint32 MipIndex = 0; MipIndex < FMath::Max<uint32>(Desc.NumMips, 1); ++MipIndex)
+	{
+		const uint32 MipSizeX = FMath::Max<uint32>(Desc.Extent.X >> MipIndex, 1);
+		const uint32 MipSizeY = FMath::Max<uint32>(Desc.Extent.Y >> MipIndex, 1);
+		const uint32 MipSizeZ = FMath::Max<uint32>(Depth >> MipIndex, 1);
+
+		Size += uint64(FMath::DivideAndRoundUp<uint32>(MipSizeX, FormatInfo.BlockSizeX))
+			* FMath::DivideAndRoundUp<uint32>(MipSizeY, FormatInfo.BlockSizeY)
+			* MipSizeZ
+			* FormatInfo.BlockBytes;
+	}
+
+	return Size * NumLayers * FMath::Max<uint32>(Desc.NumSamples, 1);
+}
+
+uint64 FRDGTransientAliasingPlanner::EstimateBufferSize(const FRDGBufferDesc& Desc)
+{
+	return Desc.GetTotalNumBytes();
+}
@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	RenderGraphAliasing.h: Transient resource aliasing planner for the render graph.
+=============================================================================*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphResources.h"
+
+/**
+ * Assigns transient resources to aliased heaps from their lifetimes in the pass order of a graph.
+ * Resources whose pass ranges don't overlap may share the same heap range. This is CPU only and does not
+ * depend on the RHI, resources are described by an estimated size, an alignment and a pass range.
+ */
+class FRDGTransientAliasingPlanner
+{
+public:
+	/** Placement of a resource in the heaps. */
+	struct FAllocation
+	{
+		int32 HeapIndex = INDEX_NONE;
+		uint64 Offset = 0;
+	};
+
+	/** @param InHeapSize - Size of each heap, resources larger than this get a heap of their own. */
+	explicit FRDGTransientAliasingPlanner(uint64 InHeapSize);
+
+	/**
+	 * Adds a resource alive from the start of FirstPass to the end of LastPass.
+	 * @return index of the resource, used to query its allocation
+	 */
+	int32 AddResource(uint64 Size, uint64 Alignment, int32 FirstPass, int32 LastPass);
+
+	/** Assigns all added resources to heaps. Resources are placed from the largest to the smallest, at the lowest free offset of the first heap they fit in. */
+	void Plan();
+
+	const FAllocation& GetAllocation(int32 ResourceIndex) const
+	{
+		return Allocations[ResourceIndex];
+	}
+
+	int32 GetNumResources() const
+	{
+		return Resources.Num();
+	}
+
+	int32 GetNumHeaps() const
+	{
+		return HeapSizes.Num();
+	}
+
+	/** @return memory needed if every resource had its own allocation */
+	uint64 GetMemoryWithoutAliasing() const
+	{
+		return MemoryWithoutAliasing;
+	}
+
+	/** @return memory used by the heaps, up to the highest allocated offset of each heap */
+	uint64 GetMemoryWithAliasing() const
+	{
+		return MemoryWithAliasing;
+	}
+
+	/** @return largest total size of the resources alive during a single pass, the lower bound of any aliasing */
+	uint64 GetPeakLiveMemory() const
+	{
+		return PeakLiveMemory;
+	}
+
+	/** @return true if the resources placed in the same heap at overlapping offsets have disjoint lifetimes */
+	bool Validate() const;
+
+	/** Estimates the memory of a texture from its descriptor, without querying the RHI. */
+	static uint64 EstimateTextureSize(const FRDGTextureDesc& Desc);
+
+	/** Estimates the memory of a buffer from its descriptor. */
+	static uint64 EstimateBufferSize(const FRDGBufferDesc& Desc);
+
+	/** Placement alignment of textures and buffers, and of multisampled textures. */
+	static const uint64 DefaultAlignment = 64 * 1024;
+	static const uint64 MultisampleAlignment = 4 * 1024 * 1024;
+
+private:
+	struct FResource
+	{
+		uint64 Size;
+		uint64 Alignment;
+		int32 FirstPass;
+		int32 LastPass;
+
+		bool OverlapsLifetime(const FResource& Other) const
+		{
+			return FirstPass <= Other.LastPass && Other.FirstPass <= LastPass;
+		}
+	};
+
+	uint64 HeapSize;
+	TArray<FResource> Resources;
+	TArray<FAllocation> Allocations;
+
+	/** Highest allocated offset of each heap. */
+	TArray<uint64> HeapSizes;
+
+	uint64 MemoryWithoutAliasing;
+	uint64 MemoryWithAliasing;
+	uint64 PeakLiveMemory;
+};
@@ -5,13 +5,35 @@
 #include "RenderTargetPool.h"
 #include "RenderGraphResourcePool.h"
 #include "RenderGraphBarrierBatcher.h"
+#include "RenderGraphAliasing.h"
 #include "VisualizeTexture.h"
 #include "ProfilingDebugging/CsvProfiler.h"
 
+DECLARE_MEMORY_STAT(TEXT("RDG Transient Memory"), STAT_RDGTransientMemory, STATGROUP_RenderTargetPool);
+DECLARE_MEMORY_STAT(TEXT("RDG Transient Memory Aliased"), STAT_RDGTransientMemoryAliased, STATGROUP_RenderTargetPool);
+DECLARE_MEMORY_STAT(TEXT("RDG Transient Memory Peak Live"), STAT_RDGTransientMemoryPeakLive, STATGROUP_RenderTargetPool);
+
 namespace
 {
 const int32 kRDGEmitWarningsOnce = 1;
 
+int32 GRDGTransientAliasing = 0;
+FAutoConsoleVariableRef CVarRDGTransientAliasing(
+	TEXT("r.RDG.TransientAliasing"),
+	GRDGTransientAliasing,
+	TEXT("Plans the placement of the transient resources of each graph in aliased heaps from their pass lifetimes, and reports the transient memory with and without aliasing.\n")
+	TEXT(" 0: disabled (default);\n")
+	TEXT(" 1: plan and update the RDG transient memory stats;\n")
+	TEXT(" 2: also log the plan of every graph."),
+	ECVF_RenderThreadSafe);
+
+int32 GRDGTransientAliasingHeapSizeMB = 64;
+FAutoConsoleVariableRef CVarRDGTransientAliasingHeapSizeMB(
+	TEXT("r.RDG.TransientAliasing.HeapSizeMB"),
+	GRDGTransientAliasingHeapSizeMB,
+	TEXT("Size of the heaps the transient resources are planned into, in megabytes. Larger resources get a heap of their own."),
+	ECVF_RenderThreadSafe);
+
 #if RDG_ENABLE_DEBUG
 
 int32 GRDGImmediateMode = 0;
@@ -179,6 +201,11 @@ void FRDGBuilder::Execute()
 	{
 		WalkGraphDependencies();
 
+		if (GRDGTransientAliasing)
+		{
+			PlanTransientResourceAliasing();
+		}
+
 		QUICK_SCOPE_CYCLE_COUNTER(STAT_FRDGBuilder_Execute);
 		for (const FRDGPass* Pass : Passes)
 		{
@@ -493,6 +520,150 @@ void FRDGBuilder::WalkGraphDependencies()
 	}
 }
 
+void FRDGBuilder::PlanTransientResourceAliasing()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FRDGBuilder_PlanTransientResourceAliasing);
+
+	struct FTransientResource
+	{
+		uint64 Size;
+		uint64 Alignment;
+		int32 FirstPass;
+		int32 LastPass;
+		bool bExtracted;
+	};
+
+	TMap<const FRDGParentResource*, FTransientResource, SceneRenderingSetAllocator> TransientResources;
+
+	const auto AddResourceUse = [&TransientResources](const FRDGParentResource* Resource, int32 PassIndex, uint64 Size, uint64 Alignment)
+	{
+		if (FTransientResource* TransientResource = TransientResources.Find(Resource))
+		{
+			TransientResource->LastPass = PassIndex;
+		}
+		else
+		{
+			TransientResources.Add(Resource, { Size, Alignment, PassIndex, PassIndex, false });
+		}
+	};
+
+	// Registered external resources already have their pooled resource, only the ones created by the graph are transient.
+	const auto AddTextureUse = [&AddResourceUse](const FRDGTexture* Texture, int32 PassIndex)
+	{
+		if (Texture && !Texture->PooledRenderTarget)
+		{
+			const uint64 Alignment = Texture->Desc.NumSamples > 1 ? FRDGTransientAliasingPlanner::MultisampleAlignment : FRDGTransientAliasingPlanner::DefaultAlignment;
+			AddResourceUse(Texture, PassIndex, FRDGTransientAliasingPlanner::EstimateTextureSize(Texture->Desc), Alignment);
+		}
+	};
+
+	const auto AddBufferUse = [&AddResourceUse](const FRDGBuffer* Buffer, int32 PassIndex)
+	{
+		if (Buffer && !Buffer->PooledBuffer)
+		{
+			AddResourceUse(Buffer, PassIndex, FRDGTransientAliasingPlanner::EstimateBufferSize(Buffer->Desc), FRDGTransientAliasingPlanner::DefaultAlignment);
+		}
+	};
+
+	for (int32 PassIndex = 0; PassIndex < Passes.Num(); ++PassIndex)
+	{
+		FRDGPassParameterStruct ParameterStruct = Passes[PassIndex]->GetParameters();
+
+		const uint32 ParameterCount = ParameterStruct.GetParameterCount();
+
+		for (uint32 ParameterIndex = 0; ParameterIndex < ParameterCount; ++ParameterIndex)
+		{
+			FRDGPassParameter Parameter = ParameterStruct.GetParameter(ParameterIndex);
+
+			switch (Parameter.GetType())
+			{
+			case UBMT_RDG_TEXTURE:
+			case UBMT_RDG_TEXTURE_COPY_DEST:
+				AddTextureUse(Parameter.GetAsTexture(), PassIndex);
+				break;
+			case UBMT_RDG_TEXTURE_SRV:
+			case UBMT_RDG_TEXTURE_UAV:
+				if (FRDGChildResourceRef Resource = Parameter.GetAsChildResource())
+				{
+					AddTextureUse(static_cast<const FRDGTexture*>(Resource->GetParent()), PassIndex);
+				}
+				break;
+			case UBMT_RDG_BUFFER:
+			case UBMT_RDG_BUFFER_COPY_DEST:
+				AddBufferUse(Parameter.GetAsBuffer(), PassIndex);
+				break;
+			case UBMT_RDG_BUFFER_SRV:
+			case UBMT_RDG_BUFFER_UAV:
+				if (FRDGChildResourceRef Resource = Parameter.GetAsChildResource())
+				{
+					AddBufferUse(static_cast<const FRDGBuffer*>(Resource->GetParent()), PassIndex);
+				}
+				break;
+			case UBMT_RENDER_TARGET_BINDING_SLOTS:
+			{
+				const FRenderTargetBindingSlots& RenderTargetBindingSlots = Parameter.GetAsRenderTargetBindingSlots();
+				const auto& RenderTargets = RenderTargetBindingSlots.Output;
+				const uint32 RenderTargetCount = RenderTargets.Num();
+
+				for (uint32 RenderTargetIndex = 0; RenderTargetIndex < RenderTargetCount && RenderTargets[RenderTargetIndex].GetTexture(); ++RenderTargetIndex)
+				{
+					AddTextureUse(RenderTargets[RenderTargetIndex].GetTexture(), PassIndex);
+				}
+
+				AddTextureUse(RenderTargetBindingSlots.DepthStencil.GetTexture(), PassIndex);
+			}
+			break;
+			}
+		}
+	}
+
+	// Extracted resources outlive the graph, so they can't be aliased.
+	for (const auto& Query : DeferredInternalTextureQueries)
+	{
+		if (FTransientResource* TransientResource = TransientResources.Find(Query.Texture))
+		{
+			TransientResource->bExtracted = true;
+		}
+	}
+	for (const auto& Query : DeferredInternalBufferQueries)
+	{
+		if (FTransientResource* TransientResource = TransientResources.Find(Query.Buffer))
+		{
+			TransientResource->bExtracted = true;
+		}
+	}
+
+	FRDGTransientAliasingPlanner Planner(uint64(FMath::Max(GRDGTransientAliasingHeapSizeMB, 1)) * 1024 * 1024);
+
+	for (const auto& Pair : TransientResources)
+	{
+		const FTransientResource& TransientResource = Pair.Value;
+
+		if (!TransientResource.bExtracted)
+		{
+			Planner.AddResource(TransientResource.Size, TransientResource.Alignment, TransientResource.FirstPass, TransientResource.LastPass);
+		}
+	}
+
+	Planner.Plan();
+
+	SET_MEMORY_STAT(STAT_RDGTransientMemory, Planner.GetMemoryWithoutAliasing());
+	SET_MEMORY_STAT(STAT_RDGTransientMemoryAliased, Planner.GetMemoryWithAliasing());
+	SET_MEMORY_STAT(STAT_RDGTransientMemoryPeakLive, Planner.GetPeakLiveMemory());
+
+	if (GRDGTransientAliasing > 1)
+	{
+		const double MB = 1024.0 * 1024.0;
+		UE_LOG(LogRendererCore, Log, TEXT("RDG transient aliasing: %d resources over %d passes, %.2f MB without aliasing, %.2f MB aliased in %d heaps, %.2f MB peak live"),
+			Planner.GetNumResources(),
+			Passes.Num(),
+			Planner.GetMemoryWithoutAliasing() / MB,
+			Planner.GetMemoryWithAliasing() / MB,
+			Planner.GetNumHeaps(),
+			Planner.GetPeakLiveMemory() / MB);
+	}
+}
+
 void FRDGBuilder::AllocateRHITextureIfNeeded(FRDGTexture* Texture)
 {
 	check(Texture);
@@ -6,6 +6,7 @@
 
 #include "RenderTargetPool.h"
 #include "RHIStaticStates.h"
+#include "RenderingThread.h"
 
 /** The global render targets pool. */
 TGlobalResource<FRenderTargetPool> GRenderTargetPool;
@@ -54,6 +55,80 @@ static FAutoConsoleCommand GRenderTargetPoolEventsCmd(
 	FConsoleCommandWithArgsDelegate::CreateStatic(RenderTargetPoolEvents)
 	);
 
+void RenderTargetPoolBenchmark(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+{
+	const int32 NumIterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+	const int32 NumDescs = Args.Num() > 1 ? FMath::Clamp(FCString::Atoi(*Args[1]), 1, 4096) : 256;
+
+	struct FBenchmarkResult
+	{
+		double Seconds = 0.0;
+		uint32 NumRequests = 0;
+		uint32 NumHits = 0;
+		int32 NumBuckets = 0;
+	};
+	FBenchmarkResult Result;
+
+	ENQUEUE_RENDER_COMMAND(RenderTargetPoolBenchmark)(
+		[NumIterations, NumDescs, &Result](FRHICommandListImmediate& RHICmdList)
+	{
+		// Small distinct targets, a few of them sharing a descriptor, so that the pool holds many elements like a frame with many passes does.
+		TArray<FPooledRenderTargetDesc> Descs;
+		for (int32 DescIndex = 0; DescIndex < NumDescs; ++DescIndex)
+		{
+			const int32 DistinctIndex = DescIndex % FMath::Max(NumDescs * 3 / 4, 1);
+			const FIntPoint Extent(16 + 4 * (DistinctIndex % 32), 16 + 4 * (DistinctIndex / 32));
+			Descs.Add(FPooledRenderTargetDesc::Create2DDesc(Extent, DescIndex % 3 ? PF_FloatRGBA : PF_B8G8R8A8, FClearValueBinding::None, TexCreate_None, TexCreate_RenderTargetable, false));
+		}
+
+		TArray<TRefCountPtr<IPooledRenderTarget>> Targets;
+		Targets.SetNum(NumDescs);
+
+		const uint32 StartNumRequests = GRenderTargetPool.NumFindRequests;
+		const uint32 StartNumHits = GRenderTargetPool.NumFindHits;
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			for (int32 DescIndex = 0; DescIndex < NumDescs; ++DescIndex)
+			{
+				GRenderTargetPool.FindFreeElement(RHICmdList, Descs[DescIndex], Targets[DescIndex], TEXT("RenderTargetPoolBenchmark"), false);
+			}
+
+			for (TRefCountPtr<IPooledRenderTarget>& Target : Targets)
+			{
+				Target.SafeRelease();
+			}
+		}
+
+		Result.Seconds = FPlatformTime::Seconds() - StartTime;
+		Result.NumRequests = GRenderTargetPool.NumFindRequests - StartNumRequests;
+		Result.NumHits = GRenderTargetPool.NumFindHits - StartNumHits;
+		Result.NumBuckets = GRenderTargetPool.DescBuckets.Num();
+
+		// Don't leave the benchmark targets in the pool.
+		GRenderTargetPool.FreeUnusedResources();
+	});
+
+	FlushRenderingCommands();
+
+	Ar.Logf(TEXT("Render target pool benchmark: %d iterations of %d requests, %.3f us per request, %u/%u served from the pool, %d descriptor buckets, %d pooled render targets"),
+		NumIterations,
+		NumDescs,
+		Result.NumRequests > 0 ? Result.Seconds * 1000000.0 / Result.NumRequests : 0.0,
+		Result.NumHits,
+		Result.NumRequests,
+		Result.NumBuckets,
+		GRenderTargetPool.GetElementCount());
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GRenderTargetPoolBenchmarkCmd(
+	TEXT("r.RenderTargetPool.Benchmark"),
+	TEXT("Measures FindFreeElement on the render thread, works with -nullrhi. Unused pooled render targets are freed afterwards.\n")
+	TEXT("Usage: r.RenderTargetPool.Benchmark [Iterations=100] [RequestsPerIteration=256]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(RenderTargetPoolBenchmark)
+	);
+
 static TAutoConsoleVariable<int32> CVarAllowMultipleAliasingDiscardsPerFrame(
 	TEXT("r.RenderTargetPool.AllowMultipleAliasingDiscardsPerFrame"),
 	0,
@@ -73,6 +148,13 @@ static TAutoConsoleVariable<int32> CVarRtPoolTransientMode(
 	TEXT("3 : enable transient resource aliasing for ALL rendertargets (not recommended)\n"),
 	ECVF_RenderThreadSafe);
 
+static TAutoConsoleVariable<int32> CVarRtPoolMinUnusedFramesBeforeEviction(
+	TEXT("r.RenderTargetPool.MinUnusedFramesBeforeEviction"),
+	3,
+	TEXT("Number of frames a render target must have been unused before it can be evicted to bring the pool under r.RenderTargetPoolMin.\n")
+	TEXT("Eligible render targets are evicted in least recently used order, only until the pool fits in the budget."),
+	ECVF_RenderThreadSafe);
+
 bool FRenderTargetPool::IsEventRecordingEnabled() const
 {
 #if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
@@ -118,7 +200,10 @@ static uint32 ComputeSizeInKB(FPooledRenderTarget& Element)
 }
 
 FRenderTargetPool::FRenderTargetPool()
-	: AllocationLevelInKB(0)
+	: UseCounter(0)
+	, NumFindRequests(0)
+	, NumFindHits(0)
+	, AllocationLevelInKB(0)
 	, bCurrentlyOverBudget(false)
 	, bStartEventRecordingNextTick(false)
 	, EventRecordingSizeThreshold(0)
@@ -267,16 +352,11 @@ bool FRenderTargetPool::FindFreeElement(FRHICommandList& RHICmdList, const FPool
 
 			if (Current->IsFree())
 			{
-				AllocationLevelInKB -= ComputeSizeInKB(*Current);
-
 				int32 Index = FindIndex(Current);
 
 				check(Index >= 0);
 
-				// we don't use Remove() to not shuffle around the elements for better transparency on RenderTargetPoolEvents
-				PooledRenderTargets[Index] = 0;
-
-				VerifyAllocationLevel();
+				RemoveElement(Index, false);
 			}
 		}
 	}
@@ -285,7 +365,9 @@ bool FRenderTargetPool::FindFreeElement(FRHICommandList& RHICmdList, const FPool
 	FPooledRenderTarget* Found = 0;
 	uint32 FoundIndex = -1;
 	bool bReusingExistingTarget = false;
-	// try to find a suitable element in the pool
+	++NumFindRequests;
+	// try to find a suitable element in the pool, only the elements with a compatible descriptor are in the bucket
+	if (const TArray<FPooledRenderTarget*, TInlineAllocator<4>>* Bucket = DescBuckets.Find(GetDescBucketHash(Desc)))
 	{
 		//don't spend time doing 2 passes if the platform doesn't support fastvram
 		uint32 PassCount = 1;
@@ -304,15 +386,9 @@ bool FRenderTargetPool::FindFreeElement(FRHICommandList& RHICmdList, const FPool
 		{
 			bool bExactMatch = (Pass == 0); //-V547
     
-			for (uint32 i = 0, Num = (uint32)PooledRenderTargets.Num(); i < Num; ++i)
+			for (FPooledRenderTarget* Element : *Bucket)
 			{
-				FPooledRenderTarget* Element = PooledRenderTargets[i];
-				if (Element && Element->GetDesc().Compare(Desc, bExactMatch))
-				{
-					int a = 0;
-				}
-    
-				if (Element && Element->IsFree() && Element->GetDesc().Compare(Desc, bExactMatch))
+				if (Element->IsFree() && Element->GetDesc().Compare(Desc, bExactMatch))
 				{
 					if ( ( Desc.Flags & TexCreate_Transient ) && bAllowMultipleDiscards == false && Element->HasBeenDiscardedThisFrame() )
 					{
@@ -321,8 +397,10 @@ bool FRenderTargetPool::FindFreeElement(FRHICommandList& RHICmdList, const FPool
 					}
 					check(!Element->IsSnapshot());
 					Found = Element;
-					FoundIndex = i;
+					// the index is only needed to record the event
+					FoundIndex = IsEventRecordingEnabled() ? FindIndex(Element) : -1;
 					bReusingExistingTarget = true;
+					++NumFindHits;
 					goto Done;
 				}
 			}
@@ -338,6 +416,7 @@ Done:
 		Found = new FPooledRenderTarget(Desc, this);
 
 		PooledRenderTargets.Add(Found);
+		AddToDescBucket(Found);
 		
 		// TexCreate_UAV should be used on Desc.TargetableFlags
 		check(!(Desc.Flags & TexCreate_UAV));
@@ -522,6 +601,7 @@ Done:
 
 	Found->Desc.DebugName = InDebugName;
 	Found->UnusedForNFrames = 0;
+	Found->LastUseTime = ++UseCounter;
 
 	AddAllocEvent(FoundIndex, Found);
 
@@ -874,58 +954,21 @@ void FRenderTargetPool::TickPoolElements()
 		}
 	}
 
-	// we need to release something, take the oldest ones first
-	while (AllocationLevelInKB > MinimumPoolSizeInKB)
-	{
-		// -1: not set
-		int32 OldestElementIndex = -1;
-
-		// find oldest element we can remove
-		for (uint32 i = 0, Num = (uint32)PooledRenderTargets.Num(); i < Num; ++i)
-		{
-			FPooledRenderTarget* Element = PooledRenderTargets[i];
+	// we need to release something, take the least recently used ones first
+	EvictLeastRecentlyUsed(MinimumPoolSizeInKB);
 
-			if (Element && Element->UnusedForNFrames > 2)
-			{
-				if (OldestElementIndex != -1)
-				{
-					if (PooledRenderTargets[OldestElementIndex]->UnusedForNFrames < Element->UnusedForNFrames)
-					{
-						OldestElementIndex = i;
-					}
-				}
-				else
-				{
-					OldestElementIndex = i;
-				}
-			}
-		}
-
-		if (OldestElementIndex != -1)
-		{
-			AllocationLevelInKB -= ComputeSizeInKB(*PooledRenderTargets[OldestElementIndex]);
-
-			// we assume because of reference counting the resource gets released when not needed any more
-			// we don't use Remove() to not shuffle around the elements for better transparency on RenderTargetPoolEvents
-			PooledRenderTargets[OldestElementIndex] = 0;
-
-			VerifyAllocationLevel();
-		}
-		else
+	if (AllocationLevelInKB > MinimumPoolSizeInKB)
+	{
+		// There is no element we can remove but we are over budget, better we log that.
+		// Options:
+		//   * Increase the pool
+		//   * Reduce rendering features or resolution
+		//   * Investigate allocations, order or reusing other render targets can help
+		//   * Ignore (editor case, might start using slow memory which can be ok)
+		if (!bCurrentlyOverBudget)
 		{
-			// There is no element we can remove but we are over budget, better we log that.
-			// Options:
-			//   * Increase the pool
-			//   * Reduce rendering features or resolution
-			//   * Investigate allocations, order or reusing other render targets can help
-			//   * Ignore (editor case, might start using slow memory which can be ok)
-			if (!bCurrentlyOverBudget)
-			{
-				UE_CLOG(IsRunningClientOnly(), LogRenderTargetPool, Warning, TEXT("r.RenderTargetPoolMin exceeded %d/%d MB (ok in editor, bad on fixed memory platform)"), (AllocationLevelInKB + 1023) / 1024, MinimumPoolSizeInKB / 1024);
-				bCurrentlyOverBudget = true;
-			}
-			// at this point we need to give up
-			break;
+			UE_CLOG(IsRunningClientOnly(), LogRenderTargetPool, Warning, TEXT("r.RenderTargetPoolMin exceeded %d/%d MB (ok in editor, bad on fixed memory platform)"), (AllocationLevelInKB + 1023) / 1024, MinimumPoolSizeInKB / 1024);
+			bCurrentlyOverBudget = true;
 		}
 	}
 
@@ -948,7 +991,101 @@ void FRenderTargetPool::TickPoolElements()
 	SET_MEMORY_STAT(STAT_RenderTargetPoolSize, int64(SizeKB) * 1024ll);
 	SET_MEMORY_STAT(STAT_RenderTargetPoolUsed, int64(UsedKB) * 1024ll);
 	SET_DWORD_STAT(STAT_RenderTargetPoolCount, Count);
+	SET_DWORD_STAT(STAT_RenderTargetPoolRequests, NumFindRequests);
+	SET_DWORD_STAT(STAT_RenderTargetPoolHits, NumFindHits);
 #endif // STATS
+
+	NumFindRequests = 0;
+	NumFindHits = 0;
+}
+
+uint32 FRenderTargetPool::GetDescBucketHash(const FPooledRenderTargetDesc& Desc)
+{
+	uint32 Hash = GetTypeHash(Desc.Extent);
+	Hash = HashCombine(Hash, Desc.Depth);
+	Hash = HashCombine(Hash, Desc.ArraySize | (uint32(Desc.bIsArray) << 30) | (uint32(Desc.bIsCubemap) << 31));
+	Hash = HashCombine(Hash, uint32(Desc.NumMips) | (uint32(Desc.NumSamples) << 16));
+	Hash = HashCombine(Hash, uint32(Desc.Format));
+	Hash = HashCombine(Hash, Desc.Flags & ~TexCreate_FastVRAM);
+	Hash = HashCombine(Hash, Desc.TargetableFlags);
+	return Hash;
+}
+
+void FRenderTargetPool::AddToDescBucket(FPooledRenderTarget* Element)
+{
+	DescBuckets.FindOrAdd(GetDescBucketHash(Element->GetDesc())).Add(Element);
+}
+
+void FRenderTargetPool::RemoveFromDescBucket(FPooledRenderTarget* Element)
+{
+	const uint32 Hash = GetDescBucketHash(Element->GetDesc());
+	TArray<FPooledRenderTarget*, TInlineAllocator<4>>& Bucket = DescBuckets.FindChecked(Hash);
+
+	// keep the order, so the search still prefers the oldest elements like the linear search did
+	verify(Bucket.RemoveSingle(Element) == 1);
+
+	if (Bucket.Num() == 0)
+	{
+		DescBuckets.Remove(Hash);
+	}
+}
+
+void FRenderTargetPool::RemoveElement(int32 Index, bool bDeferDelete)
+{
+	FPooledRenderTarget* Element = PooledRenderTargets[Index];
+	check(Element && !Element->IsSnapshot());
+
+	AllocationLevelInKB -= ComputeSizeInKB(*Element);
+	RemoveFromDescBucket(Element);
+
+	if (bDeferDelete)
+	{
+		DeferredDeleteArray.Add(PooledRenderTargets[Index]);
+	}
+
+	// we assume because of reference counting the resource gets released when not needed any more
+	// we don't use Remove() to not shuffle around the elements for better transparency on RenderTargetPoolEvents
+	PooledRenderTargets[Index] = 0;
+
+	VerifyAllocationLevel();
+}
+
+void FRenderTargetPool::EvictLeastRecentlyUsed(uint32 BudgetInKB)
+{
+	if (AllocationLevelInKB <= BudgetInKB)
+	{
+		return;
+	}
+
+	const uint32 MinUnusedFrames = (uint32)FMath::Max(CVarRtPoolMinUnusedFramesBeforeEviction.GetValueOnRenderThread(), 1);
+
+	TArray<int32, TInlineAllocator<64>> Candidates;
+
+	for (int32 Index = 0; Index < PooledRenderTargets.Num(); ++Index)
+	{
+		FPooledRenderTarget* Element = PooledRenderTargets[Index];
+
+		if (Element && Element->IsFree() && Element->UnusedForNFrames >= MinUnusedFrames)
+		{
+			Candidates.Add(Index);
+		}
+	}
+
+	Candidates.Sort([this](int32 A, int32 B)
+	{
+		return PooledRenderTargets[A]->LastUseTime < PooledRenderTargets[B]->LastUseTime;
+	});
+
+	for (int32 Index : Candidates)
+	{
+		if (AllocationLevelInKB <= BudgetInKB)
+		{
+			break;
+		}
+
+		RemoveElement(Index, false);
+		INC_DWORD_STAT(STAT_RenderTargetPoolEvictions);
+	}
 }
 
 int32 FRenderTargetPool::FindIndex(IPooledRenderTarget* In) const
@@ -985,16 +1122,9 @@ void FRenderTargetPool::FreeUnusedResource(TRefCountPtr<IPooledRenderTarget>& In
 
 		if (Element && Element->IsFree())
 		{
-			check(!Element->IsSnapshot());
-			AllocationLevelInKB -= ComputeSizeInKB(*Element);
-			// we assume because of reference counting the resource gets released when not needed any more
-			// we don't use Remove() to not shuffle around the elements for better transparency on RenderTargetPoolEvents
-			DeferredDeleteArray.Add(PooledRenderTargets[Index]);
-			PooledRenderTargets[Index] = 0;
+			RemoveElement(Index, true);
 
 			In.SafeRelease();
-
-			VerifyAllocationLevel();
 		}
 	}
 }
@@ -1009,16 +1139,9 @@ void FRenderTargetPool::FreeUnusedResources()
 
 		if (Element && Element->IsFree())
 		{
-			check(!Element->IsSnapshot());
-			AllocationLevelInKB -= ComputeSizeInKB(*Element);
-			// we assume because of reference counting the resource gets released when not needed any more
-			// we don't use Remove() to not shuffle around the elements for better transparency on RenderTargetPoolEvents
-			DeferredDeleteArray.Add(PooledRenderTargets[i]);
-			PooledRenderTargets[i] = 0;
+			RemoveElement(i, true);
 		}
 	}
-
-	VerifyAllocationLevel();
 }
 
 void FRenderTargetPool::DumpMemoryUsage(FOutputDevice& OutputDevice)
@@ -1051,6 +1174,7 @@ void FRenderTargetPool::DumpMemoryUsage(FOutputDevice& OutputDevice)
 	uint32 PoolKB=0;
 	GetStats(NumTargets,PoolKB,UsedKB);
 	OutputDevice.Logf(TEXT("%.3fMB total, %.3fMB used, %d render targets"), PoolKB / 1024.f, UsedKB / 1024.f, NumTargets);
+	OutputDevice.Logf(TEXT("%d descriptor buckets, %u/%u requests served from the pool this frame"), DescBuckets.Num(), NumFindHits, NumFindRequests);
 
 	uint32 DeferredTotal = 0;
 	OutputDevice.Logf(TEXT("Deferred Render Targets:"));
@@ -1103,15 +1227,21 @@ uint32 FPooledRenderTarget::Release()
 			RenderTargetItem.SafeRelease();
 			delete this;
 		}
-		else if (Refs == 1 && RenderTargetPool && IsTransient() )
+		else if (Refs == 1 && RenderTargetPool)
 		{
-			// Discard the resource
-			check(GetRenderTargetItem().TargetableTexture != nullptr);
-			if (GetRenderTargetItem().TargetableTexture)
+			// Only referenced by the pool again
+			LastUseTime = ++RenderTargetPool->UseCounter;
+
+			if (IsTransient())
 			{
-				RHIDiscardTransientResource(GetRenderTargetItem().TargetableTexture);
+				// Discard the resource
+				check(GetRenderTargetItem().TargetableTexture != nullptr);
+				if (GetRenderTargetItem().TargetableTexture)
+				{
+					RHIDiscardTransientResource(GetRenderTargetItem().TargetableTexture);
+				}
+				FrameNumberLastDiscard = GFrameNumberRenderThread;
 			}
-			FrameNumberLastDiscard = GFrameNumberRenderThread;
 		}
 		return Refs;
 	}
@@ -1142,6 +1272,7 @@ void FRenderTargetPool::ReleaseDynamicRHI()
 	WaitForTransitionFence();
 
 	PooledRenderTargets.Empty();
+	DescBuckets.Empty();
 	if (PooledRenderTargetSnapshots.Num())
 	{
 		DestructSnapshots();
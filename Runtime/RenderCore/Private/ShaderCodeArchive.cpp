@@ -6,6 +6,8 @@
 #include "Stats/Stats.h"
 #include "ProfilingDebugging/LoadTimeTracker.h"
 #include "Misc/MemStack.h"
+#include "Hash/CityHash.h"
+#include "HAL/PlatformFilemanager.h"
 
 int32 GShaderCodeLibraryAsyncLoadingPriority = int32(AIOP_Normal);
 static FAutoConsoleVariableRef CVarShaderCodeLibraryAsyncLoadingPriority(
@@ -15,6 +17,17 @@ static FAutoConsoleVariableRef CVarShaderCodeLibraryAsyncLoadingPriority(
 	ECVF_Default
 );
 
+int32 GShaderCodeLibraryMemoryMapped = 0;
+static FAutoConsoleVariableRef CVarShaderCodeLibraryMemoryMapped(
+	TEXT("r.ShaderCodeLibrary.MemoryMapped"),
+	GShaderCodeLibraryMemoryMapped,
+	TEXT("If > 0, the shader code of the libraries is memory mapped instead of read through the file cache, each shader is decompressed from the mapping when it is first created.\n")
+	TEXT("Falls back to the file cache when the platform or the pak file can't map the library. Read when a library is opened."),
+	ECVF_Default
+);
+
+DECLARE_MEMORY_STAT(TEXT("Shader Library Mapped Mem"), STAT_Shaders_ShaderLibraryMappedMemory, STATGROUP_Shaders);
+
 static const FName ShaderLibraryCompressionFormat = NAME_LZ4;
 
 int32 FSerializedShaderArchive::FindShaderMapWithKey(const FSHAHash& Hash, uint32 Key) const
@@ -116,6 +129,54 @@ void FSerializedShaderArchive::Finalize()
 		}
 	}
 
+	BuildPreloadEntries();
+}
+
+void FSerializedShaderArchive::Finalize(const TArray<TArray<uint8>>& ShaderCode, TArray<int32>& OutCodeIndices)
+{
+	check(ShaderCode.Num() == ShaderEntries.Num());
+
+	OutCodeIndices.Reset(ShaderEntries.Num());
+
+	// Set the offsets, shaders whose code was already written point to it
+	{
+		TMultiMap<uint64, int32> CodeHashToShaderIndex;
+		uint64 Offset = 0u;
+		for (int32 ShaderIndex = 0; ShaderIndex < ShaderEntries.Num(); ++ShaderIndex)
+		{
+			FShaderCodeEntry& Entry = ShaderEntries[ShaderIndex];
+			const TArray<uint8>& Code = ShaderCode[ShaderIndex];
+			check(Entry.Size == Code.Num());
+
+			const uint64 CodeHash = CityHash64((const char*)Code.GetData(), Code.Num());
+			int32 SharedShaderIndex = INDEX_NONE;
+			for (auto It = CodeHashToShaderIndex.CreateConstKeyIterator(CodeHash); It && SharedShaderIndex == INDEX_NONE; ++It)
+			{
+				if (ShaderEntries[It.Value()].UncompressedSize == Entry.UncompressedSize && ShaderCode[It.Value()] == Code)
+				{
+					SharedShaderIndex = It.Value();
+				}
+			}
+
+			if (SharedShaderIndex != INDEX_NONE)
+			{
+				Entry.Offset = ShaderEntries[SharedShaderIndex].Offset;
+			}
+			else
+			{
+				Entry.Offset = Offset;
+				Offset += Entry.Size;
+				CodeHashToShaderIndex.Add(CodeHash, ShaderIndex);
+				OutCodeIndices.Add(ShaderIndex);
+			}
+		}
+	}
+
+	BuildPreloadEntries();
+}
+
+void FSerializedShaderArchive::BuildPreloadEntries()
+{
 	PreloadEntries.Empty();
 	for (FShaderMapEntry& ShaderMapEntry : ShaderMapEntries)
 	{
@@ -136,6 +197,12 @@ void FSerializedShaderArchive::Finalize()
 		for (uint32 PreloadIndex = 1; PreloadIndex <= ShaderMapEntry.NumShaders; ++PreloadIndex)
 		{
 			const FFileCachePreloadEntry& PreloadEntry = SortedPreloadEntries[PreloadIndex];
+			if (PreloadEntry.Offset + PreloadEntry.Size <= CurrentPreloadEntry.Offset + CurrentPreloadEntry.Size && PreloadEntry.Size > 0)
+			{
+				// Code shared with a shader already in the current entry
+				continue;
+			}
+
 			const int64 Gap = PreloadEntry.Offset - CurrentPreloadEntry.Offset - CurrentPreloadEntry.Size;
 			checkf(Gap >= 0, TEXT("Overlapping preload entries, [%lld-%lld), [%lld-%lld)"),
 				CurrentPreloadEntry.Offset, CurrentPreloadEntry.Offset + CurrentPreloadEntry.Size, PreloadEntry.Offset, PreloadEntry.Offset + PreloadEntry.Size);
@@ -204,12 +271,34 @@ FShaderCodeArchive* FShaderCodeArchive::Create(EShaderPlatform InPlatform, FArch
 	}
 #endif // TRACK_SHADER_PRELOADS
 
-	// Open library for async reads
-	Library->FileCacheHandle = IFileCacheHandle::CreateFileCacheHandle(*InDestFilePath);
+	if (GShaderCodeLibraryMemoryMapped > 0 && Library->SerializedShaders.GetNumShaders() > 0)
+	{
+		// Map the shader code, pages are only made resident when a shader is created
+		Library->MappedFileHandle = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*InDestFilePath);
+		if (Library->MappedFileHandle && Library->MappedFileHandle->GetFileSize() > Library->LibraryCodeOffset)
+		{
+			Library->MappedCodeRegion = Library->MappedFileHandle->MapRegion(Library->LibraryCodeOffset);
+		}
 
-	UE_LOG(LogShaderLibrary, Display, TEXT("Using %s for material shader code. Total %d unique shaders."), *InDestFilePath, Library->SerializedShaders.ShaderEntries.Num());
+		if (!Library->MappedCodeRegion)
+		{
+			UE_LOG(LogShaderLibrary, Display, TEXT("Unable to memory map %s, falling back to the file cache."), *InDestFilePath);
+			delete Library->MappedFileHandle;
+			Library->MappedFileHandle = nullptr;
+		}
+	}
+
+	if (!Library->MappedCodeRegion)
+	{
+		// Open library for async reads
+		Library->FileCacheHandle = IFileCacheHandle::CreateFileCacheHandle(*InDestFilePath);
+	}
+
+	UE_LOG(LogShaderLibrary, Display, TEXT("Using %s for material shader code. Total %d unique shaders, %.1f KB resident, %.1f KB mapped."), *InDestFilePath, Library->SerializedShaders.ShaderEntries.Num(),
+		Library->GetSizeBytes() / 1024.0f, Library->GetMappedSizeBytes() / 1024.0f);
 
 	INC_DWORD_STAT_BY(STAT_Shaders_ShaderResourceMemory, Library->GetSizeBytes());
+	INC_MEMORY_STAT_BY(STAT_Shaders_ShaderLibraryMappedMemory, Library->GetMappedSizeBytes());
 
 	return Library;
 }
@@ -219,6 +308,8 @@ FShaderCodeArchive::FShaderCodeArchive(EShaderPlatform InPlatform, const FString
 	, LibraryDir(InLibraryDir)
 	, LibraryCodeOffset(0)
 	, FileCacheHandle(nullptr)
+	, MappedFileHandle(nullptr)
+	, MappedCodeRegion(nullptr)
 {
 }
 
@@ -235,6 +326,19 @@ void FShaderCodeArchive::Teardown()
 		delete FileCacheHandle;
 		FileCacheHandle = nullptr;
 	}
+
+	if (MappedCodeRegion)
+	{
+		DEC_MEMORY_STAT_BY(STAT_Shaders_ShaderLibraryMappedMemory, MappedCodeRegion->GetMappedSize());
+		delete MappedCodeRegion;
+		MappedCodeRegion = nullptr;
+	}
+
+	if (MappedFileHandle)
+	{
+		delete MappedFileHandle;
+		MappedFileHandle = nullptr;
+	}
 }
 
 IMemoryReadStreamRef FShaderCodeArchive::ReadShaderCode(int32 ShaderIndex)
@@ -261,6 +365,12 @@ IMemoryReadStreamRef FShaderCodeArchive::ReadShaderCode(int32 ShaderIndex)
 
 FGraphEventRef FShaderCodeArchive::PreloadShader(int32 ShaderIndex)
 {
+	if (MappedCodeRegion)
+	{
+		// Mapped code is paged in when the shader is created
+		return FGraphEventRef();
+	}
+
 	const FShaderCodeEntry& ShaderEntry = SerializedShaders.ShaderEntries[ShaderIndex];
 #if TRACK_SHADER_PRELOADS
 	ShaderFramePreloaded[ShaderIndex] = FMath::Min(ShaderFramePreloaded[ShaderIndex], GFrameNumber);
@@ -272,6 +382,11 @@ FGraphEventRef FShaderCodeArchive::PreloadShader(int32 ShaderIndex)
 
 FGraphEventRef FShaderCodeArchive::PreloadShaderMap(int32 ShaderMapIndex)
 {
+	if (MappedCodeRegion)
+	{
+		return FGraphEventRef();
+	}
+
 	const FShaderMapEntry& ShaderMapEntry = SerializedShaders.ShaderMapEntries[ShaderMapIndex];
 #if TRACK_SHADER_PRELOADS
 	const uint32 FrameNumber = GFrameNumber;
@@ -287,6 +402,11 @@ FGraphEventRef FShaderCodeArchive::PreloadShaderMap(int32 ShaderMapIndex)
 
 void FShaderCodeArchive::ReleasePreloadedShaderMap(int32 ShaderMapIndex)
 {
+	if (MappedCodeRegion)
+	{
+		return;
+	}
+
 	const FShaderMapEntry& ShaderMapEntry = SerializedShaders.ShaderMapEntries[ShaderMapIndex];
 #if TRACK_SHADER_PRELOADS
 	for (uint32 i = 0u; i < ShaderMapEntry.NumShaders; ++i)
@@ -298,39 +418,86 @@ void FShaderCodeArchive::ReleasePreloadedShaderMap(int32 ShaderMapIndex)
 	FileCacheHandle->ReleasePreloadedData(&SerializedShaders.PreloadEntries[ShaderMapEntry.FirstPreloadIndex], ShaderMapEntry.NumPreloadEntries, LibraryCodeOffset);
 }
 
-TRefCountPtr<FRHIShader> FShaderCodeArchive::CreateShader(int32 Index)
+const uint8* FShaderCodeArchive::ReadUncompressedShaderCode(int32 Index, FMemStackBase& MemStack, IMemoryReadStreamRef& OutCodeStream)
 {
-	TRefCountPtr<FRHIShader> Shader;
+	const FShaderCodeEntry& ShaderEntry = SerializedShaders.ShaderEntries[Index];
+	const uint8* ShaderCode = nullptr;
 
-	IMemoryReadStreamRef Code = ReadShaderCode(Index);
-	if (Code)
+	if (MappedCodeRegion)
 	{
-		FMemStackBase& MemStack = FMemStack::Get();
-		const FShaderCodeEntry& ShaderEntry = SerializedShaders.ShaderEntries[Index];
-		check(ShaderEntry.Size == Code->GetSize());
-		const uint8* ShaderCode = nullptr;
+		check(int64(ShaderEntry.Offset + ShaderEntry.Size) <= MappedCodeRegion->GetMappedSize());
+		const uint8* MappedCode = MappedCodeRegion->GetMappedPtr() + ShaderEntry.Offset;
+		if (ShaderEntry.UncompressedSize != ShaderEntry.Size)
+		{
+			void* UncompressedCode = MemStack.Alloc(ShaderEntry.UncompressedSize, 16);
+			const bool bDecompressResult = FCompression::UncompressMemory(ShaderLibraryCompressionFormat, UncompressedCode, ShaderEntry.UncompressedSize, MappedCode, ShaderEntry.Size);
+			check(bDecompressResult);
+			ShaderCode = (uint8*)UncompressedCode;
+		}
+		else
+		{
+			ShaderCode = MappedCode;
+		}
+		return ShaderCode;
+	}
+
+	OutCodeStream = ReadShaderCode(Index);
+	if (OutCodeStream)
+	{
+		check(ShaderEntry.Size == OutCodeStream->GetSize());
 
-		FMemMark Mark(MemStack);
 		if (ShaderEntry.UncompressedSize != ShaderEntry.Size)
 		{
 			void* UncompressedCode = MemStack.Alloc(ShaderEntry.UncompressedSize, 16);
-			const bool bDecompressResult = FCompression::UncompressMemoryStream(ShaderLibraryCompressionFormat, UncompressedCode, ShaderEntry.UncompressedSize, Code, 0, ShaderEntry.Size);
+			const bool bDecompressResult = FCompression::UncompressMemoryStream(ShaderLibraryCompressionFormat, UncompressedCode, ShaderEntry.UncompressedSize, OutCodeStream, 0, ShaderEntry.Size);
 			check(bDecompressResult);
 			ShaderCode = (uint8*)UncompressedCode;
 		}
 		else
 		{
 			int64 ReadSize = 0;
-			ShaderCode = (uint8*)Code->Read(ReadSize, 0, ShaderEntry.UncompressedSize);
+			ShaderCode = (uint8*)OutCodeStream->Read(ReadSize, 0, ShaderEntry.UncompressedSize);
 			if (ReadSize != ShaderEntry.UncompressedSize)
 			{
 				// Unable to read contiguous block of code, need to copy to temp buffer
 				void* UncompressedCode = MemStack.Alloc(ShaderEntry.UncompressedSize, 16);
-				Code->CopyTo(UncompressedCode, 0, ShaderEntry.UncompressedSize);
+				OutCodeStream->CopyTo(UncompressedCode, 0, ShaderEntry.UncompressedSize);
 				ShaderCode = (uint8*)UncompressedCode;
 			}
 		}
+	}
+	return ShaderCode;
+}
+
+bool FShaderCodeArchive::GetShaderCode(int32 Index, TArray<uint8>& OutCode)
+{
+	FMemStackBase& MemStack = FMemStack::Get();
+	FMemMark Mark(MemStack);
 
+	IMemoryReadStreamRef CodeStream;
+	const uint8* ShaderCode = ReadUncompressedShaderCode(Index, MemStack, CodeStream);
+	if (!ShaderCode)
+	{
+		return false;
+	}
+
+	OutCode.Reset();
+	OutCode.Append(ShaderCode, SerializedShaders.ShaderEntries[Index].UncompressedSize);
+	return true;
+}
+
+TRefCountPtr<FRHIShader> FShaderCodeArchive::CreateShader(int32 Index)
+{
+	TRefCountPtr<FRHIShader> Shader;
+
+	FMemStackBase& MemStack = FMemStack::Get();
+	FMemMark Mark(MemStack);
+
+	IMemoryReadStreamRef CodeStream;
+	const uint8* ShaderCode = ReadUncompressedShaderCode(Index, MemStack, CodeStream);
+	if (ShaderCode)
+	{
+		const FShaderCodeEntry& ShaderEntry = SerializedShaders.ShaderEntries[Index];
 		const auto ShaderCodeView = MakeArrayView(ShaderCode, ShaderEntry.UncompressedSize);
 		const FSHAHash& ShaderHash = SerializedShaders.ShaderHashes[Index];
 		switch (ShaderEntry.Frequency)
@@ -948,6 +948,7 @@ struct FEditorShaderCodeArchive
 			{
 				// Read shader library
 				*PrevCookedAr << SerializedShaders;
+				const int64 CodeOffset = PrevCookedAr->Tell();
 
 				ShaderCode.AddDefaulted(SerializedShaders.ShaderEntries.Num());
 				for(int32 Index = 0; Index < ShaderCode.Num(); ++Index)
@@ -955,6 +956,8 @@ struct FEditorShaderCodeArchive
 					const FShaderCodeEntry& Entry = SerializedShaders.ShaderEntries[Index];
 					TArray<uint8>& Code = ShaderCode[Index];
 					Code.SetNumUninitialized(Entry.Size);
+					// Shaders may share their code, it isn't stored in shader order
+					PrevCookedAr->Seek(CodeOffset + Entry.Offset);
 					PrevCookedAr->Serialize(Code.GetData(), Entry.Size);
 					bOK = !PrevCookedAr->GetError();
 					if (!bOK)
@@ -1102,15 +1105,33 @@ struct FEditorShaderCodeArchive
 			{
 				check(Format);
 
-				SerializedShaders.Finalize();
+				// Shaders with identical code share it in the archive
+				TArray<int32> CodeIndices;
+				SerializedShaders.Finalize(ShaderCode, CodeIndices);
+
+				if (CodeIndices.Num() < ShaderCode.Num())
+				{
+					int64 SharedCodeSize = 0;
+					for (const TArray<uint8>& Code : ShaderCode)
+					{
+						SharedCodeSize += Code.Num();
+					}
+					for (int32 CodeIndex : CodeIndices)
+					{
+						SharedCodeSize -= ShaderCode[CodeIndex].Num();
+					}
+
+					UE_LOG(LogShaderLibrary, Display, TEXT("%d of %d shaders in %s share their code with another shader, saving %.1f KB"),
+						ShaderCode.Num() - CodeIndices.Num(), ShaderCode.Num(), *LibraryName, SharedCodeSize / 1024.0f);
+				}
 
 				*FileWriter << GShaderCodeArchiveVersion;
 
                 // Write shader library
                 *FileWriter << SerializedShaders;
-                for (auto& Code : ShaderCode)
+                for (int32 CodeIndex : CodeIndices)
                 {
-                    FileWriter->Serialize(Code.GetData(), Code.Num());
+                    FileWriter->Serialize(ShaderCode[CodeIndex].GetData(), ShaderCode[CodeIndex].Num());
                 }
 
 				FileWriter->Close();
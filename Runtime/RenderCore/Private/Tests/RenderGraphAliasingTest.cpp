@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "RenderGraphAliasing.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRDGTransientAliasingPlannerTest, "System.Renderer.RenderGraph.TransientAliasing", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FRDGTransientAliasingPlannerTest::RunTest(const FString& Parameters)
+{
+	const uint64 MB = 1024 * 1024;
+
+	// A post processing chain where each pass reads the output of the previous one only needs two targets
+	{
+		FRDGTransientAliasingPlanner Planner(64 * MB);
+		for (int32 PassIndex = 0; PassIndex < 16; ++PassIndex)
+		{
+			Planner.AddResource(8 * MB, FRDGTransientAliasingPlanner::DefaultAlignment, PassIndex, PassIndex + 1);
+		}
+		Planner.Plan();
+
+		TestTrue(TEXT("Chain plan is valid"), Planner.Validate());
+		TestEqual(TEXT("Chain memory without aliasing"), Planner.GetMemoryWithoutAliasing(), 128 * MB);
+		TestEqual(TEXT("Chain peak live memory"), Planner.GetPeakLiveMemory(), 16 * MB);
+		TestEqual(TEXT("Chain aliased memory"), Planner.GetMemoryWithAliasing(), 16 * MB);
+		TestEqual(TEXT("Chain heaps"), Planner.GetNumHeaps(), 1);
+	}
+
+	// Resources alive at the same time never share memory, and resources larger than a heap get their own
+	{
+		FRDGTransientAliasingPlanner Planner(16 * MB);
+		const int32 Large = Planner.AddResource(40 * MB, FRDGTransientAliasingPlanner::DefaultAlignment, 0, 3);
+		const int32 Overlapping = Planner.AddResource(12 * MB, FRDGTransientAliasingPlanner::DefaultAlignment, 2, 5);
+		const int32 Disjoint = Planner.AddResource(12 * MB, FRDGTransientAliasingPlanner::DefaultAlignment, 4, 6);
+		const int32 Small = Planner.AddResource(100, FRDGTransientAliasingPlanner::DefaultAlignment, 1, 1);
+		Planner.Plan();
+
+		TestTrue(TEXT("Mixed plan is valid"), Planner.Validate());
+		TestEqual(TEXT("Large resource has a dedicated heap"), Planner.GetAllocation(Large).Offset, uint64(0));
+		TestEqual(TEXT("Disjoint resource aliases the large one"), Planner.GetAllocation(Disjoint).HeapIndex, Planner.GetAllocation(Large).HeapIndex);
+		TestNotEqual(TEXT("Overlapping resource does not alias the large one"), Planner.GetAllocation(Overlapping).HeapIndex, Planner.GetAllocation(Large).HeapIndex);
+		TestEqual(TEXT("Small resource is aligned"), Planner.GetAllocation(Small).Offset % FRDGTransientAliasingPlanner::DefaultAlignment, uint64(0));
+		TestTrue(TEXT("Aliasing saves memory"), Planner.GetMemoryWithAliasing() < Planner.GetMemoryWithoutAliasing());
+		TestTrue(TEXT("Aliasing can't beat the live memory"), Planner.GetMemoryWithAliasing() >= Planner.GetPeakLiveMemory());
+	}
+
+	// Random lifetimes always produce a valid plan
+	{
+		FRandomStream RandomStream(0x7A11A5);
+		FRDGTransientAliasingPlanner Planner(32 * MB);
+		for (int32 ResourceIndex = 0; ResourceIndex < 200; ++ResourceIndex)
+		{
+			const int32 FirstPass = RandomStream.RandRange(0, 99);
+			const int32 LastPass = FirstPass + RandomStream.RandRange(0, 20);
+			const uint64 Alignment = RandomStream.FRand() < 0.1f ? FRDGTransientAliasingPlanner::MultisampleAlignment : FRDGTransientAliasingPlanner::DefaultAlignment;
+			Planner.AddResource(uint64(RandomStream.RandRange(1, 48 * 1024)) * 1024, Alignment, FirstPass, LastPass);
+		}
+		Planner.Plan();
+
+		TestTrue(TEXT("Random plan is valid"), Planner.Validate());
+		TestTrue(TEXT("Random aliased memory is bounded"), Planner.GetMemoryWithAliasing() <= Planner.GetMemoryWithoutAliasing() + Planner.GetNumResources() * FRDGTransientAliasingPlanner::MultisampleAlignment);
+	}
+
+	// Texture size estimates
+	{
+		const FRDGTextureDesc Desc = FPooledRenderTargetDesc::Create2DDesc(FIntPoint(1920, 1080), PF_FloatRGBA, FClearValueBinding::None, TexCreate_None, TexCreate_RenderTargetable, false);
+		TestEqual(TEXT("2D texture size"), FRDGTransientAliasingPlanner::EstimateTextureSize(Desc), uint64(1920 * 1080 * 8));
+
+		const FRDGTextureDesc MipsDesc = FPooledRenderTargetDesc::Create2DDesc(FIntPoint(4, 4), PF_R8G8B8A8, FClearValueBinding::None, TexCreate_None, TexCreate_RenderTargetable, false, 3);
+		TestEqual(TEXT("Mip chain size"), FRDGTransientAliasingPlanner::EstimateTextureSize(MipsDesc), uint64((16 + 4 + 1) * 4));
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
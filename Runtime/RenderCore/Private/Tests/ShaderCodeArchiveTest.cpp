@@ -0,0 +1,185 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "ShaderCodeArchive.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShaderCodeArchiveTest, "System.Renderer.ShaderCodeArchive", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool FShaderCodeArchiveTest::RunTest(const FString& Parameters)
+{
+	auto MakeHash = [](uint32 Seed)
+	{
+		FSHAHash Hash;
+		FSHA1::HashBuffer(&Seed, sizeof(Seed), Hash.Hash);
+		return Hash;
+	};
+
+	auto MakeCode = [](uint32 Seed, int32 Size, bool bCompressible)
+	{
+		FRandomStream RandomStream(Seed);
+		TArray<uint8> Code;
+		Code.SetNumUninitialized(Size);
+		for (int32 Index = 0; Index < Size; ++Index)
+		{
+			Code[Index] = bCompressible ? uint8(Index / 64) : uint8(RandomStream.RandRange(0, 255));
+		}
+		return Code;
+	};
+
+	FSerializedShaderArchive SerializedShaders;
+	SerializedShaders.ShaderHashTable.Initialize(0x100);
+	SerializedShaders.ShaderMapHashTable.Initialize(0x100);
+
+	TArray<TArray<uint8>> UncompressedCode;
+	TArray<TArray<uint8>> ShaderCode;
+
+	auto AddShader = [&](uint32 HashSeed, const TArray<uint8>& Code)
+	{
+		int32 ShaderIndex = INDEX_NONE;
+		verify(SerializedShaders.FindOrAddShader(MakeHash(HashSeed), ShaderIndex));
+
+		TArray<uint8>& StoredCode = ShaderCode.AddDefaulted_GetRef();
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_LZ4, Code.Num());
+		StoredCode.SetNumUninitialized(CompressedSize);
+		if (FCompression::CompressMemory(NAME_LZ4, StoredCode.GetData(), CompressedSize, Code.GetData(), Code.Num()) && CompressedSize < Code.Num())
+		{
+			StoredCode.SetNum(CompressedSize);
+		}
+		else
+		{
+			StoredCode = Code;
+		}
+		UncompressedCode.Add(Code);
+
+		FShaderCodeEntry& Entry = SerializedShaders.ShaderEntries[ShaderIndex];
+		Entry.Frequency = SF_Pixel;
+		Entry.Size = StoredCode.Num();
+		Entry.UncompressedSize = Code.Num();
+		return ShaderIndex;
+	};
+
+	auto AddShaderMap = [&](uint32 HashSeed, const TArray<int32>& ShaderIndices)
+	{
+		int32 ShaderMapIndex = INDEX_NONE;
+		verify(SerializedShaders.FindOrAddShaderMap(MakeHash(HashSeed), ShaderMapIndex));
+
+		FShaderMapEntry& ShaderMapEntry = SerializedShaders.ShaderMapEntries[ShaderMapIndex];
+		ShaderMapEntry.NumShaders = ShaderIndices.Num();
+		ShaderMapEntry.ShaderIndicesOffset = SerializedShaders.ShaderIndices.Num();
+		for (int32 ShaderIndex : ShaderIndices)
+		{
+			SerializedShaders.ShaderIndices.Add(ShaderIndex);
+		}
+	};
+
+	// Two shader maps whose permutations partly compile to the same code
+	const TArray<uint8> CodeA = MakeCode(1, 4096, true);
+	const TArray<uint8> CodeB = MakeCode(2, 3000, false);
+	const TArray<uint8> CodeC = MakeCode(3, 2048, true);
+	const TArray<uint8> CodeD = MakeCode(4, 500, false);
+
+	const int32 ShaderA = AddShader(100, CodeA);
+	const int32 ShaderB = AddShader(101, CodeB);
+	const int32 ShaderC = AddShader(102, CodeC);
+	const int32 ShaderA2 = AddShader(103, CodeA);
+	const int32 ShaderB2 = AddShader(104, CodeB);
+	const int32 ShaderD = AddShader(105, CodeD);
+
+	AddShaderMap(200, { ShaderA, ShaderB, ShaderC });
+	AddShaderMap(201, { ShaderA2, ShaderB2, ShaderD, ShaderA });
+
+	TArray<int32> CodeIndices;
+	SerializedShaders.Finalize(ShaderCode, CodeIndices);
+
+	TestEqual(TEXT("Unique code blobs"), CodeIndices.Num(), 4);
+	TestEqual(TEXT("Identical compressed code is shared"), SerializedShaders.ShaderEntries[ShaderA2].Offset, SerializedShaders.ShaderEntries[ShaderA].Offset);
+	TestEqual(TEXT("Identical uncompressed code is shared"), SerializedShaders.ShaderEntries[ShaderB2].Offset, SerializedShaders.ShaderEntries[ShaderB].Offset);
+	TestNotEqual(TEXT("Different code isn't shared"), SerializedShaders.ShaderEntries[ShaderD].Offset, SerializedShaders.ShaderEntries[ShaderC].Offset);
+	TestEqual(TEXT("Contiguous shared code has a single preload entry"), SerializedShaders.ShaderMapEntries[1].NumPreloadEntries, 1u);
+
+	int64 UniqueCodeSize = 0;
+	for (int32 CodeIndex : CodeIndices)
+	{
+		UniqueCodeSize += ShaderCode[CodeIndex].Num();
+	}
+
+	const FString LibraryDir = FPaths::ProjectSavedDir() / TEXT("Automation");
+	const FString LibraryPath = FPaths::CreateTempFilename(*LibraryDir, TEXT("ShaderCodeArchiveTest"), TEXT(".ushaderbytecode"));
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*LibraryPath));
+		if (!Writer)
+		{
+			AddError(FString::Printf(TEXT("Unable to write %s"), *LibraryPath));
+			return false;
+		}
+
+		uint32 Version = 0;
+		*Writer << Version;
+		*Writer << SerializedShaders;
+		for (int32 CodeIndex : CodeIndices)
+		{
+			Writer->Serialize(ShaderCode[CodeIndex].GetData(), ShaderCode[CodeIndex].Num());
+		}
+	}
+
+	IConsoleVariable* MemoryMappedCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("r.ShaderCodeLibrary.MemoryMapped"));
+	const int32 PreviousMemoryMapped = MemoryMappedCVar->GetInt();
+
+	// Query the archive through the file cache, then memory mapped
+	for (int32 MemoryMapped = 0; MemoryMapped < 2; ++MemoryMapped)
+	{
+		MemoryMappedCVar->Set(MemoryMapped, ECVF_SetByCode);
+
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*LibraryPath));
+		uint32 Version = 0;
+		*Reader << Version;
+
+		FRHIShaderLibraryRef LibraryRef = FShaderCodeArchive::Create(SP_PCD3D_SM5, *Reader, LibraryPath, LibraryDir, TEXT("ShaderCodeArchiveTest"));
+		Reader.Reset();
+
+		FShaderCodeArchive* Library = static_cast<FShaderCodeArchive*>(LibraryRef.GetReference());
+		TestEqual(TEXT("Shader maps"), Library->GetNumShaderMaps(), 2);
+		TestEqual(TEXT("Shaders"), Library->GetNumShaders(), 6);
+		TestEqual(TEXT("Shader map lookup"), Library->FindShaderMapIndex(MakeHash(201)), 1);
+		TestEqual(TEXT("Shader lookup"), Library->FindShaderIndex(MakeHash(104)), ShaderB2);
+		TestEqual(TEXT("Missing shader lookup"), Library->FindShaderIndex(MakeHash(999)), INDEX_NONE);
+		TestEqual(TEXT("Shader map shaders"), Library->GetShaderIndex(1, 3), ShaderA);
+
+		for (int32 ShaderIndex = 0; ShaderIndex < UncompressedCode.Num(); ++ShaderIndex)
+		{
+			TArray<uint8> Code;
+			TestTrue(TEXT("Shader code is read"), Library->GetShaderCode(ShaderIndex, Code));
+			TestTrue(FString::Printf(TEXT("Shader %d code matches"), ShaderIndex), Code == UncompressedCode[ShaderIndex]);
+		}
+
+		if (MemoryMapped == 0)
+		{
+			TestEqual(TEXT("File cache maps nothing"), Library->GetMappedSizeBytes(), int64(0));
+		}
+		else if (Library->GetMappedSizeBytes() > 0)
+		{
+			TestEqual(TEXT("Mapped bytes are the unique code"), Library->GetMappedSizeBytes(), UniqueCodeSize);
+		}
+		else
+		{
+			AddInfo(TEXT("Memory mapped files aren't supported, the archive used the file cache."));
+		}
+
+		// Closes the file before it is deleted
+		Library->Teardown();
+	}
+
+	MemoryMappedCVar->Set(PreviousMemoryMapped, ECVF_SetByCode);
+	IFileManager::Get().Delete(*LibraryPath);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -227,6 +227,9 @@ private:
 	void ClobberPassOutputs(const FRDGPass* Pass);
 
 	void WalkGraphDependencies();
+
+	/** Plans the aliasing of the transient resources from their pass lifetimes and reports the transient memory, see r.RDG.TransientAliasing. */
+	void PlanTransientResourceAliasing();
 	
 	template<class Type, class ...ConstructorParameterTypes>
 	Type* AllocateForRHILifeTime(ConstructorParameterTypes&&... ConstructorParameters);
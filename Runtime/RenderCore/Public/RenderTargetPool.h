@@ -22,6 +22,7 @@ struct RENDERCORE_API FPooledRenderTarget : public IPooledRenderTarget
 		, bSnapshot(false)
 		, RenderTargetPool(InRenderTargetPool)
 		, FrameNumberLastDiscard(-1)
+		, LastUseTime(0)
 	{
 	}
 	/* Constructor that makes a snapshot */
@@ -32,6 +33,7 @@ struct RENDERCORE_API FPooledRenderTarget : public IPooledRenderTarget
 		, bSnapshot(true)
 		, RenderTargetPool(SnaphotSource.RenderTargetPool)
 		, FrameNumberLastDiscard(-1)
+		, LastUseTime(0)
 	{
 		check(IsInRenderingThread());
 		RenderTargetItem = SnaphotSource.RenderTargetItem;
@@ -97,6 +99,9 @@ private:
 	/** Keeps track of the last frame we unmapped physical memory for this resource. We can't map again in the same frame if we did that */
 	uint32 FrameNumberLastDiscard;
 
+	/** Value of the pool use counter when the element was last handed out or returned to the pool, orders the free elements for eviction. */
+	uint64 LastUseTime;
+
 	/** @return true:release this one, false otherwise */
 	bool OnFrameStart();
 
@@ -286,13 +291,36 @@ private:
 
 	bool DoesTargetNeedTransienceOverride(const FPooledRenderTargetDesc& InputDesc, ERenderTargetTransience TransienceHint) const;
 
+	/** @return hash of the descriptor fields FPooledRenderTargetDesc::Compare() matches on, ignoring TexCreate_FastVRAM so that both search passes use the same bucket */
+	static uint32 GetDescBucketHash(const FPooledRenderTargetDesc& Desc);
+
+	void AddToDescBucket(FPooledRenderTarget* Element);
+	void RemoveFromDescBucket(FPooledRenderTarget* Element);
+
+	/** Removes the element at the given index from the pool, it gets released once it is not referenced anymore. */
+	void RemoveElement(int32 Index, bool bDeferDelete);
+
+	/** Releases the least recently used free elements until the pool fits in the given budget. */
+	void EvictLeastRecentlyUsed(uint32 BudgetInKB);
+
 	friend void RenderTargetPoolEvents(const TArray<FString>& Args);
+	friend void RenderTargetPoolBenchmark(const TArray<FString>& Args, class UWorld* World, FOutputDevice& Ar);
 
 	/** Elements can be 0, we compact the buffer later. */
 	TArray< TRefCountPtr<FPooledRenderTarget> > PooledRenderTargets;
 	TArray< TRefCountPtr<FPooledRenderTarget> > DeferredDeleteArray;
 	TArray< FRHITexture* > TransitionTargets;
 
+	/** Pooled elements grouped by GetDescBucketHash(), so FindFreeElement() only looks at the elements with a compatible descriptor. */
+	TMap<uint32, TArray<FPooledRenderTarget*, TInlineAllocator<4>>> DescBuckets;
+
+	/** Incremented when an element is handed out or returned to the pool. */
+	uint64 UseCounter;
+
+	/** FindFreeElement() calls and the ones served by an existing element, since the last TickPoolElements(). */
+	uint32 NumFindRequests;
+	uint32 NumFindHits;
+
 	/** These are snapshots, have odd life times, live in the scene allocator, and don't contribute to any accounting or other management. */
 	TArray<FPooledRenderTarget*> PooledRenderTargetSnapshots;
 
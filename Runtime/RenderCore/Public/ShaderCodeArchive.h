@@ -6,6 +6,7 @@
 #include "RHI.h"
 #include "FileCache/FileCache.h"
 #include "Containers/HashTable.h"
+#include "Async/MappedFileHandle.h"
 
 struct FShaderMapEntry
 {
@@ -101,6 +102,14 @@ public:
 	void DecompressShader(int32 Index, const TArray<TArray<uint8>>& ShaderCode, TArray<uint8>& OutDecompressedShader) const;
 
 	void Finalize();
+
+	/**
+	 * Same as Finalize, except that shaders with identical code, such as permutations compiling to the same bytecode, share a single code range.
+	 * @param ShaderCode - code of each shader entry
+	 * @param OutCodeIndices - indices of the shaders whose code must be written after the archive, in offset order
+	 */
+	void Finalize(const TArray<TArray<uint8>>& ShaderCode, TArray<int32>& OutCodeIndices);
+
 	void Serialize(FArchive& Ar);
 
 	friend FArchive& operator<<(FArchive& Ar, FSerializedShaderArchive& Ref)
@@ -108,6 +117,9 @@ public:
 		Ref.Serialize(Ar);
 		return Ar;
 	}
+
+private:
+	void BuildPreloadEntries();
 };
 
 #define TRACK_SHADER_PRELOADS STATS
@@ -121,12 +133,22 @@ public:
 
 	virtual bool IsNativeLibrary() const override { return false; }
 
+	/** @return bytes of the library resident in memory, the shader code is read through the file cache or mapped on demand and isn't included */
 	uint32 GetSizeBytes() const
 	{
 		return sizeof(*this) +
 			SerializedShaders.GetAllocatedSize();
 	}
 
+	/** @return bytes of shader code mapped from the library file, 0 if the code is read through the file cache */
+	int64 GetMappedSizeBytes() const
+	{
+		return MappedCodeRegion ? MappedCodeRegion->GetMappedSize() : 0;
+	}
+
+	/** Reads and decompresses the code of a shader, without creating the RHI shader. */
+	bool GetShaderCode(int32 Index, TArray<uint8>& OutCode);
+
 	virtual int32 GetNumShaders() const override { return SerializedShaders.ShaderEntries.Num(); }
 	virtual int32 GetNumShaderMaps() const override { return SerializedShaders.ShaderMapEntries.Num(); }
 	virtual int32 GetNumShadersForShaderMap(int32 ShaderMapIndex) const override { return SerializedShaders.ShaderMapEntries[ShaderMapIndex].NumShaders; }
@@ -161,6 +183,12 @@ protected:
 
 	IMemoryReadStreamRef ReadShaderCode(int32 Index);
 
+	/**
+	 * Returns the uncompressed code of a shader, decompressed in MemStack if needed. Mapped uncompressed code is used in place.
+	 * @param OutCodeStream - keeps the code read through the file cache alive, the returned code may point into it
+	 */
+	const uint8* ReadUncompressedShaderCode(int32 Index, FMemStackBase& MemStack, IMemoryReadStreamRef& OutCodeStream);
+
 	FORCENOINLINE void CheckShaderCreation(void* ShaderPtr, int32 Index)
 	{
 	}
@@ -174,6 +202,10 @@ protected:
 	// Library file handle for async reads
 	IFileCacheHandle* FileCacheHandle;
 
+	// Library file and shader code mapping, used instead of the file cache when r.ShaderCodeLibrary.MemoryMapped is enabled and the platform can map the file
+	IMappedFileHandle* MappedFileHandle;
+	IMappedFileRegion* MappedCodeRegion;
+
 	// The shader code present in the library
 	FSerializedShaderArchive SerializedShaders;
 
@@ -1260,7 +1260,7 @@ static TAutoConsoleVariable<float> CVarStallInitViews(
 
 void FDeferredShadingSceneRenderer::Render(FRHICommandListImmediate& RHICmdList)
 {
-	Scene->UpdateAllPrimitiveSceneInfos(RHICmdList, true);
+	Scene->UpdateAllPrimitiveSceneInfosWithBudget(RHICmdList, true);
 
 	check(RHICmdList.IsOutsideRenderPass());
 
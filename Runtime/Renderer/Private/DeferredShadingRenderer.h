@@ -150,15 +150,6 @@ private:
 	static TGlobalResource<FGlobalDynamicReadBuffer> DynamicReadBufferForInitViews;
 	static TGlobalResource<FGlobalDynamicReadBuffer> DynamicReadBufferForInitShadows;
 
-	/** Creates a per object projected shadow for the given interaction. */
-	void CreatePerObjectProjectedShadow(
-		FRHICommandListImmediate& RHICmdList,
-		FLightPrimitiveInteraction* Interaction,
-		bool bCreateTranslucentObjectShadow,
-		bool bCreateInsetObjectShadow,
-		const TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& ViewDependentWholeSceneShadows,
-		TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& OutPreShadows);
-
 	/**
 	* Used by RenderLights to figure out if light functions need to be rendered to the attenuation buffer.
 	*
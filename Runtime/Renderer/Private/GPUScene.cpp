@@ -14,6 +14,7 @@
 #include "SceneFilterRendering.h"
 #include "ClearQuad.h"
 #include "RendererModule.h"
+#include "Async/ParallelFor.h"
 
 int32 GGPUSceneUploadEveryFrame = 0;
 FAutoConsoleVariableRef CVarGPUSceneUploadEveryFrame(
@@ -39,6 +40,43 @@ FAutoConsoleVariableRef CVarGGPUSceneMaxPooledUploadBufferSize(
 	ECVF_RenderThreadSafe
 	);
 
+int32 GGPUSceneUploadTransformsOnly = 1;
+FAutoConsoleVariableRef CVarGPUSceneUploadTransformsOnly(
+	TEXT("r.GPUScene.UploadTransformsOnly"),
+	GGPUSceneUploadTransformsOnly,
+	TEXT("Whether primitives whose transform is the only change since the last upload only upload their transform and bounds, skipping the custom primitive data and the lightmap data."),
+	ECVF_RenderThreadSafe
+	);
+
+int32 GGPUSceneParallelUpload = 1;
+FAutoConsoleVariableRef CVarGPUSceneParallelUpload(
+	TEXT("r.GPUScene.ParallelUpload"),
+	GGPUSceneParallelUpload,
+	TEXT("Whether the primitive data uploaded to GPU Scene is built in parallel tasks."),
+	ECVF_RenderThreadSafe
+	);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("GPUScene primitive uploads"), STAT_GPUScenePrimitiveUploads, STATGROUP_SceneRendering);
+DECLARE_DWORD_COUNTER_STAT(TEXT("GPUScene transform only uploads"), STAT_GPUSceneTransformUploads, STATGROUP_SceneRendering);
+DECLARE_DWORD_COUNTER_STAT(TEXT("GPUScene primitive bytes uploaded"), STAT_GPUScenePrimitiveBytesUploaded, STATGROUP_SceneRendering);
+DECLARE_DWORD_COUNTER_STAT(TEXT("GPUScene lightmap bytes uploaded"), STAT_GPUSceneLightmapBytesUploaded, STATGROUP_SceneRendering);
+
+CSV_DEFINE_CATEGORY(GPUScene, true);
+
+/**
+ * Transform only uploads write the primitive data in chunks of 7 float4s, the primitive data stride is a multiple of it.
+ * The first chunks cover everything up to the custom primitive data.
+ */
+static const uint32 GPUSceneTransformChunkFloat4s = 7;
+static const uint32 GPUSceneTransformChunksPerPrimitive = 4;
+static const uint32 GPUSceneChunksPerPrimitive = FPrimitiveSceneShaderData::PrimitiveDataStrideInFloat4s / GPUSceneTransformChunkFloat4s;
+
+static_assert(FPrimitiveSceneShaderData::PrimitiveDataStrideInFloat4s % GPUSceneTransformChunkFloat4s == 0, "Primitive data stride must be a multiple of the transform chunk size.");
+static_assert(GPUSceneTransformChunksPerPrimitive * GPUSceneTransformChunkFloat4s >= FPrimitiveSceneShaderData::PrimitiveDataStrideInFloat4s - FCustomPrimitiveData::NumCustomPrimitiveDataFloat4s, "Transform chunks must cover all primitive data but the custom primitive data.");
+
+/** Number of primitives whose upload data is built by a single task. */
+static const int32 GPUSceneUploadBatchSize = 64;
+
 // Allocate a range.  Returns allocated StartOffset.
 int32 FGrowOnlySpanAllocator::Allocate(int32 Num)
 {
@@ -239,13 +277,19 @@ void UpdateGPUSceneInternal(FRHICommandListImmediate& RHICmdList, FScene& Scene)
 		{
 			for (int32 Index : Scene.GPUScene.PrimitivesToUpdate)
 			{
-				Scene.GPUScene.PrimitivesMarkedToUpdate[Index] = false;
+				Scene.GPUScene.PrimitiveDirtyState[Index] = EPrimitiveDirtyState::None;
 			}
 			Scene.GPUScene.PrimitivesToUpdate.Reset();
 
+			if (Scene.Primitives.Num() > Scene.GPUScene.PrimitiveDirtyState.Num())
+			{
+				Scene.GPUScene.PrimitiveDirtyState.AddZeroed(Align(Scene.Primitives.Num(), 64) - Scene.GPUScene.PrimitiveDirtyState.Num());
+			}
+
 			for (int32 i = 0; i < Scene.Primitives.Num(); i++)
 			{
 				Scene.GPUScene.PrimitivesToUpdate.Add(i);
+				Scene.GPUScene.PrimitiveDirtyState[i] = EPrimitiveDirtyState::ChangedAll;
 			}
 
 			Scene.GPUScene.bUpdateAllPrimitives = false;
@@ -271,29 +315,101 @@ void UpdateGPUSceneInternal(FRHICommandListImmediate& RHICmdList, FScene& Scene)
 
 		if (NumPrimitiveDataUploads > 0)
 		{
+			struct FPrimitiveUpload
+			{
+				FPrimitiveSceneProxy* PrimitiveSceneProxy;
+				FVector4* Data;
+				uint32 NumFloat4s;
+			};
+			TArray<FPrimitiveUpload> PrimitiveUploads;
+
+			uint32 NumPrimitiveBytesUploaded = 0;
+
 			const int32 MaxPrimitivesUploads = GetMaxPrimitivesUpdate(NumPrimitiveDataUploads, FPrimitiveSceneShaderData::PrimitiveDataStrideInFloat4s);
 			for (int32 PrimitiveOffset = 0; PrimitiveOffset < NumPrimitiveDataUploads; PrimitiveOffset += MaxPrimitivesUploads)
 			{
 				SCOPED_DRAW_EVENTF(RHICmdList, UpdateGPUScene, TEXT("UpdateGPUScene PrimitivesToUpdate and Offset = %u %u"), NumPrimitiveDataUploads, PrimitiveOffset);
 
+				const int32 NumUploads = FMath::Min(MaxPrimitivesUploads, NumPrimitiveDataUploads - PrimitiveOffset);
 
-				Scene.GPUScene.PrimitiveUploadBuffer.Init(MaxPrimitivesUploads, sizeof(FPrimitiveSceneShaderData::Data), true, TEXT("PrimitiveUploadBuffer"));
+				int32 NumFullUploads = 0;
+				int32 NumTransformUploads = 0;
 
-				for (int32 IndexUpdate = 0; (IndexUpdate < MaxPrimitivesUploads) && ((IndexUpdate + PrimitiveOffset) < NumPrimitiveDataUploads); ++IndexUpdate)
+				for (int32 IndexUpdate = 0; IndexUpdate < NumUploads; ++IndexUpdate)
 				{
-					int32 Index = Scene.GPUScene.PrimitivesToUpdate[IndexUpdate + PrimitiveOffset];
+					const int32 Index = Scene.GPUScene.PrimitivesToUpdate[IndexUpdate + PrimitiveOffset];
 					// PrimitivesToUpdate may contain a stale out of bounds index, as we don't remove update request on primitive removal from scene.
 					if (Index < Scene.PrimitiveSceneProxies.Num())
 					{
-						FPrimitiveSceneProxy* RESTRICT PrimitiveSceneProxy = Scene.PrimitiveSceneProxies[Index];
-						NumLightmapDataUploads += PrimitiveSceneProxy->GetPrimitiveSceneInfo()->GetNumLightmapDataEntries();
+						if (GGPUSceneUploadTransformsOnly && Scene.GPUScene.PrimitiveDirtyState[Index] == EPrimitiveDirtyState::ChangedTransform)
+						{
+							++NumTransformUploads;
+						}
+						else
+						{
+							++NumFullUploads;
+						}
+					}
+				}
+
+				if (NumFullUploads > 0)
+				{
+					Scene.GPUScene.PrimitiveUploadBuffer.Init(NumFullUploads, sizeof(FPrimitiveSceneShaderData::Data), true, TEXT("PrimitiveUploadBuffer"));
+				}
+
+				if (NumTransformUploads > 0)
+				{
+					Scene.GPUScene.PrimitiveTransformUploadBuffer.Init(NumTransformUploads * GPUSceneTransformChunksPerPrimitive, GPUSceneTransformChunkFloat4s * sizeof(FVector4), true, TEXT("PrimitiveTransformUploadBuffer"));
+				}
+
+				// Scatter indices are written here, the primitive data is built afterwards straight into the locked upload buffers.
+				PrimitiveUploads.Reset(NumFullUploads + NumTransformUploads);
+
+				for (int32 IndexUpdate = 0; IndexUpdate < NumUploads; ++IndexUpdate)
+				{
+					const int32 Index = Scene.GPUScene.PrimitivesToUpdate[IndexUpdate + PrimitiveOffset];
+					if (Index < Scene.PrimitiveSceneProxies.Num())
+					{
+						FPrimitiveUpload& PrimitiveUpload = PrimitiveUploads.AddDefaulted_GetRef();
+						PrimitiveUpload.PrimitiveSceneProxy = Scene.PrimitiveSceneProxies[Index];
 
-						FPrimitiveSceneShaderData PrimitiveSceneData(PrimitiveSceneProxy);
-						Scene.GPUScene.PrimitiveUploadBuffer.Add(Index, &PrimitiveSceneData.Data[0]);
+						if (GGPUSceneUploadTransformsOnly && Scene.GPUScene.PrimitiveDirtyState[Index] == EPrimitiveDirtyState::ChangedTransform)
+						{
+							PrimitiveUpload.Data = (FVector4*)Scene.GPUScene.PrimitiveTransformUploadBuffer.Add_GetRef(Index * GPUSceneChunksPerPrimitive, GPUSceneTransformChunksPerPrimitive);
+							PrimitiveUpload.NumFloat4s = GPUSceneTransformChunksPerPrimitive * GPUSceneTransformChunkFloat4s;
+						}
+						else
+						{
+							PrimitiveUpload.Data = (FVector4*)Scene.GPUScene.PrimitiveUploadBuffer.Add_GetRef(Index);
+							PrimitiveUpload.NumFloat4s = FPrimitiveSceneShaderData::PrimitiveDataStrideInFloat4s;
+							NumLightmapDataUploads += PrimitiveUpload.PrimitiveSceneProxy->GetPrimitiveSceneInfo()->GetNumLightmapDataEntries();
+						}
 					}
-					Scene.GPUScene.PrimitivesMarkedToUpdate[Index] = false;
 				}
 
+				{
+					QUICK_SCOPE_CYCLE_COUNTER(STAT_UpdateGPUScene_BuildPrimitiveData);
+
+					const int32 NumBatches = FMath::DivideAndRoundUp(PrimitiveUploads.Num(), GPUSceneUploadBatchSize);
+					ParallelFor(NumBatches, [&PrimitiveUploads](int32 BatchIndex)
+					{
+						const int32 FirstUpload = BatchIndex * GPUSceneUploadBatchSize;
+						const int32 LastUpload = FMath::Min(FirstUpload + GPUSceneUploadBatchSize, PrimitiveUploads.Num());
+
+						for (int32 UploadIndex = FirstUpload; UploadIndex < LastUpload; ++UploadIndex)
+						{
+							const FPrimitiveUpload& PrimitiveUpload = PrimitiveUploads[UploadIndex];
+							FPrimitiveSceneShaderData PrimitiveSceneData(PrimitiveUpload.PrimitiveSceneProxy);
+							FMemory::Memcpy(PrimitiveUpload.Data, &PrimitiveSceneData.Data[0], PrimitiveUpload.NumFloat4s * sizeof(FVector4));
+						}
+					}, !GGPUSceneParallelUpload);
+				}
+
+				NumPrimitiveBytesUploaded += NumFullUploads * (sizeof(FPrimitiveSceneShaderData::Data) + sizeof(uint32));
+				NumPrimitiveBytesUploaded += NumTransformUploads * GPUSceneTransformChunksPerPrimitive * (GPUSceneTransformChunkFloat4s * sizeof(FVector4) + sizeof(uint32));
+				INC_DWORD_STAT_BY(STAT_GPUScenePrimitiveUploads, NumFullUploads + NumTransformUploads);
+				INC_DWORD_STAT_BY(STAT_GPUSceneTransformUploads, NumTransformUploads);
+
 				if (bResizedPrimitiveData)
 				{
 					RHICmdList.TransitionResource(EResourceTransitionAccess::ERWBarrier, EResourceTransitionPipeline::EComputeToCompute, MirrorResourceGPU->UAV);
@@ -303,12 +419,26 @@ void UpdateGPUSceneInternal(FRHICommandListImmediate& RHICmdList, FScene& Scene)
 					RHICmdList.TransitionResource(EResourceTransitionAccess::EWritable, EResourceTransitionPipeline::EGfxToCompute, MirrorResourceGPU->UAV);
 				}
 
+				if (NumFullUploads > 0)
 				{
-					Scene.GPUScene.PrimitiveUploadBuffer.ResourceUploadTo(RHICmdList, *MirrorResourceGPU, true);
+					Scene.GPUScene.PrimitiveUploadBuffer.ResourceUploadTo(RHICmdList, *MirrorResourceGPU, NumTransformUploads == 0);
+				}
+
+				if (NumTransformUploads > 0)
+				{
+					if (NumFullUploads > 0)
+					{
+						RHICmdList.TransitionResource(EResourceTransitionAccess::ERWNoBarrier, EResourceTransitionPipeline::EComputeToCompute, MirrorResourceGPU->UAV);
+					}
+
+					Scene.GPUScene.PrimitiveTransformUploadBuffer.ResourceUploadTo(RHICmdList, *MirrorResourceGPU, true);
 				}
 			}
 
 			RHICmdList.TransitionResource(EResourceTransitionAccess::EReadable, EResourceTransitionPipeline::EComputeToGfx, MirrorResourceGPU->UAV);
+
+			INC_DWORD_STAT_BY(STAT_GPUScenePrimitiveBytesUploaded, NumPrimitiveBytesUploaded);
+			CSV_CUSTOM_STAT(GPUScene, PrimitiveBytesUploaded, float(NumPrimitiveBytesUploaded), ECsvCustomStatOp::Accumulate);
 		}
 
 
@@ -347,7 +477,8 @@ void UpdateGPUSceneInternal(FRHICommandListImmediate& RHICmdList, FScene& Scene)
 				for (int32 Index : Scene.GPUScene.PrimitivesToUpdate)
 				{
 					// PrimitivesToUpdate may contain a stale out of bounds index, as we don't remove update request on primitive removal from scene.
-					if (Index < Scene.PrimitiveSceneProxies.Num())
+					// Lightmap data doesn't depend on the transform.
+					if (Index < Scene.PrimitiveSceneProxies.Num() && !(GGPUSceneUploadTransformsOnly && Scene.GPUScene.PrimitiveDirtyState[Index] == EPrimitiveDirtyState::ChangedTransform))
 					{
 						FPrimitiveSceneProxy* PrimitiveSceneProxy = Scene.PrimitiveSceneProxies[Index];
 
@@ -377,8 +508,16 @@ void UpdateGPUSceneInternal(FRHICommandListImmediate& RHICmdList, FScene& Scene)
 				Scene.GPUScene.LightmapUploadBuffer.ResourceUploadTo(RHICmdList, Scene.GPUScene.LightmapDataBuffer, false);
 
 				RHICmdList.TransitionResource(EResourceTransitionAccess::EReadable, EResourceTransitionPipeline::EComputeToGfx, Scene.GPUScene.LightmapDataBuffer.UAV);
+
+				const uint32 NumLightmapBytesUploaded = NumLightmapDataUploads * (sizeof(FLightmapSceneShaderData::Data) + sizeof(uint32));
+				INC_DWORD_STAT_BY(STAT_GPUSceneLightmapBytesUploaded, NumLightmapBytesUploaded);
+				CSV_CUSTOM_STAT(GPUScene, LightmapBytesUploaded, float(NumLightmapBytesUploaded), ECsvCustomStatOp::Accumulate);
 			}
 
+			for (int32 Index : Scene.GPUScene.PrimitivesToUpdate)
+			{
+				Scene.GPUScene.PrimitiveDirtyState[Index] = EPrimitiveDirtyState::None;
+			}
 			Scene.GPUScene.PrimitivesToUpdate.Reset();
 			
 			if (Scene.GPUScene.PrimitiveUploadBuffer.GetNumBytes() > (uint32)GGPUSceneMaxPooledUploadBufferSize)
@@ -386,6 +525,11 @@ void UpdateGPUSceneInternal(FRHICommandListImmediate& RHICmdList, FScene& Scene)
 				Scene.GPUScene.PrimitiveUploadBuffer.Release();
 			}
 
+			if (Scene.GPUScene.PrimitiveTransformUploadBuffer.GetNumBytes() > (uint32)GGPUSceneMaxPooledUploadBufferSize)
+			{
+				Scene.GPUScene.PrimitiveTransformUploadBuffer.Release();
+			}
+
 			if (Scene.GPUScene.LightmapUploadBuffer.GetNumBytes() > (uint32)GGPUSceneMaxPooledUploadBufferSize)
 			{
 				Scene.GPUScene.LightmapUploadBuffer.Release();
@@ -454,6 +598,10 @@ void UploadDynamicPrimitiveShaderDataForViewInternal(FRHICommandListImmediate& R
 						Scene.GPUScene.PrimitiveUploadBuffer.ResourceUploadTo(RHICmdList, ViewPrimitiveShaderDataResource, false);
 					}
 				}
+
+				const uint32 NumPrimitiveBytesUploaded = NumPrimitiveDataUploads * (sizeof(FPrimitiveSceneShaderData::Data) + sizeof(uint32));
+				INC_DWORD_STAT_BY(STAT_GPUScenePrimitiveBytesUploaded, NumPrimitiveBytesUploaded);
+				CSV_CUSTOM_STAT(GPUScene, PrimitiveBytesUploaded, float(NumPrimitiveBytesUploaded), ECsvCustomStatOp::Accumulate);
 			}
 
 			RHICmdList.TransitionResource(EResourceTransitionAccess::EReadable, EResourceTransitionPipeline::EComputeToGfx, ViewPrimitiveShaderDataResource.UAV);
@@ -501,22 +649,23 @@ void UploadDynamicPrimitiveShaderDataForViewInternal(FRHICommandListImmediate& R
 template void UploadDynamicPrimitiveShaderDataForViewInternal<FRWBufferStructured>(FRHICommandListImmediate& RHICmdList, FScene& Scene, FViewInfo& View);
 template void UploadDynamicPrimitiveShaderDataForViewInternal<FTextureRWBuffer2D>(FRHICommandListImmediate& RHICmdList, FScene& Scene, FViewInfo& View);
 
-void AddPrimitiveToUpdateGPU(FScene& Scene, int32 PrimitiveId)
+void AddPrimitiveToUpdateGPU(FScene& Scene, int32 PrimitiveId, EPrimitiveDirtyState DirtyState)
 {
 	if (UseGPUScene(GMaxRHIShaderPlatform, Scene.GetFeatureLevel()))
 	{ 
-		if (PrimitiveId + 1 > Scene.GPUScene.PrimitivesMarkedToUpdate.Num())
+		if (PrimitiveId + 1 > Scene.GPUScene.PrimitiveDirtyState.Num())
 		{
 			const int32 NewSize = Align(PrimitiveId + 1, 64);
-			Scene.GPUScene.PrimitivesMarkedToUpdate.Add(0, NewSize - Scene.GPUScene.PrimitivesMarkedToUpdate.Num());
+			Scene.GPUScene.PrimitiveDirtyState.AddZeroed(NewSize - Scene.GPUScene.PrimitiveDirtyState.Num());
 		}
 
 		// Make sure we aren't updating same primitive multiple times.
-		if (!Scene.GPUScene.PrimitivesMarkedToUpdate[PrimitiveId])
+		if (Scene.GPUScene.PrimitiveDirtyState[PrimitiveId] == EPrimitiveDirtyState::None)
 		{
 			Scene.GPUScene.PrimitivesToUpdate.Add(PrimitiveId);
-			Scene.GPUScene.PrimitivesMarkedToUpdate[PrimitiveId] = true;
 		}
+
+		Scene.GPUScene.PrimitiveDirtyState[PrimitiveId] |= DirtyState;
 	}
 }
 
@@ -10,7 +10,17 @@ class FRHICommandList;
 class FScene;
 class FViewInfo;
 
+/** Parts of a primitive's GPU Scene data that need to be uploaded. */
+enum class EPrimitiveDirtyState : uint8
+{
+	None				= 0,
+	/** Transform, bounds and primitive flags, everything but the custom primitive data and the lightmap data. */
+	ChangedTransform	= 1 << 0,
+	ChangedAll			= 0xFF,
+};
+ENUM_CLASS_FLAGS(EPrimitiveDirtyState);
+
 extern void UploadDynamicPrimitiveShaderDataForView(FRHICommandListImmediate& RHICmdList, FScene& Scene, FViewInfo& View);
 extern void UpdateGPUScene(FRHICommandListImmediate& RHICmdList, FScene& Scene);
-extern void AddPrimitiveToUpdateGPU(FScene& Scene, int32 PrimitiveId);
+extern void AddPrimitiveToUpdateGPU(FScene& Scene, int32 PrimitiveId, EPrimitiveDirtyState DirtyState = EPrimitiveDirtyState::ChangedAll);
 
@@ -38,6 +38,7 @@ void FLightSceneInfoCompact::Init(FLightSceneInfo* InLightSceneInfo)
 FLightSceneInfo::FLightSceneInfo(FLightSceneProxy* InProxy, bool InbVisible)
 	: DynamicInteractionOftenMovingPrimitiveList(NULL)
 	, DynamicInteractionStaticPrimitiveList(NULL)
+	, bWholeSceneStaticShadowCastersDirty(true)
 	, Proxy(InProxy)
 	, Id(INDEX_NONE)
 	, TileIntersectionResources(nullptr)
@@ -235,6 +236,34 @@ FLightPrimitiveInteraction* FLightSceneInfo::GetDynamicInteractionStaticPrimitiv
 	return DynamicInteractionStaticPrimitiveList;
 }
 
+const TArray<FPrimitiveSceneInfo*>& FLightSceneInfo::GetWholeSceneStaticShadowCasters(bool bSync) const
+{
+	check(IsInRenderingThread());
+
+	if (bSync)
+	{
+		Scene->FlushAsyncLightPrimitiveInteractionCreation();
+	}
+
+	if (bWholeSceneStaticShadowCastersDirty)
+	{
+		WholeSceneStaticShadowCasters.Reset();
+
+		for (FLightPrimitiveInteraction* Interaction = DynamicInteractionStaticPrimitiveList; Interaction; Interaction = Interaction->GetNextPrimitive())
+		{
+			// If the primitive only wants to cast a self shadow don't include it in whole scene shadows.
+			if (Interaction->HasShadow() && !Interaction->CastsSelfShadowOnly())
+			{
+				WholeSceneStaticShadowCasters.Add(Interaction->GetPrimitiveSceneInfo());
+			}
+		}
+
+		bWholeSceneStaticShadowCastersDirty = false;
+	}
+
+	return WholeSceneStaticShadowCasters;
+}
+
 void FLightSceneInfo::ReleaseRHI()
 {
 	if (TileIntersectionResources)
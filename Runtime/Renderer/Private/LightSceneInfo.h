@@ -158,6 +158,13 @@ class FLightSceneInfo : public FRenderResource
 
 	FLightPrimitiveInteraction* DynamicInteractionStaticPrimitiveList;
 
+	/**
+	 * Shadow casting primitives of DynamicInteractionStaticPrimitiveList that can cast whole scene shadows, kept across frames.
+	 * Rebuilt after a static primitive interaction is created or destroyed, which is also what happens when the primitive moves.
+	 */
+	mutable TArray<FPrimitiveSceneInfo*> WholeSceneStaticShadowCasters;
+	mutable bool bWholeSceneStaticShadowCastersDirty;
+
 public:
 	/** The light's scene proxy. */
 	FLightSceneProxy* Proxy;
@@ -306,6 +313,9 @@ public:
 
 	FLightPrimitiveInteraction* GetDynamicInteractionStaticPrimitiveList(bool bSync = true) const;
 
+	/** Returns the whole scene shadow casters of the static primitive interaction list, rebuilding them if interactions changed. */
+	const TArray<FPrimitiveSceneInfo*>& GetWholeSceneStaticShadowCasters(bool bSync = true) const;
+
 	/** Hash function. */
 	friend uint32 GetTypeHash(const FLightSceneInfo* LightSceneInfo)
 	{
@@ -25,6 +25,16 @@ static TAutoConsoleVariable<int32> CVarMobileMeshSortingMethod(
 	TEXT("\t1: Strict front to back sorting.\n"),
 	ECVF_RenderThreadSafe);
 
+static TAutoConsoleVariable<int32> CVarMeshDrawCommandsIncrementalSort(
+	TEXT("r.MeshDrawCommands.IncrementalSort"),
+	0,
+	TEXT("Whether to sort the visible mesh draw commands of view passes incrementally, reusing the order of the commands that were already visible in the previous frame.\n")
+	TEXT("Only the commands that became visible are sorted and merged in, which is cheaper when the visible set changes little between frames."),
+	ECVF_RenderThreadSafe);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Reused sorted mesh draw commands"), STAT_ReusedSortedMeshDrawCommands, STATGROUP_InitViews);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resorted mesh draw commands"), STAT_ResortedMeshDrawCommands, STATGROUP_InitViews);
+
 FPrimitiveIdVertexBufferPool::FPrimitiveIdVertexBufferPool()
 	: DiscardId(0)
 {
@@ -138,6 +148,141 @@ struct FCompareFMeshDrawCommands
 	}
 };
 
+/**
+ * Sorts visible mesh draw commands using the order they had in the previous frame.
+ * Commands that were already visible keep their relative order, which is the sorted one since their sort keys did not change.
+ * Commands that became visible are sorted on their own and merged in. Produces the same order as sorting with FCompareFMeshDrawCommands.
+ * @return number of commands whose order was reused
+ */
+static int32 SortVisibleMeshDrawCommandsIncrementally(
+	FMeshCommandOneFrameArray& VisibleMeshDrawCommands,
+	FMeshCommandOneFrameArray& TempVisibleMeshDrawCommands,
+	FVisibleMeshDrawCommandSortHistory& SortHistory)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SortVisibleMeshDrawCommandsIncrementally);
+	check(TempVisibleMeshDrawCommands.Num() == 0);
+
+	typedef FVisibleMeshDrawCommandSortHistory::FKey FKey;
+	const int32 NumCommands = VisibleMeshDrawCommands.Num();
+
+	// Runs on task threads, so scratch arrays are kept in the history rather than on the rendering thread mem stack.
+	TArray<FKey>& InputKeys = SortHistory.InputKeysScratch;
+	InputKeys.SetNumUninitialized(NumCommands, false);
+
+	bool bSameInput = SortHistory.InputKeys.Num() == NumCommands;
+	for (int32 CommandIndex = 0; CommandIndex < NumCommands; ++CommandIndex)
+	{
+		InputKeys[CommandIndex] = FKey(VisibleMeshDrawCommands[CommandIndex]);
+		bSameInput = bSameInput && InputKeys[CommandIndex] == SortHistory.InputKeys[CommandIndex];
+	}
+
+	TempVisibleMeshDrawCommands.SetNumUninitialized(NumCommands, false);
+
+	if (bSameInput)
+	{
+		// The same commands were gathered in the same order, apply last frame's permutation.
+		for (int32 CommandIndex = 0; CommandIndex < NumCommands; ++CommandIndex)
+		{
+			TempVisibleMeshDrawCommands[SortHistory.SortedIndices[CommandIndex]] = VisibleMeshDrawCommands[CommandIndex];
+		}
+
+		FMemory::Memswap(&VisibleMeshDrawCommands, &TempVisibleMeshDrawCommands, sizeof(TempVisibleMeshDrawCommands));
+		TempVisibleMeshDrawCommands.Reset();
+		return NumCommands;
+	}
+
+	// The map from command to sorted index persists across frames and is updated in place below: entries of commands that
+	// stayed visible are found and renumbered, entries of commands that became invisible are removed and new ones added.
+	typedef FVisibleMeshDrawCommandSortHistory::FSortedCommand FSortedCommand;
+	typedef FVisibleMeshDrawCommandSortHistory::FReusedCommand FReusedCommand;
+	TMap<FKey, FSortedCommand>& SortedCommands = SortHistory.SortedCommands;
+	const uint32 Generation = ++SortHistory.Generation;
+
+	TArray<FReusedCommand>& ReusedCommands = SortHistory.ReusedCommandsScratch;
+	TArray<int32>& NewCommandIndices = SortHistory.NewCommandIndicesScratch;
+	TArray<FSortedCommand*>& ReusedEntries = SortHistory.ReusedEntriesScratch;
+	ReusedCommands.Reset(NumCommands);
+	NewCommandIndices.Reset();
+	ReusedEntries.SetNumUninitialized(NumCommands, false);
+
+	for (int32 CommandIndex = 0; CommandIndex < NumCommands; ++CommandIndex)
+	{
+		FSortedCommand* SortedCommand = SortedCommands.Find(InputKeys[CommandIndex]);
+
+		// A command gathered twice only reuses its entry once.
+		if (SortedCommand && SortedCommand->Generation != Generation)
+		{
+			SortedCommand->Generation = Generation;
+			ReusedCommands.Add({ (uint32)SortedCommand->SortedIndex, CommandIndex });
+			ReusedEntries[CommandIndex] = SortedCommand;
+		}
+		else
+		{
+			NewCommandIndices.Add(CommandIndex);
+			ReusedEntries[CommandIndex] = nullptr;
+		}
+	}
+
+	// Commands that stayed visible are ordered by their previous position.
+	TArray<FReusedCommand>& SortedReusedCommands = SortHistory.SortedReusedCommandsScratch;
+	SortedReusedCommands.SetNumUninitialized(ReusedCommands.Num(), false);
+	RadixSort32(SortedReusedCommands.GetData(), ReusedCommands.GetData(), ReusedCommands.Num(), [](const FReusedCommand& Command) { return Command.PreviousSortedIndex; });
+
+	// Commands that became visible are sorted on their own.
+	{
+		const FCompareFMeshDrawCommands Compare;
+		NewCommandIndices.Sort([&VisibleMeshDrawCommands, &Compare](int32 A, int32 B)
+		{
+			return Compare(VisibleMeshDrawCommands[A], VisibleMeshDrawCommands[B]);
+		});
+	}
+
+	// Merge both lists and record the new sorted index of each gathered command.
+	SortHistory.SortedIndices.SetNumUninitialized(NumCommands, false);
+	{
+		const FCompareFMeshDrawCommands Compare;
+		int32 ReusedIndex = 0;
+		int32 NewIndex = 0;
+
+		for (int32 SortedIndex = 0; SortedIndex < NumCommands; ++SortedIndex)
+		{
+			const bool bTakeNew = ReusedIndex == SortedReusedCommands.Num()
+				|| (NewIndex < NewCommandIndices.Num() && Compare(VisibleMeshDrawCommands[NewCommandIndices[NewIndex]], VisibleMeshDrawCommands[SortedReusedCommands[ReusedIndex].CommandIndex]));
+			const int32 CommandIndex = bTakeNew ? NewCommandIndices[NewIndex++] : SortedReusedCommands[ReusedIndex++].CommandIndex;
+
+			TempVisibleMeshDrawCommands[SortedIndex] = VisibleMeshDrawCommands[CommandIndex];
+			SortHistory.SortedIndices[CommandIndex] = SortedIndex;
+
+			if (!bTakeNew)
+			{
+				ReusedEntries[CommandIndex]->SortedIndex = SortedIndex;
+			}
+		}
+	}
+
+	// Removing from the map leaves the other entries in place, so this is done before adding and after the entries were renumbered.
+	for (TMap<FKey, FSortedCommand>::TIterator It(SortedCommands); It; ++It)
+	{
+		if (It.Value().Generation != Generation)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (const int32 CommandIndex : NewCommandIndices)
+	{
+		FSortedCommand& SortedCommand = SortedCommands.Add(InputKeys[CommandIndex]);
+		SortedCommand.SortedIndex = SortHistory.SortedIndices[CommandIndex];
+		SortedCommand.Generation = Generation;
+	}
+
+	Swap(SortHistory.InputKeys, InputKeys);
+
+	FMemory::Memswap(&VisibleMeshDrawCommands, &TempVisibleMeshDrawCommands, sizeof(TempVisibleMeshDrawCommands));
+	TempVisibleMeshDrawCommands.Reset();
+	return ReusedCommands.Num();
+}
+
 uint32 BitInvertIfNegativeFloat(uint32 f)
 {
 	unsigned mask = -int32(f >> 31) | 0x80000000;
@@ -864,6 +1009,13 @@ public:
 				);
 			}
 
+			if (Context.SortHistory)
+			{
+				Context.NumReusedMeshDrawCommands = SortVisibleMeshDrawCommandsIncrementally(Context.MeshDrawCommands, Context.TempVisibleMeshDrawCommands, *Context.SortHistory);
+				INC_DWORD_STAT_BY(STAT_ReusedSortedMeshDrawCommands, Context.NumReusedMeshDrawCommands);
+				INC_DWORD_STAT_BY(STAT_ResortedMeshDrawCommands, Context.MeshDrawCommands.Num() - Context.NumReusedMeshDrawCommands);
+			}
+			else
 			{
 				QUICK_SCOPE_CYCLE_COUNTER(STAT_SortVisibleMeshDrawCommands);
 				Context.MeshDrawCommands.Sort(FCompareFMeshDrawCommands());
@@ -1054,6 +1206,22 @@ void FParallelMeshDrawCommandPass::DispatchPassSetup(
 	TaskContext.ViewMatrix = View.ViewMatrices.GetViewMatrix();
 	TaskContext.PrimitiveBounds = &Scene->PrimitiveBounds;
 
+	// Hand the sort history of this pass to the task, unless another pass setup of the same view state already uses it this frame.
+	TaskContext.SortHistory = nullptr;
+	TaskContext.NumReusedMeshDrawCommands = 0;
+	FSceneViewState* ViewState = (FSceneViewState*)View.State;
+
+	if (ViewState && PassType != EMeshPass::Num && CVarMeshDrawCommandsIncrementalSort.GetValueOnRenderThread() != 0)
+	{
+		FVisibleMeshDrawCommandSortHistory& SortHistory = ViewState->MeshDrawCommandSortHistory[PassType];
+
+		if (SortHistory.LastFrameNumber != View.Family->FrameNumber)
+		{
+			SortHistory.LastFrameNumber = View.Family->FrameNumber;
+			TaskContext.SortHistory = &SortHistory;
+		}
+	}
+
 	switch (PassType)
 	{
 		case EMeshPass::TranslucencyStandard: TaskContext.TranslucencyPass = ETranslucencyPass::TPT_StandardTranslucency; break;
@@ -1169,6 +1337,8 @@ void FParallelMeshDrawCommandPass::WaitForTasksAndEmpty()
 	TaskContext.TempVisibleMeshDrawCommands.Empty();
 	TaskContext.PrimitiveIdBufferData = nullptr;
 	TaskContext.PrimitiveIdBufferDataSize = 0;
+	TaskContext.SortHistory = nullptr;
+	TaskContext.NumReusedMeshDrawCommands = 0;
 }
 
 FParallelMeshDrawCommandPass::~FParallelMeshDrawCommandPass()
@@ -1336,6 +1506,11 @@ void FParallelMeshDrawCommandPass::DumpInstancingStats() const
 		UE_LOG(LogRenderer, Log, TEXT("   %i Mesh Draw Commands in %i instancing state buckets"), TaskContext.VisibleMeshDrawCommandsNum, TaskContext.NewPassVisibleMeshDrawCommandsNum);
 		UE_LOG(LogRenderer, Log, TEXT("   Largest %i"), TaskContext.MaxInstances);
 		UE_LOG(LogRenderer, Log, TEXT("   %.1f Dynamic Instancing draw call reduction factor"), TaskContext.VisibleMeshDrawCommandsNum / (float)TaskContext.NewPassVisibleMeshDrawCommandsNum);
+
+		if (TaskContext.SortHistory)
+		{
+			UE_LOG(LogRenderer, Log, TEXT("   %i Mesh Draw Commands reused their sorted order, %i were sorted"), TaskContext.NumReusedMeshDrawCommands, TaskContext.VisibleMeshDrawCommandsNum - TaskContext.NumReusedMeshDrawCommands);
+		}
 	}
 }
 
@@ -44,6 +44,85 @@ private:
 
 extern TGlobalResource<FPrimitiveIdVertexBufferPool> GPrimitiveIdVertexBufferPool;
 
+/**
+ * Visible mesh draw commands of a mesh pass as they were gathered and sorted in the previous frame.
+ * Stored per view state and used to sort the next frame's commands incrementally, see r.MeshDrawCommands.IncrementalSort.
+ */
+class FVisibleMeshDrawCommandSortHistory
+{
+public:
+	struct FKey
+	{
+		const FMeshDrawCommand* MeshDrawCommand;
+		uint64 SortKey;
+		int32 DrawPrimitiveId;
+		int32 StateBucketId;
+
+		FKey() = default;
+
+		explicit FKey(const FVisibleMeshDrawCommand& VisibleMeshDrawCommand)
+			: MeshDrawCommand(VisibleMeshDrawCommand.MeshDrawCommand)
+			, SortKey(VisibleMeshDrawCommand.SortKey.PackedData)
+			, DrawPrimitiveId(VisibleMeshDrawCommand.DrawPrimitiveId)
+			, StateBucketId(VisibleMeshDrawCommand.StateBucketId)
+		{
+		}
+
+		bool operator==(const FKey& Other) const
+		{
+			return MeshDrawCommand == Other.MeshDrawCommand
+				&& SortKey == Other.SortKey
+				&& DrawPrimitiveId == Other.DrawPrimitiveId
+				&& StateBucketId == Other.StateBucketId;
+		}
+
+		friend uint32 GetTypeHash(const FKey& Key)
+		{
+			return HashCombine(PointerHash(Key.MeshDrawCommand), HashCombine(GetTypeHash(Key.SortKey), GetTypeHash(Key.DrawPrimitiveId)));
+		}
+	};
+
+	struct FSortedCommand
+	{
+		int32 SortedIndex;
+		uint32 Generation;
+	};
+
+	struct FReusedCommand
+	{
+		uint32 PreviousSortedIndex;
+		int32 CommandIndex;
+	};
+
+	FVisibleMeshDrawCommandSortHistory()
+		: Generation(0)
+		, LastFrameNumber(UINT_MAX)
+	{
+	}
+
+	/** Keys of the commands in the order they were gathered. */
+	TArray<FKey> InputKeys;
+
+	/** Index of each gathered command in the sorted list. */
+	TArray<int32> SortedIndices;
+
+	/** Sorted index of each visible command, updated in place when the visible set changes. */
+	TMap<FKey, FSortedCommand> SortedCommands;
+
+	/** Incremented on each incremental sort, entries of SortedCommands not stamped with it are no longer visible. */
+	uint32 Generation;
+
+	/** Scratch storage reused across frames by the sorting task. */
+	TArray<FKey> InputKeysScratch;
+	TArray<int32> NewCommandIndicesScratch;
+	TArray<FReusedCommand> ReusedCommandsScratch;
+	TArray<FReusedCommand> SortedReusedCommandsScratch;
+	TArray<FSortedCommand*> ReusedEntriesScratch;
+
+	/** Frame the history was last handed to a pass setup task, a history is only used by one task per frame. */
+	uint32 LastFrameNumber;
+};
+
 /**	
  * Parallel mesh draw command pass setup task context.
  */
@@ -69,6 +148,8 @@ public:
 		, PrimitiveIdBufferData(nullptr)
 		, PrimitiveIdBufferDataSize(0)
 		, PrimitiveBounds(nullptr)
+		, SortHistory(nullptr)
+		, NumReusedMeshDrawCommands(0)
 		, VisibleMeshDrawCommandsNum(0)
 		, NewPassVisibleMeshDrawCommandsNum(0)
 		, MaxInstances(1)
@@ -117,6 +198,10 @@ public:
 	FMatrix ViewMatrix;
 	const TArray<struct FPrimitiveBounds>* PrimitiveBounds;
 
+	// For incremental sorting, null if the commands are fully sorted.
+	FVisibleMeshDrawCommandSortHistory* SortHistory;
+	int32 NumReusedMeshDrawCommands;
+
 	// For logging instancing stats.
 	int32 VisibleMeshDrawCommandsNum;
 	int32 NewPassVisibleMeshDrawCommandsNum;
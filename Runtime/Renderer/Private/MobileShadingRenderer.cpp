@@ -379,7 +379,7 @@ void FMobileSceneRenderer::Render(FRHICommandListImmediate& RHICmdList)
 	SCOPED_DRAW_EVENT(RHICmdList, MobileSceneRender);
 	SCOPED_GPU_STAT(RHICmdList, MobileSceneRender);
 
-	Scene->UpdateAllPrimitiveSceneInfos(RHICmdList);
+	Scene->UpdateAllPrimitiveSceneInfosWithBudget(RHICmdList);
 
 	PrepareViewRectsForRendering();
 
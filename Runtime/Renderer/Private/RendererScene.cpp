@@ -691,6 +691,24 @@ static void DoLazyStaticMeshUpdateCVarSinkFunction()
 
 static FAutoConsoleVariableSink CVarDoLazyStaticMeshUpdateSink(FConsoleCommandDelegate::CreateStatic(&DoLazyStaticMeshUpdateCVarSinkFunction));
 
+static TAutoConsoleVariable<float> CVarAddPrimitivesTimeBudgetMs(
+	TEXT("r.Scene.AddPrimitivesTimeBudgetMs"),
+	0.0f,
+	TEXT("Time in milliseconds the renderer may spend adding new primitives to the scene each frame, including caching their mesh draw commands.\n")
+	TEXT("Primitives over budget stay pending and are added by the next frames, they are not rendered until then. 0 adds all primitives in the frame they were registered (default)."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarAddPrimitivesBatchSize(
+	TEXT("r.Scene.AddPrimitivesBatchSize"),
+	512,
+	TEXT("Number of primitives added to the scene between two checks of r.Scene.AddPrimitivesTimeBudgetMs."),
+	ECVF_RenderThreadSafe);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pending primitive adds"), STAT_PendingScenePrimitiveAdds, STATGROUP_SceneRendering);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Primitive adds (ms)"), STAT_AddScenePrimitivesMs, STATGROUP_SceneRendering);
+
+CSV_DEFINE_CATEGORY(ScenePrimitives, true);
+
 static void UpdateEarlyZPassModeCVarSinkFunction()
 {
 	static int32 CachedEarlyZPass = CVarEarlyZPass.GetValueOnGameThread();
@@ -1157,6 +1175,8 @@ FScene::FScene(UWorld* InWorld, bool bInRequiresHitProxies, bool bInIsEditorScen
 #if RHI_RAYTRACING
 , RayTracingDynamicGeometryCollection(nullptr)
 #endif
+,	AddPrimitivesFrameNumber(0)
+,	AddPrimitivesTimeMs(0.0f)
 ,	AsyncCreateLightPrimitiveInteractionsTask(nullptr)
 ,	NumVisibleLights_GameThread(0)
 ,	NumEnabledSkylights_GameThread(0)
@@ -3511,6 +3531,7 @@ void FScene::ApplyWorldOffset_RenderThread(const FVector& InOffset)
 
 	// Primitives octree
 	PrimitiveOctree.ApplyOffset(InOffset, /*bGlobalOctee*/ true);
+	PrimitiveBVH.Invalidate();
 
 	// Lights
 	VectorRegister OffsetReg = VectorLoadFloat3_W0(&InOffset);
@@ -3578,13 +3599,32 @@ void FScene::OnLevelAddedToWorld(FName LevelAddedName, UWorld* InWorld, bool bIs
 	ENQUEUE_RENDER_COMMAND(FLevelAddedToWorld)(
 		[Scene, LevelAddedName](FRHICommandListImmediate& RHICmdList)
 		{
-			Scene->UpdateAllPrimitiveSceneInfos(RHICmdList);
+			Scene->UpdateAllPrimitiveSceneInfosWithBudget(RHICmdList);
 			Scene->OnLevelAddedToWorld_RenderThread(LevelAddedName);
 		});
 }
 
 void FScene::OnLevelAddedToWorld_RenderThread(FName InLevelName)
 {
+	// Level primitives still waiting to be added to the scene are added as visible later on,
+	// unless their proxy needs the notification, which expects the primitive in the scene.
+	bool bAddPendingPrimitives = false;
+
+	for (FPrimitiveSceneInfo* PrimitiveSceneInfo : AddedPrimitiveSceneInfos)
+	{
+		FPrimitiveSceneProxy* Proxy = PrimitiveSceneInfo->Proxy;
+		if (Proxy->LevelName == InLevelName)
+		{
+			Proxy->bIsComponentLevelVisible = true;
+			bAddPendingPrimitives |= Proxy->NeedsLevelAddedToWorldNotification();
+		}
+	}
+
+	if (bAddPendingPrimitives)
+	{
+		UpdateAllPrimitiveSceneInfos(FRHICommandListExecutor::GetImmediateCommandList());
+	}
+
 	// Mark level primitives
 	TArray<FPrimitiveSceneInfo*> PrimitivesToAdd;
 
@@ -3678,6 +3718,25 @@ struct FPrimitiveArraySortKey
 };
 
 void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList, bool bAsyncCreateLPIs)
+{
+	UpdateAllPrimitiveSceneInfosInternal(RHICmdList, bAsyncCreateLPIs, 0.0f);
+}
+
+void FScene::UpdateAllPrimitiveSceneInfosWithBudget(FRHICommandListImmediate& RHICmdList, bool bAsyncCreateLPIs)
+{
+	const float TimeBudgetMs = GIsEditor ? 0.0f : CVarAddPrimitivesTimeBudgetMs.GetValueOnRenderThread();
+
+	if (AddPrimitivesFrameNumber != GFrameNumberRenderThread)
+	{
+		AddPrimitivesFrameNumber = GFrameNumberRenderThread;
+		AddPrimitivesTimeMs = 0.0f;
+	}
+
+	// The budget is shared by all the renders of the scene in a frame, a render past the budget still adds one batch of primitives.
+	UpdateAllPrimitiveSceneInfosInternal(RHICmdList, bAsyncCreateLPIs, TimeBudgetMs > 0.0f ? FMath::Max(TimeBudgetMs - AddPrimitivesTimeMs, SMALL_NUMBER) : 0.0f);
+}
+
+void FScene::UpdateAllPrimitiveSceneInfosInternal(FRHICommandListImmediate& RHICmdList, bool bAsyncCreateLPIs, float AddTimeBudgetMs)
 {
 	SCOPED_NAMED_EVENT(FScene_UpdateAllPrimitiveSceneInfos, FColor::Orange);
 	SCOPE_CYCLE_COUNTER(STAT_UpdateScenePrimitiveRenderThreadTime);
@@ -3778,6 +3837,7 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 							TArraySwapElements(PrimitiveTransforms, DestIndex, SourceIndex);
 							TArraySwapElements(PrimitiveSceneProxies, DestIndex, SourceIndex);
 							TArraySwapElements(PrimitiveBounds, DestIndex, SourceIndex);
+							PrimitiveBVH.SwapPrimitives(DestIndex, SourceIndex);
 							TArraySwapElements(PrimitiveFlagsCompact, DestIndex, SourceIndex);
 							TArraySwapElements(PrimitiveVisibilityIds, DestIndex, SourceIndex);
 							TArraySwapElements(PrimitiveOcclusionFlags, DestIndex, SourceIndex);
@@ -3819,6 +3879,7 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 			{
 				int SourceIndex = RemovedLocalPrimitiveSceneInfos[RemoveIndex]->PackedIndex;
 				check(SourceIndex >= (Primitives.Num() - RemovedLocalPrimitiveSceneInfos.Num() + StartIndex));
+				PrimitiveBVH.RemoveLastPrimitive();
 				Primitives.Pop();
 				PrimitiveTransforms.Pop();
 				PrimitiveSceneProxies.Pop();
@@ -3874,6 +3935,11 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 		CSV_SCOPED_TIMING_STAT_EXCLUSIVE(AddPrimitiveSceneInfos);
 		SCOPED_NAMED_EVENT(FScene_AddPrimitiveSceneInfos, FColor::Green);
 		SCOPE_CYCLE_COUNTER(STAT_AddScenePrimitiveRenderThreadTime);
+
+		const uint32 AddStartCycles = FPlatformTime::Cycles();
+		const int32 AddBatchSize = FMath::Max(CVarAddPrimitivesBatchSize.GetValueOnRenderThread(), 1);
+		bool bAddedAnyPrimitive = false;
+
 		if (AddedLocalPrimitiveSceneInfos.Num())
 		{
 			Primitives.Reserve(Primitives.Num() + AddedLocalPrimitiveSceneInfos.Num());
@@ -3892,6 +3958,12 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 
 		while (AddedLocalPrimitiveSceneInfos.Num())
 		{
+			// Over budget, the remaining primitives stay pending until the next call.
+			if (AddTimeBudgetMs > 0.0f && bAddedAnyPrimitive && FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - AddStartCycles) >= AddTimeBudgetMs)
+			{
+				break;
+			}
+
 			int StartIndex = AddedLocalPrimitiveSceneInfos.Num() - 1;
 			SIZE_T InsertProxyHash = AddedLocalPrimitiveSceneInfos[StartIndex]->Proxy->GetTypeHash();
 
@@ -3900,6 +3972,12 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 				StartIndex--;
 			}
 
+			if (AddTimeBudgetMs > 0.0f)
+			{
+				// Primitives of the same type are added in several batches so the budget is checked often enough.
+				StartIndex = FMath::Max(StartIndex, AddedLocalPrimitiveSceneInfos.Num() - AddBatchSize);
+			}
+
 			for (int AddIndex = StartIndex; AddIndex < AddedLocalPrimitiveSceneInfos.Num(); AddIndex++)
 			{
 				FPrimitiveSceneInfo* PrimitiveSceneInfo = AddedLocalPrimitiveSceneInfos[AddIndex];
@@ -3919,6 +3997,7 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 
 				const int SourceIndex = PrimitiveSceneProxies.Num() - 1;
 				PrimitiveSceneInfo->PackedIndex = SourceIndex;
+				PrimitiveBVH.AddPrimitive(SourceIndex);
 
 				AddPrimitiveToUpdateGPU(*this, SourceIndex);
 			}
@@ -3986,6 +4065,7 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 							TArraySwapElements(PrimitiveTransforms, DestIndex, SourceIndex);
 							TArraySwapElements(PrimitiveSceneProxies, DestIndex, SourceIndex);
 							TArraySwapElements(PrimitiveBounds, DestIndex, SourceIndex);
+							PrimitiveBVH.SwapPrimitives(DestIndex, SourceIndex);
 							TArraySwapElements(PrimitiveFlagsCompact, DestIndex, SourceIndex);
 							TArraySwapElements(PrimitiveVisibilityIds, DestIndex, SourceIndex);
 							TArraySwapElements(PrimitiveOcclusionFlags, DestIndex, SourceIndex);
@@ -4072,8 +4152,19 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 				SceneLODHierarchy.UpdateNodeSceneInfo(PrimitiveSceneInfo->PrimitiveComponentId, PrimitiveSceneInfo);
 			}
 			AddedLocalPrimitiveSceneInfos.RemoveAt(StartIndex, AddedLocalPrimitiveSceneInfos.Num() - StartIndex);
+			bAddedAnyPrimitive = true;
 		}
+
+		const float AddTimeMs = FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - AddStartCycles);
+		AddPrimitivesTimeMs += AddTimeMs;
+		INC_FLOAT_STAT_BY(STAT_AddScenePrimitivesMs, AddTimeMs);
+		SET_DWORD_STAT(STAT_PendingScenePrimitiveAdds, AddedLocalPrimitiveSceneInfos.Num());
+		CSV_CUSTOM_STAT(ScenePrimitives, AddMs, AddTimeMs, ECsvCustomStatOp::Accumulate);
+		CSV_CUSTOM_STAT(ScenePrimitives, PendingAdds, AddedLocalPrimitiveSceneInfos.Num(), ECsvCustomStatOp::Set);
 	}
+
+	// Primitives left in AddedLocalPrimitiveSceneInfos were not added to the scene, their updates are kept for the call that adds them.
+	TSet<FPrimitiveSceneInfo*> PendingAddedSceneInfos(AddedLocalPrimitiveSceneInfos);
 	{
 		CSV_SCOPED_TIMING_STAT_EXCLUSIVE(UpdatePrimitiveTransform);
 		SCOPED_NAMED_EVENT(FScene_AddPrimitiveSceneInfos, FColor::Yellow);
@@ -4084,10 +4175,14 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 		UpdatedSceneInfosWithStaticDrawListUpdate.Reserve(UpdatedTransforms.Num());
 		UpdatedSceneInfosWithoutStaticDrawListUpdate.Reserve(UpdatedTransforms.Num());
 
+		// Lightmap data allocations of the updated primitives, re-adding them to the scene may move their lightmap data.
+		TArray<TPair<FPrimitiveSceneInfo*, int32>> UpdatedLightmapDataOffsets;
+		UpdatedLightmapDataOffsets.Reserve(UpdatedTransforms.Num());
+
 		for (const auto& Transform : UpdatedTransforms)
 		{
 			FPrimitiveSceneProxy* PrimitiveSceneProxy = Transform.Key;
-			if (DeletedSceneInfos.Contains(PrimitiveSceneProxy->GetPrimitiveSceneInfo()))
+			if (DeletedSceneInfos.Contains(PrimitiveSceneProxy->GetPrimitiveSceneInfo()) || PendingAddedSceneInfos.Contains(PrimitiveSceneProxy->GetPrimitiveSceneInfo()))
 			{
 				continue;
 			}
@@ -4112,6 +4207,8 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 
 			PrimitiveSceneInfo->FlushRuntimeVirtualTexture();
 
+			UpdatedLightmapDataOffsets.Emplace(PrimitiveSceneInfo, PrimitiveSceneInfo->GetLightmapDataOffset());
+
 			// Remove the primitive from the scene at its old location
 			// (note that the octree update relies on the bounds not being modified yet).
 			PrimitiveSceneInfo->RemoveFromScene(bUpdateStaticDrawLists);
@@ -4131,7 +4228,7 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 				PrimitiveSceneInfo->MarkIndirectLightingCacheBufferDirty();
 			}
 
-			AddPrimitiveToUpdateGPU(*this, PrimitiveSceneInfo->PackedIndex);
+			AddPrimitiveToUpdateGPU(*this, PrimitiveSceneInfo->PackedIndex, EPrimitiveDirtyState::ChangedTransform);
 
 			DistanceFieldSceneData.UpdatePrimitive(PrimitiveSceneInfo);
 
@@ -4154,6 +4251,14 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 			}
 		}
 
+		for (const TPair<FPrimitiveSceneInfo*, int32>& LightmapDataOffset : UpdatedLightmapDataOffsets)
+		{
+			if (LightmapDataOffset.Key->GetLightmapDataOffset() != LightmapDataOffset.Value)
+			{
+				AddPrimitiveToUpdateGPU(*this, LightmapDataOffset.Key->PackedIndex);
+			}
+		}
+
 		if (AsyncCreateLightPrimitiveInteractionsTask && AsyncCreateLightPrimitiveInteractionsTask->GetTask().HasPendingPrimitives())
 		{
 			check(GAsyncCreateLightPrimitiveInteractions);
@@ -4163,6 +4268,11 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 		for (const auto& Transform : OverridenPreviousTransforms)
 		{
 			FPrimitiveSceneInfo* PrimitiveSceneInfo = Transform.Key;
+			if (PendingAddedSceneInfos.Contains(PrimitiveSceneInfo))
+			{
+				continue;
+			}
+
 			VelocityData.OverridePreviousTransform(PrimitiveSceneInfo->PrimitiveComponentId, Transform.Value);
 		}
 	}
@@ -4170,7 +4280,7 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 	for (const auto& Attachments : UpdatedAttachmentRoots)
 	{
 		FPrimitiveSceneInfo* PrimitiveSceneInfo = Attachments.Key;
-		if (DeletedSceneInfos.Contains(PrimitiveSceneInfo))
+		if (DeletedSceneInfos.Contains(PrimitiveSceneInfo) || PendingAddedSceneInfos.Contains(PrimitiveSceneInfo))
 		{
 			continue;
 		}
@@ -4183,7 +4293,7 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 	for (const auto& CustomParams : UpdatedCustomPrimitiveParams)
 	{
 		FPrimitiveSceneProxy* PrimitiveSceneProxy = CustomParams.Key;
-		if (DeletedSceneInfos.Contains(PrimitiveSceneProxy->GetPrimitiveSceneInfo()))
+		if (DeletedSceneInfos.Contains(PrimitiveSceneProxy->GetPrimitiveSceneInfo()) || PendingAddedSceneInfos.Contains(PrimitiveSceneProxy->GetPrimitiveSceneInfo()))
 		{
 			continue;
 		}
@@ -4197,7 +4307,7 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 
 	for (FPrimitiveSceneInfo* PrimitiveSceneInfo : DistanceFieldSceneDataUpdates)
 	{
-		if (DeletedSceneInfos.Contains(PrimitiveSceneInfo))
+		if (DeletedSceneInfos.Contains(PrimitiveSceneInfo) || PendingAddedSceneInfos.Contains(PrimitiveSceneInfo))
 		{
 			continue;
 		}
@@ -4205,6 +4315,60 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 		DistanceFieldSceneData.UpdatePrimitive(PrimitiveSceneInfo);
 	}
 
+	if (PendingAddedSceneInfos.Num() == 0)
+	{
+		UpdatedAttachmentRoots.Reset();
+		UpdatedTransforms.Reset();
+		UpdatedCustomPrimitiveParams.Reset();
+		OverridenPreviousTransforms.Reset();
+		DistanceFieldSceneDataUpdates.Reset();
+		AddedPrimitiveSceneInfos.Reset();
+	}
+	else
+	{
+		for (auto It = UpdatedAttachmentRoots.CreateIterator(); It; ++It)
+		{
+			if (!PendingAddedSceneInfos.Contains(It.Key()))
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		for (auto It = UpdatedTransforms.CreateIterator(); It; ++It)
+		{
+			if (!PendingAddedSceneInfos.Contains(It.Key()->GetPrimitiveSceneInfo()))
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		for (auto It = UpdatedCustomPrimitiveParams.CreateIterator(); It; ++It)
+		{
+			if (!PendingAddedSceneInfos.Contains(It.Key()->GetPrimitiveSceneInfo()))
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		for (auto It = OverridenPreviousTransforms.CreateIterator(); It; ++It)
+		{
+			if (!PendingAddedSceneInfos.Contains(It.Key()))
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		for (auto It = DistanceFieldSceneDataUpdates.CreateIterator(); It; ++It)
+		{
+			if (!PendingAddedSceneInfos.Contains(*It))
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		AddedPrimitiveSceneInfos = MoveTemp(PendingAddedSceneInfos);
+	}
+
 	{
 		SCOPED_NAMED_EVENT(FScene_DeletePrimitiveSceneInfo, FColor::Red);
 		for (FPrimitiveSceneInfo* PrimitiveSceneInfo : DeletedSceneInfos)
@@ -4225,13 +4389,7 @@ void FScene::UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList,
 		}
 	}
 
-	UpdatedAttachmentRoots.Reset();
-	UpdatedTransforms.Reset();
-	UpdatedCustomPrimitiveParams.Reset();
-	OverridenPreviousTransforms.Reset();
-	DistanceFieldSceneDataUpdates.Reset();
 	RemovedPrimitiveSceneInfos.Reset();
-	AddedPrimitiveSceneInfos.Reset();
 }
 
 void FScene::CreateLightPrimitiveInteractionsForPrimitive(FPrimitiveSceneInfo* PrimitiveInfo, bool bAsyncCreateLPIs)
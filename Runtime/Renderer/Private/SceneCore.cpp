@@ -252,6 +252,7 @@ FLightPrimitiveInteraction::FLightPrimitiveInteraction(
 	}
 
 	FlushCachedShadowMapData();
+	InvalidateWholeSceneStaticShadowCasters();
 
 	NextPrimitive = *PrevPrimitiveLink;
 	if(*PrevPrimitiveLink)
@@ -287,6 +288,7 @@ FLightPrimitiveInteraction::~FLightPrimitiveInteraction()
 #endif
 
 	FlushCachedShadowMapData();
+	InvalidateWholeSceneStaticShadowCasters();
 
 	// Track mobile movable point light count
 	if (bMobileDynamicPointLight)
@@ -313,6 +315,15 @@ FLightPrimitiveInteraction::~FLightPrimitiveInteraction()
 	*PrevLightLink = NextLight;
 }
 
+void FLightPrimitiveInteraction::InvalidateWholeSceneStaticShadowCasters()
+{
+	// Only interactions on the light's static primitive list can be cached casters
+	if (bIsDynamic && bCastShadow && PrimitiveSceneInfo->Proxy && !PrimitiveSceneInfo->Proxy->IsMeshShapeOftenMoving())
+	{
+		LightSceneInfo->bWholeSceneStaticShadowCastersDirty = true;
+	}
+}
+
 void FLightPrimitiveInteraction::FlushCachedShadowMapData()
 {
 	if (LightSceneInfo && PrimitiveSceneInfo && PrimitiveSceneInfo->Proxy && PrimitiveSceneInfo->Scene)
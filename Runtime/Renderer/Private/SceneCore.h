@@ -117,6 +117,8 @@ private:
 	/** Hide dtor */
 	~FLightPrimitiveInteraction();
 
+	/** Marks the light's cached whole scene static shadow casters for rebuild, if the interaction is one of them. */
+	void InvalidateWholeSceneStaticShadowCasters();
 };
 
 /**
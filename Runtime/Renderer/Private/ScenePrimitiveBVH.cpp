@@ -0,0 +1,520 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ScenePrimitiveBVH.cpp: Bounding volume hierarchy over the scene primitive bounds.
+=============================================================================*/
+
+#include "ScenePrimitiveBVH.h"
+#include "HAL/IConsoleManager.h"
+#include "Templates/Sorting.h"
+#include "ConvexVolume.h"
+#include "ScenePrivate.h"
+
+static int32 GScenePrimitiveBVH = 0;
+static FAutoConsoleVariableRef CVarScenePrimitiveBVH(
+	TEXT("r.Visibility.BVH"),
+	GScenePrimitiveBVH,
+	TEXT("Whether to cull the scene primitives through a bounding volume hierarchy instead of testing all of them.\n")
+	TEXT("Used by view frustum culling and by shadow subject gathering."),
+	ECVF_RenderThreadSafe
+	);
+
+static int32 GScenePrimitiveBVHValidate = 0;
+static FAutoConsoleVariableRef CVarScenePrimitiveBVHValidate(
+	TEXT("r.Visibility.BVH.Validate"),
+	GScenePrimitiveBVHValidate,
+	TEXT("When enabled, views culled through the bounding volume hierarchy are culled again linearly and differences are logged."),
+	ECVF_RenderThreadSafe
+	);
+
+static int32 GScenePrimitiveBVHMinRebuildPrimitives = 1024;
+static FAutoConsoleVariableRef CVarScenePrimitiveBVHMinRebuildPrimitives(
+	TEXT("r.Visibility.BVH.MinRebuildPrimitives"),
+	GScenePrimitiveBVHMinRebuildPrimitives,
+	TEXT("The bounding volume hierarchy is rebuilt once more primitives than this, or than 1/16 of the scene primitives, were added or removed since it was built.\n")
+	TEXT("Until then added primitives are tested individually."),
+	ECVF_RenderThreadSafe
+	);
+
+/** Primitives larger than this fraction of the scene are tested individually, they would make every leaf they are in pass the tests. */
+static const float LargePrimitiveSceneFraction = 0.25f;
+
+/** Extent of empty children, large enough for any box test against them to fail. */
+static const float EmptyChildExtent = -1.0e30f;
+
+/** Spreads the 10 lowest bits of a value to every third bit. */
+static FORCEINLINE uint32 SpreadMortonBits(uint32 Value)
+{
+	Value &= 0x3ff;
+	Value = (Value | (Value << 16)) & 0x030000ff;
+	Value = (Value | (Value << 8)) & 0x0300f00f;
+	Value = (Value | (Value << 4)) & 0x030c30c3;
+	Value = (Value | (Value << 2)) & 0x09249249;
+	return Value;
+}
+
+void FScenePrimitiveBVH::FNode::SetChildBounds(int32 ChildIndex, const FBox& Box, float InMaxCullDistance)
+{
+	if (Box.IsValid)
+	{
+		const FVector Center = Box.GetCenter();
+		const FVector Extent = Box.GetExtent();
+		CenterX[ChildIndex] = Center.X;
+		CenterY[ChildIndex] = Center.Y;
+		CenterZ[ChildIndex] = Center.Z;
+		ExtentX[ChildIndex] = Extent.X;
+		ExtentY[ChildIndex] = Extent.Y;
+		ExtentZ[ChildIndex] = Extent.Z;
+	}
+	else
+	{
+		CenterX[ChildIndex] = CenterY[ChildIndex] = CenterZ[ChildIndex] = 0.0f;
+		ExtentX[ChildIndex] = ExtentY[ChildIndex] = ExtentZ[ChildIndex] = EmptyChildExtent;
+	}
+	MaxCullDistance[ChildIndex] = InMaxCullDistance;
+}
+
+FBox FScenePrimitiveBVH::FNode::GetChildBox(int32 ChildIndex) const
+{
+	const FVector Center(CenterX[ChildIndex], CenterY[ChildIndex], CenterZ[ChildIndex]);
+	const FVector Extent(ExtentX[ChildIndex], ExtentY[ChildIndex], ExtentZ[ChildIndex]);
+	return FBox(Center - Extent, Center + Extent);
+}
+
+FScenePrimitiveBVH::FScenePrimitiveBVH()
+	: NumDirtyLeaves(0)
+	, NumAddedPrimitives(0)
+	, NumRemovedPrimitives(0)
+	, bValid(false)
+{
+}
+
+bool FScenePrimitiveBVH::IsEnabled()
+{
+	return GScenePrimitiveBVH != 0;
+}
+
+bool FScenePrimitiveBVH::ShouldValidate()
+{
+	return GScenePrimitiveBVHValidate != 0;
+}
+
+void FScenePrimitiveBVH::SetSlotPrimitive(int32 Slot, int32 PackedIndex)
+{
+	if (Slot >= 0)
+	{
+		LeafPrimitives[Slot] = PackedIndex;
+	}
+	else
+	{
+		UnsortedPrimitives[GetUnsortedIndex(Slot)] = PackedIndex;
+	}
+}
+
+void FScenePrimitiveBVH::AddPrimitive(int32 PackedIndex)
+{
+	if (bValid)
+	{
+		check(PackedIndex == PrimitiveSlots.Num());
+		PrimitiveSlots.Add(MakeUnsortedSlot(UnsortedPrimitives.Add(PackedIndex)));
+		NumAddedPrimitives++;
+	}
+}
+
+void FScenePrimitiveBVH::RemoveLastPrimitive()
+{
+	if (bValid)
+	{
+		const int32 Slot = PrimitiveSlots.Pop(false);
+		if (Slot >= 0)
+		{
+			LeafPrimitives[Slot] = INDEX_NONE;
+
+			// Shrink the leaf bounds on the next refit
+			const int32 LeafIndex = Slot / LeafSize;
+			if (!DirtyLeaves[LeafIndex])
+			{
+				DirtyLeaves[LeafIndex] = true;
+				NumDirtyLeaves++;
+			}
+		}
+		else
+		{
+			const int32 UnsortedIndex = GetUnsortedIndex(Slot);
+			UnsortedPrimitives.RemoveAtSwap(UnsortedIndex, 1, false);
+			if (UnsortedIndex < UnsortedPrimitives.Num())
+			{
+				PrimitiveSlots[UnsortedPrimitives[UnsortedIndex]] = MakeUnsortedSlot(UnsortedIndex);
+			}
+		}
+		NumRemovedPrimitives++;
+	}
+}
+
+void FScenePrimitiveBVH::SwapPrimitives(int32 PackedIndexA, int32 PackedIndexB)
+{
+	if (bValid)
+	{
+		Swap(PrimitiveSlots[PackedIndexA], PrimitiveSlots[PackedIndexB]);
+		SetSlotPrimitive(PrimitiveSlots[PackedIndexA], PackedIndexA);
+		SetSlotPrimitive(PrimitiveSlots[PackedIndexB], PackedIndexB);
+	}
+}
+
+void FScenePrimitiveBVH::UpdatePrimitiveBounds(int32 PackedIndex)
+{
+	if (bValid)
+	{
+		// Primitives that are not in a leaf are tested with their current bounds
+		const int32 Slot = PrimitiveSlots[PackedIndex];
+		if (Slot >= 0 && !DirtyLeaves[Slot / LeafSize])
+		{
+			DirtyLeaves[Slot / LeafSize] = true;
+			NumDirtyLeaves++;
+		}
+	}
+}
+
+void FScenePrimitiveBVH::Invalidate()
+{
+	bValid = false;
+}
+
+void FScenePrimitiveBVH::Release()
+{
+	Nodes.Empty();
+	LeafPrimitives.Empty();
+	PrimitiveSlots.Empty();
+	UnsortedPrimitives.Empty();
+	DirtyLeaves.Empty();
+	NumDirtyLeaves = 0;
+	NumAddedPrimitives = 0;
+	NumRemovedPrimitives = 0;
+	bValid = false;
+}
+
+bool FScenePrimitiveBVH::Update(const TArray<FPrimitiveBounds>& PrimitiveBounds)
+{
+	check(IsInRenderingThread());
+
+	if (!IsEnabled())
+	{
+		if (bValid || Nodes.Num() > 0)
+		{
+			Release();
+		}
+		return false;
+	}
+
+	checkSlow(!bValid || PrimitiveSlots.Num() == PrimitiveBounds.Num());
+
+	const int32 MaxChangedPrimitives = FMath::Max(GScenePrimitiveBVHMinRebuildPrimitives, PrimitiveBounds.Num() / 16);
+	if (!bValid || NumAddedPrimitives + NumRemovedPrimitives > MaxChangedPrimitives)
+	{
+		Build(PrimitiveBounds);
+	}
+	else if (NumDirtyLeaves > 0)
+	{
+		Refit(PrimitiveBounds);
+	}
+
+	return bValid;
+}
+
+bool FScenePrimitiveBVH::ComputeLeafBounds(int32 LeafIndex, const TArray<FPrimitiveBounds>& PrimitiveBounds, FBox& OutBox, float& OutMaxCullDistance) const
+{
+	OutBox.Init();
+	OutMaxCullDistance = 0.0f;
+
+	const int32* LeafSlots = &LeafPrimitives[LeafIndex * LeafSize];
+	for (int32 SlotIndex = 0; SlotIndex < LeafSize; ++SlotIndex)
+	{
+		if (LeafSlots[SlotIndex] != INDEX_NONE)
+		{
+			const FPrimitiveBounds& Bounds = PrimitiveBounds[LeafSlots[SlotIndex]];
+			OutBox += FBox(Bounds.BoxSphereBounds.Origin - Bounds.BoxSphereBounds.BoxExtent, Bounds.BoxSphereBounds.Origin + Bounds.BoxSphereBounds.BoxExtent);
+			OutMaxCullDistance = FMath::Max(OutMaxCullDistance, Bounds.MaxCullDistance);
+		}
+	}
+
+	return !!OutBox.IsValid;
+}
+
+bool FScenePrimitiveBVH::ComputeNodeBounds(const FNode& Node, FBox& OutBox, float& OutMaxCullDistance) const
+{
+	OutBox.Init();
+	OutMaxCullDistance = 0.0f;
+
+	for (int32 ChildIndex = 0; ChildIndex < Node.NumChildren; ++ChildIndex)
+	{
+		if (!Node.IsChildEmpty(ChildIndex))
+		{
+			OutBox += Node.GetChildBox(ChildIndex);
+			OutMaxCullDistance = FMath::Max(OutMaxCullDistance, Node.MaxCullDistance[ChildIndex]);
+		}
+	}
+
+	return !!OutBox.IsValid;
+}
+
+void FScenePrimitiveBVH::Build(const TArray<FPrimitiveBounds>& PrimitiveBounds)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ScenePrimitiveBVH_Build);
+
+	const int32 NumPrimitives = PrimitiveBounds.Num();
+
+	Nodes.Reset();
+	LeafPrimitives.Reset();
+	UnsortedPrimitives.Reset();
+	PrimitiveSlots.SetNumUninitialized(NumPrimitives);
+	NumDirtyLeaves = 0;
+	NumAddedPrimitives = 0;
+	NumRemovedPrimitives = 0;
+	bValid = true;
+
+	FBox CenterBounds(ForceInit);
+	for (const FPrimitiveBounds& Bounds : PrimitiveBounds)
+	{
+		CenterBounds += Bounds.BoxSphereBounds.Origin;
+	}
+
+	const float LargePrimitiveExtent = FMath::Max(CenterBounds.GetExtent().GetMax() * LargePrimitiveSceneFraction, 1.0f);
+	const FVector QuantizeScale = FVector(1023.0f) / CenterBounds.GetSize().ComponentMax(FVector(1.0f));
+
+	struct FSortItem
+	{
+		uint32 MortonCode;
+		int32 PackedIndex;
+	};
+
+	TArray<FSortItem> Items;
+	Items.Reserve(NumPrimitives);
+
+	for (int32 PackedIndex = 0; PackedIndex < NumPrimitives; ++PackedIndex)
+	{
+		const FBoxSphereBounds& Bounds = PrimitiveBounds[PackedIndex].BoxSphereBounds;
+		if (Bounds.BoxExtent.GetMax() > LargePrimitiveExtent)
+		{
+			PrimitiveSlots[PackedIndex] = MakeUnsortedSlot(UnsortedPrimitives.Add(PackedIndex));
+			continue;
+		}
+
+		const FVector Quantized = (Bounds.Origin - CenterBounds.Min) * QuantizeScale;
+		FSortItem Item;
+		Item.MortonCode =
+			SpreadMortonBits((uint32)FMath::Clamp(Quantized.X, 0.0f, 1023.0f))
+			| (SpreadMortonBits((uint32)FMath::Clamp(Quantized.Y, 0.0f, 1023.0f)) << 1)
+			| (SpreadMortonBits((uint32)FMath::Clamp(Quantized.Z, 0.0f, 1023.0f)) << 2);
+		Item.PackedIndex = PackedIndex;
+		Items.Add(Item);
+	}
+
+	// Primitives close to each other along the curve share leaves
+	TArray<FSortItem> SortedItems;
+	SortedItems.SetNumUninitialized(Items.Num());
+	RadixSort32(SortedItems.GetData(), Items.GetData(), Items.Num(), [](const FSortItem& Item) { return Item.MortonCode; });
+
+	const int32 NumLeaves = FMath::DivideAndRoundUp(SortedItems.Num(), LeafSize);
+	LeafPrimitives.Init(INDEX_NONE, NumLeaves * LeafSize);
+	DirtyLeaves.Init(false, NumLeaves);
+
+	for (int32 Slot = 0; Slot < SortedItems.Num(); ++Slot)
+	{
+		LeafPrimitives[Slot] = SortedItems[Slot].PackedIndex;
+		PrimitiveSlots[SortedItems[Slot].PackedIndex] = Slot;
+	}
+
+	// Group four consecutive children per node, level by level until a single root is left
+	int32 LevelStart = 0;
+	int32 LevelNum = NumLeaves;
+	bool bLeafLevel = true;
+
+	while (LevelNum > 1 || (bLeafLevel && LevelNum > 0))
+	{
+		const int32 NumLevelNodes = FMath::DivideAndRoundUp(LevelNum, 4);
+		const int32 FirstNode = Nodes.AddUninitialized(NumLevelNodes);
+
+		for (int32 LevelNodeIndex = 0; LevelNodeIndex < NumLevelNodes; ++LevelNodeIndex)
+		{
+			FNode& Node = Nodes[FirstNode + LevelNodeIndex];
+			Node.FirstChild = LevelStart + LevelNodeIndex * 4;
+			Node.NumChildren = FMath::Min(4, LevelNum - LevelNodeIndex * 4);
+			Node.Parent = INDEX_NONE;
+			Node.bLeafChildren = bLeafLevel;
+
+			for (int32 ChildIndex = 0; ChildIndex < 4; ++ChildIndex)
+			{
+				FBox ChildBox(ForceInit);
+				float ChildMaxCullDistance = 0.0f;
+
+				if (ChildIndex < Node.NumChildren)
+				{
+					if (bLeafLevel)
+					{
+						ComputeLeafBounds(Node.FirstChild + ChildIndex, PrimitiveBounds, ChildBox, ChildMaxCullDistance);
+					}
+					else
+					{
+						FNode& ChildNode = Nodes[Node.FirstChild + ChildIndex];
+						ChildNode.Parent = FirstNode + LevelNodeIndex;
+						ComputeNodeBounds(ChildNode, ChildBox, ChildMaxCullDistance);
+					}
+				}
+
+				Node.SetChildBounds(ChildIndex, ChildBox, ChildMaxCullDistance);
+			}
+		}
+
+		LevelStart = FirstNode;
+		LevelNum = NumLevelNodes;
+		bLeafLevel = false;
+	}
+}
+
+void FScenePrimitiveBVH::Refit(const TArray<FPrimitiveBounds>& PrimitiveBounds)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ScenePrimitiveBVH_Refit);
+
+	TBitArray<> DirtyNodes(false, Nodes.Num());
+
+	// Leaves are the children of the bottom level nodes, which come first
+	for (TConstSetBitIterator<> It(DirtyLeaves); It; ++It)
+	{
+		const int32 LeafIndex = It.GetIndex();
+		FBox LeafBox;
+		float LeafMaxCullDistance;
+		ComputeLeafBounds(LeafIndex, PrimitiveBounds, LeafBox, LeafMaxCullDistance);
+
+		Nodes[LeafIndex / 4].SetChildBounds(LeafIndex % 4, LeafBox, LeafMaxCullDistance);
+		DirtyNodes[LeafIndex / 4] = true;
+	}
+
+	// Parents always come after their children
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); ++NodeIndex)
+	{
+		const FNode& Node = Nodes[NodeIndex];
+		if (DirtyNodes[NodeIndex] && Node.Parent != INDEX_NONE)
+		{
+			FBox NodeBox;
+			float NodeMaxCullDistance;
+			ComputeNodeBounds(Node, NodeBox, NodeMaxCullDistance);
+
+			FNode& ParentNode = Nodes[Node.Parent];
+			ParentNode.SetChildBounds(NodeIndex - ParentNode.FirstChild, NodeBox, NodeMaxCullDistance);
+			DirtyNodes[Node.Parent] = true;
+		}
+	}
+
+	DirtyLeaves.Init(false, DirtyLeaves.Num());
+	NumDirtyLeaves = 0;
+}
+
+int32 FScenePrimitiveBVH::FindPotentiallyVisiblePrimitives(const FConvexVolume& Frustum, const FVector& ViewOrigin, float MaxDrawDistanceScale, float FadeRadius, FSceneBitArray& OutCandidates) const
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_ScenePrimitiveBVH_FindPotentiallyVisiblePrimitives);
+	check(bValid && OutCandidates.Num() == PrimitiveSlots.Num());
+
+	uint32* RESTRICT CandidateWords = OutCandidates.GetData();
+	int32 NumCandidates = 0;
+
+	auto AddCandidate = [CandidateWords, &NumCandidates](int32 PackedIndex)
+	{
+		CandidateWords[PackedIndex / NumBitsPerDWORD] |= 1u << (PackedIndex & (NumBitsPerDWORD - 1));
+		NumCandidates++;
+	};
+
+	if (Nodes.Num() > 0)
+	{
+		const FPlane* Planes = Frustum.Planes.GetData();
+		const int32 NumPlanes = Frustum.Planes.Num();
+		const bool bDistanceCull = MaxDrawDistanceScale > 0.0f;
+
+		const VectorRegister OriginX = VectorLoadFloat1(&ViewOrigin.X);
+		const VectorRegister OriginY = VectorLoadFloat1(&ViewOrigin.Y);
+		const VectorRegister OriginZ = VectorLoadFloat1(&ViewOrigin.Z);
+		const VectorRegister DistanceScale = VectorLoadFloat1(&MaxDrawDistanceScale);
+		const VectorRegister DistanceFade = VectorLoadFloat1(&FadeRadius);
+
+		TArray<int32, TInlineAllocator<64>> NodeStack;
+		NodeStack.Add(Nodes.Num() - 1);
+
+		while (NodeStack.Num() > 0)
+		{
+			const FNode& Node = Nodes[NodeStack.Pop(false)];
+
+			const VectorRegister CenterX = VectorLoadAligned(Node.CenterX);
+			const VectorRegister CenterY = VectorLoadAligned(Node.CenterY);
+			const VectorRegister CenterZ = VectorLoadAligned(Node.CenterZ);
+			const VectorRegister ExtentX = VectorLoadAligned(Node.ExtentX);
+			const VectorRegister ExtentY = VectorLoadAligned(Node.ExtentY);
+			const VectorRegister ExtentZ = VectorLoadAligned(Node.ExtentZ);
+
+			// Same test as FConvexVolume::IntersectBox, for the four children against one plane at a time
+			VectorRegister Outside = VectorZero();
+			for (int32 PlaneIndex = 0; PlaneIndex < NumPlanes; ++PlaneIndex)
+			{
+				const FPlane& Plane = Planes[PlaneIndex];
+				const VectorRegister PlaneX = VectorLoadFloat1(&Plane.X);
+				const VectorRegister PlaneY = VectorLoadFloat1(&Plane.Y);
+				const VectorRegister PlaneZ = VectorLoadFloat1(&Plane.Z);
+				const VectorRegister PlaneW = VectorLoadFloat1(&Plane.W);
+
+				VectorRegister Distance = VectorMultiply(CenterX, PlaneX);
+				Distance = VectorMultiplyAdd(CenterY, PlaneY, Distance);
+				Distance = VectorMultiplyAdd(CenterZ, PlaneZ, Distance);
+				Distance = VectorSubtract(Distance, PlaneW);
+
+				VectorRegister PushOut = VectorMultiply(ExtentX, VectorAbs(PlaneX));
+				PushOut = VectorMultiplyAdd(ExtentY, VectorAbs(PlaneY), PushOut);
+				PushOut = VectorMultiplyAdd(ExtentZ, VectorAbs(PlaneZ), PushOut);
+
+				Outside = VectorBitwiseOr(Outside, VectorCompareGT(Distance, PushOut));
+			}
+
+			if (bDistanceCull)
+			{
+				// Primitive origins are inside their bounds, so none is closer to the view than the closest point of the child bounds
+				const VectorRegister DeltaX = VectorMax(VectorSubtract(VectorAbs(VectorSubtract(CenterX, OriginX)), ExtentX), VectorZero());
+				const VectorRegister DeltaY = VectorMax(VectorSubtract(VectorAbs(VectorSubtract(CenterY, OriginY)), ExtentY), VectorZero());
+				const VectorRegister DeltaZ = VectorMax(VectorSubtract(VectorAbs(VectorSubtract(CenterZ, OriginZ)), ExtentZ), VectorZero());
+
+				VectorRegister DistanceSquared = VectorMultiply(DeltaX, DeltaX);
+				DistanceSquared = VectorMultiplyAdd(DeltaY, DeltaY, DistanceSquared);
+				DistanceSquared = VectorMultiplyAdd(DeltaZ, DeltaZ, DistanceSquared);
+
+				const VectorRegister MaxDistance = VectorMultiplyAdd(VectorLoadAligned(Node.MaxCullDistance), DistanceScale, DistanceFade);
+				Outside = VectorBitwiseOr(Outside, VectorCompareGT(DistanceSquared, VectorMultiply(MaxDistance, MaxDistance)));
+			}
+
+			uint32 InsideMask = ~(uint32)VectorMaskBits(Outside) & ((1u << Node.NumChildren) - 1);
+			while (InsideMask)
+			{
+				const int32 ChildIndex = FMath::CountTrailingZeros(InsideMask);
+				InsideMask &= InsideMask - 1;
+
+				if (Node.bLeafChildren)
+				{
+					const int32* LeafSlots = &LeafPrimitives[(Node.FirstChild + ChildIndex) * LeafSize];
+					for (int32 SlotIndex = 0; SlotIndex < LeafSize; ++SlotIndex)
+					{
+						if (LeafSlots[SlotIndex] != INDEX_NONE)
+						{
+							AddCandidate(LeafSlots[SlotIndex]);
+						}
+					}
+				}
+				else
+				{
+					NodeStack.Add(Node.FirstChild + ChildIndex);
+				}
+			}
+		}
+	}
+
+	for (int32 PackedIndex : UnsortedPrimitives)
+	{
+		AddCandidate(PackedIndex);
+	}
+
+	return NumCandidates;
+}
@@ -0,0 +1,201 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ScenePrimitiveBVH.h: Bounding volume hierarchy over the scene primitive bounds.
+=============================================================================*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ScenePrivateBase.h"
+
+struct FConvexVolume;
+struct FPrimitiveBounds;
+
+/**
+ * Bounding volume hierarchy over FScene::PrimitiveBounds, used to reject whole groups of primitives
+ * during view frustum culling and shadow subject gathering when r.Visibility.BVH is enabled.
+ *
+ * The hierarchy is built bottom up from the primitives sorted along a Morton curve: each leaf holds
+ * LeafSize primitives and each node bounds four consecutive children, stored as structure of arrays
+ * so that the four children are tested against a plane at once.
+ *
+ * Leaves reference primitives by packed index, so the swaps done while adding and removing primitives
+ * only patch two slots. Added primitives are kept in a list that is always tested, bounds changes refit
+ * the affected leaves on the next Update(), and the hierarchy is rebuilt once too many primitives were
+ * added or removed since it was built.
+ */
+class FScenePrimitiveBVH
+{
+public:
+
+	/** Number of primitive slots in each leaf. */
+	static const int32 LeafSize = 8;
+
+	FScenePrimitiveBVH();
+
+	/** @return true if the hierarchy should be used for culling, see r.Visibility.BVH. */
+	static bool IsEnabled();
+
+	/** @return true if r.Visibility.BVH.Validate requests a comparison against the linear culling path. */
+	static bool ShouldValidate();
+
+	/** Called after a primitive was appended to the packed primitive arrays. */
+	void AddPrimitive(int32 PackedIndex);
+
+	/** Called before the last primitive of the packed primitive arrays is removed. */
+	void RemoveLastPrimitive();
+
+	/** Called after two primitives were swapped in the packed primitive arrays. */
+	void SwapPrimitives(int32 PackedIndexA, int32 PackedIndexB);
+
+	/** Called after the bounds of a primitive were updated. */
+	void UpdatePrimitiveBounds(int32 PackedIndex);
+
+	/** Discards the hierarchy, the next Update() will rebuild it. */
+	void Invalidate();
+
+	/**
+	 * Rebuilds or refits the hierarchy to match the scene primitive bounds, or releases it if r.Visibility.BVH is disabled.
+	 * Must be called on the rendering thread once the scene primitives are up to date.
+	 * @return true if the hierarchy can be queried
+	 */
+	bool Update(const TArray<FPrimitiveBounds>& PrimitiveBounds);
+
+	bool IsValid() const
+	{
+		return bValid;
+	}
+
+	/**
+	 * Finds the primitives that may pass frustum and distance culling for a view.
+	 * @param Frustum - Planes of the view frustum.
+	 * @param ViewOrigin - Origin used for distance culling.
+	 * @param MaxDrawDistanceScale - Scale applied to the MaxCullDistance of the primitives, or 0 to skip distance culling.
+	 * @param FadeRadius - Distance added to the max draw distances to keep fading primitives.
+	 * @param OutCandidates - Bit array of the size of the scene primitive arrays, the bits of the candidate primitives are set.
+	 * @return number of candidate primitives
+	 */
+	int32 FindPotentiallyVisiblePrimitives(const FConvexVolume& Frustum, const FVector& ViewOrigin, float MaxDrawDistanceScale, float FadeRadius, FSceneBitArray& OutCandidates) const;
+
+	/**
+	 * Finds the primitives in the subtrees accepted by a predicate, plus the primitives that are not in the hierarchy yet.
+	 * @param IntersectsBox - Called as IntersectsBox(Center, Extent) for the bounds of each child node and leaf.
+	 * @param OutPrimitives - Receives the packed indices of the primitives.
+	 */
+	template<typename PredicateType, typename AllocatorType>
+	void FindPrimitives(PredicateType&& IntersectsBox, TArray<int32, AllocatorType>& OutPrimitives) const;
+
+private:
+
+	/** Four child bounds, either of nodes or of leaves. */
+	MS_ALIGN(16) struct FNode
+	{
+		float CenterX[4];
+		float CenterY[4];
+		float CenterZ[4];
+		float ExtentX[4];
+		float ExtentY[4];
+		float ExtentZ[4];
+		/** Largest MaxCullDistance of the primitives below each child. */
+		float MaxCullDistance[4];
+		int32 FirstChild;
+		int32 NumChildren;
+		int32 Parent;
+		uint32 bLeafChildren;
+
+		void SetChildBounds(int32 ChildIndex, const FBox& Box, float InMaxCullDistance);
+		FBox GetChildBox(int32 ChildIndex) const;
+
+		bool IsChildEmpty(int32 ChildIndex) const
+		{
+			return ExtentX[ChildIndex] < 0.0f;
+		}
+	} GCC_ALIGN(16);
+
+	/** Computes the bounds of the primitives of a leaf, returns false if the leaf is empty. */
+	bool ComputeLeafBounds(int32 LeafIndex, const TArray<FPrimitiveBounds>& PrimitiveBounds, FBox& OutBox, float& OutMaxCullDistance) const;
+
+	/** Computes the bounds of the children of a node, returns false if all of them are empty. */
+	bool ComputeNodeBounds(const FNode& Node, FBox& OutBox, float& OutMaxCullDistance) const;
+
+	void Build(const TArray<FPrimitiveBounds>& PrimitiveBounds);
+	void Refit(const TArray<FPrimitiveBounds>& PrimitiveBounds);
+	void Release();
+
+	void SetSlotPrimitive(int32 Slot, int32 PackedIndex);
+
+	template<typename AllocatorType>
+	FORCEINLINE void AddLeafPrimitives(int32 LeafIndex, TArray<int32, AllocatorType>& OutPrimitives) const
+	{
+		const int32* LeafSlots = &LeafPrimitives[LeafIndex * LeafSize];
+		for (int32 SlotIndex = 0; SlotIndex < LeafSize; ++SlotIndex)
+		{
+			if (LeafSlots[SlotIndex] != INDEX_NONE)
+			{
+				OutPrimitives.Add(LeafSlots[SlotIndex]);
+			}
+		}
+	}
+
+	/** Slots of primitives that are not in a leaf are stored as negative values, see MakeUnsortedSlot(). */
+	static int32 MakeUnsortedSlot(int32 UnsortedIndex) { return -UnsortedIndex - 1; }
+	static int32 GetUnsortedIndex(int32 Slot) { return -Slot - 1; }
+
+	/** Nodes from the bottom level to the root, which is the last one. */
+	TArray<FNode, TAlignedHeapAllocator<16>> Nodes;
+
+	/** LeafSize packed primitive indices per leaf, INDEX_NONE for empty slots. */
+	TArray<int32> LeafPrimitives;
+
+	/** Slot in LeafPrimitives of each packed primitive, or its encoded index in UnsortedPrimitives. */
+	TArray<int32> PrimitiveSlots;
+
+	/** Primitives tested individually: primitives added since the last build and primitives too large for the leaves. */
+	TArray<int32> UnsortedPrimitives;
+
+	/** Leaves containing primitives whose bounds changed since the last refit. */
+	TBitArray<> DirtyLeaves;
+
+	int32 NumDirtyLeaves;
+	int32 NumAddedPrimitives;
+	int32 NumRemovedPrimitives;
+	bool bValid;
+};
+
+template<typename PredicateType, typename AllocatorType>
+void FScenePrimitiveBVH::FindPrimitives(PredicateType&& IntersectsBox, TArray<int32, AllocatorType>& OutPrimitives) const
+{
+	check(bValid);
+
+	if (Nodes.Num() > 0)
+	{
+		TArray<int32, TInlineAllocator<64>> NodeStack;
+		NodeStack.Add(Nodes.Num() - 1);
+
+		while (NodeStack.Num() > 0)
+		{
+			const FNode& Node = Nodes[NodeStack.Pop(false)];
+
+			for (int32 ChildIndex = 0; ChildIndex < Node.NumChildren; ++ChildIndex)
+			{
+				if (!Node.IsChildEmpty(ChildIndex)
+					&& IntersectsBox(
+						FVector(Node.CenterX[ChildIndex], Node.CenterY[ChildIndex], Node.CenterZ[ChildIndex]),
+						FVector(Node.ExtentX[ChildIndex], Node.ExtentY[ChildIndex], Node.ExtentZ[ChildIndex])))
+				{
+					if (Node.bLeafChildren)
+					{
+						AddLeafPrimitives(Node.FirstChild + ChildIndex, OutPrimitives);
+					}
+					else
+					{
+						NodeStack.Add(Node.FirstChild + ChildIndex);
+					}
+				}
+			}
+		}
+	}
+
+	OutPrimitives.Append(UnsortedPrimitives);
+}
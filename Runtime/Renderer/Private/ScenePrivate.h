@@ -40,9 +40,11 @@
 #include "MobileBasePassRendering.h"
 #include "VolumeRendering.h"
 #include "SceneSoftwareOcclusion.h"
+#include "ScenePrimitiveBVH.h"
 #include "CommonRenderResources.h"
 #include "VisualizeTexture.h"
 #include "UnifiedBuffer.h"
+#include "GPUScene.h"
 #include "LightMapDensityRendering.h"
 #include "VolumetricFogShared.h"
 #include "DebugViewModeRendering.h"
@@ -991,6 +993,9 @@ public:
 
 	class FAOScreenGridResources* AOScreenGridResources;
 
+	/** Order of the visible mesh draw commands of each pass in the previous frame, see r.MeshDrawCommands.IncrementalSort. */
+	FVisibleMeshDrawCommandSortHistory MeshDrawCommandSortHistory[EMeshPass::Num];
+
 	bool bInitializedGlobalDistanceFieldOrigins;
 	FGlobalDistanceFieldClipmapState GlobalDistanceFieldClipmapState[GMaxGlobalDistanceFieldClipmaps];
 	int32 GlobalDistanceFieldUpdateIndex;
@@ -1728,14 +1733,15 @@ public:
 	/** Indices of primitives that need to be updated in GPU Scene */
 	TArray<int32> PrimitivesToUpdate;
 
-	/** Bit array of all scene primitives. Set bit means that current primitive is in PrimitivesToUpdate array. */
-	TBitArray<> PrimitivesMarkedToUpdate;
+	/** Dirty state of all scene primitives. Primitives that aren't EPrimitiveDirtyState::None are in PrimitivesToUpdate array. */
+	TArray<EPrimitiveDirtyState> PrimitiveDirtyState;
 
 	/** GPU mirror of Primitives */
 	/** Only one of the resources(TextureBuffer or Texture2D) will be used depending on the Mobile.UseGPUSceneTexture cvar */
 	FRWBufferStructured PrimitiveBuffer;
 	FTextureRWBuffer2D PrimitiveTexture;
 	FScatterUploadBuffer PrimitiveUploadBuffer;
+	FScatterUploadBuffer PrimitiveTransformUploadBuffer;
 
 	FGrowOnlySpanAllocator	LightmapDataAllocator;
 	FRWBufferStructured		LightmapDataBuffer;
@@ -2688,6 +2694,9 @@ public:
 	/** An octree containing the primitives in the scene. */
 	FScenePrimitiveOctree PrimitiveOctree;
 
+	/** A bounding volume hierarchy over PrimitiveBounds, kept in sync with the packed primitive arrays while r.Visibility.BVH is enabled. */
+	FScenePrimitiveBVH PrimitiveBVH;
+
 	/** Indicates whether this scene requires hit proxy rendering. */
 	bool bRequiresHitProxies;
 
@@ -2746,6 +2755,19 @@ public:
 	virtual void RemovePrimitive(UPrimitiveComponent* Primitive) override;
 	virtual void ReleasePrimitive(UPrimitiveComponent* Primitive) override;
 	virtual void UpdateAllPrimitiveSceneInfos(FRHICommandListImmediate& RHICmdList, bool bAsyncCreateLPIs = false) override;
+
+	/**
+	 * Same as UpdateAllPrimitiveSceneInfos, except that primitive additions are spread across frames under the r.Scene.AddPrimitivesTimeBudgetMs budget.
+	 * Primitives over budget stay pending, they become visible once a later call added them and cached their mesh draw commands.
+	 */
+	void UpdateAllPrimitiveSceneInfosWithBudget(FRHICommandListImmediate& RHICmdList, bool bAsyncCreateLPIs = false);
+
+	/** @return number of primitives waiting to be added to the scene */
+	int32 GetNumPendingPrimitiveAdds() const
+	{
+		return AddedPrimitiveSceneInfos.Num();
+	}
+
 	virtual void UpdatePrimitiveTransform(UPrimitiveComponent* Primitive) override;
 	virtual void UpdatePrimitiveAttachment(UPrimitiveComponent* Primitive) override;
 	virtual void UpdateCustomPrimitiveData(UPrimitiveComponent* Primitive) override;
@@ -3101,6 +3123,10 @@ private:
 	void ProcessAtmosphereLightAddition_RenderThread(FLightSceneInfo* LightSceneInfo);
 
 private:
+
+	/** Processes the pending primitive updates, stopping primitive additions once AddTimeBudgetMs is spent if it is positive. */
+	void UpdateAllPrimitiveSceneInfosInternal(FRHICommandListImmediate& RHICmdList, bool bAsyncCreateLPIs, float AddTimeBudgetMs);
+
 	struct FUpdateTransformCommand
 	{
 		FBoxSphereBounds WorldBounds;
@@ -3117,6 +3143,10 @@ private:
 	TSet<FPrimitiveSceneInfo*> RemovedPrimitiveSceneInfos;
 	TSet<FPrimitiveSceneInfo*> DistanceFieldSceneDataUpdates;
 
+	/** Render thread frame in which primitives were last added with a time budget, and the time spent adding primitives in that frame. */
+	uint32 AddPrimitivesFrameNumber;
+	float AddPrimitivesTimeMs;
+
 	FAsyncTask<class FAsyncCreateLightPrimitiveInteractionsTask>* AsyncCreateLightPrimitiveInteractionsTask;
 
 	/** 
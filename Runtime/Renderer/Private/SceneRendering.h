@@ -1504,6 +1504,49 @@ struct FSortedShadowMaps
 	}
 };
 
+/**
+ * A per-object shadow of a light-primitive interaction.
+ * Everything that doesn't depend on occlusion queries is computed on task threads, the projected shadows are then created on the rendering thread.
+ */
+struct FPerObjectShadowSetup
+{
+	FLightPrimitiveInteraction* Interaction = nullptr;
+	bool bCreateTranslucentObjectShadow = false;
+	bool bCreateOpaqueObjectShadow = false;
+
+	/** Number of view dependent whole scene shadows created before the interaction's light, which the preshadow is tested against. */
+	int32 NumViewDependentWholeSceneShadows = 0;
+
+	/** The subject primitive followed by the primitives of its lighting attachment group. */
+	TArray<FPrimitiveSceneInfo*, SceneRenderingAllocator> ShadowGroupPrimitives;
+
+	/** Whether the subject is shadow relevant in each view. */
+	TArray<bool, TInlineAllocator<2> > ShadowRelevantInViews;
+	bool bShadowIsPotentiallyVisibleNextFrame = false;
+	bool bSubjectIsVisible = false;
+	bool bOpaque = false;
+	bool bTranslucentRelevance = false;
+	bool bRenderPreShadow = false;
+
+	/** Composite bounds of the shadow group, and the bounds the shadow initializer was computed from, expanded for cached preshadows. */
+	FBoxSphereBounds OriginalBounds;
+	FBoxSphereBounds Bounds;
+
+	TArray<float, TInlineAllocator<2> > ResolutionFadeAlphas;
+	TArray<float, TInlineAllocator<2> > ResolutionPreShadowFadeAlphas;
+	float MaxResolutionFadeAlpha = 0.0f;
+	float MaxResolutionPreShadowFadeAlpha = 0.0f;
+	float MaxScreenPercent = 0.0f;
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+	int32 PreShadowSizeX = 0;
+	int32 PreShadowSizeY = 0;
+
+	/** Whether the shadow hasn't completely faded away and the light provided ShadowInitializer. */
+	bool bHasShadowInitializer = false;
+	FPerObjectProjectedShadowInitializer ShadowInitializer;
+};
+
 /**
  * Used as the scope for scene rendering functions.
  * It is initialized in the game thread by FSceneViewFamily::BeginRender, and then passed to the rendering thread.
@@ -1658,23 +1701,26 @@ protected:
 		const FBoxSphereBounds& Bounds,
 		uint32 InResolutionX);
 
-	/** Creates a per object projected shadow for the given interaction. */
+	/** Creates the per object projected shadows of a setup, reading the shadow occlusion queries. */
 	void CreatePerObjectProjectedShadow(
 		FRHICommandListImmediate& RHICmdList,
-		FLightPrimitiveInteraction* Interaction,
-		bool bCreateTranslucentObjectShadow,
-		bool bCreateInsetObjectShadow,
+		const FPerObjectShadowSetup& Setup,
 		const TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& ViewDependentWholeSceneShadows,
 		TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& OutPreShadows);
 
-	/** Creates shadows for the given interaction. */
+	/** Adds the per object shadow setup of the given interaction, if it needs one. */
 	void SetupInteractionShadows(
-		FRHICommandListImmediate& RHICmdList,
 		FLightPrimitiveInteraction* Interaction,
-		FVisibleLightInfo& VisibleLightInfo,
 		bool bStaticSceneOnly,
+		int32 NumViewDependentWholeSceneShadows,
+		TArray<FPerObjectShadowSetup, SceneRenderingAllocator>& OutPerObjectShadows);
+
+	/** Computes the per object shadow setups on task threads, then creates their projected shadows. */
+	void CreatePerObjectProjectedShadows(
+		FRHICommandListImmediate& RHICmdList,
+		TArray<FPerObjectShadowSetup, SceneRenderingAllocator>& PerObjectShadows,
 		const TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& ViewDependentWholeSceneShadows,
-		TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& PreShadows);
+		TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& OutPreShadows);
 
 	/** Generates FProjectedShadowInfos for all wholesceneshadows on the given light.*/
 	void AddViewDependentWholeSceneShadowsForView(
@@ -9,10 +9,15 @@
 #include "SceneRendering.h"
 #include "DynamicPrimitiveDrawing.h"
 #include "ScenePrivate.h"
+#include "RendererModule.h"
 #include "RenderTargetTemp.h"
 #include "CanvasTypes.h"
 #include "Async/TaskGraphInterfaces.h"
+#include "Async/ParallelFor.h"
 #include "Math/Vector.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
 
 DECLARE_STATS_GROUP(TEXT("Software Occlusion"),STATGROUP_SoftwareOcclusion, STATCAT_Advanced);
 DECLARE_CYCLE_STAT(TEXT("(RT) Gather Time"),STAT_SoftwareOcclusionGather,STATGROUP_SoftwareOcclusion);
@@ -69,13 +74,47 @@ static FAutoConsoleVariableRef CVarSOVisualizeBuffer(
 	ECVF_RenderThreadSafe
 	);
 
+static int32 GSODepthBuffer = 0;
+static FAutoConsoleVariableRef CVarSODepthBuffer(
+	TEXT("r.so.DepthBuffer"),
+	GSODepthBuffer,
+	TEXT("0 = Sort triangles front to back and rasterize them into a 1-bit coverage buffer (Default)\n")
+	TEXT("1 = Rasterize occluders into a depth buffer with a min depth per 8x8 tile, occludees are tested against the tiles first"),
+	ECVF_RenderThreadSafe
+	);
+
+static int32 GSODepthBufferResolutionScale = 2;
+static FAutoConsoleVariableRef CVarSODepthBufferResolutionScale(
+	TEXT("r.so.DepthBuffer.ResolutionScale"),
+	GSODepthBufferResolutionScale,
+	TEXT("Resolution of the depth buffer as a multiple of the 384x256 coverage buffer, 1 to 4"),
+	ECVF_RenderThreadSafe
+	);
 
+static int32 GSOParallelRasterize = 1;
+static FAutoConsoleVariableRef CVarSOParallelRasterize(
+	TEXT("r.so.ParallelRasterize"),
+	GSOParallelRasterize,
+	TEXT("Rasterize the bins of the occlusion buffer in parallel"),
+	ECVF_RenderThreadSafe
+	);
 
 static const int32 BIN_WIDTH = 64;
 static const int32 BIN_NUM = 6;
 static const int32 FRAMEBUFFER_WIDTH = BIN_WIDTH*BIN_NUM;
 static const int32 FRAMEBUFFER_HEIGHT = 256;
 
+// Depth buffer mode scales the number of bins and the height
+static const int32 MAX_RESOLUTION_SCALE = 4;
+static const int32 MAX_BIN_NUM = BIN_NUM*MAX_RESOLUTION_SCALE;
+
+// Depth buffer tiles, each keeps the farthest depth of its pixels
+static const int32 HIZ_TILE_SIZE = 8;
+static const int32 HIZ_TILES_PER_BIN_ROW = BIN_WIDTH/HIZ_TILE_SIZE;
+
+// Depth of pixels no occluder was rasterized to, farther than anything on screen
+static const float EMPTY_DEPTH = -MAX_flt;
+
 namespace EScreenVertexFlags
 {
 	const uint8 None = 0;
@@ -102,10 +141,89 @@ struct FScreenTriangle
 	FScreenPosition V[3];
 };
 
+/** Buffer layout and rasterizer options of one frame, latched from the cvars when the scene is submitted */
+struct FOcclusionSettings
+{
+	int32 Width = FRAMEBUFFER_WIDTH;
+	int32 Height = FRAMEBUFFER_HEIGHT;
+	int32 NumBins = BIN_NUM;
+	bool bDepthBuffer = false;
+	bool bSIMD = true;
+	bool bParallel = true;
+};
+
+static FOcclusionSettings MakeOcclusionSettings(bool bDepthBuffer, int32 ResolutionScale, bool bSIMD, bool bParallel)
+{
+	// Coverage buffer rows are one uint64 per bin, only the depth buffer can go above the base resolution
+	const int32 Scale = bDepthBuffer ? FMath::Clamp(ResolutionScale, 1, MAX_RESOLUTION_SCALE) : 1;
+
+	FOcclusionSettings Settings;
+	Settings.Width = FRAMEBUFFER_WIDTH*Scale;
+	Settings.Height = FRAMEBUFFER_HEIGHT*Scale;
+	Settings.NumBins = BIN_NUM*Scale;
+	Settings.bDepthBuffer = bDepthBuffer;
+	Settings.bSIMD = bSIMD;
+	Settings.bParallel = bParallel;
+	return Settings;
+}
+
+/** Per pixel occluder depth, stored bin by bin so each bin can be rasterized by a different thread */
+struct FOcclusionDepthBuffer
+{
+	int32 Height = 0;
+	int32 NumBins = 0;
+	// Height rows of BIN_WIDTH depths per bin
+	TArray<float, TAlignedHeapAllocator<16>> Depth;
+	// Height/HIZ_TILE_SIZE rows of HIZ_TILES_PER_BIN_ROW farthest depths per bin
+	TArray<float> TileMinDepth;
+
+	void Init(int32 InHeight, int32 InNumBins)
+	{
+		Height = InHeight;
+		NumBins = InNumBins;
+		Depth.SetNumUninitialized(NumBins*Height*BIN_WIDTH, false);
+		TileMinDepth.SetNumUninitialized(NumBins*(Height/HIZ_TILE_SIZE)*HIZ_TILES_PER_BIN_ROW, false);
+	}
+
+	float* GetBinDepth(int32 BinIdx)
+	{
+		return Depth.GetData() + BinIdx*Height*BIN_WIDTH;
+	}
+
+	const float* GetBinDepth(int32 BinIdx) const
+	{
+		return Depth.GetData() + BinIdx*Height*BIN_WIDTH;
+	}
+
+	float* GetBinTiles(int32 BinIdx)
+	{
+		return TileMinDepth.GetData() + BinIdx*(Height/HIZ_TILE_SIZE)*HIZ_TILES_PER_BIN_ROW;
+	}
+};
+
 struct FOcclusionFrameResults
 {
+	FOcclusionSettings Settings;
 	FFramebufferBin	Bins[BIN_NUM];
+	FOcclusionDepthBuffer DepthBuffer;
 	TMap<FPrimitiveComponentId, bool> VisibilityMap;
+
+	/** Clears the results of a previous frame so the allocations can be reused */
+	void Reset()
+	{
+		FMemory::Memzero(Bins);
+		VisibilityMap.Reset();
+	}
+};
+
+/** Counters of one processed frame */
+struct FOcclusionFrameStats
+{
+	int32 NumTriangles = 0;
+	int32 NumRasterizedOccluderTris = 0;
+	int32 NumRasterizedOccludeeTris = 0;
+	int32 NumOccludees = 0;
+	int32 NumOccluded = 0;
 };
 
 struct FOcclusionMeshData
@@ -124,18 +242,34 @@ struct FSortedIndexDepth
 
 struct FOcclusionFrameData
 {
+	const int32						NumBins;
+	const int32						Height;
+
 	// binned tris
-	TArray<FSortedIndexDepth>		SortedTriangles[BIN_NUM];
+	TArray<FSortedIndexDepth>		SortedTriangles[MAX_BIN_NUM];
 	
 	// tris data	
 	TArray<FScreenTriangle>			ScreenTriangles;
 	TArray<FPrimitiveComponentId>	ScreenTrianglesPrimID;
 	TArray<uint8>					ScreenTrianglesFlags;
 
+	// per bin results, merged once all bins are rasterized
+	TArray<int32>					VisibleOccludeeTris[MAX_BIN_NUM];
+	int32							NumRasterizedOccluderTris[MAX_BIN_NUM];
+	int32							NumRasterizedOccludeeTris[MAX_BIN_NUM];
+
+	explicit FOcclusionFrameData(const FOcclusionSettings& Settings)
+		: NumBins(Settings.NumBins)
+		, Height(Settings.Height)
+	{
+		FMemory::Memzero(NumRasterizedOccluderTris);
+		FMemory::Memzero(NumRasterizedOccludeeTris);
+	}
+
 	void ReserveBuffers(int32 NumTriangles)
 	{
-		const int32 NumTrianglesPerBin = NumTriangles/BIN_NUM + 1;
-		for (int32 BinIdx = 0; BinIdx < BIN_NUM; ++BinIdx)
+		const int32 NumTrianglesPerBin = NumTriangles/NumBins + 1;
+		for (int32 BinIdx = 0; BinIdx < NumBins; ++BinIdx)
 		{
 			SortedTriangles[BinIdx].Reserve(NumTrianglesPerBin);
 		}
@@ -173,12 +307,21 @@ inline uint64 ComputeBinRowMask(int32 BinMinX, float fX0, float fX1)
 	}
 }
 
-inline void RasterizeHalf(float X0, float X1, float DX0, float DX1, int32 Row0, int32 Row1, uint64* BinData, int32 BinMinX)
+/** Same pixel range as ComputeBinRowMask(), as bin relative [OutX0, OutX1] */
+inline bool ComputeBinRowSpan(int32 BinMinX, float fX0, float fX1, int32& OutX0, int32& OutX1)
 {
-	checkSlow(Row0 <= Row1);
-	checkSlow(Row0 >= 0 && Row1 < FRAMEBUFFER_HEIGHT);
-	
-	for (int32 Row = Row0; Row <= Row1; Row++, X0+=DX0, X1+=DX1)
+	OutX0 = FMath::Max(FMath::RoundToInt(fX0) - BinMinX, 0);
+	OutX1 = FMath::Min(FMath::RoundToInt(fX1) - BinMinX, BIN_WIDTH-1);
+	return OutX0 <= OutX1;
+}
+
+/** Marks the pixels of a span as covered in a 1-bit bin */
+struct FCoverageSpanWriter
+{
+	uint64* BinData;
+	int32 BinMinX;
+
+	FORCEINLINE void operator()(int32 Row, float X0, float X1) const
 	{
 		uint64 FrameBufferMask = BinData[Row];
 		if (FrameBufferMask != ~0ull) // whether this row is already fully rasterized
@@ -190,16 +333,68 @@ inline void RasterizeHalf(float X0, float X1, float DX0, float DX1, int32 Row0,
 			}
 		}
 	}
+};
+
+/** Keeps the closest occluder depth of every pixel of a span in a depth bin */
+template<bool bSIMD>
+struct TDepthSpanWriter
+{
+	float* BinDepth;
+	int32 BinMinX;
+	float Depth;
+
+	FORCEINLINE void operator()(int32 Row, float fX0, float fX1) const
+	{
+		int32 X0, X1;
+		if (!ComputeBinRowSpan(BinMinX, fX0, fX1, X0, X1))
+		{
+			return;
+		}
+
+		float* RowDepth = BinDepth + Row*BIN_WIDTH;
+		int32 X = X0;
+		if (bSIMD)
+		{
+			for (; X <= X1 && (X & 3) != 0; ++X)
+			{
+				RowDepth[X] = FMath::Max(RowDepth[X], Depth);
+			}
+
+			const VectorRegister vDepth = VectorSetFloat1(Depth);
+			for (; X + 3 <= X1; X += 4)
+			{
+				VectorStoreAligned(VectorMax(VectorLoadAligned(RowDepth + X), vDepth), RowDepth + X);
+			}
+		}
+
+		for (; X <= X1; ++X)
+		{
+			RowDepth[X] = FMath::Max(RowDepth[X], Depth);
+		}
+	}
+};
+
+template<typename SpanWriterType>
+inline void RasterizeHalf(float X0, float X1, float DX0, float DX1, int32 Row0, int32 Row1, int32 Height, const SpanWriterType& SpanWriter)
+{
+	checkSlow(Row0 <= Row1);
+	checkSlow(Row0 >= 0 && Row1 < Height);
+	
+	for (int32 Row = Row0; Row <= Row1; Row++, X0+=DX0, X1+=DX1)
+	{
+		SpanWriter(Row, X0, X1);
+	}
 }
 
-static void RasterizeOccluderTri(const FScreenTriangle& Tri, uint64* BinData, int32 BinMinX)
+template<typename SpanWriterType>
+static void RasterizeOccluderTri(const FScreenTriangle& Tri, int32 Height, const SpanWriterType& SpanWriter)
 {
 	FScreenPosition A = Tri.V[0];
 	FScreenPosition B = Tri.V[1];
 	FScreenPosition C = Tri.V[2];
 
 	int32 RowMin = FMath::Max<int32>(A.Y, 0);
-	int32 RowMax = FMath::Min<int32>(FRAMEBUFFER_HEIGHT-1, C.Y);
+	int32 RowMax = FMath::Min<int32>(Height-1, C.Y);
 
 	bool bRasterized = false;
 
@@ -218,7 +413,7 @@ static void RasterizeOccluderTri(const FScreenTriangle& Tri, uint64* BinData, in
 		float X0 = A.X + dX0*(RowS - A.Y);
 		float X1 = A.X + dX1*(RowS - A.Y);
 		ensure(X0 <= X1);
-		RasterizeHalf(X0, X1, dX0, dX1, RowS, RowE, BinData, BinMinX);
+		RasterizeHalf(X0, X1, dX0, dX1, RowS, RowE, Height, SpanWriter);
 		bRasterized|= true;
 		RowS = RowE + 1;
 	}
@@ -236,7 +431,7 @@ static void RasterizeOccluderTri(const FScreenTriangle& Tri, uint64* BinData, in
 			Swap(X0, X1);
 			Swap(dX0, dX1);
 		}
-		RasterizeHalf(X0, X1, dX0, dX1, RowS, RowMax, BinData, BinMinX);
+		RasterizeHalf(X0, X1, dX0, dX1, RowS, RowMax, Height, SpanWriter);
 		bRasterized|= true;
 	}
 
@@ -245,7 +440,7 @@ static void RasterizeOccluderTri(const FScreenTriangle& Tri, uint64* BinData, in
 	{
 		float X0 = FMath::Min3(A.X, B.X, C.X);
 		float X1 = FMath::Max3(A.X, B.X, C.X);
-		RasterizeHalf(X0, X1, 0.0f, 0.0f, RowS, RowS, BinData, BinMinX);
+		RasterizeHalf(X0, X1, 0.0f, 0.0f, RowS, RowS, Height, SpanWriter);
 	}
 }
 
@@ -277,6 +472,118 @@ static bool RasterizeOccludeeQuad(const FScreenTriangle& Tri, uint64* BinData, i
 	return false;
 }
 
+/** Computes the farthest depth of each HIZ_TILE_SIZE square of a depth bin */
+template<bool bSIMD>
+static void BuildDepthTiles(const float* BinDepth, float* OutBinTiles, int32 Height)
+{
+	for (int32 TileY = 0; TileY < Height/HIZ_TILE_SIZE; ++TileY)
+	{
+		for (int32 TileX = 0; TileX < HIZ_TILES_PER_BIN_ROW; ++TileX)
+		{
+			const float* TileDepth = BinDepth + TileY*HIZ_TILE_SIZE*BIN_WIDTH + TileX*HIZ_TILE_SIZE;
+			float MinDepth;
+			if (bSIMD)
+			{
+				static_assert(HIZ_TILE_SIZE == 8, "Tile rows are loaded as two vectors");
+				VectorRegister vMin0 = VectorLoadAligned(TileDepth);
+				VectorRegister vMin1 = VectorLoadAligned(TileDepth + 4);
+				for (int32 Row = 1; Row < HIZ_TILE_SIZE; ++Row)
+				{
+					vMin0 = VectorMin(vMin0, VectorLoadAligned(TileDepth + Row*BIN_WIDTH));
+					vMin1 = VectorMin(vMin1, VectorLoadAligned(TileDepth + Row*BIN_WIDTH + 4));
+				}
+				vMin0 = VectorMin(vMin0, vMin1);
+				vMin0 = VectorMin(vMin0, VectorSwizzle(vMin0, 2, 3, 0, 1));
+				vMin0 = VectorMin(vMin0, VectorSwizzle(vMin0, 1, 0, 3, 2));
+				MinDepth = VectorGetComponent(vMin0, 0);
+			}
+			else
+			{
+				MinDepth = TileDepth[0];
+				for (int32 Row = 0; Row < HIZ_TILE_SIZE; ++Row)
+				{
+					for (int32 X = 0; X < HIZ_TILE_SIZE; ++X)
+					{
+						MinDepth = FMath::Min(MinDepth, TileDepth[Row*BIN_WIDTH + X]);
+					}
+				}
+			}
+			OutBinTiles[TileY*HIZ_TILES_PER_BIN_ROW + TileX] = MinDepth;
+		}
+	}
+}
+
+/** Returns true if any pixel of the occludee quad inside the bin is farther than the quad depth */
+template<bool bSIMD>
+static bool TestOccludeeQuadDepth(const FScreenTriangle& Tri, float QuadDepth, const float* BinDepth, const float* BinTiles, int32 BinMinX)
+{
+	const int32 RowMin = Tri.V[0].Y; // Quad MinY
+	const int32 RowMax = Tri.V[2].Y; // Quad MaxY
+	const int32 X0 = FMath::Max(Tri.V[0].X - BinMinX, 0);
+	const int32 X1 = FMath::Min(Tri.V[1].X - BinMinX, BIN_WIDTH - 1);
+	checkSlow(RowMin >= 0 && X0 <= X1);
+
+	for (int32 TileY = RowMin/HIZ_TILE_SIZE; TileY <= RowMax/HIZ_TILE_SIZE; ++TileY)
+	{
+		const int32 TileRow0 = TileY*HIZ_TILE_SIZE;
+		const int32 Row0 = FMath::Max(TileRow0, RowMin);
+		const int32 Row1 = FMath::Min(TileRow0 + HIZ_TILE_SIZE - 1, RowMax);
+
+		for (int32 TileX = X0/HIZ_TILE_SIZE; TileX <= X1/HIZ_TILE_SIZE; ++TileX)
+		{
+			if (BinTiles[TileY*HIZ_TILES_PER_BIN_ROW + TileX] >= QuadDepth)
+			{
+				// every pixel of the tile is occluded
+				continue;
+			}
+
+			const int32 TileX0 = TileX*HIZ_TILE_SIZE;
+			const int32 SpanX0 = FMath::Max(TileX0, X0);
+			const int32 SpanX1 = FMath::Min(TileX0 + HIZ_TILE_SIZE - 1, X1);
+			if (Row0 == TileRow0 && Row1 == TileRow0 + HIZ_TILE_SIZE - 1 && SpanX0 == TileX0 && SpanX1 == TileX0 + HIZ_TILE_SIZE - 1)
+			{
+				// quad covers the whole tile, so the farthest pixel of the tile is inside it
+				return true;
+			}
+
+			for (int32 Row = Row0; Row <= Row1; ++Row)
+			{
+				const float* RowDepth = BinDepth + Row*BIN_WIDTH;
+				int32 X = SpanX0;
+				if (bSIMD)
+				{
+					for (; X <= SpanX1 && (X & 3) != 0; ++X)
+					{
+						if (RowDepth[X] < QuadDepth)
+						{
+							return true;
+						}
+					}
+
+					const VectorRegister vQuadDepth = VectorSetFloat1(QuadDepth);
+					for (; X + 3 <= SpanX1; X += 4)
+					{
+						if (VectorAnyGreaterThan(vQuadDepth, VectorLoadAligned(RowDepth + X)))
+						{
+							return true;
+						}
+					}
+				}
+
+				for (; X <= SpanX1; ++X)
+				{
+					if (RowDepth[X] < QuadDepth)
+					{
+						return true;
+					}
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
 static bool TestFrontface(const FScreenTriangle& Tri)
 {
 	if ((Tri.V[2].X - Tri.V[0].X) * (Tri.V[1].Y - Tri.V[0].Y) >= (Tri.V[2].Y - Tri.V[0].Y) * (Tri.V[1].X - Tri.V[0].X))
@@ -295,7 +602,7 @@ inline bool AddTriangle(FScreenTriangle& Tri, float TriDepth, FPrimitiveComponen
 		if (Tri.V[1].Y > Tri.V[2].Y) Swap(Tri.V[1], Tri.V[2]);
 		if (Tri.V[0].Y > Tri.V[1].Y) Swap(Tri.V[0], Tri.V[1]);
 	
-		if (Tri.V[0].Y >= FRAMEBUFFER_HEIGHT || Tri.V[2].Y < 0)
+		if (Tri.V[0].Y >= InData.Height || Tri.V[2].Y < 0)
 		{
 			return false;
 		}
@@ -309,7 +616,7 @@ inline bool AddTriangle(FScreenTriangle& Tri, float TriDepth, FPrimitiveComponen
 	int32 MinX = FMath::Min3(Tri.V[0].X, Tri.V[1].X, Tri.V[2].X) / BIN_WIDTH; 
 	int32 MaxX = FMath::Max3(Tri.V[0].X, Tri.V[1].X, Tri.V[2].X) / BIN_WIDTH;
 	int32 BinMin = FMath::Max(MinX, 0);
-	int32 BinMax = FMath::Min(MaxX, BIN_NUM-1);
+	int32 BinMax = FMath::Min(MaxX, InData.NumBins-1);
 	
 	FSortedIndexDepth SortedIndexDepth;
 	SortedIndexDepth.Index = TriangleID;
@@ -323,7 +630,6 @@ inline bool AddTriangle(FScreenTriangle& Tri, float TriDepth, FPrimitiveComponen
 	return true;
 }
 
-static const VectorRegister vFramebufferBounds = MakeVectorRegister(FRAMEBUFFER_WIDTH-1, FRAMEBUFFER_HEIGHT-1, 1.0f, 1.0f);
 static const VectorRegister vXYHalf = MakeVectorRegister(0.5f, 0.5f, 0.0f, 0.0f);
 
 // BEGIN Intel
@@ -334,8 +640,9 @@ static const uint32 sBByInd[NUM_CUBE_VTX] = { 1, 1, 1, 1, 0, 0, 0, 0 };
 static const uint32 sBBzInd[NUM_CUBE_VTX] = { 1, 1, 0, 0, 0, 1, 1, 0 };
 // END Intel
 
-static void ProcessOccludeeGeomSIMD(const FMatrix& InMat, const FVector* InMinMax, int32 Num, int32* RESTRICT OutQuads, float* RESTRICT OutQuadDepth, int32* RESTRICT OutQuadClipped)
+static void ProcessOccludeeGeomSIMD(const FMatrix& InMat, const FVector* InMinMax, int32 Num, int32 Width, int32 Height, int32* RESTRICT OutQuads, float* RESTRICT OutQuadDepth, int32* RESTRICT OutQuadClipped)
 {
+	const VectorRegister vFramebufferBounds = MakeVectorRegister(Width-1.f, Height-1.f, 1.0f, 1.0f);
 	const float W_CLIP = InMat.M[3][2];
 	VectorRegister vClippingW = VectorLoadFloat1(&W_CLIP);
 	VectorRegister mRow0  = VectorLoadAligned(InMat.M[0]);
@@ -400,7 +707,7 @@ static void ProcessOccludeeGeomSIMD(const FMatrix& InMat, const FVector* InMinMa
 	}
 }
 
-static void ProcessOccludeeGeomScalar(const FMatrix& InMat, const FVector* InMinMax, int32 Num, int32* RESTRICT OutQuads, float* RESTRICT OutQuadDepth, int32* RESTRICT OutQuadClipped)
+static void ProcessOccludeeGeomScalar(const FMatrix& InMat, const FVector* InMinMax, int32 Num, int32 Width, int32 Height, int32* RESTRICT OutQuads, float* RESTRICT OutQuadDepth, int32* RESTRICT OutQuadClipped)
 {
 	const float W_CLIP =  InMat.M[3][2];
 	FVector4 AX = FVector4(InMat.M[0][0], InMat.M[0][1], InMat.M[0][2], InMat.M[0][3]);
@@ -461,8 +768,8 @@ static void ProcessOccludeeGeomScalar(const FMatrix& InMat, const FVector* InMin
 			// Clip against screen rect
 			MinXY.X = FMath::Max(0.f, MinXY.X);
 			MinXY.Y = FMath::Max(0.f, MinXY.Y);
-			MaxXY.X = FMath::Min(FRAMEBUFFER_WIDTH-1.f, MaxXY.X);
-			MaxXY.Y = FMath::Min(FRAMEBUFFER_HEIGHT-1.f, MaxXY.Y);
+			MaxXY.X = FMath::Min(Width-1.f, MaxXY.X);
+			MaxXY.Y = FMath::Min(Height-1.f, MaxXY.Y);
 
 			// Make MinX, MinY, MaxX, MaxY
 			OutQuads[0] = (int32)MinXY.X;
@@ -480,23 +787,26 @@ static void ProcessOccludeeGeomScalar(const FMatrix& InMat, const FVector* InMin
 	}
 }
 
-const FMatrix FramebufferMat(
-			FVector(0.5f*(float)FRAMEBUFFER_WIDTH,  0.0f,							0.0f),
-			FVector(0.0f,							0.5f*(float)FRAMEBUFFER_HEIGHT, 0.0f),
-			FVector(0.0f,							0.0f,							1.0f),
-			FVector(0.5f*(float)FRAMEBUFFER_WIDTH,	0.5f*(float)FRAMEBUFFER_HEIGHT, 0.0f)
+static FMatrix MakeFramebufferMatrix(const FOcclusionSettings& Settings)
+{
+	return FMatrix(
+			FVector(0.5f*(float)Settings.Width,	0.0f,							0.0f),
+			FVector(0.0f,						0.5f*(float)Settings.Height,	0.0f),
+			FVector(0.0f,						0.0f,							1.0f),
+			FVector(0.5f*(float)Settings.Width,	0.5f*(float)Settings.Height,	0.0f)
 		);
+}
 
-static bool ProcessOccludeeGeom(const FOcclusionSceneData& SceneData, FOcclusionFrameData& FrameData, TMap<FPrimitiveComponentId, bool>& VisibilityMap)
+static bool ProcessOccludeeGeom(const FOcclusionSceneData& SceneData, const FOcclusionSettings& Settings, FOcclusionFrameData& FrameData, TMap<FPrimitiveComponentId, bool>& VisibilityMap)
 {
 	const int32 RUN_SIZE = 512;
-	const bool bUseSIMD = GSOSIMD != 0;
+	const bool bUseSIMD = Settings.bSIMD;
 		
 	int32 NumBoxes = SceneData.OccludeeBoxMinMax.Num()/2;
 	const FVector* MinMax = SceneData.OccludeeBoxMinMax.GetData();
 	const FPrimitiveComponentId* PrimIds = SceneData.OccludeeBoxPrimId.GetData();
 
-	FMatrix WorldToFB = SceneData.ViewProj * FramebufferMat;
+	FMatrix WorldToFB = SceneData.ViewProj * MakeFramebufferMatrix(Settings);
 	
 	// on stack mem for each run output
 	MS_ALIGN(SIMD_ALIGNMENT) int32 Quads[RUN_SIZE*4] GCC_ALIGN(SIMD_ALIGNMENT);
@@ -513,11 +823,11 @@ static bool ProcessOccludeeGeom(const FOcclusionSceneData& SceneData, FOcclusion
 		// Generate quads
 		if (bUseSIMD)
 		{
-			ProcessOccludeeGeomSIMD(WorldToFB, MinMax, RunSize, Quads, QuadDepths, QuadClipFlags);
+			ProcessOccludeeGeomSIMD(WorldToFB, MinMax, RunSize, Settings.Width, Settings.Height, Quads, QuadDepths, QuadClipFlags);
 		}
 		else
 		{
-			ProcessOccludeeGeomScalar(WorldToFB, MinMax, RunSize, Quads, QuadDepths, QuadClipFlags);
+			ProcessOccludeeGeomScalar(WorldToFB, MinMax, RunSize, Settings.Width, Settings.Height, Quads, QuadDepths, QuadClipFlags);
 		}
 							
 		// Triangulate generated quads
@@ -574,13 +884,13 @@ static void CollectOccludeeGeom(const FBoxSphereBounds& Bounds, FPrimitiveCompon
 	SceneData.OccludeeBoxPrimId.Add(PrimitiveId);
 }
 
-static bool ClippedVertexToScreen(const FVector4& XFV, FScreenPosition& OutSP, float& OutDepth)
+static bool ClippedVertexToScreen(const FVector4& XFV, const FOcclusionSettings& Settings, FScreenPosition& OutSP, float& OutDepth)
 {
 	checkSlow(XFV.W >= 0.f);
 
 	FVector4 FSP = XFV / XFV.W;
-	int32 X = FMath::RoundToInt((FSP.X + 1.f) * FRAMEBUFFER_WIDTH/2.0);
-	int32 Y = FMath::RoundToInt((FSP.Y + 1.f) * FRAMEBUFFER_HEIGHT/2.0);
+	int32 X = FMath::RoundToInt((FSP.X + 1.f) * Settings.Width/2.0);
+	int32 Y = FMath::RoundToInt((FSP.Y + 1.f) * Settings.Height/2.0);
 	
 	OutSP.X = X;
 	OutSP.Y = Y;
@@ -621,7 +931,7 @@ static uint8 ProcessXFormVertex(const FVector4& XFV, float W_CLIP)
 	return Flags;
 }
 
-static void ProcessOccluderGeom(const FOcclusionSceneData& SceneData, FOcclusionFrameData& OutData)
+static void ProcessOccluderGeom(const FOcclusionSceneData& SceneData, const FOcclusionSettings& Settings, FOcclusionFrameData& OutData)
 {
 	const float W_CLIP = SceneData.ViewProj.M[3][2];
 
@@ -739,9 +1049,9 @@ static void ProcessOccluderGeom(const FOcclusionSceneData& SceneData, FOcclusion
 					float Depths[3];
 					bool bShouldDiscard = false;
 
-					bShouldDiscard|= ClippedVertexToScreen(ClippedPos[0],	Tri.V[0], Depths[0]);
-					bShouldDiscard|= ClippedVertexToScreen(ClippedPos[j-1],	Tri.V[1], Depths[1]);
-					bShouldDiscard|= ClippedVertexToScreen(ClippedPos[j],	Tri.V[2], Depths[2]);
+					bShouldDiscard|= ClippedVertexToScreen(ClippedPos[0],	Settings, Tri.V[0], Depths[0]);
+					bShouldDiscard|= ClippedVertexToScreen(ClippedPos[j-1],	Settings, Tri.V[1], Depths[1]);
+					bShouldDiscard|= ClippedVertexToScreen(ClippedPos[j],	Settings, Tri.V[2], Depths[2]);
 								
 					if (!bShouldDiscard && TestFrontface(Tri))
 					{
@@ -759,7 +1069,7 @@ static void ProcessOccluderGeom(const FOcclusionSceneData& SceneData, FOcclusion
 						
 				for (int32 j = 0; j < 3 && !bShouldDiscard; ++j)
 				{
-					bShouldDiscard|= ClippedVertexToScreen(V[j], Tri.V[j], Depths[j]);
+					bShouldDiscard|= ClippedVertexToScreen(V[j], Settings, Tri.V[j], Depths[j]);
 				}
 			
 				if (!bShouldDiscard && TestFrontface(Tri))
@@ -805,75 +1115,164 @@ public:
 	FPrimitiveComponentId CurrentPrimitiveId;
 };
 
-static void ProcessOcclusionFrame(const FOcclusionSceneData& InSceneData, FOcclusionFrameResults& OutResults)
+static void RasterizeCoverageBin(int32 BinIdx, FOcclusionFrameData& FrameData, FOcclusionFrameResults& OutResults)
+{
+	const uint8* MeshFlags = FrameData.ScreenTrianglesFlags.GetData();
+	const FScreenTriangle* Tris = FrameData.ScreenTriangles.GetData();
+	TArray<int32>& VisibleOccludeeTris = FrameData.VisibleOccludeeTris[BinIdx];
+
+	// Sort triangles in the bin by depth
+	FrameData.SortedTriangles[BinIdx].Sort([](const FSortedIndexDepth& A, const FSortedIndexDepth& B) { 
+		// biggerZ (closer) first 
+		return A.Depth > B.Depth; 
+	});
+
+	const FSortedIndexDepth* SortedTriIndices = FrameData.SortedTriangles[BinIdx].GetData();
+	const int32 NumTris = FrameData.SortedTriangles[BinIdx].Num();
+	const int32 BinMinX = BinIdx*BIN_WIDTH;
+	FFramebufferBin& Bin = OutResults.Bins[BinIdx];
+	const FCoverageSpanWriter SpanWriter = { Bin.Data, BinMinX };
+	// TODO: add a way to check when bin is already fully rasterized, so we can skip this work
+				
+	for (int32 TriIdx = 0; TriIdx < NumTris; ++TriIdx)
+	{
+		int32 TriID = SortedTriIndices[TriIdx].Index;
+		const FScreenTriangle& Tri = Tris[TriID];
+
+		if (MeshFlags[TriID] != 0)
+		{
+			// rasterize occluder
+			RasterizeOccluderTri(Tri, FrameData.Height, SpanWriter);
+			FrameData.NumRasterizedOccluderTris[BinIdx]++;
+		}
+		else
+		{
+			// rasterize occludee
+			if (RasterizeOccludeeQuad(Tri, Bin.Data, BinMinX))
+			{
+				VisibleOccludeeTris.Add(TriID);
+			}
+			FrameData.NumRasterizedOccludeeTris[BinIdx]++;
+		}
+	}
+}
+
+template<bool bSIMD>
+static void RasterizeDepthBin(int32 BinIdx, FOcclusionFrameData& FrameData, FOcclusionFrameResults& OutResults)
+{
+	const uint8* MeshFlags = FrameData.ScreenTrianglesFlags.GetData();
+	const FScreenTriangle* Tris = FrameData.ScreenTriangles.GetData();
+	const TArray<FSortedIndexDepth>& BinTriangles = FrameData.SortedTriangles[BinIdx];
+	TArray<int32>& VisibleOccludeeTris = FrameData.VisibleOccludeeTris[BinIdx];
+
+	const int32 Height = FrameData.Height;
+	const int32 BinMinX = BinIdx*BIN_WIDTH;
+	float* BinDepth = OutResults.DepthBuffer.GetBinDepth(BinIdx);
+	float* BinTiles = OutResults.DepthBuffer.GetBinTiles(BinIdx);
+
+	for (int32 Idx = 0; Idx < Height*BIN_WIDTH; ++Idx)
+	{
+		BinDepth[Idx] = EMPTY_DEPTH;
+	}
+
+	// Each pixel keeps the closest occluder, so occluders don't need to be sorted
+	for (const FSortedIndexDepth& SortedTri : BinTriangles)
+	{
+		if (MeshFlags[SortedTri.Index] != 0)
+		{
+			const TDepthSpanWriter<bSIMD> SpanWriter = { BinDepth, BinMinX, SortedTri.Depth };
+			RasterizeOccluderTri(Tris[SortedTri.Index], Height, SpanWriter);
+			FrameData.NumRasterizedOccluderTris[BinIdx]++;
+		}
+	}
+
+	BuildDepthTiles<bSIMD>(BinDepth, BinTiles, Height);
+
+	for (const FSortedIndexDepth& SortedTri : BinTriangles)
+	{
+		if (MeshFlags[SortedTri.Index] == 0)
+		{
+			if (TestOccludeeQuadDepth<bSIMD>(Tris[SortedTri.Index], SortedTri.Depth, BinDepth, BinTiles, BinMinX))
+			{
+				VisibleOccludeeTris.Add(SortedTri.Index);
+			}
+			FrameData.NumRasterizedOccludeeTris[BinIdx]++;
+		}
+	}
+}
+
+static void ProcessOcclusionFrame(const FOcclusionSceneData& InSceneData, const FOcclusionSettings& Settings, FOcclusionFrameResults& OutResults, FOcclusionFrameStats& OutStats)
 {
-	FOcclusionFrameData FrameData;
+	OutResults.Settings = Settings;
+
+	FOcclusionFrameData FrameData(Settings);
 	int32 NumExpectedTriangles = InSceneData.NumOccluderTriangles + InSceneData.OccludeeBoxPrimId.Num(); // one triangle for each occludee
 	FrameData.ReserveBuffers(NumExpectedTriangles);
 		
 	{
 		SCOPE_CYCLE_COUNTER(STAT_SoftwareOcclusionProcessOccluder)
-		ProcessOccluderGeom(InSceneData, FrameData);
+		ProcessOccluderGeom(InSceneData, Settings, FrameData);
 	}
 
 	{
 		SCOPE_CYCLE_COUNTER(STAT_SoftwareOcclusionProcessOccludee)
 		// Generate screen quads from all collected occludee bboxes
-		ProcessOccludeeGeom(InSceneData, FrameData, OutResults.VisibilityMap);
+		ProcessOccludeeGeom(InSceneData, Settings, FrameData, OutResults.VisibilityMap);
 	}
 
-	int32 NumRasterizedOccluderTris = 0;
-	int32 NumRasterizedOccludeeTris = 0;
 	{
 		SCOPE_CYCLE_COUNTER(STAT_SoftwareOcclusionRasterize);
 
+		if (Settings.bDepthBuffer)
+		{
+			OutResults.DepthBuffer.Init(Settings.Height, Settings.NumBins);
+		}
+
+		// Bins don't share pixels, each one writes only its own buffer and result lists
+		ParallelFor(Settings.NumBins, [&FrameData, &OutResults, &Settings](int32 BinIdx)
+		{
+			if (!Settings.bDepthBuffer)
+			{
+				RasterizeCoverageBin(BinIdx, FrameData, OutResults);
+			}
+			else if (Settings.bSIMD)
+			{
+				RasterizeDepthBin<true>(BinIdx, FrameData, OutResults);
+			}
+			else
+			{
+				RasterizeDepthBin<false>(BinIdx, FrameData, OutResults);
+			}
+		}, !Settings.bParallel);
+
+		// Occludees that reached the rasterizer are occluded unless a bin found them visible
 		const uint8* MeshFlags = FrameData.ScreenTrianglesFlags.GetData();
 		const FPrimitiveComponentId* PrimitiveIds = FrameData.ScreenTrianglesPrimID.GetData();
-		const FScreenTriangle* Tris = FrameData.ScreenTriangles.GetData();
-						
-		for (int32 BinIdx = 0; BinIdx < BIN_NUM; ++BinIdx)
+		for (int32 TriID = 0; TriID < FrameData.ScreenTriangles.Num(); ++TriID)
 		{
-			// Sort triangles in the bin by depth
-			FrameData.SortedTriangles[BinIdx].Sort([](const FSortedIndexDepth& A, const FSortedIndexDepth& B) { 
-				// biggerZ (closer) first 
-				return A.Depth > B.Depth; 
-			});
-
-			const FSortedIndexDepth* SortedTriIndices = FrameData.SortedTriangles[BinIdx].GetData();
-			const int32 NumTris = FrameData.SortedTriangles[BinIdx].Num();
-			const int32 BinMinX = BinIdx*BIN_WIDTH;
-			FFramebufferBin& Bin = OutResults.Bins[BinIdx];
-			// TODO: add a way to check when bin is already fully rasterized, so we can skip this work
-						
-			for (int32 TriIdx = 0; TriIdx < NumTris; ++TriIdx)
+			if (MeshFlags[TriID] == 0)
 			{
-				int32 TriID = SortedTriIndices[TriIdx].Index;
-				uint8 Flags = MeshFlags[TriID];
-				FPrimitiveComponentId PrimitiveId = PrimitiveIds[TriID];
-				const FScreenTriangle& Tri = Tris[TriID];
+				OutResults.VisibilityMap.FindOrAdd(PrimitiveIds[TriID]);
+			}
+		}
 
-				if (Flags != 0)
-				{
-					// rasterize occluder
-					RasterizeOccluderTri(Tri, Bin.Data, BinMinX);
-					NumRasterizedOccluderTris++;
-				}
-				else
-				{
-					// rasterize occludee
-					bool& VisBit = OutResults.VisibilityMap.FindOrAdd(PrimitiveId);
-					bool bVisible = RasterizeOccludeeQuad(Tri, Bin.Data, BinMinX);
-					VisBit|= bVisible;
-					NumRasterizedOccludeeTris++;
-				}
+		for (int32 BinIdx = 0; BinIdx < Settings.NumBins; ++BinIdx)
+		{
+			for (int32 TriID : FrameData.VisibleOccludeeTris[BinIdx])
+			{
+				OutResults.VisibilityMap.FindChecked(PrimitiveIds[TriID]) = true;
 			}
+			OutStats.NumRasterizedOccluderTris+= FrameData.NumRasterizedOccluderTris[BinIdx];
+			OutStats.NumRasterizedOccludeeTris+= FrameData.NumRasterizedOccludeeTris[BinIdx];
 		}
 	}
 	
-	int32 NumTotalTris = FrameData.ScreenTriangles.Num();
-	INC_DWORD_STAT_BY(STAT_SoftwareTriangles, NumTotalTris);
-	INC_DWORD_STAT_BY(STAT_SoftwareOccluderTris, NumRasterizedOccluderTris);
-	INC_DWORD_STAT_BY(STAT_SoftwareOccludeeTris, NumRasterizedOccludeeTris);
+	OutStats.NumTriangles+= FrameData.ScreenTriangles.Num();
+	for (const TPair<FPrimitiveComponentId, bool>& Pair : OutResults.VisibilityMap)
+	{
+		OutStats.NumOccludees++;
+		OutStats.NumOccluded+= Pair.Value ? 0 : 1;
+	}
 }
 
 FSceneSoftwareOcclusion::FSceneSoftwareOcclusion()
@@ -961,6 +1360,240 @@ static float ComputePotentialOccluderWeight(float ScreenSize, float DistanceSqua
 	return ScreenSize + OCCLUDER_DISTANCE_WEIGHT/DistanceSquared;
 }
 
+/**
+ * Occlusion scenes captured by r.so.Benchmark.Record or loaded by r.so.Benchmark.Load, replayed by r.so.Benchmark
+ * to compare the rasterizer configurations on the same occluders and occludees.
+ */
+static FCriticalSection GSORecordingCS;
+static TArray<TSharedPtr<FOcclusionSceneData>> GSORecordedScenes;
+static volatile int32 GSONumScenesToRecord = 0;
+
+static const uint32 SO_RECORDING_MAGIC = 0x534F5243;
+static const uint32 SO_RECORDING_VERSION = 1;
+
+static void RecordOcclusionScene(const FOcclusionSceneData& SceneData)
+{
+	if (GSONumScenesToRecord <= 0)
+	{
+		return;
+	}
+
+	FScopeLock Lock(&GSORecordingCS);
+	if (GSONumScenesToRecord > 0)
+	{
+		GSORecordedScenes.Add(MakeShared<FOcclusionSceneData>(SceneData));
+		if (--GSONumScenesToRecord == 0)
+		{
+			UE_LOG(LogRenderer, Display, TEXT("Recorded %d software occlusion scenes"), GSORecordedScenes.Num());
+		}
+	}
+}
+
+static void SerializeOcclusionScene(FArchive& Ar, FOcclusionSceneData& SceneData)
+{
+	Ar << SceneData.ViewProj;
+	Ar << SceneData.OccludeeBoxMinMax;
+
+	int32 NumOccludees = SceneData.OccludeeBoxPrimId.Num();
+	Ar << NumOccludees;
+	if (Ar.IsLoading())
+	{
+		SceneData.OccludeeBoxPrimId.SetNum(NumOccludees);
+	}
+	for (FPrimitiveComponentId& PrimId : SceneData.OccludeeBoxPrimId)
+	{
+		Ar << PrimId.PrimIDValue;
+	}
+
+	// Meshes shared by several recorded frames are written once per frame
+	int32 NumOccluders = SceneData.OccluderData.Num();
+	Ar << NumOccluders;
+	if (Ar.IsLoading())
+	{
+		SceneData.OccluderData.SetNum(NumOccluders);
+	}
+	for (FOcclusionMeshData& Mesh : SceneData.OccluderData)
+	{
+		if (Ar.IsLoading())
+		{
+			Mesh.VerticesSP = MakeShared<FOccluderVertexArray, ESPMode::ThreadSafe>();
+			Mesh.IndicesSP = MakeShared<FOccluderIndexArray, ESPMode::ThreadSafe>();
+		}
+		Ar << Mesh.LocalToWorld;
+		Ar << Mesh.PrimId.PrimIDValue;
+		Ar << *Mesh.VerticesSP;
+		Ar << *Mesh.IndicesSP;
+	}
+
+	Ar << SceneData.NumOccluderTriangles;
+}
+
+static FString GetOcclusionRecordingPath(const TArray<FString>& Args)
+{
+	const FString Name = Args.Num() > 0 ? Args[0] : FString(TEXT("Default"));
+	return FPaths::ProfilingDir() / TEXT("SoftwareOcclusion") / (Name + TEXT(".sorec"));
+}
+
+static void SaveOcclusionRecording(const TArray<FString>& Args, FOutputDevice& Ar)
+{
+	FScopeLock Lock(&GSORecordingCS);
+	const FString Filename = GetOcclusionRecordingPath(Args);
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Writer)
+	{
+		Ar.Logf(TEXT("Failed to open %s for writing"), *Filename);
+		return;
+	}
+
+	uint32 Magic = SO_RECORDING_MAGIC;
+	uint32 Version = SO_RECORDING_VERSION;
+	int32 NumScenes = GSORecordedScenes.Num();
+	*Writer << Magic << Version << NumScenes;
+	for (const TSharedPtr<FOcclusionSceneData>& SceneData : GSORecordedScenes)
+	{
+		SerializeOcclusionScene(*Writer, *SceneData);
+	}
+	Ar.Logf(TEXT("Saved %d software occlusion scenes to %s"), NumScenes, *Filename);
+}
+
+static void LoadOcclusionRecording(const TArray<FString>& Args, FOutputDevice& Ar)
+{
+	const FString Filename = GetOcclusionRecordingPath(Args);
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Filename));
+	if (!Reader)
+	{
+		Ar.Logf(TEXT("Failed to open %s"), *Filename);
+		return;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int32 NumScenes = 0;
+	*Reader << Magic << Version << NumScenes;
+	if (Magic != SO_RECORDING_MAGIC || Version != SO_RECORDING_VERSION || NumScenes < 0)
+	{
+		Ar.Logf(TEXT("%s is not a software occlusion recording of version %u"), *Filename, SO_RECORDING_VERSION);
+		return;
+	}
+
+	TArray<TSharedPtr<FOcclusionSceneData>> Scenes;
+	for (int32 SceneIdx = 0; SceneIdx < NumScenes && !Reader->IsError(); ++SceneIdx)
+	{
+		TSharedPtr<FOcclusionSceneData> SceneData = MakeShared<FOcclusionSceneData>();
+		SerializeOcclusionScene(*Reader, *SceneData);
+		Scenes.Add(SceneData);
+	}
+
+	if (Reader->IsError())
+	{
+		Ar.Logf(TEXT("Failed to read %s"), *Filename);
+		return;
+	}
+
+	FScopeLock Lock(&GSORecordingCS);
+	GSORecordedScenes = MoveTemp(Scenes);
+	Ar.Logf(TEXT("Loaded %d software occlusion scenes from %s"), NumScenes, *Filename);
+}
+
+static void RunOcclusionBenchmark(const TArray<FString>& Args, FOutputDevice& Ar)
+{
+	const int32 NumIterations = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 10;
+
+	TArray<TSharedPtr<FOcclusionSceneData>> Scenes;
+	{
+		FScopeLock Lock(&GSORecordingCS);
+		Scenes = GSORecordedScenes;
+	}
+
+	if (Scenes.Num() == 0)
+	{
+		Ar.Logf(TEXT("No software occlusion scenes, use r.so.Benchmark.Record or r.so.Benchmark.Load first"));
+		return;
+	}
+
+	struct FBenchmarkConfig
+	{
+		const TCHAR* Name;
+		bool bDepthBuffer;
+		int32 ResolutionScale;
+		bool bSIMD;
+		bool bParallel;
+	};
+
+	static const FBenchmarkConfig Configs[] =
+	{
+		{ TEXT("Coverage 384x256"),					false,	1,	true,	false },
+		{ TEXT("Coverage 384x256 parallel"),		false,	1,	true,	true },
+		{ TEXT("Depth 384x256 scalar"),				true,	1,	false,	false },
+		{ TEXT("Depth 384x256 SIMD"),				true,	1,	true,	false },
+		{ TEXT("Depth 384x256 SIMD parallel"),		true,	1,	true,	true },
+		{ TEXT("Depth 768x512 SIMD parallel"),		true,	2,	true,	true },
+		{ TEXT("Depth 1536x1024 SIMD parallel"),	true,	4,	true,	true },
+	};
+
+	Ar.Logf(TEXT("Software occlusion benchmark, %d scenes x %d iterations"), Scenes.Num(), NumIterations);
+	Ar.Logf(TEXT("%-32s %10s %12s %10s"), TEXT("Config"), TEXT("ms/frame"), TEXT("tris/ms"), TEXT("culled %"));
+
+	TUniquePtr<FOcclusionFrameResults> Results = MakeUnique<FOcclusionFrameResults>();
+	for (const FBenchmarkConfig& Config : Configs)
+	{
+		const FOcclusionSettings Settings = MakeOcclusionSettings(Config.bDepthBuffer, Config.ResolutionScale, Config.bSIMD, Config.bParallel);
+		FOcclusionFrameStats Stats;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			for (const TSharedPtr<FOcclusionSceneData>& SceneData : Scenes)
+			{
+				Results->Reset();
+				ProcessOcclusionFrame(*SceneData, Settings, *Results, Stats);
+			}
+		}
+		const double TotalMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		const int32 NumFrames = NumIterations*Scenes.Num();
+		Ar.Logf(TEXT("%-32s %10.3f %12.1f %10.1f"), Config.Name,
+			TotalMs / NumFrames,
+			TotalMs > 0.0 ? Stats.NumTriangles / TotalMs : 0.0,
+			Stats.NumOccludees > 0 ? 100.0 * Stats.NumOccluded / Stats.NumOccludees : 0.0);
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GSOBenchmarkRecordCmd(
+	TEXT("r.so.Benchmark.Record"),
+	TEXT("Records the scenes submitted to software occlusion over the next frames, replacing previous recordings. Usage: r.so.Benchmark.Record [NumFrames]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		FScopeLock Lock(&GSORecordingCS);
+		GSORecordedScenes.Reset();
+		GSONumScenesToRecord = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+		Ar.Logf(TEXT("Recording %d software occlusion scenes"), GSONumScenesToRecord);
+	}));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GSOBenchmarkSaveCmd(
+	TEXT("r.so.Benchmark.Save"),
+	TEXT("Saves the recorded software occlusion scenes to the profiling directory. Usage: r.so.Benchmark.Save [Name]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		SaveOcclusionRecording(Args, Ar);
+	}));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GSOBenchmarkLoadCmd(
+	TEXT("r.so.Benchmark.Load"),
+	TEXT("Loads software occlusion scenes saved by r.so.Benchmark.Save. Usage: r.so.Benchmark.Load [Name]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		LoadOcclusionRecording(Args, Ar);
+	}));
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice GSOBenchmarkCmd(
+	TEXT("r.so.Benchmark"),
+	TEXT("Replays the recorded software occlusion scenes with every rasterizer configuration and logs time, triangle throughput and culling rate. Usage: r.so.Benchmark [Iterations]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		RunOcclusionBenchmark(Args, Ar);
+	}));
+
 static FGraphEventRef SubmitScene(const FScene* Scene, FViewInfo& View, FOcclusionFrameResults* Results)
 {
 	int32 NumCollectedOccluders = 0;
@@ -1065,16 +1698,25 @@ static FGraphEventRef SubmitScene(const FScene* Scene, FViewInfo& View, FOcclusi
 
 	INC_DWORD_STAT_BY(STAT_SoftwareOccluders, NumCollectedOccluders);
 	INC_DWORD_STAT_BY(STAT_SoftwareOccludees, NumCollectedOccludees);
+
+	RecordOcclusionScene(*SceneData);
 	
 	// reserve space for occludees vis flags 
 	Results->VisibilityMap.Reserve(NumCollectedOccludees);
+
+	const FOcclusionSettings Settings = MakeOcclusionSettings(GSODepthBuffer != 0, GSODepthBufferResolutionScale, GSOSIMD != 0, GSOParallelRasterize != 0);
 	
 	// Submit occlusion task
 	FOcclusionSceneData* SceneDataParam = SceneData.Release();
-	return FFunctionGraphTask::CreateAndDispatchWhenReady([SceneDataParam, Results]()
+	return FFunctionGraphTask::CreateAndDispatchWhenReady([SceneDataParam, Settings, Results]()
 	{
-		ProcessOcclusionFrame(*SceneDataParam, *Results);	
+		FOcclusionFrameStats Stats;
+		ProcessOcclusionFrame(*SceneDataParam, Settings, *Results, Stats);
 		delete SceneDataParam;
+
+		INC_DWORD_STAT_BY(STAT_SoftwareTriangles, Stats.NumTriangles);
+		INC_DWORD_STAT_BY(STAT_SoftwareOccluderTris, Stats.NumRasterizedOccluderTris);
+		INC_DWORD_STAT_BY(STAT_SoftwareOccludeeTris, Stats.NumRasterizedOccludeeTris);
 	}, GET_STATID(STAT_SoftwareOcclusionProcess), NULL, GetOcclusionThreadName());
 }
 
@@ -1084,10 +1726,19 @@ int32 FSceneSoftwareOcclusion::Process(FRHICommandListImmediate& RHICmdList, con
 	FlushResults();
 
 	// Finished processing occlusion, set results as available
+	TUniquePtr<FOcclusionFrameResults> Recycled = MoveTemp(Available);
 	Available = MoveTemp(Processing);
 
-	// Submit occlusion scene for next frame
-	Processing = MakeUnique<FOcclusionFrameResults>();
+	// Submit occlusion scene for next frame, reusing the buffers of the results that are no longer needed
+	if (Recycled.IsValid())
+	{
+		Processing = MoveTemp(Recycled);
+		Processing->Reset();
+	}
+	else
+	{
+		Processing = MakeUnique<FOcclusionFrameResults>();
+	}
 	TaskRef = SubmitScene(Scene, View, Processing.Get());
 
 	// Apply available occlusion results
@@ -1143,27 +1794,38 @@ void FSceneSoftwareOcclusion::DebugDraw(FRHICommandListImmediate& RHICmdList, co
 	FCanvas Canvas(&TempRenderTarget, NULL, View.Family->CurrentRealTime, View.Family->CurrentWorldTime, View.Family->DeltaWorldTime, View.GetFeatureLevel());
 	Canvas.SetAllowSwitchVerticalAxis(true);
 	FBatchedElements* BatchedElements = Canvas.GetBatchedElements(FCanvas::ET_Line);
+
+	const int32 NumBins = Results->Settings.NumBins;
+	const int32 Height = Results->Settings.Height;
+
+	// depth buffer pixels count as occluded once any occluder was rasterized to them
+	auto IsCovered = [Results](int32 BinIdx, int32 Row, int32 X) -> bool
+	{
+		if (Results->Settings.bDepthBuffer)
+		{
+			return Results->DepthBuffer.GetBinDepth(BinIdx)[Row*BIN_WIDTH + X] > EMPTY_DEPTH;
+		}
+		return BinRowTestBit(Results->Bins[BinIdx].Data[Row], X);
+	};
 						
-	for (int32 i = 0; i < BIN_NUM; ++i)
+	for (int32 i = 0; i < NumBins; ++i)
 	{
 		int32 BinStartX = InX + i*BIN_WIDTH;
 		int32 BinStartY = InY;
 		
 		// vertical line for each bin border
-		BatchedElements->AddLine(FVector(BinStartX, BinStartY, 0.f), FVector(BinStartX, BinStartY+FRAMEBUFFER_HEIGHT, 0.f), FColor::Blue, FHitProxyId());
+		BatchedElements->AddLine(FVector(BinStartX, BinStartY, 0.f), FVector(BinStartX, BinStartY+Height, 0.f), FColor::Blue, FHitProxyId());
 						
-		const FFramebufferBin& Bin = Results->Bins[i];
-		for (int32 j = 0; j < FRAMEBUFFER_HEIGHT; ++j)
+		for (int32 j = 0; j < Height; ++j)
 		{
-			uint64 RowData = Bin.Data[j];
-			int32 BitY = (FRAMEBUFFER_HEIGHT + InY) - j; // flip image by Y axis
+			int32 BitY = (Height + InY) - j; // flip image by Y axis
 
 			FVector Pos0 = FVector(BinStartX, BitY, 0.f);
-			int32 Bit0 = BinRowTestBit(RowData, 0) ? 1 : 0;
+			int32 Bit0 = IsCovered(i, j, 0) ? 1 : 0;
 			
 			for (int32 k = 1; k < BIN_WIDTH; ++k)
 			{
-				int32 Bit1 = BinRowTestBit(RowData, k) ? 1 : 0;
+				int32 Bit1 = IsCovered(i, j, k) ? 1 : 0;
 				if (Bit0 != Bit1 || (k == (BIN_WIDTH-1)))
 				{
 					int32 BitX = BinStartX + k;
@@ -1177,9 +1839,9 @@ void FSceneSoftwareOcclusion::DebugDraw(FRHICommandListImmediate& RHICmdList, co
 	}
 	
 	// vertical line for last bin border
-	int32 BinX = InX + BIN_NUM*BIN_WIDTH;
+	int32 BinX = InX + NumBins*BIN_WIDTH;
 	int32 BinY = InY;
-	BatchedElements->AddLine(FVector(BinX, BinY, 0.f), FVector(BinX, BinY+FRAMEBUFFER_HEIGHT, 0.f), FColor::Blue, FHitProxyId());
+	BatchedElements->AddLine(FVector(BinX, BinY, 0.f), FVector(BinX, BinY+Height, 0.f), FColor::Blue, FHitProxyId());
 	
 	Canvas.Flush_RenderThread(RHICmdList);
 #endif//!(UE_BUILD_SHIPPING || UE_BUILD_TEST)
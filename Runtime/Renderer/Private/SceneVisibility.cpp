@@ -29,6 +29,7 @@
 #include "DeferredShadingRenderer.h"
 #include "DynamicPrimitiveDrawing.h"
 #include "ScenePrivate.h"
+#include "RendererModule.h"
 #include "FXSystem.h"
 #include "PostProcess/PostProcessing.h"
 #include "SceneView.h"
@@ -436,8 +437,12 @@ static FAutoConsoleVariableRef CVarFrustumCullNumWordsPerTask(
 	);
 
 
+/**
+ * Culls the scene primitives for a view, setting their bits in View.PrimitiveVisibilityMap.
+ * @param Candidates - If set, only the primitives whose bits are set are tested and the others are culled.
+ */
 template<bool UseCustomCulling, bool bAlsoUseSphereTest, bool bUseFastIntersect>
-static int32 FrustumCull(const FScene* Scene, FViewInfo& View)
+static int32 FrustumCull(const FScene* Scene, FViewInfo& View, const FSceneBitArray* Candidates)
 {
 	SCOPE_CYCLE_COUNTER(STAT_FrustumCull);
 
@@ -459,7 +464,7 @@ static int32 FrustumCull(const FScene* Scene, FViewInfo& View)
 	const int32 NumTasks = FMath::DivideAndRoundUp(BitArrayWords, FrustumCullNumWordsPerTask);
 
 	ParallelFor(NumTasks, 
-		[&NumCulledPrimitives, Scene, &View, MaxDrawDistanceScale, HLODState](int32 TaskIndex)
+		[&NumCulledPrimitives, Scene, &View, MaxDrawDistanceScale, HLODState, Candidates](int32 TaskIndex)
 		{
 			QUICK_SCOPE_CYCLE_COUNTER(STAT_FrustumCull_Loop);
 			const FPlane* PermutedPlanePtr = View.ViewFrustum.PermutedPlanes.GetData();
@@ -476,8 +481,21 @@ static int32 FrustumCull(const FScene* Scene, FViewInfo& View)
 				uint32 Mask = 0x1;
 				uint32 VisBits = 0;
 				uint32 FadingBits = 0;
+				const uint32 CandidateBits = Candidates ? Candidates->GetData()[WordIndex] : ~0u;
+				if (CandidateBits == 0)
+				{
+					STAT(NumCulledPrimitives.Add(FMath::Min<int32>(NumBitsPerDWORD, BitArrayNumInner - WordIndex * NumBitsPerDWORD)));
+					continue;
+				}
+
 				for (int32 BitSubIndex = 0; BitSubIndex < NumBitsPerDWORD && WordIndex * NumBitsPerDWORD + BitSubIndex < BitArrayNumInner; BitSubIndex++, Mask <<= 1)
 				{
+					if (!(CandidateBits & Mask))
+					{
+						STAT(NumCulledPrimitives.Increment());
+						continue;
+					}
+
 					int32 Index = WordIndex * NumBitsPerDWORD + BitSubIndex;
 					const FPrimitiveBounds& Bounds = Scene->PrimitiveBounds[Index];
 					float DistanceSquared = (Bounds.BoxSphereBounds.Origin - ViewOriginForDistanceCulling).SizeSquared();
@@ -3521,6 +3539,79 @@ static TAutoConsoleVariable<int32> CVarUseFastIntersect(
 );
 
 
+static int32 FrustumCull(const FScene* Scene, FViewInfo& View, bool bUseCustomCulling, const FSceneBitArray* Candidates)
+{
+	const bool bUseFastIntersect = (View.ViewFrustum.PermutedPlanes.Num() == 8) && CVarUseFastIntersect.GetValueOnRenderThread();
+	if (bUseCustomCulling)
+	{
+		if (CVarAlsoUseSphereForFrustumCull.GetValueOnRenderThread())
+		{
+			return bUseFastIntersect ? FrustumCull<true, true, true>(Scene, View, Candidates) : FrustumCull<true, true, false>(Scene, View, Candidates);
+		}
+		else
+		{
+			return bUseFastIntersect ? FrustumCull<true, false, true>(Scene, View, Candidates) : FrustumCull<true, false, false>(Scene, View, Candidates);
+		}
+	}
+	else
+	{
+		if (CVarAlsoUseSphereForFrustumCull.GetValueOnRenderThread())
+		{
+			return bUseFastIntersect ? FrustumCull<false, true, true>(Scene, View, Candidates) : FrustumCull<false, true, false>(Scene, View, Candidates);
+		}
+		else
+		{
+			return bUseFastIntersect ? FrustumCull<false, false, true>(Scene, View, Candidates) : FrustumCull<false, false, false>(Scene, View, Candidates);
+		}
+	}
+}
+
+/**
+ * Culls the view against the scene primitive BVH first, then tests the primitives of the subtrees that were not rejected as the linear path does.
+ * With r.Visibility.BVH.Validate the view is culled again linearly and the primitives whose visibility differs are logged.
+ */
+static int32 FrustumCullWithBVH(const FScene* Scene, FViewInfo& View, bool bUseCustomCulling)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FrustumCullWithBVH);
+
+	// Subtrees are only rejected by distance when no primitive can have its max draw distance overridden
+	const bool bDistanceCull = !View.Family->EngineShowFlags.DistanceCulledPrimitives && !Scene->SceneLODHierarchy.IsActive();
+	const float MaxDrawDistanceScale = GetCachedScalabilityCVars().ViewDistanceScale * GetCachedScalabilityCVars().CalculateFieldOfViewDistanceScale(View.DesiredFOV);
+	const float FadeRadius = GDisableLODFade ? 0.0f : GDistanceFadeMaxTravel;
+
+	FSceneBitArray Candidates;
+	Candidates.Init(false, View.PrimitiveVisibilityMap.Num());
+	Scene->PrimitiveBVH.FindPotentiallyVisiblePrimitives(View.ViewFrustum, View.ViewMatrices.GetViewOrigin(), bDistanceCull ? MaxDrawDistanceScale : 0.0f, FadeRadius, Candidates);
+
+	int32 NumCulledPrimitivesForView = FrustumCull(Scene, View, bUseCustomCulling, &Candidates);
+
+	if (FScenePrimitiveBVH::ShouldValidate())
+	{
+		const FSceneBitArray BVHVisibilityMap = View.PrimitiveVisibilityMap;
+		const FSceneBitArray BVHFadingMap = View.PotentiallyFadingPrimitiveMap;
+
+		View.PrimitiveVisibilityMap.Init(false, BVHVisibilityMap.Num());
+		View.PotentiallyFadingPrimitiveMap.Init(false, BVHFadingMap.Num());
+		NumCulledPrimitivesForView = FrustumCull(Scene, View, bUseCustomCulling, nullptr);
+
+		int32 NumMismatches = 0;
+		const int32 NumWords = FMath::DivideAndRoundUp(BVHVisibilityMap.Num(), (int32)NumBitsPerDWORD);
+		for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+		{
+			const uint32 Mismatches = (BVHVisibilityMap.GetData()[WordIndex] ^ View.PrimitiveVisibilityMap.GetData()[WordIndex])
+				| (BVHFadingMap.GetData()[WordIndex] ^ View.PotentiallyFadingPrimitiveMap.GetData()[WordIndex]);
+			NumMismatches += FMath::CountBits(Mismatches);
+		}
+
+		if (NumMismatches > 0)
+		{
+			UE_LOG(LogRenderer, Warning, TEXT("Primitive BVH culling differs from linear culling for %d of %d primitives, keeping the linear results"), NumMismatches, BVHVisibilityMap.Num());
+		}
+	}
+
+	return NumCulledPrimitivesForView;
+}
+
 void UpdateReflectionSceneData(FScene* Scene)
 {
 	QUICK_SCOPE_CYCLE_COUNTER(STAT_UpdateReflectionSceneData)
@@ -3679,6 +3770,12 @@ void FSceneRenderer::ComputeViewVisibility(FRHICommandListImmediate& RHICmdList,
 	const bool bIsInstancedStereo = (Views.Num() > 0) ? (Views[0].IsInstancedStereoPass() || Views[0].bIsMobileMultiViewEnabled) : false;
 	UpdateReflectionSceneData(Scene);
 
+	bool bUsePrimitiveBVH = false;
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_ViewVisibilityTime_UpdatePrimitiveBVH);
+		bUsePrimitiveBVH = Scene->PrimitiveBVH.Update(Scene->PrimitiveBounds);
+	}
+
 	{
 		QUICK_SCOPE_CYCLE_COUNTER(STAT_ViewVisibilityTime_ConditionalUpdateStaticMeshesWithoutVisibilityCheck);
 		SCOPED_NAMED_EVENT(FSceneRenderer_ConditionalUpdateStaticMeshes, FColor::Red);
@@ -3831,29 +3928,15 @@ void FSceneRenderer::ComputeViewVisibility(FRHICommandListImmediate& RHICmdList,
 				HLODTree.ClearVisibilityState(View);
 			}
 
+			const bool bUseCustomCulling = View.CustomVisibilityQuery && View.CustomVisibilityQuery->Prepare();
 			int32 NumCulledPrimitivesForView;
-			const bool bUseFastIntersect = (View.ViewFrustum.PermutedPlanes.Num() == 8) && CVarUseFastIntersect.GetValueOnRenderThread();
-			if (View.CustomVisibilityQuery && View.CustomVisibilityQuery->Prepare())
+			if (bUsePrimitiveBVH)
 			{
-				if (CVarAlsoUseSphereForFrustumCull.GetValueOnRenderThread())
-				{
-					NumCulledPrimitivesForView = bUseFastIntersect ? FrustumCull<true, true, true>(Scene, View) : FrustumCull<true, true, false>(Scene, View);
-				}
-				else
-				{
-					NumCulledPrimitivesForView = bUseFastIntersect ? FrustumCull<true, false, true>(Scene, View) : FrustumCull<true, false, false>(Scene, View);
-				}
+				NumCulledPrimitivesForView = FrustumCullWithBVH(Scene, View, bUseCustomCulling);
 			}
 			else
 			{
-				if (CVarAlsoUseSphereForFrustumCull.GetValueOnRenderThread())
-				{
-					NumCulledPrimitivesForView = bUseFastIntersect ? FrustumCull<false, true, true>(Scene, View) : FrustumCull<false, true, false>(Scene, View);
-				}
-				else
-				{
-					NumCulledPrimitivesForView = bUseFastIntersect ? FrustumCull<false, false, true>(Scene, View) : FrustumCull<false, false, false>(Scene, View);
-				}
+				NumCulledPrimitivesForView = FrustumCull(Scene, View, bUseCustomCulling, nullptr);
 			}
 			STAT(NumCulledPrimitives += NumCulledPrimitivesForView);
 			UpdatePrimitiveFading(Scene, View);			
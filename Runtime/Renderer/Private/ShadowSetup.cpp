@@ -238,6 +238,18 @@ static TAutoConsoleVariable<int32> CVarParallelGatherNumPrimitivesPerPacket(
 	ECVF_RenderThreadSafe
 	);
 
+static TAutoConsoleVariable<int32> CVarParallelShadowSetup(
+	TEXT("r.Shadow.ParallelSetup"),
+	1,
+	TEXT("Whether to set up per-object shadows, cascades and shadow view relevance on task threads. Occlusion queries are still read on the rendering thread. 0 = off; 1 = on"),
+	ECVF_RenderThreadSafe
+	);
+
+static bool ShouldSetupShadowsInParallel()
+{
+	return FApp::ShouldUseThreadingForPerformance() && CVarParallelShadowSetup.GetValueOnRenderThread() > 0;
+}
+
 int32 GUseOctreeForShadowCulling = 1;
 FAutoConsoleVariableRef CVarUseOctreeForShadowCulling(
 	TEXT("r.Shadow.UseOctreeForCulling"),
@@ -1697,18 +1709,15 @@ bool ShouldCreateObjectShadowForStationaryLight(const FLightSceneInfo* LightScen
 }
 
 void FSceneRenderer::SetupInteractionShadows(
-	FRHICommandListImmediate& RHICmdList,
 	FLightPrimitiveInteraction* Interaction, 
-	FVisibleLightInfo& VisibleLightInfo, 
 	bool bStaticSceneOnly,
-	const TArray<FProjectedShadowInfo*,SceneRenderingAllocator>& ViewDependentWholeSceneShadows,
-	TArray<FProjectedShadowInfo*,SceneRenderingAllocator>& PreShadows)
+	int32 NumViewDependentWholeSceneShadows,
+	TArray<FPerObjectShadowSetup, SceneRenderingAllocator>& OutPerObjectShadows)
 {
 	// too high on hit count to leave on
 	// SCOPE_CYCLE_COUNTER(STAT_SetupInteractionShadows);
 
 	FPrimitiveSceneInfo* PrimitiveSceneInfo = Interaction->GetPrimitiveSceneInfo();
-	FLightSceneProxy* LightProxy = Interaction->GetLight()->Proxy;
 	extern bool GUseTranslucencyShadowDepths;
 
 	bool bShadowHandledByParent = false;
@@ -1732,35 +1741,62 @@ void FSceneRenderer::SetupInteractionShadows(
 			&& (!bStaticSceneOnly || PrimitiveSceneInfo->Proxy->HasStaticLighting())
 			&& (bCreateTranslucentObjectShadow || bCreateInsetObjectShadow || bCreateObjectShadowForStationaryLight))
 		{
-			// Create projected shadow infos
-			CreatePerObjectProjectedShadow(RHICmdList, Interaction, bCreateTranslucentObjectShadow, bCreateInsetObjectShadow || bCreateObjectShadowForStationaryLight, ViewDependentWholeSceneShadows, PreShadows);
+			// The projected shadow infos are created once the setups of all lights have been computed
+			FPerObjectShadowSetup& Setup = OutPerObjectShadows.AddDefaulted_GetRef();
+			Setup.Interaction = Interaction;
+			Setup.bCreateTranslucentObjectShadow = bCreateTranslucentObjectShadow;
+			Setup.bCreateOpaqueObjectShadow = bCreateInsetObjectShadow || bCreateObjectShadowForStationaryLight;
+			Setup.NumViewDependentWholeSceneShadows = NumViewDependentWholeSceneShadows;
+
+			// Gathered here as the scene rendering allocator can only be used on the rendering thread
+			PrimitiveSceneInfo->GatherLightingAttachmentGroupPrimitives(Setup.ShadowGroupPrimitives);
 		}
 	}
 }
 
-void FSceneRenderer::CreatePerObjectProjectedShadow(
-	FRHICommandListImmediate& RHICmdList,
-	FLightPrimitiveInteraction* Interaction, 
-	bool bCreateTranslucentObjectShadow, 
-	bool bCreateOpaqueObjectShadow,
-	const TArray<FProjectedShadowInfo*,SceneRenderingAllocator>& ViewDependentWholeSceneShadows,
-	TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& OutPreShadows)
+/** Shadowing constants of per-object shadows, read on the rendering thread before the setups are computed on task threads. */
+struct FPerObjectShadowConstants
+{
+	FIntPoint ShadowBufferResolution;
+	uint32 MaxShadowResolution;
+	uint32 MaxShadowResolutionY;
+	uint32 MinShadowResolution;
+	uint32 ShadowFadeResolution;
+	uint32 MinPreShadowResolution;
+	uint32 PreShadowFadeResolution;
+	float ShadowTexelsPerPixel;
+	float PreShadowResolutionFactor;
+	float PreshadowExpandFraction;
+	bool bAllowPreshadows;
+	bool bCachePreshadows;
+
+	explicit FPerObjectShadowConstants(FSceneRenderTargets& SceneContext)
+	{
+		const uint32 MaxShadowResolutionSetting = GetCachedScalabilityCVars().MaxShadowResolution;
+		ShadowBufferResolution = SceneContext.GetShadowDepthTextureResolution();
+		MaxShadowResolution = FMath::Min<int32>(MaxShadowResolutionSetting, ShadowBufferResolution.X) - SHADOW_BORDER * 2;
+		MaxShadowResolutionY = FMath::Min<int32>(MaxShadowResolutionSetting, ShadowBufferResolution.Y) - SHADOW_BORDER * 2;
+		MinShadowResolution = FMath::Max<int32>(0, CVarMinShadowResolution.GetValueOnRenderThread());
+		ShadowFadeResolution = FMath::Max<int32>(0, CVarShadowFadeResolution.GetValueOnRenderThread());
+		MinPreShadowResolution = FMath::Max<int32>(0, CVarMinPreShadowResolution.GetValueOnRenderThread());
+		PreShadowFadeResolution = FMath::Max<int32>(0, CVarPreShadowFadeResolution.GetValueOnRenderThread());
+		ShadowTexelsPerPixel = CVarShadowTexelsPerPixel.GetValueOnRenderThread();
+		PreShadowResolutionFactor = CVarPreShadowResolutionFactor.GetValueOnRenderThread();
+		PreshadowExpandFraction = FMath::Max(CVarPreshadowExpandFraction.GetValueOnRenderThread(), 0.0f);
+		bAllowPreshadows = CVarAllowPreshadows.GetValueOnRenderThread() != 0;
+		bCachePreshadows = ShouldUseCachePreshadows();
+	}
+};
+
+/** Computes everything about a per-object shadow that doesn't depend on occlusion queries. Only reads scene and view data, so it can run on any thread. */
+static void ComputePerObjectShadowSetup(const TArray<FViewInfo>& Views, const FPerObjectShadowConstants& Constants, FPerObjectShadowSetup& Setup)
 {
-	check(bCreateOpaqueObjectShadow || bCreateTranslucentObjectShadow);
+	FLightPrimitiveInteraction* Interaction = Setup.Interaction;
 	FPrimitiveSceneInfo* PrimitiveSceneInfo = Interaction->GetPrimitiveSceneInfo();
 	const int32 PrimitiveId = PrimitiveSceneInfo->GetIndex();
+	const FLightSceneInfo* LightSceneInfo = Interaction->GetLight();
 
-	FLightSceneInfo* LightSceneInfo = Interaction->GetLight();
-	FVisibleLightInfo& VisibleLightInfo = VisibleLightInfos[LightSceneInfo->Id];
-
-	// Check if the shadow is visible in any of the views.
-	bool bShadowIsPotentiallyVisibleNextFrame = false;
-	bool bOpaqueShadowIsVisibleThisFrame = false;
-	bool bSubjectIsVisible = false;
-	bool bOpaque = false;
-	bool bTranslucentRelevance = false;
-	bool bTranslucentShadowIsVisibleThisFrame = false;
-	int32 NumBufferedFrames = FOcclusionQueryHelpers::GetNumBufferedFrames(FeatureLevel);
+	Setup.ShadowRelevantInViews.Init(false, Views.Num());
 
 	for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
 	{
@@ -1775,52 +1811,28 @@ void FSceneRenderer::CreatePerObjectProjectedShadow(
 			ViewRelevance = PrimitiveSceneInfo->Proxy->GetViewRelevance(&View);
 		}
 
-		// Check if the subject primitive is shadow relevant.
-		const bool bPrimitiveIsShadowRelevant = ViewRelevance.bShadowRelevance;
-
-		const FSceneViewState::FProjectedShadowKey OpaqueKey(PrimitiveSceneInfo->PrimitiveComponentId, LightSceneInfo->Proxy->GetLightComponent(), INDEX_NONE, false);
-
-		// Check if the shadow and preshadow are occluded.
-		const bool bOpaqueShadowIsOccluded = 
-			!bCreateOpaqueObjectShadow ||
-			(
-				!View.bIgnoreExistingQueries &&	View.State &&
-				((FSceneViewState*)View.State)->IsShadowOccluded(RHICmdList, OpaqueKey, NumBufferedFrames)
-			);
-
-		const FSceneViewState::FProjectedShadowKey TranslucentKey(PrimitiveSceneInfo->PrimitiveComponentId, LightSceneInfo->Proxy->GetLightComponent(), INDEX_NONE, true);
-
-		const bool bTranslucentShadowIsOccluded = 
-			!bCreateTranslucentObjectShadow ||
-			(
-				!View.bIgnoreExistingQueries && View.State &&
-				((FSceneViewState*)View.State)->IsShadowOccluded(RHICmdList, TranslucentKey, NumBufferedFrames)
-			);
-
 		// if subject doesn't render in the main pass, it's never considered visible
 		// (in this case, there will be no need to generate any preshadows for the subject)
 		if (PrimitiveSceneInfo->Proxy->ShouldRenderInMainPass())
 		{
-			const bool bSubjectIsVisibleInThisView = View.PrimitiveVisibilityMap[PrimitiveSceneInfo->GetIndex()];
-			bSubjectIsVisible |= bSubjectIsVisibleInThisView;
+			const bool bSubjectIsVisibleInThisView = View.PrimitiveVisibilityMap[PrimitiveId];
+			Setup.bSubjectIsVisible |= bSubjectIsVisibleInThisView;
 		}
 
-		// The shadow is visible if it is view relevant and unoccluded.
-		bOpaqueShadowIsVisibleThisFrame |= (bPrimitiveIsShadowRelevant && !bOpaqueShadowIsOccluded);
-		bTranslucentShadowIsVisibleThisFrame |= (bPrimitiveIsShadowRelevant && !bTranslucentShadowIsOccluded);
-		bShadowIsPotentiallyVisibleNextFrame |= bPrimitiveIsShadowRelevant;
-		bOpaque |= ViewRelevance.bOpaque;
-		bTranslucentRelevance |= ViewRelevance.HasTranslucency();
+		// Check if the subject primitive is shadow relevant.
+		Setup.ShadowRelevantInViews[ViewIndex] = ViewRelevance.bShadowRelevance;
+		Setup.bShadowIsPotentiallyVisibleNextFrame |= ViewRelevance.bShadowRelevance;
+		Setup.bOpaque |= ViewRelevance.bOpaque;
+		Setup.bTranslucentRelevance |= ViewRelevance.HasTranslucency();
 	}
 
-	if (!bOpaqueShadowIsVisibleThisFrame && !bTranslucentShadowIsVisibleThisFrame && !bShadowIsPotentiallyVisibleNextFrame)
+	if (!Setup.bShadowIsPotentiallyVisibleNextFrame)
 	{
 		// Don't setup the shadow info for shadows which don't need to be rendered or occlusion tested.
 		return;
 	}
 
-	TArray<FPrimitiveSceneInfo*, SceneRenderingAllocator> ShadowGroupPrimitives;
-	PrimitiveSceneInfo->GatherLightingAttachmentGroupPrimitives(ShadowGroupPrimitives);
+	const TArray<FPrimitiveSceneInfo*, SceneRenderingAllocator>& ShadowGroupPrimitives = Setup.ShadowGroupPrimitives;
 
 #if ENABLE_NAN_DIAGNOSTIC
 	// allow for silent failure: only possible if NaN checking is enabled.  
@@ -1855,26 +1867,10 @@ void FSceneRenderer::CreatePerObjectProjectedShadow(
 		}
 	}
 
-	FSceneRenderTargets& SceneContext = FSceneRenderTargets::Get(RHICmdList);
-	
-	// Shadowing constants.
-	
-	const uint32 MaxShadowResolutionSetting = GetCachedScalabilityCVars().MaxShadowResolution;
-	const FIntPoint ShadowBufferResolution = SceneContext.GetShadowDepthTextureResolution();
-	const uint32 MaxShadowResolution = FMath::Min<int32>(MaxShadowResolutionSetting, ShadowBufferResolution.X) - SHADOW_BORDER * 2;
-	const uint32 MaxShadowResolutionY = FMath::Min<int32>(MaxShadowResolutionSetting, ShadowBufferResolution.Y) - SHADOW_BORDER * 2;
-	const uint32 MinShadowResolution     = FMath::Max<int32>(0, CVarMinShadowResolution.GetValueOnRenderThread());
-	const uint32 ShadowFadeResolution    = FMath::Max<int32>(0, CVarShadowFadeResolution.GetValueOnRenderThread());
-	const uint32 MinPreShadowResolution  = FMath::Max<int32>(0, CVarMinPreShadowResolution.GetValueOnRenderThread());
-	const uint32 PreShadowFadeResolution = FMath::Max<int32>(0, CVarPreShadowFadeResolution.GetValueOnRenderThread());
-	
+	Setup.OriginalBounds = OriginalBounds;
+
 	// Compute the maximum resolution required for the shadow by any view. Also keep track of the unclamped resolution for fading.
 	uint32 MaxDesiredResolution = 0;
-	float MaxScreenPercent = 0;
-	TArray<float, TInlineAllocator<2> > ResolutionFadeAlphas;
-	TArray<float, TInlineAllocator<2> > ResolutionPreShadowFadeAlphas;
-	float MaxResolutionFadeAlpha = 0;
-	float MaxResolutionPreShadowFadeAlpha = 0;
 
 	for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
 	{
@@ -1896,20 +1892,20 @@ void FSceneRenderer::CreatePerObjectProjectedShadow(
 			OriginalBounds.SphereRadius /
 			FMath::Max(ShadowViewDistFromBounds, 1.0f);
 
-		MaxScreenPercent = FMath::Max(MaxScreenPercent, ScreenPercent);
+		Setup.MaxScreenPercent = FMath::Max(Setup.MaxScreenPercent, ScreenPercent);
 
 		// Determine the amount of shadow buffer resolution needed for this view.
-		const float UnclampedResolution = ScreenRadius * CVarShadowTexelsPerPixel.GetValueOnRenderThread();
+		const float UnclampedResolution = ScreenRadius * Constants.ShadowTexelsPerPixel;
 
 		// Calculate fading based on resolution
 		// Compute FadeAlpha before ShadowResolutionScale contribution (artists want to modify the softness of the shadow, not change the fade ranges)
-		const float ViewSpecificAlpha = CalculateShadowFadeAlpha(UnclampedResolution, ShadowFadeResolution, MinShadowResolution) * LightSceneInfo->Proxy->GetShadowAmount();
-		MaxResolutionFadeAlpha = FMath::Max(MaxResolutionFadeAlpha, ViewSpecificAlpha);
-		ResolutionFadeAlphas.Add(ViewSpecificAlpha);
+		const float ViewSpecificAlpha = CalculateShadowFadeAlpha(UnclampedResolution, Constants.ShadowFadeResolution, Constants.MinShadowResolution) * LightSceneInfo->Proxy->GetShadowAmount();
+		Setup.MaxResolutionFadeAlpha = FMath::Max(Setup.MaxResolutionFadeAlpha, ViewSpecificAlpha);
+		Setup.ResolutionFadeAlphas.Add(ViewSpecificAlpha);
 
-		const float ViewSpecificPreShadowAlpha = CalculateShadowFadeAlpha(UnclampedResolution * CVarPreShadowResolutionFactor.GetValueOnRenderThread(), PreShadowFadeResolution, MinPreShadowResolution) * LightSceneInfo->Proxy->GetShadowAmount();
-		MaxResolutionPreShadowFadeAlpha = FMath::Max(MaxResolutionPreShadowFadeAlpha, ViewSpecificPreShadowAlpha);
-		ResolutionPreShadowFadeAlphas.Add(ViewSpecificPreShadowAlpha);
+		const float ViewSpecificPreShadowAlpha = CalculateShadowFadeAlpha(UnclampedResolution * Constants.PreShadowResolutionFactor, Constants.PreShadowFadeResolution, Constants.MinPreShadowResolution) * LightSceneInfo->Proxy->GetShadowAmount();
+		Setup.MaxResolutionPreShadowFadeAlpha = FMath::Max(Setup.MaxResolutionPreShadowFadeAlpha, ViewSpecificPreShadowAlpha);
+		Setup.ResolutionPreShadowFadeAlphas.Add(ViewSpecificPreShadowAlpha);
 
 		const float ShadowResolutionScale = LightSceneInfo->Proxy->GetShadowResolutionScale();
 
@@ -1921,7 +1917,7 @@ void FSceneRenderer::CreatePerObjectProjectedShadow(
 			ClampedResolution *= ShadowResolutionScale;
 		}
 
-		ClampedResolution = FMath::Min<float>(ClampedResolution, MaxShadowResolution);
+		ClampedResolution = FMath::Min<float>(ClampedResolution, Constants.MaxShadowResolution);
 
 		if (ShadowResolutionScale <= 1.0f)
 		{
@@ -1934,221 +1930,322 @@ void FSceneRenderer::CreatePerObjectProjectedShadow(
 			MaxDesiredResolution,
 			FMath::Max<uint32>(
 				ClampedResolution,
-				FMath::Min<int32>(MinShadowResolution, ShadowBufferResolution.X - SHADOW_BORDER * 2)
+				FMath::Min<int32>(Constants.MinShadowResolution, Constants.ShadowBufferResolution.X - SHADOW_BORDER * 2)
 				)
 			);
 	}
 
 	FBoxSphereBounds Bounds = OriginalBounds;
 
-	const bool bRenderPreShadow = 
-		CVarAllowPreshadows.GetValueOnRenderThread() 
+	Setup.bRenderPreShadow = 
+		Constants.bAllowPreshadows
 		&& LightSceneInfo->Proxy->HasStaticShadowing()
 		// Preshadow only affects the subject's pixels
-		&& bSubjectIsVisible 
+		&& Setup.bSubjectIsVisible 
 		// Only objects with dynamic lighting should create a preshadow
 		// Unless we're in the editor and need to preview an object without built lighting
 		&& (!PrimitiveSceneInfo->Proxy->HasStaticLighting() || !Interaction->IsShadowMapped())
 		// Disable preshadows from directional lights for primitives that use single sample shadowing, the shadow factor will be written into the precomputed shadow mask in the GBuffer instead
 		&& !(PrimitiveSceneInfo->Proxy->UseSingleSampleShadowFromStationaryLights() && LightSceneInfo->Proxy->GetLightType() == LightType_Directional);
 
-	if (bRenderPreShadow && ShouldUseCachePreshadows())
+	if (Setup.bRenderPreShadow && Constants.bCachePreshadows)
 	{
-		float PreshadowExpandFraction = FMath::Max(CVarPreshadowExpandFraction.GetValueOnRenderThread(), 0.0f);
-
 		// If we're creating a preshadow, expand the bounds somewhat so that the preshadow will be cached more often as the shadow caster moves around.
 		//@todo - only expand the preshadow bounds for this, not the per object shadow.
-		Bounds.SphereRadius += (Bounds.BoxExtent * PreshadowExpandFraction).Size();
-		Bounds.BoxExtent *= PreshadowExpandFraction + 1.0f;
+		Bounds.SphereRadius += (Bounds.BoxExtent * Constants.PreshadowExpandFraction).Size();
+		Bounds.BoxExtent *= Constants.PreshadowExpandFraction + 1.0f;
 	}
 
+	Setup.Bounds = Bounds;
+
 	// Compute the projected shadow initializer for this primitive-light pair.
-	FPerObjectProjectedShadowInitializer ShadowInitializer;
+	Setup.bHasShadowInitializer = (Setup.MaxResolutionFadeAlpha > 1.0f / 256.0f || (Setup.bRenderPreShadow && Setup.MaxResolutionPreShadowFadeAlpha > 1.0f / 256.0f))
+		&& LightSceneInfo->Proxy->GetPerObjectProjectedShadowInitializer(Bounds, Setup.ShadowInitializer);
 
-	if ((MaxResolutionFadeAlpha > 1.0f / 256.0f || (bRenderPreShadow && MaxResolutionPreShadowFadeAlpha > 1.0f / 256.0f))
-		&& LightSceneInfo->Proxy->GetPerObjectProjectedShadowInitializer(Bounds, ShadowInitializer))
+	if (Setup.bHasShadowInitializer)
 	{
-		const float MaxFadeAlpha = MaxResolutionFadeAlpha;
-
-		// Only create a shadow from this object if it hasn't completely faded away
-		if (CVarAllowPerObjectShadows.GetValueOnRenderThread() && MaxFadeAlpha > 1.0f / 256.0f)
+		if (Setup.MaxResolutionFadeAlpha > 1.0f / 256.0f)
 		{
 			// Round down to the nearest power of two so that resolution changes are always doubling or halving the resolution, which increases filtering stability
 			// Use the max resolution if the desired resolution is larger than that
-			const int32 SizeX = MaxDesiredResolution >= MaxShadowResolution ? MaxShadowResolution : (1 << (FMath::CeilLogTwo(MaxDesiredResolution) - 1));
+			Setup.SizeX = MaxDesiredResolution >= Constants.MaxShadowResolution ? Constants.MaxShadowResolution : (1 << (FMath::CeilLogTwo(MaxDesiredResolution) - 1));
+			Setup.SizeY = Constants.MaxShadowResolutionY;
+		}
 
-			if (bOpaque && bCreateOpaqueObjectShadow && (bOpaqueShadowIsVisibleThisFrame || bShadowIsPotentiallyVisibleNextFrame))
+		if (Setup.bRenderPreShadow && Setup.MaxResolutionPreShadowFadeAlpha > 1.0f / 256.0f)
+		{
+			// Round down to the nearest power of two so that resolution changes are always doubling or halving the resolution, which increases filtering stability.
+			Setup.PreShadowSizeX = 1 << (FMath::CeilLogTwo(FMath::TruncToInt(MaxDesiredResolution * Constants.PreShadowResolutionFactor)) - 1);
+			Setup.PreShadowSizeY = FMath::TruncToInt(Constants.MaxShadowResolutionY * Constants.PreShadowResolutionFactor);
+		}
+	}
+}
+
+void FSceneRenderer::CreatePerObjectProjectedShadows(
+	FRHICommandListImmediate& RHICmdList,
+	TArray<FPerObjectShadowSetup, SceneRenderingAllocator>& PerObjectShadows,
+	const TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& ViewDependentWholeSceneShadows,
+	TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& OutPreShadows)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_CreatePerObjectProjectedShadows);
+
+	const FPerObjectShadowConstants Constants(FSceneRenderTargets::Get(RHICmdList));
+
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_ComputePerObjectShadowSetups);
+
+		ParallelFor(PerObjectShadows.Num(),
+			[this, &Constants, &PerObjectShadows](int32 Index)
 			{
-				// Create a projected shadow for this interaction's shadow.
-				FProjectedShadowInfo* ProjectedShadowInfo = new(FMemStack::Get(),1,16) FProjectedShadowInfo;
+				ComputePerObjectShadowSetup(Views, Constants, PerObjectShadows[Index]);
+			},
+			!ShouldSetupShadowsInParallel()
+		);
+	}
 
-				if(ProjectedShadowInfo->SetupPerObjectProjection(
-					LightSceneInfo,
-					PrimitiveSceneInfo,
-					ShadowInitializer,
-					false,					// no preshadow
-					SizeX,
-					MaxShadowResolutionY,
-					SHADOW_BORDER,
-					MaxScreenPercent,
-					false))					// no translucent shadow
-				{
-					ProjectedShadowInfo->bPerObjectOpaqueShadow = true;
-					ProjectedShadowInfo->FadeAlphas = ResolutionFadeAlphas;
-					VisibleLightInfo.MemStackProjectedShadows.Add(ProjectedShadowInfo);
+	for (const FPerObjectShadowSetup& Setup : PerObjectShadows)
+	{
+		CreatePerObjectProjectedShadow(RHICmdList, Setup, ViewDependentWholeSceneShadows, OutPreShadows);
+	}
+}
 
-					if (bOpaqueShadowIsVisibleThisFrame)
-					{
-						VisibleLightInfo.AllProjectedShadows.Add(ProjectedShadowInfo);
+void FSceneRenderer::CreatePerObjectProjectedShadow(
+	FRHICommandListImmediate& RHICmdList,
+	const FPerObjectShadowSetup& Setup,
+	const TArray<FProjectedShadowInfo*,SceneRenderingAllocator>& ViewDependentWholeSceneShadows,
+	TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& OutPreShadows)
+{
+	check(Setup.bCreateOpaqueObjectShadow || Setup.bCreateTranslucentObjectShadow);
 
-						for (int32 ChildIndex = 0, ChildCount = ShadowGroupPrimitives.Num(); ChildIndex < ChildCount; ChildIndex++)
-						{
-							FPrimitiveSceneInfo* ShadowChild = ShadowGroupPrimitives[ChildIndex];
-							ProjectedShadowInfo->AddSubjectPrimitive(ShadowChild, &Views, FeatureLevel, false);
-						}
-					}
-					else if (bShadowIsPotentiallyVisibleNextFrame)
+	// Shadows that aren't shadow relevant in any view, or that faded away, don't need to be rendered or occlusion tested.
+	if (!Setup.bHasShadowInitializer)
+	{
+		return;
+	}
+
+	FLightPrimitiveInteraction* Interaction = Setup.Interaction;
+	FPrimitiveSceneInfo* PrimitiveSceneInfo = Interaction->GetPrimitiveSceneInfo();
+
+	FLightSceneInfo* LightSceneInfo = Interaction->GetLight();
+	FVisibleLightInfo& VisibleLightInfo = VisibleLightInfos[LightSceneInfo->Id];
+
+	// Check if the shadow is visible in any of the views.
+	const bool bShadowIsPotentiallyVisibleNextFrame = Setup.bShadowIsPotentiallyVisibleNextFrame;
+	bool bOpaqueShadowIsVisibleThisFrame = false;
+	bool bTranslucentShadowIsVisibleThisFrame = false;
+	int32 NumBufferedFrames = FOcclusionQueryHelpers::GetNumBufferedFrames(FeatureLevel);
+
+	for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+	{
+		// The shadow is visible if it is view relevant and unoccluded.
+		if (!Setup.ShadowRelevantInViews[ViewIndex])
+		{
+			continue;
+		}
+
+		const FViewInfo& View = Views[ViewIndex];
+
+		const FSceneViewState::FProjectedShadowKey OpaqueKey(PrimitiveSceneInfo->PrimitiveComponentId, LightSceneInfo->Proxy->GetLightComponent(), INDEX_NONE, false);
+
+		// Check if the shadow and preshadow are occluded.
+		const bool bOpaqueShadowIsOccluded = 
+			!Setup.bCreateOpaqueObjectShadow ||
+			(
+				!View.bIgnoreExistingQueries &&	View.State &&
+				((FSceneViewState*)View.State)->IsShadowOccluded(RHICmdList, OpaqueKey, NumBufferedFrames)
+			);
+
+		const FSceneViewState::FProjectedShadowKey TranslucentKey(PrimitiveSceneInfo->PrimitiveComponentId, LightSceneInfo->Proxy->GetLightComponent(), INDEX_NONE, true);
+
+		const bool bTranslucentShadowIsOccluded = 
+			!Setup.bCreateTranslucentObjectShadow ||
+			(
+				!View.bIgnoreExistingQueries && View.State &&
+				((FSceneViewState*)View.State)->IsShadowOccluded(RHICmdList, TranslucentKey, NumBufferedFrames)
+			);
+
+		bOpaqueShadowIsVisibleThisFrame |= !bOpaqueShadowIsOccluded;
+		bTranslucentShadowIsVisibleThisFrame |= !bTranslucentShadowIsOccluded;
+	}
+
+	const TArray<FPrimitiveSceneInfo*, SceneRenderingAllocator>& ShadowGroupPrimitives = Setup.ShadowGroupPrimitives;
+	FSceneRenderTargets& SceneContext = FSceneRenderTargets::Get(RHICmdList);
+
+	const float MaxFadeAlpha = Setup.MaxResolutionFadeAlpha;
+
+	// Only create a shadow from this object if it hasn't completely faded away
+	if (CVarAllowPerObjectShadows.GetValueOnRenderThread() && MaxFadeAlpha > 1.0f / 256.0f)
+	{
+		if (Setup.bOpaque && Setup.bCreateOpaqueObjectShadow && (bOpaqueShadowIsVisibleThisFrame || bShadowIsPotentiallyVisibleNextFrame))
+		{
+			// Create a projected shadow for this interaction's shadow.
+			FProjectedShadowInfo* ProjectedShadowInfo = new(FMemStack::Get(),1,16) FProjectedShadowInfo;
+
+			if(ProjectedShadowInfo->SetupPerObjectProjection(
+				LightSceneInfo,
+				PrimitiveSceneInfo,
+				Setup.ShadowInitializer,
+				false,					// no preshadow
+				Setup.SizeX,
+				Setup.SizeY,
+				SHADOW_BORDER,
+				Setup.MaxScreenPercent,
+				false))					// no translucent shadow
+			{
+				ProjectedShadowInfo->bPerObjectOpaqueShadow = true;
+				ProjectedShadowInfo->FadeAlphas = Setup.ResolutionFadeAlphas;
+				VisibleLightInfo.MemStackProjectedShadows.Add(ProjectedShadowInfo);
+
+				if (bOpaqueShadowIsVisibleThisFrame)
+				{
+					VisibleLightInfo.AllProjectedShadows.Add(ProjectedShadowInfo);
+
+					for (int32 ChildIndex = 0, ChildCount = ShadowGroupPrimitives.Num(); ChildIndex < ChildCount; ChildIndex++)
 					{
-						VisibleLightInfo.OccludedPerObjectShadows.Add(ProjectedShadowInfo);
+						FPrimitiveSceneInfo* ShadowChild = ShadowGroupPrimitives[ChildIndex];
+						ProjectedShadowInfo->AddSubjectPrimitive(ShadowChild, &Views, FeatureLevel, false);
 					}
 				}
+				else if (bShadowIsPotentiallyVisibleNextFrame)
+				{
+					VisibleLightInfo.OccludedPerObjectShadows.Add(ProjectedShadowInfo);
+				}
 			}
+		}
 
-			if (bTranslucentRelevance
-				&& Scene->GetFeatureLevel() >= ERHIFeatureLevel::SM5
-				&& bCreateTranslucentObjectShadow 
-				&& (bTranslucentShadowIsVisibleThisFrame || bShadowIsPotentiallyVisibleNextFrame))
+		if (Setup.bTranslucentRelevance
+			&& Scene->GetFeatureLevel() >= ERHIFeatureLevel::SM5
+			&& Setup.bCreateTranslucentObjectShadow 
+			&& (bTranslucentShadowIsVisibleThisFrame || bShadowIsPotentiallyVisibleNextFrame))
+		{
+			// Create a projected shadow for this interaction's shadow.
+			FProjectedShadowInfo* ProjectedShadowInfo = new(FMemStack::Get(),1,16) FProjectedShadowInfo;
+
+			if(ProjectedShadowInfo->SetupPerObjectProjection(
+				LightSceneInfo,
+				PrimitiveSceneInfo,
+				Setup.ShadowInitializer,
+				false,					// no preshadow
+				// Size was computed for the full res opaque shadow, convert to downsampled translucent shadow size with proper clamping
+				FMath::Clamp<int32>(Setup.SizeX / SceneContext.GetTranslucentShadowDownsampleFactor(), 1, SceneContext.GetTranslucentShadowDepthTextureResolution().X - SHADOW_BORDER * 2),
+				FMath::Clamp<int32>(Setup.SizeY / SceneContext.GetTranslucentShadowDownsampleFactor(), 1, SceneContext.GetTranslucentShadowDepthTextureResolution().Y - SHADOW_BORDER * 2),
+				SHADOW_BORDER,
+				Setup.MaxScreenPercent,
+				true))					// translucent shadow
 			{
-				// Create a projected shadow for this interaction's shadow.
-				FProjectedShadowInfo* ProjectedShadowInfo = new(FMemStack::Get(),1,16) FProjectedShadowInfo;
+				ProjectedShadowInfo->FadeAlphas = Setup.ResolutionFadeAlphas,
+				VisibleLightInfo.MemStackProjectedShadows.Add(ProjectedShadowInfo);
 
-				if(ProjectedShadowInfo->SetupPerObjectProjection(
-					LightSceneInfo,
-					PrimitiveSceneInfo,
-					ShadowInitializer,
-					false,					// no preshadow
-					// Size was computed for the full res opaque shadow, convert to downsampled translucent shadow size with proper clamping
-					FMath::Clamp<int32>(SizeX / SceneContext.GetTranslucentShadowDownsampleFactor(), 1, SceneContext.GetTranslucentShadowDepthTextureResolution().X - SHADOW_BORDER * 2),
-					FMath::Clamp<int32>(MaxShadowResolutionY / SceneContext.GetTranslucentShadowDownsampleFactor(), 1, SceneContext.GetTranslucentShadowDepthTextureResolution().Y - SHADOW_BORDER * 2),
-					SHADOW_BORDER,
-					MaxScreenPercent,
-					true))					// translucent shadow
+				if (bTranslucentShadowIsVisibleThisFrame)
 				{
-					ProjectedShadowInfo->FadeAlphas = ResolutionFadeAlphas,
-					VisibleLightInfo.MemStackProjectedShadows.Add(ProjectedShadowInfo);
-
-					if (bTranslucentShadowIsVisibleThisFrame)
-					{
-						VisibleLightInfo.AllProjectedShadows.Add(ProjectedShadowInfo);
+					VisibleLightInfo.AllProjectedShadows.Add(ProjectedShadowInfo);
 
-						for (int32 ChildIndex = 0, ChildCount = ShadowGroupPrimitives.Num(); ChildIndex < ChildCount; ChildIndex++)
-						{
-							FPrimitiveSceneInfo* ShadowChild = ShadowGroupPrimitives[ChildIndex];
-							ProjectedShadowInfo->AddSubjectPrimitive(ShadowChild, &Views, FeatureLevel, false);
-						}
-					}
-					else if (bShadowIsPotentiallyVisibleNextFrame)
+					for (int32 ChildIndex = 0, ChildCount = ShadowGroupPrimitives.Num(); ChildIndex < ChildCount; ChildIndex++)
 					{
-						VisibleLightInfo.OccludedPerObjectShadows.Add(ProjectedShadowInfo);
+						FPrimitiveSceneInfo* ShadowChild = ShadowGroupPrimitives[ChildIndex];
+						ProjectedShadowInfo->AddSubjectPrimitive(ShadowChild, &Views, FeatureLevel, false);
 					}
 				}
+				else if (bShadowIsPotentiallyVisibleNextFrame)
+				{
+					VisibleLightInfo.OccludedPerObjectShadows.Add(ProjectedShadowInfo);
+				}
 			}
 		}
+	}
 
-		const float MaxPreFadeAlpha = MaxResolutionPreShadowFadeAlpha;
+	const float MaxPreFadeAlpha = Setup.MaxResolutionPreShadowFadeAlpha;
 
-		// If the subject is visible in at least one view, create a preshadow for static primitives shadowing the subject.
-		if (MaxPreFadeAlpha > 1.0f / 256.0f 
-			&& bRenderPreShadow
-			&& bOpaque
-			&& Scene->GetFeatureLevel() >= ERHIFeatureLevel::SM5)
+	// If the subject is visible in at least one view, create a preshadow for static primitives shadowing the subject.
+	if (MaxPreFadeAlpha > 1.0f / 256.0f 
+		&& Setup.bRenderPreShadow
+		&& Setup.bOpaque
+		&& Scene->GetFeatureLevel() >= ERHIFeatureLevel::SM5)
+	{
+		const FBoxSphereBounds& Bounds = Setup.Bounds;
+		const FIntPoint PreshadowCacheResolution = SceneContext.GetPreShadowCacheTextureResolution();
+		checkSlow(Setup.PreShadowSizeX <= PreshadowCacheResolution.X);
+		bool bIsOutsideWholeSceneShadow = true;
+
+		// Only the whole scene shadows of the lights processed before the interaction's light, as when shadows were set up one light at a time
+		for (int32 i = 0; i < Setup.NumViewDependentWholeSceneShadows; i++)
 		{
-			// Round down to the nearest power of two so that resolution changes are always doubling or halving the resolution, which increases filtering stability.
-			int32 PreshadowSizeX = 1 << (FMath::CeilLogTwo(FMath::TruncToInt(MaxDesiredResolution * CVarPreShadowResolutionFactor.GetValueOnRenderThread())) - 1);
+			const FProjectedShadowInfo* WholeSceneShadow = ViewDependentWholeSceneShadows[i];
+			const FVector2D DistanceFadeValues = WholeSceneShadow->GetLightSceneInfo().Proxy->GetDirectionalLightDistanceFadeParameters(Scene->GetFeatureLevel(), WholeSceneShadow->GetLightSceneInfo().IsPrecomputedLightingValid(), WholeSceneShadow->DependentView->MaxShadowCascades);
+			const float DistanceFromShadowCenterSquared = (WholeSceneShadow->ShadowBounds.Center - Bounds.Origin).SizeSquared();
+			//@todo - if view dependent whole scene shadows are ever supported in splitscreen, 
+			// We can only disable the preshadow at this point if it is inside a whole scene shadow for all views
+			const float DistanceFromViewSquared = ((FVector)WholeSceneShadow->DependentView->ShadowViewMatrices.GetViewOrigin() - Bounds.Origin).SizeSquared();
+			// Mark the preshadow as inside the whole scene shadow if its bounding sphere is inside the near fade distance
+			if (DistanceFromShadowCenterSquared < FMath::Square(FMath::Max(WholeSceneShadow->ShadowBounds.W - Bounds.SphereRadius, 0.0f))
+				//@todo - why is this extra threshold required?
+				&& DistanceFromViewSquared < FMath::Square(FMath::Max(DistanceFadeValues.X - 200.0f - Bounds.SphereRadius, 0.0f)))
+			{
+				bIsOutsideWholeSceneShadow = false;
+				break;
+			}
+		}
 
-			const FIntPoint PreshadowCacheResolution = SceneContext.GetPreShadowCacheTextureResolution();
-			checkSlow(PreshadowSizeX <= PreshadowCacheResolution.X);
-			bool bIsOutsideWholeSceneShadow = true;
+		// Only create opaque preshadows when part of the caster is outside the whole scene shadow.
+		if (bIsOutsideWholeSceneShadow)
+		{
+			// Try to reuse a preshadow from the cache
+			TRefCountPtr<FProjectedShadowInfo> ProjectedPreShadowInfo = GetCachedPreshadow(Interaction, Setup.ShadowInitializer, Setup.OriginalBounds, Setup.PreShadowSizeX);
 
-			for (int32 i = 0; i < ViewDependentWholeSceneShadows.Num(); i++)
+			bool bOk = true;
+
+			if(!ProjectedPreShadowInfo)
 			{
-				const FProjectedShadowInfo* WholeSceneShadow = ViewDependentWholeSceneShadows[i];
-				const FVector2D DistanceFadeValues = WholeSceneShadow->GetLightSceneInfo().Proxy->GetDirectionalLightDistanceFadeParameters(Scene->GetFeatureLevel(), WholeSceneShadow->GetLightSceneInfo().IsPrecomputedLightingValid(), WholeSceneShadow->DependentView->MaxShadowCascades);
-				const float DistanceFromShadowCenterSquared = (WholeSceneShadow->ShadowBounds.Center - Bounds.Origin).SizeSquared();
-				//@todo - if view dependent whole scene shadows are ever supported in splitscreen, 
-				// We can only disable the preshadow at this point if it is inside a whole scene shadow for all views
-				const float DistanceFromViewSquared = ((FVector)WholeSceneShadow->DependentView->ShadowViewMatrices.GetViewOrigin() - Bounds.Origin).SizeSquared();
-				// Mark the preshadow as inside the whole scene shadow if its bounding sphere is inside the near fade distance
-				if (DistanceFromShadowCenterSquared < FMath::Square(FMath::Max(WholeSceneShadow->ShadowBounds.W - Bounds.SphereRadius, 0.0f))
-					//@todo - why is this extra threshold required?
-					&& DistanceFromViewSquared < FMath::Square(FMath::Max(DistanceFadeValues.X - 200.0f - Bounds.SphereRadius, 0.0f)))
-				{
-					bIsOutsideWholeSceneShadow = false;
-					break;
-				}
+				// Create a new projected shadow for this interaction's preshadow
+				// Not using the scene rendering mem stack because this shadow info may need to persist for multiple frames if it gets cached
+				ProjectedPreShadowInfo = new FProjectedShadowInfo;
+
+				bOk = ProjectedPreShadowInfo->SetupPerObjectProjection(
+					LightSceneInfo,
+					PrimitiveSceneInfo,
+					Setup.ShadowInitializer,
+					true,				// preshadow
+					Setup.PreShadowSizeX,
+					Setup.PreShadowSizeY,
+					SHADOW_BORDER,
+					Setup.MaxScreenPercent,
+					false				// not translucent shadow
+					);
 			}
 
-			// Only create opaque preshadows when part of the caster is outside the whole scene shadow.
-			if (bIsOutsideWholeSceneShadow)
+			if (bOk)
 			{
-				// Try to reuse a preshadow from the cache
-				TRefCountPtr<FProjectedShadowInfo> ProjectedPreShadowInfo = GetCachedPreshadow(Interaction, ShadowInitializer, OriginalBounds, PreshadowSizeX);
 
-				bool bOk = true;
+				// Update fade alpha on the cached preshadow
+				ProjectedPreShadowInfo->FadeAlphas = Setup.ResolutionPreShadowFadeAlphas;
 
-				if(!ProjectedPreShadowInfo)
-				{
-					// Create a new projected shadow for this interaction's preshadow
-					// Not using the scene rendering mem stack because this shadow info may need to persist for multiple frames if it gets cached
-					ProjectedPreShadowInfo = new FProjectedShadowInfo;
+				VisibleLightInfo.AllProjectedShadows.Add(ProjectedPreShadowInfo);
+				VisibleLightInfo.ProjectedPreShadows.Add(ProjectedPreShadowInfo);
 
-					bOk = ProjectedPreShadowInfo->SetupPerObjectProjection(
-						LightSceneInfo,
-						PrimitiveSceneInfo,
-						ShadowInitializer,
-						true,				// preshadow
-						PreshadowSizeX,
-						FMath::TruncToInt(MaxShadowResolutionY * CVarPreShadowResolutionFactor.GetValueOnRenderThread()),
-						SHADOW_BORDER,
-						MaxScreenPercent,
-						false				// not translucent shadow
-						);
+				// Only add to OutPreShadows if the preshadow doesn't already have depths cached, 
+				// Since OutPreShadows is used to generate information only used when rendering the shadow depths.
+				if (!ProjectedPreShadowInfo->bDepthsCached && ProjectedPreShadowInfo->CasterFrustum.PermutedPlanes.Num())
+				{
+					OutPreShadows.Add(ProjectedPreShadowInfo);
 				}
 
-				if (bOk)
+				for (int32 ChildIndex = 0; ChildIndex < ShadowGroupPrimitives.Num(); ChildIndex++)
 				{
-
-					// Update fade alpha on the cached preshadow
-					ProjectedPreShadowInfo->FadeAlphas = ResolutionPreShadowFadeAlphas;
-
-					VisibleLightInfo.AllProjectedShadows.Add(ProjectedPreShadowInfo);
-					VisibleLightInfo.ProjectedPreShadows.Add(ProjectedPreShadowInfo);
-
-					// Only add to OutPreShadows if the preshadow doesn't already have depths cached, 
-					// Since OutPreShadows is used to generate information only used when rendering the shadow depths.
-					if (!ProjectedPreShadowInfo->bDepthsCached && ProjectedPreShadowInfo->CasterFrustum.PermutedPlanes.Num())
+					FPrimitiveSceneInfo* ShadowChild = ShadowGroupPrimitives[ChildIndex];
+					bool bChildIsVisibleInAnyView = false;
+					for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
 					{
-						OutPreShadows.Add(ProjectedPreShadowInfo);
-					}
-
-					for (int32 ChildIndex = 0; ChildIndex < ShadowGroupPrimitives.Num(); ChildIndex++)
-					{
-						FPrimitiveSceneInfo* ShadowChild = ShadowGroupPrimitives[ChildIndex];
-						bool bChildIsVisibleInAnyView = false;
-						for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+						const FViewInfo& View = Views[ViewIndex];
+						if (View.PrimitiveVisibilityMap[ShadowChild->GetIndex()])
 						{
-							const FViewInfo& View = Views[ViewIndex];
-							if (View.PrimitiveVisibilityMap[ShadowChild->GetIndex()])
-							{
-								bChildIsVisibleInAnyView = true;
-								break;
-							}
-						}
-						if (bChildIsVisibleInAnyView)
-						{
-							ProjectedPreShadowInfo->AddReceiverPrimitive(ShadowChild);
+							bChildIsVisibleInAnyView = true;
+							break;
 						}
 					}
+					if (bChildIsVisibleInAnyView)
+					{
+						ProjectedPreShadowInfo->AddReceiverPrimitive(ShadowChild);
+					}
 				}
 			}
 		}
@@ -2699,20 +2796,15 @@ void FSceneRenderer::CreateWholeSceneProjectedShadow(
 						
 						if (CacheMode[CacheModeIndex] != SDCM_MovablePrimitivesOnly)
 						{
-							// Add all the shadow casting primitives affected by the light to the shadow's subject primitive list.
-							for (FLightPrimitiveInteraction* Interaction = LightSceneInfo->GetDynamicInteractionStaticPrimitiveList(false);
-								Interaction;
-								Interaction = Interaction->GetNextPrimitive())
+							// Add the static shadow casting primitives affected by the light, which the light keeps until one of them moves.
+							for (FPrimitiveSceneInfo* PrimitiveSceneInfo : LightSceneInfo->GetWholeSceneStaticShadowCasters(false))
 							{
-								if (Interaction->HasShadow()
-									// If the primitive only wants to cast a self shadow don't include it in whole scene shadows.
-									&& !Interaction->CastsSelfShadowOnly()
-									&& (!bStaticSceneOnly || Interaction->GetPrimitiveSceneInfo()->Proxy->HasStaticLighting()))
+								if (!bStaticSceneOnly || PrimitiveSceneInfo->Proxy->HasStaticLighting())
 								{
-									FBoxSphereBounds const& Bounds = Interaction->GetPrimitiveSceneInfo()->Proxy->GetBounds();
+									FBoxSphereBounds const& Bounds = PrimitiveSceneInfo->Proxy->GetBounds();
 									if (IntersectsConvexHulls(LightViewFrustumConvexHulls, Bounds))
 									{
-										ProjectedShadowInfo->AddSubjectPrimitive(Interaction->GetPrimitiveSceneInfo(), &Views, FeatureLevel, false);
+										ProjectedShadowInfo->AddSubjectPrimitive(PrimitiveSceneInfo, &Views, FeatureLevel, false);
 									}
 								}
 							}
@@ -2739,11 +2831,29 @@ void FSceneRenderer::CreateWholeSceneProjectedShadow(
 	}
 }
 
+/** Whether a shadow can be projected in a view, view dependent shadows rendered for the left eye are also projected in the right eye. */
+static bool IsShadowValidForView(const FProjectedShadowInfo& ProjectedShadowInfo, const FViewInfo& View, int32 ViewIndex)
+{
+	if (ProjectedShadowInfo.DependentView && ProjectedShadowInfo.DependentView != &View)
+	{
+		// The view dependent projected shadow is valid for this view if it's the
+		// right eye and the projected shadow is being rendered for the left eye.
+		return IStereoRendering::IsASecondaryView(View)
+			&& IStereoRendering::IsAPrimaryView(*ProjectedShadowInfo.DependentView)
+			&& ProjectedShadowInfo.FadeAlphas.IsValidIndex(ViewIndex)
+			&& ProjectedShadowInfo.FadeAlphas[ViewIndex] == 1.0f;
+	}
+
+	return true;
+}
+
 void FSceneRenderer::InitProjectedShadowVisibility(FRHICommandListImmediate& RHICmdList)
 {
 	SCOPE_CYCLE_COUNTER(STAT_InitProjectedShadowVisibility);
 	int32 NumBufferedFrames = FOcclusionQueryHelpers::GetNumBufferedFrames(FeatureLevel);
 
+	TArray<int32, SceneRenderingAllocator> ShadowedLightIndices;
+
 	// Initialize the views' ProjectedShadowVisibilityMaps and remove shadows without subjects.
 	for(TSparseArray<FLightSceneInfoCompact>::TConstIterator LightIt(Scene->Lights);LightIt;++LightIt)
 	{
@@ -2761,49 +2871,81 @@ void FSceneRenderer::InitProjectedShadowVisibility(FRHICommandListImmediate& RHI
 
 		for( int32 ShadowIndex=0; ShadowIndex<VisibleLightInfo.AllProjectedShadows.Num(); ShadowIndex++ )
 		{
-			FProjectedShadowInfo& ProjectedShadowInfo = *VisibleLightInfo.AllProjectedShadows[ShadowIndex];
-
 			// Assign the shadow its id.
-			ProjectedShadowInfo.ShadowId = ShadowIndex;
+			VisibleLightInfo.AllProjectedShadows[ShadowIndex]->ShadowId = ShadowIndex;
+		}
 
-			for(int32 ViewIndex = 0;ViewIndex < Views.Num();ViewIndex++)
+		if (VisibleLightInfo.AllProjectedShadows.Num() > 0)
+		{
+			ShadowedLightIndices.Add(LightIt.GetIndex());
+		}
+	}
+
+	// Compute the view relevance of the shadows on task threads, each light only writes its own maps.
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_ComputeShadowViewRelevance);
+
+		ParallelFor(ShadowedLightIndices.Num(),
+			[this, &ShadowedLightIndices](int32 Index)
 			{
-				FViewInfo& View = Views[ViewIndex];
+				const int32 LightIndex = ShadowedLightIndices[Index];
+				const FVisibleLightInfo& VisibleLightInfo = VisibleLightInfos[LightIndex];
 
-				if (ProjectedShadowInfo.DependentView && ProjectedShadowInfo.DependentView != &View)
+				for (int32 ShadowIndex = 0; ShadowIndex < VisibleLightInfo.AllProjectedShadows.Num(); ShadowIndex++)
 				{
-					// The view dependent projected shadow is valid for this view if it's the
-					// right eye and the projected shadow is being rendered for the left eye.
-					const bool bIsValidForView = IStereoRendering::IsASecondaryView(View)
-						&& IStereoRendering::IsAPrimaryView(*ProjectedShadowInfo.DependentView)
-						&& ProjectedShadowInfo.FadeAlphas.IsValidIndex(ViewIndex)
-						&& ProjectedShadowInfo.FadeAlphas[ViewIndex] == 1.0f;
-
-					if (!bIsValidForView)
+					const FProjectedShadowInfo& ProjectedShadowInfo = *VisibleLightInfo.AllProjectedShadows[ShadowIndex];
+
+					for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
 					{
-						continue;
+						const FViewInfo& View = Views[ViewIndex];
+						FVisibleLightViewInfo& VisibleLightViewInfo = Views[ViewIndex].VisibleLightInfos[LightIndex];
+
+						if (VisibleLightViewInfo.bInViewFrustum && IsShadowValidForView(ProjectedShadowInfo, View, ViewIndex))
+						{
+							// Compute the subject primitive's view relevance.  Note that the view won't necessarily have it cached,
+							// since the primitive might not be visible.
+							FPrimitiveViewRelevance ViewRelevance;
+							if (ProjectedShadowInfo.GetParentSceneInfo())
+							{
+								ViewRelevance = ProjectedShadowInfo.GetParentSceneInfo()->Proxy->GetViewRelevance(&View);
+							}
+							else
+							{
+								ViewRelevance.bDrawRelevance = ViewRelevance.bStaticRelevance = ViewRelevance.bDynamicRelevance = ViewRelevance.bShadowRelevance = true;
+							}
+							VisibleLightViewInfo.ProjectedShadowViewRelevanceMap[ShadowIndex] = ViewRelevance;
+						}
 					}
 				}
+			},
+			!ShouldSetupShadowsInParallel()
+		);
+	}
+
+	// Occlusion queries are read and shadow frustums drawn on the rendering thread.
+	for (int32 LightIndex : ShadowedLightIndices)
+	{
+		FVisibleLightInfo& VisibleLightInfo = VisibleLightInfos[LightIndex];
+
+		for( int32 ShadowIndex=0; ShadowIndex<VisibleLightInfo.AllProjectedShadows.Num(); ShadowIndex++ )
+		{
+			FProjectedShadowInfo& ProjectedShadowInfo = *VisibleLightInfo.AllProjectedShadows[ShadowIndex];
+
+			for(int32 ViewIndex = 0;ViewIndex < Views.Num();ViewIndex++)
+			{
+				FViewInfo& View = Views[ViewIndex];
+
+				if (!IsShadowValidForView(ProjectedShadowInfo, View, ViewIndex))
+				{
+					continue;
+				}
 
-				FVisibleLightViewInfo& VisibleLightViewInfo = View.VisibleLightInfos[LightIt.GetIndex()];
+				FVisibleLightViewInfo& VisibleLightViewInfo = View.VisibleLightInfos[LightIndex];
 
 				if(VisibleLightViewInfo.bInViewFrustum)
 				{
-					// Compute the subject primitive's view relevance.  Note that the view won't necessarily have it cached,
-					// since the primitive might not be visible.
-					FPrimitiveViewRelevance ViewRelevance;
-					if(ProjectedShadowInfo.GetParentSceneInfo())
-					{
-						ViewRelevance = ProjectedShadowInfo.GetParentSceneInfo()->Proxy->GetViewRelevance(&View);
-					}
-					else
-					{
-						ViewRelevance.bDrawRelevance = ViewRelevance.bStaticRelevance = ViewRelevance.bDynamicRelevance = ViewRelevance.bShadowRelevance = true;
-					}							
-					VisibleLightViewInfo.ProjectedShadowViewRelevanceMap[ShadowIndex] = ViewRelevance;
-
 					// Check if the subject primitive's shadow is view relevant.
-					const bool bPrimitiveIsShadowRelevant = ViewRelevance.bShadowRelevance;
+					const bool bPrimitiveIsShadowRelevant = VisibleLightViewInfo.ProjectedShadowViewRelevanceMap[ShadowIndex].bShadowRelevance;
 
 					bool bShadowIsOccluded = false;
 
@@ -3002,6 +3144,8 @@ struct FGatherShadowPrimitivesPacket
 	const FScenePrimitiveOctree::FNode* Node;
 	int32 StartPrimitiveIndex;
 	int32 NumPrimitives;
+	/** If set, StartPrimitiveIndex and NumPrimitives index this array of primitive indices instead of the scene primitives. */
+	const int32* PrimitiveIndices;
 	const TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& PreShadows;
 	const TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& ViewDependentWholeSceneShadows;
 	ERHIFeatureLevel::Type FeatureLevel;
@@ -3020,12 +3164,14 @@ struct FGatherShadowPrimitivesPacket
 		const TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& InPreShadows,
 		const TArray<FProjectedShadowInfo*, SceneRenderingAllocator>& InViewDependentWholeSceneShadows,
 		ERHIFeatureLevel::Type InFeatureLevel,
-		bool bInStaticSceneOnly) 
+		bool bInStaticSceneOnly,
+		const int32* InPrimitiveIndices = nullptr) 
 		: Scene(InScene)
 		, Views(InViews)
 		, Node(InNode)
 		, StartPrimitiveIndex(InStartPrimitiveIndex)
 		, NumPrimitives(InNumPrimitives)
+		, PrimitiveIndices(InPrimitiveIndices)
 		, PreShadows(InPreShadows)
 		, ViewDependentWholeSceneShadows(InViewDependentWholeSceneShadows)
 		, FeatureLevel(InFeatureLevel)
@@ -3058,8 +3204,9 @@ struct FGatherShadowPrimitivesPacket
 			check(NumPrimitives > 0);
 
 			// Check primitives in this packet's range
-			for (int32 PrimitiveIndex = StartPrimitiveIndex; PrimitiveIndex < StartPrimitiveIndex + NumPrimitives; PrimitiveIndex++)
+			for (int32 RangeIndex = StartPrimitiveIndex; RangeIndex < StartPrimitiveIndex + NumPrimitives; RangeIndex++)
 			{
+				const int32 PrimitiveIndex = PrimitiveIndices ? PrimitiveIndices[RangeIndex] : RangeIndex;
 				FPrimitiveFlagsCompact PrimitiveFlagsCompact = Scene->PrimitiveFlagsCompact[PrimitiveIndex];
 
 				if (PrimitiveFlagsCompact.bCastDynamicShadow)
@@ -3206,8 +3353,48 @@ void FSceneRenderer::GatherShadowPrimitives(
 	if (PreShadows.Num() || ViewDependentWholeSceneShadows.Num())
 	{
 		TArray<FGatherShadowPrimitivesPacket*,SceneRenderingAllocator> Packets;
+		TArray<int32, SceneRenderingAllocator> BVHPrimitiveIndices;
+
+		if (Scene->PrimitiveBVH.Update(Scene->PrimitiveBounds))
+		{
+			QUICK_SCOPE_CYCLE_COUNTER(STAT_ShadowScenePrimitiveBVHTraversal);
+
+			// Find primitives in subtrees that are in a shadow frustum, same as the octree traversal below
+			Scene->PrimitiveBVH.FindPrimitives([&PreShadows, &ViewDependentWholeSceneShadows](const FVector& Center, const FVector& Extent)
+			{
+				for (const FProjectedShadowInfo* ProjectedShadowInfo : PreShadows)
+				{
+					if (ProjectedShadowInfo->CasterFrustum.IntersectBox(Center + ProjectedShadowInfo->PreShadowTranslation, Extent))
+					{
+						return true;
+					}
+				}
+
+				for (const FProjectedShadowInfo* ProjectedShadowInfo : ViewDependentWholeSceneShadows)
+				{
+					if (ProjectedShadowInfo->CasterFrustum.IntersectBox(Center + ProjectedShadowInfo->PreShadowTranslation, Extent))
+					{
+						return true;
+					}
+				}
+
+				return false;
+			}, BVHPrimitiveIndices);
+
+			const int32 PacketSize = CVarParallelGatherNumPrimitivesPerPacket.GetValueOnRenderThread();
+			const int32 NumPackets = FMath::DivideAndRoundUp(BVHPrimitiveIndices.Num(), PacketSize);
+
+			Packets.Reserve(NumPackets);
 
-		if (GUseOctreeForShadowCulling)
+			for (int32 PacketIndex = 0; PacketIndex < NumPackets; PacketIndex++)
+			{
+				const int32 StartIndex = PacketIndex * PacketSize;
+				const int32 NumPrimitives = FMath::Min(PacketSize, BVHPrimitiveIndices.Num() - StartIndex);
+				FGatherShadowPrimitivesPacket* Packet = new(FMemStack::Get()) FGatherShadowPrimitivesPacket(Scene, Views, NULL, StartIndex, NumPrimitives, PreShadows, ViewDependentWholeSceneShadows, FeatureLevel, bStaticSceneOnly, BVHPrimitiveIndices.GetData());
+				Packets.Add(Packet);
+			}
+		}
+		else if (GUseOctreeForShadowCulling)
 		{
 			QUICK_SCOPE_CYCLE_COUNTER(STAT_ShadowSceneOctreeTraversal);
 
@@ -3381,43 +3568,64 @@ void FSceneRenderer::AddViewDependentWholeSceneShadowsForView(
 			FSceneRenderTargets& SceneContext_ConstantsOnly = FSceneRenderTargets::Get_FrameConstantsOnly();
 
 
-			// todo: this code can be simplified by computing all the distances in one place - avoiding some redundant work and complexity
-			for (int32 Index = 0; Index < ProjectionCount; Index++)
-			{
-				FWholeSceneProjectedShadowInitializer ProjectedShadowInitializer;
+			const FIntPoint ShadowBufferResolution(
+				FMath::Clamp(GetCachedScalabilityCVars().MaxCSMShadowResolution, 1, (int32)GMaxShadowDepthBufferSizeX),
+				FMath::Clamp(GetCachedScalabilityCVars().MaxCSMShadowResolution, 1, (int32)GMaxShadowDepthBufferSizeY));
 
-				int32 LocalIndex = Index;
+			const uint32 ShadowBorder = NeedsUnatlasedCSMDepthsWorkaround(FeatureLevel) ? 0 : SHADOW_BORDER;
 
-				// Indexing like this puts the ray traced shadow cascade last (might not be needed)
-				if(bExtraDistanceFieldCascade && LocalIndex + 1 == ProjectionCount)
-				{
-					LocalIndex = INDEX_NONE;
-				}
+			// Create the projected shadow infos up front, the scene rendering mem stack can only be used on the rendering thread.
+			TArray<FProjectedShadowInfo*, TInlineAllocator<8> > CascadeShadowInfos;
+			CascadeShadowInfos.AddUninitialized(ProjectionCount);
 
-				if (LightSceneInfo.Proxy->GetViewDependentWholeSceneProjectedShadowInitializer(View, LocalIndex, LightSceneInfo.IsPrecomputedLightingValid(), ProjectedShadowInitializer))
+			for (int32 Index = 0; Index < ProjectionCount; Index++)
+			{
+				CascadeShadowInfos[Index] = new(FMemStack::Get(), 1, 16) FProjectedShadowInfo;
+			}
+
+			// Compute the cascade bounds and projections on task threads.
+			// todo: this code can be simplified by computing all the distances in one place - avoiding some redundant work and complexity
+			ParallelFor(ProjectionCount,
+				[&View, &LightSceneInfo, &CascadeShadowInfos, ProjectionCount, bExtraDistanceFieldCascade, ShadowBufferResolution, ShadowBorder](int32 Index)
 				{
-					const FIntPoint ShadowBufferResolution(
-					FMath::Clamp(GetCachedScalabilityCVars().MaxCSMShadowResolution, 1, (int32)GMaxShadowDepthBufferSizeX),
-					FMath::Clamp(GetCachedScalabilityCVars().MaxCSMShadowResolution, 1, (int32)GMaxShadowDepthBufferSizeY));
+					FWholeSceneProjectedShadowInitializer ProjectedShadowInitializer;
 
-					// Create the projected shadow info.
-					FProjectedShadowInfo* ProjectedShadowInfo = new(FMemStack::Get(), 1, 16) FProjectedShadowInfo;
+					int32 LocalIndex = Index;
 
-					uint32 ShadowBorder = NeedsUnatlasedCSMDepthsWorkaround(FeatureLevel) ? 0 : SHADOW_BORDER;
+					// Indexing like this puts the ray traced shadow cascade last (might not be needed)
+					if(bExtraDistanceFieldCascade && LocalIndex + 1 == ProjectionCount)
+					{
+						LocalIndex = INDEX_NONE;
+					}
 
-					ProjectedShadowInfo->SetupWholeSceneProjection(
-						&LightSceneInfo,
-						&View,
-						ProjectedShadowInitializer,
-						ShadowBufferResolution.X - ShadowBorder * 2,
-						ShadowBufferResolution.Y - ShadowBorder * 2,
-						ShadowBorder,
-						false	// no RSM
-						);
+					if (LightSceneInfo.Proxy->GetViewDependentWholeSceneProjectedShadowInitializer(View, LocalIndex, LightSceneInfo.IsPrecomputedLightingValid(), ProjectedShadowInitializer))
+					{
+						CascadeShadowInfos[Index]->SetupWholeSceneProjection(
+							&LightSceneInfo,
+							&View,
+							ProjectedShadowInitializer,
+							ShadowBufferResolution.X - ShadowBorder * 2,
+							ShadowBufferResolution.Y - ShadowBorder * 2,
+							ShadowBorder,
+							false	// no RSM
+							);
+					}
+					else
+					{
+						// Class was allocated on the memstack which does not call destructors
+						CascadeShadowInfos[Index]->~FProjectedShadowInfo();
+						CascadeShadowInfos[Index] = nullptr;
+					}
+				},
+				!ShouldSetupShadowsInParallel()
+			);
 
+			for (FProjectedShadowInfo* ProjectedShadowInfo : CascadeShadowInfos)
+			{
+				if (ProjectedShadowInfo)
+				{
 					ProjectedShadowInfo->FadeAlphas = FadeAlphas;
 
-					FVisibleLightInfo& LightViewInfo = VisibleLightInfos[LightSceneInfo.Id];
 					VisibleLightInfo.MemStackProjectedShadows.Add(ProjectedShadowInfo);
 					VisibleLightInfo.AllProjectedShadows.Add(ProjectedShadowInfo);
 					ShadowInfos.Add(ProjectedShadowInfo);
@@ -4130,6 +4338,7 @@ void FSceneRenderer::InitDynamicShadows(FRHICommandListImmediate& RHICmdList, FG
 	TArray<FProjectedShadowInfo*,SceneRenderingAllocator> PreShadows;
 	TArray<FProjectedShadowInfo*,SceneRenderingAllocator> ViewDependentWholeSceneShadows;
 	TArray<FProjectedShadowInfo*,SceneRenderingAllocator> ViewDependentWholeSceneShadowsThatNeedCulling;
+	TArray<FPerObjectShadowSetup,SceneRenderingAllocator> PerObjectShadows;
 	{
 		SCOPE_CYCLE_COUNTER(STAT_InitDynamicShadowsTime);
 		CSV_SCOPED_TIMING_STAT_EXCLUSIVE(ShadowInitDynamic);
@@ -4236,7 +4445,7 @@ void FSceneRenderer::InitDynamicShadows(FRHICommandListImmediate& RHICmdList, FG
 								Interaction = Interaction->GetNextPrimitive()
 								)
 							{
-								SetupInteractionShadows(RHICmdList, Interaction, VisibleLightInfo, bStaticSceneOnly, ViewDependentWholeSceneShadows, PreShadows);
+								SetupInteractionShadows(Interaction, bStaticSceneOnly, ViewDependentWholeSceneShadows.Num(), PerObjectShadows);
 							}
 
 							for (FLightPrimitiveInteraction* Interaction = LightSceneInfo->GetDynamicInteractionStaticPrimitiveList(false);
@@ -4244,7 +4453,7 @@ void FSceneRenderer::InitDynamicShadows(FRHICommandListImmediate& RHICmdList, FG
 								Interaction = Interaction->GetNextPrimitive()
 								)
 							{
-								SetupInteractionShadows(RHICmdList, Interaction, VisibleLightInfo, bStaticSceneOnly, ViewDependentWholeSceneShadows, PreShadows);
+								SetupInteractionShadows(Interaction, bStaticSceneOnly, ViewDependentWholeSceneShadows.Num(), PerObjectShadows);
 							}
 						}
 					}
@@ -4254,6 +4463,9 @@ void FSceneRenderer::InitDynamicShadows(FRHICommandListImmediate& RHICmdList, FG
 
 		CSV_CUSTOM_STAT(LightCount, UpdatedShadowMaps, float(NumPointShadowCachesUpdatedThisFrame + NumSpotShadowCachesUpdatedThisFrame), ECsvCustomStatOp::Set);
 
+		// Set up the per-object shadows of all lights together, so the setups can be computed in parallel.
+		CreatePerObjectProjectedShadows(RHICmdList, PerObjectShadows, ViewDependentWholeSceneShadows, PreShadows);
+
 		// Calculate visibility of the projected shadows.
 		InitProjectedShadowVisibility(RHICmdList);
 	}
@@ -84,6 +84,63 @@ void ThreadDestroy(UPTRINT Handle)
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+struct FSemaphore
+{
+	pthread_mutex_t	Mutex;
+	pthread_cond_t	Condition;
+	uint32			Count;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+UPTRINT SemaphoreCreate()
+{
+	auto* Semaphore = reinterpret_cast<FSemaphore*>(MemoryReserve(sizeof(FSemaphore)));
+	if (Semaphore == nullptr)
+	{
+		return 0;
+	}
+
+	pthread_mutex_init(&Semaphore->Mutex, nullptr);
+	pthread_cond_init(&Semaphore->Condition, nullptr);
+	Semaphore->Count = 0;
+	return reinterpret_cast<UPTRINT>(Semaphore);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SemaphoreRelease(UPTRINT Handle, uint32 Count)
+{
+	auto* Semaphore = reinterpret_cast<FSemaphore*>(Handle);
+	pthread_mutex_lock(&Semaphore->Mutex);
+	Semaphore->Count += Count;
+	pthread_cond_broadcast(&Semaphore->Condition);
+	pthread_mutex_unlock(&Semaphore->Mutex);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SemaphoreWait(UPTRINT Handle)
+{
+	auto* Semaphore = reinterpret_cast<FSemaphore*>(Handle);
+	pthread_mutex_lock(&Semaphore->Mutex);
+	while (Semaphore->Count == 0)
+	{
+		pthread_cond_wait(&Semaphore->Condition, &Semaphore->Mutex);
+	}
+	--Semaphore->Count;
+	pthread_mutex_unlock(&Semaphore->Mutex);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SemaphoreDestroy(UPTRINT Handle)
+{
+	auto* Semaphore = reinterpret_cast<FSemaphore*>(Handle);
+	pthread_cond_destroy(&Semaphore->Condition);
+	pthread_mutex_destroy(&Semaphore->Mutex);
+	MemoryFree(Semaphore, sizeof(FSemaphore));
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 uint64 TimeGetFrequency()
 {
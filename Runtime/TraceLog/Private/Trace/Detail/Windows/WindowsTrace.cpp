@@ -83,6 +83,32 @@ void ThreadDestroy(UPTRINT Handle)
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+UPTRINT SemaphoreCreate()
+{
+	return UPTRINT(CreateSemaphoreW(nullptr, 0, 0x7fffffff, nullptr));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SemaphoreRelease(UPTRINT Handle, uint32 Count)
+{
+	ReleaseSemaphore(HANDLE(Handle), LONG(Count), nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SemaphoreWait(UPTRINT Handle)
+{
+	WaitForSingleObject(HANDLE(Handle), INFINITE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SemaphoreDestroy(UPTRINT Handle)
+{
+	CloseHandle(HANDLE(Handle));
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 uint64 TimeGetFrequency()
 {
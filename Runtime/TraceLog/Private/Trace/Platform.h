@@ -21,6 +21,12 @@ void	ThreadSleep(uint32 Milliseconds);
 void	ThreadJoin(UPTRINT Handle);
 void	ThreadDestroy(UPTRINT Handle);
 
+////////////////////////////////////////////////////////////////////////////////
+UPTRINT	SemaphoreCreate();
+void	SemaphoreRelease(UPTRINT Handle, uint32 Count);
+void	SemaphoreWait(UPTRINT Handle);
+void	SemaphoreDestroy(UPTRINT Handle);
+
 ////////////////////////////////////////////////////////////////////////////////
 uint64	TimeGetFrequency();
 uint64	TimeGetTimestamp();
@@ -15,6 +15,10 @@ namespace Private
 ////////////////////////////////////////////////////////////////////////////////
 bool	Writer_SendTo(const ANSICHAR*, uint32);
 bool	Writer_WriteTo(const ANSICHAR*);
+bool	Writer_StartFlightRecorder(uint32, uint32);
+bool	Writer_DumpFlightRecorder(const ANSICHAR*, uint32);
+void	Writer_SetEncodeThreadCount(uint32);
+void	Writer_GetStatistics(FStatistics&);
 
 } // namespace Private
 
@@ -58,6 +62,32 @@ bool WriteTo(const TCHAR* InPath)
 	return Private::Writer_WriteTo(Path);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool StartFlightRecorder(uint32 Seconds, uint32 SizeMb)
+{
+	return Private::Writer_StartFlightRecorder(Seconds, SizeMb);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DumpFlightRecorder(const TCHAR* InPath, uint32 WaitMs)
+{
+	char Path[512];
+	ToAnsiCheap(Path, InPath);
+	return Private::Writer_DumpFlightRecorder(Path, WaitMs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void SetCompressionThreadCount(uint32 Count)
+{
+	Private::Writer_SetEncodeThreadCount(Count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GetStatistics(FStatistics& Out)
+{
+	Private::Writer_GetStatistics(Out);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ToggleChannel(const TCHAR* ChannelName, bool bEnabled)
 {
@@ -202,6 +202,7 @@ static FWriteBuffer* Writer_NextBufferInternal(uint32 PageGrowth)
 	NextBuffer->Reaped = NextBuffer->Cursor;
 	NextBuffer->EtxOffset = UPTRINT(0) - sizeof(FWriteBuffer);
 	NextBuffer->NextBuffer = nullptr;
+	NextBuffer->bPinned = 0;
 
 
 	FWriteBuffer* CurrentBuffer = GTlsWriteBuffer;
@@ -294,7 +295,7 @@ class FHoldBufferImpl
 public:
 	void				Init();
 	void				Shutdown();
-	void				Write(const void* Data, uint32 Size);
+	bool				Write(const void* Data, uint32 Size);
 	bool				IsFull() const	{ return bFull; }
 	const uint8*		GetData() const { return Base; }
 	uint32				GetSize() const { return Used; }
@@ -335,8 +336,15 @@ void FHoldBufferImpl::Shutdown()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void FHoldBufferImpl::Write(const void* Data, uint32 Size)
+bool FHoldBufferImpl::Write(const void* Data, uint32 Size)
 {
+	// Once full, stay full so that whatever takes over from the hold buffer
+	// receives all subsequent data in order.
+	if (bFull)
+	{
+		return false;
+	}
+
 	int32 NextUsed = Used + Size;
 
 	uint16 HotPageCount = uint16((NextUsed + (FHoldBufferImpl::PageSize - 1)) >> FHoldBufferImpl::PageShift);
@@ -345,7 +353,7 @@ void FHoldBufferImpl::Write(const void* Data, uint32 Size)
 		if (HotPageCount > FHoldBufferImpl::MaxPages)
 		{
 			bFull = true;
-			return;
+			return false;
 		}
 
 		void* MapStart = Base + (UPTRINT(MappedPageCount) << FHoldBufferImpl::PageShift);
@@ -358,6 +366,125 @@ void FHoldBufferImpl::Write(const void* Data, uint32 Size)
 	memcpy(Base + Used, Data, Size);
 
 	Used = NextUsed;
+	return true;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+class FFlightRecorderImpl
+{
+public:
+	void				Init(uint32 Size, uint32 Seconds);
+	void				Shutdown();
+	void				Write(const void* Data, uint32 Size);
+	bool				WriteTo(UPTRINT Handle) const;
+	bool				IsActive() const	{ return Base != nullptr; }
+	uint32				GetSize() const		{ return uint32(WritePos - ReadPos); }
+
+private:
+	struct FEntry
+	{
+		uint64			Timestamp;
+		uint32			EntrySize;		// including this header and padding
+		uint32			PacketSize;		// zero for padding at the end of the ring
+	};
+
+	static const uint32	MinSize = 1 << 20;
+	uint8*				Base;
+	uint64				ReadPos;
+	uint64				WritePos;
+	uint64				MaxAge;
+	uint32				Capacity;
+};
+
+typedef TSafeStatic<FFlightRecorderImpl> FFlightRecorder;
+
+////////////////////////////////////////////////////////////////////////////////
+void FFlightRecorderImpl::Init(uint32 Size, uint32 Seconds)
+{
+	Capacity = (Size > MinSize) ? ((Size + MinSize - 1) & ~(MinSize - 1)) : MinSize;
+	Base = MemoryReserve(Capacity);
+	MemoryMap(Base, Capacity);
+	ReadPos = 0;
+	WritePos = 0;
+	MaxAge = TimeGetFrequency() * Seconds;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FFlightRecorderImpl::Shutdown()
+{
+	if (Base == nullptr)
+	{
+		return;
+	}
+
+	MemoryFree(Base, Capacity);
+	Base = nullptr;
+	ReadPos = WritePos = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void FFlightRecorderImpl::Write(const void* Data, uint32 Size)
+{
+	static_assert(sizeof(FEntry) == 16, "Entries are expected to be 16-byte aligned");
+	uint32 EntrySize = (sizeof(FEntry) + Size + 15) & ~15u;
+	uint64 Now = TimeGetTimestamp();
+	uint64 Cutoff = (Now > MaxAge) ? Now - MaxAge : 0;
+
+	// Entries never straddle the end of the ring. If this one would then the
+	// rest of the ring is skipped with a padding entry.
+	uint32 Offset = uint32(WritePos % Capacity);
+	uint32 PadSize = (Offset + EntrySize > Capacity) ? Capacity - Offset : 0;
+
+	// Make room by dropping the oldest entries, and drop those that are too old
+	// anyway while we are at it.
+	while (ReadPos < WritePos)
+	{
+		const auto* Oldest = (const FEntry*)(Base + (ReadPos % Capacity));
+		bool bNeedsRoom = (WritePos + PadSize + EntrySize - ReadPos > Capacity);
+		if (!bNeedsRoom && Oldest->Timestamp >= Cutoff)
+		{
+			break;
+		}
+		ReadPos += Oldest->EntrySize;
+	}
+
+	if (PadSize)
+	{
+		auto* Padding = (FEntry*)(Base + Offset);
+		Padding->Timestamp = 0;
+		Padding->EntrySize = PadSize;
+		Padding->PacketSize = 0;
+		WritePos += PadSize;
+		Offset = 0;
+	}
+
+	auto* Entry = (FEntry*)(Base + Offset);
+	Entry->Timestamp = Now;
+	Entry->EntrySize = EntrySize;
+	Entry->PacketSize = Size;
+	memcpy(Entry + 1, Data, Size);
+	WritePos += EntrySize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool FFlightRecorderImpl::WriteTo(UPTRINT Handle) const
+{
+	uint64 Now = TimeGetTimestamp();
+	uint64 Cutoff = (Now > MaxAge) ? Now - MaxAge : 0;
+
+	bool bOk = true;
+	for (uint64 Pos = ReadPos; bOk && Pos < WritePos;)
+	{
+		const auto* Entry = (const FEntry*)(Base + (Pos % Capacity));
+		if (Entry->PacketSize && Entry->Timestamp >= Cutoff)
+		{
+			bOk = IoWrite(Handle, Entry + 1, Entry->PacketSize);
+		}
+		Pos += Entry->EntrySize;
+	}
+	return bOk;
 }
 
 
@@ -370,84 +497,349 @@ enum class EDataState : uint8
 	Sending,			// Events are being sent to an IO handle
 };
 static FHoldBuffer				GHoldBuffer;		// will init to zero.
+static FHoldBuffer				GPinnedBuffer;		// will init to zero.
+static FFlightRecorder			GFlightRecorder;	// will init to zero.
 static UPTRINT					GDataHandle;		// = 0
 static EDataState				GDataState;			// = EDataState::Passive
 UPTRINT							GPendingDataHandle;	// = 0
 static FWriteBuffer* __restrict GActiveThreadList;	// = nullptr;
 
 ////////////////////////////////////////////////////////////////////////////////
-static uint32 Writer_SendData(uint32 ThreadId, uint8* __restrict Data, uint32 Size)
+struct FWriterStats
 {
-	auto SendInner = [] (uint8* __restrict SendData, uint32 SendSize)
+	uint64	BytesReaped;
+	uint64	BytesSent;
+	uint64	BytesDropped;
+	uint32	MaxDrainBytes;
+};
+static FWriterStats				GWriterStats;		// = {}
+
+////////////////////////////////////////////////////////////////////////////////
+struct FPacketBase
+{
+	uint16 PacketSize;
+	uint16 ThreadId;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+struct FPacketEncoded
+	: public FPacketBase
+{
+	uint16	DecodedSize;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+struct FPacket
+	: public FPacketEncoded
+{
+	uint8 Data[GPoolBlockSize + 64];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+static void Writer_SendPacket(const uint8* __restrict Data, uint32 Size, bool bPinned)
+{
+	GWriterStats.BytesSent += Size;
+
+	if (GDataState == EDataState::Sending)
 	{
-		if (GDataState == EDataState::Sending)
+		// Transmit data to the io handle
+		if (GDataHandle)
 		{
-			// Transmit data to the io handle
-			if (GDataHandle)
+			if (!IoWrite(GDataHandle, Data, Size))
 			{
-				if (!IoWrite(GDataHandle, SendData, SendSize))
-				{
-					IoClose(GDataHandle);
-					GDataHandle = 0;
-				}
+				IoClose(GDataHandle);
+				GDataHandle = 0;
 			}
 		}
-		else
-		{
-			GHoldBuffer->Write(SendData, SendSize);
+		return;
+	}
 
-			// Did we overflow? Enter partial mode.
-			bool bOverflown = GHoldBuffer->IsFull();
-			if (bOverflown && GDataState != EDataState::Partial)
-			{
-				GDataState = EDataState::Partial;
-			}
-		}
-	};
+	if (GHoldBuffer->Write(Data, Size))
+	{
+		return;
+	}
 
-	struct FPacketBase
+	// Event definitions are needed to decode anything that follows them, so
+	// they are kept apart where the flight recorder's ring can't evict them.
+	if (bPinned && GPinnedBuffer->Write(Data, Size))
 	{
-		uint16 PacketSize;
-		uint16 ThreadId;
-	};
+		return;
+	}
 
+	// The hold buffer has the start of the trace. Once it is full the flight
+	// recorder, if there is one, keeps the most recent data.
+	if (GFlightRecorder->IsActive())
+	{
+		GFlightRecorder->Write(Data, Size);
+		return;
+	}
+
+	// Did we overflow? Enter partial mode.
+	GWriterStats.BytesDropped += Size;
+	if (GDataState != EDataState::Partial)
+	{
+		GDataState = EDataState::Partial;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static uint8* Writer_EncodePacket(
+	FPacket& __restrict Packet,
+	uint32 ThreadId,
+	uint8* __restrict Data,
+	uint32& InOutSize)
+{
 	// Smaller buffers usually aren't redundant enough to benefit from being
 	// compressed. They often end up being larger.
-	if (Size <= 384)
+	if (InOutSize <= 384)
 	{
 		static_assert(sizeof(FPacketBase) == sizeof(uint32), "");
 		Data -= sizeof(FPacketBase);
-		Size += sizeof(FPacketBase);
-		auto* Packet = (FPacketBase*)Data;
-		Packet->ThreadId = uint16(ThreadId & 0x7fff);
-		Packet->PacketSize = uint16(Size);
-
-		SendInner(Data, Size);
-		return Size;
+		InOutSize += sizeof(FPacketBase);
+		auto* Header = (FPacketBase*)Data;
+		Header->ThreadId = uint16(ThreadId & 0x7fff);
+		Header->PacketSize = uint16(InOutSize);
+		return Data;
 	}
 
-	struct FPacketEncoded
-		: public FPacketBase
+	Packet.ThreadId = 0x8000 | uint16(ThreadId & 0x7fff);
+	Packet.DecodedSize = uint16(InOutSize);
+	Packet.PacketSize = Encode(Data, Packet.DecodedSize, Packet.Data, sizeof(Packet.Data));
+	Packet.PacketSize += sizeof(FPacketEncoded);
+
+	InOutSize = Packet.PacketSize;
+	return (uint8*)&Packet;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static uint32 Writer_SendData(uint32 ThreadId, uint8* __restrict Data, uint32 Size, bool bPinned)
+{
+	FPacket Packet;
+	uint8* PacketData = Writer_EncodePacket(Packet, ThreadId, Data, Size);
+	Writer_SendPacket(PacketData, Size, bPinned);
+	return Size;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Compressing drained data is the bulk of the worker thread's time. Optionally
+// it can be shared with a number of encode threads; the worker collects a batch
+// of buffers, everyone encodes them, and the worker sends the packets in the
+// order they were drained.
+struct FEncodeJob
+{
+	uint8* __restrict	Data;
+	uint32				Size;
+	uint32				ThreadId;
+	bool				bPinned;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+struct FEncodeBatch
+{
+	enum : uint32
 	{
-		uint16	DecodedSize;
+		MaxJobs		= 64,
+		Closed		= MaxJobs,
 	};
 
-	struct FPacket
-		: public FPacketEncoded
+	FEncodeJob							Jobs[MaxJobs];
+	uint32								Num;
+	alignas(PLATFORM_CACHE_LINE_SIZE)
+		uint32 volatile					NextJob;
+	alignas(PLATFORM_CACHE_LINE_SIZE)
+		uint32 volatile					NumDone;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+static const uint32				GEncodeMaxThreads		= 8;
+static const uint32				GEncodePacketsSize		= (sizeof(FPacket) * FEncodeBatch::MaxJobs + 0xffff) & ~0xffff;
+static FEncodeBatch				GEncodeBatch;
+static FPacket*					GEncodePackets;				// = nullptr
+static UPTRINT					GEncodeThreads[GEncodeMaxThreads];
+static UPTRINT					GEncodeSemaphore;			// = 0
+static uint32					GEncodeThreadCount;			// = 0
+static uint32 volatile			GEncodeThreadCountRequested;	// = 0
+static volatile bool			GEncodeThreadsQuit;			// = false
+
+////////////////////////////////////////////////////////////////////////////////
+static bool Writer_EncodeNextJob()
+{
+	FEncodeBatch& Batch = GEncodeBatch;
+
+	uint32 Index = AtomicLoadRelaxed(&Batch.NextJob);
+	if (Index >= FEncodeBatch::Closed)
 	{
-		uint8 Data[GPoolBlockSize + 64];
-	};
+		return false;
+	}
 
-	FPacket Packet;
-	Packet.ThreadId = 0x8000 | uint16(ThreadId & 0x7fff);
-	Packet.DecodedSize = uint16(Size);
-	Packet.PacketSize = Encode(Data, Packet.DecodedSize, Packet.Data, sizeof(Packet.Data));
-	Packet.PacketSize += sizeof(FPacketEncoded);
+	if (!AtomicCompareExchangeAcquire(&Batch.NextJob, Index + 1, Index))
+	{
+		return true;
+	}
+
+	// Claims can overshoot the end of the batch, they just don't do anything.
+	if (Index >= Batch.Num)
+	{
+		return false;
+	}
+
+	FEncodeJob& Job = Batch.Jobs[Index];
+	Job.Data = Writer_EncodePacket(GEncodePackets[Index], Job.ThreadId, Job.Data, Job.Size);
 
-	SendInner((uint8*)&Packet, Packet.PacketSize);
-	return Packet.PacketSize;
+	for (;; Private::PlatformYield())
+	{
+		uint32 NumDone = AtomicLoadRelaxed(&Batch.NumDone);
+		if (AtomicCompareExchangeRelease(&Batch.NumDone, NumDone + 1, NumDone))
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void Writer_EncodeThread()
+{
+	// The worker releases the semaphore once per encode thread for each batch
+	// it publishes, and once more when the threads should quit.
+	while (true)
+	{
+		SemaphoreWait(GEncodeSemaphore);
+		if (GEncodeThreadsQuit)
+		{
+			break;
+		}
+
+		while (Writer_EncodeNextJob());
+	}
 }
 
+////////////////////////////////////////////////////////////////////////////////
+static void Writer_FlushEncodeBatch()
+{
+	FEncodeBatch& Batch = GEncodeBatch;
+	if (Batch.Num == 0)
+	{
+		return;
+	}
+
+	// Publish the batch and help encode it.
+	AtomicStoreRelaxed(&Batch.NumDone, 0u);
+	AtomicStoreRelease(&Batch.NextJob, 0u);
+	SemaphoreRelease(GEncodeSemaphore, GEncodeThreadCount);
+	while (Writer_EncodeNextJob());
+
+	while (AtomicLoadAcquire(&Batch.NumDone) != Batch.Num)
+	{
+		Private::PlatformYield();
+	}
+	AtomicStoreRelaxed(&Batch.NextJob, uint32(FEncodeBatch::Closed));
+
+	for (uint32 i = 0; i < Batch.Num; ++i)
+	{
+		const FEncodeJob& Job = Batch.Jobs[i];
+		Writer_SendPacket(Job.Data, Job.Size, Job.bPinned);
+	}
+	Batch.Num = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void Writer_DrainData(uint32 ThreadId, uint8* __restrict Data, uint32 Size, bool bPinned)
+{
+	if (GEncodeThreadCount == 0)
+	{
+		Writer_SendData(ThreadId, Data, Size, bPinned);
+		return;
+	}
+
+	FEncodeBatch& Batch = GEncodeBatch;
+	Batch.Jobs[Batch.Num++] = { Data, Size, ThreadId, bPinned };
+	if (Batch.Num == FEncodeBatch::MaxJobs)
+	{
+		Writer_FlushEncodeBatch();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void Writer_StopEncodeThreads()
+{
+	GEncodeThreadsQuit = true;
+	if (GEncodeThreadCount)
+	{
+		SemaphoreRelease(GEncodeSemaphore, GEncodeThreadCount);
+	}
+	for (uint32 i = 0; i < GEncodeThreadCount; ++i)
+	{
+		ThreadJoin(GEncodeThreads[i]);
+		ThreadDestroy(GEncodeThreads[i]);
+	}
+	GEncodeThreadCount = 0;
+	GEncodeThreadsQuit = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void Writer_UpdateEncodeThreads()
+{
+	uint32 Requested = AtomicLoadRelaxed(&GEncodeThreadCountRequested);
+	Requested = (Requested < GEncodeMaxThreads) ? Requested : GEncodeMaxThreads;
+	if (Requested == GEncodeThreadCount)
+	{
+		return;
+	}
+
+	Writer_StopEncodeThreads();
+
+	if (Requested == 0)
+	{
+		return;
+	}
+
+	if (GEncodePackets == nullptr)
+	{
+		GEncodePackets = (FPacket*)MemoryReserve(GEncodePacketsSize);
+		MemoryMap(GEncodePackets, GEncodePacketsSize);
+	}
+
+	if (GEncodeSemaphore == 0)
+	{
+		GEncodeSemaphore = SemaphoreCreate();
+		if (GEncodeSemaphore == 0)
+		{
+			return;
+		}
+	}
+
+	AtomicStoreRelaxed(&GEncodeBatch.NextJob, uint32(FEncodeBatch::Closed));
+	for (uint32 i = 0; i < Requested; ++i)
+	{
+		GEncodeThreads[GEncodeThreadCount] = ThreadCreate("TraceEncode", Writer_EncodeThread);
+		GEncodeThreadCount += (GEncodeThreads[GEncodeThreadCount] != 0);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void Writer_ShutdownEncodeThreads()
+{
+	Writer_StopEncodeThreads();
+
+	if (GEncodePackets != nullptr)
+	{
+		MemoryFree(GEncodePackets, GEncodePacketsSize);
+		GEncodePackets = nullptr;
+	}
+
+	if (GEncodeSemaphore != 0)
+	{
+		SemaphoreDestroy(GEncodeSemaphore);
+		GEncodeSemaphore = 0;
+	}
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 static void Writer_ConsumeEvents()
 {
@@ -466,9 +858,9 @@ static void Writer_ConsumeEvents()
 
 #if TRACE_PRIVATE_PERF
 	uint64 StartTsc = TimeGetTimestamp();
-	uint32 BytesReaped = 0;
-	uint32 BytesSent = 0;
+	uint64 StartBytesSent = GWriterStats.BytesSent;
 #endif
+	uint32 BytesReaped = 0;
 
 	// Claim ownership of any new thread buffer lists
 	FWriteBuffer* __restrict NewThreadList;
@@ -504,11 +896,8 @@ static void Writer_ConsumeEvents()
 				// Send as much as we can.
 				if (uint32 SizeToReap = uint32(Committed - Buffer->Reaped))
 				{
-#if TRACE_PRIVATE_PERF
 					BytesReaped += SizeToReap;
-					BytesSent += /*...*/
-#endif
-					Writer_SendData(ThreadId, Buffer->Reaped, SizeToReap);
+					Writer_DrainData(ThreadId, Buffer->Reaped, SizeToReap, Buffer->bPinned != 0);
 					Buffer->Reaped = Committed;
 				}
 
@@ -532,11 +921,20 @@ static void Writer_ConsumeEvents()
 		}
 	}
 
+	// Retirees' data may still be waiting to be encoded.
+	Writer_FlushEncodeBatch();
+
+	GWriterStats.BytesReaped += BytesReaped;
+	if (BytesReaped > GWriterStats.MaxDrainBytes)
+	{
+		GWriterStats.MaxDrainBytes = BytesReaped;
+	}
+
 #if TRACE_PRIVATE_PERF
 	UE_TRACE_LOG($Trace, WorkerThread, TraceLogChannel)
 		<< WorkerThread.Cycles(uint32(TimeGetTimestamp() - StartTsc))
-		<< WorkerThread.BytesReaped(BytesReaped);
-		<< WorkerThread.BytesSent(BytesSent);
+		<< WorkerThread.BytesReaped(BytesReaped)
+		<< WorkerThread.BytesSent(uint32(GWriterStats.BytesSent - StartBytesSent));
 
 	UE_TRACE_LOG($Trace, Memory, TraceLogChannel)
 		<< Memory.AllocSize(uint32(GPoolPageCursor - GPoolBase));
@@ -556,6 +954,85 @@ static void Writer_ConsumeEvents()
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////
+static bool Writer_WriteStreamHeader(UPTRINT Handle)
+{
+	// Handshake.
+	const uint32 Magic = 'TRCE';
+	bool bOk = IoWrite(Handle, &Magic, sizeof(Magic));
+
+	// Stream header
+	const struct {
+		uint8 TransportVersion	= ETransport::TidPacket;
+		uint8 ProtocolVersion	= EProtocol::Id;
+	} TransportHeader;
+	bOk &= IoWrite(Handle, &TransportHeader, sizeof(TransportHeader));
+
+	// Passively collected data
+	if (GHoldBuffer->GetSize())
+	{
+		bOk &= IoWrite(Handle, GHoldBuffer->GetData(), GHoldBuffer->GetSize());
+	}
+
+	// Definitions that didn't fit the hold buffer, ahead of the events using them
+	if (GPinnedBuffer->GetSize())
+	{
+		bOk &= IoWrite(Handle, GPinnedBuffer->GetData(), GPinnedBuffer->GetSize());
+	}
+
+	if (GFlightRecorder->IsActive())
+	{
+		bOk &= GFlightRecorder->WriteTo(Handle);
+	}
+
+	return bOk;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+enum class EDumpState : uint32
+{
+	Idle = 0,
+	Claimed,
+	Pending,
+};
+static ANSICHAR					GDumpPath[512];
+static uint32 volatile			GDumpState;					// = EDumpState::Idle
+static uint32					GFlightRecorderSize;		// = 0
+static uint32					GFlightRecorderSeconds;		// = 0
+static uint32 volatile			GFlightRecorderRequested;	// = 0
+
+////////////////////////////////////////////////////////////////////////////////
+static void Writer_UpdateFlightRecorder()
+{
+	if (AtomicLoadAcquire(&GFlightRecorderRequested))
+	{
+		// There is nothing to record once data is being sent somewhere.
+		if (GDataState != EDataState::Sending && !GFlightRecorder->IsActive())
+		{
+			GFlightRecorder->Init(GFlightRecorderSize, GFlightRecorderSeconds);
+		}
+		AtomicStoreRelaxed(&GFlightRecorderRequested, 0u);
+	}
+
+	if (AtomicLoadAcquire(&GDumpState) != uint32(EDumpState::Pending))
+	{
+		return;
+	}
+
+	if (GFlightRecorder->IsActive())
+	{
+		if (UPTRINT DumpHandle = FileOpen(GDumpPath))
+		{
+			Writer_WriteStreamHeader(DumpHandle);
+			IoClose(DumpHandle);
+		}
+	}
+
+	AtomicStoreRelease(&GDumpState, uint32(EDumpState::Idle));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 static void Writer_UpdateData()
 {
@@ -572,27 +1049,12 @@ static void Writer_UpdateData()
 		GDataHandle = GPendingDataHandle;
 		GPendingDataHandle = 0;
 
-		// Handshake.
-		const uint32 Magic = 'TRCE';
-		bool bOk = IoWrite(GDataHandle, &Magic, sizeof(Magic));
-
-		// Stream header
-		const struct {
-			uint8 TransportVersion	= ETransport::TidPacket;
-			uint8 ProtocolVersion	= EProtocol::Id;
-		} TransportHeader;
-		bOk &= IoWrite(GDataHandle, &TransportHeader, sizeof(TransportHeader));
-
-		// Passively collected data
-		if (GHoldBuffer->GetSize())
-		{
-			bOk &= IoWrite(GDataHandle, GHoldBuffer->GetData(), GHoldBuffer->GetSize());
-		}
-
-		if (bOk)
+		if (Writer_WriteStreamHeader(GDataHandle))
 		{
 			GDataState = EDataState::Sending;
 			GHoldBuffer->Shutdown();
+			GPinnedBuffer->Shutdown();
+			GFlightRecorder->Shutdown();
 		}
 		else
 		{
@@ -602,6 +1064,7 @@ static void Writer_UpdateData()
 	}
 
 	Writer_ConsumeEvents();
+	Writer_UpdateFlightRecorder();
 }
 
 
@@ -618,6 +1081,7 @@ static void Writer_WorkerThread()
 		const uint32 SleepMs = 24;
 		ThreadSleep(SleepMs);
 
+		Writer_UpdateEncodeThreads();
 		Writer_UpdateControl();
 		Writer_UpdateData();
 	}
@@ -655,6 +1119,7 @@ static void Writer_InternalInitialize()
 	Writer_LogHeader();
 
 	GHoldBuffer->Init();
+	GPinnedBuffer->Init();
 
 	GWorkerThread = ThreadCreate("TraceWorker", Writer_WorkerThread);
 
@@ -674,9 +1139,12 @@ static void Writer_Shutdown()
 	ThreadJoin(GWorkerThread);
 	ThreadDestroy(GWorkerThread);
 
+	Writer_ShutdownEncodeThreads();
 	Writer_ShutdownControl();
 
 	GHoldBuffer->Shutdown();
+	GPinnedBuffer->Shutdown();
+	GFlightRecorder->Shutdown();
 	Writer_ShutdownBuffers();
 
 	GInitialized = false;
@@ -745,6 +1213,86 @@ bool Writer_WriteTo(const ANSICHAR* Path)
 	return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+bool Writer_StartFlightRecorder(uint32 Seconds, uint32 SizeMb)
+{
+	if (GPendingDataHandle || GDataHandle)
+	{
+		return false;
+	}
+
+	Writer_Initialize();
+
+	GFlightRecorderSeconds = Seconds;
+	// Size is narrowed to the recorder's 32 bit capacity, keep it well below the limit
+	const uint64 MaxSize = 1ull << 30;
+	const uint64 Size = uint64(SizeMb) << 20;
+	GFlightRecorderSize = uint32((Size < MaxSize) ? Size : MaxSize);
+	AtomicStoreRelease(&GFlightRecorderRequested, 1u);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Writer_DumpFlightRecorder(const ANSICHAR* Path, uint32 WaitMs)
+{
+	if (!GInitialized || GDataHandle || !GFlightRecorder->IsActive())
+	{
+		return false;
+	}
+
+	// Only one dump can be in flight at a time.
+	if (!AtomicCompareExchangeAcquire(&GDumpState, uint32(EDumpState::Claimed), uint32(EDumpState::Idle)))
+	{
+		return false;
+	}
+
+	int32 i = 0;
+	for (; i < int32(sizeof(GDumpPath)) - 1 && Path[i]; ++i)
+	{
+		GDumpPath[i] = Path[i];
+	}
+	GDumpPath[i] = '\0';
+
+	// The worker thread does the dump after it next drains the threads' buffers.
+	AtomicStoreRelease(&GDumpState, uint32(EDumpState::Pending));
+
+	if (WaitMs == 0)
+	{
+		return true;
+	}
+
+	for (; WaitMs; --WaitMs)
+	{
+		ThreadSleep(1);
+		if (AtomicLoadAcquire(&GDumpState) == uint32(EDumpState::Idle))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Writer_SetEncodeThreadCount(uint32 Count)
+{
+	AtomicStoreRelaxed(&GEncodeThreadCountRequested, Count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Writer_GetStatistics(FStatistics& Out)
+{
+	// Written by the worker thread without synchronization so values may be
+	// an update behind, which is good enough for monitoring.
+	Out.BytesReaped = GWriterStats.BytesReaped;
+	Out.BytesSent = GWriterStats.BytesSent;
+	Out.BytesDropped = GWriterStats.BytesDropped;
+	Out.MemoryUsed = GInitialized ? uint64(AtomicLoadRelaxed(&GPoolPageCursor) - GPoolBase) : 0;
+	Out.MaxDrainBytes = GWriterStats.MaxDrainBytes;
+	Out.FlightRecorderBytes = GFlightRecorder->IsActive() ? GFlightRecorder->GetSize() : 0;
+	Out.EncodeThreadCount = GEncodeThreadCount;
+}
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -788,6 +1336,11 @@ void Writer_EventCreate(
 	EventSize += sizeof(FNewEventEvent::Fields[0]) * FieldCount;
 	EventSize += NamesSize;
 
+	// The definition gets a write buffer of its own, flagged so the worker can
+	// pin it outside the flight recorder's ring.
+	FWriteBuffer* DefinitionBuffer = Writer_NextBuffer(0);
+	DefinitionBuffer->bPinned = 1;
+
 	FLogInstance LogInstance = Writer_BeginLog(EventUid, EventSize, false);
 	auto& Event = *(FNewEventEvent*)(LogInstance.Ptr);
 
@@ -841,6 +1394,9 @@ void Writer_EventCreate(
 	}
 
 	Writer_EndLog(LogInstance);
+
+	// Retire the definition's buffer so nothing else is written to it.
+	Writer_NextBuffer(0);
 }
 
 } // namespace Private
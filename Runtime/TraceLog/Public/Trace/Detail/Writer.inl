@@ -24,6 +24,7 @@ struct FWriteBuffer
 	uint8* __restrict volatile	Committed;
 	uint8* __restrict			Reaped;
 	UPTRINT volatile			EtxOffset;
+	uint32						bPinned;
 };
 
 
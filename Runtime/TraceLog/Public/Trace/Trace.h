@@ -18,9 +18,24 @@
 namespace Trace
 {
 
+struct FStatistics
+{
+	uint64	BytesReaped;			// Event data drained from the threads' buffers
+	uint64	BytesSent;				// Data after compression, sent or kept in-process
+	uint64	BytesDropped;			// Lost because nothing was connected and the hold buffer was full
+	uint64	MemoryUsed;				// Mapped for the threads' buffers. Grows when the writer falls behind
+	uint32	MaxDrainBytes;			// Most event data drained in a single update
+	uint32	FlightRecorderBytes;	// Currently held by the flight recorder
+	uint32	EncodeThreadCount;		// Threads helping the writer compress data
+};
+
 UE_TRACE_API bool	Initialize() UE_TRACE_IMPL(false);
 UE_TRACE_API bool	SendTo(const TCHAR* Host, uint32 Port=1980) UE_TRACE_IMPL(false);
 UE_TRACE_API bool	WriteTo(const TCHAR* Path) UE_TRACE_IMPL(false);
+UE_TRACE_API bool	StartFlightRecorder(uint32 Seconds, uint32 SizeMb=64) UE_TRACE_IMPL(false);
+UE_TRACE_API bool	DumpFlightRecorder(const TCHAR* Path, uint32 WaitMs=0) UE_TRACE_IMPL(false);
+UE_TRACE_API void	SetCompressionThreadCount(uint32 Count) UE_TRACE_IMPL();
+UE_TRACE_API void	GetStatistics(FStatistics& Out) UE_TRACE_IMPL();
 UE_TRACE_API bool	ToggleChannel(const TCHAR* ChannelName, bool bEnabled) UE_TRACE_IMPL(false);
 UE_TRACE_API bool	ToggleChannel(struct FChannel& Channel, bool bEnabled) UE_TRACE_IMPL(false);
 